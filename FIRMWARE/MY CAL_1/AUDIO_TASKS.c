@@ -5,7 +5,7 @@
  * Author:          Hab S. Collector
  * Date:            2/15/12
  * LAST EDIT:       6/15/2012
- * LAST EDIT:       7/24/2012
+ * LAST EDIT:       10/19/2026
  * Hardware:        NXP LPC1768
  * Firmware Tool:   CrossStudio for ARM
  * Notes:           This file should be written as to not be dependent on other includes.
@@ -52,6 +52,7 @@ extern DIR Directory;
 extern CTL_MESSAGE_QUEUE_t AudioQueue;
 extern Type_AudioQueueStruct AudioQueueStruct;
 extern CTL_MEMORY_AREA_t MemArea;
+extern CTL_MUTEX_t FatFsMutex;
 
 /*************************************************************************
  * Function Name: audio_taskFn
@@ -111,6 +112,8 @@ extern CTL_MEMORY_AREA_t MemArea;
  * NOTE: The file play data is loaded to the DAC (Audio) via the Timer IRQ
  * NOTE: This function has been modified to work with Music List Mode.  Where ever you see a test for 
  * music list mode is where there lies a "hook"
+ * NOTE: Each FAT FS call holds FatFsMutex - the tape, log and list tasks use the card as well.  The
+ * result is kept local as FF_Result is shared by the tasks
  * STEP 1: Verify file can play at present Cal Verbose settings.  Use of LFN if set, Other start stuff
  * STEP 2: Build the file name with path, mount the drive and open the file for reading
  * STEP 3: If this is the first read of the file (the file is read in buffer size chunks)
@@ -131,6 +134,7 @@ extern CTL_MEMORY_AREA_t MemArea;
  {
  
  FIL FileStream;
+ FRESULT StreamResult;
  UINT BytesRead;
  BYTE Buffer[IN_COMMING_BUFFER_SIZE];
  BOOLEAN FileVerified = FALSE,
@@ -185,8 +189,10 @@ CalSettings.MusicPlayBack.Playing = FALSE;
  
  // MOUNT THE DRIVE AND OPEN
  //f_mount(0, &fs[0]);
- FF_Result = f_open(&FileStream, PathName, FA_OPEN_EXISTING | FA_READ);
- if (FF_Result != FR_OK)
+ ctl_mutex_lock(&FatFsMutex, CTL_TIMEOUT_NONE, 0);
+ StreamResult = f_open(&FileStream, PathName, FA_OPEN_EXISTING | FA_READ);
+ ctl_mutex_unlock(&FatFsMutex);
+ if (StreamResult != FR_OK)
    {
    //f_mount(0, NULL);
    return(FALSE);
@@ -197,8 +203,10 @@ CalSettings.MusicPlayBack.Playing = FALSE;
  while(TRUE)
    {
    // READ A CHUNK OF THE WAV FILE
-   FF_Result = f_read(&FileStream, Buffer, sizeof(Buffer), &BytesRead);  
-   if ((FF_Result != FR_OK) || BytesRead == 0) 
+   ctl_mutex_lock(&FatFsMutex, CTL_TIMEOUT_NONE, 0);
+   StreamResult = f_read(&FileStream, Buffer, sizeof(Buffer), &BytesRead);  
+   ctl_mutex_unlock(&FatFsMutex);
+   if ((StreamResult != FR_OK) || BytesRead == 0) 
      break; 
    
    // STEP 3
@@ -214,7 +222,9 @@ CalSettings.MusicPlayBack.Playing = FALSE;
      uint8_t StringCompareTotal = strcmp(RIFF_FILE_TYPE, FileType) + strcmp(WAVE_RIFF_TYPE, RiffType);
      if ((StringCompareTotal !=0) || (Buffer[FORMAT_SIZE_OFFSET] != 16) && (Buffer[BIT_PER_SAMPLE_OFFSET] != 16))
        {
+       ctl_mutex_lock(&FatFsMutex, CTL_TIMEOUT_NONE, 0);
        f_close(&FileStream);
+       ctl_mutex_unlock(&FatFsMutex);
        //f_mount(0, NULL);
        return(FALSE);
        }
@@ -325,7 +335,9 @@ CalSettings.MusicPlayBack.Playing = FALSE;
    // CHECK FOR END CONDITION IF MODE OTHER THAN MUSIC_LIST_MODE
    if (DataChunkSize.Int32Value == 0)
      {
+     ctl_mutex_lock(&FatFsMutex, CTL_TIMEOUT_NONE, 0);
      f_close(&FileStream);
+     ctl_mutex_unlock(&FatFsMutex);
      //f_mount(0, NULL);
      // WAIT FOR THE BUFFERS TO BE EMPTY: FREE MEMORY AND DISABLE TIMER IRQ
      while(!isEmpty_CB(&CircularBufferLeft));
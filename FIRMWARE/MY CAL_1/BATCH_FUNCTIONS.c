@@ -0,0 +1,449 @@
+/*****************************************************************
+ *
+ * File name:       BATCH_FUNCTIONS.C
+ * Description:     BATCH - a keystroke program function applied to every row of a CSV file on the SD card
+ * Author:          Hab S. Collector
+ * Date:            10/19/2026
+ * LAST EDIT:       10/19/2026
+ * Hardware:        NXP LPC1769
+ * Firmware Tool:   CrossStudio for ARM
+ * Notes:           This file should be written as to not be dependent on other includes.
+ *                  everything these functions need should be passed to them.
+ *                  It will be necessary to consult the reference documents and associated schematics to understand
+ *                  the operations of this firmware.
+ *                  As SOLVE and INTEGRATE the function is a subroutine of the keystroke program at LBL n.  Columns
+ *                  1 - 4 of a row are put in X, Y, Z and T (a one column file fills the stack with x), the function
+ *                  runs to its RTN and X is added to the row as a new last column.  The input is streamed a block
+ *                  at a time and the output is written a block at a time, so the size of the file does not matter.
+ *                  The batch runs in the program task with the display held - only the progress line is written.
+ *****************************************************************/
+
+#include <ctl_api.h>
+#include "BATCH_FUNCTIONS.H"
+#include "PROGRAM_TASKS.H"
+#include "CORE_FUNCTIONS.H"
+#include "MATH_FUNCTIONS.H"
+#include "DIP204.H"
+#include "AUDIO_TASKS.H"
+#include "TOUCH_TASKS.h"
+#include "FAT_FS_INC/ff.h"
+#include "lpc_types.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+// GLOBAL VARS
+// TYPES
+typedef struct
+  {
+  uint32_t Rows;                             // ROWS THROUGH THE FUNCTION
+  uint32_t Skipped;                          // ROWS MARKED ERROR - NOT NUMBERS, TOO LONG OR A FUNCTION ERROR
+  uint32_t BytesIn;                          // OF THE INPUT FILE SO FAR
+  uint32_t StartTime;                        // ms - ctl_get_current_time
+  uint32_t ShownTime;                        // ms - LAST UPDATE OF THE PROGRESS LINE
+  uint16_t LineLength;                       // BYTES OF THE ROW SO FAR
+  uint16_t OutLength;                        // BYTES OF THE OUTPUT BLOCK
+  BOOLEAN Overflow;                          // THE ROW IS LONGER THAN BATCH_LINE_LENGTH
+  uint8_t Label;
+  uint8_t Result;                            // SEE enum BATCH_RESULT
+  } Type_Batch;
+static Type_Batch Batch;
+// NOT ON THE STACK - THE PROGRAM TASK STACK IS SMALL.  IN THE SCRATCH POOL FOR THE RUN (SEE call_ScratchClaim)
+typedef struct
+  {
+  FIL InFile;
+  FIL OutFile;
+  uint8_t InBlock[BATCH_BLOCK];
+  uint8_t OutBlock[BATCH_BLOCK];
+  uint8_t Line[BATCH_LINE_LENGTH];
+  Type_Register SavedRegister[TOTAL_REGISTERS];
+  } Type_BatchScratch;
+static Type_BatchScratch *BatchScratch;
+
+// EXTERN VARS
+extern Type_Program Program;
+extern Type_CalSettings CalSettings;
+extern Type_Register RegisterValue[TOTAL_REGISTERS];
+extern Type_Numeric NumericValue;
+extern Type_MathErrorDisplay MathError;
+extern double LastX;
+extern CTL_MUTEX_t FatFsMutex;
+
+// PROTOTYPES LOCAL
+static BOOLEAN call_BatchRow(void);
+static BOOLEAN call_BatchPut(const uint8_t *, uint16_t);
+static BOOLEAN call_BatchFlush(void);
+static void call_BatchProgress(void);
+static void call_BatchError(const uint8_t *, const uint8_t *);
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BatchRun
+ * Parameters: uint8_t
+ * Return: void
+ *
+ * Description: BATCH n - every row of BATCH_IN_FILE_NAME through the function at LBL n, the rows
+ * with the result added written to BATCH_OUT_FILE_NAME.  Called by the program task with the
+ * program compiled and the display held.  The input is read BATCH_BLOCK bytes at a time and cut
+ * into rows here.  A first row that is not numbers is taken as the header and gets the column
+ * name RESULT, any other row that is not numbers, is too long or the function had an error on gets
+ * ERROR and the batch goes on.  Line 4 shows the
+ * progress while it runs and the rows and rows per second are reported on line 1.  ATN (any key)
+ * stops the batch with the rows so far written.  The stack is as it was before the batch.
+ * NOTE: FatFsMutex is held for each FAT FS call, not across the rows - the function runs with the
+ * card free.  The results are local as FF_Result is shared by the tasks.
+ * STEP 1: Claim the scratch pool, open the files, save the stack
+ * STEP 2: Read a block - cut it into rows, each row through the function
+ * STEP 3: The last row if the file does not end in a new line, write what is left and close
+ * STEP 4: Restore the stack, give back the scratch pool
+ * STEP 5: Report or error
+ *************************************************************************/
+ void call_BatchRun(uint8_t Label)
+ {
+
+ UINT BytesRead;
+ FRESULT Result;
+ uint32_t Elapsed;
+ double SavedLastX = LastX;
+
+ // STEP 1
+ memset(&Batch, 0, sizeof(Batch));
+ Batch.Label = Label;
+ Batch.Result = BATCH_DONE;
+ Program.Evaluations = 0;
+ BatchScratch = (Type_BatchScratch *)call_ScratchClaim(SCRATCH_BATCH, sizeof(Type_BatchScratch));
+ if (BatchScratch == NULL)
+   {
+   //                 01234567890123456789
+   call_BatchError("Memory in use", "DIM the matrices 0");
+   return;
+   }
+ ctl_mutex_lock(&FatFsMutex, CTL_TIMEOUT_NONE, 0);
+ Result = f_open(&BatchScratch->InFile, BATCH_IN_FILE_NAME, FA_OPEN_EXISTING | FA_READ);
+ ctl_mutex_unlock(&FatFsMutex);
+ if (Result != FR_OK)
+   {
+   //                 01234567890123456789
+   call_BatchError("No HC15C_IN.CSV", "Copy it to the SD");
+   call_ScratchRelease(SCRATCH_BATCH);
+   return;
+   }
+ ctl_mutex_lock(&FatFsMutex, CTL_TIMEOUT_NONE, 0);
+ Result = f_open(&BatchScratch->OutFile, BATCH_OUT_FILE_NAME, FA_CREATE_ALWAYS | FA_WRITE);
+ if (Result != FR_OK)
+   f_close(&BatchScratch->InFile);
+ ctl_mutex_unlock(&FatFsMutex);
+ if (Result != FR_OK)
+   {
+   call_BatchError("SD write failed", "Check the SD card");
+   call_ScratchRelease(SCRATCH_BATCH);
+   return;
+   }
+ memcpy(BatchScratch->SavedRegister, RegisterValue, sizeof(BatchScratch->SavedRegister));
+ Batch.ShownTime = Batch.StartTime = ctl_get_current_time();
+ call_BatchProgress();
+
+ // STEP 2
+ while (Batch.Result == BATCH_DONE)
+   {
+   ctl_mutex_lock(&FatFsMutex, CTL_TIMEOUT_NONE, 0);
+   Result = f_read(&BatchScratch->InFile, BatchScratch->InBlock, BATCH_BLOCK, &BytesRead);
+   ctl_mutex_unlock(&FatFsMutex);
+   if (Result != FR_OK)
+     {
+     Batch.Result = BATCH_FILE_ERROR;
+     break;
+     }
+   if (!BytesRead)
+     break;
+   Batch.BytesIn += BytesRead;
+   for (UINT Index = 0; (Index < BytesRead) && (Batch.Result == BATCH_DONE); Index++)
+     {
+     switch(BatchScratch->InBlock[Index])
+       {
+       case '\n':
+         call_BatchRow();
+       break;
+
+       case '\r':
+       break;
+
+       default:
+         if (Batch.LineLength < (BATCH_LINE_LENGTH - 1))
+           BatchScratch->Line[Batch.LineLength++] = BatchScratch->InBlock[Index];
+         else
+           Batch.Overflow = TRUE;
+       break;
+       }
+     }
+   if ((Program.StopRequest) && (Batch.Result == BATCH_DONE))
+     Batch.Result = BATCH_STOPPED;
+   if ((ctl_get_current_time() - Batch.ShownTime) >= BATCH_PROGRESS_TIME)
+     call_BatchProgress();
+   }
+
+ // STEP 3
+ if ((Batch.Result == BATCH_DONE) && (Batch.LineLength))
+   call_BatchRow();
+ if (!call_BatchFlush())
+   Batch.Result = BATCH_FILE_ERROR;
+ ctl_mutex_lock(&FatFsMutex, CTL_TIMEOUT_NONE, 0);
+ f_close(&BatchScratch->InFile);
+ Result = f_close(&BatchScratch->OutFile);
+ ctl_mutex_unlock(&FatFsMutex);
+ if (Result != FR_OK)
+   Batch.Result = BATCH_FILE_ERROR;
+
+ // STEP 4
+ memcpy(RegisterValue, BatchScratch->SavedRegister, sizeof(BatchScratch->SavedRegister));
+ LastX = SavedLastX;
+ call_ScratchRelease(SCRATCH_BATCH);
+
+ // STEP 5
+ Elapsed = ctl_get_current_time() - Batch.StartTime;
+ if (!Elapsed)
+   Elapsed = 1;
+ switch(Batch.Result)
+   {
+   case BATCH_DONE:
+     //                            01234567890123456789
+     snprintf(Program.Report, PROGRAM_REPORT_LENGTH, "%lu ROWS %lu/S", Batch.Rows, (uint32_t)(((uint64_t)Batch.Rows * 1000) / Elapsed));
+   break;
+
+   case BATCH_STOPPED:
+     snprintf(Program.Report, PROGRAM_REPORT_LENGTH, "BATCH STOPPED %lu", Batch.Rows);
+   break;
+
+   case BATCH_FILE_ERROR:
+     call_BatchError("SD access failed", "Check the SD card");
+   break;
+
+   default:
+   break;
+   }
+
+ } // END OF call_BatchRun
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BatchRow
+ * Parameters: void
+ * Return: BOOLEAN
+ *
+ * Description: One row of the input.  Columns 1 - 4 are read as numbers, the function runs on
+ * them and the row is written with X added.  A row that is not numbers is written with RESULT
+ * (the first row - the header) or ERROR added.  A row cut short at BATCH_LINE_LENGTH is not read,
+ * it is written as far as it was kept with ERROR.  A math error of the function is cleared and the
+ * row written with ERROR - the error stays on lines 1 - 3 until the batch ends.  Blank rows are
+ * dropped.  Returns FALSE with Batch.Result set if the function was stopped or the output could
+ * not be written.
+ * STEP 1: The row to text, blank rows dropped
+ * STEP 2: The columns to numbers - not a row cut short
+ * STEP 3: Not numbers - the header or an error
+ * STEP 4: Columns to the stack and run the function - clear an error of the function
+ * STEP 5: Write the row and X
+ *************************************************************************/
+ static BOOLEAN call_BatchRow(void)
+ {
+
+ double Value[BATCH_COLUMNS];
+ uint8_t Columns = 0,
+         ResultText[BATCH_RESULT_LENGTH],
+         *Text = BatchScratch->Line,
+         *End;
+ BOOLEAN Numbers = !Batch.Overflow;
+
+ // STEP 1
+ BatchScratch->Line[Batch.LineLength] = NULL_VALUE;
+ if ((!Batch.LineLength) && (!Batch.Overflow))
+   return(TRUE);
+
+ // STEP 2
+ while ((Numbers) && (Columns < BATCH_COLUMNS))
+   {
+   // A SEPARATOR THAT ENDS THE ROW
+   if ((Columns) && (*Text == NULL_VALUE))
+     break;
+   Value[Columns] = strtod(Text, (char **)&End);
+   if (End == Text)
+     {
+     Numbers = FALSE;
+     break;
+     }
+   Columns++;
+   while (*End == ' ')
+     End++;
+   if (*End == NULL_VALUE)
+     break;
+   if (*End != BATCH_SEPARATOR)
+     Numbers = FALSE;
+   Text = End + 1;
+   }
+
+ // STEP 3
+ if (!Numbers)
+   {
+   if ((!Batch.Rows) && (!Batch.Skipped) && (!Batch.Overflow))
+     strcpy(ResultText, ",RESULT\r\n");
+   else
+     strcpy(ResultText, ",ERROR\r\n");
+   Batch.Skipped++;
+   }
+ else
+   {
+   // STEP 4
+   for (uint8_t RegCount = 0; RegCount < TOTAL_REGISTERS; RegCount++)
+     RegisterValue[RegCount].NumericValue = (RegCount < Columns) ? Value[RegCount] : Value[0];
+   if (call_ProgramEvaluateStack(Batch.Label))
+     {
+     sprintf(ResultText, ",%.15G\r\n", RegisterValue[0].NumericValue);
+     Batch.Rows++;
+     }
+   else if (CalSettings.CalError != NO_ERROR)
+     {
+     CalSettings.CalError = NO_ERROR;
+     select_All_Normal_Keys();
+     DIP204_ICON_set(ICON_ALERT, ICON_OFF);
+     strcpy(ResultText, ",ERROR\r\n");
+     Batch.Skipped++;
+     }
+   else
+     {
+     Batch.Result = BATCH_STOPPED;
+     Batch.LineLength = 0;
+     Batch.Overflow = FALSE;
+     return(FALSE);
+     }
+   }
+
+ // STEP 5
+ if ((!call_BatchPut(BatchScratch->Line, Batch.LineLength)) || (!call_BatchPut(ResultText, strlen(ResultText))))
+   Batch.Result = BATCH_FILE_ERROR;
+ Batch.LineLength = 0;
+ Batch.Overflow = FALSE;
+ return(Batch.Result == BATCH_DONE);
+
+ } // END OF call_BatchRow
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BatchPut
+ * Parameters: const uint8_t *, uint16_t
+ * Return: BOOLEAN
+ *
+ * Description: Adds text to the output block.  Each time the block is full it is written, so
+ * every write but the last is BATCH_BLOCK bytes on a sector boundary.  Returns FALSE if a write
+ * failed.
+ * STEP 1: Copy to the block - write the block when full
+ *************************************************************************/
+ static BOOLEAN call_BatchPut(const uint8_t *Text, uint16_t Length)
+ {
+
+ uint16_t Part;
+
+ // STEP 1
+ while (Length)
+   {
+   Part = BATCH_BLOCK - Batch.OutLength;
+   if (Part > Length)
+     Part = Length;
+   memcpy(&BatchScratch->OutBlock[Batch.OutLength], Text, Part);
+   Batch.OutLength += Part;
+   Text += Part;
+   Length -= Part;
+   if ((Batch.OutLength == BATCH_BLOCK) && (!call_BatchFlush()))
+     return(FALSE);
+   }
+ return(TRUE);
+
+ } // END OF call_BatchPut
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BatchFlush
+ * Parameters: void
+ * Return: BOOLEAN
+ *
+ * Description: Writes the output block - FatFsMutex held for the write.  Returns FALSE if the
+ * write failed.
+ * STEP 1: Write and empty the block
+ *************************************************************************/
+ static BOOLEAN call_BatchFlush(void)
+ {
+
+ UINT BytesWritten;
+ FRESULT Result;
+
+ // STEP 1
+ if (!Batch.OutLength)
+   return(TRUE);
+ ctl_mutex_lock(&FatFsMutex, CTL_TIMEOUT_NONE, 0);
+ Result = f_write(&BatchScratch->OutFile, BatchScratch->OutBlock, Batch.OutLength, &BytesWritten);
+ ctl_mutex_unlock(&FatFsMutex);
+ if (BytesWritten != Batch.OutLength)
+   Result = FR_DISK_ERR;
+ Batch.OutLength = 0;
+ return(Result == FR_OK);
+
+ } // END OF call_BatchFlush
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BatchProgress
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Line 4 while the batch runs: the part of the input read and the rows done
+ * STEP 1: Show the progress
+ *************************************************************************/
+ static void call_BatchProgress(void)
+ {
+
+ uint32_t Percent = 100;
+ uint8_t LineText[2 * MAX_DISPLAY_LENGTH];
+
+ // STEP 1
+ if (f_size(&BatchScratch->InFile))
+   Percent = (uint32_t)(((uint64_t)Batch.BytesIn * 100) / f_size(&BatchScratch->InFile));
+ //                  01234567890123456789
+ sprintf(LineText, "BATCH %lu%% ROW %lu", Percent, Batch.Rows);
+ LineText[MAX_DISPLAY_LENGTH] = NULL_VALUE;
+ DIP204_clearLine(4);
+ DIP204_txt_engine(LineText, 4, 0, strlen(LineText));
+ Batch.ShownTime = ctl_get_current_time();
+
+ } // END OF call_BatchProgress
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BatchError
+ * Parameters: const uint8_t *, const uint8_t *
+ * Return: void
+ *
+ * Description: Shows a BATCH error as a math error - ATN clears it
+ * STEP 1: Set the error text and show
+ *************************************************************************/
+ static void call_BatchError(const uint8_t *Description, const uint8_t *Solution)
+ {
+
+ // STEP 1
+ strcpy(MathError.ErrorDescription, Description);
+ strcpy(MathError.ErrorSolution, Solution);
+ strcpy(NumericValue.AudioErrorFileName, I_AND_I_ERROR_WAV);
+ NumericValue.AudioPlayLevel = BASIC_HELP;
+ call_ShowMathError();
+
+ } // END OF call_BatchError
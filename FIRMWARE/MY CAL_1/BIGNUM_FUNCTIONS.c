@@ -0,0 +1,1470 @@
+/*****************************************************************
+ *
+ * File name:       BIGNUM_FUNCTIONS.C
+ * Description:     Exact big integer results of the HC15C - n!, y^x, nCr and nPr to any number of digits
+ * Author:          Hab S. Collector
+ * Date:            10/19/2026
+ * LAST EDIT:       10/19/2026
+ * Hardware:        NXP LPC1769
+ * Firmware Tool:   CrossStudio for ARM
+ * Notes:           This file should be written as to not be dependent on other includes.
+ *                  everything these functions need should be passed to them.
+ *                  It will be necessary to consult the reference documents and associated schematics to understand
+ *                  the operations of this firmware.
+ *                  A big number is an array of 32 bit limbs, least significant first.  Every number and all the
+ *                  scratch of an operation come from one arena (BigArena) used as a stack: an operation that
+ *                  needs more than the arena holds stops with a "too big" error - the arena size is the RAM cap.
+ *                  The arena is the scratch pool shared with the matrices and BATCH (see call_ScratchClaim):
+ *                  BIG can not run while a matrix is dimensioned, and the result kept for the view is lost to
+ *                  a DIM or a BATCH run.
+ *                  Multiplies of long numbers are Karatsuba, short ones schoolbook.  n! and the products of nCr
+ *                  and nPr are a product tree so the long multiplies are of near equal length numbers.  The
+ *                  result is taken to base 10^9 by divide and conquer: split by 10^(9 x 2^k), convert each half.
+ *                  The exact result is viewed a page at a time (lines 2 - 4) or saved to the SD card, X is set to
+ *                  the nearest double when it has one.
+ *****************************************************************/
+
+#include <ctl_api.h>
+#include "BIGNUM_FUNCTIONS.H"
+#include "PROGRAM_TASKS.H"
+#include "CORE_FUNCTIONS.H"
+#include "MATH_FUNCTIONS.H"
+#include "TOUCH_TASKS.H"
+#include "TIMERS_HC15C.H"
+#include "DIP204.H"
+#include "AUDIO_TASKS.H"
+#include "FAT_FS_INC/ff.h"
+#include "lpc_types.h"
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+
+// GLOBAL VARS
+// TYPES
+Type_BigNum BigNum;
+static uint32_t *BigArena;                       // THE SCRATCH POOL - SEE call_BigNumClaim
+// BIG n: DIGIT KEYS 0 - 5
+static const uint32_t BigDigitKey[BIGNUM_OPERATION_TOTAL] =
+  {
+  MASK_KEY_0, MASK_KEY_1, MASK_KEY_2, MASK_KEY_3, MASK_KEY_4, MASK_KEY_5
+  };
+static const uint8_t BigOpName[BIGNUM_OPERATION_TOTAL][6] =
+  {
+  "n!", "y^x", "nCr", "nPr", "VIEW", "BENCH"
+  };
+static const uint32_t BigPowerOf10[BIGNUM_CHUNK_DIGITS] =
+  {
+  1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL, 10000000UL, 100000000UL
+  };
+
+// EXTERN VARS
+extern Type_Program Program;
+extern Type_CalSettings CalSettings;
+extern Type_Register RegisterValue[TOTAL_REGISTERS];
+extern Type_Numeric NumericValue;
+extern Type_MathErrorDisplay MathError;
+extern BOOLEAN bln_LineLoaded;
+extern FRESULT FF_Result;
+extern CTL_MUTEX_t FatFsMutex;
+extern FIL FatFsFile;
+extern uint32_t SystemCoreClock;
+
+// PROTOTYPES LOCAL
+static void call_BigNumDigit(uint8_t);
+static void call_BigNumRun(uint8_t);
+static BOOLEAN call_BigNumArgument(double, double, uint32_t *);
+static BOOLEAN call_BigNumClaim(void);
+static double call_BigNumLog2Factorial(double);
+static void call_BigNumBenchmark(void);
+static void call_BigNumView(void);
+static void call_BigNumText(uint16_t, uint16_t, uint8_t *);
+static BOOLEAN call_BigNumSave(void);
+static double call_BigNumToDouble(void);
+static void call_BigNumError(const uint8_t *, const uint8_t *);
+static uint32_t *call_BigAlloc(uint16_t);
+static uint16_t call_BigLength(const uint32_t *, uint16_t);
+static uint16_t call_BigMulSmall(uint32_t *, uint16_t, uint32_t);
+static uint16_t call_BigDivSmall(uint32_t *, uint16_t, uint32_t, uint32_t *);
+static uint32_t call_BigAddTo(uint32_t *, uint16_t, const uint32_t *, uint16_t);
+static uint32_t call_BigSubFrom(uint32_t *, uint16_t, const uint32_t *, uint16_t);
+static void call_BigMulSchool(const uint32_t *, uint16_t, const uint32_t *, uint16_t, uint32_t *);
+static BOOLEAN call_BigKaratsuba(const uint32_t *, const uint32_t *, uint16_t, uint32_t *);
+static BOOLEAN call_BigMul(const uint32_t *, uint16_t, const uint32_t *, uint16_t, uint32_t *);
+static BOOLEAN call_BigDivMod(uint32_t *, uint16_t, const uint32_t *, uint16_t, uint32_t *);
+static uint32_t *call_BigProduct(uint32_t, uint32_t, uint16_t *);
+static uint32_t *call_BigPower(uint64_t, uint32_t, uint16_t *);
+static uint32_t *call_BigCombinations(uint32_t, uint32_t, uint16_t *);
+static BOOLEAN call_BigToChunks(uint32_t *, uint16_t);
+static BOOLEAN call_BigConvert(uint32_t *, uint16_t, uint32_t *, uint16_t, uint32_t **, const uint16_t *);
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BigNumKey
+ * Parameters: uint32_t
+ * Return: BOOLEAN
+ *
+ * Description: Called by the click task for every key that passed the filter.  Returns TRUE
+ * if the key was taken here and is not to go to the keypad switch.  While the BIG prefix waits
+ * only ATN (cancel) and the digit keys are enabled.  While the view of a result is shown only
+ * ATN (leave), 8 (page up), 2 (page down) and 5 (save to the SD card).
+ * STEP 1: Not waiting - not taken
+ * STEP 2: ATN cancels
+ * STEP 3: The operation digit
+ * STEP 4: The keys of the view
+ *************************************************************************/
+ BOOLEAN call_BigNumKey(uint32_t Key)
+ {
+
+ // STEP 1
+ if ((!BigNum.Prefix) && (!BigNum.View))
+   return(FALSE);
+
+ // STEP 2
+ if (Key == MASK_ATN_KEY)
+   {
+   BigNum.Prefix = BigNum.View = FALSE;
+   select_All_Normal_Keys();
+   call_FormatNumber();
+   return(TRUE);
+   }
+ if (!(Key & MASK_B_TOUCH_DATA))
+   return(TRUE);
+ Key &= ~MASK_B_TOUCH_DATA;
+
+ // STEP 3
+ if (BigNum.Prefix)
+   {
+   for (uint8_t Digit = 0; Digit < BIGNUM_OPERATION_TOTAL; Digit++)
+     {
+     if (Key == BigDigitKey[Digit])
+       call_BigNumDigit(Digit);
+     }
+   return(TRUE);
+   }
+
+ // STEP 4
+ if ((Key == MASK_KEY_UP) && (BigNum.ViewFirst))
+   {
+   BigNum.ViewFirst -= BIGNUM_VIEW_DIGITS;
+   call_BigNumView();
+   }
+ if ((Key == MASK_KEY_DOWN) && ((BigNum.ViewFirst + BIGNUM_VIEW_DIGITS) < BigNum.Digits))
+   {
+   BigNum.ViewFirst += BIGNUM_VIEW_DIGITS;
+   call_BigNumView();
+   }
+ if (Key == MASK_KEY_5)
+   {
+   if (call_BigNumSave())
+     {
+     //                                            01234567890123456789
+     DIP204_clearLine(1);
+     DIP204_txt_engine("SAVED HC15C_BIG.TXT", 1, 0, strlen("SAVED HC15C_BIG.TXT"));
+     }
+   else
+     {
+     BigNum.View = FALSE;
+     select_All_Normal_Keys();
+     call_BigNumError("SD write failed", "Check the SD card");
+     }
+   }
+ return(TRUE);
+
+ } // END OF call_BigNumKey
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BigNumPrefix
+ * Parameters: void
+ * Return: void
+ *
+ * Description: BIG - R shift 4.  The operations are shown on lines 1 - 3 and the next digit
+ * picks one (see enum BIGNUM_OPERATION).  CAL mode base 10 only.  A number being keyed is first
+ * entered - the operations take their integers from X and Y.
+ * STEP 1: Check the calculator can start a big operation
+ * STEP 2: Mask the keys to ATN and the digits, show the operations
+ *************************************************************************/
+ void call_BigNumPrefix(void)
+ {
+
+ uint8_t LineText[MAX_DISPLAY_LENGTH];
+
+ // STEP 1
+ if ((Program.Running) || (CalSettings.CalMode != CAL_MODE) || (CalSettings.CalError != NO_ERROR) || (CalSettings.CalBase != BASE_10))
+   return;
+ if (!bln_LineLoaded)
+   call_Enter();
+ if (CalSettings.CalError != NO_ERROR)
+   return;
+
+ // STEP 2
+ BigNum.Prefix = TRUE;
+ BigNum.View = FALSE;
+ CalSettings.Mask_KeyTouchA = CalSettings.Mask_KeyTouchB = NO_KEYS_SELECTED;
+ CalSettings.Mask_KeyTouchA = MASK_ATN_KEY;
+ CalSettings.Mask_KeyTouchB = MASK_0TO9_ONLY;
+ DIP204_set_cursor(CURSOR_OFF);
+ DIP204_clearDisplay();
+ //                  01234567890123456789
+ sprintf(LineText, "0n! 1y^x 2nCr 3nPr");
+ DIP204_txt_engine(LineText, 1, 0, strlen(LineText));
+ sprintf(LineText, "4VIEW 5BENCH");
+ DIP204_txt_engine(LineText, 2, 0, strlen(LineText));
+ sprintf(LineText, "EXACT INTEGER");
+ DIP204_txt_engine(LineText, 3, 0, strlen(LineText));
+ sprintf(LineText, "BIG _");
+ DIP204_txt_engine(LineText, 4, 0, strlen(LineText));
+
+ } // END OF call_BigNumPrefix
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BigNumDigit
+ * Parameters: uint8_t
+ * Return: void
+ *
+ * Description: The operation digit after BIG.
+ * STEP 1: Restore the keys
+ * STEP 2: Run the operation, view the last result or the benchmark
+ *************************************************************************/
+ static void call_BigNumDigit(uint8_t Digit)
+ {
+
+ // STEP 1
+ BigNum.Prefix = FALSE;
+ select_All_Normal_Keys();
+
+ // STEP 2
+ switch (Digit)
+   {
+   case BIGNUM_VIEW:
+     if ((!BigNum.Digits) || (!call_ScratchOwned(SCRATCH_BIGNUM)))
+       {
+       //                 01234567890123456789
+       call_BigNumError("No big result", "Run a BIG operation");
+       return;
+       }
+     BigNum.ViewFirst = 0;
+     call_BigNumView();
+   break;
+
+   case BIGNUM_BENCHMARK:
+     call_BigNumBenchmark();
+   break;
+
+   default:
+     call_BigNumRun(Digit);
+   break;
+   }
+
+ } // END OF call_BigNumDigit
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BigNumRun
+ * Parameters: uint8_t
+ * Return: void
+ *
+ * Description: Runs n!, y^x, nCr or nPr exactly.  n!: X is n.  y^x: Y is y (an integer of at most
+ * 53 bits, either sign) and X is x.  nCr, nPr: Y is n and X is r.  The size of the result is
+ * estimated first and an operation whose work does not fit the arena is not started.  As the real
+ * math n! replaces X and the others drop the stack - X is the result to double precision, or is
+ * left as it was when the result is larger than a double.  The exact result is then viewed.
+ * STEP 1: Check the arguments
+ * STEP 2: Estimate the result - too big for the arena is an error
+ * STEP 3: The exact result
+ * STEP 4: To base 10^9
+ * STEP 5: X and the view
+ *************************************************************************/
+ static void call_BigNumRun(uint8_t Operation)
+ {
+
+ uint32_t *Result = NULL,
+          X,
+          Y = 0,
+          Smaller;
+ uint16_t Length = 0;
+ double Bits,
+        Approximate;
+ BOOLEAN Negative = FALSE;
+
+ // STEP 1
+ if (!call_BigNumArgument(RegisterValue[0].NumericValue, BIGNUM_MAX_ARGUMENT, &X))
+   return;
+ if (Operation == BIGNUM_POWER)
+   {
+   if ((RegisterValue[1].NumericValue != floor(RegisterValue[1].NumericValue)) || (fabs(RegisterValue[1].NumericValue) > BIGNUM_MAX_BASE))
+     {
+     //                 01234567890123456789
+     call_BigNumError("y not an integer", "Integer y to 2^53");
+     return;
+     }
+   Negative = ((RegisterValue[1].NumericValue < 0.0) && (X & 1));
+   }
+ else if (Operation != BIGNUM_FACTORIAL)
+   {
+   if (!call_BigNumArgument(RegisterValue[1].NumericValue, BIGNUM_MAX_ARGUMENT, &Y))
+     return;
+   if (X > Y)
+     {
+     call_BigNumError("r larger than n", "Key r <= n");
+     return;
+     }
+   }
+
+ // STEP 2
+ switch (Operation)
+   {
+   case BIGNUM_FACTORIAL:
+     Bits = call_BigNumLog2Factorial(X);
+   break;
+   case BIGNUM_POWER:
+     Bits = (double)X * log(fmax(fabs(RegisterValue[1].NumericValue), 1.0)) * BIGNUM_LOG2_E;
+   break;
+   case BIGNUM_COMBINATIONS:
+     // THE NUMERATOR - n DOWN TO n - r + 1 WITH r THE SMALLER OF r AND n - r
+     Smaller = (((Y - X) < X) ? (Y - X) : X);
+     Bits = call_BigNumLog2Factorial(Y) - call_BigNumLog2Factorial(Y - Smaller);
+   break;
+   default:
+     Bits = call_BigNumLog2Factorial(Y) - call_BigNumLog2Factorial(Y - X);
+   break;
+   }
+ if ((((Bits / 32.0) + 2.0) * BIGNUM_WORK_FACTOR) > BIGNUM_ARENA_LIMBS)
+   {
+   call_BigNumError("Result too big", "Over the RAM budget");
+   return;
+   }
+ if (!call_BigNumClaim())
+   return;
+
+ // STEP 3
+ BigNum.Top = 0;
+ BigNum.Digits = 0;
+ switch (Operation)
+   {
+   case BIGNUM_FACTORIAL:
+     Result = call_BigProduct(1, X, &Length);
+   break;
+   case BIGNUM_POWER:
+     Result = call_BigPower((uint64_t)fabs(RegisterValue[1].NumericValue), X, &Length);
+   break;
+   case BIGNUM_COMBINATIONS:
+     Result = call_BigCombinations(Y, X, &Length);
+   break;
+   case BIGNUM_PERMUTATIONS:
+     Result = (X ? call_BigProduct((Y - X) + 1, Y, &Length) : call_BigProduct(1, 0, &Length));
+   break;
+   }
+
+ // STEP 4
+ if ((Result == NULL) || (!call_BigToChunks(Result, Length)))
+   {
+   BigNum.Top = 0;
+   BigNum.Digits = 0;
+   call_BigNumError("Result too big", "Over the RAM budget");
+   return;
+   }
+ BigNum.Negative = Negative;
+ BigNum.Operation = Operation;
+
+ // STEP 5
+ Approximate = call_BigNumToDouble();
+ if (isfinite(Approximate))
+   {
+   if (Operation == BIGNUM_FACTORIAL)
+     call_ChkAndDisplayRaise(Approximate);
+   else
+     call_ChkAndDisplayDrop(Approximate);
+   }
+ BigNum.ViewFirst = 0;
+ call_BigNumView();
+
+ } // END OF call_BigNumRun
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BigNumArgument
+ * Parameters: double, double, uint32_t *
+ * Return: BOOLEAN
+ *
+ * Description: An integer argument 0 - Largest.  Shows the error and returns FALSE if not.
+ * STEP 1: Check and convert
+ *************************************************************************/
+ static BOOLEAN call_BigNumArgument(double Value, double Largest, uint32_t *Argument)
+ {
+
+ // STEP 1
+ if ((Value != floor(Value)) || (Value < 0.0) || (Value > Largest))
+   {
+   //                 01234567890123456789
+   call_BigNumError("Not an integer >= 0", "Key 0 to 4294967295");
+   return(FALSE);
+   }
+ *Argument = (uint32_t)Value;
+ return(TRUE);
+
+ } // END OF call_BigNumArgument
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BigNumClaim
+ * Parameters: void
+ * Return: BOOLEAN
+ *
+ * Description: The scratch pool as the arena.  Shows the error and returns FALSE if the matrices
+ * or BATCH hold it.
+ * STEP 1: Claim the pool
+ *************************************************************************/
+ static BOOLEAN call_BigNumClaim(void)
+ {
+
+ // STEP 1
+ BigArena = (uint32_t *)call_ScratchClaim(SCRATCH_BIGNUM, BIGNUM_ARENA_LIMBS * sizeof(uint32_t));
+ if (BigArena != NULL)
+   return(TRUE);
+ //                 01234567890123456789
+ call_BigNumError("Memory in use", "DIM the matrices 0");
+ return(FALSE);
+
+ } // END OF call_BigNumClaim
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BigNumLog2Factorial
+ * Parameters: double
+ * Return: double
+ *
+ * Description: log2(n!) by Stirling - n log2(n) - n log2(e) + log2(2 PI n) / 2.  Low by less
+ * than 1 / (12 n ln 2) bits, enough to size a result before it is made.
+ * STEP 1: 0! and 1! are 1
+ * STEP 2: Stirling
+ *************************************************************************/
+ static double call_BigNumLog2Factorial(double n)
+ {
+
+ // STEP 1
+ if (n < 2.0)
+   return(0.0);
+
+ // STEP 2
+ return(((n * log(n)) - n + (0.5 * log(BIGNUM_TWO_PI * n))) * BIGNUM_LOG2_E);
+
+ } // END OF call_BigNumLog2Factorial
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BigNumBenchmark
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Times BIGNUM_BENCH_N! - the CPU cycles (DWT cycle counter) of the product tree
+ * with Karatsuba and with schoolbook multiplies only, and of the divide and conquer base 10^9
+ * conversion.  The result is kept - BIG 4 views it.  Shown until the next key:
+ * 500! <digits per second of product and conversion>DIG/S
+ * KARAT / SCHOOL / BASE10 <cycles>
+ * STEP 1: Schoolbook product tree
+ * STEP 2: Karatsuba product tree
+ * STEP 3: Conversion
+ * STEP 4: Display
+ *************************************************************************/
+ static void call_BigNumBenchmark(void)
+ {
+
+ uint32_t *Result,
+          StartCount,
+          CyclesSchool,
+          CyclesKaratsuba,
+          CyclesConvert;
+ uint16_t Length;
+ uint8_t LineText[2 * MAX_DISPLAY_LENGTH];
+
+ // STEP 1
+ if (!call_BigNumClaim())
+   return;
+ init_CycleCounter();
+ BigNum.Top = 0;
+ BigNum.Digits = 0;
+ BigNum.SchoolOnly = TRUE;
+ StartCount = CYCLE_COUNT;
+ Result = call_BigProduct(1, BIGNUM_BENCH_N, &Length);
+ CyclesSchool = CYCLE_COUNT - StartCount;
+ BigNum.SchoolOnly = FALSE;
+
+ // STEP 2
+ BigNum.Top = 0;
+ StartCount = CYCLE_COUNT;
+ Result = call_BigProduct(1, BIGNUM_BENCH_N, &Length);
+ CyclesKaratsuba = CYCLE_COUNT - StartCount;
+
+ // STEP 3
+ StartCount = CYCLE_COUNT;
+ if ((Result == NULL) || (!call_BigToChunks(Result, Length)))
+   {
+   BigNum.Top = 0;
+   BigNum.Digits = 0;
+   call_BigNumError("Result too big", "Over the RAM budget");
+   return;
+   }
+ CyclesConvert = CYCLE_COUNT - StartCount;
+ BigNum.Negative = FALSE;
+ BigNum.Operation = BIGNUM_FACTORIAL;
+
+ // STEP 4
+ DIP204_set_cursor(CURSOR_OFF);
+ DIP204_clearDisplay();
+ //                  01234567890123456789
+ sprintf(LineText, "%u! %luDIG/S", BIGNUM_BENCH_N, (uint32_t)(((uint64_t)BigNum.Digits * SystemCoreClock) / (CyclesKaratsuba + CyclesConvert)));
+ LineText[MAX_DISPLAY_LENGTH] = NULL_VALUE;
+ DIP204_txt_engine(LineText, 1, 0, strlen(LineText));
+ sprintf(LineText, "KARAT  %lu", CyclesKaratsuba);
+ DIP204_txt_engine(LineText, 2, 0, strlen(LineText));
+ sprintf(LineText, "SCHOOL %lu", CyclesSchool);
+ DIP204_txt_engine(LineText, 3, 0, strlen(LineText));
+ sprintf(LineText, "BASE10 %lu", CyclesConvert);
+ DIP204_txt_engine(LineText, 4, 0, strlen(LineText));
+
+ } // END OF call_BigNumBenchmark
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BigNumView
+ * Parameters: void
+ * Return: void
+ *
+ * Description: One page of the result: line 1 the operation, sign, number of digits and page,
+ * lines 2 - 4 the digits from ViewFirst, 20 to a line.  8 / 2 page up / down, 5 saves the
+ * result to the SD card, ATN leaves.
+ * STEP 1: Mask the keys
+ * STEP 2: Header
+ * STEP 3: Digits
+ *************************************************************************/
+ static void call_BigNumView(void)
+ {
+
+ uint8_t LineText[2 * MAX_DISPLAY_LENGTH];
+ uint16_t First;
+
+ // STEP 1
+ BigNum.View = TRUE;
+ CalSettings.Mask_KeyTouchA = CalSettings.Mask_KeyTouchB = NO_KEYS_SELECTED;
+ CalSettings.Mask_KeyTouchA = MASK_ATN_KEY;
+ CalSettings.Mask_KeyTouchB = (MASK_KEY_UP | MASK_KEY_DOWN | MASK_KEY_5);
+
+ // STEP 2
+ DIP204_set_cursor(CURSOR_OFF);
+ DIP204_clearDisplay();
+ //                  01234567890123456789
+ sprintf(LineText, "%s %c%u DIG %u/%u", BigOpName[BigNum.Operation], (BigNum.Negative ? '-' : '+'), BigNum.Digits,
+         (BigNum.ViewFirst / BIGNUM_VIEW_DIGITS) + 1, ((BigNum.Digits - 1) / BIGNUM_VIEW_DIGITS) + 1);
+ LineText[MAX_DISPLAY_LENGTH] = NULL_VALUE;
+ DIP204_txt_engine(LineText, 1, 0, strlen(LineText));
+
+ // STEP 3
+ for (uint8_t Line = 0; Line < BIGNUM_VIEW_LINES; Line++)
+   {
+   First = BigNum.ViewFirst + (Line * MAX_DISPLAY_LENGTH);
+   if (First >= BigNum.Digits)
+     break;
+   call_BigNumText(First, MAX_DISPLAY_LENGTH, LineText);
+   DIP204_txt_engine(LineText, Line + 2, 0, strlen(LineText));
+   }
+
+ } // END OF call_BigNumView
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BigNumText
+ * Parameters: uint16_t, uint16_t, uint8_t *
+ * Return: void
+ *
+ * Description: Count digits of the result from digit First (0 is the most significant) as a
+ * NULL terminated string - fewer at the end of the number.
+ * STEP 1: Each digit from its chunk
+ *************************************************************************/
+ static void call_BigNumText(uint16_t First, uint16_t Count, uint8_t *Text)
+ {
+
+ uint16_t Place;
+
+ // STEP 1
+ for (; (Count) && (First < BigNum.Digits); Count--, First++)
+   {
+   // PLACE OF THE DIGIT FROM THE LEAST SIGNIFICANT
+   Place = (BigNum.Digits - 1) - First;
+   *Text++ = '0' + ((BigArena[Place / BIGNUM_CHUNK_DIGITS] / BigPowerOf10[Place % BIGNUM_CHUNK_DIGITS]) % 10);
+   }
+ *Text = NULL_VALUE;
+
+ } // END OF call_BigNumText
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BigNumSave
+ * Parameters: void
+ * Return: BOOLEAN
+ *
+ * Description: Writes the result to BIGNUM_FILE_NAME on the SD card as one line of text.
+ * Returns FALSE if the file could not be written.  FatFsMutex is held from the open to the close.
+ * STEP 1: Create the file
+ * STEP 2: Sign and digits a block at a time
+ *************************************************************************/
+ static BOOLEAN call_BigNumSave(void)
+ {
+
+ uint8_t Block[BIGNUM_FILE_BLOCK + 1];
+ UINT BytesWritten;
+ BOOLEAN Written;
+
+ // STEP 1
+ ctl_mutex_lock(&FatFsMutex, CTL_TIMEOUT_NONE, 0);
+ FF_Result = f_open(&FatFsFile, BIGNUM_FILE_NAME, FA_CREATE_ALWAYS | FA_WRITE);
+ if (FF_Result != FR_OK)
+   {
+   ctl_mutex_unlock(&FatFsMutex);
+   return(FALSE);
+   }
+
+ // STEP 2
+ if (BigNum.Negative)
+   FF_Result = f_write(&FatFsFile, "-", 1, &BytesWritten);
+ for (uint16_t First = 0; (FF_Result == FR_OK) && (First < BigNum.Digits); First += BIGNUM_FILE_BLOCK)
+   {
+   call_BigNumText(First, BIGNUM_FILE_BLOCK, Block);
+   FF_Result = f_write(&FatFsFile, Block, strlen(Block), &BytesWritten);
+   if (BytesWritten != strlen(Block))
+     FF_Result = FR_DISK_ERR;
+   }
+ if (FF_Result == FR_OK)
+   FF_Result = f_write(&FatFsFile, "\r\n", 2, &BytesWritten);
+ f_close(&FatFsFile);
+ Written = (FF_Result == FR_OK);
+ ctl_mutex_unlock(&FatFsMutex);
+ return(Written);
+
+ } // END OF call_BigNumSave
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BigNumToDouble
+ * Parameters: void
+ * Return: double
+ *
+ * Description: The result to double precision from its 3 most significant chunks - infinite
+ * when it is larger than a double.
+ * STEP 1: The top chunks
+ * STEP 2: Scale by the chunks below them
+ *************************************************************************/
+ static double call_BigNumToDouble(void)
+ {
+
+ double Value = 0.0;
+ uint16_t Chunk = BigNum.Chunks;
+
+ // STEP 1
+ while ((Chunk) && ((BigNum.Chunks - Chunk) < 3))
+   {
+   Chunk--;
+   Value = (Value * (double)BIGNUM_CHUNK) + (double)BigArena[Chunk];
+   }
+
+ // STEP 2
+ if (Chunk)
+   Value *= pow(10.0, (double)(Chunk * BIGNUM_CHUNK_DIGITS));
+ return(BigNum.Negative ? -Value : Value);
+
+ } // END OF call_BigNumToDouble
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BigNumError
+ * Parameters: const uint8_t *, const uint8_t *
+ * Return: void
+ *
+ * Description: Shows a math error of a big operation.  Each line at most 19 characters.
+ * STEP 1: Set and show the error
+ *************************************************************************/
+ static void call_BigNumError(const uint8_t *Description, const uint8_t *Solution)
+ {
+
+ // STEP 1
+ strcpy(MathError.ErrorDescription, Description);
+ strcpy(MathError.ErrorSolution, Solution);
+ strcpy(NumericValue.AudioErrorFileName, I_AND_I_ERROR_WAV);
+ NumericValue.AudioPlayLevel = BASIC_HELP;
+ call_ShowMathError();
+
+ } // END OF call_BigNumError
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BigAlloc
+ * Parameters: uint16_t
+ * Return: uint32_t *
+ *
+ * Description: Limbs from the top of the arena, NULL if the arena does not have them.  Memory
+ * is given back by setting BigNum.Top back to where it was.
+ * STEP 1: Take the limbs
+ *************************************************************************/
+ static uint32_t *call_BigAlloc(uint16_t Limbs)
+ {
+
+ uint32_t *Block;
+
+ // STEP 1
+ if (Limbs > (BIGNUM_ARENA_LIMBS - BigNum.Top))
+   return(NULL);
+ Block = &BigArena[BigNum.Top];
+ BigNum.Top += Limbs;
+ return(Block);
+
+ } // END OF call_BigAlloc
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BigLength
+ * Parameters: const uint32_t *, uint16_t
+ * Return: uint16_t
+ *
+ * Description: The length of A without its most significant zero limbs.
+ * STEP 1: Drop the zero limbs
+ *************************************************************************/
+ static uint16_t call_BigLength(const uint32_t *A, uint16_t Length)
+ {
+
+ // STEP 1
+ while ((Length) && (!A[Length - 1]))
+   Length--;
+ return(Length);
+
+ } // END OF call_BigLength
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BigMulSmall
+ * Parameters: uint32_t *, uint16_t, uint32_t
+ * Return: uint16_t
+ *
+ * Description: A = A x Multiplier in place, returns the new length.  A must have room for
+ * one more limb.
+ * STEP 1: Multiply each limb with the carry
+ *************************************************************************/
+ static uint16_t call_BigMulSmall(uint32_t *A, uint16_t Length, uint32_t Multiplier)
+ {
+
+ uint64_t Product;
+ uint32_t Carry = 0;
+
+ // STEP 1
+ for (uint16_t Index = 0; Index < Length; Index++)
+   {
+   Product = ((uint64_t)A[Index] * Multiplier) + Carry;
+   A[Index] = (uint32_t)Product;
+   Carry = (uint32_t)(Product >> 32);
+   }
+ if (Carry)
+   A[Length++] = Carry;
+ return(Length);
+
+ } // END OF call_BigMulSmall
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BigDivSmall
+ * Parameters: uint32_t *, uint16_t, uint32_t, uint32_t *
+ * Return: uint16_t
+ *
+ * Description: A = A / Divisor in place, the remainder to Remainder.  Returns the new length.
+ * STEP 1: Divide from the most significant limb
+ *************************************************************************/
+ static uint16_t call_BigDivSmall(uint32_t *A, uint16_t Length, uint32_t Divisor, uint32_t *Remainder)
+ {
+
+ uint64_t Dividend;
+ uint32_t Carry = 0;
+
+ // STEP 1
+ for (uint16_t Index = Length; Index > 0; Index--)
+   {
+   Dividend = ((uint64_t)Carry << 32) | A[Index - 1];
+   A[Index - 1] = (uint32_t)(Dividend / Divisor);
+   Carry = (uint32_t)(Dividend % Divisor);
+   }
+ *Remainder = Carry;
+ return(call_BigLength(A, Length));
+
+ } // END OF call_BigDivSmall
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BigAddTo
+ * Parameters: uint32_t *, uint16_t, const uint32_t *, uint16_t
+ * Return: uint32_t
+ *
+ * Description: A = A + B over the ALength limbs of A (ALength >= BLength).  Returns the carry
+ * out of A.
+ * STEP 1: Add B and carry on through A
+ *************************************************************************/
+ static uint32_t call_BigAddTo(uint32_t *A, uint16_t ALength, const uint32_t *B, uint16_t BLength)
+ {
+
+ uint64_t Sum;
+ uint32_t Carry = 0;
+
+ // STEP 1
+ for (uint16_t Index = 0; Index < ALength; Index++)
+   {
+   if ((Index >= BLength) && (!Carry))
+     break;
+   Sum = (uint64_t)A[Index] + Carry + ((Index < BLength) ? B[Index] : 0);
+   A[Index] = (uint32_t)Sum;
+   Carry = (uint32_t)(Sum >> 32);
+   }
+ return(Carry);
+
+ } // END OF call_BigAddTo
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BigSubFrom
+ * Parameters: uint32_t *, uint16_t, const uint32_t *, uint16_t
+ * Return: uint32_t
+ *
+ * Description: A = A - B over the ALength limbs of A (ALength >= BLength).  Returns the borrow
+ * out of A.
+ * STEP 1: Subtract B and borrow on through A
+ *************************************************************************/
+ static uint32_t call_BigSubFrom(uint32_t *A, uint16_t ALength, const uint32_t *B, uint16_t BLength)
+ {
+
+ uint64_t Difference;
+ uint32_t Borrow = 0;
+
+ // STEP 1
+ for (uint16_t Index = 0; Index < ALength; Index++)
+   {
+   if ((Index >= BLength) && (!Borrow))
+     break;
+   Difference = (uint64_t)A[Index] - Borrow - ((Index < BLength) ? B[Index] : 0);
+   A[Index] = (uint32_t)Difference;
+   Borrow = (uint32_t)(Difference >> 63);
+   }
+ return(Borrow);
+
+ } // END OF call_BigSubFrom
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BigMulSchool
+ * Parameters: const uint32_t *, uint16_t, const uint32_t *, uint16_t, uint32_t *
+ * Return: void
+ *
+ * Description: Result = A x B, ALength + BLength limbs, by schoolbook multiply.  Result must
+ * not be A or B.
+ * STEP 1: Clear the result
+ * STEP 2: A row of partial products for each limb of A
+ *************************************************************************/
+ static void call_BigMulSchool(const uint32_t *A, uint16_t ALength, const uint32_t *B, uint16_t BLength, uint32_t *Result)
+ {
+
+ uint64_t Product;
+ uint32_t Carry;
+
+ // STEP 1
+ memset(Result, 0, (ALength + BLength) * sizeof(uint32_t));
+
+ // STEP 2
+ for (uint16_t Row = 0; Row < ALength; Row++)
+   {
+   Carry = 0;
+   for (uint16_t Col = 0; Col < BLength; Col++)
+     {
+     Product = ((uint64_t)A[Row] * B[Col]) + Result[Row + Col] + Carry;
+     Result[Row + Col] = (uint32_t)Product;
+     Carry = (uint32_t)(Product >> 32);
+     }
+   Result[Row + BLength] = Carry;
+   }
+
+ } // END OF call_BigMulSchool
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BigKaratsuba
+ * Parameters: const uint32_t *, const uint32_t *, uint16_t, uint32_t *
+ * Return: BOOLEAN
+ *
+ * Description: Result = A x B, both Length limbs, Result 2 x Length limbs.  With A = A1 b + A0
+ * and B = B1 b + B0 the product is A1B1 b^2 + ((A0 + A1)(B0 + B1) - A0B0 - A1B1) b + A0B0 -
+ * three half length multiplies for four.  A0B0 and A1B1 go straight to the result, the middle
+ * product is made in the arena.  Returns FALSE if the arena is full.
+ * STEP 1: Short numbers are schoolbook
+ * STEP 2: A0B0 and A1B1 to the result
+ * STEP 3: (A0 + A1)(B0 + B1)
+ * STEP 4: Less A0B0 and A1B1, add in at b
+ *************************************************************************/
+ static BOOLEAN call_BigKaratsuba(const uint32_t *A, const uint32_t *B, uint16_t Length, uint32_t *Result)
+ {
+
+ uint16_t Low = Length / 2,
+          High = Length - Low,
+          Mark = BigNum.Top;
+ uint32_t *SumA,
+          *SumB,
+          *Middle;
+
+ // STEP 1
+ if ((Length < BIGNUM_KARATSUBA_LIMBS) || (BigNum.SchoolOnly))
+   {
+   call_BigMulSchool(A, Length, B, Length, Result);
+   return(TRUE);
+   }
+
+ // STEP 2
+ if ((!call_BigKaratsuba(A, B, Low, Result)) || (!call_BigKaratsuba(&A[Low], &B[Low], High, &Result[2 * Low])))
+   return(FALSE);
+
+ // STEP 3
+ SumA = call_BigAlloc(High + 1);
+ SumB = call_BigAlloc(High + 1);
+ Middle = call_BigAlloc(2 * (High + 1));
+ if (Middle == NULL)
+   {
+   BigNum.Top = Mark;
+   return(FALSE);
+   }
+ memcpy(SumA, &A[Low], High * sizeof(uint32_t));
+ memcpy(SumB, &B[Low], High * sizeof(uint32_t));
+ SumA[High] = SumB[High] = 0;
+ call_BigAddTo(SumA, High + 1, A, Low);
+ call_BigAddTo(SumB, High + 1, B, Low);
+ if (!call_BigKaratsuba(SumA, SumB, High + 1, Middle))
+   {
+   BigNum.Top = Mark;
+   return(FALSE);
+   }
+
+ // STEP 4
+ call_BigSubFrom(Middle, 2 * (High + 1), Result, 2 * Low);
+ call_BigSubFrom(Middle, 2 * (High + 1), &Result[2 * Low], 2 * High);
+ call_BigAddTo(&Result[Low], (2 * Length) - Low, Middle, 2 * (High + 1));
+ BigNum.Top = Mark;
+ return(TRUE);
+
+ } // END OF call_BigKaratsuba
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BigMul
+ * Parameters: const uint32_t *, uint16_t, const uint32_t *, uint16_t, uint32_t *
+ * Return: BOOLEAN
+ *
+ * Description: Result = A x B, ALength + BLength limbs.  Result must not be A or B.  When both
+ * are long the longer is cut in pieces the length of the shorter and each piece is a Karatsuba
+ * multiply.  Returns FALSE if the arena is full.
+ * STEP 1: The longer number first, short numbers are schoolbook
+ * STEP 2: Karatsuba of each piece of A, added in at its place
+ *************************************************************************/
+ static BOOLEAN call_BigMul(const uint32_t *A, uint16_t ALength, const uint32_t *B, uint16_t BLength, uint32_t *Result)
+ {
+
+ const uint32_t *Swap;
+ uint32_t *Piece,
+          *Product;
+ uint16_t Count,
+          Mark = BigNum.Top;
+
+ // STEP 1
+ if (ALength < BLength)
+   {
+   Swap = A;
+   A = B;
+   B = Swap;
+   Count = ALength;
+   ALength = BLength;
+   BLength = Count;
+   }
+ if ((BLength < BIGNUM_KARATSUBA_LIMBS) || (BigNum.SchoolOnly))
+   {
+   call_BigMulSchool(A, ALength, B, BLength, Result);
+   return(TRUE);
+   }
+
+ // STEP 2
+ Piece = call_BigAlloc(BLength);
+ Product = call_BigAlloc(2 * BLength);
+ if (Product == NULL)
+   {
+   BigNum.Top = Mark;
+   return(FALSE);
+   }
+ memset(Result, 0, (ALength + BLength) * sizeof(uint32_t));
+ for (uint16_t Offset = 0; Offset < ALength; Offset += BLength)
+   {
+   Count = (((ALength - Offset) < BLength) ? (ALength - Offset) : BLength);
+   memset(Piece, 0, BLength * sizeof(uint32_t));
+   memcpy(Piece, &A[Offset], Count * sizeof(uint32_t));
+   if (!call_BigKaratsuba(Piece, B, BLength, Product))
+     {
+     BigNum.Top = Mark;
+     return(FALSE);
+     }
+   call_BigAddTo(&Result[Offset], (ALength + BLength) - Offset, Product, Count + BLength);
+   }
+ BigNum.Top = Mark;
+ return(TRUE);
+
+ } // END OF call_BigMul
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BigDivMod
+ * Parameters: uint32_t *, uint16_t, const uint32_t *, uint16_t, uint32_t *
+ * Return: BOOLEAN
+ *
+ * Description: Quotient = U / V (ULength - VLength + 1 limbs), the remainder replaces U.  V has
+ * no zero top limb and ULength >= VLength.  Knuth algorithm D: V is shifted so its top bit is set,
+ * then each quotient limb is estimated from the top two limbs and corrected at most twice.
+ * Returns FALSE if the arena is full.
+ * STEP 1: One limb divisor
+ * STEP 2: Normalize copies of U and V
+ * STEP 3: A quotient limb at a time - estimate, multiply and subtract, add back
+ * STEP 4: The remainder back to U
+ *************************************************************************/
+ static BOOLEAN call_BigDivMod(uint32_t *U, uint16_t ULength, const uint32_t *V, uint16_t VLength, uint32_t *Quotient)
+ {
+
+ uint32_t *UShifted,
+          *VShifted,
+          Remainder;
+ uint64_t Estimate,
+          EstimateRemainder,
+          Product;
+ int64_t Borrow,
+         Difference;
+ uint16_t Mark = BigNum.Top;
+ uint8_t Shift = 0;
+
+ // STEP 1
+ if (VLength == 1)
+   {
+   memcpy(Quotient, U, ULength * sizeof(uint32_t));
+   call_BigDivSmall(Quotient, ULength, V[0], &Remainder);
+   memset(U, 0, ULength * sizeof(uint32_t));
+   U[0] = Remainder;
+   return(TRUE);
+   }
+
+ // STEP 2
+ UShifted = call_BigAlloc(ULength + 1);
+ VShifted = call_BigAlloc(VLength);
+ if ((UShifted == NULL) || (VShifted == NULL))
+   {
+   BigNum.Top = Mark;
+   return(FALSE);
+   }
+ while (!(V[VLength - 1] & (0x80000000UL >> Shift)))
+   Shift++;
+ for (uint16_t Index = VLength - 1; Index > 0; Index--)
+   VShifted[Index] = (V[Index] << Shift) | (Shift ? (V[Index - 1] >> (32 - Shift)) : 0);
+ VShifted[0] = V[0] << Shift;
+ UShifted[ULength] = (Shift ? (U[ULength - 1] >> (32 - Shift)) : 0);
+ for (uint16_t Index = ULength - 1; Index > 0; Index--)
+   UShifted[Index] = (U[Index] << Shift) | (Shift ? (U[Index - 1] >> (32 - Shift)) : 0);
+ UShifted[0] = U[0] << Shift;
+
+ // STEP 3
+ for (int16_t Limb = ULength - VLength; Limb >= 0; Limb--)
+   {
+   Estimate = (((uint64_t)UShifted[Limb + VLength] << 32) | UShifted[Limb + VLength - 1]) / VShifted[VLength - 1];
+   EstimateRemainder = (((uint64_t)UShifted[Limb + VLength] << 32) | UShifted[Limb + VLength - 1]) - (Estimate * VShifted[VLength - 1]);
+   while ((Estimate >> 32) || ((Estimate * VShifted[VLength - 2]) > ((EstimateRemainder << 32) | UShifted[Limb + VLength - 2])))
+     {
+     Estimate--;
+     EstimateRemainder += VShifted[VLength - 1];
+     if (EstimateRemainder >> 32)
+       break;
+     }
+   Borrow = 0;
+   for (uint16_t Index = 0; Index < VLength; Index++)
+     {
+     Product = Estimate * VShifted[Index];
+     Difference = (int64_t)UShifted[Index + Limb] - Borrow - (int64_t)(Product & 0xFFFFFFFFUL);
+     UShifted[Index + Limb] = (uint32_t)Difference;
+     Borrow = (int64_t)(Product >> 32) - (Difference >> 32);
+     }
+   Difference = (int64_t)UShifted[Limb + VLength] - Borrow;
+   UShifted[Limb + VLength] = (uint32_t)Difference;
+   Quotient[Limb] = (uint32_t)Estimate;
+   // ESTIMATE ONE TOO LARGE - RARE
+   if (Difference < 0)
+     {
+     Quotient[Limb]--;
+     UShifted[Limb + VLength] += call_BigAddTo(&UShifted[Limb], VLength, VShifted, VLength);
+     }
+   }
+
+ // STEP 4
+ memset(U, 0, ULength * sizeof(uint32_t));
+ for (uint16_t Index = 0; Index < VLength; Index++)
+   U[Index] = (UShifted[Index] >> Shift) | (Shift ? (UShifted[Index + 1] << (32 - Shift)) : 0);
+ BigNum.Top = Mark;
+ return(TRUE);
+
+ } // END OF call_BigDivMod
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BigProduct
+ * Parameters: uint32_t, uint32_t, uint16_t *
+ * Return: uint32_t *
+ *
+ * Description: First x (First + 1) x ... x Last (1 if First > Last) on the top of the arena,
+ * its length to Length.  A product tree: the range is split in halves and the two products
+ * multiplied, so the long multiplies are of near equal lengths (Karatsuba).  A short range is
+ * multiplied in one limb at a time.  Returns NULL if the arena is full.
+ * STEP 1: Short range
+ * STEP 2: The products of the halves
+ * STEP 3: Their product down to where the first half was
+ *************************************************************************/
+ static uint32_t *call_BigProduct(uint32_t First, uint32_t Last, uint16_t *Length)
+ {
+
+ uint32_t *Left,
+          *Right,
+          *Result,
+          Middle;
+ uint16_t LeftLength,
+          RightLength,
+          Start = BigNum.Top;
+
+ // STEP 1
+ if ((First > Last) || ((Last - First) < BIGNUM_LEAF_FACTORS))
+   {
+   Result = call_BigAlloc(((First > Last) ? 0 : (Last - First)) + 2);
+   if (Result == NULL)
+     return(NULL);
+   Result[0] = 1;
+   *Length = 1;
+   for (uint32_t Factor = First; Factor <= Last; Factor++)
+     {
+     *Length = call_BigMulSmall(Result, *Length, Factor);
+     // Last MAY BE THE LARGEST uint32_t
+     if (Factor == Last)
+       break;
+     }
+   *Length = call_BigLength(Result, *Length);
+   BigNum.Top = Start + *Length;
+   return(Result);
+   }
+
+ // STEP 2
+ Middle = First + ((Last - First) / 2);
+ Left = call_BigProduct(First, Middle, &LeftLength);
+ Right = ((Left == NULL) ? NULL : call_BigProduct(Middle + 1, Last, &RightLength));
+ Result = ((Right == NULL) ? NULL : call_BigAlloc(LeftLength + RightLength));
+ if ((Result == NULL) || (!call_BigMul(Left, LeftLength, Right, RightLength, Result)))
+   {
+   BigNum.Top = Start;
+   return(NULL);
+   }
+
+ // STEP 3
+ *Length = call_BigLength(Result, LeftLength + RightLength);
+ memmove(&BigArena[Start], Result, *Length * sizeof(uint32_t));
+ BigNum.Top = Start + *Length;
+ return(&BigArena[Start]);
+
+ } // END OF call_BigProduct
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BigPower
+ * Parameters: uint64_t, uint32_t, uint16_t *
+ * Return: uint32_t *
+ *
+ * Description: Base ^ Power on the top of the arena, its length to Length.  Left to right
+ * binary powering: square for each bit of Power, times Base for each 1 bit - the squares are
+ * Karatsuba.  0^0 is 1.  Returns NULL if the arena is full.
+ * STEP 1: Base as limbs, the result 1
+ * STEP 2: Square and multiply from the top bit of Power
+ *************************************************************************/
+ static uint32_t *call_BigPower(uint64_t Base, uint32_t Power, uint16_t *Length)
+ {
+
+ uint32_t BaseLimb[2],
+          *Result,
+          *Product;
+ uint16_t BaseLength,
+          Start = BigNum.Top;
+ uint8_t Bit = 32;
+
+ // STEP 1
+ BaseLimb[0] = (uint32_t)Base;
+ BaseLimb[1] = (uint32_t)(Base >> 32);
+ BaseLength = (BaseLimb[1] ? 2 : 1);
+ Result = call_BigAlloc(1);
+ if (Result == NULL)
+   return(NULL);
+ Result[0] = 1;
+ *Length = 1;
+
+ // STEP 2
+ while ((Bit) && (!(Power & ((uint32_t)1 << (Bit - 1)))))
+   Bit--;
+ for (; Bit; Bit--)
+   {
+   Product = call_BigAlloc(2 * *Length);
+   if ((Product == NULL) || (!call_BigMul(Result, *Length, Result, *Length, Product)))
+     {
+     BigNum.Top = Start;
+     return(NULL);
+     }
+   *Length = call_BigLength(Product, 2 * *Length);
+   memmove(Result, Product, *Length * sizeof(uint32_t));
+   BigNum.Top = Start + *Length;
+   if (!(Power & ((uint32_t)1 << (Bit - 1))))
+     continue;
+   Product = call_BigAlloc(*Length + BaseLength);
+   if (Product == NULL)
+     {
+     BigNum.Top = Start;
+     return(NULL);
+     }
+   call_BigMulSchool(Result, *Length, BaseLimb, BaseLength, Product);
+   *Length = call_BigLength(Product, *Length + BaseLength);
+   memmove(Result, Product, *Length * sizeof(uint32_t));
+   BigNum.Top = Start + *Length;
+   }
+ // 0 ^ x - LENGTH 0 IS THE NUMBER 0
+ if (!*Length)
+   {
+   Result[0] = 0;
+   *Length = 1;
+   BigNum.Top = Start + 1;
+   }
+ return(Result);
+
+ } // END OF call_BigPower
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BigCombinations
+ * Parameters: uint32_t, uint32_t, uint16_t *
+ * Return: uint32_t *
+ *
+ * Description: n C r = n! / (r! (n - r)!) on the top of the arena, its length to Length.  The
+ * (n - r + 1) x ... x n product divided by r!, with r the smaller of r and n - r.  The division is
+ * exact.  Returns NULL if the arena is full.
+ * STEP 1: Numerator and denominator products
+ * STEP 2: Divide, the quotient down to where the numerator was
+ *************************************************************************/
+ static uint32_t *call_BigCombinations(uint32_t n, uint32_t r, uint16_t *Length)
+ {
+
+ uint32_t *Numerator,
+          *Denominator,
+          *Quotient;
+ uint16_t NumeratorLength,
+          DenominatorLength,
+          Start = BigNum.Top;
+
+ // STEP 1
+ if (r > (n - r))
+   r = n - r;
+ if (!r)
+   return(call_BigProduct(1, 0, Length));
+ Numerator = call_BigProduct((n - r) + 1, n, &NumeratorLength);
+ Denominator = ((Numerator == NULL) ? NULL : call_BigProduct(1, r, &DenominatorLength));
+ Quotient = ((Denominator == NULL) ? NULL : call_BigAlloc((NumeratorLength - DenominatorLength) + 1));
+ if ((Quotient == NULL) || (!call_BigDivMod(Numerator, NumeratorLength, Denominator, DenominatorLength, Quotient)))
+   {
+   BigNum.Top = Start;
+   return(NULL);
+   }
+
+ // STEP 2
+ *Length = call_BigLength(Quotient, (NumeratorLength - DenominatorLength) + 1);
+ memmove(&BigArena[Start], Quotient, *Length * sizeof(uint32_t));
+ BigNum.Top = Start + *Length;
+ return(&BigArena[Start]);
+
+ } // END OF call_BigCombinations
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BigToChunks
+ * Parameters: uint32_t *, uint16_t
+ * Return: BOOLEAN
+ *
+ * Description: N (destroyed) to base 10^9 chunks at the start of the arena - the result of
+ * BigNum (Chunks, Digits).  The chunks needed are bounded from the bits of N, the powers
+ * 10^(9 x 2^k) are made by squaring and call_BigConvert splits N by them.  Returns FALSE if the
+ * arena is full.
+ * STEP 1: The chunks of N at most
+ * STEP 2: 10^9, 10^18, 10^36 ... up to half the chunks
+ * STEP 3: Convert
+ * STEP 4: Trim the zero chunks, count the digits, move the chunks to the start of the arena
+ *************************************************************************/
+ static BOOLEAN call_BigToChunks(uint32_t *N, uint16_t Length)
+ {
+
+ uint32_t *Chunk,
+          *Power[BIGNUM_MAX_POWERS];
+ uint16_t PowerLength[BIGNUM_MAX_POWERS],
+          Count;
+ uint8_t Level = 0;
+
+ // STEP 1
+ // DIGITS <= BITS x log10(2) + 1
+ Count = (uint16_t)((((uint32_t)Length * 32UL * 30103UL) / 100000UL) / BIGNUM_CHUNK_DIGITS) + 1;
+ Chunk = call_BigAlloc(Count);
+ if (Chunk == NULL)
+   return(FALSE);
+ memset(Chunk, 0, Count * sizeof(uint32_t));
+
+ // STEP 2
+ Power[0] = call_BigAlloc(1);
+ if (Power[0] == NULL)
+   return(FALSE);
+ Power[0][0] = BIGNUM_CHUNK;
+ PowerLength[0] = 1;
+ while (((2UL << Level) < Count) && (Level < (BIGNUM_MAX_POWERS - 1)))
+   {
+   Power[Level + 1] = call_BigAlloc(2 * PowerLength[Level]);
+   if ((Power[Level + 1] == NULL) || (!call_BigMul(Power[Level], PowerLength[Level], Power[Level], PowerLength[Level], Power[Level + 1])))
+     return(FALSE);
+   PowerLength[Level + 1] = call_BigLength(Power[Level + 1], 2 * PowerLength[Level]);
+   Level++;
+   }
+
+ // STEP 3
+ if (!call_BigConvert(N, Length, Chunk, Count, Power, PowerLength))
+   return(FALSE);
+
+ // STEP 4
+ while ((Count > 1) && (!Chunk[Count - 1]))
+   Count--;
+ BigNum.Chunks = Count;
+ BigNum.Digits = (Count - 1) * BIGNUM_CHUNK_DIGITS;
+ for (uint8_t Digit = 0; (Digit < BIGNUM_CHUNK_DIGITS) && ((!Digit) || (Chunk[Count - 1] >= BigPowerOf10[Digit])); Digit++)
+   BigNum.Digits++;
+ memmove(BigArena, Chunk, Count * sizeof(uint32_t));
+ BigNum.Top = Count;
+ return(TRUE);
+
+ } // END OF call_BigToChunks
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BigConvert
+ * Parameters: uint32_t *, uint16_t, uint32_t *, uint16_t, uint32_t **, const uint16_t *
+ * Return: BOOLEAN
+ *
+ * Description: N (destroyed, less than 10^(9 x Count)) to Count base 10^9 chunks, least first.
+ * Divide and conquer: with 2^k < Count <= 2^(k+1), N = Q x 10^(9 x 2^k) + R - R is the low 2^k
+ * chunks and Q the rest, each converted the same way.  Few chunks are repeated divides by 10^9.
+ * Returns FALSE if the arena is full.
+ * STEP 1: Few chunks
+ * STEP 2: Split by the largest power below Count
+ * STEP 3: Convert the two parts
+ *************************************************************************/
+ static BOOLEAN call_BigConvert(uint32_t *N, uint16_t Length, uint32_t *Chunk, uint16_t Count, uint32_t **Power, const uint16_t *PowerLength)
+ {
+
+ uint32_t *Quotient;
+ uint16_t Half = 1,
+          QuotientLength,
+          Mark = BigNum.Top;
+ uint8_t Level = 0;
+ BOOLEAN Converted;
+
+ // STEP 1
+ Length = call_BigLength(N, Length);
+ if ((Count <= BIGNUM_DC_CHUNKS) || (!Length))
+   {
+   for (uint16_t Index = 0; Index < Count; Index++)
+     Length = call_BigDivSmall(N, Length, BIGNUM_CHUNK, &Chunk[Index]);
+   return(TRUE);
+   }
+
+ // STEP 2
+ while ((uint16_t)(Half << 1) < Count)
+   {
+   Half <<= 1;
+   Level++;
+   }
+ if (Length < PowerLength[Level])
+   return(call_BigConvert(N, Length, Chunk, Half, Power, PowerLength));
+ QuotientLength = (Length - PowerLength[Level]) + 1;
+ Quotient = call_BigAlloc(QuotientLength);
+ if ((Quotient == NULL) || (!call_BigDivMod(N, Length, Power[Level], PowerLength[Level], Quotient)))
+   {
+   BigNum.Top = Mark;
+   return(FALSE);
+   }
+
+ // STEP 3
+ Converted = ((call_BigConvert(N, PowerLength[Level], Chunk, Half, Power, PowerLength)) &&
+              (call_BigConvert(Quotient, QuotientLength, &Chunk[Half], Count - Half, Power, PowerLength)));
+ BigNum.Top = Mark;
+ return(Converted);
+
+ } // END OF call_BigConvert
@@ -0,0 +1,820 @@
+/*****************************************************************
+ *
+ * File name:       COMPLEX_FUNCTIONS.C
+ * Description:     Complex stack mode of the HC15C - complex arithmetic and transcendental functions
+ * Author:          Hab S. Collector
+ * Date:            10/19/2026
+ * LAST EDIT:       10/19/2026
+ * Hardware:        NXP LPC1769
+ * Firmware Tool:   CrossStudio for ARM
+ * Notes:           This file should be written as to not be dependent on other includes.
+ *                  everything these functions need should be passed to them.
+ *                  It will be necessary to consult the reference documents and associated schematics to understand
+ *                  the operations of this firmware.
+ *                  In complex mode every register of the stack is a complex number: NumericValue is the real part
+ *                  and Imaginary the imaginary part.  The numbers are always held rectangular - the math never
+ *                  converts to polar and back, so a chain of operations does not pick up the rounding of atan2 and
+ *                  hypot at each step.  Polar is a display format only (see call_ComplexFormat).  The keys of the
+ *                  operations are taken by call_ComplexKey ahead of the keypad switch, all other keys (digits,
+ *                  ENTER, Drop, x<>y, STO / RCL) work as in real mode and move both parts.
+ *****************************************************************/
+
+#include "COMPLEX_FUNCTIONS.H"
+#include "PROGRAM_TASKS.H"
+#include "CORE_FUNCTIONS.H"
+#include "MATH_FUNCTIONS.H"
+#include "KERNEL_FUNCTIONS.H"
+#include "TOUCH_TASKS.H"
+#include "DIP204.H"
+#include "AUDIO_TASKS.H"
+#include "lpc_types.h"
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+
+// GLOBAL VARS
+// TYPES
+// THE KEYS OF COMPLEX MODE AS KEYSTROKE CODES (SEE PROGRAM_KEY_CODE) AND THEIR OPERATION
+static const uint8_t ComplexKeyOperation[][2] =
+  {
+  {PROGRAM_KEY_CODE(TRUE, 2, PROGRAM_NO_SHIFT),   COMPLEX_ADD},         // +
+  {PROGRAM_KEY_CODE(TRUE, 1, PROGRAM_NO_SHIFT),   COMPLEX_SUBTRACT},    // -
+  {PROGRAM_KEY_CODE(TRUE, 14, PROGRAM_NO_SHIFT),  COMPLEX_MULTIPLY},    // x
+  {PROGRAM_KEY_CODE(TRUE, 13, PROGRAM_NO_SHIFT),  COMPLEX_DIVIDE},      // /
+  {PROGRAM_KEY_CODE(FALSE, 21, PROGRAM_NO_SHIFT), COMPLEX_POWER},       // y^x
+  {PROGRAM_KEY_CODE(FALSE, 21, PROGRAM_L_SHIFT),  COMPLEX_ROOT},        // L SHIFT y^x
+  {PROGRAM_KEY_CODE(FALSE, 12, PROGRAM_NO_SHIFT), COMPLEX_JXC},         // jXC
+  {PROGRAM_KEY_CODE(FALSE, 12, PROGRAM_L_SHIFT),  COMPLEX_JXL},         // L SHIFT jXC
+  {PROGRAM_KEY_CODE(FALSE, 11, PROGRAM_NO_SHIFT), COMPLEX_COMBINE},     // PtoR
+  {PROGRAM_KEY_CODE(FALSE, 11, PROGRAM_L_SHIFT),  COMPLEX_POLAR},       // L SHIFT PtoR (RtoP)
+  {PROGRAM_KEY_CODE(FALSE, 8, PROGRAM_NO_SHIFT),  COMPLEX_RECIPROCAL},  // 1/x
+  {PROGRAM_KEY_CODE(FALSE, 4, PROGRAM_NO_SHIFT),  COMPLEX_SQUARE},      // x^2
+  {PROGRAM_KEY_CODE(FALSE, 4, PROGRAM_L_SHIFT),   COMPLEX_SQRT},        // L SHIFT x^2
+  {PROGRAM_KEY_CODE(FALSE, 3, PROGRAM_NO_SHIFT),  COMPLEX_EXP},         // e^x
+  {PROGRAM_KEY_CODE(FALSE, 3, PROGRAM_L_SHIFT),   COMPLEX_LN},          // L SHIFT e^x
+  {PROGRAM_KEY_CODE(FALSE, 17, PROGRAM_NO_SHIFT), COMPLEX_EXP10},       // 10^x
+  {PROGRAM_KEY_CODE(FALSE, 17, PROGRAM_L_SHIFT),  COMPLEX_LOG},         // L SHIFT 10^x
+  {PROGRAM_KEY_CODE(FALSE, 16, PROGRAM_NO_SHIFT), COMPLEX_SIN},         // sin
+  {PROGRAM_KEY_CODE(FALSE, 2, PROGRAM_NO_SHIFT),  COMPLEX_COS},         // cos
+  {PROGRAM_KEY_CODE(FALSE, 1, PROGRAM_NO_SHIFT),  COMPLEX_TAN},         // tan
+  {PROGRAM_KEY_CODE(FALSE, 16, PROGRAM_L_SHIFT),  COMPLEX_ASIN},        // L SHIFT sin
+  {PROGRAM_KEY_CODE(FALSE, 2, PROGRAM_L_SHIFT),   COMPLEX_ACOS},        // L SHIFT cos
+  {PROGRAM_KEY_CODE(FALSE, 1, PROGRAM_L_SHIFT),   COMPLEX_ATAN},        // L SHIFT tan
+  {PROGRAM_KEY_CODE(TRUE, 18, PROGRAM_NO_SHIFT),  COMPLEX_NEGATE},      // CHS - A LOADED X ONLY
+  {PROGRAM_KEY_CODE(TRUE, 18, PROGRAM_L_SHIFT),   COMPLEX_ABS},         // L SHIFT CHS
+  {PROGRAM_KEY_CODE(TRUE, 8, PROGRAM_R_SHIFT),    COMPLEX_RE_IM},       // R SHIFT USB
+  {PROGRAM_KEY_CODE(TRUE, 16, PROGRAM_R_SHIFT),   COMPLEX_TWO_PI_X}     // R SHIFT PI
+  };
+
+// EXTERN VARS
+extern Type_Program Program;
+extern Type_CalSettings CalSettings;
+extern Type_Register RegisterValue[TOTAL_REGISTERS];
+extern Type_Numeric NumericValue;
+extern Type_MathErrorDisplay MathError;
+extern uint8_t str_InputLine[MAX_DISPLAY_LENGTH];
+extern BOOLEAN bln_LineLoaded;
+
+// PROTOTYPES LOCAL
+static void call_ComplexOperation(uint8_t);
+static void call_ComplexDrop(Type_Complex);
+static void call_ComplexRaise(Type_Complex);
+static uint8_t call_ComplexText(uint8_t *, double, double, BOOLEAN, BOOLEAN, uint8_t);
+static Type_Complex call_ComplexMake(double, double);
+static Type_Complex call_ComplexMul(Type_Complex, Type_Complex);
+static Type_Complex call_ComplexDiv(Type_Complex, Type_Complex);
+static Type_Complex call_ComplexSqrt(Type_Complex);
+static Type_Complex call_ComplexExp(Type_Complex);
+static Type_Complex call_ComplexLn(Type_Complex);
+static Type_Complex call_ComplexPow(Type_Complex, Type_Complex);
+static Type_Complex call_ComplexSin(Type_Complex);
+static Type_Complex call_ComplexCos(Type_Complex);
+static Type_Complex call_ComplexTan(Type_Complex);
+static Type_Complex call_ComplexAsin(Type_Complex);
+static Type_Complex call_ComplexAtan(Type_Complex);
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ComplexKey
+ * Parameters: uint32_t
+ * Return: BOOLEAN
+ *
+ * Description: Called by the click task for every key that passed the filter.  Returns TRUE
+ * if the key was taken here and is not to go to the keypad switch.  Only in complex mode, CAL
+ * mode base 10 and with no error or program running.  The key and its shift are made a keystroke
+ * code as program entry does and looked up in ComplexKeyOperation - a key not in the table goes
+ * to the keypad switch with its shift untouched.
+ * STEP 1: Not complex mode - not taken
+ * STEP 2: Make the keystroke code of the key
+ * STEP 3: Look up the operation, clear the shift and run it
+ *************************************************************************/
+ BOOLEAN call_ComplexKey(uint32_t Key)
+ {
+
+ uint8_t Bit = 0,
+         Shift = PROGRAM_NO_SHIFT,
+         Code;
+ BOOLEAN ChannelB;
+
+ // STEP 1
+ if ((!CalSettings.ComplexMode) || (Program.Running) || (CalSettings.CalMode != CAL_MODE) || (CalSettings.CalBase != BASE_10) || (CalSettings.CalError != NO_ERROR))
+   return(FALSE);
+
+ // STEP 2
+ ChannelB = ((Key & MASK_B_TOUCH_DATA) != 0);
+ while ((Bit < 23) && (!(Key & ((uint32_t)1 << Bit))))
+   Bit++;
+ if (CalSettings.L_Shift)
+   Shift = PROGRAM_L_SHIFT;
+ if (CalSettings.R_Shift)
+   Shift = PROGRAM_R_SHIFT;
+ Code = PROGRAM_KEY_CODE(ChannelB, Bit, Shift);
+ // CHS OF A NUMBER BEING KEYED CHANGES THE SIGN OF ITS TEXT
+ if ((Code == PROGRAM_KEY_CODE(TRUE, PROGRAM_KEY_B_CHS, PROGRAM_NO_SHIFT)) && (!bln_LineLoaded))
+   return(FALSE);
+
+ // STEP 3
+ for (uint8_t Index = 0; Index < (sizeof(ComplexKeyOperation) / sizeof(ComplexKeyOperation[0])); Index++)
+   {
+   if (Code != ComplexKeyOperation[Index][0])
+     continue;
+   if (CalSettings.L_Shift)
+     call_LShiftClick();
+   if (CalSettings.R_Shift)
+     call_RShiftClick();
+   call_ComplexOperation(ComplexKeyOperation[Index][1]);
+   return(TRUE);
+   }
+ return(FALSE);
+
+ } // END OF call_ComplexKey
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ComplexMode
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Toggles the BASE 10 stack between REAL and COMPLEX - L shift ENTER.  Going to
+ * complex mode every register has imaginary part 0, going back to real mode the imaginary parts
+ * are dropped.  A message of the new mode is shown on the top line until the next key.
+ * STEP 1: Check the mode can change
+ * STEP 2: Toggle and clear the imaginary parts
+ * STEP 3: Display
+ *************************************************************************/
+ void call_ComplexMode(void)
+ {
+
+ uint8_t LineText[MAX_DISPLAY_LENGTH + 1];
+
+ // STEP 1
+ if ((Program.Running) || (CalSettings.CalMode != CAL_MODE) || (CalSettings.CalBase != BASE_10) || (CalSettings.CalError != NO_ERROR))
+   return;
+
+ // STEP 2
+ CalSettings.ComplexMode = !CalSettings.ComplexMode;
+ for (uint8_t RegCount = 0; RegCount < TOTAL_REGISTERS; RegCount++)
+   RegisterValue[RegCount].Imaginary = 0.0;
+
+ // STEP 3
+ call_FormatNumber();
+ //                      01234567890123456789
+ sprintf((char *)LineText, "%s", (CalSettings.ComplexMode ? "COMPLEX MODE" : "REAL MODE"));
+ DIP204_clearLine(1);
+ DIP204_txt_engine(LineText, 1, 0, strlen((const char *)LineText));
+
+ } // END OF call_ComplexMode
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ComplexFormat
+ * Parameters: Type_Register *
+ * Return: void
+ *
+ * Description: The text of a register in complex mode: "re +jim" or in polar "mag <angle" with
+ * the angle in the units of CalAngle.  This is the only place the polar form is computed.  FIX
+ * mode uses FixPrecision and ENG mode EngPrecision as the real registers.  When the two parts do
+ * not fit the display the precision is reduced, FIX then goes to exponent form.
+ * STEP 1: The two parts to show
+ * STEP 2: Fit them to the display
+ *************************************************************************/
+ void call_ComplexFormat(Type_Register *Register)
+ {
+
+ double First = Register->NumericValue,
+        Second = Register->Imaginary;
+ BOOLEAN Exponent = (CalSettings.DisplayMode != FIX);
+ uint8_t Precision = (Exponent ? CalSettings.EngPrecision : CalSettings.FixPrecision),
+         Text[COMPLEX_TEXT_LENGTH];
+
+ // STEP 1
+ if (CalSettings.ComplexPolar)
+   {
+   First = hypot(Register->NumericValue, Register->Imaginary);
+   Second = atan2(Register->Imaginary, Register->NumericValue);
+   if (CalSettings.CalAngle == DEGREES)
+     Second *= KERNEL_RAD_TO_DEG;
+   }
+
+ // STEP 2
+ while (call_ComplexText(Text, First, Second, CalSettings.ComplexPolar, Exponent, Precision) >= MAX_DISPLAY_LENGTH)
+   {
+   if (Precision)
+     Precision--;
+   else if (!Exponent)
+     {
+     Exponent = TRUE;
+     Precision = CalSettings.EngPrecision;
+     }
+   else
+     break;
+   }
+ Text[MAX_DISPLAY_LENGTH - 1] = 0;
+ strcpy((char *)Register->DisplayAs, (const char *)Text);
+
+ } // END OF call_ComplexFormat
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ComplexText
+ * Parameters: uint8_t *, double, double, BOOLEAN, BOOLEAN, uint8_t
+ * Return: uint8_t
+ *
+ * Description: Writes the two parts of a complex number to Text (COMPLEX_TEXT_LENGTH) and
+ * returns the length the text needs - it may be more than was written.
+ * STEP 1: Rectangular or polar text
+ *************************************************************************/
+ static uint8_t call_ComplexText(uint8_t *Text, double First, double Second, BOOLEAN Polar, BOOLEAN Exponent, uint8_t Precision)
+ {
+
+ int Length;
+
+ // STEP 1
+ if (Polar)
+   {
+   if (Exponent)
+     Length = snprintf((char *)Text, COMPLEX_TEXT_LENGTH, "%.*E <%.*E", Precision, First, Precision, Second);
+   else
+     Length = snprintf((char *)Text, COMPLEX_TEXT_LENGTH, "%#.*f <%#.*f", Precision, First, Precision, Second);
+   }
+ else
+   {
+   if (Exponent)
+     Length = snprintf((char *)Text, COMPLEX_TEXT_LENGTH, "%.*E %cj%.*E", Precision, First, (signbit(Second) ? '-' : '+'), Precision, fabs(Second));
+   else
+     Length = snprintf((char *)Text, COMPLEX_TEXT_LENGTH, "%#.*f %cj%#.*f", Precision, First, (signbit(Second) ? '-' : '+'), Precision, fabs(Second));
+   }
+ if ((Length < 0) || (Length > 0xFF))
+   Length = 0xFF;
+ return((uint8_t)Length);
+
+ } // END OF call_ComplexText
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ComplexOperation
+ * Parameters: uint8_t
+ * Return: void
+ *
+ * Description: Runs one operation of enum COMPLEX_OPERATION on the stack.  As the real math
+ * X is the number being keyed if the line is unloaded (imaginary part 0) else register 0, and
+ * Y is register 0 if unloaded else register 1.
+ * STEP 1: The polar toggle does not use the stack
+ * STEP 2: Get X and Y
+ * STEP 3: Binary operations - the stack drops
+ * STEP 4: Unary operations - the stack raises
+ *************************************************************************/
+ static void call_ComplexOperation(uint8_t Operation)
+ {
+
+ Type_Complex X, Y, Ans;
+ double Scale;
+
+ // STEP 1
+ if (Operation == COMPLEX_POLAR)
+   {
+   CalSettings.ComplexPolar = !CalSettings.ComplexPolar;
+   call_FormatNumber();
+   return;
+   }
+
+ // STEP 2
+ if (!bln_LineLoaded)
+   {
+   if (call_IsNumericValue(str_InputLine, CalSettings.CalBase) == FALSE)
+     {
+     call_ShowEntryError();
+     return;
+     }
+   X = call_ComplexMake(NumericValue.Value, 0.0);
+   Y = call_ComplexMake(RegisterValue[0].NumericValue, RegisterValue[0].Imaginary);
+   }
+ else
+   {
+   X = call_ComplexMake(RegisterValue[0].NumericValue, RegisterValue[0].Imaginary);
+   Y = call_ComplexMake(RegisterValue[1].NumericValue, RegisterValue[1].Imaginary);
+   }
+
+ // STEP 3
+ if (Operation < COMPLEX_BINARY_TOTAL)
+   {
+   switch (Operation)
+     {
+     case COMPLEX_ADD:
+       Ans = call_ComplexMake(Y.Re + X.Re, Y.Im + X.Im);
+       break;
+     case COMPLEX_SUBTRACT:
+       Ans = call_ComplexMake(Y.Re - X.Re, Y.Im - X.Im);
+       break;
+     case COMPLEX_MULTIPLY:
+       Ans = call_ComplexMul(Y, X);
+       break;
+     case COMPLEX_DIVIDE:
+       Ans = call_ComplexDiv(Y, X);
+       break;
+     case COMPLEX_POWER:
+       Ans = call_ComplexPow(Y, X);
+       break;
+     case COMPLEX_ROOT:
+       Ans = call_ComplexPow(Y, call_ComplexDiv(call_ComplexMake(1.0, 0.0), X));
+       break;
+     case COMPLEX_JXC:
+       Ans = call_ComplexMul(Y, X);
+       Ans = call_ComplexDiv(call_ComplexMake(1.0, 0.0), call_ComplexMul(call_ComplexMake(0.0, COMPLEX_TWO_PI), Ans));
+       break;
+     case COMPLEX_JXL:
+       Ans = call_ComplexMul(call_ComplexMake(0.0, COMPLEX_TWO_PI), call_ComplexMul(Y, X));
+       break;
+     default:
+     case COMPLEX_COMBINE:
+       // THE REAL PARTS OF Y AND X - IN POLAR Y IS THE MAGNITUDE AND X THE ANGLE
+       if (CalSettings.ComplexPolar)
+         {
+         Scale = ((CalSettings.CalAngle == DEGREES) ? (X.Re * KERNEL_DEG_TO_RAD) : X.Re);
+         Ans = call_ComplexMake(Y.Re * cos(Scale), Y.Re * sin(Scale));
+         }
+       else
+         Ans = call_ComplexMake(Y.Re, X.Re);
+       break;
+     }
+   call_ComplexDrop(Ans);
+   return;
+   }
+
+ // STEP 4
+ switch (Operation)
+   {
+   case COMPLEX_RECIPROCAL:
+     Ans = call_ComplexDiv(call_ComplexMake(1.0, 0.0), X);
+     break;
+   case COMPLEX_SQUARE:
+     Ans = call_ComplexMul(X, X);
+     break;
+   case COMPLEX_SQRT:
+     Ans = call_ComplexSqrt(X);
+     break;
+   case COMPLEX_EXP:
+     Ans = call_ComplexExp(X);
+     break;
+   case COMPLEX_LN:
+     Ans = call_ComplexLn(X);
+     break;
+   case COMPLEX_EXP10:
+     Ans = call_ComplexExp(call_ComplexMake(X.Re * COMPLEX_LN_10, X.Im * COMPLEX_LN_10));
+     break;
+   case COMPLEX_LOG:
+     Ans = call_ComplexLn(X);
+     Ans = call_ComplexMake(Ans.Re / COMPLEX_LN_10, Ans.Im / COMPLEX_LN_10);
+     break;
+   case COMPLEX_SIN:
+     Ans = call_ComplexSin(X);
+     break;
+   case COMPLEX_COS:
+     Ans = call_ComplexCos(X);
+     break;
+   case COMPLEX_TAN:
+     Ans = call_ComplexTan(X);
+     break;
+   case COMPLEX_ASIN:
+     Ans = call_ComplexAsin(X);
+     break;
+   case COMPLEX_ACOS:
+     // acos(z) = PI/2 - asin(z)
+     Ans = call_ComplexAsin(X);
+     Ans = call_ComplexMake(COMPLEX_PI_OVER_2 - Ans.Re, -Ans.Im);
+     break;
+   case COMPLEX_ATAN:
+     Ans = call_ComplexAtan(X);
+     break;
+   case COMPLEX_NEGATE:
+     Ans = call_ComplexMake(-X.Re, -X.Im);
+     break;
+   case COMPLEX_ABS:
+     Ans = call_ComplexMake(hypot(X.Re, X.Im), 0.0);
+     break;
+   case COMPLEX_RE_IM:
+     Ans = call_ComplexMake(X.Im, X.Re);
+     break;
+   default:
+   case COMPLEX_TWO_PI_X:
+     Ans = call_ComplexMake(X.Re * COMPLEX_TWO_PI, X.Im * COMPLEX_TWO_PI);
+     break;
+   }
+ call_ComplexRaise(Ans);
+
+ } // END OF call_ComplexOperation
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ComplexDrop
+ * Parameters: Type_Complex
+ * Return: void
+ *
+ * Description: The complex call_ChkAndDisplayDrop.  Checks the result of a binary operation,
+ * on an error the error is shown and the stack is not changed.  Else register 0 is set to the
+ * result and the stack drops.
+ * STEP 1: Check for error
+ * STEP 2: Update Reg 0 and drop the stack
+ *************************************************************************/
+ static void call_ComplexDrop(Type_Complex Ans)
+ {
+
+ // STEP 1
+ if ((!isfinite(Ans.Re)) || (!isfinite(Ans.Im)))
+   {
+   strcpy((char *)MathError.ErrorDescription,"Invalid result");
+   strcpy((char *)MathError.ErrorSolution,"Unsupported math");
+   strcpy((char *)NumericValue.AudioErrorFileName, I_AND_I_ERROR_WAV);
+   NumericValue.AudioPlayLevel = BASIC_HELP;
+   call_ShowMathError();
+   return;
+   }
+
+ // STEP 2
+ RegisterValue[0].NumericValue = Ans.Re;
+ RegisterValue[0].Imaginary = Ans.Im;
+ call_ProcessStackDown();
+
+ } // END OF call_ComplexDrop
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ComplexRaise
+ * Parameters: Type_Complex
+ * Return: void
+ *
+ * Description: The complex call_ChkAndDisplayRaise.  Checks the result of a unary operation,
+ * on an error the error is shown and the stack is not changed.  Else the stack is raised as
+ * call_ProcessStackUp and register 0 is set to both parts of the result.
+ * STEP 1: Check for error
+ * STEP 2: Raise the stack, update Reg 0 and display
+ *************************************************************************/
+ static void call_ComplexRaise(Type_Complex Ans)
+ {
+
+ // STEP 1
+ if ((!isfinite(Ans.Re)) || (!isfinite(Ans.Im)))
+   {
+   strcpy((char *)MathError.ErrorDescription,"Invalid result");
+   strcpy((char *)MathError.ErrorSolution,"Unsupported math");
+   strcpy((char *)NumericValue.AudioErrorFileName, I_AND_I_ERROR_WAV);
+   NumericValue.AudioPlayLevel = BASIC_HELP;
+   call_ShowMathError();
+   return;
+   }
+
+ // STEP 2
+ if (!bln_LineLoaded)
+   {
+   for (uint8_t RegCount = (TOTAL_REGISTERS - 1); RegCount > 0; RegCount--)
+     {
+     RegisterValue[RegCount].NumericValue = RegisterValue[RegCount - 1].NumericValue;
+     RegisterValue[RegCount].IntegerValue = RegisterValue[RegCount - 1].IntegerValue;
+     RegisterValue[RegCount].Imaginary = RegisterValue[RegCount - 1].Imaginary;
+     RegisterValue[RegCount].Displayed = RegisterValue[RegCount - 1].Displayed;
+     }
+   bln_LineLoaded = TRUE;
+   }
+ RegisterValue[0].NumericValue = Ans.Re;
+ RegisterValue[0].Imaginary = Ans.Im;
+ RegisterValue[0].Displayed = TRUE;
+ call_FormatNumber();
+
+ } // END OF call_ComplexRaise
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ComplexMake
+ * Parameters: double, double
+ * Return: Type_Complex
+ *
+ * Description: The complex number Re + jIm.
+ * STEP 1: Make it
+ *************************************************************************/
+ static Type_Complex call_ComplexMake(double Re, double Im)
+ {
+
+ Type_Complex Ans;
+
+ // STEP 1
+ Ans.Re = Re;
+ Ans.Im = Im;
+ return(Ans);
+
+ } // END OF call_ComplexMake
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ComplexMul
+ * Parameters: Type_Complex, Type_Complex
+ * Return: Type_Complex
+ *
+ * Description: A x B.
+ * STEP 1: (ac - bd) + j(ad + bc)
+ *************************************************************************/
+ static Type_Complex call_ComplexMul(Type_Complex A, Type_Complex B)
+ {
+
+ // STEP 1
+ return(call_ComplexMake((A.Re * B.Re) - (A.Im * B.Im), (A.Re * B.Im) + (A.Im * B.Re)));
+
+ } // END OF call_ComplexMul
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ComplexDiv
+ * Parameters: Type_Complex, Type_Complex
+ * Return: Type_Complex
+ *
+ * Description: A / B by Smith's method - the larger part of B is divided out first so
+ * |B|^2 is never formed and cannot overflow or underflow.  B = 0 gives an infinite or NaN
+ * result which the caller shows as an error.
+ * STEP 1: Divide by the larger part of B
+ *************************************************************************/
+ static Type_Complex call_ComplexDiv(Type_Complex A, Type_Complex B)
+ {
+
+ double Ratio, Denominator;
+
+ // STEP 1
+ if (fabs(B.Re) >= fabs(B.Im))
+   {
+   Ratio = B.Im / B.Re;
+   Denominator = B.Re + (B.Im * Ratio);
+   return(call_ComplexMake((A.Re + (A.Im * Ratio)) / Denominator, (A.Im - (A.Re * Ratio)) / Denominator));
+   }
+ Ratio = B.Re / B.Im;
+ Denominator = (B.Re * Ratio) + B.Im;
+ return(call_ComplexMake(((A.Re * Ratio) + A.Im) / Denominator, ((A.Im * Ratio) - A.Re) / Denominator));
+
+ } // END OF call_ComplexDiv
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ComplexSqrt
+ * Parameters: Type_Complex
+ * Return: Type_Complex
+ *
+ * Description: The principal square root.  The part that would be a difference of near
+ * equal numbers is found from the other part instead, so neither part loses digits.
+ * STEP 1: sqrt(0) is 0
+ * STEP 2: t = sqrt((|z| + |Re|) / 2) is one part, Im / 2t the other
+ *************************************************************************/
+ static Type_Complex call_ComplexSqrt(Type_Complex Z)
+ {
+
+ double Part;
+
+ // STEP 1
+ if ((Z.Re == 0.0) && (Z.Im == 0.0))
+   return(call_ComplexMake(0.0, Z.Im));
+
+ // STEP 2
+ Part = sqrt((hypot(Z.Re, Z.Im) + fabs(Z.Re)) * 0.5);
+ if (Z.Re >= 0.0)
+   return(call_ComplexMake(Part, Z.Im / (2.0 * Part)));
+ return(call_ComplexMake(fabs(Z.Im) / (2.0 * Part), copysign(Part, Z.Im)));
+
+ } // END OF call_ComplexSqrt
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ComplexExp
+ * Parameters: Type_Complex
+ * Return: Type_Complex
+ *
+ * Description: e^z = e^Re (cos Im + j sin Im).
+ * STEP 1: Scale the unit vector
+ *************************************************************************/
+ static Type_Complex call_ComplexExp(Type_Complex Z)
+ {
+
+ double Magnitude = exp(Z.Re);
+
+ // STEP 1
+ if (Z.Im == 0.0)
+   return(call_ComplexMake(Magnitude, 0.0));
+ return(call_ComplexMake(Magnitude * cos(Z.Im), Magnitude * sin(Z.Im)));
+
+ } // END OF call_ComplexExp
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ComplexLn
+ * Parameters: Type_Complex
+ * Return: Type_Complex
+ *
+ * Description: The principal natural log ln|z| + j arg z, arg in (-PI, PI].  ln 0 is
+ * -infinite which the caller shows as an error.
+ * STEP 1: Magnitude and angle
+ *************************************************************************/
+ static Type_Complex call_ComplexLn(Type_Complex Z)
+ {
+
+ // STEP 1
+ return(call_ComplexMake(log(hypot(Z.Re, Z.Im)), atan2(Z.Im, Z.Re)));
+
+ } // END OF call_ComplexLn
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ComplexPow
+ * Parameters: Type_Complex, Type_Complex
+ * Return: Type_Complex
+ *
+ * Description: Base^Power = e^(Power ln Base).  A zero base gives 0 for a power with a
+ * positive real part and an error (NaN) for any other power.  A real positive base and a real
+ * power use pow so an exact result (2^10) stays exact.
+ * STEP 1: Zero base
+ * STEP 2: Real result
+ * STEP 3: e^(Power ln Base)
+ *************************************************************************/
+ static Type_Complex call_ComplexPow(Type_Complex Base, Type_Complex Power)
+ {
+
+ // STEP 1
+ if ((Base.Re == 0.0) && (Base.Im == 0.0))
+   {
+   if (Power.Re > 0.0)
+     return(call_ComplexMake(0.0, 0.0));
+   return(call_ComplexMake(NAN, NAN));
+   }
+
+ // STEP 2
+ if ((Base.Im == 0.0) && (Power.Im == 0.0) && (Base.Re > 0.0))
+   return(call_ComplexMake(pow(Base.Re, Power.Re), 0.0));
+
+ // STEP 3
+ return(call_ComplexExp(call_ComplexMul(Power, call_ComplexLn(Base))));
+
+ } // END OF call_ComplexPow
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ComplexSin
+ * Parameters: Type_Complex
+ * Return: Type_Complex
+ *
+ * Description: sin(a + jb) = sin a cosh b + j cos a sinh b.  Radians.
+ * STEP 1: The two parts
+ *************************************************************************/
+ static Type_Complex call_ComplexSin(Type_Complex Z)
+ {
+
+ // STEP 1
+ return(call_ComplexMake(sin(Z.Re) * cosh(Z.Im), cos(Z.Re) * sinh(Z.Im)));
+
+ } // END OF call_ComplexSin
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ComplexCos
+ * Parameters: Type_Complex
+ * Return: Type_Complex
+ *
+ * Description: cos(a + jb) = cos a cosh b - j sin a sinh b.  Radians.
+ * STEP 1: The two parts
+ *************************************************************************/
+ static Type_Complex call_ComplexCos(Type_Complex Z)
+ {
+
+ // STEP 1
+ return(call_ComplexMake(cos(Z.Re) * cosh(Z.Im), -sin(Z.Re) * sinh(Z.Im)));
+
+ } // END OF call_ComplexCos
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ComplexTan
+ * Parameters: Type_Complex
+ * Return: Type_Complex
+ *
+ * Description: tan(a + jb) = (sin 2a + j sinh 2b) / (cos 2a + cosh 2b).  Radians.  For
+ * |b| > COMPLEX_TAN_LIMIT cosh 2b would overflow - tan is then +-j to the display with a real
+ * part of 2 sin 2a e^-2|b|.
+ * STEP 1: Large imaginary part
+ * STEP 2: One divide of the double angle parts
+ *************************************************************************/
+ static Type_Complex call_ComplexTan(Type_Complex Z)
+ {
+
+ double Denominator;
+
+ // STEP 1
+ if (fabs(Z.Im) > COMPLEX_TAN_LIMIT)
+   return(call_ComplexMake(2.0 * sin(2.0 * Z.Re) * exp(-2.0 * fabs(Z.Im)), copysign(1.0, Z.Im)));
+
+ // STEP 2
+ Denominator = cos(2.0 * Z.Re) + cosh(2.0 * Z.Im);
+ return(call_ComplexMake(sin(2.0 * Z.Re) / Denominator, sinh(2.0 * Z.Im) / Denominator));
+
+ } // END OF call_ComplexTan
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ComplexAsin
+ * Parameters: Type_Complex
+ * Return: Type_Complex
+ *
+ * Description: The principal asin(z) = -j ln(jz + sqrt(1 - z^2)).  Radians.
+ * STEP 1: jz + sqrt(1 - z^2)
+ * STEP 2: Times -j of its ln
+ *************************************************************************/
+ static Type_Complex call_ComplexAsin(Type_Complex Z)
+ {
+
+ Type_Complex Root;
+
+ // STEP 1
+ Root = call_ComplexMul(Z, Z);
+ Root = call_ComplexSqrt(call_ComplexMake(1.0 - Root.Re, -Root.Im));
+ Root = call_ComplexLn(call_ComplexMake(Root.Re - Z.Im, Root.Im + Z.Re));
+
+ // STEP 2
+ return(call_ComplexMake(Root.Im, -Root.Re));
+
+ } // END OF call_ComplexAsin
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ComplexAtan
+ * Parameters: Type_Complex
+ * Return: Type_Complex
+ *
+ * Description: The principal atan(z) = (j/2) [ln(1 - jz) - ln(1 + jz)].  Radians.  z = +-j
+ * is a log of 0 which the caller shows as an error.
+ * STEP 1: The two logs
+ * STEP 2: Times j/2 of the difference
+ *************************************************************************/
+ static Type_Complex call_ComplexAtan(Type_Complex Z)
+ {
+
+ Type_Complex LogMinus, LogPlus;
+
+ // STEP 1
+ LogMinus = call_ComplexLn(call_ComplexMake(1.0 + Z.Im, -Z.Re));
+ LogPlus = call_ComplexLn(call_ComplexMake(1.0 - Z.Im, Z.Re));
+
+ // STEP 2
+ return(call_ComplexMake(-0.5 * (LogMinus.Im - LogPlus.Im), 0.5 * (LogMinus.Re - LogPlus.Re)));
+
+ } // END OF call_ComplexAtan
@@ -4,7 +4,7 @@
  * Description:     Functions used to support calculator operations of the HC15C
  * Author:          Hab S. Collector
  * Date:            10/11/11
- * LAST EDIT:       8/17/2012
+ * LAST EDIT:       10/19/2026
  * Hardware:        NXP LPC1769
  * Firmware Tool:   CrossStudio for ARM
  * Notes:           This file should be written as to not be dependent on other includes.
@@ -23,6 +23,9 @@
 #include "LIST_TASKS.H"
 #include "SETUP_TASKS.H"
 #include "AUDIO_TASKS.H"
+#include "INTEGER_FUNCTIONS.H"
+#include "COMPLEX_FUNCTIONS.H"
+#include "KERNEL_FUNCTIONS.H"
 #include "lpc_types.h"
 #include <string.h>
 #include <stdio.h>
@@ -32,13 +35,25 @@
  
 // DEFINE GLOBALS
 BOOLEAN bln_LineLoaded = TRUE,
-        bln_InputHasExp = FALSE;
+        bln_InputHasExp = FALSE,
+        bln_IntegerResult = FALSE,  // HEX MODE: SET BY INTEGER OPS - REGISTER IntegerValue IS CURRENT
+        bln_DisplayHold = FALSE;    // A PROGRAM IS RUNNING - THE STACK IS KEPT BUT NOT DISPLAYED
 uint8_t str_InputLine[MAX_DISPLAY_LENGTH]; 
 // TYPES
 Type_Register RegisterValue[TOTAL_REGISTERS];
 Type_Numeric NumericValue;
 Type_CalSettings CalSettings;
 Type_STO_RCL STO_RCL;
+Type_NumEntry NumEntry;
+// EXACT POWERS OF 10 FOR THE ENTRY FAST PATH (SEE MAX_EXACT_POWER_OF_10)
+static const double PowerOf10[MAX_EXACT_POWER_OF_10 + 1] = 
+  {
+  1E0,  1E1,  1E2,  1E3,  1E4,  1E5,  1E6,  1E7,  1E8,  1E9,  1E10, 1E11,
+  1E12, 1E13, 1E14, 1E15, 1E16, 1E17, 1E18, 1E19, 1E20, 1E21, 1E22
+  };
+// SCRATCH POOL - uint64_t SO A double IS ALIGNED
+static uint64_t ScratchPool[SCRATCH_POOL_SIZE / sizeof(uint64_t)] AHB_BANK1;
+static uint8_t ScratchOwner = SCRATCH_FREE;
 
 // EXTERNS
 extern void delayXms(uint32_t);
@@ -67,12 +82,15 @@ extern CTL_MEMORY_AREA_t MemArea;
  * value remains unloaded until it is Entered (Enter), or acted upon by a math function.  At that
  * time the first this the calling function does is determine if the unloaded string array can be a valid 
  * number.
+ * NOTE: Each char added to the string is also fed to the entry parse (NumEntry) so that
+ * call_IsNumericValue does not need to re-scan the string.
  * STEP 1: Check if loaded / unloaded and take action to setup string. Check if
  * the max number of characters have already been entered if so do nothing.  Check if CHS has
  * been pressed - if so toggle the first location of the array to be "-" or nothing.
  * STEP 2: Load string according to alpha numeric digit, EXP, or decimal point that was 
  * Click-ed.  Set or clear the exponent flag if exponent added or removed (backspace). Handle
  * backspace event to remove the last char of the string (if not chars left - no string is being entered.
+ * Backspace reloads the entry parse from what remains of the string.
  * Setup for STO or RCL to receive the next two numeric digits.
  * STEP 3: Display: Clear the display, display the stack moved up - but do not store to 
  * the RegisterValue.  This is for display only at this point.
@@ -93,22 +111,28 @@ extern CTL_MEMORY_AREA_t MemArea;
    // CHECK IF CHS OPERATION
    if (NumberClick == CHANGE_SIGN)
      {
+     if (CalSettings.CalBase == BASE_16)
+       {
+       call_IntUnaryOp(INT_NEGATE);
+       return;
+       }
      RegisterValue[0].NumericValue *= -1.0;
      call_FormatNumber();
      return;
      }
-   sprintf(str_InputLine, "");
+   str_InputLine[0] = NULL_VALUE;
    bln_LineLoaded = FALSE;
+   call_NumEntryReset(CalSettings.CalBase);
    }
  // CHECK IF MAX DISPLAY LENGHT EXCEED IF SO DO NOTHING.  IF HEX YOU HAV EOT ACCOUNT FOR 0x IN DISPLAY
  if (CalSettings.CalBase == BASE_16)
    {
-   if (strlen(str_InputLine) > (MAX_DISPLAY_LENGTH - (1+2)))
+   if (strlen((const char *)str_InputLine) > (MAX_DISPLAY_LENGTH - (1+2)))
      return;
    }
  else
    {
-   if (strlen(str_InputLine) > (MAX_DISPLAY_LENGTH - 1))
+   if (strlen((const char *)str_InputLine) > (MAX_DISPLAY_LENGTH - 1))
      return;
    }
 
@@ -126,27 +150,34 @@ extern CTL_MEMORY_AREA_t MemArea;
    case 8:
    case 9:
    case 0:
-     sprintf(str_StringToAdd,"%d",NumberClick);
-     strcat(str_InputLine, str_StringToAdd);
+     sprintf((char *)str_StringToAdd,"%d",NumberClick);
+     strcat((char *)str_InputLine, (const char *)str_StringToAdd);
+     call_NumEntryAddChar(*str_StringToAdd);
    break;
    
    case DECIMAL_POINT:
    // DECIMAL POINT - FRACTIONS NOT IMPLEMENTED AT THIS TIME
-     sprintf(str_StringToAdd, ".");
-     strcat(str_InputLine, str_StringToAdd);
+     sprintf((char *)str_StringToAdd, ".");
+     strcat((char *)str_InputLine, (const char *)str_StringToAdd);
+     call_NumEntryAddChar('.');
    break;
    
    case EXPONENT:
    // EXPONENT SET THE EXPONENT FLAG
      if ((bln_InputHasExp) || (CalSettings.CalBase == BASE_16))
        break;
-     if (strcmp(str_InputLine, "" ) == 0)
-       sprintf(str_InputLine, "1E+");
+     if (strcmp((const char *)str_InputLine, "" ) == 0)
+       {
+       sprintf((char *)str_InputLine, "1E+");
+       call_NumEntryAddChar('1');
+       }
      else
        {
-       sprintf(str_StringToAdd, "E+");
-       strcat(str_InputLine, str_StringToAdd);
+       sprintf((char *)str_StringToAdd, "E+");
+       strcat((char *)str_InputLine, (const char *)str_StringToAdd);
        }
+     call_NumEntryAddChar('E');
+     call_NumEntryAddChar('+');
      bln_InputHasExp = TRUE;
    break;
    
@@ -159,22 +190,24 @@ extern CTL_MEMORY_AREA_t MemArea;
    case HEX_F:
      *str_StringToAdd = (char)NumberClick;
      str_StringToAdd[1] = NULL_VALUE; // Must terminate the string
-     strcat(str_InputLine, str_StringToAdd);
+     strcat((char *)str_InputLine, (const char *)str_StringToAdd);
+     call_NumEntryAddChar(*str_StringToAdd);
    break;
    
    case BACKSPACE:
-     if (strcmp(str_InputLine, "") == 0)
+     if (strcmp((const char *)str_InputLine, "") == 0)
          {
          bln_LineLoaded = TRUE;
          call_FormatNumber();
          return;
          }
      // ONLY IF LINE NOT LOADED - IF 'E' REMOVED CLEAR THE EXPONENT FLAG
-     if ((!bln_LineLoaded) && (strlen(str_InputLine) > 0))
+     if ((!bln_LineLoaded) && (strlen((const char *)str_InputLine) > 0))
        {
-       if (str_InputLine[strlen(str_InputLine) - 1] == 'E')
+       if (str_InputLine[strlen((const char *)str_InputLine) - 1] == 'E')
          bln_InputHasExp = FALSE;
-       str_InputLine[strlen(str_InputLine) - 1] = NULL_VALUE; // String must be NULL terminated
+       str_InputLine[strlen((const char *)str_InputLine) - 1] = NULL_VALUE; // String must be NULL terminated
+       call_NumEntryReload(str_InputLine, CalSettings.CalBase);
        }
    break;
    
@@ -191,13 +224,17 @@ extern CTL_MEMORY_AREA_t MemArea;
            CharCount++;
            }
          str_TempString[CharCount] = NULL_VALUE;
-         strcpy(str_InputLine, str_TempString);
+         strcpy((char *)str_InputLine, (const char *)str_TempString);
+         NumEntry.MantissaNeg = FALSE;
+         NumEntry.Length--;
          }
        else
          {
-         sprintf(str_TempString, "-");
-         strcat(str_TempString, str_InputLine);
-         strcpy(str_InputLine, str_TempString);
+         sprintf((char *)str_TempString, "-");
+         strcat((char *)str_TempString, (const char *)str_InputLine);
+         strcpy((char *)str_InputLine, (const char *)str_TempString);
+         NumEntry.MantissaNeg = TRUE;
+         NumEntry.Length++;
          }
        }
      // EXPONENT: CHANGE + TO -, IF NOTHING AFTER "E" MAKE -
@@ -220,7 +257,10 @@ extern CTL_MEMORY_AREA_t MemArea;
            str_TempString[CharCount+1] = str_InputLine[CharCount];
            CharCount++;
            }
-         strcpy(str_InputLine, str_TempString);
+         strcpy((char *)str_InputLine, (const char *)str_TempString);
+         NumEntry.ExpSignGiven = TRUE;
+         NumEntry.ExponentNeg = TRUE;
+         NumEntry.Length++;
          break;
          }
        // TEST IF - OR +: IF SO CHANGE TO OPPOSITE SIGN
@@ -228,19 +268,20 @@ extern CTL_MEMORY_AREA_t MemArea;
          str_TempString[CharCount] = '-';
        if (str_InputLine[CharCount] == '-')
          str_TempString[CharCount] = '+';
+       NumEntry.ExponentNeg = (str_TempString[CharCount] == '-');
        CharCount++;
        while (str_InputLine[CharCount] != NULL_VALUE)
          {
          str_TempString[CharCount] = str_InputLine[CharCount];
          CharCount++;
          }
-       strcpy(str_InputLine, str_TempString);
+       strcpy((char *)str_InputLine, (const char *)str_TempString);
        }       
    break;   
    
    case STO:
      // SHOW DISPLAYF FOR STORE
-     strcpy(str_InputLine, "STO ");
+     strcpy((char *)str_InputLine, "STO ");
      // SET THE STORE FLAG AND MASK UNNCESSARY KEYS TO AVOID ERRORS
      STO_RCL.STO_Event = TRUE;
      CalSettings.Mask_KeyTouchA = CalSettings.Mask_KeyTouchB = NO_KEYS_SELECTED;
@@ -249,7 +290,7 @@ extern CTL_MEMORY_AREA_t MemArea;
    
    case RCL:
      // SHOW DISPLAYF FOR RECALL
-     strcpy(str_InputLine, "RCL ");
+     strcpy((char *)str_InputLine, "RCL ");
      // SET THE STORE FLAG AND MASK UNNCESSARY KEYS TO AVOID ERRORS
      STO_RCL.RCL_Event = TRUE;
      CalSettings.Mask_KeyTouchA = CalSettings.Mask_KeyTouchB = NO_KEYS_SELECTED;
@@ -264,7 +305,7 @@ extern CTL_MEMORY_AREA_t MemArea;
  for (uint8_t LineCount = 1; LineCount < 4; LineCount++)
    {
    if (RegisterValue[3-LineCount].Displayed == TRUE)
-      DIP204_txt_engine(RegisterValue[3-LineCount].DisplayAs, LineCount, 0, strlen(RegisterValue[3-LineCount].DisplayAs));
+      DIP204_txt_engine(RegisterValue[3-LineCount].DisplayAs, LineCount, 0, strlen((const char *)RegisterValue[3-LineCount].DisplayAs));
    else
      DIP204_clearLine(LineCount);
    }
@@ -278,14 +319,14 @@ extern CTL_MEMORY_AREA_t MemArea;
  // A line length of 6 means that "STO ##" or "RCL ##" has been entered - call STO or RCL and have that sub complete the transaction
  if (STO_RCL.STO_Event)
  {
-   if (strlen(str_InputLine) == 6)
+   if (strlen((const char *)str_InputLine) == 6)
    call_PerformSTO();
  }
  // CHECK FOR STORE EVENT
  // A line length of 6 means that "STO ##" or "RCL ##" has been entered - call STO or RCL and have that sub complete the transaction 
  if (STO_RCL.RCL_Event)
  {
-   if (strlen(str_InputLine) == 6)
+   if (strlen((const char *)str_InputLine) == 6)
    call_PerformRCL();
  }
  
@@ -303,180 +344,248 @@ extern CTL_MEMORY_AREA_t MemArea;
  * number is evaluated within the context of the present entry system: HEX, decimal,
  * or binary.  The function can be called by the ENTER or any math function working on 
  * unloaded values.  Returns TRUE or FALSE
- * STEP 1: Check for Base 10 value.  If error occurs load Numeric structure
+ * NOTE: The string is not re-scanned.  The entry parse (NumEntry) is kept up to date by 
+ * call_NumClick as each char is entered, so the work left here is fixed no matter the length
+ * of the entry.  If the parse does not describe the string passed it is reloaded first.
  * Error checking includes:
- * STEP 1: COPY AND ASSIGN POINTER
- * STEP 2: FOR DECIMAL
- * 1. If Value contains any characters other than "0123456789.E+-"
+ * 1. If Value is empty or contains any characters not valid for the base
  * 2. If Value contains more than 1 "E" or more than 1 "."
- * STEP 3: FOR HEXIDECIMAL
+ * 3. If Value is too large (Inf)
+ * STEP 1: Reload the entry parse if it is not of this string or base
+ * STEP 2: Invalid chars seen - load Numeric structure with the error
+ * STEP 3: FOR DECIMAL: Scale the integer mantissa by an exact power of 10.  If the mantissa 
+ * or power is too large to be exact fall back to the library conversion
+ * STEP 4: FOR HEXIDECIMAL: The mantissa is the value
+ * STEP 5: Check for Inf
  *************************************************************************/
  BOOLEAN call_IsNumericValue(const uint8_t StringToEval[], uint8_t NumericBase)
  {
  
- uint8_t CharE_Count = 0,
-         CharDP_Count = 0,
-         HexValueLenght = 0,
-         Base16Power = 0;
- uint8_t StringToConvert[MAX_DISPLAY_LENGTH];
- uint8_t *StringValue;
- double HexStringValue;
+ int16_t PowerOfTen;
 
  // STEP 1
- strcpy(StringToConvert,StringToEval);
- StringValue = StringToConvert;
+ if ((StringToEval != str_InputLine) || (NumEntry.Base != NumericBase) || (NumEntry.Length != strlen((const char *)StringToEval)))
+   call_NumEntryReload(StringToEval, NumericBase);
  
  // STEP 2
+ // AN EMPTY ENTRY OR A NEGATIVE HEX ENTRY IS NOT VALID
+ if ((NumEntry.InvalidChars) || (NumEntry.Length == 0) || ((NumericBase == BASE_16) && (NumEntry.MantissaNeg)))
+   {
+   NumericValue.Valid = FALSE;
+   //                              01234567890123456789
+   strcpy((char *)NumericValue.Description, "Invalid Number");
+   strcpy((char *)NumericValue.Solution,    "Check your base");
+   strcpy((char *)NumericValue.AudioErrorFileName, INVALID_NUMBER_WAV);
+   NumericValue.AudioPlayLevel = BASIC_HELP;
+   strcpy((char *)NumericValue.Result, (const char *)StringToEval);
+   return(FALSE);
+   }
+ NumericValue.Valid = TRUE;
+ 
+ // STEP 3
  // FOR DECIMAL ENTRY
  if (NumericBase == BASE_10)
    {
-   // CHECK ERRORS
-   do
+   PowerOfTen = (NumEntry.ExponentNeg ? -NumEntry.Exponent : NumEntry.Exponent) - NumEntry.FractionDigits;
+   if ((NumEntry.DroppedDigits) || (NumEntry.Mantissa > MAX_EXACT_MANTISSA) ||
+       (PowerOfTen > MAX_EXACT_POWER_OF_10) || (PowerOfTen < -MAX_EXACT_POWER_OF_10))
      {
-     if (*StringValue == 'E')
-       CharE_Count++;
-     if (*StringValue == '.')
-       CharDP_Count++;
-     if ((*StringValue != '0')&&(*StringValue != '1')&&(*StringValue != '2')&&(*StringValue != '3')&&
-         (*StringValue != '4')&&(*StringValue != '5')&&(*StringValue != '6')&&(*StringValue != '7')&&
-         (*StringValue != '8')&&(*StringValue != '9')&&(*StringValue != '.')&&(*StringValue != 'E')&&
-         (*StringValue != '-')&&(*StringValue != '+')||(CharE_Count > 1)||(CharDP_Count > 1))
-       {
-       NumericValue.Valid = FALSE;
-       //                              01234567890123456789
-       strcpy(NumericValue.Description, "Invalid Number");
-       strcpy(NumericValue.Solution,    "Check your base");
-       strcpy(NumericValue.AudioErrorFileName, INVALID_NUMBER_WAV);
-       NumericValue.AudioPlayLevel = BASIC_HELP;
-       strcpy(NumericValue.Result, StringToConvert);
-       return(FALSE);
-       }
-     StringValue++;
-     }while(*StringValue != NULL_VALUE);
-   // NO ERRORS IF YOU GET THIS FAR
-   NumericValue.Valid = TRUE;
-   NumericValue.Value = atof(StringToConvert);
-   // CHECK FOR INFINITE ERROR - INF ERROR IS NUMBER TOO LARGE
-   if (isinf(NumericValue.Value) || isnan(NumericValue.Value))
+     // RARE: EXACT SCALE NOT POSSIBLE
+     NumericValue.Value = atof((const char *)StringToEval);
+     }
+   else
      {
-     //                              01234567890123456789
-     strcpy(NumericValue.Description, "Value looks Inf");
-     strcpy(NumericValue.Solution, "Out of range");
-     strcpy(NumericValue.AudioErrorFileName, VALUE_TOO_LARGE_WAV);
-     NumericValue.AudioPlayLevel = BASIC_HELP;
-     return(FALSE);
+     // BOTH OPERANDS ARE EXACT SO THE RESULT IS CORRECTLY ROUNDED
+     if (PowerOfTen >= 0)
+       NumericValue.Value = (double)NumEntry.Mantissa * PowerOf10[PowerOfTen];
+     else
+       NumericValue.Value = (double)NumEntry.Mantissa / PowerOf10[-PowerOfTen];
+     if ((NumEntry.MantissaNeg) && (NumEntry.Mantissa != 0))
+       NumericValue.Value = -NumericValue.Value;
      }
-   bln_InputHasExp = FALSE; // On valid number must clear.
-   LastX = NumericValue.Value;
-   return(TRUE);
    } // BASE_10
  
- // STEP 3
+ // STEP 4
  /* FOR HEXIDECIMAL ENTRY
   * NOTE: HEX ENTIRES WILL NOT HAVE EXPONENT TO BE CONCERNED WITH */
  if (NumericBase == BASE_16)
-   {  
-   HexStringValue = 0;
-   HexValueLenght = strlen(StringToConvert);
-   Base16Power = HexValueLenght - 1; // THIS IS RELATED TO AN ARRAY SO YOU COUNT FROM 0
-   for(uint8_t CharCount = 0; CharCount < (HexValueLenght); CharCount++)
-      {
-      switch(*StringValue)
-        {
-        case '0':
-        break;
-        
-        case '1':
-        HexStringValue += 1 * (pow(16, Base16Power));
-        break;
-        
-        case '2':
-        HexStringValue += 2 * (pow(16, Base16Power));
-        break;
-        
-        case '3':
-        HexStringValue += 3 * (pow(16, Base16Power));
-        break;
-        
-        case '4':
-        HexStringValue += 4 * (pow(16, Base16Power));
-        break;
-        
-        case '5':
-        HexStringValue += 5 * (pow(16, Base16Power));
-        break;
-        
-        case '6':
-        HexStringValue += 6 * (pow(16, Base16Power));
-        break;
-        
-        case '7':
-        HexStringValue += 7 * (pow(16, Base16Power));
-        break;
-        
-        case '8':
-        HexStringValue += 8 * (pow(16, Base16Power));
-        break;  
-    
-        case '9':
-        HexStringValue += 9 * (pow(16, Base16Power));
-        break;  
-        
-        case 'A':
-        HexStringValue += 10 * (pow(16, Base16Power));
-        break;    
-      
-        case 'B':
-        HexStringValue += 11 * (pow(16, Base16Power));
-        break;  
-        
-        case 'C':
-        HexStringValue += 12 * (pow(16, Base16Power));
-        break;    
-      
-        case 'D':
-        HexStringValue += 13 * (pow(16, Base16Power));
-        break;  
-        
-        case 'E':
-        HexStringValue += 14 * (pow(16, Base16Power));
-        break; 
+   {
+   // HEX IS THE INTEGER MODE - THE ENTRY MUST FIT THE WORD SIZE
+   if ((NumEntry.DroppedDigits) || (NumEntry.Mantissa & ~call_IntWordMask()))
+     {
+     //                              01234567890123456789
+     strcpy((char *)NumericValue.Description, "Value too large");
+     strcpy((char *)NumericValue.Solution,    "Check word size");
+     strcpy((char *)NumericValue.AudioErrorFileName, VALUE_TOO_LARGE_WAV);
+     NumericValue.AudioPlayLevel = BASIC_HELP;
+     return(FALSE);
+     }
+   NumericValue.IntegerValue = NumEntry.Mantissa;
+   NumericValue.Value = call_IntToDouble(NumericValue.IntegerValue);
+   } // BASE_16
+ 
+ // STEP 5
+ // CHECK FOR INFINITE ERROR - INF ERROR IS NUMBER TOO LARGE
+ if (isinf(NumericValue.Value) || isnan(NumericValue.Value))
+   {
+   //                              01234567890123456789
+   strcpy((char *)NumericValue.Description, "Value looks Inf");
+   strcpy((char *)NumericValue.Solution, "Out of range");
+   strcpy((char *)NumericValue.AudioErrorFileName, VALUE_TOO_LARGE_WAV);
+   NumericValue.AudioPlayLevel = BASIC_HELP;
+   return(FALSE);
+   }
+ bln_InputHasExp = FALSE; // On valid number must clear.
+ LastX = NumericValue.Value;
+ return(TRUE);
+
+ } // END OF call_IsNumeric
+
+
+
+
+/*************************************************************************
+ * Function Name: call_NumEntryReset
+ * Parameters: uint8_t
+ * Return: void
+ *
+ * Description: Clears the entry parse for a new line of entry in the base passed.
+ * STEP 1: Clear all and set the base
+ *************************************************************************/
+ void call_NumEntryReset(uint8_t NumericBase)
+ {
+ 
+ // STEP 1
+ memset(&NumEntry, 0, sizeof(NumEntry));
+ NumEntry.Base = NumericBase;
+ 
+ } // END OF call_NumEntryReset
+
+
+
+
+/*************************************************************************
+ * Function Name: call_NumEntryAddChar
+ * Parameters: uint8_t
+ * Return: void
+ *
+ * Description: Updates the entry parse with one char appended to the input line.  Digits
+ * are accumulated Horner style into an integer mantissa (X10 for decimal, X16 for hex) so
+ * no powers or string conversions are needed when the value is taken.  Chars that are not
+ * valid in the base, or a second 'E' or '.', are counted as invalid.
+ * STEP 1: Get the value of the char as a digit in the base of entry
+ * STEP 2: Digits after the 'E' go to the exponent
+ * STEP 3: Digits go to the mantissa - leading zeros are not significant
+ * STEP 4: Decimal point, exponent and signs
+ *************************************************************************/
+ void call_NumEntryAddChar(uint8_t CharToAdd)
+ {
+ 
+ uint8_t Digit = 0xFF;
+ int32_t Exponent;
+ 
+ // STEP 1
+ if ((CharToAdd >= '0') && (CharToAdd <= '9'))
+   Digit = CharToAdd - '0';
+ if ((NumEntry.Base == BASE_16) && (CharToAdd >= HEX_A) && (CharToAdd <= HEX_F))
+   Digit = CharToAdd - HEX_A + 10;
+ NumEntry.Length++;
+ 
+ // STEP 2
+ if ((Digit != 0xFF) && (NumEntry.HasExp))
+   {
+   NumEntry.ExponentDigits++;
+   // ACCUMULATE WIDE AND CLAMP - THE INT16 WOULD WRAP PAST 32767 AND '1 E 65536' WOULD BE 1
+   Exponent = ((int32_t)NumEntry.Exponent * 10) + Digit;
+   NumEntry.Exponent = (Exponent > MAX_ENTRY_EXPONENT) ? MAX_ENTRY_EXPONENT : (int16_t)Exponent;
+   return;
+   }
+ 
+ // STEP 3
+ if (Digit != 0xFF)
+   {
+   if ((NumEntry.Mantissa == 0) && (Digit == 0))
+     {
+     if (NumEntry.HasDP)
+       NumEntry.FractionDigits++;
+     }
+   else if (NumEntry.MantissaDigits < ((NumEntry.Base == BASE_16) ? MAX_HEX_DIGITS : MAX_MANTISSA_DIGITS))
+     {
+     NumEntry.Mantissa = (NumEntry.Mantissa * ((NumEntry.Base == BASE_16) ? 16 : 10)) + Digit;
+     NumEntry.MantissaDigits++;
+     if (NumEntry.HasDP)
+       NumEntry.FractionDigits++;
+     }
+   else
+     NumEntry.DroppedDigits++;
+   return;
+   }
+ 
+ // STEP 4
+ // NONE OF THESE ARE VALID IN HEX
+ if (NumEntry.Base == BASE_16)
+   {
+   NumEntry.InvalidChars++;
+   return;
+   }
+ switch(CharToAdd)
+   {
+   case '.':
+     if ((NumEntry.HasDP) || (NumEntry.HasExp))
+       NumEntry.InvalidChars++;
+     NumEntry.HasDP = TRUE;
+   break;
+   
+   case 'E':
+     if (NumEntry.HasExp)
+       NumEntry.InvalidChars++;
+     NumEntry.HasExp = TRUE;
+   break;
    
-        case 'F':
-        HexStringValue += 15 * (pow(16, Base16Power));
-        break; 
-        
-        default:
-        NumericValue.Valid = FALSE;
-        //                              01234567890123456789
-        strcpy(NumericValue.Description, "Invalid Number");
-        strcpy(NumericValue.Solution,    "Check your base");
-        strcpy(NumericValue.AudioErrorFileName, INVALID_NUMBER_WAV);
-        NumericValue.AudioPlayLevel = BASIC_HELP;
-        strcpy(NumericValue.Result, StringToConvert);
-        return(FALSE);
-        break;
-        }
-      StringValue++;
-      Base16Power--;
-      }
-     NumericValue.Value = HexStringValue;
-     // CHECK FOR INFINITE ERROR - INF ERROR IS NUMBER TOO LARGE
-     if (isinf(NumericValue.Value) || isnan(NumericValue.Value))
+   case '+':
+   case '-':
+     // ONLY AS THE FIRST CHAR OR DIRECTLY FOLLOWING THE 'E'
+     if (NumEntry.Length == 1)
+       NumEntry.MantissaNeg = (CharToAdd == '-');
+     else if ((NumEntry.HasExp) && (!NumEntry.ExpSignGiven) && (NumEntry.ExponentDigits == 0))
        {
-       //                              01234567890123456789
-       strcpy(NumericValue.Description, "Value looks Inf");
-       strcpy(NumericValue.Solution, "Out of range");
-       strcpy(NumericValue.AudioErrorFileName, VALUE_TOO_LARGE_WAV);
-       NumericValue.AudioPlayLevel = BASIC_HELP;
-       return(FALSE);
+       NumEntry.ExpSignGiven = TRUE;
+       NumEntry.ExponentNeg = (CharToAdd == '-');
        }
-     bln_InputHasExp = FALSE; // On valid number must clear.
-     LastX = NumericValue.Value;
-     return(TRUE);
-     } // BASE_16
+     else
+       NumEntry.InvalidChars++;
+   break;
+   
+   default:
+     NumEntry.InvalidChars++;
+   break;
+   }
+ 
+ } // END OF call_NumEntryAddChar
 
- } // END OF call_IsNumeric
+
+
+
+/*************************************************************************
+ * Function Name: call_NumEntryReload
+ * Parameters: const uint8_t *, uint8_t
+ * Return: void
+ *
+ * Description: Rebuilds the entry parse from a whole string.  Used on backspace and
+ * whenever the parse does not describe the string to be evaluated.
+ * STEP 1: Reset and feed each char of the string
+ *************************************************************************/
+ void call_NumEntryReload(const uint8_t StringToLoad[], uint8_t NumericBase)
+ {
+ 
+ // STEP 1
+ call_NumEntryReset(NumericBase);
+ while (*StringToLoad != NULL_VALUE)
+   {
+   call_NumEntryAddChar(*StringToLoad);
+   StringToLoad++;
+   }
+ } // END OF call_NumEntryReload
 
 
 
@@ -489,7 +598,11 @@ extern CTL_MEMORY_AREA_t MemArea;
  * Description: Formats the number based on BASE 10 or BASE 16 modes.  Base 10
  * modes have an option of Scientific (ENG Mode) or Fix (mantissa) mode.  In fix mode
  * if the number exceeds a pre-defined max value it is automatically displayed in ENG mode.
- * In Hex mode if the number exceeds a pre-defined max value it too is displayed in ENG mode.
+ * In complex mode each register is shown as its two parts (see call_ComplexFormat).
+ * In Hex mode the integer word of each register is displayed zero filled to the word size.  The
+ * double of the register is a shadow of the word and is refreshed here.  If the double no longer
+ * matches the word (a floating point function was used) the word is loaded from the double.
+ * While a program runs (bln_DisplayHold) only the hex word is kept current - nothing is displayed.
  * STEP 1: Clear screen
  * STEP 2: Format Display registers according to Display Base with setting precision
  * STEP 3: Display the registers according to display value status
@@ -501,34 +614,43 @@ extern CTL_MEMORY_AREA_t MemArea;
  Type_AudioQueueStruct AudioQueueStruct;
  
  // STEP 1
- DIP204_clearDisplay();
+ if (!bln_DisplayHold)
+   DIP204_clearDisplay();
  
  // STEP 2
  switch(CalSettings.CalBase)
    {
    default:
    case BASE_10:
+     if (bln_DisplayHold)
+       break;
      for(uint8_t RegCount = 0; RegCount < TOTAL_REGISTERS; RegCount++)
        {
+       // COMPLEX MODE - THE ONLY PLACE THE PARTS ARE CONVERTED TO POLAR
+       if (CalSettings.ComplexMode)
+         {
+         call_ComplexFormat(&RegisterValue[RegCount]);
+         continue;
+         }
        // FIX MODE
        if (CalSettings.DisplayMode == FIX)
          {
          if ((RegisterValue[RegCount].NumericValue > LARGEST_FIX_DISPLAY_NUMBER) || (RegisterValue[RegCount].NumericValue < (-1.0 *LARGEST_FIX_DISPLAY_NUMBER)))
            {
-           sprintf(RegisterValue[RegCount].DisplayAs,"%2.*E",CalSettings.EngPrecision, RegisterValue[RegCount].NumericValue);
-           strcpy(AudioQueueStruct.FileName, FIX_EXCEEDED_WAV);
+           sprintf((char *)RegisterValue[RegCount].DisplayAs,"%2.*E",CalSettings.EngPrecision, RegisterValue[RegCount].NumericValue);
+           strcpy((char *)AudioQueueStruct.FileName, FIX_EXCEEDED_WAV);
            AudioQueueStruct.FullInteractiveMask = FIX_EXCEEDED_MASK;
            AudioQueueStruct.PlayLevel = FULL_INTERACTIVE;
            ctl_PostMessageByMemAllocate(&AudioQueueStruct);
            }
          else
-           sprintf(RegisterValue[RegCount].DisplayAs,"%#2.*f",CalSettings.FixPrecision, RegisterValue[RegCount].NumericValue);
+           sprintf((char *)RegisterValue[RegCount].DisplayAs,"%#2.*f",CalSettings.FixPrecision, RegisterValue[RegCount].NumericValue);
          }
        else
          {
          // ENG MODE
          if (CalSettings.DisplayMode == ENG)
-         sprintf(RegisterValue[RegCount].DisplayAs,"%2.*E",CalSettings.EngPrecision, RegisterValue[RegCount].NumericValue);
+         sprintf((char *)RegisterValue[RegCount].DisplayAs,"%2.*E",CalSettings.EngPrecision, RegisterValue[RegCount].NumericValue);
          }
        }
    break;
@@ -536,18 +658,23 @@ extern CTL_MEMORY_AREA_t MemArea;
    case BASE_16:
      for(uint8_t RegCount = 0; RegCount < TOTAL_REGISTERS; RegCount++)
        {
-       if (RegisterValue[RegCount].NumericValue < LARGEST_HEX_DISPLAY_NUMBER)
-         sprintf(RegisterValue[RegCount].DisplayAs,"0x%X", (int32_t)RegisterValue[RegCount].NumericValue);
-       else
-         sprintf(RegisterValue[RegCount].DisplayAs,"%2.*E",CalSettings.EngPrecision, RegisterValue[RegCount].NumericValue);
+       // A FLOATING POINT FUNCTION CHANGED THE REGISTER - LOAD THE WORD FROM IT
+       if ((!bln_IntegerResult) && (RegisterValue[RegCount].NumericValue != call_IntToDouble(RegisterValue[RegCount].IntegerValue)))
+         RegisterValue[RegCount].IntegerValue = call_IntFromDouble(RegisterValue[RegCount].NumericValue);
+       RegisterValue[RegCount].NumericValue = call_IntToDouble(RegisterValue[RegCount].IntegerValue);
+       if (!bln_DisplayHold)
+         call_IntFormat(RegisterValue[RegCount].IntegerValue, RegisterValue[RegCount].DisplayAs);
        }
+     bln_IntegerResult = FALSE;
    }
+ if (bln_DisplayHold)
+   return;
  
  // STEP 3
  for (uint8_t LineCount = 1; LineCount < DISPLAY_LINE_TOTAL+1; LineCount++)
    {
    if (RegisterValue[(TOTAL_REGISTERS-LineCount)].Displayed)
-     DIP204_txt_engine(RegisterValue[(TOTAL_REGISTERS-LineCount)].DisplayAs, LineCount, 0, strlen(RegisterValue[(TOTAL_REGISTERS-LineCount)].DisplayAs));
+     DIP204_txt_engine(RegisterValue[(TOTAL_REGISTERS-LineCount)].DisplayAs, LineCount, 0, strlen((const char *)RegisterValue[(TOTAL_REGISTERS-LineCount)].DisplayAs));
    else
      DIP204_clearLine(LineCount);
    }
@@ -585,15 +712,15 @@ extern CTL_MEMORY_AREA_t MemArea;
  
  // STEP 2
  DIP204_clearDisplay();
- sprintf(LineText,"ENTRY ERROR:");
- DIP204_txt_engine(LineText, 1, 0, strlen(LineText));
- DIP204_txt_engine(NumericValue.Description, 2, 3, strlen(NumericValue.Description));
- DIP204_txt_engine(NumericValue.Solution, 3, 3, strlen(NumericValue.Solution));
+ sprintf((char *)LineText,"ENTRY ERROR:");
+ DIP204_txt_engine(LineText, 1, 0, strlen((const char *)LineText));
+ DIP204_txt_engine(NumericValue.Description, 2, 3, strlen((const char *)NumericValue.Description));
+ DIP204_txt_engine(NumericValue.Solution, 3, 3, strlen((const char *)NumericValue.Solution));
  DIP204_ICON_set(ICON_ALERT, ICON_BLINK);
  DIP204_set_cursor(CURSOR_OFF);
  
  // STEP 3
- strcpy(AudioToPlay.FileName, NumericValue.AudioErrorFileName);
+ strcpy((char *)AudioToPlay.FileName, (const char *)NumericValue.AudioErrorFileName);
  AudioToPlay.PlayLevel = NumericValue.AudioPlayLevel;
  ctl_PostMessageByMemAllocate(&AudioToPlay);
 
@@ -613,14 +740,14 @@ extern CTL_MEMORY_AREA_t MemArea;
  * table that follows. Note, Memory address 0-99 cannot all be filled.  After the loading of
  * the Cal Registers the memory is loaded.  A cal memory marker dictates there is memory to read.
  * Note, registers are stored as an 8 byte value.  The bytes are read into a union and converted to double
- * for use
+ * for use.  In HEX mode the 8 bytes are the integer word of the register
  * TABLE OF MEMORY ADDRESS AND CONTENTS:
  * ADDR CONTENTS
  * 0    EEPROM HAS SOMETHING TO READ (A5)
  * 1    .CalBase (Lower Nibble) / .Setup.BacklightTimeOut (Upper Nibble)
  * 2    .FixPrecision (Lower Nibble) / .Setup.CalVerbose (Upper Nibble)
  * 3    .EngPrecision (Lower Nibble) / .Setup.TimeToSleep (Upper Nibble)
- * 4    .DisplayMode
+ * 4    .DisplayMode (Lower Nibble) / .WordSize (Bits 4-5) / .IntSigned (Bit 6) / .DecimalMath (Bit 7)
  * 5    .CalAngle
  * 6    DisplayByte (for RegisterValues - Loaded LSN bit set = displayed
  * NEXT 8 BYTES = REGISTER 0 (X)
@@ -656,9 +783,11 @@ extern CTL_MEMORY_AREA_t MemArea;
  // INIT I2C1 THE EEPROM I2C PORT
  init_I2C1(I2C_24C0X_FREQUENCY);
  // CLEAR AND INIT CONDITIONS
- strcpy(DefaultRegister.DisplayAs, "");
+ strcpy((char *)DefaultRegister.DisplayAs, "");
  DefaultRegister.Displayed = FALSE;
  DefaultRegister.NumericValue = 0.0;
+ DefaultRegister.IntegerValue = 0;
+ DefaultRegister.Imaginary = 0.0;
  for (uint8_t RegCount = 0; RegCount < TOTAL_REGISTERS; RegCount++)
    {
    RegisterValue[RegCount] = DefaultRegister;
@@ -670,6 +799,9 @@ extern CTL_MEMORY_AREA_t MemArea;
  CalSettings.CalError = NO_ERROR;
  CalSettings.SleepDisable = FALSE;
  CalSettings.USB_Link = FALSE;
+ CalSettings.ComplexMode = FALSE;  // THE IMAGINARY PARTS ARE NOT STORED - ALWAYS START REAL
+ CalSettings.ComplexPolar = FALSE;
+ CalSettings.KernelMode = KERNEL_ACCURATE;  // FAST ONLY WHILE THE PROGRAM TASK RUNS A BATCH OR STATISTICS
  select_All_Normal_Keys(); // ALL KEYS ARE ACTIVE IN CAL MODE
  STO_RCL.STO_Event = FALSE;
  STO_RCL.RCL_Event = FALSE;
@@ -683,6 +815,9 @@ extern CTL_MEMORY_AREA_t MemArea;
    CalSettings.FixPrecision = 4;
    CalSettings.EngPrecision = 3;
    CalSettings.DisplayMode = FIX;
+   CalSettings.WordSize = WORD_SIZE_64;
+   CalSettings.IntSigned = FALSE;
+   CalSettings.DecimalMath = FALSE;
    CalSettings.CalAngle = DEGREES;
    CalSettings.Setup.BackLightTimeOut = DEFAULT_BACKLIGHT_TIMEOUT;
    CalSettings.Setup.CalVerbose = FULL_INTERACTIVE;
@@ -705,7 +840,10 @@ extern CTL_MEMORY_AREA_t MemArea;
  CalSettings.Setup.CalVerbose = (EEPROM_Data[1] >> 4);
  CalSettings.EngPrecision = (0x0F & EEPROM_Data[2]);
  CalSettings.Setup.TimeToSleep = (EEPROM_Data[2] >> 4);
- CalSettings.DisplayMode = EEPROM_Data[3];
+ CalSettings.DisplayMode = (0x0F & EEPROM_Data[3]);
+ CalSettings.WordSize = (0x03 & (EEPROM_Data[3] >> 4));
+ CalSettings.IntSigned = ((EEPROM_Data[3] & 0x40) ? TRUE : FALSE);
+ CalSettings.DecimalMath = ((EEPROM_Data[3] & 0x80) ? TRUE : FALSE);
  CalSettings.CalAngle = EEPROM_Data[4];
  if (CalSettings.CalAngle == RADS)
    {
@@ -730,7 +868,13 @@ extern CTL_MEMORY_AREA_t MemArea;
      {
      ValueToStore.ByteValue[ByteCount] = EEPROM_Data[ByteCount];
      }
-   RegisterValue[RegCount].NumericValue = ValueToStore.DoubleValue;
+   if (CalSettings.CalBase == BASE_16)
+     {
+     RegisterValue[RegCount].IntegerValue = ValueToStore.IntegerValue;
+     RegisterValue[RegCount].NumericValue = call_IntToDouble(ValueToStore.IntegerValue);
+     }
+   else
+     RegisterValue[RegCount].NumericValue = ValueToStore.DoubleValue;
    Index += sizeof(double);
    }
  
@@ -774,14 +918,14 @@ extern CTL_MEMORY_AREA_t MemArea;
  * On a 256 memory you can store 21 memory locations.  Memory is stored from 00 to 99 if non-zero until there
  * is no more storage memory.
  * Note, registers are stored as an 8 byte value.  The bytes are read into a union and converted to double
- * for use
+ * for use.  In HEX mode the 8 bytes are the integer word of the register
  * TABLE OF MEMORY ADDRESS AND CONTENTS:
  * ADDR CONTENTS
  * 0    EEPROM HAS SOMETHING TO READ (A5)
  * 1    .CalBase (Lower Nibble) / .Setup.BacklightTimeOut (Upper Nibble)
  * 2    .FixPrecision (Lower Nibble) / .Setup.CalVerbose (Upper Nibble)
  * 3    .EngPrecision (Lower Nibble) / .Setup.TimeToSleep (Upper Nibble)
- * 4    .DisplayMode
+ * 4    .DisplayMode (Lower Nibble) / .WordSize (Bits 4-5) / .IntSigned (Bit 6) / .DecimalMath (Bit 7)
  * 5    .CalAngle
  * 6    DisplayByte (for RegisterValues - Loaded LSN bit set = displayed
  * NEXT 8 BYTES = REGISTER 0 (X)
@@ -817,7 +961,7 @@ extern CTL_MEMORY_AREA_t MemArea;
  EEPROM_Data[++Index] = (CalSettings.CalBase | (CalSettings.Setup.BackLightTimeOut << 4));
  EEPROM_Data[++Index] = (CalSettings.FixPrecision | (CalSettings.Setup.CalVerbose << 4));
  EEPROM_Data[++Index] = (CalSettings.EngPrecision | (CalSettings.Setup.TimeToSleep << 4));
- EEPROM_Data[++Index] = CalSettings.DisplayMode;
+ EEPROM_Data[++Index] = (CalSettings.DisplayMode | (CalSettings.WordSize << 4) | (CalSettings.IntSigned << 6) | (CalSettings.DecimalMath << 7));
  EEPROM_Data[++Index] = CalSettings.CalAngle;
  
  // STEP 3
@@ -834,7 +978,10 @@ extern CTL_MEMORY_AREA_t MemArea;
  // STEP 4
  for (uint8_t RegCount = 0; RegCount < TOTAL_REGISTERS; RegCount++)
    {
-   ValueToStore.DoubleValue = RegisterValue[RegCount].NumericValue;
+   if (CalSettings.CalBase == BASE_16)
+     ValueToStore.IntegerValue = RegisterValue[RegCount].IntegerValue;
+   else
+     ValueToStore.DoubleValue = RegisterValue[RegCount].NumericValue;
    for (uint8_t ByteCount = 0; ByteCount < sizeof(double); ByteCount++)
      {
      EEPROM_Data[++Index] = ValueToStore.ByteValue[ByteCount];
@@ -894,7 +1041,7 @@ extern CTL_MEMORY_AREA_t MemArea;
      for (uint8_t LineCount = 1; LineCount < 4; LineCount++)
        {
        if (RegisterValue[3-LineCount].Displayed == TRUE)
-         DIP204_txt_engine(RegisterValue[3-LineCount].DisplayAs, LineCount, 0, strlen(RegisterValue[3-LineCount].DisplayAs));
+         DIP204_txt_engine(RegisterValue[3-LineCount].DisplayAs, LineCount, 0, strlen((const char *)RegisterValue[3-LineCount].DisplayAs));
        else
         DIP204_clearLine(LineCount);
        }
@@ -914,7 +1061,7 @@ extern CTL_MEMORY_AREA_t MemArea;
        for (uint8_t LineCount = 1; LineCount < 5; LineCount++)
          {
          if (RegisterValue[4-LineCount].Displayed == TRUE)
-           DIP204_txt_engine(RegisterValue[4-LineCount].DisplayAs, LineCount, 0, strlen(RegisterValue[4-LineCount].DisplayAs));
+           DIP204_txt_engine(RegisterValue[4-LineCount].DisplayAs, LineCount, 0, strlen((const char *)RegisterValue[4-LineCount].DisplayAs));
          else
            DIP204_clearLine(LineCount);
          }
@@ -924,7 +1071,7 @@ extern CTL_MEMORY_AREA_t MemArea;
        for (uint8_t LineCount = 1; LineCount < 4; LineCount++)
        {
        if (RegisterValue[3-LineCount].Displayed == TRUE)
-         DIP204_txt_engine(RegisterValue[3-LineCount].DisplayAs, LineCount, 0, strlen(RegisterValue[3-LineCount].DisplayAs));
+         DIP204_txt_engine(RegisterValue[3-LineCount].DisplayAs, LineCount, 0, strlen((const char *)RegisterValue[3-LineCount].DisplayAs));
        else
         DIP204_clearLine(LineCount);
        }
@@ -962,10 +1109,16 @@ extern CTL_MEMORY_AREA_t MemArea;
   if (bln_LineLoaded) 
     {
     RegisterValue[1].NumericValue = RegisterValue[2].NumericValue;
+    RegisterValue[1].IntegerValue = RegisterValue[2].IntegerValue;
+    RegisterValue[1].Imaginary = RegisterValue[2].Imaginary;
     RegisterValue[1].Displayed = RegisterValue[2].Displayed;
     RegisterValue[2].NumericValue = RegisterValue[3].NumericValue;
+    RegisterValue[2].IntegerValue = RegisterValue[3].IntegerValue;
+    RegisterValue[2].Imaginary = RegisterValue[3].Imaginary;
     RegisterValue[2].Displayed = RegisterValue[3].Displayed;
     RegisterValue[3].NumericValue = 0.0;
+    RegisterValue[3].IntegerValue = 0;
+    RegisterValue[3].Imaginary = 0.0;
     RegisterValue[3].Displayed = FALSE;
     }
   else
@@ -996,17 +1149,25 @@ extern CTL_MEMORY_AREA_t MemArea;
   if (bln_LineLoaded) 
     {
     RegisterValue[0].NumericValue = Ans;
+    RegisterValue[0].Imaginary = 0.0;
     RegisterValue[0].Displayed = TRUE;
     }
   else
    {
    RegisterValue[3].NumericValue = RegisterValue[2].NumericValue;
+   RegisterValue[3].IntegerValue = RegisterValue[2].IntegerValue;
+   RegisterValue[3].Imaginary = RegisterValue[2].Imaginary;
    RegisterValue[3].Displayed = RegisterValue[2].Displayed;
    RegisterValue[2].NumericValue = RegisterValue[1].NumericValue;
+   RegisterValue[2].IntegerValue = RegisterValue[1].IntegerValue;
+   RegisterValue[2].Imaginary = RegisterValue[1].Imaginary;
    RegisterValue[2].Displayed = RegisterValue[1].Displayed;
    RegisterValue[1].NumericValue = RegisterValue[0].NumericValue;
+   RegisterValue[1].IntegerValue = RegisterValue[0].IntegerValue;
+   RegisterValue[1].Imaginary = RegisterValue[0].Imaginary;
    RegisterValue[1].Displayed = RegisterValue[0].Displayed;
    RegisterValue[0].NumericValue = Ans;
+   RegisterValue[0].Imaginary = 0.0;
    RegisterValue[0].Displayed = TRUE;
    bln_LineLoaded = TRUE;
    }
@@ -1040,8 +1201,8 @@ extern CTL_MEMORY_AREA_t MemArea;
  // STEP 1
  str_StorageLocation[0] = str_InputLine[4];
  str_StorageLocation[1] = str_InputLine[5];
- str_StorageLocation[3] = NULL_VALUE;
- StorageLocation = atoi(str_StorageLocation);
+ str_StorageLocation[2] = NULL_VALUE;
+ StorageLocation = atoi((const char *)str_StorageLocation);
  
  // STEP 2
  STO_RCL.StoredValue[StorageLocation] = RegisterValue[0].NumericValue;
@@ -1077,8 +1238,8 @@ extern CTL_MEMORY_AREA_t MemArea;
  // STEP 1
  str_StorageLocation[0] = str_InputLine[4];
  str_StorageLocation[1] = str_InputLine[5];
- str_StorageLocation[3] = NULL_VALUE;
- StorageLocation = atoi(str_StorageLocation);
+ str_StorageLocation[2] = NULL_VALUE;
+ StorageLocation = atoi((const char *)str_StorageLocation);
  
  // STEP 2
  STO_RCL.RCL_Event = FALSE;
@@ -1165,6 +1326,10 @@ extern CTL_MEMORY_AREA_t MemArea;
      call_MusicListModeEnd();
    break;
    
+   case SCOPE_MODE:
+     call_ScopeModeEnd();
+   break;
+   
    default:
    case CAL_MODE:
    break;
@@ -1246,7 +1411,7 @@ extern CTL_MEMORY_AREA_t MemArea;
       ctl_handle_error(CTL_UNSPECIFIED_ERROR);
  
  // STEP 2
- strcpy(AudioToPlay->FileName, AudioStruct->FileName);
+ strcpy((char *)AudioToPlay->FileName, (const char *)AudioStruct->FileName);
  AudioToPlay->PlayLevel = AudioStruct->PlayLevel;
  AudioToPlay->FullInteractiveMask = AudioStruct->FullInteractiveMask;
  
@@ -1254,4 +1419,76 @@ extern CTL_MEMORY_AREA_t MemArea;
  ctl_message_queue_post(&AudioQueue, AudioToPlay, 0, 0);
 
  } // END OF ctl_PostMessageByMemAllocate
-   
\ No newline at end of file
+   
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ScratchClaim
+ * Parameters: uint8_t Owner, uint16_t Size
+ * Return: void *
+ *
+ * Description: The scratch pool for Owner (see enum SCRATCH_OWNER) - Size bytes of it are needed.
+ * BIG, the matrices and BATCH never run together, so they share one pool of AHB SRAM in place
+ * of a buffer each.  The pool is given if it is free, already Owner's, or held by BIG: the BIG
+ * result kept for the view is only a copy of what was shown, so it is given up (the view then
+ * has no result).  The matrices hold the pool while any is dimensioned and BATCH for its run.
+ * Returns NULL if the pool is held by one of them or Size is more than the pool - the caller
+ * shows the error.  Only the click and program tasks claim, never at the same time.
+ * STEP 1: Too large
+ * STEP 2: Free, Owner's or BIG's - Owner's now
+ *************************************************************************/
+ void *call_ScratchClaim(uint8_t Owner, uint16_t Size)
+ {
+
+ // STEP 1
+ if (Size > SCRATCH_POOL_SIZE)
+   return(NULL);
+
+ // STEP 2
+ if ((ScratchOwner != SCRATCH_FREE) && (ScratchOwner != Owner) && (ScratchOwner != SCRATCH_BIGNUM))
+   return(NULL);
+ ScratchOwner = Owner;
+ return(ScratchPool);
+
+ } // END OF call_ScratchClaim
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ScratchRelease
+ * Parameters: uint8_t Owner
+ * Return: void
+ *
+ * Description: Owner is done with the scratch pool.  No effect if Owner does not hold it.
+ * STEP 1: Free if Owner's
+ *************************************************************************/
+ void call_ScratchRelease(uint8_t Owner)
+ {
+
+ // STEP 1
+ if (ScratchOwner == Owner)
+   ScratchOwner = SCRATCH_FREE;
+
+ } // END OF call_ScratchRelease
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ScratchOwned
+ * Parameters: uint8_t Owner
+ * Return: BOOLEAN
+ *
+ * Description: TRUE if Owner holds the scratch pool - what it left there is still there.
+ * STEP 1: Compare
+ *************************************************************************/
+ BOOLEAN call_ScratchOwned(uint8_t Owner)
+ {
+
+ // STEP 1
+ return(ScratchOwner == Owner);
+
+ } // END OF call_ScratchOwned
@@ -4,7 +4,7 @@
  * Description:       Project definitions and function prototypes for use with CORE_FUNCTIONS.c
  * Author:            Hab S. Collector
  * Date:              10/12/2011
- * LAST EDIT:         7/24/2012
+ * LAST EDIT:         10/19/2026
  * Hardware:               
  * Firmware Tool:     CrossStudio for ARM
  * Notes:             This file should be written as to not be dependent 
@@ -38,10 +38,15 @@
 #define BACKSPACE           200
 #define STO                 226
 #define RCL                 227
+// USED BY THE INCREMENTAL ENTRY PARSE
+#define MAX_MANTISSA_DIGITS   19                      // uint64_t HOLDS 19 DECIMAL DIGITS WITHOUT OVERFLOW
+#define MAX_HEX_DIGITS        16                      // uint64_t HOLDS 16 HEX DIGITS WITHOUT OVERFLOW
+#define MAX_EXACT_MANTISSA    9007199254740992ULL     // 2^53 - LARGEST INTEGER HELD EXACTLY BY A DOUBLE
+#define MAX_EXACT_POWER_OF_10 22                      // 1E22 - LARGEST POWER OF 10 HELD EXACTLY BY A DOUBLE
+#define MAX_ENTRY_EXPONENT    9999                    // CLAMP - ANYTHING THIS LARGE IS INF OR 0 ANYWAY
 
 // NUMBER FORMATING
 #define LARGEST_FIX_DISPLAY_NUMBER 1E10               // LARGEST POSSIBLE FIX DISPLAY VALUE - GOES TO ENG IF LARGER
-#define LARGEST_HEX_DISPLAY_NUMBER 2147483647         // int32_t
 #define MAX_FIX_PRECISION          5
 #define MIN_FIX_PRECISION          1
 #define DEFAULT_FIX_PRECISION      2
@@ -59,6 +64,8 @@ typedef struct
   uint8_t DisplayAs [MAX_DISPLAY_LENGTH]; // STRING REPRESENTATION OF THE NUMBER
   BOOLEAN Displayed;                      // IS THE VALUE TO BE DISPLAYED
   double NumericValue;                    // MUST BE GREATER THAN 0
+  uint64_t IntegerValue;                  // HEX (INTEGER) MODE VALUE - MASKED TO THE WORD SIZE
+  double Imaginary;                       // COMPLEX MODE IMAGINARY PART - NumericValue IS THE REAL PART
   } Type_Register;
 
 typedef struct
@@ -70,8 +77,27 @@ typedef struct
   uint8_t AudioErrorFileName[30];            // FILE NAME OF ASSOCIATED ERROR FILE
   uint8_t AudioPlayLevel;                    // PLAY LEVEL OF ASSOCIATED ERROR FILE
   double Value;                              // NUMERIC VALUE
+  uint64_t IntegerValue;                     // HEX (INTEGER) MODE VALUE
   } Type_Numeric;
 
+typedef struct
+  {
+  uint64_t Mantissa;                         // DIGITS ACCUMULATED HORNER STYLE (X10 OR X16 PER DIGIT)
+  int16_t Exponent;                          // DIGITS ACCUMULATED AFTER THE 'E'
+  uint8_t ExponentDigits;                    // DIGITS ENTERED AFTER THE 'E'
+  uint8_t FractionDigits;                    // DIGITS HELD IN MANTISSA THAT FOLLOW THE DECIMAL POINT
+  uint8_t MantissaDigits;                    // SIGNIFICANT DIGITS HELD IN MANTISSA
+  uint8_t DroppedDigits;                     // DIGITS THAT WOULD OVERFLOW MANTISSA
+  uint8_t InvalidChars;                      // CHARS NOT VALID IN THE BASE OF ENTRY
+  uint8_t Length;                            // LENGTH OF THE INPUT LINE THIS STATE DESCRIBES
+  uint8_t Base;                              // BASE THE STATE WAS BUILT IN SEE ENUM NUMERIC BASE
+  BOOLEAN HasDP;                             // DECIMAL POINT ENTERED
+  BOOLEAN HasExp;                            // EXPONENT ENTERED
+  BOOLEAN ExpSignGiven;                      // '+' OR '-' FOLLOWS THE 'E'
+  BOOLEAN MantissaNeg;                       // LEADING '-'
+  BOOLEAN ExponentNeg;                       // '-' FOLLOWS THE 'E'
+  } Type_NumEntry;
+
 typedef struct
   {
   uint8_t BackLightTimeOut;
@@ -103,7 +129,13 @@ typedef struct
   uint8_t EngPrecision;                 // ENG FORMAT PRECISIION FOR BASE 10
   uint8_t DisplayMode;                  // CAL DISPLAY SEE ENUM DISPLAY MODE
   uint8_t CalAngle;                     // CAL ANGLE SEE ENUM ANGLE MEASURE
+  uint8_t KernelMode;                   // SIN COS TAN EXP LN ACCURACY SEE ENUM KERNEL_MODE - NOT STORED
   uint8_t CalMode;                      // CAL MODE SEE ENUM OPERATING_MODE
+  uint8_t WordSize;                     // HEX MODE INTEGER WORD SIZE SEE ENUM INT_WORD_SIZE
+  BOOLEAN IntSigned;                    // HEX MODE INTEGER 2'S COMPLEMENT (TRUE) OR UNSIGNED
+  BOOLEAN DecimalMath;                  // BASE 10 MATH IN 13 DIGIT BCD (TRUE) OR BINARY DOUBLE
+  BOOLEAN ComplexMode;                  // BASE 10 COMPLEX STACK - NOT STORED, ALWAYS STARTS REAL
+  BOOLEAN ComplexPolar;                 // COMPLEX MODE DISPLAY: POLAR (TRUE) OR RECTANGULAR
   uint16_t CalVerboseMask;              // CAL MODE FULL INTERACTIVE HELP
   BOOLEAN L_Shift;                      // LEFT SHFIT FLAG
   BOOLEAN R_Shift;                      // RIGHT SHIFT FLAG
@@ -127,6 +159,7 @@ typedef struct
 typedef union
    {
    double DoubleValue;
+   uint64_t IntegerValue;
    uint8_t ByteValue[sizeof(double)];
    } Union_DoubleInBytes;
 
@@ -166,7 +199,17 @@ enum OPERATING_MODE
   OHMS_MODE,
   SD_LIST_MODE,
   SETUP_MODE,
-  MUSIC_LIST_MODE
+  MUSIC_LIST_MODE,
+  SCOPE_MODE
+  };
+
+// OWNER OF THE SCRATCH POOL - SEE call_ScratchClaim
+enum SCRATCH_OWNER
+  {
+  SCRATCH_FREE,
+  SCRATCH_BIGNUM,                           // THE ARENA - KEEPS THE LAST RESULT FOR THE VIEW UNTIL ANOTHER CLAIM
+  SCRATCH_MATRIX,                           // THE ELEMENTS - WHILE ANY MATRIX IS DIMENSIONED
+  SCRATCH_BATCH                             // THE FILES AND BLOCKS - FOR THE RUN
   };
 
 typedef enum 
@@ -181,6 +224,9 @@ typedef enum
 // PROTOTYPES
 void call_NumClick(uint8_t);
 BOOLEAN call_IsNumericValue(const uint8_t *, uint8_t);
+void call_NumEntryReset(uint8_t);
+void call_NumEntryAddChar(uint8_t);
+void call_NumEntryReload(const uint8_t *, uint8_t);
 void call_FormatNumber(void);
 void call_ShowEntryError(void);
 void call_LoadCalSettings(void);
@@ -195,5 +241,8 @@ void call_EndPresentMode(void);
 void ctl_HabTaskSuspend(CTL_TASK_t *);
 void ctl_HabTaskRun(CTL_TASK_t *);
 void ctl_PostMessageByMemAllocate(Type_AudioQueueStruct *);
+void *call_ScratchClaim(uint8_t, uint16_t);
+void call_ScratchRelease(uint8_t);
+BOOLEAN call_ScratchOwned(uint8_t);
 
 #endif
\ No newline at end of file
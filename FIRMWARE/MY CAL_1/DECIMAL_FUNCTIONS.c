@@ -0,0 +1,967 @@
+/*****************************************************************
+ *
+ * File name:       DECIMAL_FUNCTIONS.C
+ * Description:     Packed BCD decimal arithmetic engine of the HC15C
+ * Author:          Hab S. Collector
+ * Date:            10/19/2026
+ * LAST EDIT:       10/19/2026
+ * Hardware:        NXP LPC1769
+ * Firmware Tool:   CrossStudio for ARM
+ * Notes:           This file should be written as to not be dependent on other includes.
+ *                  everything these functions need should be passed to them.
+ *                  It will be necessary to consult the reference documents and associated schematics to understand
+ *                  the operations of this firmware.
+ *                  In DECIMAL math mode (CalSettings.DecimalMath) add, subtract, multiply, divide and square root
+ *                  of BASE 10 are done in decimal as on the HP-15C: a 13 digit packed BCD mantissa and a 3 digit
+ *                  exponent.  Digits are worked 16 at a time in a 64 bit word (SWAR nibble add and subtract) so
+ *                  an add is a handful of integer ops.  Every operation keeps 2 guard digits and truncates -
+ *                  the truncation is exact (a floor) so the round half up to 13 digits is always correct.
+ *                  0.1 + 0.2 is 0.3 and 1/3 x 3 is 0.9999999999999, as on the 15C.
+ *                  The stack still holds doubles: operands are taken to 13 digits on the way in and the result
+ *                  comes back as the double nearest the decimal answer.  The transcendental functions are
+ *                  evaluated by the math kernel and the result rounded to 13 digits (call_DecimalRound) in
+ *                  call_ChkAndDisplayDrop / Raise - so 10^2 is 100 and sin 30 is 0.5, not the binary neighbours.
+ *****************************************************************/
+
+#include "DECIMAL_FUNCTIONS.H"
+#include "CORE_FUNCTIONS.H"
+#include "MATH_FUNCTIONS.H"
+#include "TIMERS_HC15C.H"
+#include "DIP204.H"
+#include "lpc_types.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+
+// GLOBAL VARS
+// TYPES
+// EXACT POWERS OF 10 - 10^22 IS THE LARGEST EXACT IN A DOUBLE
+#define EXACT_POWER_OF_10_MAX   22
+#define EXACT_INTEGER_MAX       9007199254740992ULL   // 2^53 - EVERY INTEGER TO IT IS EXACT IN A DOUBLE
+static const double PowerOf10[EXACT_POWER_OF_10_MAX + 1] =
+  {
+  1.0E0,  1.0E1,  1.0E2,  1.0E3,  1.0E4,  1.0E5,  1.0E6,  1.0E7,  1.0E8,  1.0E9,  1.0E10, 1.0E11,
+  1.0E12, 1.0E13, 1.0E14, 1.0E15, 1.0E16, 1.0E17, 1.0E18, 1.0E19, 1.0E20, 1.0E21, 1.0E22
+  };
+static const uint8_t BenchName[DECIMAL_OPERATION_TOTAL][4] = {"ADD", "SUB", "MUL", "DIV", "SQR"};
+
+// EXTERN VARS
+extern Type_CalSettings CalSettings;
+
+// PROTOTYPES LOCAL
+static uint64_t call_BCDAdd(uint64_t, uint64_t);
+static uint64_t call_BCDSubtract(uint64_t, uint64_t);
+static uint64_t call_BCDFromBinary(uint64_t);
+static uint64_t call_BCDToBinary(uint64_t);
+static double call_DecimalScale(double, int16_t);
+static void call_DecimalPack(uint64_t, int16_t, BOOLEAN, Type_Decimal *);
+static BOOLEAN call_DecimalBenchCall(uint8_t, const Type_Decimal *, const Type_Decimal *, Type_Decimal *);
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BCDAdd
+ * Parameters: uint64_t, uint64_t
+ * Return: uint64_t
+ *
+ * Description: Adds 2 packed BCD words of 16 digits.  The sum must fit in 16 digits.
+ * Each digit is biased by 6 so a decimal carry is a binary carry out of the nibble, one
+ * binary add does all 16 digits, then the 6 is taken back out of every digit that did not carry.
+ * STEP 1: Bias and add
+ * STEP 2: Find the digits that did not carry and remove their bias
+ *************************************************************************/
+ static uint64_t call_BCDAdd(uint64_t BCD_A, uint64_t BCD_B)
+ {
+
+ uint64_t Biased,
+          Sum,
+          NoCarry;
+
+ // STEP 1
+ Biased = BCD_A + BCD_SIX_EACH_DIGIT;
+ Sum = Biased + BCD_B;
+
+ // STEP 2
+ // CARRY INTO EACH BIT IS (A ^ B ^ SUM) - BIT 0 OF A NIBBLE IS THE CARRY OUT OF THE NIBBLE BELOW
+ // THE TOP DIGIT NEVER CARRIES OUT SO ITS BIAS ALWAYS COMES OUT
+ NoCarry = ~(Sum ^ Biased ^ BCD_B) & BCD_CARRY_MASK;
+ return(Sum - ((NoCarry >> 2) | (NoCarry >> 3)) - BCD_TOP_DIGIT_SIX);
+
+ } // END OF call_BCDAdd
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BCDSubtract
+ * Parameters: uint64_t, uint64_t
+ * Return: uint64_t
+ *
+ * Description: Subtracts packed BCD word B from A - A must not be less than B.  One binary
+ * subtract does all 16 digits, a digit that borrowed is left 6 too large (16 for 10) and is corrected.
+ * STEP 1: Subtract
+ * STEP 2: Find the digits that borrowed and correct them
+ *************************************************************************/
+ static uint64_t call_BCDSubtract(uint64_t BCD_A, uint64_t BCD_B)
+ {
+
+ uint64_t Difference,
+          Borrow;
+
+ // STEP 1
+ Difference = BCD_A - BCD_B;
+
+ // STEP 2
+ Borrow = (BCD_A ^ BCD_B ^ Difference) & BCD_CARRY_MASK;
+ return(Difference - ((Borrow >> 2) | (Borrow >> 3)));
+
+ } // END OF call_BCDSubtract
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BCDFromBinary
+ * Parameters: uint64_t
+ * Return: uint64_t
+ *
+ * Description: Binary to packed BCD of up to 13 digits.  The 64 bit divide is a library
+ * call so it is done once - the two halves of 6 and 7 digits are then converted in 32 bits.
+ * STEP 1: Split in two
+ * STEP 2: Pack each half
+ *************************************************************************/
+ static uint64_t call_BCDFromBinary(uint64_t Binary)
+ {
+
+ uint32_t High,
+          Low;
+ uint64_t BCD = 0;
+
+ // STEP 1
+ High = (uint32_t)(Binary / 10000000ULL);
+ Low = (uint32_t)(Binary - ((uint64_t)High * 10000000ULL));
+
+ // STEP 2
+ for (uint8_t Digit = 0; Digit < 7; Digit++)
+   {
+   BCD |= ((uint64_t)(Low % 10) << (Digit * BITS_PER_BCD_DIGIT));
+   Low /= 10;
+   }
+ for (uint8_t Digit = 7; Digit < DECIMAL_DIGITS; Digit++)
+   {
+   BCD |= ((uint64_t)(High % 10) << (Digit * BITS_PER_BCD_DIGIT));
+   High /= 10;
+   }
+
+ return(BCD);
+
+ } // END OF call_BCDFromBinary
+
+
+
+
+/*************************************************************************
+ * Function Name: call_BCDToBinary
+ * Parameters: uint64_t
+ * Return: uint64_t
+ *
+ * Description: Packed BCD of up to 13 digits to binary.  As call_BCDFromBinary the work is
+ * done in two 32 bit halves and joined with one multiply.
+ * STEP 1: Unpack each half most significant digit first
+ * STEP 2: Join
+ *************************************************************************/
+ static uint64_t call_BCDToBinary(uint64_t BCD)
+ {
+
+ uint32_t High = 0,
+          Low = 0;
+
+ // STEP 1
+ for (int8_t Digit = (DECIMAL_DIGITS - 1); Digit >= 7; Digit--)
+   High = (High * 10) + (uint32_t)((BCD >> (Digit * BITS_PER_BCD_DIGIT)) & BCD_DIGIT_MASK);
+ for (int8_t Digit = 6; Digit >= 0; Digit--)
+   Low = (Low * 10) + (uint32_t)((BCD >> (Digit * BITS_PER_BCD_DIGIT)) & BCD_DIGIT_MASK);
+
+ // STEP 2
+ return(((uint64_t)High * 10000000ULL) + Low);
+
+ } // END OF call_BCDToBinary
+
+
+
+
+/*************************************************************************
+ * Function Name: call_DecimalScale
+ * Parameters: double, int16_t
+ * Return: double
+ *
+ * Description: Returns Value x 10^Power.  Within +/-22 this is one multiply or divide by an
+ * exact power of 10 so it is correctly rounded.  Outside that it steps by up to 10^22 and each
+ * step rounds - a few ULP, well under the 13 digits call_DecimalFromDouble keeps.
+ * STEP 1: Step large powers
+ * STEP 2: Scale by the exact power
+ *************************************************************************/
+ static double call_DecimalScale(double Value, int16_t Power)
+ {
+
+ int16_t Step;
+
+ // STEP 1
+ while (Power > EXACT_POWER_OF_10_MAX)
+   {
+   Step = Power - EXACT_POWER_OF_10_MAX;
+   if (Step > EXACT_POWER_OF_10_MAX)
+     Step = EXACT_POWER_OF_10_MAX;
+   Value *= PowerOf10[Step];
+   Power -= Step;
+   }
+ while (Power < -EXACT_POWER_OF_10_MAX)
+   {
+   Value /= PowerOf10[EXACT_POWER_OF_10_MAX];
+   Power += EXACT_POWER_OF_10_MAX;
+   }
+
+ // STEP 2
+ if (Power >= 0)
+   return(Value * PowerOf10[Power]);
+ else
+   return(Value / PowerOf10[-Power]);
+
+ } // END OF call_DecimalScale
+
+
+
+
+/*************************************************************************
+ * Function Name: call_DecimalPack
+ * Parameters: uint64_t, int16_t, BOOLEAN, Type_Decimal *
+ * Return: void
+ *
+ * Description: Builds a decimal result from a working value.  The working value is 15 digits
+ * (13 + 2 guard) with the units digit in nibble 14: value = Work / 10^14 x 10^Exponent.  Nibble
+ * 15 may hold a carry.  The working value must be the exact result truncated (a floor) so the
+ * first guard digit decides the round half up.  An exponent past 999 saturates to
+ * 9.999999999999E999 (a double overflow - the caller sees infinity), below -999 the result is 0.
+ * STEP 1: Zero
+ * STEP 2: Normalize so the units digit is not 0
+ * STEP 3: Round to 13 digits
+ * STEP 4: Range of the exponent
+ *************************************************************************/
+ static void call_DecimalPack(uint64_t Work, int16_t Exponent, BOOLEAN Negative, Type_Decimal *Result)
+ {
+
+ BOOLEAN RoundUp;
+
+ // STEP 1
+ if (Work == 0)
+   {
+   Result->Mantissa = 0;
+   Result->Exponent = 0;
+   Result->Negative = FALSE;
+   return;
+   }
+
+ // STEP 2
+ if ((Work >> (DECIMAL_WORK_DIGITS * BITS_PER_BCD_DIGIT)) != 0)
+   {
+   Work >>= BITS_PER_BCD_DIGIT;
+   Exponent++;
+   }
+ while ((Work >> ((DECIMAL_WORK_DIGITS - 1) * BITS_PER_BCD_DIGIT)) == 0)
+   {
+   Work <<= BITS_PER_BCD_DIGIT;
+   Exponent--;
+   }
+
+ // STEP 3
+ RoundUp = (((Work >> BITS_PER_BCD_DIGIT) & BCD_DIGIT_MASK) >= 5);
+ Work >>= (DECIMAL_GUARD_DIGITS * BITS_PER_BCD_DIGIT);
+ if (RoundUp)
+   {
+   Work = call_BCDAdd(Work, 1);
+   // 9.999999999999 ROUNDED TO 10.00000000000
+   if ((Work >> (DECIMAL_DIGITS * BITS_PER_BCD_DIGIT)) != 0)
+     {
+     Work >>= BITS_PER_BCD_DIGIT;
+     Exponent++;
+     }
+   }
+
+ // STEP 4
+ if (Exponent > DECIMAL_MAX_EXPONENT)
+   {
+   Work = 0x9999999999999ULL;
+   Exponent = DECIMAL_MAX_EXPONENT;
+   }
+ if (Exponent < -DECIMAL_MAX_EXPONENT)
+   {
+   Work = 0;
+   Exponent = 0;
+   Negative = FALSE;
+   }
+ Result->Mantissa = Work;
+ Result->Exponent = Exponent;
+ Result->Negative = Negative;
+
+ } // END OF call_DecimalPack
+
+
+
+
+/*************************************************************************
+ * Function Name: call_DecimalFromDouble
+ * Parameters: double, Type_Decimal *
+ * Return: void
+ *
+ * Description: Rounds a double to 13 significant decimal digits.  The double is scaled so
+ * its 13 digits are the integer part and rounded to the nearest integer - a keyed number of 10
+ * digits or less comes back exactly as keyed.  The value must be finite.
+ * STEP 1: Zero and sign
+ * STEP 2: Decimal exponent - log10 can be 1 off near a power of 10 so check the integer
+ * STEP 3: Pack
+ *************************************************************************/
+ void call_DecimalFromDouble(double Value, Type_Decimal *Result)
+ {
+
+ int16_t Exponent;
+ uint64_t Integer;
+
+ // STEP 1
+ Result->Mantissa = 0;
+ Result->Exponent = 0;
+ Result->Negative = FALSE;
+ if (Value == 0)
+   return;
+ if (Value < 0)
+   {
+   Result->Negative = TRUE;
+   Value = -Value;
+   }
+
+ // STEP 2
+ Exponent = (int16_t)floor(log10(Value));
+ Integer = (uint64_t)(call_DecimalScale(Value, (DECIMAL_DIGITS - 1) - Exponent) + 0.5);
+ if (Integer >= 10000000000000ULL)
+   {
+   Exponent++;
+   Integer = (uint64_t)(call_DecimalScale(Value, (DECIMAL_DIGITS - 1) - Exponent) + 0.5);
+   }
+ else if (Integer < 1000000000000ULL)
+   {
+   Exponent--;
+   Integer = (uint64_t)(call_DecimalScale(Value, (DECIMAL_DIGITS - 1) - Exponent) + 0.5);
+   }
+ // 9.9999999999996 ROUNDED TO 10.000000000000
+ if (Integer >= 10000000000000ULL)
+   {
+   Exponent++;
+   Integer = 1000000000000ULL;
+   }
+
+ // STEP 3
+ Result->Mantissa = call_BCDFromBinary(Integer);
+ Result->Exponent = Exponent;
+
+ } // END OF call_DecimalFromDouble
+
+
+
+
+/*************************************************************************
+ * Function Name: call_DecimalToDouble
+ * Parameters: const Type_Decimal *
+ * Return: double
+ *
+ * Description: Returns the double nearest the decimal number.  The 13 digits are an exact
+ * integer in a double and are scaled by one exact power of 10 - so 0.3 comes back as the same
+ * double as the constant 0.3.  Trailing 0 digits are dropped first (a nibble shift) so a short
+ * number stays in the range of one exact power: 1E-12 is 1 / 10^12 and not 10^12 / 10^24.  A
+ * power past 10^22 is taken into the integer while it stays exact (1E30 is 10^8 x 10^22).  Past
+ * that 2 roundings could give the wrong neighbour, so the digits go to strtod - as a keyed number.
+ * STEP 1: Zero
+ * STEP 2: Drop trailing 0 digits
+ * STEP 3: Integer of the digits - move a power past 10^22 into it while exact
+ * STEP 4: Scaled by one exact power of 10, or the text of the digits to strtod
+ *************************************************************************/
+ double call_DecimalToDouble(const Type_Decimal *Value)
+ {
+
+ uint64_t Digits,
+          Integer;
+ int16_t Power;
+ double Answer;
+ uint8_t Text[DECIMAL_DIGITS + 9];  // D.DDDDDDDDDDDDE-32768
+
+ // STEP 1
+ if (Value->Mantissa == 0)
+   return(0);
+
+ // STEP 2
+ Digits = Value->Mantissa;
+ Power = Value->Exponent - (DECIMAL_DIGITS - 1);
+ while ((Digits & BCD_DIGIT_MASK) == 0)
+   {
+   Digits >>= BITS_PER_BCD_DIGIT;
+   Power++;
+   }
+
+ // STEP 3
+ Integer = call_BCDToBinary(Digits);
+ while ((Power > EXACT_POWER_OF_10_MAX) && (Integer <= (EXACT_INTEGER_MAX / 10)))
+   {
+   Integer *= 10;
+   Power--;
+   }
+
+ // STEP 4
+ if ((Power >= -EXACT_POWER_OF_10_MAX) && (Power <= EXACT_POWER_OF_10_MAX))
+   Answer = (Power >= 0) ? ((double)Integer * PowerOf10[Power]) : ((double)Integer / PowerOf10[-Power]);
+ else
+   {
+   // D.DDDDDDDDDDDDE<EXPONENT>
+   Text[0] = '0' + (uint8_t)((Value->Mantissa >> ((DECIMAL_DIGITS - 1) * BITS_PER_BCD_DIGIT)) & BCD_DIGIT_MASK);
+   Text[1] = '.';
+   for (int8_t Digit = (DECIMAL_DIGITS - 2); Digit >= 0; Digit--)
+     Text[DECIMAL_DIGITS - Digit] = '0' + (uint8_t)((Value->Mantissa >> (Digit * BITS_PER_BCD_DIGIT)) & BCD_DIGIT_MASK);
+   sprintf((char *)&Text[DECIMAL_DIGITS + 1], "E%d", Value->Exponent);
+   Answer = strtod((const char *)Text, NULL);
+   }
+ return(Value->Negative ? -Answer : Answer);
+
+ } // END OF call_DecimalToDouble
+
+
+
+
+/*************************************************************************
+ * Function Name: call_DecimalRound
+ * Parameters: double
+ * Return: double
+ *
+ * Description: Rounds a double to 13 significant digits - the double nearest the 13 digit
+ * decimal.  Used on every result in DECIMAL math mode so the functions not done in BCD
+ * (the transcendentals) give the 15C answer and not the binary neighbour of it.
+ * STEP 1: Pass infinity, NAN and 0
+ * STEP 2: To decimal and back
+ *************************************************************************/
+ double call_DecimalRound(double Value)
+ {
+
+ Type_Decimal Decimal;
+
+ // STEP 1
+ if (isinf(Value) || isnan(Value) || (Value == 0))
+   return(Value);
+
+ // STEP 2
+ call_DecimalFromDouble(Value, &Decimal);
+ return(call_DecimalToDouble(&Decimal));
+
+ } // END OF call_DecimalRound
+
+
+
+
+/*************************************************************************
+ * Function Name: call_DecimalAdd
+ * Parameters: const Type_Decimal *, const Type_Decimal *, Type_Decimal *
+ * Return: void
+ *
+ * Description: Result = A + B.  The smaller magnitude is aligned to the larger and digits
+ * shifted past the 2 guard digits are dropped.  On a subtract of magnitudes a dropped non zero
+ * digit takes 1 more off the last guard digit so the working result is still the exact floor.
+ * STEP 1: A zero operand
+ * STEP 2: Order by magnitude
+ * STEP 3: Align the smaller
+ * STEP 4: Add or subtract the magnitudes and pack
+ *************************************************************************/
+ void call_DecimalAdd(const Type_Decimal *A, const Type_Decimal *B, Type_Decimal *Result)
+ {
+
+ const Type_Decimal *Large,
+                    *Small;
+ uint64_t WorkLarge,
+          WorkSmall;
+ int16_t Shift;
+ BOOLEAN Dropped = FALSE;
+
+ // STEP 1
+ if (B->Mantissa == 0)
+   {
+   *Result = *A;
+   return;
+   }
+ if (A->Mantissa == 0)
+   {
+   *Result = *B;
+   return;
+   }
+
+ // STEP 2
+ if ((A->Exponent > B->Exponent) || ((A->Exponent == B->Exponent) && (A->Mantissa >= B->Mantissa)))
+   {
+   Large = A;
+   Small = B;
+   }
+ else
+   {
+   Large = B;
+   Small = A;
+   }
+
+ // STEP 3
+ WorkLarge = Large->Mantissa << (DECIMAL_GUARD_DIGITS * BITS_PER_BCD_DIGIT);
+ WorkSmall = Small->Mantissa << (DECIMAL_GUARD_DIGITS * BITS_PER_BCD_DIGIT);
+ Shift = Large->Exponent - Small->Exponent;
+ if (Shift >= DECIMAL_WORK_DIGITS)
+   {
+   WorkSmall = 0;
+   Dropped = TRUE;
+   }
+ else if (Shift > 0)
+   {
+   Dropped = ((WorkSmall & ((1ULL << (Shift * BITS_PER_BCD_DIGIT)) - 1)) != 0);
+   WorkSmall >>= (Shift * BITS_PER_BCD_DIGIT);
+   }
+
+ // STEP 4
+ if (Large->Negative == Small->Negative)
+   WorkLarge = call_BCDAdd(WorkLarge, WorkSmall);
+ else
+   {
+   if (Dropped)
+     WorkSmall = call_BCDAdd(WorkSmall, 1);
+   WorkLarge = call_BCDSubtract(WorkLarge, WorkSmall);
+   }
+ call_DecimalPack(WorkLarge, Large->Exponent, Large->Negative, Result);
+
+ } // END OF call_DecimalAdd
+
+
+
+
+/*************************************************************************
+ * Function Name: call_DecimalSubtract
+ * Parameters: const Type_Decimal *, const Type_Decimal *, Type_Decimal *
+ * Return: void
+ *
+ * Description: Result = A - B.  Add of -B
+ * STEP 1: Change the sign of B and add
+ *************************************************************************/
+ void call_DecimalSubtract(const Type_Decimal *A, const Type_Decimal *B, Type_Decimal *Result)
+ {
+
+ Type_Decimal NegativeB = *B;
+
+ // STEP 1
+ NegativeB.Negative = !B->Negative;
+ call_DecimalAdd(A, &NegativeB, Result);
+
+ } // END OF call_DecimalSubtract
+
+
+
+
+/*************************************************************************
+ * Function Name: call_DecimalMultiply
+ * Parameters: const Type_Decimal *, const Type_Decimal *, Type_Decimal *
+ * Return: void
+ *
+ * Description: Result = A x B.  Shift and add from the least significant digit of B: A
+ * (with its guard digits) is added digit times, then the product is shifted one digit right.
+ * A digit once shifted out is never changed by a later add, so the product is the exact floor.
+ * The product is 14 or 15 digits - on 14 the last digit shifted out is put back as the guard.
+ * STEP 1: A zero operand
+ * STEP 2: Shift and add
+ * STEP 3: Normalize and pack
+ *************************************************************************/
+ void call_DecimalMultiply(const Type_Decimal *A, const Type_Decimal *B, Type_Decimal *Result)
+ {
+
+ uint64_t WorkA,
+          Product = 0;
+ uint8_t DigitB,
+         LastDropped = 0;
+ int16_t Exponent;
+
+ // STEP 1
+ if ((A->Mantissa == 0) || (B->Mantissa == 0))
+   {
+   call_DecimalPack(0, 0, FALSE, Result);
+   return;
+   }
+
+ // STEP 2
+ WorkA = A->Mantissa << (DECIMAL_GUARD_DIGITS * BITS_PER_BCD_DIGIT);
+ for (uint8_t Digit = 0; Digit < DECIMAL_DIGITS; Digit++)
+   {
+   DigitB = (uint8_t)((B->Mantissa >> (Digit * BITS_PER_BCD_DIGIT)) & BCD_DIGIT_MASK);
+   while (DigitB--)
+     Product = call_BCDAdd(Product, WorkA);
+   LastDropped = (uint8_t)(Product & BCD_DIGIT_MASK);
+   Product >>= BITS_PER_BCD_DIGIT;
+   }
+
+ // STEP 3
+ Exponent = A->Exponent + B->Exponent + 1;
+ if ((Product >> ((DECIMAL_WORK_DIGITS - 1) * BITS_PER_BCD_DIGIT)) == 0)
+   {
+   Product = (Product << BITS_PER_BCD_DIGIT) | LastDropped;
+   Exponent--;
+   }
+ call_DecimalPack(Product, Exponent, (A->Negative != B->Negative), Result);
+
+ } // END OF call_DecimalMultiply
+
+
+
+
+/*************************************************************************
+ * Function Name: call_DecimalDivide
+ * Parameters: const Type_Decimal *, const Type_Decimal *, Type_Decimal *
+ * Return: void
+ *
+ * Description: Result = A / B.  Restoring long division: each quotient digit is the count
+ * of subtracts of B from the remainder.  15 digits are made so the quotient is the exact floor
+ * with 2 guard digits.  B must not be 0 - the caller checks.
+ * STEP 1: A is zero
+ * STEP 2: Line up so the first quotient digit is not 0
+ * STEP 3: Long division
+ *************************************************************************/
+ void call_DecimalDivide(const Type_Decimal *A, const Type_Decimal *B, Type_Decimal *Result)
+ {
+
+ uint64_t Remainder,
+          Quotient = 0;
+ uint8_t DigitQ;
+ int16_t Exponent;
+
+ // STEP 1
+ if (A->Mantissa == 0)
+   {
+   call_DecimalPack(0, 0, FALSE, Result);
+   return;
+   }
+
+ // STEP 2
+ Remainder = A->Mantissa;
+ Exponent = A->Exponent - B->Exponent;
+ if (Remainder < B->Mantissa)
+   {
+   Remainder <<= BITS_PER_BCD_DIGIT;
+   Exponent--;
+   }
+
+ // STEP 3
+ for (uint8_t Digit = 0; Digit < DECIMAL_WORK_DIGITS; Digit++)
+   {
+   DigitQ = 0;
+   while (Remainder >= B->Mantissa)
+     {
+     Remainder = call_BCDSubtract(Remainder, B->Mantissa);
+     DigitQ++;
+     }
+   Quotient = (Quotient << BITS_PER_BCD_DIGIT) | DigitQ;
+   Remainder <<= BITS_PER_BCD_DIGIT;
+   }
+ call_DecimalPack(Quotient, Exponent, (A->Negative != B->Negative), Result);
+
+ } // END OF call_DecimalDivide
+
+
+
+
+/*************************************************************************
+ * Function Name: call_DecimalSqrt
+ * Parameters: const Type_Decimal *, Type_Decimal *
+ * Return: void
+ *
+ * Description: Result = square root of A.  Digit by digit (the pencil and paper method):
+ * bring down a pair of digits, then subtract the odd numbers 20Y+1, 20Y+3 ... from the
+ * remainder, the count is the next root digit.  14 root digits are made - the exact floor
+ * with 1 guard digit, which is all the round half up needs.  A must not be negative.
+ * STEP 1: A is zero
+ * STEP 2: Pair the digits - an odd exponent takes 2 digits in the first pair
+ * STEP 3: Root digit by digit
+ * STEP 4: Pack
+ *************************************************************************/
+ void call_DecimalSqrt(const Type_Decimal *A, Type_Decimal *Result)
+ {
+
+ uint64_t Source,
+          Remainder = 0,
+          Root = 0,
+          OddNumber;
+ uint8_t DigitRoot;
+ int16_t Exponent;
+
+ // STEP 1
+ if (A->Mantissa == 0)
+   {
+   call_DecimalPack(0, 0, FALSE, Result);
+   return;
+   }
+
+ // STEP 2
+ // DIGITS TO THE TOP OF THE WORD - PAIRS ARE TAKEN FROM THE TOP
+ Source = A->Mantissa << ((16 - DECIMAL_DIGITS) * BITS_PER_BCD_DIGIT);
+ if ((A->Exponent & 0x01) == 0)
+   Source >>= BITS_PER_BCD_DIGIT;
+ Exponent = (A->Exponent - (A->Exponent & 0x01)) / 2;
+
+ // STEP 3
+ for (uint8_t Digit = 0; Digit < (DECIMAL_DIGITS + 1); Digit++)
+   {
+   Remainder = (Remainder << (2 * BITS_PER_BCD_DIGIT)) | (Source >> (14 * BITS_PER_BCD_DIGIT));
+   Source <<= (2 * BITS_PER_BCD_DIGIT);
+   OddNumber = Root << BITS_PER_BCD_DIGIT;
+   OddNumber = call_BCDAdd(call_BCDAdd(OddNumber, OddNumber), 1);
+   DigitRoot = 0;
+   while (Remainder >= OddNumber)
+     {
+     Remainder = call_BCDSubtract(Remainder, OddNumber);
+     OddNumber = call_BCDAdd(OddNumber, 2);
+     DigitRoot++;
+     }
+   Root = (Root << BITS_PER_BCD_DIGIT) | DigitRoot;
+   }
+
+ // STEP 4
+ call_DecimalPack((Root << BITS_PER_BCD_DIGIT), Exponent, FALSE, Result);
+
+ } // END OF call_DecimalSqrt
+
+
+
+
+/*************************************************************************
+ * Function Name: call_DecimalOperation
+ * Parameters: uint8_t, double, double
+ * Return: double
+ *
+ * Description: Stack entry to the decimal engine.  Returns A op B as the double nearest
+ * the 13 digit decimal answer (square root is of A, B is not used).  The operands must be
+ * finite, divide by 0 is checked by the caller.  The square root of a negative returns NAN
+ * from the library so the caller shows the same error as in binary.
+ * STEP 1: Operands to decimal
+ * STEP 2: Operate
+ * STEP 3: Back to double
+ *************************************************************************/
+ double call_DecimalOperation(uint8_t Operation, double A, double B)
+ {
+
+ Type_Decimal DecimalA,
+              DecimalB,
+              DecimalAns;
+
+ // STEP 1
+ if ((Operation == DECIMAL_SQRT) && (A < 0))
+   return(sqrt(A));
+ call_DecimalFromDouble(A, &DecimalA);
+ call_DecimalFromDouble(B, &DecimalB);
+
+ // STEP 2
+ switch(Operation)
+   {
+   default:
+   case DECIMAL_ADD:
+     call_DecimalAdd(&DecimalA, &DecimalB, &DecimalAns);
+   break;
+
+   case DECIMAL_SUBTRACT:
+     call_DecimalSubtract(&DecimalA, &DecimalB, &DecimalAns);
+   break;
+
+   case DECIMAL_MULTIPLY:
+     call_DecimalMultiply(&DecimalA, &DecimalB, &DecimalAns);
+   break;
+
+   case DECIMAL_DIVIDE:
+     call_DecimalDivide(&DecimalA, &DecimalB, &DecimalAns);
+   break;
+
+   case DECIMAL_SQRT:
+     call_DecimalSqrt(&DecimalA, &DecimalAns);
+   break;
+   }
+
+ // STEP 3
+ return(call_DecimalToDouble(&DecimalAns));
+
+ } // END OF call_DecimalOperation
+
+
+
+
+/*************************************************************************
+ * Function Name: call_DecimalMode
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Toggles BASE 10 math between DECIMAL (BCD) and BINARY (double).  The
+ * stack is not changed.  A message of the new mode is shown on the top line until the next key.
+ * STEP 1: Toggle
+ * STEP 2: Display
+ *************************************************************************/
+ void call_DecimalMode(void)
+ {
+
+ uint8_t LineText[MAX_DISPLAY_LENGTH + 1];
+
+ // STEP 1
+ CalSettings.DecimalMath = !CalSettings.DecimalMath;
+
+ // STEP 2
+ call_FormatNumber();
+ //                      01234567890123456789
+ sprintf((char *)LineText, "%s", (CalSettings.DecimalMath ? "DECIMAL MATH 13 DIG" : "BINARY MATH DOUBLE"));
+ DIP204_clearLine(1);
+ DIP204_txt_engine(LineText, 1, 0, strlen((const char *)LineText));
+
+ } // END OF call_DecimalMode
+
+
+
+
+/*************************************************************************
+ * Function Name: call_DecimalBenchCall
+ * Parameters: uint8_t, const Type_Decimal *, const Type_Decimal *, Type_Decimal *
+ * Return: BOOLEAN
+ *
+ * Description: Calls one decimal operation for the benchmark.  Returns TRUE so the call
+ * can not be removed by the compiler.
+ * STEP 1: Operate
+ *************************************************************************/
+ static BOOLEAN call_DecimalBenchCall(uint8_t Operation, const Type_Decimal *A, const Type_Decimal *B, Type_Decimal *Answer)
+ {
+
+ // STEP 1
+ if (Operation == DECIMAL_ADD)
+   call_DecimalAdd(A, B, Answer);
+ else if (Operation == DECIMAL_SUBTRACT)
+   call_DecimalSubtract(A, B, Answer);
+ else if (Operation == DECIMAL_MULTIPLY)
+   call_DecimalMultiply(A, B, Answer);
+ else if (Operation == DECIMAL_DIVIDE)
+   call_DecimalDivide(A, B, Answer);
+ else
+   call_DecimalSqrt(A, Answer);
+
+ return(Answer->Mantissa != 0);
+
+ } // END OF call_DecimalBenchCall
+
+
+
+
+/*************************************************************************
+ * Function Name: call_DecimalBenchmark
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Measures the cost per operation of the BCD engine against the double (soft
+ * float) math.  As call_IntBenchmark each operation is timed on the DWT cycle counter in
+ * batches, the loop overhead is removed and the fastest batch is kept.  The operands are full
+ * 13 digit numbers - the BCD multiply and divide cost grows with the digits.  Subtract is
+ * the same cost as add and is not shown.  Results are CPU cycles per operation, F for double
+ * and B for BCD, until the next key:
+ * ADD F:xxxxx B:xxxxx
+ * MUL F:xxxxx B:xxxxx
+ * DIV F:xxxxx B:xxxxx
+ * SQR F:xxxxx B:xxxxx
+ * NOTE: The stack and settings are not changed
+ * STEP 1: Operands and the loop overhead
+ * STEP 2: Time each operation on double and on BCD
+ * STEP 3: Display
+ *************************************************************************/
+ void call_DecimalBenchmark(void)
+ {
+
+ static const uint8_t Operations[] = {DECIMAL_ADD, DECIMAL_MULTIPLY, DECIMAL_DIVIDE, DECIMAL_SQRT};
+ volatile double DoubleA = 1234567.891234,
+                 DoubleB = 3.217654321987,
+                 DoubleAns;
+ Type_Decimal DecimalA,
+              DecimalB,
+              DecimalAns;
+ uint32_t StartCount,
+          BatchCycles,
+          OverheadDouble = 0xFFFFFFFF,
+          OverheadDecimal = 0xFFFFFFFF,
+          CyclesDouble[4] = {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+          CyclesDecimal[4] = {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF};
+ uint8_t Operation,
+         Completed = 0,
+         LineText[MAX_DISPLAY_LENGTH + 1];
+
+ // STEP 1
+ call_DecimalFromDouble(DoubleA, &DecimalA);
+ call_DecimalFromDouble(DoubleB, &DecimalB);
+ init_CycleCounter();
+ for (uint8_t Batch = 0; Batch < DECIMAL_BENCH_BATCHES; Batch++)
+   {
+   StartCount = CYCLE_COUNT;
+   for (uint8_t Count = 0; Count < DECIMAL_BENCH_BATCH; Count++)
+     DoubleAns = DoubleA;
+   BatchCycles = CYCLE_COUNT - StartCount;
+   if (BatchCycles < OverheadDouble)
+     OverheadDouble = BatchCycles;
+   StartCount = CYCLE_COUNT;
+   for (uint8_t Count = 0; Count < DECIMAL_BENCH_BATCH; Count++)
+     Completed += (DecimalA.Mantissa != 0);
+   BatchCycles = CYCLE_COUNT - StartCount;
+   if (BatchCycles < OverheadDecimal)
+     OverheadDecimal = BatchCycles;
+   }
+
+ // STEP 2
+ for (uint8_t Batch = 0; Batch < DECIMAL_BENCH_BATCHES; Batch++)
+   {
+   for (uint8_t Index = 0; Index < 4; Index++)
+     {
+     Operation = Operations[Index];
+     StartCount = CYCLE_COUNT;
+     for (uint8_t Count = 0; Count < DECIMAL_BENCH_BATCH; Count++)
+       {
+       if (Operation == DECIMAL_ADD)
+         DoubleAns = DoubleA + DoubleB;
+       else if (Operation == DECIMAL_MULTIPLY)
+         DoubleAns = DoubleA * DoubleB;
+       else if (Operation == DECIMAL_DIVIDE)
+         DoubleAns = DoubleA / DoubleB;
+       else
+         DoubleAns = sqrt(DoubleA);
+       }
+     BatchCycles = CYCLE_COUNT - StartCount;
+     if (BatchCycles < CyclesDouble[Index])
+       CyclesDouble[Index] = BatchCycles;
+
+     StartCount = CYCLE_COUNT;
+     for (uint8_t Count = 0; Count < DECIMAL_BENCH_BATCH; Count++)
+       Completed += call_DecimalBenchCall(Operation, &DecimalA, &DecimalB, &DecimalAns);
+     BatchCycles = CYCLE_COUNT - StartCount;
+     if (BatchCycles < CyclesDecimal[Index])
+       CyclesDecimal[Index] = BatchCycles;
+     }
+   }
+
+ // STEP 3
+ (void)DoubleAns;   // A SINK ONLY - VOLATILE SO THE TIMED DOUBLE MATH IS NOT REMOVED
+ DIP204_set_cursor(CURSOR_OFF);
+ DIP204_clearDisplay();
+ for (uint8_t Index = 0; Index < 4; Index++)
+   {
+   CyclesDouble[Index] = (CyclesDouble[Index] > OverheadDouble) ? (CyclesDouble[Index] - OverheadDouble) : 0;
+   CyclesDecimal[Index] = (CyclesDecimal[Index] > OverheadDecimal) ? (CyclesDecimal[Index] - OverheadDecimal) : 0;
+   CyclesDouble[Index] = MIN((CyclesDouble[Index] / DECIMAL_BENCH_BATCH), DECIMAL_BENCH_SHOWN_MAX);
+   CyclesDecimal[Index] = MIN((CyclesDecimal[Index] / DECIMAL_BENCH_BATCH), DECIMAL_BENCH_SHOWN_MAX);
+   //                      01234567890123456789
+   snprintf((char *)LineText, sizeof(LineText), "%s F:%5lu B:%5lu", BenchName[Operations[Index]],
+            CyclesDouble[Index], CyclesDecimal[Index]);
+   DIP204_txt_engine(LineText, (Index + 1), 0, strlen((const char *)LineText));
+   }
+
+ } // END OF call_DecimalBenchmark
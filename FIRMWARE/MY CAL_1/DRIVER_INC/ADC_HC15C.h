@@ -4,7 +4,7 @@
  * Description:     Project definitions and function prototypes for use with ADC_HC15C.c
  * Author:          Hab S. Collector
  * Date:            11/12/2011
- * LAST EDIT:       7/04/2012
+ * LAST EDIT:       10/19/2026
  * Hardware:               
  * Firmware Tool:   CrossStudio for ARM
  * Notes:           This file should be written as to not be dependent 
@@ -53,9 +53,54 @@
 #define ADC_BAT_DIVIDER   (R39/(R37+R39))
 
 // ADC PARAMETERS CONVERSION RATE
-#define ADC_CONVERSION_RATE 100000
-#define ADC_AVG_WEIGHT      10
-#define ADC_SAMPLE_RATE     3
+// BACKGROUND SCAN: TIMER 0 MR1 PACES THE CONVERSIONS - EACH MATCH REQUESTS A GPDMA WRITE OF ADCR THAT STARTS ONE
+// CONVERSION OF THE NEXT CHANNEL IN THE SCAN ORDER.  A SECOND GPDMA CHANNEL MOVES EACH RESULT TO A RING OF TWO HALVES
+// AND THE DMA IRQ FILTERS A HALF WHILE THE OTHER FILLS.  NO CPU PER CONVERSION
+#define ADC_SCAN_RATE       10000             // CONVERSIONS PER SECOND: ONE EACH 100us TIMER 0 PERIOD
+#define ADC_TRIGGER_MATCH   50                // us INTO THE TIMER 0 PERIOD - ANY VALUE BELOW THE PERIOD
+#define ADC_CONVERSION_RATE 200000            // ADC CLOCK FOR A 5us CONVERSION - DONE WELL BEFORE THE NEXT MATCH
+#define ADC_SCAN_CHANNELS   3                 // ADC_BAT_VOLTAGE TO ADC_USB_VOLTAGE - AD0.0 TO AD0.2
+#define ADC_SCAN_SLOTS      4                 // SCAN ORDER MET BAT MET USB: THE METER AT 5kHz, BATTERY AND USB AT 2.5kHz
+#define ADC_SCAN_BLOCK      48                // CONVERSIONS PER HALF OF THE DMA RING: 4.8ms - WHOLE SCAN ORDERS
+#define ADC_SCAN_SETTLE     10                // ms BETWEEN CHECKS FOR A FULL FILTER
+#define ADC_RING_LENGTH     32                // MOST DECIMATED VALUES IN THE MOVING AVERAGE
+#define ADC_MAX_DECIMATION  1024              // 4095 x 1024 x ADC_RING_LENGTH FITS 32 BITS
+#define ADC_PROBE_SAMPLES   8                 // MOST RECENT SAMPLES OF A CHANNEL IN ITS PROBE VALUE: 1.6ms
+// DEFAULT FILTER - BATTERY AND USB: 10ms DECIMATED VALUES, 200ms MOVING AVERAGE
+#define ADC_DEFAULT_DECIMATION  25
+#define ADC_DEFAULT_LENGTH      20
+#define ADC_DMA_CHANNEL     0                 // GPDMA CHANNEL OF THE ADC - HIGHEST PRIORITY CHANNEL
+#define ADC_DMA_REQUEST     4                 // GPDMA PERIPHERAL NUMBER OF THE ADC
+#define ADC_PACE_DMA_CHANNEL  1               // GPDMA CHANNEL THAT WRITES ADCR ON THE MATCH
+#define ADC_PACE_DMA_REQUEST  9               // GPDMA PERIPHERAL NUMBER OF MAT0.1 - WITH ADC_PACE_DMAREQSEL
+#define ADC_PACE_DMAREQSEL    ((uint32_t)(1<<1))  // DMAREQSEL: REQUEST 9 IS MAT0.1, NOT UART0 RX
+// GPDMA CHANNEL CONTROL AND CONFIGURATION BITS
+#define DMA_CONTROL_SWIDTH_WORD   ((uint32_t)(2<<18))
+#define DMA_CONTROL_DWIDTH_WORD   ((uint32_t)(2<<21))
+#define DMA_CONTROL_DI            ((uint32_t)(1<<27))
+#define DMA_CONTROL_I             ((uint32_t)(1UL<<31))
+#define DMA_CONTROL_SIZE_MASK     0x0FFF
+#define DMA_CONFIG_E              ((uint32_t)(1<<0))
+#define DMA_CONFIG_SRC_PERIPHERAL(n)  ((uint32_t)(n)<<1)
+#define DMA_CONFIG_DEST_PERIPHERAL(n) ((uint32_t)(n)<<6)
+#define DMA_CONFIG_M2P            ((uint32_t)(1<<11))
+#define DMA_CONFIG_P2M            ((uint32_t)(2<<11))
+#define DMA_CONFIG_IE             ((uint32_t)(1<<14))
+#define DMA_CONFIG_ITC            ((uint32_t)(1<<15))
+// CAPTURE: THE METER CHANNEL ALONE AT THE MOST THE ADC DOES.  THE GPDMA FILLS A RING A CHUNK AT A TIME - THE
+// RING IS ALL OF AHB SRAM BANK 0 (.ahb_bank0).  ONCE THE PRE-TRIGGER CHUNKS ARE FULL THE DMA IRQ OF EACH CHUNK
+// LOOKS FOR THE TRIGGER, THEN STOPS THE CAPTURE WHEN THE CHUNKS AFTER IT ARE IN.  THE BACKGROUND SCAN IS
+// STOPPED WHILE CAPTURING - init_ADC_Scan STARTS IT AGAIN
+#define ADC_CAPTURE_RATE        200000            // CONVERSIONS PER SECOND ASKED FOR - THE ADC CLOCK DIVIDER SETS WHAT IS MET
+#define ADC_CAPTURE_SAMPLES     4096              // ADGDR WORDS OF THE RING - 16KB: 20ms AT 200kHz
+#define ADC_CAPTURE_CHUNK       512               // SAMPLES PER LINKED LIST ITEM: A DMA IRQ EACH 2.56ms
+#define ADC_CAPTURE_CHUNKS      (ADC_CAPTURE_SAMPLES / ADC_CAPTURE_CHUNK)
+#define ADC_CAPTURE_MAX_PRE     (ADC_CAPTURE_CHUNKS - 2)  // THE CHUNK BEING WRITTEN AT THE STOP AND THE TRIGGER CHUNK
+#define ADC_CAPTURE_HYSTERESIS  16                // ADC COUNTS PAST THE LEVEL THAT ARM THE EDGE
+// RMS: A FORCED CAPTURE AT A LOWER RATE - 4096 SAMPLES ARE 102ms, 5 CYCLES OF THE MAINS AND UP.  THE
+// WINDOW IS THE WHOLE CYCLES BETWEEN THE FIRST AND LAST RISING CROSSING OF THE CAPTURE MEAN
+#define ADC_RMS_RATE            40000             // CONVERSIONS PER SECOND ASKED FOR
+#define ADC_RMS_HYSTERESIS      8                 // ADC COUNTS UNDER THE MEAN THAT ARM A RISING CROSSING
 
 // ENUMERATED TYPES AND STRUCTURES
 enum ADC_HP15C_TYPES
@@ -65,19 +110,101 @@ enum ADC_HP15C_TYPES
      ADC_USB_VOLTAGE
      };
 
+enum ADC_CAPTURE_STATUS
+     {
+     CAPTURE_IDLE,                  // THE BACKGROUND SCAN OR STOPPED
+     CAPTURE_ARMED,                 // FILLING THE PRE-TRIGGER AND LOOKING FOR THE TRIGGER
+     CAPTURE_TRIGGERED,             // FILLING THE CHUNKS AFTER THE TRIGGER
+     CAPTURE_DONE                   // THE RING HOLDS THE CAPTURE - THE ADC AND DMA ARE STOPPED
+     };
+
 // STRUCTURES
 typedef struct
   {
-  uint8_t ADC_Type;                 // SHOULD BE: ADC_BAT_VOLTATE TO ADC_MET_VOLTAGE
-  uint8_t ADC_AvgWeight;            // 0 = NO AVERAGE
-  uint8_t ADC_msTimeBetweenSamples; // Time between samples in the average in ms
+  uint8_t ADC_Type;                 // SHOULD BE: ADC_BAT_VOLTATE TO ADC_USB_VOLTAGE
   double ADC_FrontEndDivider;       // MUST BE GREATER THAN 0
   } ADC_HC15C_Type;
 
+// FILTER OF A SCANNED CHANNEL: A FIRST ORDER CIC (SUM AND DUMP OF Decimation SAMPLES) INTO A RING,
+// THEN A MOVING AVERAGE OF THE LAST Length RING VALUES.  ONLY THE DMA IRQ WRITES IT
+typedef struct
+  {
+  uint16_t Decimation;              // SAMPLES SUMMED PER RING VALUE: 1 TO ADC_MAX_DECIMATION
+  uint8_t Length;                   // RING VALUES AVERAGED: 1 TO ADC_RING_LENGTH
+  uint16_t Count;                   // SAMPLES IN Accumulator
+  uint32_t Accumulator;
+  uint32_t Ring[ADC_RING_LENGTH];   // SUMS OF Decimation SAMPLES
+  uint8_t Head;                     // NEXT RING VALUE TO REPLACE
+  uint8_t Filled;                   // RING VALUES SINCE THE LAST FLUSH - AT MOST Length
+  uint32_t RingSum;                 // SUM OF THE Filled RING VALUES
+  volatile float Filtered;          // LATEST AVERAGE IN ADC COUNTS
+  uint16_t Discard;                 // SAMPLES STILL DROPPED AFTER A FLUSH - THE INPUT SETTLING
+  uint32_t ProbeSum;                // SAMPLES SINCE THE LAST PROBE VALUE
+  uint16_t ProbeCount;
+  volatile float Probe;             // AVERAGE OF AT LEAST ADC_PROBE_SAMPLES FROM THE LAST DMA HALF
+  volatile BOOLEAN ProbeReady;      // A PROBE VALUE SINCE THE LAST FLUSH
+  } ADC_Scan_Type;
+
+// ONE HALF OF THE DMA RING - THE GPDMA LINKED LIST ITEM
+typedef struct
+  {
+  uint32_t SrcAddr;
+  uint32_t DestAddr;
+  uint32_t NextLLI;
+  uint32_t Control;
+  } ADC_DMA_LLI_Type;
+
+
+// A CAPTURE: ONLY THE DMA IRQ WRITES IT WHILE ARMED OR TRIGGERED.  WHEN DONE THE SAMPLES ARE IN TIME ORDER
+// FROM Buffer[First] AROUND THE RING TO Buffer[First - 1]
+typedef struct
+  {
+  volatile uint8_t Status;          // SEE ENUM ADC_CAPTURE_STATUS
+  uint16_t Level;                   // TRIGGER LEVEL IN ADC COUNTS
+  BOOLEAN Rising;                   // TRIGGER ON A RISING (TRUE) OR FALLING EDGE THROUGH Level
+  BOOLEAN Armed;                    // A SAMPLE ADC_CAPTURE_HYSTERESIS BEFORE Level - THE EDGE CAN FOLLOW
+  volatile BOOLEAN Force;           // TRIGGER AT THE START OF THE NEXT CHUNK - AUTO TRIGGER
+  uint8_t PreChunks;                // FULL CHUNKS BEFORE THE TRIGGER: 1 TO ADC_CAPTURE_MAX_PRE
+  uint8_t Next;                     // NEXT CHUNK OF THE RING TO LOOK AT
+  uint16_t Chunks;                  // FULL CHUNKS SINCE THE START
+  uint16_t StopChunk;               // Chunks AT THE STOP
+  uint32_t StartCycles;             // CYCLE_COUNT AT THE FIRST FULL CHUNK
+  uint32_t StopCycles;              // CYCLE_COUNT AT THE LAST FULL CHUNK
+  const volatile uint32_t *Buffer;  // THE RING - ADGDR AS READ
+  uint16_t First;                   // RING INDEX OF THE OLDEST SAMPLE
+  uint16_t Trigger;                 // RING INDEX OF THE TRIGGER SAMPLE
+  uint32_t Rate;                    // SAMPLES PER SECOND MEASURED OVER THE CAPTURE
+  } ADC_Capture_Type;
+
+// RMS OF A CAPTURE IN ADC COUNTS - THE DC (Mean) REMOVED.  Cycles IS 0 WHEN THERE WAS NOT ONE WHOLE
+// CYCLE: THE WINDOW IS THEN THE CAPTURE
+typedef struct
+  {
+  uint16_t Samples;                 // IN THE WINDOW
+  uint16_t Cycles;                  // WHOLE CYCLES IN THE WINDOW
+  uint16_t Low;                     // LOWEST COUNT OF THE CAPTURE
+  uint16_t High;                    // HIGHEST COUNT OF THE CAPTURE - ADC_FULL_COUNT IS CLIPPED
+  float Mean;                       // AVERAGE COUNT OF THE WINDOW
+  float Rms;                        // ROOT MEAN SQUARE ABOUT Mean
+  float Frequency;                  // Hz OF THE WHOLE CYCLES - 0 WITHOUT
+  } ADC_RMS_Type;
+
 
 // PROTOTYPE FUNCITONS
-void init_ADC_polling(void);
+void init_ADC_Scan(void);
+void ADC_ScanStop(void);
+void ADC_ScanConfig(uint8_t, uint16_t, uint8_t);
+void ADC_ScanFlush(uint8_t, uint16_t);
+BOOLEAN ADC_ScanSettled(uint8_t);
+BOOLEAN ADC_ScanProbeReady(uint8_t);
 double ADC_getConvertedValue(ADC_HC15C_Type);
+double ADC_getProbeValue(ADC_HC15C_Type);
+void ADC_CaptureStart(uint32_t, uint16_t, BOOLEAN, uint8_t);
+void ADC_CaptureForce(void);
+uint8_t ADC_CaptureStatus(void);
+const ADC_Capture_Type *ADC_CaptureResult(void);
+void ADC_CaptureRMS(const ADC_Capture_Type *, ADC_RMS_Type *);
+void DMA_IRQHandler(void);
 
 
 #endif
\ No newline at end of file
@@ -36,7 +36,8 @@ enum DIP204_CURSOR
 #define DIP204_RST_DELAY_TIME 5       // TIME IN ms
 #define DISPLAY_LINE_TOTAL    4
 #define DISPLAY_COLUMN_TOTAL  20
-#define WAIT_FOR_DISPLAY      2       // TIME IN ms A NECESSARY WAIT BETWEEN SUCESSIVE DISPLAY FUNCTION CALLS
+#define WAIT_FOR_DISPLAY      2       // TIME IN ms A CLEAR DISPLAY TAKES - 1.53ms IN THE DATA SHEET: THE TASK SLEEPS
+#define WAIT_FOR_COMMAND      50      // TIME IN us ANY OTHER INSTRUCTION TAKES - 39us IN THE DATA SHEET: BUSY WAIT
 
 // ROW COLUMN VALUES
 #define LINE1_START_ADDRESS 0x00
@@ -78,6 +79,13 @@ enum DIP204_CURSOR
   #define MASK_CURSOR_BLINK 0x01
 // DDRAM ADDRESS
 #define CMD_SET_DDR_ADDR    0x80
+// SET CGRAM ADR - REQUIRES RE BIT CLEAR
+#define CMD_SET_CGR_ADDR    0x40   // MASK WITH CHARACTER x 8 + PATTERN ROW
+
+// USER CHARACTERS: CHARACTER CODES 0 TO 7 SHOW THE PATTERN LOADED IN CGRAM
+#define CGRAM_CHARACTERS    8
+#define CGRAM_ROWS          8      // PATTERN ROWS TOP TO BOTTOM
+#define CGRAM_WIDTH         5      // PIXELS OF A ROW - BIT 4 IS THE LEFT
 
 // LCD MISC
 #define LCD_CHAR_WIDTH 20
@@ -128,5 +136,6 @@ void init_PWM_BackLight(void);
 void DIP204_set_cursor(enum DIP204_CURSOR);
 void DIP204_clearDisplay(void);
 void DIP204_DisplayOff(void);
+void DIP204_loadCGRAM(uint8_t, const uint8_t *);
 
 #endif
\ No newline at end of file
@@ -4,7 +4,7 @@
  * Description:     Project definitions and function prototypes for use with ADC_HC15C.c
  * Author:          Hab S. Collector
  * Date:            11/12/2011
- * LAST EDIT:       7/21/2012 
+ * LAST EDIT:       10/19/2026
  * Hardware:               
  * Firmware Tool:   CrossStudio for ARM
  * Notes:           This file should be written as to not be dependent 
@@ -14,36 +14,69 @@
  
  // INCLUDES
 #include "ADC_HC15C.H"
+#include "TIMERS_HC15C.H"
 #include "lpc17xx_adc.h"
 #include "lpc17xx_pinsel.h"
 #include "lpc17xx_gpio.h"
+#include "lpc17xx_clkpwr.h"
+#include "lpc17xx_timer.h"
 #include <ctl_api.h>
+#include <string.h>
 
 // GLOBAL VARS
+static volatile uint32_t ADC_Raw[2][ADC_SCAN_BLOCK];    // GPDMA DESTINATION - ADGDR AS READ, A HALF AT A TIME
+static ADC_DMA_LLI_Type ADC_LLI[2];                     // EACH HALF LINKS TO THE OTHER
+static const uint8_t ADC_ScanOrder[ADC_SCAN_SLOTS] = {ADC_MET_VOLTAGE, ADC_BAT_VOLTAGE, ADC_MET_VOLTAGE, ADC_USB_VOLTAGE};
+static uint32_t ADC_ScanControl[ADC_SCAN_SLOTS];        // ADCR OF EACH SLOT: ITS CHANNEL, START NOW - THE GPDMA READS RAM
+static ADC_DMA_LLI_Type ADC_PaceLLI[ADC_SCAN_SLOTS];    // ONE WRITE OF ADCR PER MATCH - THE LAST SLOT LINKS TO THE FIRST
+static ADC_Scan_Type ADC_Scan[ADC_SCAN_CHANNELS] =      // FILTERS KEEP THEIR SETTINGS THROUGH SLEEP
+  {
+  {ADC_DEFAULT_DECIMATION, ADC_DEFAULT_LENGTH},
+  {ADC_DEFAULT_DECIMATION, ADC_DEFAULT_LENGTH},
+  {ADC_DEFAULT_DECIMATION, ADC_DEFAULT_LENGTH}
+  };
+static volatile uint32_t ADC_CaptureRing[ADC_CAPTURE_SAMPLES] AHB_BANK0;   // GPDMA DESTINATION OF A CAPTURE
+static ADC_DMA_LLI_Type ADC_CaptureLLI[ADC_CAPTURE_CHUNKS];   // EACH CHUNK LINKS TO THE NEXT, THE LAST TO THE FIRST
+static ADC_Capture_Type ADC_Capture;
 
 
-// EXTERNS
-extern void delayXms(uint32_t);
-extern CTL_MUTEX_t ADC_Mutex;
+// PROTOTYPES LOCAL
+static void ADC_ScanReset(ADC_Scan_Type *);
+static void ADC_ScanDMA_Start(void);
+static void ADC_CaptureIRQ(void);
+static void ADC_CaptureHalt(void);
+static uint32_t ADC_SquareRoot(uint64_t);
 
 
 
 
 /*************************************************************************
- * Function Name: init_ADC_polling
+ * Function Name: init_ADC_Scan
  * Parameters: void
  * Return: void
  *
- * Description: Configures P0.23 and P0.24 for ADC polling (Meter and Vbat channel)
- * Must be used before conversion commands can be called.
- * STEP 1: Configure P0.23 and P0.24 as ADC pins
+ * Description: Configures P0.23, P0.24 and P0.25 for the ADC (Vbat, Meter and Vusb channel) and starts
+ * the background scan.  Timer 0 MR1 paces it at ADC_SCAN_RATE: each match the pace GPDMA channel
+ * writes ADCR with the next slot of ADC_ScanOrder, which starts one conversion of that channel.  The
+ * ADC GPDMA channel moves each result (ADGDR - the channel number is in the word) to ADC_Raw without
+ * a stop: the two halves link to each other.  The DMA IRQ at the end of each half filters it.
+ * Must be used before conversion commands can be called.  Call again after a wake from sleep and
+ * after the last capture (see ADC_CaptureStart).
+ * NOTE: Timer 0 must be running (init_HC15C_OnTimerCounter0) - its MR1 is the conversion pace
+ * STEP 1: Configure P0.23, P0.24 and P0.25 as ADC pins
  * STEP 2: Configure ADC Meter range and control pins as outputs and set default conditions 
- * STEP 3: Set conversion rate, set for polling (no IRQ), and channels to disable 
+ * STEP 3: Set the conversion clock and the ADCR of each slot.  Only the global done requests DMA -
+ * reading ADGDR clears it
+ * STEP 4: Timer 0 MR1 - no IRQ, no reset, no pin.  Its match is the DMA request of the pace channel:
+ * clear one left from before
+ * STEP 5: Start the filters over (no capture), power the GPDMA and start the ring and the pace
  *************************************************************************/
- void init_ADC_polling(void)
+ void init_ADC_Scan(void)
   {
  
   PINSEL_CFG_Type PINSEL_PinCfgStruct;
+  TIM_MATCHCFG_Type TIM_MatchConfigStruct;
+  uint32_t Control;
  
   // STEP 1
   // FROM TABLE 8.5 USER MANUAL LPC17XX SET UP AS ADC FUNCTION
@@ -68,14 +101,172 @@ extern CTL_MUTEX_t ADC_Mutex;
   
   // STEP 3
   ADC_Init(LPC_ADC, ADC_CONVERSION_RATE);
-  ADC_IntConfig(LPC_ADC,ADC_ADINTEN0,DISABLE);
-  ADC_IntConfig(LPC_ADC,ADC_ADINTEN1,DISABLE);
-  ADC_IntConfig(LPC_ADC,ADC_ADINTEN2,DISABLE);
-  ADC_ChannelCmd(LPC_ADC,ADC_BAT_VOLTAGE,DISABLE);
-  ADC_ChannelCmd(LPC_ADC,ADC_MET_VOLTAGE,DISABLE);
-  ADC_ChannelCmd(LPC_ADC,ADC_USB_VOLTAGE,DISABLE);
+  LPC_ADC->ADINTEN = ADC_INTEN_GLOBAL;
+  Control = LPC_ADC->ADCR & ~(ADC_CR_CH_SEL(0) | ADC_CR_CH_SEL(1) | ADC_CR_CH_SEL(2) | ADC_CR_BURST | ADC_CR_START_MASK | ADC_CR_EDGE);
+  for (uint8_t Slot = 0; Slot < ADC_SCAN_SLOTS; Slot++)
+    ADC_ScanControl[Slot] = Control | ADC_CR_CH_SEL(ADC_ScanOrder[Slot]) | ADC_CR_START_NOW;
+  
+  // STEP 4
+  TIM_MatchConfigStruct.MatchChannel = 1;
+  TIM_MatchConfigStruct.IntOnMatch = FALSE;
+  TIM_MatchConfigStruct.ResetOnMatch = FALSE;
+  TIM_MatchConfigStruct.StopOnMatch = FALSE;
+  TIM_MatchConfigStruct.ExtMatchOutputType = TIM_EXTMATCH_NOTHING;
+  TIM_MatchConfigStruct.MatchValue = ADC_TRIGGER_MATCH;
+  TIM_ConfigMatch(LPC_TIM0, &TIM_MatchConfigStruct);
+  TIM_ClearIntPending(LPC_TIM0, TIM_MR1_INT);
+  
+  // STEP 5
+  for (uint8_t Channel = 0; Channel < ADC_SCAN_CHANNELS; Channel++)
+    ADC_ScanReset(&ADC_Scan[Channel]);
+  ADC_Capture.Status = CAPTURE_IDLE;
+  CLKPWR_ConfigPPWR(CLKPWR_PCONP_PCGPDMA, ENABLE);
+  LPC_SC->DMAREQSEL |= ADC_PACE_DMAREQSEL;
+  LPC_GPDMA->DMACConfig = 0x01;  // ENABLE, LITTLE ENDIAN
+  ADC_ScanDMA_Start();
+  ctl_set_priority(DMA_IRQn, DMA_IRQ_PRIORITY);
+  ctl_unmask_isr(DMA_IRQn);
   
-  } // END OF init_ADC_polling
+  } // END OF init_ADC_Scan
+
+
+
+
+/*************************************************************************
+ * Function Name: ADC_ScanStop
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Stops the background scan (or a capture) and powers down the ADC and GPDMA - use before
+ * sleep.  init_ADC_Scan starts the scan again.  The filtered values are kept until then.
+ * STEP 1: Stop the pace (or the burst of a capture) and the DMA, mask its IRQ and power down.  A capture
+ * not done is dropped
+ *************************************************************************/
+ void ADC_ScanStop(void)
+ {
+ 
+ // STEP 1
+ LPC_GPDMACH1->DMACCConfig = 0;
+ ADC_BurstCmd(LPC_ADC, DISABLE);
+ ctl_mask_isr(DMA_IRQn);
+ ADC_Capture.Status = CAPTURE_IDLE;
+ LPC_GPDMACH0->DMACCConfig = 0;
+ LPC_GPDMA->DMACIntTCClear = (1 << ADC_DMA_CHANNEL) | (1 << ADC_PACE_DMA_CHANNEL);
+ LPC_GPDMA->DMACIntErrClr = (1 << ADC_DMA_CHANNEL) | (1 << ADC_PACE_DMA_CHANNEL);
+ LPC_GPDMA->DMACConfig = 0;
+ CLKPWR_ConfigPPWR(CLKPWR_PCONP_PCGPDMA, DISABLE);
+ ADC_DeInit(LPC_ADC);
+ 
+ } // END OF ADC_ScanStop
+
+
+
+
+/*************************************************************************
+ * Function Name: ADC_ScanConfig
+ * Parameters: uint8_t Channel, uint16_t Decimation, uint8_t Length
+ * Return: void
+ *
+ * Description: Sets the filter of a scanned channel: Decimation samples are summed to each ring
+ * value and the filtered value is the average of the last Length ring values.  The filter window is
+ * Decimation x Length samples at the rate of the channel - its slots of ADC_ScanOrder.  The filter starts over.
+ * STEP 1: Limit the settings
+ * STEP 2: Set the filter with the DMA IRQ masked - it is the only other user
+ *************************************************************************/
+ void ADC_ScanConfig(uint8_t Channel, uint16_t Decimation, uint8_t Length)
+ {
+ 
+ // STEP 1
+ if (Channel >= ADC_SCAN_CHANNELS)
+   return;
+ if (Decimation == 0)
+   Decimation = 1;
+ if (Decimation > ADC_MAX_DECIMATION)
+   Decimation = ADC_MAX_DECIMATION;
+ if (Length == 0)
+   Length = 1;
+ if (Length > ADC_RING_LENGTH)
+   Length = ADC_RING_LENGTH;
+ 
+ // STEP 2
+ ctl_mask_isr(DMA_IRQn);
+ ADC_Scan[Channel].Decimation = Decimation;
+ ADC_Scan[Channel].Length = Length;
+ ADC_ScanReset(&ADC_Scan[Channel]);
+ ctl_unmask_isr(DMA_IRQn);
+ 
+ } // END OF ADC_ScanConfig
+
+
+
+
+/*************************************************************************
+ * Function Name: ADC_ScanFlush
+ * Parameters: uint8_t Channel, uint16_t Discard
+ * Return: void
+ *
+ * Description: Starts the filter of a channel over - use after the input of the channel changes
+ * (a meter range switch) so no older sample is in what follows.  The next Discard samples of the
+ * channel are dropped while the input settles.  The last filtered and probe values stay until
+ * the first new ones.  See ADC_ScanSettled and ADC_ScanProbeReady.
+ * STEP 1: Reset the filter with the DMA IRQ masked
+ *************************************************************************/
+ void ADC_ScanFlush(uint8_t Channel, uint16_t Discard)
+ {
+ 
+ // STEP 1
+ if (Channel >= ADC_SCAN_CHANNELS)
+   return;
+ ctl_mask_isr(DMA_IRQn);
+ ADC_ScanReset(&ADC_Scan[Channel]);
+ ADC_Scan[Channel].Discard = Discard;
+ ctl_unmask_isr(DMA_IRQn);
+ 
+ } // END OF ADC_ScanFlush
+
+
+
+
+/*************************************************************************
+ * Function Name: ADC_ScanSettled
+ * Parameters: uint8_t Channel
+ * Return: BOOLEAN
+ *
+ * Description: TRUE when the moving average of the channel is full - every ring value in it is
+ * from after the last flush, config or init.
+ * STEP 1: Compare the ring values in to the length
+ *************************************************************************/
+ BOOLEAN ADC_ScanSettled(uint8_t Channel)
+ {
+ 
+ // STEP 1
+ if (Channel >= ADC_SCAN_CHANNELS)
+   return(FALSE);
+ return(ADC_Scan[Channel].Filled >= ADC_Scan[Channel].Length);
+ 
+ } // END OF ADC_ScanSettled
+
+
+
+
+/*************************************************************************
+ * Function Name: ADC_ScanProbeReady
+ * Parameters: uint8_t Channel
+ * Return: BOOLEAN
+ *
+ * Description: TRUE when the channel has a probe value from after the last flush, config or init:
+ * ADC_PROBE_SAMPLES or more samples after the discard - a few ms where the filter takes 100s.
+ * STEP 1: Return the probe flag
+ *************************************************************************/
+ BOOLEAN ADC_ScanProbeReady(uint8_t Channel)
+ {
+ 
+ // STEP 1
+ if (Channel >= ADC_SCAN_CHANNELS)
+   return(FALSE);
+ return(ADC_Scan[Channel].ProbeReady);
+ 
+ } // END OF ADC_ScanProbeReady
 
 
 
@@ -85,68 +276,608 @@ extern CTL_MUTEX_t ADC_Mutex;
  * Parameters: ADC_HC15C_Type
  * Return: double
  *
- * Description: Retrieves the conversion result for the specified ADC Channel.
- * Returns a result that has been averaged by the structure avg value.  If avg
- * value set to zero - no averaging occurs.  The samples are taken on a periodic interval,
- * hence the total time it takes to do a conversion can be large: (Convert Time + Interval)x Number of Samples
- * NOTE: This a a polling routine.  Use with init_ADC_polling - called first
- * NOTE: Multiple calling tasks - must be thread safe
- * STEP 1: Issue a conversion command according to ADC channel
- * STEP 2: Get the Count by polling until done
- * STEP 3: Convert the count to the voltage reading
+ * Description: Returns the latest filtered value of the specified ADC Channel as the voltage at the
+ * front end.  The scan runs in the background so this does not wait and takes no mutex: the
+ * filtered count is one word written by the DMA IRQ.  See ADC_ScanConfig for the filter.
+ * NOTE: Use with init_ADC_Scan - called first
+ * STEP 1: Convert the filtered count to the voltage reading
  *************************************************************************/
  double ADC_getConvertedValue(ADC_HC15C_Type ADC_HC15C_Struct)
  {
  
- ctl_mutex_lock(&ADC_Mutex, CTL_TIMEOUT_NONE, 0); 
-   
- uint8_t Count;
- uint32_t ADC_ConvertValue = 0, ADC_Conversion = 0;
- double ADC_Voltage;
+ double ADC_Voltage = 0.0;
  
  // STEP 1
- Count = ADC_HC15C_Struct.ADC_AvgWeight;
- switch (ADC_HC15C_Struct.ADC_Type)
+ if (ADC_HC15C_Struct.ADC_Type < ADC_SCAN_CHANNELS)
    {
-   case ADC_BAT_VOLTAGE:
-   ADC_ChannelCmd(LPC_ADC,ADC_BAT_VOLTAGE,ENABLE);
-   ADC_ChannelCmd(LPC_ADC,ADC_MET_VOLTAGE,DISABLE);
-   ADC_ChannelCmd(LPC_ADC,ADC_USB_VOLTAGE,DISABLE);
-   break;
-   
-   case ADC_MET_VOLTAGE:
-   ADC_ChannelCmd(LPC_ADC,ADC_BAT_VOLTAGE,DISABLE);
-   ADC_ChannelCmd(LPC_ADC,ADC_MET_VOLTAGE,ENABLE);
-   ADC_ChannelCmd(LPC_ADC,ADC_USB_VOLTAGE,DISABLE);
-   break;
+   ADC_Voltage = ADC_Scan[ADC_HC15C_Struct.ADC_Type].Filtered;
+   ADC_Voltage = (ADC_Voltage/ADC_FULL_COUNT) * (1.0/ADC_HC15C_Struct.ADC_FrontEndDivider) * ADC_REFERENCE;
+   }
+ 
+ return(ADC_Voltage);
+ 
+ } // END OF FUNCTION ADC_getConvertedValue
+
+
+
+
+/*************************************************************************
+ * Function Name: ADC_getProbeValue
+ * Parameters: ADC_HC15C_Type
+ * Return: double
+ *
+ * Description: Returns the latest probe value of the specified ADC Channel as the voltage at the
+ * front end: the average of the samples of the last DMA half, not filtered.  Quick to follow a
+ * step at the input so use it to decide (a meter range), not to display.
+ * NOTE: Use with init_ADC_Scan - called first
+ * STEP 1: Convert the probe count to the voltage reading
+ *************************************************************************/
+ double ADC_getProbeValue(ADC_HC15C_Type ADC_HC15C_Struct)
+ {
+ 
+ double ADC_Voltage = 0.0;
+ 
+ // STEP 1
+ if (ADC_HC15C_Struct.ADC_Type < ADC_SCAN_CHANNELS)
+   {
+   ADC_Voltage = ADC_Scan[ADC_HC15C_Struct.ADC_Type].Probe;
+   ADC_Voltage = (ADC_Voltage/ADC_FULL_COUNT) * (1.0/ADC_HC15C_Struct.ADC_FrontEndDivider) * ADC_REFERENCE;
+   }
+ 
+ return(ADC_Voltage);
+ 
+ } // END OF FUNCTION ADC_getProbeValue
+
+
+
+
+/*************************************************************************
+ * Function Name: ADC_CaptureStart
+ * Parameters: uint32_t Rate, uint16_t Level, BOOLEAN Rising, uint8_t PreChunks
+ * Return: void
+ *
+ * Description: Stops the background scan (and its pace) and arms a capture of the meter channel alone at Rate
+ * conversions per second - ADC_CAPTURE_RATE at the most.  The GPDMA writes ADC_CaptureRing in chunks that link in a circle.
+ * Once PreChunks chunks are full the trigger is the first sample through Level (ADC counts) on the
+ * Rising or falling edge, and the capture stops when the ring holds the PreChunks chunks before the
+ * trigger chunk.  See ADC_CaptureStatus and ADC_CaptureResult.  init_ADC_Scan ends capture use.
+ * STEP 1: Stop the scan and set up the capture
+ * STEP 2: The ADC at the capture rate on the meter channel - the global done requests DMA
+ * STEP 3: Link the chunks of the ring and start the DMA channel on the first
+ * STEP 4: Start the burst
+ *************************************************************************/
+ void ADC_CaptureStart(uint32_t Rate, uint16_t Level, BOOLEAN Rising, uint8_t PreChunks)
+ {
+ 
+ // STEP 1
+ ADC_ScanStop();
+ if (PreChunks == 0)
+   PreChunks = 1;
+ if (PreChunks > ADC_CAPTURE_MAX_PRE)
+   PreChunks = ADC_CAPTURE_MAX_PRE;
+ ADC_Capture.Level = Level;
+ ADC_Capture.Rising = Rising;
+ ADC_Capture.Armed = FALSE;
+ ADC_Capture.Force = FALSE;
+ ADC_Capture.PreChunks = PreChunks;
+ ADC_Capture.Next = 0;
+ ADC_Capture.Chunks = 0;
+ ADC_Capture.Buffer = ADC_CaptureRing;
+ ADC_Capture.Rate = 0;
+ if ((Rate == 0) || (Rate > ADC_CAPTURE_RATE))
+   Rate = ADC_CAPTURE_RATE;
+ 
+ // STEP 2
+ ADC_Init(LPC_ADC, Rate);
+ LPC_ADC->ADINTEN = ADC_INTEN_GLOBAL;
+ ADC_ChannelCmd(LPC_ADC,ADC_MET_VOLTAGE,ENABLE);
+ 
+ // STEP 3
+ for (uint8_t Chunk = 0; Chunk < ADC_CAPTURE_CHUNKS; Chunk++)
+   {
+   ADC_CaptureLLI[Chunk].SrcAddr = (uint32_t)&LPC_ADC->ADGDR;
+   ADC_CaptureLLI[Chunk].DestAddr = (uint32_t)&ADC_CaptureRing[Chunk * ADC_CAPTURE_CHUNK];
+   ADC_CaptureLLI[Chunk].NextLLI = (uint32_t)&ADC_CaptureLLI[(Chunk + 1) % ADC_CAPTURE_CHUNKS];
+   ADC_CaptureLLI[Chunk].Control = ADC_CAPTURE_CHUNK | DMA_CONTROL_SWIDTH_WORD | DMA_CONTROL_DWIDTH_WORD | DMA_CONTROL_DI | DMA_CONTROL_I;
+   }
+ CLKPWR_ConfigPPWR(CLKPWR_PCONP_PCGPDMA, ENABLE);
+ LPC_GPDMA->DMACConfig = 0x01;  // ENABLE, LITTLE ENDIAN
+ LPC_GPDMA->DMACIntTCClear = (1 << ADC_DMA_CHANNEL);
+ LPC_GPDMA->DMACIntErrClr = (1 << ADC_DMA_CHANNEL);
+ LPC_GPDMACH0->DMACCSrcAddr = ADC_CaptureLLI[0].SrcAddr;
+ LPC_GPDMACH0->DMACCDestAddr = ADC_CaptureLLI[0].DestAddr;
+ LPC_GPDMACH0->DMACCLLI = ADC_CaptureLLI[0].NextLLI;
+ LPC_GPDMACH0->DMACCControl = ADC_CaptureLLI[0].Control;
+ LPC_GPDMACH0->DMACCConfig = DMA_CONFIG_E | DMA_CONFIG_SRC_PERIPHERAL(ADC_DMA_REQUEST) | DMA_CONFIG_P2M | DMA_CONFIG_IE | DMA_CONFIG_ITC;
+ ADC_Capture.Status = CAPTURE_ARMED;
+ ctl_set_priority(DMA_IRQn, DMA_IRQ_PRIORITY);
+ ctl_unmask_isr(DMA_IRQn);
+ 
+ // STEP 4
+ ADC_StartCmd(LPC_ADC, ADC_START_CONTINUOUS);  // START FIELD 0: REQUIRED IN BURST
+ ADC_BurstCmd(LPC_ADC, ENABLE);
+ 
+ } // END OF ADC_CaptureStart
+
+
+
+
+/*************************************************************************
+ * Function Name: ADC_CaptureForce
+ * Parameters: void
+ * Return: void
+ *
+ * Description: An armed capture triggers at the start of the next chunk it looks at - use as the auto
+ * trigger when no edge comes.  Nothing is done if the capture is not armed.
+ * STEP 1: Flag the DMA IRQ
+ *************************************************************************/
+ void ADC_CaptureForce(void)
+ {
+ 
+ // STEP 1
+ if (ADC_Capture.Status == CAPTURE_ARMED)
+   ADC_Capture.Force = TRUE;
+ 
+ } // END OF ADC_CaptureForce
+
+
+
+
+/*************************************************************************
+ * Function Name: ADC_CaptureStatus
+ * Parameters: void
+ * Return: uint8_t
+ *
+ * Description: Returns the state of the capture - see enum ADC_CAPTURE_STATUS.  CAPTURE_IDLE after
+ * init_ADC_Scan, ADC_ScanStop (sleep) or a DMA error.
+ * STEP 1: Return the status
+ *************************************************************************/
+ uint8_t ADC_CaptureStatus(void)
+ {
+ 
+ // STEP 1
+ return(ADC_Capture.Status);
+ 
+ } // END OF ADC_CaptureStatus
+
+
+
+
+/*************************************************************************
+ * Function Name: ADC_CaptureResult
+ * Parameters: void
+ * Return: const ADC_Capture_Type *
+ *
+ * Description: Returns the capture once done, NULL before.  The samples are read where the DMA wrote
+ * them - they stay until the next ADC_CaptureStart.  Each is ADGDR: ADC_GDR_RESULT gives the count.
+ * STEP 1: Return the capture if done
+ *************************************************************************/
+ const ADC_Capture_Type *ADC_CaptureResult(void)
+ {
+ 
+ // STEP 1
+ if (ADC_Capture.Status != CAPTURE_DONE)
+   return(NULL);
+ return(&ADC_Capture);
+ 
+ } // END OF ADC_CaptureResult
+
+
+
+
+/*************************************************************************
+ * Function Name: ADC_CaptureRMS
+ * Parameters: const ADC_Capture_Type *Capture, ADC_RMS_Type *RMS
+ * Return: void
+ *
+ * Description: The RMS of a done capture with the DC removed - all integer but the last divide.  A
+ * rising crossing is a sample at or over the capture mean after one ADC_RMS_HYSTERESIS under it.  The
+ * window runs from the first rising crossing to the last, a whole number of cycles, so a part cycle
+ * does not bend the result.  Sums of the window are the running sums at its ends taken apart: one
+ * pass.  With n samples n x n x variance = n x SUM(X^2) - SUM(X)^2, exact in 64 bits (n x 4095^2 x n
+ * is under 2^50), then the integer square root.  About 1ms of the CPU for a whole ring.
+ * STEP 1: Mean, low and high of the capture
+ * STEP 2: Running sum and sum of squares - note them at the first and the last rising crossing
+ * STEP 3: The window: whole cycles or else the capture
+ * STEP 4: RMS and mean of the window
+ *************************************************************************/
+ void ADC_CaptureRMS(const ADC_Capture_Type *Capture, ADC_RMS_Type *RMS)
+ {
+ 
+ uint16_t Result, Mean, Crossings = 0, Start = 0, End = 0;
+ uint32_t Sum = 0, StartSum = 0, EndSum = 0, WindowSum;
+ uint64_t Squares = 0, StartSquares = 0, EndSquares = 0, WindowSquares;
+ BOOLEAN Below = FALSE;
+ 
+ // STEP 1
+ RMS->Low = (uint16_t)ADC_FULL_COUNT;
+ RMS->High = 0;
+ for (uint16_t Count = 0; Count < ADC_CAPTURE_SAMPLES; Count++)
+   {
+   Result = ADC_GDR_RESULT(Capture->Buffer[(Capture->First + Count) % ADC_CAPTURE_SAMPLES]);
+   Sum += Result;
+   if (Result < RMS->Low)
+     RMS->Low = Result;
+   if (Result > RMS->High)
+     RMS->High = Result;
+   }
+ Mean = Sum / ADC_CAPTURE_SAMPLES;
+ 
+ // STEP 2
+ Sum = 0;
+ for (uint16_t Count = 0; Count < ADC_CAPTURE_SAMPLES; Count++)
+   {
+   Result = ADC_GDR_RESULT(Capture->Buffer[(Capture->First + Count) % ADC_CAPTURE_SAMPLES]);
+   if ((Result + ADC_RMS_HYSTERESIS) <= Mean)
+     Below = TRUE;
+   else if (Below && (Result >= Mean))
+     {
+     Below = FALSE;
+     if (Crossings++ == 0)
+       {
+       Start = Count;
+       StartSum = Sum;
+       StartSquares = Squares;
+       }
+     End = Count;
+     EndSum = Sum;
+     EndSquares = Squares;
+     }
+   Sum += Result;
+   Squares += (uint32_t)Result * Result;
+   }
+ 
+ // STEP 3
+ if (Crossings >= 2)
+   {
+   RMS->Cycles = Crossings - 1;
+   RMS->Samples = End - Start;
+   WindowSum = EndSum - StartSum;
+   WindowSquares = EndSquares - StartSquares;
+   RMS->Frequency = ((float)RMS->Cycles * Capture->Rate) / RMS->Samples;
+   }
+ else
+   {
+   RMS->Cycles = 0;
+   RMS->Samples = ADC_CAPTURE_SAMPLES;
+   WindowSum = Sum;
+   WindowSquares = Squares;
+   RMS->Frequency = 0;
+   }
    
-   case ADC_USB_VOLTAGE:
-   ADC_ChannelCmd(LPC_ADC,ADC_BAT_VOLTAGE,DISABLE);
-   ADC_ChannelCmd(LPC_ADC,ADC_MET_VOLTAGE,DISABLE);
-   ADC_ChannelCmd(LPC_ADC,ADC_USB_VOLTAGE,ENABLE);
-   break;
+ // STEP 4
+ RMS->Rms = (float)ADC_SquareRoot(((uint64_t)RMS->Samples * WindowSquares) - ((uint64_t)WindowSum * WindowSum)) / RMS->Samples;
+ RMS->Mean = (float)WindowSum / RMS->Samples;
+ 
+ } // END OF ADC_CaptureRMS
+
+
+
+
+/*************************************************************************
+ * Function Name: DMA_IRQHandler
+ * Parameters: void
+ * Return: void
+ *
+ * Description: IRQ Handler for the GPDMA.  A half of ADC_Raw is full - the DMA is already on the other
+ * half.  Each sample goes to the filter of its channel: it is summed until Decimation samples,
+ * the sum replaces the oldest ring value and the filtered value is the ring average.  The samples
+ * are also summed for the probe value.  After a flush the first Discard samples are dropped.
+ * While a capture runs the chunks go to ADC_CaptureIRQ instead.
+ * STEP 1: Check it is the ADC channel and clear the IRQ.  After an error start the ring and the pace
+ * again - or drop the capture.  An error of the pace channel starts the scan again
+ * STEP 2: The half not being written is the one done
+ * STEP 3: Filter each sample of the half
+ * STEP 4: Probe value of each channel with enough samples
+ *************************************************************************/
+ void DMA_IRQHandler(void)
+ {
+
+ uint32_t Sample;
+ uint8_t Half;
+ ADC_Scan_Type *Scan;
+
+ // STEP 1
+ if (LPC_GPDMA->DMACIntErrStat & (1 << ADC_PACE_DMA_CHANNEL))
+   {
+   LPC_GPDMA->DMACIntErrClr = (1 << ADC_PACE_DMA_CHANNEL);
+   if (ADC_Capture.Status == CAPTURE_IDLE)
+     ADC_ScanDMA_Start();
+   return;
+   }
+ if (!((LPC_GPDMA->DMACIntTCStat | LPC_GPDMA->DMACIntErrStat) & (1 << ADC_DMA_CHANNEL)))
+   return;
+ LPC_GPDMA->DMACIntTCClear = (1 << ADC_DMA_CHANNEL);
+ if (LPC_GPDMA->DMACIntErrStat & (1 << ADC_DMA_CHANNEL))
+   {
+   LPC_GPDMA->DMACIntErrClr = (1 << ADC_DMA_CHANNEL);
+   if (ADC_Capture.Status != CAPTURE_IDLE)
+     {
+     ADC_CaptureHalt();
+     ADC_Capture.Status = CAPTURE_IDLE;
+     }
+   else
+     ADC_ScanDMA_Start();
+   return;
+   }
+ if (ADC_Capture.Status != CAPTURE_IDLE)
+   {
+   ADC_CaptureIRQ();
+   return;
    }
- ADC_Conversion = ADC_GlobalGetData(LPC_ADC);
- ADC_Conversion = ADC_ChannelGetData(LPC_ADC, ADC_HC15C_Struct.ADC_Type);
  
  // STEP 2
- do
-   { 
-   ADC_StartCmd(LPC_ADC, ADC_START_NOW);
-   while (!(ADC_ChannelGetStatus(LPC_ADC, ADC_HC15C_Struct.ADC_Type, ADC_DATA_DONE)));
-	 ADC_Conversion = ADC_ChannelGetData(LPC_ADC, ADC_HC15C_Struct.ADC_Type);
-   ADC_ConvertValue += ADC_Conversion;
-   Count--;
-   delayXms(ADC_HC15C_Struct.ADC_msTimeBetweenSamples);
-   } while (Count > 0);
+ Half = (LPC_GPDMACH0->DMACCDestAddr >= (uint32_t)ADC_Raw[1]) ? 0 : 1;
+ 
+ // STEP 3
+ for (uint8_t Index = 0; Index < ADC_SCAN_BLOCK; Index++)
+   {
+   Sample = ADC_Raw[Half][Index];
+   if (ADC_GDR_CH(Sample) >= ADC_SCAN_CHANNELS)
+     continue;
+   Scan = &ADC_Scan[ADC_GDR_CH(Sample)];
+   if (Scan->Discard)
+     {
+     Scan->Discard--;
+     continue;
+     }
+   Scan->ProbeSum += ADC_GDR_RESULT(Sample);
+   Scan->ProbeCount++;
+   Scan->Accumulator += ADC_GDR_RESULT(Sample);
+   if (++Scan->Count < Scan->Decimation)
+     continue;
+   Scan->RingSum += Scan->Accumulator - Scan->Ring[Scan->Head];
+   Scan->Ring[Scan->Head] = Scan->Accumulator;
+   if (++Scan->Head >= Scan->Length)
+     Scan->Head = 0;
+   if (Scan->Filled < Scan->Length)
+     Scan->Filled++;
+   Scan->Filtered = (float)Scan->RingSum / ((float)Scan->Decimation * Scan->Filled);
+   Scan->Accumulator = 0;
+   Scan->Count = 0;
+   }
+ 
+ // STEP 4
+ for (uint8_t Channel = 0; Channel < ADC_SCAN_CHANNELS; Channel++)
+   {
+   Scan = &ADC_Scan[Channel];
+   if (Scan->ProbeCount < ADC_PROBE_SAMPLES)
+     continue;
+   Scan->Probe = (float)Scan->ProbeSum / Scan->ProbeCount;
+   Scan->ProbeReady = TRUE;
+   Scan->ProbeSum = 0;
+   Scan->ProbeCount = 0;
+   }
+
+ } // END OF FUNCTION DMA_IRQHandler
+
+
+
+
+/*************************************************************************
+ * Function Name: ADC_ScanReset
+ * Parameters: ADC_Scan_Type *
+ * Return: void
+ *
+ * Description: Empties the filter of a channel but keeps its settings, last filtered and last probe value.
+ * NOTE: The caller masks the DMA IRQ
+ * STEP 1: Clear the sum, the ring and the ring average, the probe sum and the discard
+ *************************************************************************/
+ static void ADC_ScanReset(ADC_Scan_Type *Scan)
+ {
+ 
+ // STEP 1
+ Scan->Accumulator = 0;
+ Scan->Count = 0;
+ memset(Scan->Ring, 0, sizeof(Scan->Ring));
+ Scan->Head = 0;
+ Scan->Filled = 0;
+ Scan->RingSum = 0;
+ Scan->Discard = 0;
+ Scan->ProbeSum = 0;
+ Scan->ProbeCount = 0;
+ Scan->ProbeReady = FALSE;
+ 
+ } // END OF ADC_ScanReset
+
+
+
+
+/*************************************************************************
+ * Function Name: ADC_ScanDMA_Start
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Links the two halves of ADC_Raw to each other and starts the ADC DMA channel on the
+ * first.  Every half ends with a terminal count IRQ and the channel never stops.  Then links the
+ * ADCR words of the slots in a circle and starts the pace channel on the first: a word each timer 0
+ * MR1 match, no terminal count IRQ.
+ * STEP 1: Build the linked list of the ring
+ * STEP 2: Load the channel with the first half and enable it - peripheral (ADC) to memory
+ * STEP 3: Build the linked list of the slots
+ * STEP 4: Load the pace channel with the first slot and enable it - memory to peripheral (MAT0.1)
+ *************************************************************************/
+ static void ADC_ScanDMA_Start(void)
+ {
+ 
+ // STEP 1
+ for (uint8_t Half = 0; Half < 2; Half++)
+   {
+   ADC_LLI[Half].SrcAddr = (uint32_t)&LPC_ADC->ADGDR;
+   ADC_LLI[Half].DestAddr = (uint32_t)ADC_Raw[Half];
+   ADC_LLI[Half].NextLLI = (uint32_t)&ADC_LLI[Half ^ 1];
+   ADC_LLI[Half].Control = ADC_SCAN_BLOCK | DMA_CONTROL_SWIDTH_WORD | DMA_CONTROL_DWIDTH_WORD | DMA_CONTROL_DI | DMA_CONTROL_I;
+   }
    
+ // STEP 2
+ LPC_GPDMACH0->DMACCConfig = 0;
+ LPC_GPDMA->DMACIntTCClear = (1 << ADC_DMA_CHANNEL);
+ LPC_GPDMA->DMACIntErrClr = (1 << ADC_DMA_CHANNEL);
+ LPC_GPDMACH0->DMACCSrcAddr = ADC_LLI[0].SrcAddr;
+ LPC_GPDMACH0->DMACCDestAddr = ADC_LLI[0].DestAddr;
+ LPC_GPDMACH0->DMACCLLI = ADC_LLI[0].NextLLI;
+ LPC_GPDMACH0->DMACCControl = ADC_LLI[0].Control;
+ LPC_GPDMACH0->DMACCConfig = DMA_CONFIG_E | DMA_CONFIG_SRC_PERIPHERAL(ADC_DMA_REQUEST) | DMA_CONFIG_P2M | DMA_CONFIG_IE | DMA_CONFIG_ITC;
+ 
  // STEP 3
- ADC_Voltage = ((double)ADC_ConvertValue/ADC_HC15C_Struct.ADC_AvgWeight);
- ADC_Voltage = (ADC_Voltage/ADC_FULL_COUNT) * (1.0/ADC_HC15C_Struct.ADC_FrontEndDivider) * ADC_REFERENCE;
+ for (uint8_t Slot = 0; Slot < ADC_SCAN_SLOTS; Slot++)
+   {
+   ADC_PaceLLI[Slot].SrcAddr = (uint32_t)&ADC_ScanControl[Slot];
+   ADC_PaceLLI[Slot].DestAddr = (uint32_t)&LPC_ADC->ADCR;
+   ADC_PaceLLI[Slot].NextLLI = (uint32_t)&ADC_PaceLLI[(Slot + 1) % ADC_SCAN_SLOTS];
+   ADC_PaceLLI[Slot].Control = 1 | DMA_CONTROL_SWIDTH_WORD | DMA_CONTROL_DWIDTH_WORD;
+   }
  
- ctl_mutex_unlock(&ADC_Mutex);
- return(ADC_Voltage);
+ // STEP 4
+ LPC_GPDMACH1->DMACCConfig = 0;
+ LPC_GPDMA->DMACIntTCClear = (1 << ADC_PACE_DMA_CHANNEL);
+ LPC_GPDMA->DMACIntErrClr = (1 << ADC_PACE_DMA_CHANNEL);
+ LPC_GPDMACH1->DMACCSrcAddr = ADC_PaceLLI[0].SrcAddr;
+ LPC_GPDMACH1->DMACCDestAddr = ADC_PaceLLI[0].DestAddr;
+ LPC_GPDMACH1->DMACCLLI = ADC_PaceLLI[0].NextLLI;
+ LPC_GPDMACH1->DMACCControl = ADC_PaceLLI[0].Control;
+ LPC_GPDMACH1->DMACCConfig = DMA_CONFIG_E | DMA_CONFIG_DEST_PERIPHERAL(ADC_PACE_DMA_REQUEST) | DMA_CONFIG_M2P | DMA_CONFIG_IE;
  
- } // END OF FUNCTION ADC_getConvertedValue
+ } // END OF ADC_ScanDMA_Start
+
+
+
+
+/*************************************************************************
+ * Function Name: ADC_CaptureIRQ
+ * Parameters: void
+ * Return: void
+ *
+ * Description: The DMA IRQ of a capture.  Every chunk before the one being written is done - more
+ * than one if the IRQ was late.  Once PreChunks chunks are full each done chunk is searched for the
+ * trigger: a sample ADC_CAPTURE_HYSTERESIS before Level arms the edge, the first sample through Level
+ * after it is the trigger.  The capture stops when the ring no longer holds anything older than the
+ * PreChunks chunks before the trigger chunk - and not before the ring has gone round once, so the
+ * part of the chunk being written at the stop holds this capture too.  The rate is the samples over the cycles between the
+ * first and the last full chunk.
+ * STEP 1: Count each done chunk.  Note the cycle count of the first
+ * STEP 2: Search it for the trigger while armed
+ * STEP 3: Stop after the chunks that follow the trigger
+ *************************************************************************/
+ static void ADC_CaptureIRQ(void)
+ {
+ 
+ uint8_t Writing;
+ uint16_t Index, Result;
+ int32_t Arm;
+ 
+ // THE END OF THE RING READS AS THE FIRST CHUNK - THE CHANNEL IS LOADING ITS LINKED LIST ITEM
+ Writing = (((LPC_GPDMACH0->DMACCDestAddr - (uint32_t)ADC_CaptureRing) / sizeof(uint32_t)) / ADC_CAPTURE_CHUNK) % ADC_CAPTURE_CHUNKS;
+ Arm = ADC_Capture.Rising ? ((int32_t)ADC_Capture.Level - ADC_CAPTURE_HYSTERESIS) : ((int32_t)ADC_Capture.Level + ADC_CAPTURE_HYSTERESIS);
+ while (ADC_Capture.Next != Writing)
+   {
+   // STEP 1
+   if (ADC_Capture.Chunks == 0)
+     ADC_Capture.StartCycles = CYCLE_COUNT;
+   ADC_Capture.Chunks++;
+   Index = ADC_Capture.Next * ADC_CAPTURE_CHUNK;
+   ADC_Capture.Next = (ADC_Capture.Next + 1) % ADC_CAPTURE_CHUNKS;
+   
+   // STEP 2
+   if ((ADC_Capture.Status == CAPTURE_ARMED) && (ADC_Capture.Chunks > ADC_Capture.PreChunks))
+     {
+     if (ADC_Capture.Force)
+       {
+       ADC_Capture.Force = FALSE;
+       ADC_Capture.Trigger = Index;
+       ADC_Capture.Status = CAPTURE_TRIGGERED;
+       }
+     for (uint16_t Sample = 0; (Sample < ADC_CAPTURE_CHUNK) && (ADC_Capture.Status == CAPTURE_ARMED); Sample++, Index++)
+       {
+       Result = ADC_GDR_RESULT(ADC_Capture.Buffer[Index]);
+       if (ADC_Capture.Rising ? ((int32_t)Result <= Arm) : ((int32_t)Result >= Arm))
+         ADC_Capture.Armed = TRUE;
+       else if (ADC_Capture.Armed && (ADC_Capture.Rising ? (Result >= ADC_Capture.Level) : (Result <= ADC_Capture.Level)))
+         {
+         ADC_Capture.Trigger = Index;
+         ADC_Capture.Status = CAPTURE_TRIGGERED;
+         }
+       }
+     if (ADC_Capture.Status == CAPTURE_TRIGGERED)
+       {
+       ADC_Capture.StopChunk = ADC_Capture.Chunks + ADC_CAPTURE_MAX_PRE - ADC_Capture.PreChunks;
+       if (ADC_Capture.StopChunk < ADC_CAPTURE_CHUNKS)
+         ADC_Capture.StopChunk = ADC_CAPTURE_CHUNKS;
+       }
+     }
+   
+   // STEP 3
+   if ((ADC_Capture.Status == CAPTURE_TRIGGERED) && (ADC_Capture.Chunks >= ADC_Capture.StopChunk))
+     {
+     ADC_Capture.StopCycles = CYCLE_COUNT;
+     ADC_CaptureHalt();
+     ADC_Capture.First = ((LPC_GPDMACH0->DMACCDestAddr - (uint32_t)ADC_CaptureRing) / sizeof(uint32_t)) % ADC_CAPTURE_SAMPLES;
+     ADC_Capture.Rate = (uint32_t)(((uint64_t)(ADC_Capture.Chunks - 1) * ADC_CAPTURE_CHUNK * SystemCoreClock) / 
+                                   (ADC_Capture.StopCycles - ADC_Capture.StartCycles));
+     ADC_Capture.Status = CAPTURE_DONE;
+     return;
+     }
+   }
+ 
+ } // END OF ADC_CaptureIRQ
+
+
+
+
+/*************************************************************************
+ * Function Name: ADC_CaptureHalt
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Stops the burst and the DMA channel of a capture where they are.  The channel keeps
+ * the address it would write next.  The ADC and GPDMA stay powered until ADC_ScanStop.
+ * STEP 1: Stop the burst, then the channel
+ *************************************************************************/
+ static void ADC_CaptureHalt(void)
+ {
+ 
+ // STEP 1
+ ADC_BurstCmd(LPC_ADC, DISABLE);
+ LPC_GPDMACH0->DMACCConfig = 0;
+ LPC_GPDMA->DMACIntTCClear = (1 << ADC_DMA_CHANNEL);
+ 
+ } // END OF ADC_CaptureHalt
+
+
+
+
+/*************************************************************************
+ * Function Name: ADC_SquareRoot
+ * Parameters: uint64_t Value
+ * Return: uint32_t
+ *
+ * Description: The integer square root (rounded down) - a result bit per pass, shifts and adds only.
+ * STEP 1: The highest power of 4 not over Value
+ * STEP 2: Try each result bit from there down
+ *************************************************************************/
+ static uint32_t ADC_SquareRoot(uint64_t Value)
+ {
+ 
+ uint64_t Root = 0;
+ uint64_t Bit = (uint64_t)1 << 62;
+ 
+ // STEP 1
+ while (Bit > Value)
+   Bit >>= 2;
    
- 
\ No newline at end of file
+ // STEP 2
+ while (Bit)
+   {
+   if (Value >= (Root + Bit))
+     {
+     Value -= Root + Bit;
+     Root = (Root >> 1) + Bit;
+     }
+   else
+     Root >>= 1;
+   Bit >>= 2;
+   }
+ 
+ return((uint32_t)Root);
+ 
+ } // END OF ADC_SquareRoot
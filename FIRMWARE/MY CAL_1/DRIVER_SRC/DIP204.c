@@ -4,7 +4,7 @@
  * Description:       Functions used to support PN: EA DIP204 LCD
  * Author:            Hab S. Collector
  * Date:              6/9/11
- * Last Edit:         8/03/12
+ * Last Edit:         10/19/2026
  * Hardware:          EA DIP204 LCD, 4X20 LCD WITH SPI INTERFACE Controller hardware is: SamSung KS0073
  * Firmware Tool:     CrossStudio for ARM
  * Notes:             This file should be written as to not be dependent on other includes.
@@ -27,6 +27,7 @@ uint8_t sLineNum = 0, sColNum = 0;
 
 // EXTERNS
 extern void delayXms(uint32_t);
+extern void delayXus(uint32_t);
 extern CTL_MUTEX_t DIP204MutexPrint, DIP204MutexClear, DIP204Mutex, DIP204MutexGoTo, DIP204MutexICON;
 
 // PROTOTYPE FUNCITONS
@@ -213,41 +214,41 @@ void DIP204_engine(uint8_t DisplayInstruction, uint8_t InstructionData)
   // STEP 2
   // FUNCTION SET: 8BIT, RE=0
   DIP204_engine(START_BYTE_CMD_WRITE, 0x30);               
-  delayXms(WAIT_FOR_DISPLAY);
+  delayXus(WAIT_FOR_COMMAND);
   // ENTRY MODE: CURSOR AUTO INC        
   DIP204_engine(START_BYTE_CMD_WRITE, 0x06);               
-  delayXms(WAIT_FOR_DISPLAY);
+  delayXus(WAIT_FOR_COMMAND);
   // FUNCTION SET: 8BIT, RE=1, BLINK ENABLE
   DIP204_engine(START_BYTE_CMD_WRITE, 0x36);                
-  delayXms(WAIT_FOR_DISPLAY);
+  delayXus(WAIT_FOR_COMMAND);
   // EX FUNCTION SET: 4 LINE MODE
   DIP204_engine(START_BYTE_CMD_WRITE, 0x09);               
-  delayXms(WAIT_FOR_DISPLAY);
+  delayXus(WAIT_FOR_COMMAND);
   
   // CLEAR THE ICONS TO OFF
   // SET SERRAM ADDRESS TO BASE 00
   DIP204_engine(START_BYTE_CMD_WRITE, 0x40);               
-  delayXms(WAIT_FOR_DISPLAY);
+  delayXus(WAIT_FOR_COMMAND);
   // WRITE 00 X16 TO CLEAR ALL ICONS
   for (int I=0; I<16; I++)                                               
    {
    DIP204_engine(START_BYTE_DAT_WRITE, 0x00);
-   delayXms(WAIT_FOR_DISPLAY);
+   delayXus(WAIT_FOR_COMMAND);
    }
   
   // STEP 3
   // FUNCTION SET: 8BIT, RE=0
   DIP204_engine(START_BYTE_CMD_WRITE, 0x30);
-  delayXms(WAIT_FOR_DISPLAY);
+  delayXus(WAIT_FOR_COMMAND);
   // DISPLAY ON, CURSOR ON
   DIP204_engine(START_BYTE_CMD_WRITE, 0x0E);
-  delayXms(WAIT_FOR_DISPLAY);
+  delayXus(WAIT_FOR_COMMAND);
   // CLEAR DISPLAY
   DIP204_engine(START_BYTE_CMD_WRITE, 0x01);
   delayXms(WAIT_FOR_DISPLAY);
   // DISPLAY ON, CURSOR ON, CURSOR BLINK
   DIP204_engine(START_BYTE_CMD_WRITE, 0x0F); 
-  delayXms(WAIT_FOR_DISPLAY);
+  delayXus(WAIT_FOR_COMMAND);
   DIP204_txt_engine(LCD_INTRO_LINE1,1,0,strlen(LCD_INTRO_LINE1));
   DIP204_txt_engine(LCD_INTRO_LINE2,2,0,strlen(LCD_INTRO_LINE2));
   DIP204_txt_engine(LCD_INTRO_LINE3,3,0,strlen(LCD_INTRO_LINE3));
@@ -390,7 +391,7 @@ void DIP204_engine(uint8_t DisplayInstruction, uint8_t InstructionData)
  
  // STEP 3
  DIP204_engine(START_BYTE_CMD_WRITE, (CMD_SET_DDR_ADDR|LineNumber));
- delayXms(WAIT_FOR_DISPLAY);
+ delayXus(WAIT_FOR_COMMAND);
  
  ctl_mutex_unlock(&DIP204Mutex); 
          
@@ -539,7 +540,7 @@ void DIP204_set_cursor(enum DIP204_CURSOR CursorStatus)
    }
  
  // STEP 2
- delayXms(WAIT_FOR_DISPLAY);
+ delayXus(WAIT_FOR_COMMAND);
  
  } // END OF FUNCTION DIP204_cursor
 
@@ -584,9 +585,48 @@ void DIP204_set_cursor(enum DIP204_CURSOR CursorStatus)
   
   // STEP 1
   DIP204_engine(START_BYTE_CMD_WRITE, CMD_DISPALY);
-  delayXms(WAIT_FOR_DISPLAY);
+  delayXus(WAIT_FOR_COMMAND);
   
  } // END OF FUNCTION DIP204_DisplayOff
  
          
-         
\ No newline at end of file
+         
+
+
+
+
+/*************************************************************************
+ * Function Name: DIP204_loadCGRAM
+ * Parameters: uint8_t, const uint8_t *
+ * Return: void
+ *
+ * Description: Loads the pattern of a user character (0-7): CGRAM_ROWS rows top to bottom, the low
+ * CGRAM_WIDTH bits of each.  The character code shows the new pattern at once wherever it is on
+ * the display.  Setting the CGRAM address moves the cursor - it is put back.
+ * STEP 1: Function set RE=0 then set the CGRAM address of the character
+ * STEP 2: Write the rows of the pattern
+ * STEP 3: Restore the cursor location using the global values for cursor location
+ *************************************************************************/
+ void DIP204_loadCGRAM(uint8_t Character, const uint8_t Pattern[])
+ {
+  
+  ctl_mutex_lock(&DIP204Mutex, CTL_TIMEOUT_NONE, 0); 
+  
+  // STEP 1
+  // FUNCTION SET: 8BIT, RE=0
+  DIP204_engine(START_BYTE_CMD_WRITE, 0x30);
+  DIP204_engine(START_BYTE_CMD_WRITE, (CMD_SET_CGR_ADDR | ((Character % CGRAM_CHARACTERS) * CGRAM_ROWS)));
+  delayXus(WAIT_FOR_COMMAND);
+  
+  // STEP 2
+  for (uint8_t Row = 0; Row < CGRAM_ROWS; Row++)
+    {
+    DIP204_engine(START_BYTE_DAT_WRITE, (Pattern[Row] & 0x1F));
+    }
+  
+  // STEP 3
+  DIP204_cursorToXY(sLineNum, sColNum);
+  
+  ctl_mutex_unlock(&DIP204Mutex); 
+  
+ } // END OF FUNCTION DIP204_loadCGRAM
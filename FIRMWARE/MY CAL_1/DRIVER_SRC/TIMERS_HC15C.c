@@ -4,7 +4,7 @@
  * Description:     Functions used to support timer operations on the HC15C
  * Author:          Hab S. Collector
  * Date:            9/22/11
- * LAST EDIT:       8/03/2012
+ * LAST EDIT:       10/19/2026
  * Hardware:        NXP LPC1769
  * Firmware Tool:   CrossStudio for ARM
  * Notes:           This file should be written as to not be dependent on other includes.
@@ -18,10 +18,13 @@
  #include "LED_HC15C.H"
  #include "CLOCK_TASKS.H"
  #include "METER_TASKS.H"
+ #include "LOG_TASKS.H"
+ #include "USB_LINK.H"
  #include "AUDIO_TASKS.H"
  #include "CORE_FUNCTIONS.H"
  #include "lpc17xx_timer.h"
  #include "lpc17xx_gpio.h"
+ #include "lpc17xx_clkpwr.h"
  #include "FAT_FS_INC/diskio.h"
  
  
@@ -30,7 +33,10 @@
  volatile uint16_t TimerCounterA_100us;
  volatile uint16_t TimerCounterB_100us;
  volatile uint16_t TimerCounterC_100us;
- volatile uint32_t msCounter;
+ volatile uint32_t IdleCycles;          // SYSTICK COUNTS ASLEEP IN THE IDLE TASK - WRAPS, ONLY DIFFERENCES COUNT
+ volatile uint8_t IdlePercent;          // OF THE LAST SECOND
+ volatile uint32_t DelayTicks;          // ms TASKS SLEPT IN delayXms - WRAPS, ONLY DIFFERENCES COUNT
+ volatile uint8_t WaitPercent;          // OF THE LAST SECOND - THE CPU THE BUSY WAIT delayXms SPUN AWAY
 
 
  // EXTERNS
@@ -39,39 +45,176 @@
  extern Type_SWAT SWAT;
  extern Type_Meter Meter;
  extern Type_OHMS OHMS;
- extern CTL_MUTEX_t DelayMutex;
+ extern Type_Scope Scope;
+ extern Type_Log MeterLog;
+ extern Type_Stream MeterStream;
  extern volatile uint8_t AudioChannel;
  extern volatile BOOLEAN PlayLeftChannel;
  extern Type_CircularBuffer CircularBufferLeft, CircularBufferRight;
  extern BOOLEAN ContinunityTone;
  
  
+ // PROTOTYPES LOCAL
+ static uint32_t getSysTickCount(void);
+ 
+ 
  /*************************************************************************
  * Function Name: delayXms
  * Parameters:    uint32_t
  * Return:        void
  *
- * Description: For CTL RTOS based applications.  Delays program execution by the
- * stated number of mili-seconds.  The time interval of the IRQ in ms
- * NOTE: Multiple calling tasks - must be thread safe
- * STEP 1: If desired delay less than max possible delay, then delay, if not no delay
+ * Description: For CTL RTOS based applications.  Delays the calling task at least the stated
+ * number of mili-seconds.  The task sleeps on its own CTL timeout: other tasks run meanwhile and
+ * any number of tasks can delay at once - nothing is shared.  The timeout ends on a tick, so the
+ * delay is up to 1ms longer than asked.  Only from a task - for less than a ms see delayXus.
+ * The time slept is added to DelayTicks: the delayXms before this one spun for it under a mutex,
+ * so each second WaitPercent is the CPU it took - IdlePercent less WaitPercent is the idle of then.
+ * STEP 1: Sleep to the tick after the delay
+ * STEP 2: Count the time slept - the add is not split by a task that also delays
  *************************************************************************/
  void delayXms(uint32_t DelayIn_ms)
   {
  
-  ctl_mutex_lock(&DelayMutex, CTL_TIMEOUT_NONE, 0); 
- 
+  uint32_t Start;
+  
   // STEP 1
-  TimerCounterA_100us = 0;
-  msCounter = 0;
-  while (msCounter < DelayIn_ms);
+  if (DelayIn_ms == 0)
+    return;
+  Start = ctl_get_current_time();
+  ctl_timeout_wait(Start + DelayIn_ms + 1);
   
-  ctl_mutex_unlock(&DelayMutex); 
+  // STEP 2
+  __disable_irq();
+  DelayTicks += ctl_current_time - Start;
+  __enable_irq();
   
   } // END OF delayXms
 
 
 
+/*************************************************************************
+ * Function Name: delayXus
+ * Parameters:    uint32_t
+ * Return:        void
+ *
+ * Description: Busy waits the stated number of micro-seconds on the DWT cycle counter - timed by
+ * SystemCoreClock, so it holds at any core clock.  Interrupts and a switch to a higher task only
+ * make it longer.  For the short waits of a device (well under a ms) where a sleep to the next
+ * tick would cost more than it saves.
+ * STEP 1: The cycle counter must run
+ * STEP 2: Spin the cycles of the delay
+ *************************************************************************/
+ void delayXus(uint32_t DelayIn_us)
+ {
+ 
+ uint32_t Start, Cycles;
+ 
+ // STEP 1
+ if (!(*((volatile uint32_t *)DWT_CTRL_ADDR) & DWT_CTRL_CYCCNTENA))
+   init_CycleCounter();
+ 
+ // STEP 2
+ Cycles = DelayIn_us * (SystemCoreClock / 1000000);
+ Start = CYCLE_COUNT;
+ while ((CYCLE_COUNT - Start) < Cycles);
+ 
+ } // END OF delayXus
+
+
+
+/*************************************************************************
+ * Function Name: idleSleep
+ * Parameters:    void
+ * Return:        void
+ *
+ * Description: The idle task loop: sleeps the core until an IRQ and adds the time asleep to
+ * IdleCycles.  The time is read off the SysTick counter and the CTL tick, which run while the core
+ * sleeps (the cycle counter does not).  The IRQs are masked (PRIMASK) from the first stamp to the
+ * last: WFI still wakes on an IRQ pending, but its handler - and a task it readies - runs only
+ * after the end stamp, so only the time asleep is counted.  The timer 0 IRQ makes IdlePercent of
+ * it each second.
+ * STEP 1: Mask the IRQs and stamp
+ * STEP 2: Sleep - any of the touch IRQs, timer IRQs or the RTC wake the core
+ * STEP 3: Add the time asleep, then let the IRQ that woke the core run
+ *************************************************************************/
+ void idleSleep(void)
+ {
+ 
+ uint32_t Start;
+ 
+ // STEP 1
+ __disable_irq();
+ Start = getSysTickCount();
+ 
+ // STEP 2
+ CLKPWR_Sleep();
+ 
+ // STEP 3
+ IdleCycles += getSysTickCount() - Start;
+ __enable_irq();
+ 
+ } // END OF idleSleep
+
+
+
+/*************************************************************************
+ * Function Name: getSysTickCount
+ * Parameters:    void
+ * Return:        uint32_t
+ *
+ * Description: Time in SysTick counts: the CTL ticks by the counts of a tick plus the counts into
+ * this one.  Wraps - only differences count.  Only with the IRQs masked: the SysTick IRQ cannot
+ * count a tick between the reads, so a tick pending (the counter wrapped) is added here and the
+ * counter read again.  ctl_current_time is read direct - one 32 bit read, no CTL call with the
+ * IRQs masked.  Good for one tick pending, as WFI wakes on it.
+ * STEP 1: The counter and the tick
+ * STEP 2: The counter wrapped and its IRQ is pending - one tick more
+ * STEP 3: Return the counts
+ *************************************************************************/
+ static uint32_t getSysTickCount(void)
+ {
+ 
+ uint32_t Tick, Count;
+ 
+ // STEP 1
+ Count = SysTick->VAL;
+ Tick = ctl_current_time;
+ 
+ // STEP 2
+ if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+   {
+   Count = SysTick->VAL;
+   Tick++;
+   }
+ 
+ // STEP 3
+ return((Tick * (SysTick->LOAD + 1)) + (SysTick->LOAD - Count));
+ 
+ } // END OF getSysTickCount
+
+
+
+/*************************************************************************
+ * Function Name: init_CycleCounter
+ * Parameters:    void
+ * Return:        void
+ *
+ * Description: Enables the Cortex-M3 DWT cycle counter.  Once enabled CYCLE_COUNT
+ * counts CPU clocks (SystemCoreClock) and wraps at 32 bits.  Used to time code.
+ * Safe to call more than once.
+ * STEP 1: Enable trace then the counter
+ *************************************************************************/
+ void init_CycleCounter(void)
+ {
+
+ // STEP 1
+ CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+ *((volatile uint32_t *)DWT_CTRL_ADDR) |= DWT_CTRL_CYCCNTENA;
+
+ } // END OF init_CycleCounter
+
+
+
 /*************************************************************************
  * Function Name: SysTimerCallFromISR
  * Parameters:    void
@@ -151,17 +294,18 @@ void init_HC15C_OnTimerCounter0(uint32_t TimeInMicoSeconds)
  * Return: void
  *
  * Description: IRQ Handler for Timer0.  
- * Used to count milli-seconds: for the delayXms function and for the 50% duty square 
- * wave of the continunity beep.  
+ * Used to count milli-seconds: for the 50% duty square wave of the continunity beep and the meter
+ * sample times.
  * Used to create 1 sec period: The 1s period is used as the backlight timer and to set an event for
- * the battery power monitor task.  
+ * the battery power monitor task.  Each second the idle time and the delayXms time of the last second
+ * are made a percent.
  * Used to create 10ms interval for use with the FAT FS
  * NOTE: In order to use this IRQ the function init_HC15C_OnTimerCounter0
  * must be previously called and set to an IRQ of 100us.  
  * STEP 1: Increment the 100us Timers
- * STEP 2: Increment the ms Counter - Create Audio Beep if Continunity Tone set
+ * STEP 2: Increment the ms Counter - Create Audio Beep if Continunity Tone set, set the meter log sample event
  * STEP 3: Increment the 500ms Counter 
- * STEP 4: Increment the 1s Counter: Take care of back light
+ * STEP 4: Increment the 1s Counter: Take care of back light, the idle and wait percent
  * STEP 5: Increment the 10ms Counter
  * STEP 6: Clear the IRQ
  **************************************************************************/
@@ -170,6 +314,9 @@ void TIMER0_IRQHandler(void)
  
  static uint8_t TimerFatFS_DiskIO;
  static BOOLEAN ToggleTone = 0;
+ static uint32_t IdleLast,
+                 DelayLast;
+ uint32_t Percent;
  
  // STEP 1
  TimerCounterA_100us++;
@@ -178,10 +325,8 @@ void TIMER0_IRQHandler(void)
  
  // STEP 2
  // EVERY 1 MILI-SECOND COUNTER
- // USED IN FUNCTION delayXms
  if(TimerCounterA_100us > 9)
    {
-   msCounter++;
    TimerCounterA_100us = 0;
    
     // USED IN OHM METER CONTINUNITY TO PRODUCE 2KHz TONE (T = 1ms + 1ms)
@@ -201,6 +346,38 @@ void TIMER0_IRQHandler(void)
        }
      ToggleTone = ~ToggleTone;
      }
+   
+   // METER RANGE PROBE - FROM A RANGE SWITCH TO THE FIRST READING ON THE NEW RANGE
+   if ((CalSettings.CalMode == METER_MODE) && (Meter.Status == START_MEASURE) && (Meter.Step != METER_STEADY) &&
+       (++Meter.ProbeTicks >= METER_PROBE_TIME))
+     {
+     Meter.ProbeTicks = 0;
+     ctl_events_set_clear(&CalEvents, EVENT_METER, 0);
+     }
+   
+   // OHMS SAMPLE TIME - THE CONTINUITY LATENCY IS A FEW OF THESE
+   if ((CalSettings.CalMode == OHMS_MODE) && (OHMS.Status == START_MEASURE) && (++OHMS.Ticks >= OHMS_SAMPLE_TIME))
+     {
+     OHMS.Ticks = 0;
+     ctl_events_set_clear(&CalEvents, EVENT_OHMS, 0);
+     }
+   
+   // METER LOG SAMPLE TIME - IF THE METER TASK HAS NOT TAKEN THE LAST SAMPLE THIS ONE IS MISSED
+   if ((MeterLog.On) && (++MeterLog.Ticks >= MeterLog.SampleTime))
+     {
+     MeterLog.Ticks = 0;
+     if (CalEvents & EVENT_LOG)
+       MeterLog.Missed++;
+     else
+       ctl_events_set_clear(&CalEvents, EVENT_LOG, 0);
+     }
+   
+   // METER STREAM SAMPLE TIME - THE PACKET CARRIES THE TIME OF EACH SAMPLE, ONE NOT TAKEN IS SKIPPED
+   if ((MeterStream.On) && (++MeterStream.Ticks >= MeterStream.SampleTime))
+     {
+     MeterStream.Ticks = 0;
+     ctl_events_set_clear(&CalEvents, EVENT_STREAM, 0);
+     }
    }
  
  // STEP 3
@@ -221,6 +398,14 @@ void TIMER0_IRQHandler(void)
    if (BackLightTimer < 0xFF)
       BackLightTimer++;
    ctl_events_set_clear(&CalEvents, EVENT_BAT_Q, 0);
+   // A SECOND IS 1000 TICKS OF SYSTICK LOAD + 1 COUNTS - THE PERCENT IN 32 BITS, CLAMPED, THEN TO 8
+   Percent = (IdleCycles - IdleLast) / (10 * (SysTick->LOAD + 1));
+   IdlePercent = (uint8_t)MIN(Percent, 100);
+   IdleLast = IdleCycles;
+   // TASKS CAN DELAY AT ONCE - THE OLD BUSY WAIT DID THEM ONE AFTER THE OTHER, SO THE SUM IS ITS CPU
+   Percent = (DelayTicks - DelayLast) / 10;
+   WaitPercent = (uint8_t)MIN(Percent, 100);
+   DelayLast = DelayTicks;
    TimerCounterC_100us = 0;
    }
  
@@ -303,9 +488,10 @@ void init_HC15C_OnTimerCounter1(uint32_t TimeInMicoSeconds)
  * accordance with the passed value to init_HC15C_OnTimerCounter1.  This is set to be
  * a 100ms timer event
  * STEP 1: Set the stop watch (SWAT) event
- * STEP 2: Set the Meter event (measure voltage at terminal)
- * STEP 3: Set the OHMs event (measure ohms at terminal)
- * STEP 5: Clear the Timer IRQ
+ * STEP 2: Set the Meter event (measure voltage at terminal) each Meter.UpdateTicks.  In scope mode
+ * each tick: the meter task shows a capture when it is done and arms the next
+ * STEP 3: Clear the Timer IRQ
+ * NOTE: The OHMs event (measure ohms at terminal) is set by timer 0 each OHMS_SAMPLE_TIME
  **************************************************************************/
 void TIMER1_IRQHandler(void)
  {
@@ -317,18 +503,17 @@ void TIMER1_IRQHandler(void)
    }
  
  // STEP 2
- if ((CalSettings.CalMode == METER_MODE) && (Meter.Status == START_MEASURE))
+ if ((CalSettings.CalMode == METER_MODE) && (Meter.Status == START_MEASURE) && (++Meter.Ticks >= Meter.UpdateTicks))
    {
+   Meter.Ticks = 0;
    ctl_events_set_clear(&CalEvents, EVENT_METER, 0);
    }
- 
-  // STEP 3
- if ((CalSettings.CalMode == OHMS_MODE) && (OHMS.Status == START_MEASURE))
+ if ((CalSettings.CalMode == SCOPE_MODE) && (Scope.Status == START_MEASURE))
    {
-   ctl_events_set_clear(&CalEvents, EVENT_OHMS, 0);
+   ctl_events_set_clear(&CalEvents, EVENT_METER, 0);
    }
-   
- // STEP 4
+ 
+ // STEP 3
  TIM_ClearIntPending(LPC_TIM1, TIM_MR0_INT);
   
  } // END OF FUNCTION TIMER1_IRQHandler
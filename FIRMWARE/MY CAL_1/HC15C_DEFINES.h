@@ -4,7 +4,7 @@
  * Description:   Project definitions and hardware pin assignments
  * Author:        Hab S. Collector
  * Date:          07/03/11
- * LAST EDIT:     7/19/2012 
+ * LAST EDIT:     10/19/2026 
  * Hardware:      PCB-HC15C REV2
  * Firmware Tool: Rowley CrossStudio 
  ******************************************************************/ 
@@ -23,6 +23,8 @@ typedef unsigned short int uint16_t;  // 2 bytes 0 to 65535
 typedef signed short int int16_t;     // 2 bytes -32767 to 32767 
 typedef unsigned long int uint32_t;   // 4 bytes 0 to 4294967295 
 typedef signed long int int32_t;      // 4 bytes -2147483647 to 2147483647 
+typedef unsigned long long int uint64_t;  // 8 bytes 0 to 18446744073709551615
+typedef signed long long int int64_t;     // 8 bytes -9223372036854775807 to 9223372036854775807
 /*
 #ifndef BOOLEAN
   #ifdef FALSE 
@@ -58,6 +60,15 @@ enum PORT_NUMBERS
 // USED IN INT ROUNDING
 #define ROUNDING 0.5
 
+// AHB SRAM: 2 BANKS OF 16KB OUTSIDE THE 32KB OF MAIN RAM.  HC15C_PLACEMENT.xml LINKS .ahb_bank0 AT 0x2007C000
+// AND .ahb_bank1 AT 0x20080000 - NEITHER IS ZEROED AT RESET, WHAT IS PLACED THERE IS SET BY ITS INIT
+#define AHB_BANK0  __attribute__ ((section(".ahb_bank0")))
+#define AHB_BANK1  __attribute__ ((section(".ahb_bank1")))
+#define AHB_BANK_SIZE  0x4000
+// SCRATCH POOL: ONE BLOCK OF BANK 1 SHARED BY BIG, THE MATRICES AND BATCH - THEY NEVER RUN TOGETHER.  SEE
+// call_ScratchClaim
+#define SCRATCH_POOL_SIZE  4096
+
 // DEFINE THE HARDWARE BY PORT ASSIGMENTS
 // LED INTERFACE - CAL STATUS DISPLAY
 #define LED_USB    ((uint32_t)(1<<18))      // P1.18 USB CONNECT
@@ -109,6 +120,12 @@ enum PORT_NUMBERS
 #define EVENT_MAINT         ((uint16_t)(1<<12))
 #define EVENT_MUSIC_LIST    ((uint16_t)(1<<13))
 #define EVENT_SETUP         ((uint16_t)(1<<14))
+#define EVENT_PROGRAM       ((uint16_t)(1<<15))
+#define EVENT_TAPE          ((uint32_t)(1<<16))  // CTL EVENT SETS ARE 32 BITS
+#define EVENT_LOG           ((uint32_t)(1<<17))
+#define EVENT_LOG_WRITE     ((uint32_t)(1<<18))
+#define EVENT_STREAM        ((uint32_t)(1<<19))
+#define EVENT_LOG_OPEN      ((uint32_t)(1<<20))
 // MESSAGE QUEUES
 #define MAX_TOUCH_MSG       20
 #define MAX_AUDIO_MSG       20
@@ -121,6 +138,7 @@ enum TASKING_IRQ_PRIORITY
   EINT2_IRQ_PRIORITY,      // TOUCH CH A IRQ
   TIMER2_IRQ_PRIORITY,     // AUDIO PLAYBACK TIMER
   TIMER0_IRQ_PRIORITY,     // GENERIC TIMER HAS MULTIPLE USES  
+  DMA_IRQ_PRIORITY,        // ADC SCAN - HALF OF THE SAMPLE RING IN
   EINT0_IRQ_PRIORITY,      // EXTERNAL WAKE FROM SLEEP IRQ
   RTC_IRQ_PRIORITY,        // RTC IRQ FOR CLOCK
   TIMER1_IRQ_PRIORITY      // USED WITH OHMS & VOLT METER TO UPDATE READOUT // CLOCK TO UPDATE TIME
@@ -5,7 +5,7 @@
  * messages between the calculator and the HC15C Win App.  
  * Author:          Hab S. Collector
  * Date:            12/31/11
- * LAST EDIT:       7/06/2012
+ * LAST EDIT:       10/19/2026
  * Hardware:        NXP LPC1769
  * Firmware Tool:   CrossStudio for ARM
  * Notes:           This file should be written as to not be dependent on other includes.
@@ -81,6 +81,55 @@ void createTX_Buffer(const uint8_t LoadBuffer[], uint8_t LoadBufferSize, uint8_t
 
 
 
+/*************************************************************************
+ * Function Name: encodeVarint
+ * Parameters: uint32_t, uint8_t *
+ * Return: uint8_t - the bytes written (1 to MAX_VARINT_SIZE)
+ *
+ * Description: Writes the passed value to the passed buffer as a varint: 7 bits a byte, low
+ * bits first, bit 7 set on every byte but the last.  A value under 128 is one byte.
+ * STEP 1: Write 7 bits with the continue bit while more than 7 bits remain
+ * STEP 2: Write the last byte
+ *************************************************************************/
+uint8_t encodeVarint(uint32_t Value, uint8_t *Buffer)
+{
+	uint8_t Length = 0;
+
+	// STEP 1
+	while (Value >= 0x80)
+	{
+		Buffer[Length++] = (uint8_t)(Value | 0x80);
+		Value >>= 7;
+	}
+
+	// STEP 2
+	Buffer[Length++] = (uint8_t)Value;
+	return(Length);
+
+} // END OF encodeVarint
+
+
+
+
+/*************************************************************************
+ * Function Name: encodeZigZag
+ * Parameters: int32_t
+ * Return: uint32_t
+ *
+ * Description: Maps a signed value to unsigned so that a small change of either sign is a short
+ * varint: 0, -1, 1, -2 ... become 0, 1, 2, 3 ...  The receiver undoes it with (n >> 1) ^ -(n & 1).
+ * STEP 1: Shift the value up one and flip all bits of a negative value
+ *************************************************************************/
+uint32_t encodeZigZag(int32_t Value)
+{
+	// STEP 1
+	return(((uint32_t)Value << 1) ^ (uint32_t)(Value >> 31));
+
+} // END OF encodeZigZag
+
+
+
+
 /************************************************************************************************************************/
 /******************************************COMMON SUPPORT ROUTINES*******************************************************/
 /************************************************************************************************************************/
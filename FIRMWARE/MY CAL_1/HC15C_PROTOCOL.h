@@ -5,7 +5,7 @@
  * The HC15C protocol allows communication between the HC15C and the HC15C Win App
  * Author:            Hab S. Collector
  * Date:              12/31/2011
- * LAST EDIT:         7/07/2012
+ * LAST EDIT:         10/19/2026
  * Hardware:               
  * Firmware Tool:     CrossStudio for ARM
  * Notes:             This file should be written as to not be dependent 
@@ -51,8 +51,8 @@
 #define TYPE_VOLT		0xF1 // FOR THE TRANSFER OF VOLT READING
 #define TYPE_OHMS		0xF2 // FOR THE TRANSFER OF OHM VALUE READING
 #define TYPE_TIME 	0xF3 // ENABLES THE WIN APP TO SET THE HC15C TIME AND DATE
-#define TYPE_TBD1		0xF4 // TBD - FUTURE USE
-#define TYPE_TBD3		0xF5 // TBD - FUTURE USE
+#define TYPE_STREAM		0xF4 // FOR THE TRANSFER OF A BATCH OF VOLT OR OHM READINGS (SEE BELOW)
+#define TYPE_SCOPE		0xF5 // FOR THE TRANSFER OF A SCOPE CAPTURE (SEE BELOW)
 #define TYPE_TBD4		0xF0 // TBD - FUTURE USE
 
 // PROTOCOL INDEX AND SIZE
@@ -62,6 +62,30 @@
 #define RX_PAYLOAD_INDEX        3
 #define MAX_PACKET_SIZE_HC15C		0xFE
 
+// TYPE_STREAM PAYLOAD: A HEADER THEN Count SAMPLES AS FIXED POINT VALUES (VALUE * 10^Scale).  THE
+// FIRST SAMPLE IS A ZIGZAG VARINT OF THE VALUE, EACH SAMPLE AFTER IT A VARINT OF THE ms SINCE THE
+// SAMPLE BEFORE IT THEN A ZIGZAG VARINT OF THE CHANGE IN VALUE.  VARINTS ARE 7 BITS A BYTE, LOW
+// BITS FIRST, BIT 7 SET ON ALL BUT THE LAST BYTE.  ZIGZAG MAPS 0, -1, 1, -2 ... TO 0, 1, 2, 3 ...
+// A GAP IN THE SEQUENCE NUMBER IS A DROPPED PACKET
+#define STREAM_SEQ_INDEX        0     // uint16_t LITTLE ENDIAN - ONE UP EACH PACKET
+#define STREAM_METER_INDEX      2     // TYPE_VOLT OR TYPE_OHMS
+#define STREAM_SCALE_INDEX      3     // DECIMAL PLACES OF THE FIXED POINT VALUES
+#define STREAM_COUNT_INDEX      4     // SAMPLES IN THE PACKET
+#define STREAM_TIME_INDEX       5     // uint32_t LITTLE ENDIAN - ms TIME OF THE FIRST SAMPLE
+#define STREAM_HEADER_SIZE      9
+#define MAX_VARINT_SIZE         5     // BYTES OF A 32 BIT VARINT
+
+// TYPE_SCOPE PAYLOAD: THE HEADER OF A CAPTURE.  THE PACKET IS FOLLOWED BY THE RAW RING - Samples 32 BIT
+// WORDS LITTLE ENDIAN, EACH THE ADC GLOBAL DATA REGISTER AS READ: THE COUNT IS BITS 4 TO 15.  THE OLDEST
+// SAMPLE IS AT INDEX First, THE RING WRAPS AT Samples.  ALL VALUES LITTLE ENDIAN
+#define SCOPE_RATE_INDEX        0     // uint32_t - SAMPLES PER SECOND ACHIEVED
+#define SCOPE_SAMPLES_INDEX     4     // uint16_t - WORDS OF THE RING THAT FOLLOWS
+#define SCOPE_FIRST_INDEX       6     // uint16_t - RING INDEX OF THE OLDEST SAMPLE
+#define SCOPE_TRIGGER_INDEX     8     // uint16_t - RING INDEX OF THE TRIGGER SAMPLE
+#define SCOPE_LEVEL_INDEX       10    // uint16_t - TRIGGER LEVEL IN ADC COUNTS
+#define SCOPE_DIVIDER_INDEX     12    // float - FRONT END DIVIDER: VOLTS = COUNT / 4095 x 3.0 / DIVIDER
+#define SCOPE_HEADER_SIZE       16
+
 // MISC
 #define TEST_STRING "0007:0004:2012:0022:0010:0015" // 7/4/2012 10:10:15PM - USED FOR TESTING
 
@@ -96,6 +120,8 @@ void init_crc8(void);
 BOOLEAN check_packet_crc(uint8_t *, uint8_t);
 // TX PROTOTYPES
 void createTX_Buffer(const uint8_t *, uint8_t, uint8_t *, uint8_t);
+uint8_t encodeVarint(uint32_t, uint8_t *);
+uint32_t encodeZigZag(int32_t);
 // RX PROTOTYPES
 BOOLEAN parseDateTimeFromVCOM(uint8_t *, Type_DateTimeVCOM *);
 
@@ -0,0 +1,131 @@
+/*****************************************************************
+ *
+ * File name:       HOST_STUBS.C
+ * Description:     Host stand ins for the display, EEPROM, SD card, audio and CTL calls of the math path
+ * Author:          Hab S. Collector
+ * Date:            10/19/2026
+ * LAST EDIT:       10/19/2026
+ * Hardware:        Linux PC
+ * Firmware Tool:   gcc - see Makefile
+ * Notes:           Only for the host build of CORE, MATH, KERNEL, DECIMAL, INTEGER and COMPLEX.  The display
+ *                  calls do nothing (HostDisplay set: the text lines go to stdout), the SD card is not there
+ *                  (every f_* call is FR_NOT_READY), an audio message is taken and dropped, the EEPROM reads 0s.
+ *                  The other modes and tasks are not built - their mode end calls do nothing.
+ *****************************************************************/
+
+#define _POSIX_C_SOURCE 199309L              // clock_gettime - -std=c11 KEEPS glibc OFF ITS OWN intN_t TYPES
+#include <ctl_api.h>
+#include "CORE_FUNCTIONS.H"
+#include "PROGRAM_TASKS.H"
+#include "TOUCH_TASKS.H"
+#include "CLOCK_TASKS.H"
+#include "METER_TASKS.H"
+#include "LIST_TASKS.H"
+#include "SETUP_TASKS.H"
+#include "TIMERS_HC15C.H"
+#include "DIP204.H"
+#include "CAT24C02.H"
+#include "FAT_FS_INC/ff.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+
+// GLOBAL VARS
+// THE FIRMWARE GLOBALS OF THE FILES NOT BUILT ON THE HOST
+Type_Program Program;
+FRESULT FF_Result;
+CTL_MUTEX_t FatFsMutex;
+FIL FatFsFile;
+CTL_MESSAGE_QUEUE_t AudioQueue;
+CTL_MEMORY_AREA_t MemArea;
+uint32_t SystemCoreClock = 100000000;
+BOOLEAN HostDisplay = FALSE;                 // TRUE: THE DISPLAY TEXT TO stdout
+// TYPES
+static Type_AudioQueueStruct AudioMessage;   // THE ONE AUDIO MESSAGE - DROPPED ON POST
+
+
+
+
+// CTL
+CTL_TIME_t ctl_get_current_time(void)
+ {
+ struct timespec Now;
+ clock_gettime(CLOCK_MONOTONIC, &Now);
+ return((CTL_TIME_t)((Now.tv_sec * 1000) + (Now.tv_nsec / 1000000)));
+ }
+void ctl_timeout_wait(CTL_TIME_t Time) {}
+unsigned ctl_events_wait(int Type, CTL_EVENT_SET_t *Events, CTL_EVENT_SET_t Mask, int Timeout, CTL_TIME_t Time) { return(*Events & Mask); }
+void ctl_events_set_clear(CTL_EVENT_SET_t *Events, CTL_EVENT_SET_t Set, CTL_EVENT_SET_t Clear) { *Events = (*Events | Set) & ~Clear; }
+unsigned ctl_mutex_lock(CTL_MUTEX_t *Mutex, int Timeout, CTL_TIME_t Time) { Mutex->lock_count++; return(1); }
+void ctl_mutex_unlock(CTL_MUTEX_t *Mutex) { Mutex->lock_count--; }
+unsigned *ctl_memory_area_allocate(CTL_MEMORY_AREA_t *Area) { return((unsigned *)&AudioMessage); }
+void ctl_memory_area_free(CTL_MEMORY_AREA_t *Area, unsigned *Block) {}
+unsigned ctl_message_queue_post(CTL_MESSAGE_QUEUE_t *Queue, void *Message, int Timeout, CTL_TIME_t Time) { return(1); }
+void ctl_task_restore(CTL_TASK_t *Task) {}
+void ctl_task_remove(CTL_TASK_t *Task) {}
+void ctl_handle_error(CTL_ERROR_CODE_t Error)
+ {
+ fprintf(stderr, "ctl_handle_error %d\n", Error);
+ exit(2);
+ }
+
+
+// TIMERS - CYCLE_COUNT IS ns
+uint32_t call_HostCycleCount(void)
+ {
+ struct timespec Now;
+ clock_gettime(CLOCK_MONOTONIC, &Now);
+ return((uint32_t)((Now.tv_sec * 1000000000ULL) + Now.tv_nsec));
+ }
+void init_CycleCounter(void) {}
+void delayXms(uint32_t Delay) {}
+void delayXus(uint32_t Delay) {}
+void idleSleep(void) {}
+
+
+// DISPLAY
+void DIP204_txt_engine(uint8_t *Text, uint8_t Line, uint8_t Column, uint8_t Length)
+ {
+ if (HostDisplay)
+   printf("LCD %u.%u: %.*s\n", Line, Column, Length, Text);
+ }
+void DIP204_ICON_set(uint8_t Icon, uint8_t State) {}
+void DIP204_set_cursor(enum DIP204_CURSOR Cursor) {}
+void DIP204_clearDisplay(void) {}
+void DIP204_clearLine(uint8_t Line) {}
+void DIP204_cursorToXY(uint8_t Column, uint8_t Line) {}
+uint8_t DIP204_loadText(uint8_t *Text, uint8_t Length) { return(0); }
+
+
+// EEPROM
+void init_I2C1(uint32_t Rate) {}
+uint8_t CAT24C0X_write(uint8_t *Data, uint8_t Device, uint8_t Address, uint8_t Length) { return(0); }
+uint8_t CAT24C0X_read(uint8_t *Data, uint8_t Device, uint8_t Address, uint8_t Length)
+ {
+ memset(Data, 0, Length);
+ return(0);
+ }
+
+
+// SD CARD
+FRESULT f_open(FIL *File, const TCHAR *Path, BYTE Mode) { return(FR_NOT_READY); }
+FRESULT f_close(FIL *File) { return(FR_NOT_READY); }
+FRESULT f_write(FIL *File, const void *Data, UINT Length, UINT *Written)
+ {
+ *Written = 0;
+ return(FR_NOT_READY);
+ }
+
+
+// KEYS AND THE MODES NOT BUILT
+void select_All_Normal_Keys(void) {}
+void call_ClockModeEnd(void) {}
+void call_AlarmModeEnd(void) {}
+void call_SetupModeEnd(void) {}
+void call_SD_ListModeEnd(void) {}
+void call_MusicListModeEnd(void) {}
+void call_VoltMeterModeEnd(void) {}
+void call_OhmsMeterModeEnd(void) {}
+void call_ScopeModeEnd(void) {}
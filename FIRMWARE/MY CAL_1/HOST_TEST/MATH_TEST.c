@@ -0,0 +1,608 @@
+/*****************************************************************
+ *
+ * File name:       MATH_TEST.C
+ * Description:     Host regression of the math entry points against a long double reference
+ * Author:          Hab S. Collector
+ * Date:            10/19/2026
+ * LAST EDIT:       10/19/2026
+ * Hardware:        Linux PC
+ * Firmware Tool:   gcc - see Makefile
+ * Notes:           Each function is swept over its range through its call_* key entry with the value
+ *                  on the stack (line loaded), the same path as the key press.  The answer in X (and Y for
+ *                  R>P, P>R) is taken against the long double reference and the error is in ULP of the
+ *                  double answer.  Then the same points are timed for ops/sec - that is the full key, stack
+ *                  and number format included, on the host: compare runs, not the LPC1769.
+ *                  The exit is 1 if a function is over its ULP limit or an error case is wrong.
+ *****************************************************************/
+
+#define _POSIX_C_SOURCE 199309L              // clock_gettime
+#include <ctl_api.h>
+#include "CORE_FUNCTIONS.H"
+#include "MATH_FUNCTIONS.H"
+#include "DECIMAL_FUNCTIONS.H"
+#include "KERNEL_FUNCTIONS.H"
+#include "lpc_types.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+
+// DEFINES
+#define POINTS              4000             // POINTS PER FUNCTION
+#define TIMED_PASSES        5                // PASSES OVER THE POINTS FOR THE ops/sec
+#define DECIMAL_POINTS      100000           // RANDOM 13 DIGIT DECIMALS FOR THE CONVERSION CHECK
+#define FLOAT_ULP           536870912.0      // 2^29 - DOUBLE ULP IN A FLOAT ULP (24 BIT MANTISSA)
+#define ROUND_TIE_ULP       4                // call_DecimalRound: THE SCALE ERROR AT A HALF WAY POINT
+#define PI_L                3.141592653589793238462643383279502884L
+#define SWEEP_LINEAR        0                // X UNIFORM OVER LOW TO HIGH
+#define SWEEP_LOG           1                // |X| LOG UNIFORM OVER LOW TO HIGH
+#define SWEEP_LOG_SIGNED    2                // AS SWEEP_LOG WITH A RANDOM SIGN
+#define SWEEP_INTEGER       3                // THE INTEGERS LOW TO HIGH
+
+
+// ENUMERATED TYPES AND STRUCTURES
+typedef struct
+  {
+  uint8_t Sweep;
+  double Low;
+  double High;
+  } Type_Sweep;
+
+typedef struct
+  {
+  const char *Name;
+  void (*Entry)(void);                       // THE KEY ENTRY
+  uint8_t CalAngle;
+  uint8_t KernelMode;                        // SEE enum KERNEL_MODE - FAST: THE ULP ARE FLOAT ULP
+  Type_Sweep Y;                              // Y.High == 0: ONE ARGUMENT, Y NOT USED
+  Type_Sweep X;
+  long double (*Reference)(long double, long double, long double *);  // Y, X: X ANSWER - Y ANSWER TO THE POINTER
+  BOOLEAN TwoAnswers;                        // R>P, P>R: X AND Y ARE THE ANSWER
+  double UlpLimit;
+  } Type_MathTest;
+
+typedef struct
+  {
+  const char *Name;
+  void (*Entry)(void);
+  uint8_t CalAngle;
+  double Y;
+  double X;
+  BOOLEAN Error;                             // TRUE: A MATH ERROR - FALSE: EXACTLY Answer
+  double Answer;
+  } Type_MathCase;
+
+
+// PROTOTYPES
+static long double ref_Sin(long double, long double, long double *);
+static long double ref_Cos(long double, long double, long double *);
+static long double ref_Tan(long double, long double, long double *);
+static long double ref_SinDeg(long double, long double, long double *);
+static long double ref_CosDeg(long double, long double, long double *);
+static long double ref_TanDeg(long double, long double, long double *);
+static long double ref_Asin(long double, long double, long double *);
+static long double ref_Acos(long double, long double, long double *);
+static long double ref_Atan(long double, long double, long double *);
+static long double ref_Exp(long double, long double, long double *);
+static long double ref_Ln(long double, long double, long double *);
+static long double ref_TenToX(long double, long double, long double *);
+static long double ref_Log(long double, long double, long double *);
+static long double ref_Xsqr(long double, long double, long double *);
+static long double ref_Sqrt(long double, long double, long double *);
+static long double ref_OneOverX(long double, long double, long double *);
+static long double ref_YtoX(long double, long double, long double *);
+static long double ref_YtoOneOverX(long double, long double, long double *);
+static long double ref_Factorial(long double, long double, long double *);
+static long double ref_RtoP(long double, long double, long double *);
+static long double ref_RtoPDeg(long double, long double, long double *);
+static long double ref_PtoR(long double, long double, long double *);
+static long double ref_PtoRDeg(long double, long double, long double *);
+static double call_TestRandom(void);
+static double call_TestPoint(const Type_Sweep *, uint16_t);
+static double call_TestUlp(double, long double);
+static void call_TestEntry(void (*)(void), uint8_t, double, double);
+static double call_TestSeconds(void);
+static BOOLEAN call_TestFunction(const Type_MathTest *);
+static BOOLEAN call_TestCases(void);
+static BOOLEAN call_TestDecimal(void);
+
+
+// EXTERNS
+extern Type_Register RegisterValue[TOTAL_REGISTERS];
+extern Type_CalSettings CalSettings;
+extern BOOLEAN bln_LineLoaded;
+
+
+// GLOBAL VARS
+static uint64_t RandomState = 0x2545F4914F6CDD1DULL;
+static double TestY[POINTS],
+              TestX[POINTS];
+// TYPES
+static const Type_MathTest MathTest[] =
+  {
+  // NAME       ENTRY              ANGLE    KERNEL           Y                               X                                           REFERENCE         TWO    ULP
+  { "SIN",      call_sinX,         RADS,    KERNEL_ACCURATE, { 0 },                          { SWEEP_LINEAR, -10.0, 10.0 },              ref_Sin,          FALSE, 1.0 },
+  { "COS",      call_cosX,         RADS,    KERNEL_ACCURATE, { 0 },                          { SWEEP_LINEAR, -10.0, 10.0 },              ref_Cos,          FALSE, 1.5 },
+  { "TAN",      call_tanX,         RADS,    KERNEL_ACCURATE, { 0 },                          { SWEEP_LINEAR, -10.0, 10.0 },              ref_Tan,          FALSE, 2.5 },
+  { "SIN DEG",  call_sinX,         DEGREES, KERNEL_ACCURATE, { 0 },                          { SWEEP_LINEAR, -720.0, 720.0 },            ref_SinDeg,       FALSE, 1.5 },
+  { "COS DEG",  call_cosX,         DEGREES, KERNEL_ACCURATE, { 0 },                          { SWEEP_LINEAR, -720.0, 720.0 },            ref_CosDeg,       FALSE, 1.5 },
+  { "TAN DEG",  call_tanX,         DEGREES, KERNEL_ACCURATE, { 0 },                          { SWEEP_LINEAR, -720.0, 720.0 },            ref_TanDeg,       FALSE, 2.5 },
+  { "ASIN",     call_asinX,        RADS,    KERNEL_ACCURATE, { 0 },                          { SWEEP_LINEAR, -1.0, 1.0 },                ref_Asin,         FALSE, 1.0 },
+  { "ACOS",     call_acosX,        RADS,    KERNEL_ACCURATE, { 0 },                          { SWEEP_LINEAR, -1.0, 1.0 },                ref_Acos,         FALSE, 1.0 },
+  { "ATAN",     call_atanX,        RADS,    KERNEL_ACCURATE, { 0 },                          { SWEEP_LOG_SIGNED, 1.0E-3, 1.0E3 },        ref_Atan,         FALSE, 1.0 },
+  { "EXP",      call_eToX,         RADS,    KERNEL_ACCURATE, { 0 },                          { SWEEP_LINEAR, -700.0, 700.0 },            ref_Exp,          FALSE, 1.0 },
+  { "LN",       call_lnX,          RADS,    KERNEL_ACCURATE, { 0 },                          { SWEEP_LOG, 1.0E-300, 1.0E300 },           ref_Ln,           FALSE, 1.0 },
+  // THE FAST KERNELS OF A BATCH OR A STATISTICS PROGRAM - THE ULP ARE FLOAT ULP
+  { "SIN F",    call_sinX,         RADS,    KERNEL_FAST,     { 0 },                          { SWEEP_LINEAR, -10.0, 10.0 },              ref_Sin,          FALSE, 1.5 },
+  { "COS F",    call_cosX,         RADS,    KERNEL_FAST,     { 0 },                          { SWEEP_LINEAR, -10.0, 10.0 },              ref_Cos,          FALSE, 1.5 },
+  { "TAN F",    call_tanX,         RADS,    KERNEL_FAST,     { 0 },                          { SWEEP_LINEAR, -10.0, 10.0 },              ref_Tan,          FALSE, 2.5 },
+  { "SIN DG F", call_sinX,         DEGREES, KERNEL_FAST,     { 0 },                          { SWEEP_LINEAR, -720.0, 720.0 },            ref_SinDeg,       FALSE, 1.5 },
+  { "EXP F",    call_eToX,         RADS,    KERNEL_FAST,     { 0 },                          { SWEEP_LINEAR, -700.0, 700.0 },            ref_Exp,          FALSE, 1.5 },
+  { "LN F",     call_lnX,          RADS,    KERNEL_FAST,     { 0 },                          { SWEEP_LOG, 1.0E-300, 1.0E300 },           ref_Ln,           FALSE, 1.0 },
+  { "10^X",     call_10ToX,        RADS,    KERNEL_ACCURATE, { 0 },                          { SWEEP_LINEAR, -300.0, 300.0 },            ref_TenToX,       FALSE, 2.0 },
+  { "LOG",      call_logX,         RADS,    KERNEL_ACCURATE, { 0 },                          { SWEEP_LOG, 1.0E-300, 1.0E300 },           ref_Log,          FALSE, 1.0 },
+  { "X^2",      call_Xsqr,         RADS,    KERNEL_ACCURATE, { 0 },                          { SWEEP_LOG_SIGNED, 1.0E-150, 1.0E150 },    ref_Xsqr,         FALSE, 0.5 },
+  { "SQRT",     call_sqrtX,        RADS,    KERNEL_ACCURATE, { 0 },                          { SWEEP_LOG, 1.0E-300, 1.0E300 },           ref_Sqrt,         FALSE, 0.5 },
+  { "1/X",      call_OneOverX,     RADS,    KERNEL_ACCURATE, { 0 },                          { SWEEP_LOG_SIGNED, 1.0E-300, 1.0E300 },    ref_OneOverX,     FALSE, 0.5 },
+  { "Y^X",      call_YtoX,         RADS,    KERNEL_ACCURATE, { SWEEP_LOG, 1.0E-3, 1.0E3 },   { SWEEP_LINEAR, -40.0, 40.0 },              ref_YtoX,         FALSE, 1.0 },
+  { "Y^1/X",    call_YtoOneOverX,  RADS,    KERNEL_ACCURATE, { SWEEP_LOG, 1.0E-3, 1.0E3 },   { SWEEP_LOG_SIGNED, 0.1, 10.0 },            ref_YtoOneOverX,  FALSE, 1.5 },
+  { "X!",       call_Xfactorial,   RADS,    KERNEL_ACCURATE, { 0 },                          { SWEEP_LINEAR, 0.0, 170.0 },               ref_Factorial,    FALSE, 16.0 },  // THE LANCZOS SERIES IS GOOD TO ~7 ULP
+  { "X! NEG",   call_Xfactorial,   RADS,    KERNEL_ACCURATE, { 0 },                          { SWEEP_LINEAR, -20.0, 0.0 },               ref_Factorial,    FALSE, 16.0 },  // THE REFLECTION OF (-X)!
+  { "X! INT",   call_Xfactorial,   RADS,    KERNEL_ACCURATE, { 0 },                          { SWEEP_INTEGER, 0.0, 170.0 },              ref_Factorial,    FALSE, 0.5 },
+  { "R>P",      call_RtoP,         RADS,    KERNEL_ACCURATE, { SWEEP_LOG_SIGNED, 1.0E-3, 1.0E3 }, { SWEEP_LOG_SIGNED, 1.0E-3, 1.0E3 },   ref_RtoP,         TRUE,  1.0 },  // ALL 4 QUADRANTS
+  { "R>P DEG",  call_RtoP,         DEGREES, KERNEL_ACCURATE, { SWEEP_LOG_SIGNED, 1.0E-3, 1.0E3 }, { SWEEP_LOG_SIGNED, 1.0E-3, 1.0E3 },   ref_RtoPDeg,      TRUE,  2.0 },
+  { "P>R",      call_PtoR,         RADS,    KERNEL_ACCURATE, { SWEEP_LINEAR, -10.0, 10.0 },      { SWEEP_LOG_SIGNED, 1.0E-3, 1.0E3 },   ref_PtoR,         TRUE,  2.5 },  // THE KERNEL sin / cos ROUNDED BY THE R *
+  { "P>R DEG",  call_PtoR,         DEGREES, KERNEL_ACCURATE, { SWEEP_LINEAR, -720.0, 720.0 },    { SWEEP_LOG_SIGNED, 1.0E-3, 1.0E3 },   ref_PtoRDeg,      TRUE,  2.5 }
+  };
+
+// THE EDGES: EXACT ANSWERS AND THE MATH ERRORS
+static const Type_MathCase MathCase[] =
+  {
+  // NAME              ENTRY              ANGLE    Y     X        ERROR  ANSWER
+  { "SIN 180 DEG",     call_sinX,         DEGREES, 0.0,  180.0,   FALSE, 0.0 },
+  { "COS 90 DEG",      call_cosX,         DEGREES, 0.0,  90.0,    FALSE, 0.0 },
+  { "TAN 90 DEG",      call_tanX,         DEGREES, 0.0,  90.0,    TRUE,  0.0 },
+  { "ASIN 2",          call_asinX,        RADS,    0.0,  2.0,     TRUE,  0.0 },
+  { "LN 0",            call_lnX,          RADS,    0.0,  0.0,     TRUE,  0.0 },
+  { "LN -1",           call_lnX,          RADS,    0.0,  -1.0,    TRUE,  0.0 },
+  { "SQRT -1",         call_sqrtX,        RADS,    0.0,  -1.0,    TRUE,  0.0 },
+  { "1/0",             call_OneOverX,     RADS,    0.0,  0.0,     TRUE,  0.0 },
+  { "-3!",             call_Xfactorial,   RADS,    0.0,  -3.0,    TRUE,  0.0 },
+  { "171!",            call_Xfactorial,   RADS,    0.0,  171.0,   TRUE,  0.0 },
+  { "EXP 710",         call_eToX,         RADS,    0.0,  710.0,   TRUE,  0.0 },
+  { "2^10",            call_YtoX,         RADS,    2.0,  10.0,    FALSE, 1024.0 },
+  { "10^3",            call_10ToX,        RADS,    0.0,  3.0,     FALSE, 1000.0 },
+  { "LOG 1000",        call_logX,         RADS,    0.0,  1000.0,  FALSE, 3.0 },
+  { "P>R 90 DEG 2",    call_PtoR,         DEGREES, 90.0, 2.0,     FALSE, 0.0 },
+  { "P>R 180 DEG 2",   call_PtoR,         DEGREES, 180.0, 2.0,    FALSE, -2.0 },
+  { "R>P -3 0",        call_RtoP,         RADS,    0.0,  -3.0,    FALSE, 3.0 }
+  };
+
+
+
+
+/*************************************************************************
+ * Function Name: main
+ * Parameters:    void
+ * Return:        int
+ *
+ * Description: Each function of MathTest, the cases of MathCase and the decimal conversions.
+ * PASS and exit 0 only if all are in their limits.
+ * STEP 1: Functions, cases, decimal
+ *************************************************************************/
+int main(void)
+ {
+
+ uint8_t Index;
+ BOOLEAN Pass = TRUE;
+
+ // STEP 1
+ printf("%-8s %8s %12s %12s\n", "", "MAX ULP", "LIMIT", "ops/sec");
+ for (Index = 0; Index < (sizeof(MathTest) / sizeof(MathTest[0])); Index++)
+   Pass &= call_TestFunction(&MathTest[Index]);
+ Pass &= call_TestCases();
+ Pass &= call_TestDecimal();
+ printf("%s\n", Pass ? "PASS" : "FAIL");
+ return(Pass ? 0 : 1);
+
+ } // END OF main
+
+
+
+
+/*************************************************************************
+ * Function Name: call_TestFunction
+ * Parameters: const Type_MathTest *
+ * Return: BOOLEAN
+ *
+ * Description: Sweeps one function over its points through its key entry.  Each answer is
+ * taken against the reference in ULP, then the same points are timed.  Prints the max ULP and
+ * the ops/sec.  Returns FALSE if over the limit or a point showed a math error.  The keys run with
+ * the kernel mode of the test - a FAST error is in float ULP.
+ * STEP 1: The points and the kernel mode
+ * STEP 2: Each answer against the reference
+ * STEP 3: Timed
+ * STEP 4: Report
+ *************************************************************************/
+static BOOLEAN call_TestFunction(const Type_MathTest *Test)
+ {
+
+ uint16_t Point;
+ uint8_t Pass;
+ long double Reference,
+             ReferenceY;
+ double Ulp,
+        MaxUlp = 0.0,
+        WorstX = 0.0,
+        WorstY = 0.0,
+        Seconds;
+ uint16_t Errors = 0;
+
+ // STEP 1
+ for (Point = 0; Point < POINTS; Point++)
+   {
+   TestY[Point] = (Test->Y.High == 0.0) ? 0.0 : call_TestPoint(&Test->Y, Point);
+   TestX[Point] = call_TestPoint(&Test->X, Point);
+   }
+ CalSettings.KernelMode = Test->KernelMode;
+
+ // STEP 2
+ for (Point = 0; Point < POINTS; Point++)
+   {
+   call_TestEntry(Test->Entry, Test->CalAngle, TestY[Point], TestX[Point]);
+   if (CalSettings.CalError != NO_ERROR)
+     {
+     if (Errors++ == 0)
+       printf("%-8s MATH ERROR AT Y=%.17g X=%.17g\n", Test->Name, TestY[Point], TestX[Point]);
+     continue;
+     }
+   Reference = Test->Reference((long double)TestY[Point], (long double)TestX[Point], &ReferenceY);
+   Ulp = call_TestUlp(RegisterValue[0].NumericValue, Reference);
+   if (Test->TwoAnswers)
+     Ulp = fmax(Ulp, call_TestUlp(RegisterValue[1].NumericValue, ReferenceY));
+   if (Test->KernelMode == KERNEL_FAST)
+     Ulp /= FLOAT_ULP;
+   if (Ulp > MaxUlp)
+     {
+     MaxUlp = Ulp;
+     WorstY = TestY[Point];
+     WorstX = TestX[Point];
+     }
+   }
+
+ // STEP 3
+ Seconds = call_TestSeconds();
+ for (Pass = 0; Pass < TIMED_PASSES; Pass++)
+   for (Point = 0; Point < POINTS; Point++)
+     call_TestEntry(Test->Entry, Test->CalAngle, TestY[Point], TestX[Point]);
+ Seconds = call_TestSeconds() - Seconds;
+ CalSettings.KernelMode = KERNEL_ACCURATE;
+
+ // STEP 4
+ printf("%-8s %8.2f %12.2f %12.0f", Test->Name, MaxUlp, Test->UlpLimit, (POINTS * TIMED_PASSES) / Seconds);
+ if (MaxUlp > 0.0)
+   printf("   WORST Y=%.17g X=%.17g", WorstY, WorstX);
+ printf("%s\n", ((MaxUlp > Test->UlpLimit) || Errors) ? "   ** FAIL" : "");
+ return((MaxUlp <= Test->UlpLimit) && (Errors == 0));
+
+ } // END OF call_TestFunction
+
+
+
+
+/*************************************************************************
+ * Function Name: call_TestCases
+ * Parameters: void
+ * Return: BOOLEAN
+ *
+ * Description: The edges of the table MathCase: the exact answers must be exact and the
+ * math errors must show the error.  Prints each that is wrong.  Returns FALSE if any is wrong.
+ * STEP 1: Each case
+ *************************************************************************/
+static BOOLEAN call_TestCases(void)
+ {
+
+ uint8_t Index;
+ BOOLEAN Error,
+         Pass = TRUE;
+
+ // STEP 1
+ for (Index = 0; Index < (sizeof(MathCase) / sizeof(MathCase[0])); Index++)
+   {
+   call_TestEntry(MathCase[Index].Entry, MathCase[Index].CalAngle, MathCase[Index].Y, MathCase[Index].X);
+   Error = (CalSettings.CalError != NO_ERROR);
+   if ((Error != MathCase[Index].Error) || (!Error && (RegisterValue[0].NumericValue != MathCase[Index].Answer)))
+     {
+     printf("CASE %-14s GOT %s %.17g  ** FAIL\n", MathCase[Index].Name, Error ? "MATH ERROR" : "", RegisterValue[0].NumericValue);
+     Pass = FALSE;
+     }
+   }
+ printf("CASES    %u %s\n", (unsigned)(sizeof(MathCase) / sizeof(MathCase[0])), Pass ? "OK" : "** FAIL");
+ return(Pass);
+
+ } // END OF call_TestCases
+
+
+
+
+/*************************************************************************
+ * Function Name: call_TestDecimal
+ * Parameters: void
+ * Return: BOOLEAN
+ *
+ * Description: The decimal conversions against the C library.  A random 13 digit decimal
+ * to double must be the strtod of its text (the double nearest), and the 13 digit round of
+ * a random double must be the strtod of its printf to 13 digits.  The round scales in double, so
+ * a double within ROUND_TIE_ULP of a half way point may go either way - counted as a tie, not an
+ * error.  Then 0.1 + 0.2 in the decimal
+ * engine must be 0.3 - the point of decimal mode.  Returns FALSE on any difference.
+ * STEP 1: Decimal to double
+ * STEP 2: Round of a double
+ * STEP 3: Decimal mode
+ *************************************************************************/
+static BOOLEAN call_TestDecimal(void)
+ {
+
+ uint32_t Index,
+          ToDoubleErrors = 0,
+          RoundErrors = 0,
+          RoundTies = 0;
+ uint8_t Digit;
+ Type_Decimal Decimal;
+ char Text[32];
+ double Value,
+        Neighbour,
+        Answer;
+ BOOLEAN Pass;
+
+ // STEP 1
+ for (Index = 0; Index < DECIMAL_POINTS; Index++)
+   {
+   Decimal.Negative = (call_TestRandom() < 0.5);
+   Decimal.Exponent = (int16_t)(call_TestRandom() * 616.0) - 308;
+   Decimal.Mantissa = 0;
+   Text[0] = Decimal.Negative ? '-' : '+';
+   for (Digit = 0; Digit < 13; Digit++)
+     {
+     uint8_t Value = (uint8_t)(call_TestRandom() * 10.0);
+     if ((Digit == 0) && (Value == 0))
+       Value = 1;
+     Decimal.Mantissa = (Decimal.Mantissa << 4) | Value;
+     Text[(Digit == 0) ? 1 : (Digit + 2)] = '0' + Value;
+     }
+   Text[2] = '.';
+   sprintf(&Text[15], "E%d", Decimal.Exponent);
+   if ((Answer = call_DecimalToDouble(&Decimal)) != strtod(Text, NULL))
+     {
+     if (ToDoubleErrors++ == 0)
+       printf("DECIMAL %s GOT %.17g\n", Text, Answer);
+     }
+   }
+
+ // STEP 2
+ for (Index = 0; Index < DECIMAL_POINTS; Index++)
+   {
+   Value = call_TestPoint(&(Type_Sweep){ SWEEP_LOG_SIGNED, 1.0E-300, 1.0E300 }, 0);
+   sprintf(Text, "%.12E", Value);
+   if ((Answer = call_DecimalRound(Value)) == strtod(Text, NULL))
+     continue;
+   // THE 13 DIGITS OF A DOUBLE A FEW ULP AWAY: A TIE
+   Neighbour = Value;
+   for (Digit = 0; Digit < ROUND_TIE_ULP; Digit++)
+     Neighbour = nextafter(Neighbour, (Answer > Value) ? INFINITY : -INFINITY);
+   sprintf(Text, "%.12E", Neighbour);
+   if (Answer == strtod(Text, NULL))
+     RoundTies++;
+   else if (RoundErrors++ == 0)
+     printf("ROUND %.17g GOT %.17g\n", Value, Answer);
+   }
+
+ // STEP 3
+ Answer = call_DecimalOperation(DECIMAL_ADD, 0.1, 0.2);
+ Pass = (ToDoubleErrors == 0) && (RoundErrors == 0) && (Answer == 0.3);
+ printf("DECIMAL  TO DOUBLE %lu/%u WRONG  ROUND %lu/%u WRONG %lu TIES  0.1+0.2=%.13g  %s\n", (unsigned long)ToDoubleErrors,
+        DECIMAL_POINTS, (unsigned long)RoundErrors, DECIMAL_POINTS, (unsigned long)RoundTies, Answer, Pass ? "OK" : "** FAIL");
+ return(Pass);
+
+ } // END OF call_TestDecimal
+
+
+
+
+/*************************************************************************
+ * Function Name: call_TestEntry
+ * Parameters: void (*)(void), uint8_t, double, double
+ * Return: void
+ *
+ * Description: One key press: Y and X on the stack (line loaded), base 10 binary math in the
+ * angle given, no error shown.  Then the key entry.
+ * STEP 1: The stack and the settings
+ * STEP 2: The key
+ *************************************************************************/
+static void call_TestEntry(void (*Entry)(void), uint8_t CalAngle, double Y, double X)
+ {
+
+ // STEP 1
+ RegisterValue[1].NumericValue = Y;
+ RegisterValue[0].NumericValue = X;
+ bln_LineLoaded = TRUE;
+ CalSettings.CalError = NO_ERROR;
+ CalSettings.CalBase = BASE_10;
+ CalSettings.CalAngle = CalAngle;
+ CalSettings.DecimalMath = FALSE;
+
+ // STEP 2
+ Entry();
+
+ } // END OF call_TestEntry
+
+
+
+
+/*************************************************************************
+ * Function Name: call_TestUlp
+ * Parameters: double, long double
+ * Return: double
+ *
+ * Description: The error of an answer in ULP of the double nearest the reference.  A zero
+ * reference must be answered with exactly 0.
+ * STEP 1: Error in ULP
+ *************************************************************************/
+static double call_TestUlp(double Answer, long double Reference)
+ {
+
+ double Nearest = fabs((double)Reference);
+
+ // STEP 1
+ if (Nearest == 0.0)
+   return((Answer == 0.0) ? 0.0 : INFINITY);
+ return((double)(fabsl((long double)Answer - Reference) / (long double)(nextafter(Nearest, INFINITY) - Nearest)));
+
+ } // END OF call_TestUlp
+
+
+
+
+/*************************************************************************
+ * Function Name: call_TestPoint
+ * Parameters: const Type_Sweep *, uint16_t
+ * Return: double
+ *
+ * Description: A point of the sweep.  Random over the range (fixed seed - the same points
+ * each run) or the integers in turn.
+ * STEP 1: The point by sweep type
+ *************************************************************************/
+static double call_TestPoint(const Type_Sweep *Sweep, uint16_t Point)
+ {
+
+ double Value;
+
+ // STEP 1
+ switch (Sweep->Sweep)
+   {
+   case SWEEP_INTEGER:
+     return(Sweep->Low + fmod((double)Point, Sweep->High - Sweep->Low + 1.0));
+   case SWEEP_LOG:
+   case SWEEP_LOG_SIGNED:
+     Value = exp(log(Sweep->Low) + (call_TestRandom() * (log(Sweep->High) - log(Sweep->Low))));
+     if ((Sweep->Sweep == SWEEP_LOG_SIGNED) && (call_TestRandom() < 0.5))
+       Value = -Value;
+     return(Value);
+   default:
+     return(Sweep->Low + (call_TestRandom() * (Sweep->High - Sweep->Low)));
+   }
+
+ } // END OF call_TestPoint
+
+
+
+
+/*************************************************************************
+ * Function Name: call_TestRandom
+ * Parameters: void
+ * Return: double
+ *
+ * Description: xorshift64* to a double in [0, 1)
+ * STEP 1: Next
+ *************************************************************************/
+static double call_TestRandom(void)
+ {
+
+ // STEP 1
+ RandomState ^= RandomState >> 12;
+ RandomState ^= RandomState << 25;
+ RandomState ^= RandomState >> 27;
+ return((double)((RandomState * 0x2545F4914F6CDD1DULL) >> 11) * 0x1.0p-53);
+
+ } // END OF call_TestRandom
+
+
+
+
+/*************************************************************************
+ * Function Name: call_TestSeconds
+ * Parameters: void
+ * Return: double
+ *
+ * Description: The host monotonic clock in seconds
+ * STEP 1: Now
+ *************************************************************************/
+static double call_TestSeconds(void)
+ {
+
+ struct timespec Now;
+
+ // STEP 1
+ clock_gettime(CLOCK_MONOTONIC, &Now);
+ return(Now.tv_sec + (Now.tv_nsec * 1.0E-9));
+
+ } // END OF call_TestSeconds
+
+
+
+
+// THE REFERENCES: long double - 11 BITS PAST THE DOUBLE.  THE DEGREES ARE FOLDED EXACTLY TO +-45 FIRST
+static long double ref_DegreeFold(long double X, int *Quadrant)
+ {
+ long double Fold = fmodl(X, 360.0L);
+ long double Quarter = rintl(Fold / 90.0L);
+ *Quadrant = ((int)Quarter) & 3;
+ return((Fold - (Quarter * 90.0L)) * (PI_L / 180.0L));
+ }
+static long double ref_Sin(long double Y, long double X, long double *Y_Answer) { return(sinl(X)); }
+static long double ref_Cos(long double Y, long double X, long double *Y_Answer) { return(cosl(X)); }
+static long double ref_Tan(long double Y, long double X, long double *Y_Answer) { return(tanl(X)); }
+static long double ref_SinDeg(long double Y, long double X, long double *Y_Answer)
+ {
+ int Quadrant;
+ long double Angle = ref_DegreeFold(X, &Quadrant);
+ switch (Quadrant)
+   {
+   case 0:  return(sinl(Angle));
+   case 1:  return(cosl(Angle));
+   case 2:  return(-sinl(Angle));
+   default: return(-cosl(Angle));
+   }
+ }
+static long double ref_CosDeg(long double Y, long double X, long double *Y_Answer) { return(ref_SinDeg(Y, X + 90.0L, Y_Answer)); }
+static long double ref_TanDeg(long double Y, long double X, long double *Y_Answer)
+ {
+ int Quadrant;
+ long double Angle = ref_DegreeFold(X, &Quadrant);
+ return((Quadrant & 1) ? (-1.0L / tanl(Angle)) : tanl(Angle));
+ }
+static long double ref_Asin(long double Y, long double X, long double *Y_Answer) { return(asinl(X)); }
+static long double ref_Acos(long double Y, long double X, long double *Y_Answer) { return(acosl(X)); }
+static long double ref_Atan(long double Y, long double X, long double *Y_Answer) { return(atanl(X)); }
+static long double ref_Exp(long double Y, long double X, long double *Y_Answer) { return(expl(X)); }
+static long double ref_Ln(long double Y, long double X, long double *Y_Answer) { return(logl(X)); }
+static long double ref_TenToX(long double Y, long double X, long double *Y_Answer) { return(powl(10.0L, X)); }
+static long double ref_Log(long double Y, long double X, long double *Y_Answer) { return(log10l(X)); }
+static long double ref_Xsqr(long double Y, long double X, long double *Y_Answer) { return(X * X); }
+static long double ref_Sqrt(long double Y, long double X, long double *Y_Answer) { return(sqrtl(X)); }
+static long double ref_OneOverX(long double Y, long double X, long double *Y_Answer) { return(1.0L / X); }
+static long double ref_YtoX(long double Y, long double X, long double *Y_Answer) { return(powl(Y, X)); }
+static long double ref_YtoOneOverX(long double Y, long double X, long double *Y_Answer) { return(powl(Y, 1.0L / X)); }
+static long double ref_Factorial(long double Y, long double X, long double *Y_Answer) { return(tgammal(X + 1.0L)); }
+static long double ref_RtoP(long double Y, long double X, long double *Y_Answer)
+ {
+ *Y_Answer = atan2l(Y, X);
+ return(hypotl(X, Y));
+ }
+static long double ref_RtoPDeg(long double Y, long double X, long double *Y_Answer)
+ {
+ *Y_Answer = atan2l(Y, X) * (180.0L / PI_L);
+ return(hypotl(X, Y));
+ }
+static long double ref_PtoR(long double Y, long double X, long double *Y_Answer)
+ {
+ *Y_Answer = X * sinl(Y);
+ return(X * cosl(Y));
+ }
+static long double ref_PtoRDeg(long double Y, long double X, long double *Y_Answer)
+ {
+ *Y_Answer = X * ref_SinDeg(0.0L, Y, NULL);
+ return(X * ref_CosDeg(0.0L, Y, NULL));
+ }
@@ -0,0 +1,74 @@
+/*****************************************************************
+ *
+ * File name:         ctl_api.h
+ * Description:       Host stand in for the CrossWorks CTL API - the types and the calls the math path
+ *                    uses.  The bodies are in HOST_STUBS.c
+ * Author:            Hab S. Collector
+ * Date:              10/19/2026
+ * LAST EDIT:         10/19/2026
+ * Hardware:          Linux PC
+ * Firmware Tool:     gcc
+ * Notes:             There are no tasks on the host: the events are a word, a mutex is a count and the
+ *                    time is the host monotonic clock in ms
+*****************************************************************/
+
+#ifndef _HOST_CTL_API
+#define _HOST_CTL_API
+
+
+// DEFINES
+#define CTL_TIMEOUT_NONE            0
+#define CTL_TIMEOUT_INFINITE        0
+#define CTL_TIMEOUT_ABSOLUTE        1
+#define CTL_TIMEOUT_DELAY           2
+#define CTL_EVENT_WAIT_ANY_EVENTS   0
+#define CTL_EVENT_WAIT_ALL_EVENTS   1
+#define CTL_STATE_RUNNABLE          0x00
+#define CTL_STATE_SUSPENDED         0x80
+#define CTL_UNSPECIFIED_ERROR       0
+
+
+// ENUMERATED TYPES AND STRUCTURES
+typedef unsigned long CTL_TIME_t;
+typedef unsigned long CTL_EVENT_SET_t;
+typedef int CTL_ERROR_CODE_t;
+
+typedef struct
+  {
+  unsigned char state;
+  unsigned char priority;
+  const char *name;
+  } CTL_TASK_t;
+
+typedef struct
+  {
+  void **q;
+  unsigned s;
+  } CTL_MESSAGE_QUEUE_t;
+
+typedef struct
+  {
+  unsigned lock_count;
+  } CTL_MUTEX_t;
+
+typedef struct
+  {
+  void *head;
+  } CTL_MEMORY_AREA_t;
+
+
+// PROTOTYPES
+CTL_TIME_t ctl_get_current_time(void);
+void ctl_timeout_wait(CTL_TIME_t);
+unsigned ctl_events_wait(int, CTL_EVENT_SET_t *, CTL_EVENT_SET_t, int, CTL_TIME_t);
+void ctl_events_set_clear(CTL_EVENT_SET_t *, CTL_EVENT_SET_t, CTL_EVENT_SET_t);
+unsigned ctl_mutex_lock(CTL_MUTEX_t *, int, CTL_TIME_t);
+void ctl_mutex_unlock(CTL_MUTEX_t *);
+unsigned *ctl_memory_area_allocate(CTL_MEMORY_AREA_t *);
+void ctl_memory_area_free(CTL_MEMORY_AREA_t *, unsigned *);
+unsigned ctl_message_queue_post(CTL_MESSAGE_QUEUE_t *, void *, int, CTL_TIME_t);
+void ctl_handle_error(CTL_ERROR_CODE_t);
+void ctl_task_restore(CTL_TASK_t *);
+void ctl_task_remove(CTL_TASK_t *);
+
+#endif
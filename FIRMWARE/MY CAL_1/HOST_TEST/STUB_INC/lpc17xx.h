@@ -0,0 +1,2 @@
+/* HOST: THE CMSIS FILE IS LPC17xx.h */
+#include "LPC17xx.h"
@@ -0,0 +1 @@
+/* HOST: THE INTEGER TYPES ARE THOSE OF HC15C_DEFINES.h */
@@ -0,0 +1,252 @@
+/*****************************************************************
+ *
+ * File name:       TAPE_VIEW.C
+ * Description:     Host viewer of the tape journal HC15C_TAPE.CSV - see TAPE_TASKS.c
+ * Author:          Hab S. Collector
+ * Date:            10/19/2026
+ * LAST EDIT:       10/19/2026
+ * Hardware:        Linux PC
+ * Firmware Tool:   gcc - see Makefile
+ * Notes:           TAPE_VIEW [-s SESSION] [-k KEY] FILE
+ *                  Each record is n,hh:mm:ss,KEY B20 R,<X>.  The record number starts at 1 each time the
+ *                  tape is turned on, so a 1 starts a session.  A record the power cut short, a number out of
+ *                  order or a time that goes back is shown and counted.  A hex X (base 2 and 16) is also
+ *                  shown in decimal.  The exit is 1 if the file cannot be read or a record is bad.
+ *****************************************************************/
+
+#include "TAPE_TASKS.H"
+#include "lpc_types.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+// DEFINES
+#define TAPE_LINE_LENGTH    (2 * TAPE_RECORD_LENGTH)  // A LINE LONGER THAN THIS IS BAD
+#define ALL_SESSIONS        0
+#define HALF_DAY            (12UL * 3600UL)          // SECONDS
+
+
+// ENUMERATED TYPES AND STRUCTURES
+typedef struct
+  {
+  uint32_t Number;                           // SINCE THE TAPE WAS TURNED ON
+  uint32_t Seconds;                          // OF THE DAY
+  char Time[9];
+  char Key[TAPE_LINE_LENGTH];
+  char X[TAPE_LINE_LENGTH];
+  } Type_TapeRecord;
+
+typedef struct
+  {
+  uint32_t Session;
+  uint32_t Records;
+  uint32_t Errors;                           // X IS ERROR
+  uint32_t Bad;                              // NOT A RECORD, OUT OF ORDER OR BACK IN TIME
+  uint32_t LastNumber;
+  uint32_t LastSeconds;
+  char FirstTime[9];
+  char LastTime[9];
+  } Type_TapeSession;
+
+
+// PROTOTYPES
+static BOOLEAN call_TapeParse(char *, Type_TapeRecord *);
+static void call_TapeSessionEnd(const Type_TapeSession *, BOOLEAN);
+
+
+
+
+/*************************************************************************
+ * Function Name: main
+ * Parameters:    int, char *[]
+ * Return:        int
+ *
+ * Description: Reads the tape a line at a time.  Each record is checked against the one before
+ * it in its session and shown if its session and key are asked for, then the line of the session.
+ * STEP 1: The arguments and the file
+ * STEP 2: Each line to its record - a 1 is a new session
+ * STEP 3: In order and in time
+ * STEP 4: Show the record
+ * STEP 5: The last session
+ *************************************************************************/
+int main(int argc, char *argv[])
+ {
+
+ FILE *File;
+ char Line[TAPE_LINE_LENGTH + 2];
+ const char *FileName = NULL,
+            *KeyFilter = NULL;
+ uint32_t SessionFilter = ALL_SESSIONS,
+          LineNumber = 0,
+          Sessions = 0,
+          Bad = 0;
+ int Argument;
+ BOOLEAN Shown;
+ Type_TapeRecord Record;
+ Type_TapeSession Session;
+
+ // STEP 1
+ for (Argument = 1; Argument < argc; Argument++)
+   {
+   if ((strcmp(argv[Argument], "-s") == 0) && (Argument + 1 < argc))
+     SessionFilter = strtoul(argv[++Argument], NULL, 10);
+   else if ((strcmp(argv[Argument], "-k") == 0) && (Argument + 1 < argc))
+     KeyFilter = argv[++Argument];
+   else
+     FileName = argv[Argument];
+   }
+ if (FileName == NULL)
+   {
+   fprintf(stderr, "TAPE_VIEW [-s SESSION] [-k KEY] FILE\n");
+   return(1);
+   }
+ if ((File = fopen(FileName, "rb")) == NULL)
+   {
+   perror(FileName);
+   return(1);
+   }
+
+ // STEP 2
+ memset(&Session, 0, sizeof(Session));
+ while (fgets(Line, sizeof(Line), File) != NULL)
+   {
+   LineNumber++;
+   if ((LineNumber == 1) && (strncmp(Line, TAPE_HEADER, strlen(TAPE_HEADER) - 2) == 0))
+     continue;
+   Shown = (SessionFilter == ALL_SESSIONS) || (SessionFilter == Session.Session);
+   if (!call_TapeParse(Line, &Record))
+     {
+     Session.Bad++;
+     Bad++;
+     Line[strcspn(Line, "\r\n")] = '\0';
+     if (Shown)
+       printf("LINE %lu NOT A RECORD: %s\n", (unsigned long)LineNumber, Line);
+     continue;
+     }
+   if ((Record.Number == 1) || (Session.Session == 0))
+     {
+     if (Session.Session != 0)
+       call_TapeSessionEnd(&Session, Shown);
+     memset(&Session, 0, sizeof(Session));
+     Session.Session = ++Sessions;
+     strcpy(Session.FirstTime, Record.Time);
+     Session.LastNumber = Record.Number - 1;
+     Session.LastSeconds = Record.Seconds;
+     }
+
+   // STEP 3
+   Shown = (SessionFilter == ALL_SESSIONS) || (SessionFilter == Session.Session);
+   if (Record.Number != Session.LastNumber + 1)
+     {
+     Session.Bad++;
+     Bad++;
+     if (Shown)
+       printf("LINE %lu RECORD %lu AFTER %lu\n", (unsigned long)LineNumber, (unsigned long)Record.Number,
+              (unsigned long)Session.LastNumber);
+     }
+   // BACK MORE THAN HALF A DAY IS PAST MIDNIGHT
+   if ((Record.Seconds < Session.LastSeconds) && ((Session.LastSeconds - Record.Seconds) < HALF_DAY))
+     {
+     Session.Bad++;
+     Bad++;
+     if (Shown)
+       printf("LINE %lu TIME %s BEFORE THE LAST RECORD\n", (unsigned long)LineNumber, Record.Time);
+     }
+   Session.LastNumber = Record.Number;
+   Session.LastSeconds = Record.Seconds;
+   strcpy(Session.LastTime, Record.Time);
+   Session.Records++;
+   if (strcmp(Record.X, "ERROR") == 0)
+     Session.Errors++;
+
+   // STEP 4
+   if ((!Shown) || ((KeyFilter != NULL) && (strcmp(KeyFilter, Record.Key) != 0)))
+     continue;
+   printf("%3lu %6lu  %s  %-12s %s", (unsigned long)Session.Session, (unsigned long)Record.Number, Record.Time,
+          Record.Key, Record.X);
+   if (strncmp(Record.X, "0x", 2) == 0)
+     printf("  (%llu)", strtoull(Record.X, NULL, 16));
+   printf("\n");
+   }
+ // STEP 5
+ if (Session.Session != 0)
+   call_TapeSessionEnd(&Session, (SessionFilter == ALL_SESSIONS) || (SessionFilter == Session.Session));
+ fclose(File);
+ return(Bad ? 1 : 0);
+
+ } // END OF main
+
+
+
+
+/*************************************************************************
+ * Function Name: call_TapeParse
+ * Parameters: char *, Type_TapeRecord *
+ * Return: BOOLEAN
+ *
+ * Description: One line of the tape to its record.  FALSE if the line is not a whole record:
+ * no CR LF at the end (the power was cut before the commit), a field missing, a number or time
+ * that is not one.
+ * STEP 1: A whole line
+ * STEP 2: Number and time
+ * STEP 3: Key and X
+ *************************************************************************/
+static BOOLEAN call_TapeParse(char *Line, Type_TapeRecord *Record)
+ {
+
+ char *Key,
+      *X,
+      *End;
+ unsigned Hour,
+          Minute,
+          Second;
+ size_t Length = strlen(Line);
+
+ // STEP 1
+ if ((Length < 2) || (strcmp(&Line[Length - 2], "\r\n") != 0))
+   return(FALSE);
+ Line[Length - 2] = '\0';
+
+ // STEP 2
+ Record->Number = strtoul(Line, &End, 10);
+ if ((End == Line) || (*End != ',') || (Record->Number == 0))
+   return(FALSE);
+ if ((sscanf(End + 1, "%2u:%2u:%2u", &Hour, &Minute, &Second) != 3) || (Hour > 23) || (Minute > 59) || (Second > 59))
+   return(FALSE);
+ sprintf(Record->Time, "%02u:%02u:%02u", Hour, Minute, Second);
+ Record->Seconds = (Hour * 3600) + (Minute * 60) + Second;
+
+ // STEP 3
+ if (((Key = strchr(End + 1, ',')) == NULL) || ((X = strchr(Key + 1, ',')) == NULL))
+   return(FALSE);
+ *X = '\0';
+ strcpy(Record->Key, Key + 1);
+ strcpy(Record->X, X + 1);
+ return((Record->Key[0] != '\0') && (Record->X[0] != '\0'));
+
+ } // END OF call_TapeParse
+
+
+
+
+/*************************************************************************
+ * Function Name: call_TapeSessionEnd
+ * Parameters: const Type_TapeSession *, BOOLEAN
+ * Return: void
+ *
+ * Description: The line of a session: its records, the time it ran, the records with X ERROR
+ * and the bad records
+ * STEP 1: Show if the session is shown
+ *************************************************************************/
+static void call_TapeSessionEnd(const Type_TapeSession *Session, BOOLEAN Shown)
+ {
+
+ // STEP 1
+ if (!Shown)
+   return;
+ printf("SESSION %lu: %lu RECORDS %s - %s, %lu ERROR, %lu BAD\n\n", (unsigned long)Session->Session,
+        (unsigned long)Session->Records, Session->FirstTime, Session->LastTime, (unsigned long)Session->Errors,
+        (unsigned long)Session->Bad);
+
+ } // END OF call_TapeSessionEnd
@@ -0,0 +1,719 @@
+/*****************************************************************
+ *
+ * File name:       INTEGER_FUNCTIONS.C
+ * Description:     Functions used to support the integer (programmer) operations of the HC15C
+ * Author:          Hab S. Collector
+ * Date:            10/19/2026
+ * LAST EDIT:       10/19/2026
+ * Hardware:        NXP LPC1769
+ * Firmware Tool:   CrossStudio for ARM
+ * Notes:           This file should be written as to not be dependent on other includes.
+ *                  everything these functions need should be passed to them.
+ *                  It will be necessary to consult the reference documents and associated schematics to understand
+ *                  the operations of this firmware.
+ *                  In HEX mode (CalSettings.CalBase == BASE_16) the calculator is an integer calculator in the
+ *                  manner of the HP-16C.  The stack is held in RegisterValue[].IntegerValue masked to the word
+ *                  size (8, 16, 32 or 64 bits) and interpreted as 2's complement or unsigned.  Integer operations
+ *                  never touch the double value of the register.  The double (NumericValue) is kept only as a
+ *                  shadow for display, for STO / RCL and for the floating point functions - it is refreshed by
+ *                  call_FormatNumber.
+ *****************************************************************/
+
+#include "INTEGER_FUNCTIONS.H"
+#include "CORE_FUNCTIONS.H"
+#include "MATH_FUNCTIONS.H"
+#include "TIMERS_HC15C.H"
+#include "DIP204.H"
+#include "lpc_types.h"
+#include <string.h>
+#include <stdio.h>
+
+
+// GLOBAL VARS
+// TYPES
+// WORD SIZE BY CODE - SEE ENUM INT_WORD_SIZE
+static const uint8_t WordBits[] = {64, 32, 16, 8};
+static const uint64_t WordMask[] = {0xFFFFFFFFFFFFFFFFULL, 0x00000000FFFFFFFFULL, 0x000000000000FFFFULL, 0x00000000000000FFULL};
+static const uint8_t HexDigit[] = "0123456789ABCDEF";
+
+// EXTERN VARS
+extern uint8_t str_InputLine[MAX_DISPLAY_LENGTH];
+extern Type_Register RegisterValue[TOTAL_REGISTERS];
+extern Type_Numeric NumericValue;
+extern Type_CalSettings CalSettings;
+extern Type_MathErrorDisplay MathError;
+extern BOOLEAN bln_LineLoaded,
+               bln_IntegerResult;
+
+
+
+
+/*************************************************************************
+ * Function Name: call_IntWordBits
+ * Parameters: void
+ * Return: uint8_t
+ *
+ * Description: Returns the number of bits in the present integer word size
+ * STEP 1: Look up by word size code
+ *************************************************************************/
+ uint8_t call_IntWordBits(void)
+ {
+
+ // STEP 1
+ return(WordBits[CalSettings.WordSize & 0x03]);
+
+ } // END OF call_IntWordBits
+
+
+
+
+/*************************************************************************
+ * Function Name: call_IntWordMask
+ * Parameters: void
+ * Return: uint64_t
+ *
+ * Description: Returns the mask of the present integer word size.  Every integer
+ * result is and-ed with this mask before it is placed on the stack.
+ * STEP 1: Look up by word size code
+ *************************************************************************/
+ uint64_t call_IntWordMask(void)
+ {
+
+ // STEP 1
+ return(WordMask[CalSettings.WordSize & 0x03]);
+
+ } // END OF call_IntWordMask
+
+
+
+
+/*************************************************************************
+ * Function Name: call_IntSignExtend
+ * Parameters: uint64_t
+ * Return: int64_t
+ *
+ * Description: Returns the word as a signed 64 bit value.  In 2's complement mode
+ * the sign bit of the word is extended through the upper bits.  In unsigned mode
+ * the value is returned as is.
+ * STEP 1: Extend the sign if signed mode and the sign bit is set
+ *************************************************************************/
+ int64_t call_IntSignExtend(uint64_t Value)
+ {
+
+ uint64_t SignBit = (call_IntWordMask() >> 1) + 1;
+
+ // STEP 1
+ if ((CalSettings.IntSigned) && (Value & SignBit))
+   return((int64_t)(Value | ~call_IntWordMask()));
+ return((int64_t)Value);
+
+ } // END OF call_IntSignExtend
+
+
+
+
+/*************************************************************************
+ * Function Name: call_IntToDouble
+ * Parameters: uint64_t
+ * Return: double
+ *
+ * Description: Converts a word to double according to signed / unsigned mode.  Used
+ * only to load the double shadow of a register (display, STO, floating point functions).
+ * NOTE: A 64 bit word larger than 2^53 will lose its low bits in the shadow - the integer
+ * stack itself is not affected.
+ * STEP 1: Convert
+ *************************************************************************/
+ double call_IntToDouble(uint64_t Value)
+ {
+
+ // STEP 1
+ if (CalSettings.IntSigned)
+   return((double)call_IntSignExtend(Value));
+ return((double)Value);
+
+ } // END OF call_IntToDouble
+
+
+
+
+/*************************************************************************
+ * Function Name: call_IntFromDouble
+ * Parameters: double
+ * Return: uint64_t
+ *
+ * Description: Converts the result of a floating point function to a word.  The
+ * fraction is truncated.  Values beyond the range of the word are held at the max
+ * or min of the word.  In unsigned mode a negative value is loaded as its 2's complement
+ * bit pattern.
+ * STEP 1: Signed: hold to the range of the word
+ * STEP 2: Unsigned: hold to the range of the word
+ *************************************************************************/
+ uint64_t call_IntFromDouble(double Value)
+ {
+
+ uint64_t Mask = call_IntWordMask();
+ int64_t MaxSigned = (int64_t)(Mask >> 1);
+
+ // STEP 1
+ if (CalSettings.IntSigned)
+   {
+   if (Value >= (double)MaxSigned)
+     return((uint64_t)MaxSigned);
+   if (Value <= (double)(-MaxSigned - 1))
+     return((uint64_t)(-MaxSigned - 1) & Mask);
+   return((uint64_t)(int64_t)Value & Mask);
+   }
+
+ // STEP 2
+ if (Value >= (double)Mask)
+   return(Mask);
+ if (Value < 0.0)
+   {
+   if (Value <= (double)(-MaxSigned - 1))
+     return(0);
+   return((uint64_t)(int64_t)Value & Mask);
+   }
+ return((uint64_t)Value);
+
+ } // END OF call_IntFromDouble
+
+
+
+
+/*************************************************************************
+ * Function Name: call_IntFormat
+ * Parameters: uint64_t, uint8_t *
+ * Return: void
+ *
+ * Description: Formats a word as hex for display.  The hex digits are zero filled
+ * to the word size so the word size can be seen from the display (64 bits = 16 digits).
+ * Done by nibble so there is no dependence on printf long long support.
+ * STEP 1: Prefix
+ * STEP 2: Digits from the most significant nibble of the word
+ *************************************************************************/
+ void call_IntFormat(uint64_t Value, uint8_t *FormattedString)
+ {
+
+ uint8_t Digits = call_IntWordBits() / BITS_PER_HEX_DIGIT;
+
+ // STEP 1
+ *FormattedString++ = '0';
+ *FormattedString++ = 'x';
+
+ // STEP 2
+ for (int8_t Nibble = (Digits - 1); Nibble >= 0; Nibble--)
+   {
+   *FormattedString++ = HexDigit[(uint8_t)(Value >> (Nibble * BITS_PER_HEX_DIGIT)) & 0x0F];
+   }
+ *FormattedString = NULL_VALUE;
+
+ } // END OF call_IntFormat
+
+
+
+
+/*************************************************************************
+ * Function Name: call_IntLoadStack
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Loads the integer stack from the double stack.  Called when HEX mode
+ * is entered from a floating point mode.
+ * STEP 1: Convert each register
+ *************************************************************************/
+ void call_IntLoadStack(void)
+ {
+
+ // STEP 1
+ for (uint8_t RegCount = 0; RegCount < TOTAL_REGISTERS; RegCount++)
+   {
+   RegisterValue[RegCount].IntegerValue = call_IntFromDouble(RegisterValue[RegCount].NumericValue);
+   }
+ bln_IntegerResult = TRUE;
+
+ } // END OF call_IntLoadStack
+
+
+
+
+/*************************************************************************
+ * Function Name: call_IntChkAndDisplayDrop
+ * Parameters: uint64_t
+ * Return: void
+ *
+ * Description: The integer version of call_ChkAndDisplayDrop.  For operations that
+ * involve X and Y or input line and X.  Register 0 will have the result masked to the
+ * word size.  There is no result error to check for in integer math - it wraps.
+ * STEP 1: Update Reg 0 and drop the stack
+ *************************************************************************/
+ void call_IntChkAndDisplayDrop(uint64_t Ans)
+ {
+
+ // STEP 1
+ RegisterValue[0].IntegerValue = Ans & call_IntWordMask();
+ bln_IntegerResult = TRUE;
+ call_ProcessStackDown();
+
+ } // END OF call_IntChkAndDisplayDrop
+
+
+
+
+/*************************************************************************
+ * Function Name: call_IntChkAndDisplayRaise
+ * Parameters: uint64_t
+ * Return: void
+ *
+ * Description: The integer version of call_ChkAndDisplayRaise.  For operations that
+ * involve X or the input line.  If unloaded the stack is pushed up.  Register 0 will have
+ * the result masked to the word size.
+ * STEP 1: Raise stack if unloaded
+ * STEP 2: Update Reg 0 and display
+ *************************************************************************/
+ void call_IntChkAndDisplayRaise(uint64_t Ans)
+ {
+
+ // STEP 1
+ if (!bln_LineLoaded)
+   {
+   for (uint8_t RegCount = (TOTAL_REGISTERS - 1); RegCount > 0; RegCount--)
+     {
+     RegisterValue[RegCount].IntegerValue = RegisterValue[RegCount-1].IntegerValue;
+     RegisterValue[RegCount].Displayed = RegisterValue[RegCount-1].Displayed;
+     }
+   bln_LineLoaded = TRUE;
+   }
+
+ // STEP 2
+ RegisterValue[0].IntegerValue = Ans & call_IntWordMask();
+ RegisterValue[0].Displayed = TRUE;
+ bln_IntegerResult = TRUE;
+ call_FormatNumber();
+
+ } // END OF call_IntChkAndDisplayRaise
+
+
+
+
+/*************************************************************************
+ * Function Name: call_IntBinaryOp
+ * Parameters: uint8_t
+ * Return: void
+ *
+ * Description: Performs the integer operation on X and Y (loaded) or on the input line
+ * and X (unloaded).  As with the floating point functions Y is the first operand: Y - X, Y / X.
+ * Divide is signed or unsigned according to the sign mode.  All others are the same bit
+ * operation for either mode.
+ * STEP 1: Get the operands.  If unloaded check if valid number
+ * STEP 2: Check for divide by zero
+ * STEP 3: Perform the operation
+ * STEP 4: Check and Display the answer
+ *************************************************************************/
+ void call_IntBinaryOp(uint8_t Operation)
+ {
+
+ uint64_t ValueX,
+          ValueY,
+          TempAns = 0;
+
+ // STEP 1
+ if (!bln_LineLoaded)
+   {
+   if (call_IsNumericValue(str_InputLine, CalSettings.CalBase) == FALSE)
+     {
+     call_ShowEntryError();
+     return;
+     }
+   ValueX = NumericValue.IntegerValue;
+   ValueY = RegisterValue[0].IntegerValue;
+   }
+ else
+   {
+   ValueX = RegisterValue[0].IntegerValue;
+   ValueY = RegisterValue[1].IntegerValue;
+   }
+
+ // STEP 2
+ if ((Operation == INT_DIVIDE) && (ValueX == 0))
+   {
+   strcpy((char *)MathError.ErrorDescription,"Divide By 0");
+   strcpy((char *)MathError.ErrorSolution,"Causes infinity");
+   strcpy((char *)NumericValue.AudioErrorFileName, I_AND_I_ERROR_WAV);
+   NumericValue.AudioPlayLevel = BASIC_HELP;
+   call_ShowMathError();
+   return;
+   }
+
+ // STEP 3
+ switch(Operation)
+   {
+   case INT_ADD:
+     TempAns = ValueY + ValueX;
+   break;
+
+   case INT_SUBTRACT:
+     TempAns = ValueY - ValueX;
+   break;
+
+   case INT_MULTIPLY:
+     TempAns = ValueY * ValueX;
+   break;
+
+   case INT_DIVIDE:
+     // MIN / -1 OVERFLOWS A SIGNED DIVIDE - THE WRAPPED ANSWER IS MIN
+     if (CalSettings.IntSigned)
+       {
+       if (call_IntSignExtend(ValueX) == -1)
+         TempAns = 0 - ValueY;
+       else
+         TempAns = (uint64_t)(call_IntSignExtend(ValueY) / call_IntSignExtend(ValueX));
+       }
+     else
+       TempAns = ValueY / ValueX;
+   break;
+
+   case INT_AND:
+     TempAns = ValueY & ValueX;
+   break;
+
+   case INT_OR:
+     TempAns = ValueY | ValueX;
+   break;
+
+   case INT_XOR:
+     TempAns = ValueY ^ ValueX;
+   break;
+
+   default:
+   return;
+   }
+
+ // STEP 4
+ call_IntChkAndDisplayDrop(TempAns);
+
+ } // END OF call_IntBinaryOp
+
+
+
+
+/*************************************************************************
+ * Function Name: call_IntUnaryOp
+ * Parameters: uint8_t
+ * Return: void
+ *
+ * Description: Performs the integer operation on X (loaded) or the input line (unloaded).
+ * Shifts and rotates are by 1 bit within the word size.  Shift right is arithmetic
+ * (sign bit kept) in 2's complement mode and logical in unsigned mode.  Bit count
+ * returns the number of bits set in the word.
+ * STEP 1: Get the operand.  If unloaded check if valid number
+ * STEP 2: Perform the operation
+ * STEP 3: Check and Display the answer
+ *************************************************************************/
+ void call_IntUnaryOp(uint8_t Operation)
+ {
+
+ uint64_t Value,
+          TempAns = 0,
+          SignBit = (call_IntWordMask() >> 1) + 1;
+ uint8_t Bits = call_IntWordBits();
+
+ // STEP 1
+ if (!bln_LineLoaded)
+   {
+   if (call_IsNumericValue(str_InputLine, CalSettings.CalBase) == FALSE)
+     {
+     call_ShowEntryError();
+     return;
+     }
+   Value = NumericValue.IntegerValue;
+   }
+ else
+   Value = RegisterValue[0].IntegerValue;
+
+ // STEP 2
+ switch(Operation)
+   {
+   case INT_NOT:
+     TempAns = ~Value;
+   break;
+
+   case INT_NEGATE:
+     TempAns = 0 - Value;
+   break;
+
+   case INT_ABS:
+     if ((CalSettings.IntSigned) && (call_IntSignExtend(Value) < 0))
+       TempAns = 0 - Value;
+     else
+       TempAns = Value;
+   break;
+
+   case INT_SHIFT_LEFT:
+     TempAns = Value << 1;
+   break;
+
+   case INT_SHIFT_RIGHT:
+     TempAns = Value >> 1;
+     if ((CalSettings.IntSigned) && (Value & SignBit))
+       TempAns |= SignBit;
+   break;
+
+   case INT_ROTATE_LEFT:
+     TempAns = (Value << 1) | (Value >> (Bits - 1));
+   break;
+
+   case INT_ROTATE_RIGHT:
+     TempAns = (Value >> 1) | (Value << (Bits - 1));
+   break;
+
+   case INT_BIT_COUNT:
+     // CLEAR THE LOWEST SET BIT UNTIL NONE ARE LEFT
+     while (Value)
+       {
+       Value &= (Value - 1);
+       TempAns++;
+       }
+   break;
+
+   default:
+   return;
+   }
+
+ // STEP 3
+ call_IntChkAndDisplayRaise(TempAns);
+
+ } // END OF call_IntUnaryOp
+
+
+
+
+/*************************************************************************
+ * Function Name: call_IntWordSize
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Sets the integer word size from X (loaded) or the input line (unloaded).
+ * The size is read as keyed in decimal digits in any base (ie: in HEX mode key 8, 16, 32
+ * or 64 - not 0x40).  The stack is masked to the new word size.  The size value is consumed.
+ * STEP 1: Get the requested size - if unloaded check if valid number
+ * STEP 2: Map to the word size code - if not a valid size show error
+ * STEP 3: Drop the size value, mask the stack and display
+ *************************************************************************/
+ void call_IntWordSize(void)
+ {
+
+ uint64_t RequestedBits;
+
+ // STEP 1
+ if (!bln_LineLoaded)
+   {
+   if (call_IsNumericValue(str_InputLine, CalSettings.CalBase) == FALSE)
+     {
+     call_ShowEntryError();
+     return;
+     }
+   RequestedBits = (CalSettings.CalBase == BASE_16) ? NumericValue.IntegerValue : (uint64_t)NumericValue.Value;
+   }
+ else
+   RequestedBits = (CalSettings.CalBase == BASE_16) ? RegisterValue[0].IntegerValue : (uint64_t)RegisterValue[0].NumericValue;
+ // ALLOW THE HEX DIGITS OF THE SIZE TO BE READ AS DECIMAL: 0x10 = 16, 0x20 = 32...
+ if (CalSettings.CalBase == BASE_16)
+   RequestedBits = ((RequestedBits >> 4) * 10) + (RequestedBits & 0x0F);
+
+ // STEP 2
+ switch(RequestedBits)
+   {
+   case 8:
+     CalSettings.WordSize = WORD_SIZE_8;
+   break;
+
+   case 16:
+     CalSettings.WordSize = WORD_SIZE_16;
+   break;
+
+   case 32:
+     CalSettings.WordSize = WORD_SIZE_32;
+   break;
+
+   case 64:
+     CalSettings.WordSize = WORD_SIZE_64;
+   break;
+
+   default:
+     //                                   01234567890123456789
+     strcpy((char *)MathError.ErrorDescription, "Invalid word size");
+     strcpy((char *)MathError.ErrorSolution,    "Use 8 16 32 or 64");
+     strcpy((char *)NumericValue.AudioErrorFileName, I_AND_I_ERROR_WAV);
+     NumericValue.AudioPlayLevel = BASIC_HELP;
+     call_ShowMathError();
+     return;
+   }
+
+ // STEP 3
+ if (bln_LineLoaded)
+   {
+   for (uint8_t RegCount = 0; RegCount < (TOTAL_REGISTERS - 1); RegCount++)
+     {
+     RegisterValue[RegCount].IntegerValue = RegisterValue[RegCount+1].IntegerValue;
+     RegisterValue[RegCount].NumericValue = RegisterValue[RegCount+1].NumericValue;
+     RegisterValue[RegCount].Displayed = RegisterValue[RegCount+1].Displayed;
+     }
+   RegisterValue[TOTAL_REGISTERS-1].IntegerValue = 0;
+   RegisterValue[TOTAL_REGISTERS-1].NumericValue = 0.0;
+   RegisterValue[TOTAL_REGISTERS-1].Displayed = FALSE;
+   }
+ bln_LineLoaded = TRUE;
+ for (uint8_t RegCount = 0; RegCount < TOTAL_REGISTERS; RegCount++)
+   {
+   RegisterValue[RegCount].IntegerValue &= call_IntWordMask();
+   }
+ bln_IntegerResult = (CalSettings.CalBase == BASE_16);
+ call_FormatNumber();
+
+ } // END OF call_IntWordSize
+
+
+
+
+/*************************************************************************
+ * Function Name: call_IntSignMode
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Toggles the integer mode between 2's complement and unsigned.  The bits
+ * of the stack are not changed, only how they are read.  A message of the new mode is shown
+ * on the top line until the next key.
+ * STEP 1: Toggle
+ * STEP 2: Display
+ *************************************************************************/
+ void call_IntSignMode(void)
+ {
+
+ uint8_t LineText[MAX_DISPLAY_LENGTH + 1];
+
+ // STEP 1
+ CalSettings.IntSigned = !CalSettings.IntSigned;
+
+ // STEP 2
+ bln_IntegerResult = (CalSettings.CalBase == BASE_16);
+ call_FormatNumber();
+ //                      01234567890123456789
+ sprintf((char *)LineText, "%s %d BIT", (CalSettings.IntSigned ? "2'S COMP" : "UNSIGNED"), call_IntWordBits());
+ DIP204_clearLine(1);
+ DIP204_txt_engine(LineText, 1, 0, strlen((const char *)LineText));
+
+ } // END OF call_IntSignMode
+
+
+
+
+/*************************************************************************
+ * Function Name: call_IntBenchmark
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Measures the cost per operation of the integer stack math against
+ * the double (soft float) math that the stack used before.  Add, multiply and divide
+ * are each timed on the DWT cycle counter in batches, the loop overhead is removed and
+ * the fastest batch is kept so IRQ's and task switches do not count.  Results are shown
+ * in CPU cycles per operation until the next key:
+ * BENCH CYCLES/OP
+ * ADD D:xxxx I:xxxx
+ * MUL D:xxxx I:xxxx
+ * DIV D:xxxx I:xxxx
+ * NOTE: The stack and settings are not changed
+ * STEP 1: Time the loop overhead
+ * STEP 2: Time each operation on double and on 64 bit integer
+ * STEP 3: Display
+ *************************************************************************/
+ void call_IntBenchmark(void)
+ {
+
+ static const uint8_t OperationName[3][4] = {"ADD", "MUL", "DIV"};
+ volatile double DoubleA = 1234567.891,
+                 DoubleB = 3.217,
+                 DoubleAns;
+ volatile uint64_t IntA = 0x0123456789ABCDEFULL,
+                   IntB = 0x00000000DEADBEEFULL,
+                   IntAns;
+ uint32_t StartCount,
+          BatchCycles,
+          OverheadDouble = 0xFFFFFFFF,
+          OverheadInt = 0xFFFFFFFF,
+          CyclesDouble[3] = {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF},
+          CyclesInt[3] = {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF};
+ uint8_t LineText[MAX_DISPLAY_LENGTH + 1];
+
+ // STEP 1
+ init_CycleCounter();
+ for (uint8_t Batch = 0; Batch < BENCHMARK_BATCHES; Batch++)
+   {
+   StartCount = CYCLE_COUNT;
+   for (uint8_t Count = 0; Count < BENCHMARK_BATCH_SIZE; Count++)
+     DoubleAns = DoubleA;
+   BatchCycles = CYCLE_COUNT - StartCount;
+   if (BatchCycles < OverheadDouble)
+     OverheadDouble = BatchCycles;
+   StartCount = CYCLE_COUNT;
+   for (uint8_t Count = 0; Count < BENCHMARK_BATCH_SIZE; Count++)
+     IntAns = IntA;
+   BatchCycles = CYCLE_COUNT - StartCount;
+   if (BatchCycles < OverheadInt)
+     OverheadInt = BatchCycles;
+   }
+
+ // STEP 2
+ for (uint8_t Batch = 0; Batch < BENCHMARK_BATCHES; Batch++)
+   {
+   for (uint8_t Operation = 0; Operation < 3; Operation++)
+     {
+     StartCount = CYCLE_COUNT;
+     for (uint8_t Count = 0; Count < BENCHMARK_BATCH_SIZE; Count++)
+       {
+       if (Operation == 0)
+         DoubleAns = DoubleA + DoubleB;
+       else if (Operation == 1)
+         DoubleAns = DoubleA * DoubleB;
+       else
+         DoubleAns = DoubleA / DoubleB;
+       }
+     BatchCycles = CYCLE_COUNT - StartCount;
+     if (BatchCycles < CyclesDouble[Operation])
+       CyclesDouble[Operation] = BatchCycles;
+
+     StartCount = CYCLE_COUNT;
+     for (uint8_t Count = 0; Count < BENCHMARK_BATCH_SIZE; Count++)
+       {
+       if (Operation == 0)
+         IntAns = IntA + IntB;
+       else if (Operation == 1)
+         IntAns = IntA * IntB;
+       else
+         IntAns = IntA / IntB;
+       }
+     BatchCycles = CYCLE_COUNT - StartCount;
+     if (BatchCycles < CyclesInt[Operation])
+       CyclesInt[Operation] = BatchCycles;
+     }
+   }
+
+ // STEP 3
+ (void)DoubleAns;   // SINKS ONLY - VOLATILE SO THE TIMED MATH IS NOT REMOVED
+ (void)IntAns;
+ DIP204_set_cursor(CURSOR_OFF);
+ DIP204_clearDisplay();
+ //                      01234567890123456789
+ sprintf((char *)LineText, "BENCH CYCLES/OP");
+ DIP204_txt_engine(LineText, 1, 0, strlen((const char *)LineText));
+ for (uint8_t Operation = 0; Operation < 3; Operation++)
+   {
+   CyclesDouble[Operation] = (CyclesDouble[Operation] > OverheadDouble) ? (CyclesDouble[Operation] - OverheadDouble) : 0;
+   CyclesInt[Operation] = (CyclesInt[Operation] > OverheadInt) ? (CyclesInt[Operation] - OverheadInt) : 0;
+   CyclesDouble[Operation] = MIN((CyclesDouble[Operation] / BENCHMARK_BATCH_SIZE), BENCHMARK_SHOWN_MAX);
+   CyclesInt[Operation] = MIN((CyclesInt[Operation] / BENCHMARK_BATCH_SIZE), BENCHMARK_SHOWN_MAX);
+   snprintf((char *)LineText, sizeof(LineText), "%.*s D:%4lu I:%4lu", (int)sizeof(OperationName[0]), OperationName[Operation],
+            CyclesDouble[Operation], CyclesInt[Operation]);
+   DIP204_txt_engine(LineText, (Operation + 2), 0, strlen((const char *)LineText));
+   }
+
+ } // END OF call_IntBenchmark
@@ -0,0 +1,585 @@
+/*****************************************************************
+ *
+ * File name:       KERNEL_FUNCTIONS.C
+ * Description:     Math kernel layer for the transcendental functions of the HC15C
+ * Author:          Hab S. Collector
+ * Date:            10/19/2026
+ * LAST EDIT:       10/19/2026
+ * Hardware:        NXP LPC1769
+ * Firmware Tool:   CrossStudio for ARM
+ * Notes:           This file should be written as to not be dependent on other includes.
+ *                  everything these functions need should be passed to them.
+ *                  It will be necessary to consult the reference documents and associated schematics to understand
+ *                  the operations of this firmware.
+ *                  The LPC1769 has no FPU - every double op is a library call.  The kernels here do the
+ *                  range reduction once, in the unit of the angle, then evaluate a short minimax polynomial.
+ *                  Degrees are reduced mod 360 in degrees (fmod is exact) and folded to +/-45 degrees before
+ *                  the one conversion to radians - so 90, 180, 270... give exact 0 and 1 with no special case.
+ *                  ACCURATE mode polynomials are double (fdlibm kernels, < 1 ULP on +/-PI/4).
+ *                  FAST mode polynomials are single precision (Cephes kernels, about 7 digits) and cost far
+ *                  less in soft float.  In ACCURATE mode exp and ln are the library functions.
+ *                  The keys pass CalSettings.KernelMode: ACCURATE, but FAST while the program task runs a
+ *                  BATCH or a program that feeds SIGMA+ (see program_taskFn).
+ *****************************************************************/
+
+#include "KERNEL_FUNCTIONS.H"
+#include "CORE_FUNCTIONS.H"
+#include "TIMERS_HC15C.H"
+#include "DIP204.H"
+#include "lpc_types.h"
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+
+// GLOBAL VARS
+// TYPES
+// SIN ON +/-PI/4: x + x^3 * (S1 + x^2 * (S2 + ...)) - FDLIBM __kernel_sin
+static const double SinCoef[] =
+  {
+  -1.66666666666666324348E-1, 8.33333333332248946124E-3, -1.98412698298579493134E-4,
+  2.75573137070700676789E-6, -2.50507602534068634195E-8, 1.58969099521155010221E-10
+  };
+// COS ON +/-PI/4: 1 - x^2/2 + x^4 * (C1 + x^2 * (C2 + ...)) - FDLIBM __kernel_cos
+static const double CosCoef[] =
+  {
+  4.16666666666666019037E-2, -1.38888888888741095749E-3, 2.48015872894767294178E-5,
+  -2.75573143513906633035E-7, 2.08757232129817482790E-9, -1.13596475577881948265E-11
+  };
+// SINGLE PRECISION KERNELS - CEPHES sinf, cosf, expf, logf
+static const float SinCoefF[] = {-1.6666654611E-1F, 8.3321608736E-3F, -1.9515295891E-4F};
+static const float CosCoefF[] = {4.166664568298827E-2F, -1.388731625493765E-3F, 2.443315711809948E-5F};
+static const float ExpCoefF[] = {5.0000001201E-1F, 1.6666665459E-1F, 4.1665795894E-2F, 8.3334519073E-3F, 1.3981999507E-3F, 1.9875691500E-4F};
+static const float LnCoefF[] =
+  {
+  3.3333331174E-1F, -2.4999993993E-1F, 2.0000714765E-1F, -1.6668057665E-1F, 1.4249322787E-1F,
+  -1.2420140846E-1F, 1.1676998740E-1F, -1.1514610310E-1F, 7.0376836292E-2F
+  };
+static const uint8_t BenchName[KERNEL_FUNCTION_TOTAL][4] = {"S/C", "S/C", "TAN", "EXP", "LN "};
+
+// EXTERN VARS
+// NONE
+
+// PROTOTYPES LOCAL
+static uint8_t call_KernelReduce(double, uint8_t, double *);
+static double call_KernelSinPoly(double);
+static double call_KernelCosPoly(double);
+static float call_KernelSinPolyF(float);
+static float call_KernelCosPolyF(float);
+static double call_KernelBenchCall(uint8_t, double, uint8_t);
+
+
+
+
+/*************************************************************************
+ * Function Name: call_KernelReduce
+ * Parameters: double, uint8_t, double *
+ * Return: uint8_t
+ *
+ * Description: Reduces an angle to +/-PI/4 radians and the quadrant (0-3) that it came
+ * from.  Degrees: fmod 360 is exact, the 90 degree fold is exact (the operands are within a
+ * factor of 2) so the only rounding is the one conversion to radians.  Radians: Cody-Waite
+ * with PI/2 in 3 parts.  Returns 0xFF if the radian angle is too large to reduce this way.
+ * STEP 1: Degrees - reduce and fold in degrees then convert
+ * STEP 2: Radians - reduce by N * PI/2
+ *************************************************************************/
+ static uint8_t call_KernelReduce(double Angle, uint8_t AngleUnit, double *Reduced)
+ {
+
+ double Quadrant;
+
+ // STEP 1
+ if (AngleUnit == DEGREES)
+   {
+   Angle = fmod(Angle, 360.0);
+   Quadrant = rint(Angle / 90.0);
+   *Reduced = (Angle - (Quadrant * 90.0)) * KERNEL_DEG_TO_RAD;
+   return((uint8_t)((int32_t)Quadrant & 0x03));
+   }
+
+ // STEP 2
+ if (fabs(Angle) > KERNEL_MAX_REDUCE_RAD)
+   return(0xFF);
+ Quadrant = rint(Angle * KERNEL_INV_PIO2);
+ *Reduced = ((Angle - (Quadrant * KERNEL_PIO2_1)) - (Quadrant * KERNEL_PIO2_2)) - (Quadrant * KERNEL_PIO2_3);
+ return((uint8_t)((int32_t)Quadrant & 0x03));
+
+ } // END OF call_KernelReduce
+
+
+
+
+/*************************************************************************
+ * Function Name: call_KernelSinPoly
+ * Parameters: double
+ * Return: double
+ *
+ * Description: Double sin on +/-PI/4
+ * STEP 1: Polynomial in x^2
+ *************************************************************************/
+ static double call_KernelSinPoly(double X)
+ {
+
+ double Z = X * X,
+        Poly;
+
+ // STEP 1
+ Poly = SinCoef[1] + Z * (SinCoef[2] + Z * (SinCoef[3] + Z * (SinCoef[4] + Z * SinCoef[5])));
+ return(X + X * Z * (SinCoef[0] + Z * Poly));
+
+ } // END OF call_KernelSinPoly
+
+
+
+
+/*************************************************************************
+ * Function Name: call_KernelCosPoly
+ * Parameters: double
+ * Return: double
+ *
+ * Description: Double cos on +/-PI/4.  1 - x^2/2 is split so the small terms are
+ * added before the rounding of 1 - x^2/2 (as fdlibm)
+ * STEP 1: Polynomial in x^2
+ * STEP 2: Sum small terms first
+ *************************************************************************/
+ static double call_KernelCosPoly(double X)
+ {
+
+ double Z = X * X,
+        HalfZ = 0.5 * Z,
+        One_HalfZ = 1.0 - HalfZ,
+        Poly;
+
+ // STEP 1
+ Poly = Z * Z * (CosCoef[0] + Z * (CosCoef[1] + Z * (CosCoef[2] + Z * (CosCoef[3] + Z * (CosCoef[4] + Z * CosCoef[5])))));
+
+ // STEP 2
+ return(One_HalfZ + (((1.0 - One_HalfZ) - HalfZ) + Poly));
+
+ } // END OF call_KernelCosPoly
+
+
+
+
+/*************************************************************************
+ * Function Name: call_KernelSinPolyF
+ * Parameters: float
+ * Return: float
+ *
+ * Description: Single precision sin on +/-PI/4
+ * STEP 1: Polynomial in x^2
+ *************************************************************************/
+ static float call_KernelSinPolyF(float X)
+ {
+
+ float Z = X * X;
+
+ // STEP 1
+ return(((SinCoefF[2] * Z + SinCoefF[1]) * Z + SinCoefF[0]) * Z * X + X);
+
+ } // END OF call_KernelSinPolyF
+
+
+
+
+/*************************************************************************
+ * Function Name: call_KernelCosPolyF
+ * Parameters: float
+ * Return: float
+ *
+ * Description: Single precision cos on +/-PI/4
+ * STEP 1: Polynomial in x^2
+ *************************************************************************/
+ static float call_KernelCosPolyF(float X)
+ {
+
+ float Z = X * X;
+
+ // STEP 1
+ return(((CosCoefF[2] * Z + CosCoefF[1]) * Z + CosCoefF[0]) * Z * Z - 0.5F * Z + 1.0F);
+
+ } // END OF call_KernelCosPolyF
+
+
+
+
+/*************************************************************************
+ * Function Name: call_KernelSin
+ * Parameters: double, uint8_t, uint8_t
+ * Return: double
+ *
+ * Description: sin of the angle in the unit passed (DEGREES or RADS) to the accuracy of
+ * the mode passed (see enum KERNEL_MODE)
+ * STEP 1: Reduce - too large radian angles go to the library
+ * STEP 2: Select the kernel by quadrant.  Adding 0 clears a -0 result
+ *************************************************************************/
+ double call_KernelSin(double Angle, uint8_t AngleUnit, uint8_t Mode)
+ {
+
+ double Reduced,
+        Result;
+ uint8_t Quadrant;
+
+ // STEP 1
+ Quadrant = call_KernelReduce(Angle, AngleUnit, &Reduced);
+ if (Quadrant == 0xFF)
+   return(sin(Angle));
+
+ // STEP 2
+ if (Mode == KERNEL_FAST)
+   Result = (Quadrant & 0x01) ? call_KernelCosPolyF((float)Reduced) : call_KernelSinPolyF((float)Reduced);
+ else
+   Result = (Quadrant & 0x01) ? call_KernelCosPoly(Reduced) : call_KernelSinPoly(Reduced);
+ if (Quadrant & 0x02)
+   Result = -Result;
+ return(Result + 0.0);
+
+ } // END OF call_KernelSin
+
+
+
+
+/*************************************************************************
+ * Function Name: call_KernelCos
+ * Parameters: double, uint8_t, uint8_t
+ * Return: double
+ *
+ * Description: cos of the angle in the unit passed (DEGREES or RADS) to the accuracy of
+ * the mode passed (see enum KERNEL_MODE)
+ * STEP 1: Reduce - too large radian angles go to the library
+ * STEP 2: Select the kernel by quadrant.  Adding 0 clears a -0 result
+ *************************************************************************/
+ double call_KernelCos(double Angle, uint8_t AngleUnit, uint8_t Mode)
+ {
+
+ double Reduced,
+        Result;
+ uint8_t Quadrant;
+
+ // STEP 1
+ Quadrant = call_KernelReduce(Angle, AngleUnit, &Reduced);
+ if (Quadrant == 0xFF)
+   return(cos(Angle));
+
+ // STEP 2
+ if (Mode == KERNEL_FAST)
+   Result = (Quadrant & 0x01) ? call_KernelSinPolyF((float)Reduced) : call_KernelCosPolyF((float)Reduced);
+ else
+   Result = (Quadrant & 0x01) ? call_KernelSinPoly(Reduced) : call_KernelCosPoly(Reduced);
+ if ((Quadrant == 1) || (Quadrant == 2))
+   Result = -Result;
+ return(Result + 0.0);
+
+ } // END OF call_KernelCos
+
+
+
+
+/*************************************************************************
+ * Function Name: call_KernelTan
+ * Parameters: double, uint8_t, uint8_t
+ * Return: double
+ *
+ * Description: tan of the angle in the unit passed (DEGREES or RADS) to the accuracy of
+ * the mode passed (see enum KERNEL_MODE).  sin and cos of the one reduced angle.  At 90
+ * degrees (and repeats) cos is exactly 0 - the result is infinite and the caller shows
+ * the error
+ * STEP 1: Reduce - too large radian angles go to the library
+ * STEP 2: sin / cos in even quadrants, -cos / sin in odd
+ *************************************************************************/
+ double call_KernelTan(double Angle, uint8_t AngleUnit, uint8_t Mode)
+ {
+
+ double Reduced,
+        SinValue,
+        CosValue;
+ uint8_t Quadrant;
+
+ // STEP 1
+ Quadrant = call_KernelReduce(Angle, AngleUnit, &Reduced);
+ if (Quadrant == 0xFF)
+   return(tan(Angle));
+
+ // STEP 2
+ if (Mode == KERNEL_FAST)
+   {
+   SinValue = call_KernelSinPolyF((float)Reduced);
+   CosValue = call_KernelCosPolyF((float)Reduced);
+   }
+ else
+   {
+   SinValue = call_KernelSinPoly(Reduced);
+   CosValue = call_KernelCosPoly(Reduced);
+   }
+ if (Quadrant & 0x01)
+   return((-CosValue / SinValue) + 0.0);
+ return((SinValue / CosValue) + 0.0);
+
+ } // END OF call_KernelTan
+
+
+
+
+/*************************************************************************
+ * Function Name: call_KernelExp
+ * Parameters: double, uint8_t
+ * Return: double
+ *
+ * Description: e^x to the accuracy of the mode passed.  FAST: x = k*ln2 + r, |r| <= ln2/2,
+ * e^r by single precision polynomial, then scaled by 2^k in double so the range is that
+ * of a double (not float).
+ * STEP 1: ACCURATE - library
+ * STEP 2: FAST - Reduce by ln2 - out of double range goes to the library (inf / 0)
+ * STEP 3: FAST - Polynomial and scale
+ *************************************************************************/
+ double call_KernelExp(double Value, uint8_t Mode)
+ {
+
+ float Reduced,
+       Z,
+       Poly;
+ double Power2;
+
+ // STEP 1
+ if (Mode != KERNEL_FAST)
+   return(exp(Value));
+
+ // STEP 2
+ if ((Value > 709.0) || (Value < -745.0))
+   return(exp(Value));
+ Power2 = floor((Value * KERNEL_LOG2E) + 0.5);
+ Reduced = (float)(Value - (Power2 * (double)KERNEL_LN2_HI));
+ Reduced -= (float)Power2 * KERNEL_LN2_LO;
+
+ // STEP 3
+ Z = Reduced * Reduced;
+ Poly = (((((ExpCoefF[5] * Reduced + ExpCoefF[4]) * Reduced + ExpCoefF[3]) * Reduced + ExpCoefF[2]) * Reduced + ExpCoefF[1]) * Reduced + ExpCoefF[0]) * Z + Reduced + 1.0F;
+ return(ldexp((double)Poly, (int)Power2));
+
+ } // END OF call_KernelExp
+
+
+
+
+/*************************************************************************
+ * Function Name: call_KernelLn
+ * Parameters: double, uint8_t
+ * Return: double
+ *
+ * Description: ln(x) to the accuracy of the mode passed.  FAST: x = m * 2^e with m
+ * in [sqrt(1/2), sqrt(2)), ln(m) by single precision polynomial in (m - 1), e*ln2 added
+ * in 2 parts.  The split of x is in double so the range is that of a double.
+ * STEP 1: ACCURATE or not a normal positive value - library (gives the -inf / nan)
+ * STEP 2: FAST - Split and center the mantissa on 1
+ * STEP 3: FAST - Polynomial and add the exponent
+ *************************************************************************/
+ double call_KernelLn(double Value, uint8_t Mode)
+ {
+
+ double Split;
+ float Mantissa,
+       Z,
+       Poly;
+ int Exponent;
+
+ // STEP 1
+ if ((Mode != KERNEL_FAST) || (!(Value > 0.0)) || (isinf(Value)))
+   return(log(Value));
+
+ // STEP 2
+ // CENTER ON 1 BEFORE GOING TO FLOAT - (m - 1) IS EXACT IN DOUBLE, NOT AFTER m IS ROUNDED
+ Split = frexp(Value, &Exponent);
+ if (Split < KERNEL_SQRT_HALF)
+   {
+   Exponent--;
+   Mantissa = (float)((2.0 * Split) - 1.0);
+   }
+ else
+   Mantissa = (float)(Split - 1.0);
+
+ // STEP 3
+ Z = Mantissa * Mantissa;
+ Poly = LnCoefF[8];
+ for (int8_t Term = 7; Term >= 0; Term--)
+   Poly = (Poly * Mantissa) + LnCoefF[Term];
+ Poly *= Mantissa * Z;
+ Poly += (float)Exponent * KERNEL_LN2_LO;
+ Poly -= 0.5F * Z;
+ return((double)(Mantissa + Poly) + ((double)Exponent * (double)KERNEL_LN2_HI));
+
+ } // END OF call_KernelLn
+
+
+
+
+/*************************************************************************
+ * Function Name: call_KernelBenchCall
+ * Parameters: uint8_t, double, uint8_t
+ * Return: double
+ *
+ * Description: Calls the kernel function by enum KERNEL_FUNCTION.  For the benchmark
+ * only - angles are in radians so the library is a fair reference.
+ * STEP 1: Call
+ *************************************************************************/
+ static double call_KernelBenchCall(uint8_t Function, double Value, uint8_t Mode)
+ {
+
+ // STEP 1
+ switch(Function)
+   {
+   case KERNEL_SIN:
+   return(call_KernelSin(Value, RADS, Mode));
+
+   case KERNEL_COS:
+   return(call_KernelCos(Value, RADS, Mode));
+
+   case KERNEL_TAN:
+   return(call_KernelTan(Value, RADS, Mode));
+
+   case KERNEL_EXP:
+   return(call_KernelExp(Value, Mode));
+
+   case KERNEL_LN:
+   default:
+   return(call_KernelLn(Value, Mode));
+   }
+
+ } // END OF call_KernelBenchCall
+
+
+
+
+/*************************************************************************
+ * Function Name: call_KernelULP
+ * Parameters: double, double, uint8_t
+ * Return: uint32_t
+ *
+ * Description: Error of the result in units in the last place of the reference.  For
+ * FAST the unit is a float ULP (24 bit mantissa), for ACCURATE a double ULP (53 bit).
+ * Rounded up.
+ * STEP 1: ULP of the reference by its exponent
+ * STEP 2: Error in ULP
+ *************************************************************************/
+ uint32_t call_KernelULP(double Result, double Reference, uint8_t Mode)
+ {
+
+ int Exponent;
+ double ULP,
+        Error;
+
+ // STEP 1
+ if ((Reference == 0.0) || (isinf(Reference)) || (isnan(Reference)))
+   return(0);
+ frexp(Reference, &Exponent);
+ ULP = ldexp(1.0, (Exponent - ((Mode == KERNEL_FAST) ? 24 : 53)));
+
+ // STEP 2
+ Error = ceil(fabs(Result - Reference) / ULP);
+ if (Error > 99999.0)
+   return(99999);
+ return((uint32_t)Error);
+
+ } // END OF call_KernelULP
+
+
+
+
+/*************************************************************************
+ * Function Name: call_KernelBenchmark
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Measures each kernel in FAST and ACCURATE mode against the double library.
+ * Each function is swept over KERNEL_BENCH_POINTS values of its domain, the max error in
+ * ULP and the average CPU cycles per call (DWT cycle counter) are shown until the next key.
+ * sin and cos share a line (the worst of the two):
+ * S/C F<ulp>/<cyc> A<ulp>/<cyc>
+ * TAN F<ulp>/<cyc> A<ulp>/<cyc>
+ * EXP F<ulp>/<cyc> A<ulp>/<cyc>
+ * LN  F<ulp>/<cyc> A<ulp>/<cyc>
+ * NOTE: The stack and settings are not changed
+ * STEP 1: Sweep each function in each mode - ULP against the library and cycles
+ * STEP 2: Display
+ *************************************************************************/
+ void call_KernelBenchmark(void)
+ {
+
+ volatile double Result;
+ double Value,
+        Reference;
+ uint32_t StartCount,
+          ULP,
+          MaxULP[KERNEL_FUNCTION_TOTAL][2],
+          Cycles[KERNEL_FUNCTION_TOTAL][2];
+ uint8_t LineText[2 * MAX_DISPLAY_LENGTH],
+         Line;
+
+ // STEP 1
+ init_CycleCounter();
+ for (uint8_t Function = 0; Function < KERNEL_FUNCTION_TOTAL; Function++)
+   {
+   for (uint8_t Mode = KERNEL_ACCURATE; Mode <= KERNEL_FAST; Mode++)
+     {
+     MaxULP[Function][Mode] = 0;
+     Cycles[Function][Mode] = 0;
+     for (uint16_t Point = 0; Point < KERNEL_BENCH_POINTS; Point++)
+       {
+       // DOMAIN OF THE SWEEP - OFFSET SO NO POINT IS AN EXACT ZERO OF THE FUNCTION
+       switch(Function)
+         {
+         case KERNEL_TAN:
+           Value = -1.5 + ((3.0 * Point) / KERNEL_BENCH_POINTS) + 0.0123;
+           Reference = tan(Value);
+         break;
+
+         case KERNEL_EXP:
+           Value = -50.0 + ((100.0 * Point) / KERNEL_BENCH_POINTS) + 0.0123;
+           Reference = exp(Value);
+         break;
+
+         case KERNEL_LN:
+           Value = exp(-30.0 + ((60.0 * Point) / KERNEL_BENCH_POINTS) + 0.0123);
+           Reference = log(Value);
+         break;
+
+         default:
+           Value = -10.0 + ((20.0 * Point) / KERNEL_BENCH_POINTS) + 0.0123;
+           Reference = (Function == KERNEL_SIN) ? sin(Value) : cos(Value);
+         break;
+         }
+       StartCount = CYCLE_COUNT;
+       Result = call_KernelBenchCall(Function, Value, Mode);
+       Cycles[Function][Mode] += CYCLE_COUNT - StartCount;
+       ULP = call_KernelULP(Result, Reference, Mode);
+       if (ULP > MaxULP[Function][Mode])
+         MaxULP[Function][Mode] = ULP;
+       }
+     Cycles[Function][Mode] /= KERNEL_BENCH_POINTS;
+     }
+   }
+
+ // STEP 2
+ DIP204_set_cursor(CURSOR_OFF);
+ DIP204_clearDisplay();
+ for (uint8_t Function = KERNEL_COS; Function < KERNEL_FUNCTION_TOTAL; Function++)
+   {
+   // SIN AND COS SHARE THE FIRST LINE
+   if (Function == KERNEL_COS)
+     {
+     for (uint8_t Mode = KERNEL_ACCURATE; Mode <= KERNEL_FAST; Mode++)
+       {
+       if (MaxULP[KERNEL_SIN][Mode] > MaxULP[KERNEL_COS][Mode])
+         MaxULP[KERNEL_COS][Mode] = MaxULP[KERNEL_SIN][Mode];
+       if (Cycles[KERNEL_SIN][Mode] > Cycles[KERNEL_COS][Mode])
+         Cycles[KERNEL_COS][Mode] = Cycles[KERNEL_SIN][Mode];
+       }
+     }
+   Line = Function;
+   sprintf((char *)LineText, "%s F%lu/%lu A%lu/%lu", BenchName[Function],
+           MaxULP[Function][KERNEL_FAST], Cycles[Function][KERNEL_FAST],
+           MaxULP[Function][KERNEL_ACCURATE], Cycles[Function][KERNEL_ACCURATE]);
+   LineText[MAX_DISPLAY_LENGTH] = NULL_VALUE;
+   DIP204_txt_engine(LineText, Line, 0, strlen((const char *)LineText));
+   }
+
+ } // END OF call_KernelBenchmark
@@ -5,7 +5,7 @@
                     related functions of the HC15C
  * Author:          Hab S. Collector`
  * Date:            12/06/11
- * LAST EDIT:       7/21/2012 
+ * LAST EDIT:       10/19/2026
  * Hardware:        NXP LPC1769
  * Firmware Tool:   CrossStudio for ARM
  * Notes:           This file should be written as to not be dependent on other includes.
@@ -43,6 +43,7 @@ extern FATFS fs[1];
 extern FRESULT FF_Result;
 extern FILINFO FF_Status;
 extern DIR Directory;
+extern CTL_MUTEX_t FatFsMutex;
 
 
 
@@ -316,7 +317,7 @@ static FRESULT scan_files (char* path)
  * NOTE: The buffer does not sort the directories or file names in any order.  They are loaded
  * in the same manner they are read
  * STEP 1: Clear display and perform FAT FS house keeping on long file names
- * STEP 2: Open the root (0) Dir - If OK on open proceed
+ * STEP 2: Open the root (0) Dir - If OK on open proceed.  FatFsMutex is held to the end of the read
  * STEP 3: Read the directory until empty  
  * STEP 4: Check if dir read is a file or a sub dir.  Display sub dir within <Dir Name>
  * Also check if name is too long to be displayed on screen.  If so end file name as
@@ -345,6 +346,7 @@ void LoadSD_Dir(void)
     
   // STEP 2
   // OPEN ROOT AND VALIDATE
+  ctl_mutex_lock(&FatFsMutex, CTL_TIMEOUT_NONE, 0);
   FF_Result = f_opendir(&Directory, Path);                       
   if (FF_Result == FR_OK) 
   {
@@ -417,6 +419,7 @@ void LoadSD_Dir(void)
     // LOAD ARRAY VALUE TOTAL
     SD_List.NumberOfDirEntries = DirLineListing;
   }
+  ctl_mutex_unlock(&FatFsMutex);
   
   //f_mount(0, NULL);
   
@@ -534,7 +537,7 @@ void LoadSD_Dir(void)
  * NOTE: Only file names are loaded.  File names can be a max of MAX_FILE_NAME_LEN long
  * however this function does not limit as MAX_FILE_NAME_LEN (40) is thought to be long enough.
  * STEP 1: FAT FS HOUSE KEEPING FOR LONG FILE NAME
- * STEP 2: Open directory and read contents
+ * STEP 2: Open directory and read contents - FatFsMutex is held to the end of the read
  * STEP 3: If read file (only) add to music list and increment music list directory count
  **************************************************************************/  
  void LoadMusicDirListing(const uint8_t *MusicPath)
@@ -554,6 +557,7 @@ void LoadSD_Dir(void)
     
   // STEP 2
   // OPEN DIRECTORY AND VALIDATE
+  ctl_mutex_lock(&FatFsMutex, CTL_TIMEOUT_NONE, 0);
   FF_Result = f_opendir(&Directory, MusicPath);                       
   if (FF_Result == FR_OK) 
   {
@@ -589,6 +593,7 @@ void LoadSD_Dir(void)
      * STARTS AT 0.  THEREFORE AT ITS MAX SelectedFile WILL ALLWAYS BE 1 LESS THAN NumberOfDirEntries */
     Music_List.NumberOfDirEntries = DirLineListing;
   }
+  ctl_mutex_unlock(&FatFsMutex);
  
  } // END OF LoadMusicDirListing
 
@@ -0,0 +1,502 @@
+/*****************************************************************
+ *
+ * File name:       LOG_TASKS.C
+ * Description:     The meter log - timestamped volt or ohm samples of the meter task to a file on the SD card
+ * Author:          Hab S. Collector
+ * Date:            10/19/2026
+ * LAST EDIT:       10/19/2026
+ * Hardware:        NXP LPC1769
+ * Firmware Tool:   CrossStudio for ARM
+ * Notes:           This file should be written as to not be dependent on other includes.
+ *                  everything these functions need should be passed to them.
+ *                  It will be necessary to consult the reference documents and associated schematics to understand
+ *                  the operations of this firmware.
+ *                  The timer 0 IRQ sets EVENT_LOG each sample time and the meter task puts the sample in RAM - it
+ *                  never waits on the SD card.  The click task only asks for the log - the log task creates the
+ *                  file, so no key waits on the card either.  Samples go to one of two buffers of LOG_BUFFER_SIZE.  A full
+ *                  buffer is written by the log task (the lowest priority) as one multi block f_write at a
+ *                  sector aligned offset.  The file stays open while logging and is stretched LOG_PREALLOCATE
+ *                  ahead of the writes, so its clusters are allocated together and a write does not stop to
+ *                  find one.  At the stop the file is cut to the samples.
+ *                  The log is binary: 16 byte records (see Type_LogRecord), the first is a header.
+ *****************************************************************/
+
+#include <ctl_api.h>
+#include "LOG_TASKS.H"
+#include "METER_TASKS.H"
+#include "CORE_FUNCTIONS.H"
+#include "DIP204.H"
+#include "HC15C_PROTOCOL.H"
+#include "FAT_FS_INC/ff.h"
+#include "lpc17xx_rtc.h"
+#include "lpc_types.h"
+#include <string.h>
+#include <stdio.h>
+
+
+// GLOBAL VARS
+// TYPES
+Type_Log MeterLog;
+// NOT ON THE STACK - THE CLICK TASK STACK IS SMALL
+static FIL LogFile;
+static Type_LogRecord LogBuffer[LOG_BUFFERS][LOG_BUFFER_SIZE / sizeof(Type_LogRecord)] AHB_BANK1;
+
+// EXTERN VARS
+extern CTL_EVENT_SET_t CalEvents;
+extern Type_CalSettings CalSettings;
+extern FRESULT FF_Result;
+extern CTL_MUTEX_t FatFsMutex;
+
+// PROTOTYPES LOCAL
+static void call_LogOpen(void);
+static BOOLEAN call_LogSwap(void);
+static BOOLEAN call_LogWrite(const Type_LogRecord *, uint32_t);
+static void call_LogClose(void);
+
+
+
+
+/*************************************************************************
+ * Function Name: log_taskFn
+ * Parameters:    void *
+ * Return:        void
+ *
+ * Description: RTOS CTL task to create and write the meter log on the SD card.  The task is the
+ * lowest priority so the card never holds off a key or a sample.  EVENT_LOG_OPEN is set by the
+ * start, EVENT_LOG_WRITE by the meter task when a buffer is full and by the stop.
+ * STEP 1: Wait for the event
+ * STEP 2: Create the file
+ * STEP 3: Write
+ *************************************************************************/
+void log_taskFn(void *p)
+{
+
+ while (1)
+   {
+   // STEP 1
+   ctl_events_wait(CTL_EVENT_WAIT_ANY_EVENTS, &CalEvents, (EVENT_LOG_OPEN|EVENT_LOG_WRITE), CTL_TIMEOUT_NONE, 0);
+
+   // STEP 2
+   if (CalEvents & EVENT_LOG_OPEN)
+     {
+     ctl_events_set_clear(&CalEvents, 0, EVENT_LOG_OPEN);
+     call_LogOpen();
+     }
+
+   // STEP 3
+   if (CalEvents & EVENT_LOG_WRITE)
+     {
+     ctl_events_set_clear(&CalEvents, 0, EVENT_LOG_WRITE);
+     call_LogCommit();
+     }
+   }
+
+} // END OF log_taskFn
+
+
+
+
+/*************************************************************************
+ * Function Name: call_LogStart
+ * Parameters: uint8_t
+ * Return: void
+ *
+ * Description: START (KEY 6) in volt or ohm meter mode - called by the click task.  The log task
+ * is woken to create the file (call_LogOpen) so the key never waits on the SD card.  Type is
+ * TYPE_VOLT or TYPE_OHMS.
+ * STEP 1: Not already logging - or still opening or closing the last log
+ * STEP 2: Wake the log task to create the file
+ *************************************************************************/
+ void call_LogStart(uint8_t Type)
+ {
+
+ uint8_t LineText[DISPLAY_COLUMN_TOTAL + 1];
+
+ // STEP 1
+ if ((MeterLog.On) || (MeterLog.Opened) || (MeterLog.Starting))
+   return;
+
+ // STEP 2
+ MeterLog.Type = Type;
+ MeterLog.Starting = TRUE;
+ //                 01234567890123456789
+ strcpy(LineText, "LOG OPENING");
+ DIP204_clearLine(LOG_ROW);
+ DIP204_txt_engine(LineText, LOG_ROW, 0, strlen(LineText));
+ ctl_events_set_clear(&CalEvents, EVENT_LOG_OPEN, 0);
+
+ } // END OF call_LogStart
+
+
+
+
+/*************************************************************************
+ * Function Name: call_LogOpen
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Called by the log task after the start.  Creates the log file named by the day and
+ * time, stretches it LOG_PREALLOCATE and puts the header record in the first buffer.  The timer 0
+ * IRQ then sets EVENT_LOG each LOG_SAMPLE_TIME.  Line 3 shows the count as samples are taken.  A
+ * stop keyed while the file was created closes it at once with just the header.
+ * STEP 1: Still wanted - the stop or the end of the mode clears Starting
+ * STEP 2: Create the file and allocate ahead
+ * STEP 3: The header and the counts, then start
+ * STEP 4: Stopped while it was created - close
+ *************************************************************************/
+ static void call_LogOpen(void)
+ {
+
+ uint8_t FileName[32];
+ Type_LogRecord *Header;
+ BOOLEAN Created;
+
+ // STEP 1
+ if (!MeterLog.Starting)
+   return;
+
+ // STEP 2
+ sprintf(FileName, LOG_FILE_NAME, RTC_GetTime(LPC_RTC, RTC_TIMETYPE_DAYOFMONTH), RTC_GetTime(LPC_RTC, RTC_TIMETYPE_HOUR),
+         RTC_GetTime(LPC_RTC, RTC_TIMETYPE_MINUTE), RTC_GetTime(LPC_RTC, RTC_TIMETYPE_SECOND));
+ ctl_mutex_lock(&FatFsMutex, CTL_TIMEOUT_NONE, 0);
+ FF_Result = f_open(&LogFile, FileName, FA_CREATE_ALWAYS | FA_WRITE);
+ if (FF_Result == FR_OK)
+   {
+   FF_Result = f_lseek(&LogFile, LOG_PREALLOCATE);
+   if ((FF_Result == FR_OK) && (f_tell(&LogFile) != LOG_PREALLOCATE))
+     FF_Result = FR_DENIED;  // CARD FULL
+   if (FF_Result == FR_OK)
+     FF_Result = f_lseek(&LogFile, 0);
+   if (FF_Result != FR_OK)
+     f_close(&LogFile);
+   }
+ Created = (FF_Result == FR_OK);
+ ctl_mutex_unlock(&FatFsMutex);
+ if (!Created)
+   {
+   MeterLog.Starting = FALSE;
+   if ((CalSettings.CalMode != METER_MODE) && (CalSettings.CalMode != OHMS_MODE))
+     return;
+   //                 01234567890123456789
+   strcpy(FileName, "LOG SD FAILED");
+   DIP204_clearLine(LOG_ROW);
+   DIP204_txt_engine(FileName, LOG_ROW, 0, strlen(FileName));
+   return;
+   }
+
+ // STEP 3
+ MeterLog.Opened = TRUE;
+ MeterLog.Allocated = LOG_PREALLOCATE;
+ MeterLog.Position = MeterLog.Samples = MeterLog.Missed = MeterLog.Lost = MeterLog.WriteTime = 0;
+ MeterLog.Error = FALSE;
+ MeterLog.Fill = 0;
+ MeterLog.Used[1] = 0;
+ MeterLog.Full[0] = MeterLog.Full[1] = FALSE;
+ Header = &LogBuffer[0][0];
+ memset(Header, 0, sizeof(Type_LogRecord));
+ Header->Time = LOG_SAMPLE_TIME;
+ Header->Sample = LOG_MAGIC;
+ Header->Type = LOG_TYPE_HEADER;
+ Header->Range = sizeof(Type_LogRecord);
+ MeterLog.Used[0] = 1;
+ MeterLog.SampleTime = LOG_SAMPLE_TIME;
+ MeterLog.Ticks = 0;
+ MeterLog.Start = ctl_get_current_time();
+ MeterLog.On = TRUE;
+ if (MeterLog.Starting)
+   {
+   MeterLog.Starting = FALSE;
+   call_LogShow();
+   return;
+   }
+
+ // STEP 4
+ MeterLog.On = FALSE;
+ MeterLog.Stop = ctl_get_current_time();
+ call_LogCommit();
+
+ } // END OF call_LogOpen
+
+
+
+
+/*************************************************************************
+ * Function Name: call_LogStop
+ * Parameters: void
+ * Return: void
+ *
+ * Description: STOP (KEY 5) in volt or ohm meter mode, and the end of either mode.  No more samples
+ * are taken and the log task is woken to write what is left and close the file - it then shows the
+ * results on line 3.  A log the log task has not yet created is not started.
+ * STEP 1: Stop and wake the log task
+ *************************************************************************/
+ void call_LogStop(void)
+ {
+
+ // STEP 1
+ MeterLog.Starting = FALSE;
+ if (!MeterLog.On)
+   return;
+ MeterLog.On = FALSE;
+ MeterLog.Stop = ctl_get_current_time();
+ ctl_events_set_clear(&CalEvents, EVENT_LOG_WRITE, 0);
+
+ } // END OF call_LogStop
+
+
+
+
+/*************************************************************************
+ * Function Name: call_LogSample
+ * Parameters: double Value, uint8_t Range, BOOLEAN Settled
+ * Return: void
+ *
+ * Description: Called by the meter task on EVENT_LOG with the reading in volts or ohms.  The record
+ * goes to the buffer being filled.  A full buffer is swapped for the other and the log task woken.
+ * If the other is still waiting on its write (or the meter filter is not settled after a range
+ * switch) the sample is dropped and counted - its sample number is skipped in the file.
+ * STEP 1: Logging, and a reading to log
+ * STEP 2: Room for the record
+ * STEP 3: The record
+ * STEP 4: Buffer full - swap
+ *************************************************************************/
+ void call_LogSample(double Value, uint8_t Range, BOOLEAN Settled)
+ {
+
+ Type_LogRecord *Record;
+ uint8_t Fill;
+
+ // STEP 1
+ if (!MeterLog.On)
+   return;
+ if (!Settled)
+   {
+   MeterLog.Lost++;
+   return;
+   }
+
+ // STEP 2
+ if ((MeterLog.Used[MeterLog.Fill] >= LOG_RECORDS) && (!call_LogSwap()))
+   {
+   MeterLog.Lost++;
+   return;
+   }
+
+ // STEP 3
+ Fill = MeterLog.Fill;
+ Record = &LogBuffer[Fill][MeterLog.Used[Fill]];
+ Record->Time = ctl_get_current_time() - MeterLog.Start;
+ Record->Sample = MeterLog.Samples + MeterLog.Lost + MeterLog.Missed + 1;
+ Record->Value = (float)Value;
+ Record->Type = MeterLog.Type;
+ Record->Range = Range;
+ Record->Reserved = 0;
+ MeterLog.Used[Fill]++;
+ MeterLog.Samples++;
+
+ // STEP 4
+ if (MeterLog.Used[Fill] >= LOG_RECORDS)
+   call_LogSwap();
+
+ } // END OF call_LogSample
+
+
+
+
+/*************************************************************************
+ * Function Name: call_LogSwap
+ * Parameters: void
+ * Return: BOOLEAN
+ *
+ * Description: Marks the buffer being filled full and fills the other - FALSE if the other is still
+ * waiting on its write.  Only the meter task calls this.
+ * STEP 1: Swap and wake the log task
+ *************************************************************************/
+ static BOOLEAN call_LogSwap(void)
+ {
+
+ uint8_t Fill = MeterLog.Fill;
+
+ // STEP 1
+ if (MeterLog.Full[Fill ^ 1])
+   return(FALSE);
+ MeterLog.Full[Fill] = TRUE;
+ MeterLog.Used[Fill ^ 1] = 0;
+ MeterLog.Fill = Fill ^ 1;
+ ctl_events_set_clear(&CalEvents, EVENT_LOG_WRITE, 0);
+ return(TRUE);
+
+ } // END OF call_LogSwap
+
+
+
+
+/*************************************************************************
+ * Function Name: call_LogShow
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Line 3 while logging - the meter task calls this with each reading it shows:
+ * LOG 1234 DROP 0
+ * STEP 1: Show the counts
+ *************************************************************************/
+ void call_LogShow(void)
+ {
+
+ uint8_t LineText[2 * DISPLAY_COLUMN_TOTAL];
+
+ // STEP 1
+ if (!MeterLog.On)
+   return;
+ //                  01234567890123456789
+ sprintf(LineText, "LOG %lu DROP %lu", MeterLog.Samples, MeterLog.Lost + MeterLog.Missed);
+ LineText[DISPLAY_COLUMN_TOTAL] = NULL_VALUE;
+ DIP204_clearLine(LOG_ROW);
+ DIP204_txt_engine(LineText, LOG_ROW, 0, strlen(LineText));
+
+ } // END OF call_LogShow
+
+
+
+
+/*************************************************************************
+ * Function Name: call_LogCommit
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Writes a full buffer to the log file, and after the stop closes the file.  Called by
+ * the log task and by goToSleep from the init task - the two are the same priority and time sliced,
+ * so FatFsMutex is held for the whole commit: it keeps the other caller, and the audio, tape and
+ * list tasks, off the card until the commit is done.  A full buffer not written stays full - the
+ * meter task drops samples until it is.  Before a write would pass the allocated end the file is
+ * stretched another LOG_PREALLOCATE.
+ * STEP 1: Lock - the full buffer, there is at most one
+ * STEP 2: Stretch the file if needed
+ * STEP 3: Write it and update the directory entry
+ * STEP 4: Stopped - close
+ *************************************************************************/
+ void call_LogCommit(void)
+ {
+
+ uint8_t Full;
+
+ // STEP 1
+ ctl_mutex_lock(&FatFsMutex, CTL_TIMEOUT_NONE, 0);
+ if (!MeterLog.Opened)
+   {
+   ctl_mutex_unlock(&FatFsMutex);
+   return;
+   }
+ Full = MeterLog.Fill ^ 1;
+ if (MeterLog.Full[Full])
+   {
+   // STEP 2
+   if (MeterLog.Position + LOG_BUFFER_SIZE > MeterLog.Allocated)
+     {
+     if ((f_lseek(&LogFile, MeterLog.Allocated + LOG_PREALLOCATE) == FR_OK) && (f_tell(&LogFile) == MeterLog.Allocated + LOG_PREALLOCATE))
+       MeterLog.Allocated += LOG_PREALLOCATE;
+     }
+
+   // STEP 3
+   if (call_LogWrite(LogBuffer[Full], LOG_BUFFER_SIZE))
+     {
+     MeterLog.Position += LOG_BUFFER_SIZE;
+     MeterLog.Full[Full] = FALSE;
+     if (f_sync(&LogFile) != FR_OK)
+       MeterLog.Error = TRUE;
+     }
+   }
+
+ // STEP 4
+ if ((!MeterLog.On) && (!MeterLog.Full[Full]))
+   call_LogClose();
+ ctl_mutex_unlock(&FatFsMutex);
+
+ } // END OF call_LogCommit
+
+
+
+
+/*************************************************************************
+ * Function Name: call_LogWrite
+ * Parameters: const Type_LogRecord *, uint32_t
+ * Return: BOOLEAN
+ *
+ * Description: Writes the bytes passed to the log file at Position (FatFsMutex is held by the
+ * caller) - one f_write, so FatFs sends
+ * the whole sectors straight from the buffer as a multi block write.  Returns FALSE and sets the
+ * log error if not all written.  The time in f_write is the file throughput.
+ * STEP 1: Seek and write
+ *************************************************************************/
+ static BOOLEAN call_LogWrite(const Type_LogRecord *Block, uint32_t Length)
+ {
+
+ UINT BytesWritten = 0;
+ uint32_t Time = ctl_get_current_time();
+
+ // STEP 1
+ FF_Result = f_lseek(&LogFile, MeterLog.Position);
+ if (FF_Result == FR_OK)
+   FF_Result = f_write(&LogFile, Block, Length, &BytesWritten);
+ MeterLog.WriteTime += ctl_get_current_time() - Time;
+ if ((FF_Result != FR_OK) || (BytesWritten != Length))
+   {
+   MeterLog.Error = TRUE;
+   return(FALSE);
+   }
+ return(TRUE);
+
+ } // END OF call_LogWrite
+
+
+
+
+/*************************************************************************
+ * Function Name: call_LogClose
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Writes the samples of the buffer being filled, cuts the file to them and closes it
+ * (FatFsMutex is held by the caller).
+ * Line 3 shows the samples per second over the log, the samples dropped and the file throughput,
+ * if still in a meter mode:
+ * 50.0/S D0 312KB/S
+ * STEP 1: The last samples and the size of the file
+ * STEP 2: Close
+ * STEP 3: Show the results
+ *************************************************************************/
+ static void call_LogClose(void)
+ {
+
+ uint8_t Fill = MeterLog.Fill,
+         LineText[2 * DISPLAY_COLUMN_TOTAL];
+ uint32_t Length = MeterLog.Used[Fill] * sizeof(Type_LogRecord),
+          Elapsed;
+
+ // STEP 1
+ if ((Length) && (call_LogWrite(LogBuffer[Fill], Length)))
+   MeterLog.Position += Length;
+ MeterLog.Used[Fill] = 0;
+ if ((f_lseek(&LogFile, MeterLog.Position) != FR_OK) || (f_truncate(&LogFile) != FR_OK))
+   MeterLog.Error = TRUE;
+
+ // STEP 2
+ if (f_close(&LogFile) != FR_OK)
+   MeterLog.Error = TRUE;
+ MeterLog.Opened = FALSE;
+
+ // STEP 3
+ if ((CalSettings.CalMode != METER_MODE) && (CalSettings.CalMode != OHMS_MODE))
+   return;
+ Elapsed = MeterLog.Stop - MeterLog.Start;
+ //                  01234567890123456789
+ if (MeterLog.Error)
+   sprintf(LineText, "LOG SD FAILED");
+ else
+   sprintf(LineText, "%.1f/S D%lu %luKB/S", (Elapsed) ? (1000.0 * MeterLog.Samples / Elapsed) : 0.0,
+           MeterLog.Lost + MeterLog.Missed, (MeterLog.WriteTime) ? (uint32_t)(MeterLog.Position / 1.024 / MeterLog.WriteTime) : 0);
+ LineText[DISPLAY_COLUMN_TOTAL] = NULL_VALUE;
+ DIP204_clearLine(LOG_ROW);
+ DIP204_txt_engine(LineText, LOG_ROW, 0, strlen(LineText));
+
+ } // END OF call_LogClose
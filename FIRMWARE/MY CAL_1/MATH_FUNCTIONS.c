@@ -4,7 +4,7 @@
  * Description:     Functions MATH RELATED operations used to support calculator operations of the HC15C
  * Author:          Hab S. Collector
  * Date:            12/15/11
- * LAST EDIT:       8/18/2012
+ * LAST EDIT:       10/19/2026
  * Hardware:        NXP LPC1769
  * Firmware Tool:   CrossStudio for ARM
  * Notes:           This file should be written as to not be dependent on other includes.
@@ -13,10 +13,17 @@
  *                  the operations of this firmware.
  *****************************************************************/ 
  
+#include <ctl_api.h>
 #include "MATH_FUNCTIONS.H"
 #include "CORE_FUNCTIONS.H"
 #include "TOUCH_TASKS.H"
 #include "DIP204.H"
+#include "INTEGER_FUNCTIONS.H"
+#include "KERNEL_FUNCTIONS.H"
+#include "DECIMAL_FUNCTIONS.H"
+#include "PROGRAM_TASKS.H"
+#include "TIMERS_HC15C.H"
+#include "FAT_FS_INC/ff.h"
 #include "lpc_types.h"
 #include <string.h>
 #include <stdio.h>
@@ -27,13 +34,157 @@ double LastX;
 // TYPES
 Type_MathErrorDisplay MathError;
 Type_Stat Stat;
+// N! FOR N = 0 TO MAX_FACTORIAL - EACH THE DOUBLE NEAREST THE EXACT VALUE
+static const double FactorialTable[MAX_FACTORIAL + 1] =
+  {
+  1.0, 1.0, 2.0, 6.0,
+  24.0, 120.0, 720.0, 5040.0,
+  40320.0, 362880.0, 3628800.0, 39916800.0,
+  479001600.0, 6227020800.0, 87178291200.0, 1307674368000.0,
+  20922789888000.0, 355687428096000.0, 6402373705728000.0, 1.21645100408832E17,
+  2.43290200817664E18, 5.109094217170944E19, 1.1240007277776077E21, 2.585201673888498E22,
+  6.204484017332394E23, 1.5511210043330986E25, 4.0329146112660565E26, 1.0888869450418352E28,
+  3.0488834461171387E29, 8.841761993739702E30, 2.6525285981219107E32, 8.222838654177922E33,
+  2.631308369336935E35, 8.683317618811886E36, 2.9523279903960416E38, 1.0333147966386145E40,
+  3.7199332678990125E41, 1.3763753091226346E43, 5.230226174666011E44, 2.0397882081197444E46,
+  8.159152832478977E47, 3.345252661316381E49, 1.40500611775288E51, 6.041526306337383E52,
+  2.658271574788449E54, 1.1962222086548019E56, 5.502622159812089E57, 2.5862324151116818E59,
+  1.2413915592536073E61, 6.082818640342675E62, 3.0414093201713376E64, 1.5511187532873822E66,
+  8.065817517094388E67, 4.2748832840600255E69, 2.308436973392414E71, 1.2696403353658276E73,
+  7.109985878048635E74, 4.0526919504877214E76, 2.3505613312828785E78, 1.3868311854568984E80,
+  8.32098711274139E81, 5.075802138772248E83, 3.146997326038794E85, 1.98260831540444E87,
+  1.2688693218588417E89, 8.247650592082472E90, 5.443449390774431E92, 3.647111091818868E94,
+  2.4800355424368305E96, 1.711224524281413E98, 1.1978571669969892E100, 8.504785885678623E101,
+  6.1234458376886085E103, 4.4701154615126844E105, 3.307885441519386E107, 2.48091408113954E109,
+  1.8854947016660504E111, 1.4518309202828587E113, 1.1324281178206297E115, 8.946182130782976E116,
+  7.156945704626381E118, 5.797126020747368E120, 4.753643337012842E122, 3.945523969720659E124,
+  3.314240134565353E126, 2.81710411438055E128, 2.4227095383672734E130, 2.107757298379528E132,
+  1.8548264225739844E134, 1.650795516090846E136, 1.4857159644817615E138, 1.352001527678403E140,
+  1.2438414054641308E142, 1.1567725070816416E144, 1.087366156656743E146, 1.032997848823906E148,
+  9.916779348709496E149, 9.619275968248212E151, 9.426890448883248E153, 9.332621544394415E155,
+  9.332621544394415E157, 9.42594775983836E159, 9.614466715035127E161, 9.90290071648618E163,
+  1.0299016745145628E166, 1.081396758240291E168, 1.1462805637347084E170, 1.226520203196138E172,
+  1.324641819451829E174, 1.4438595832024937E176, 1.588245541522743E178, 1.7629525510902446E180,
+  1.974506857221074E182, 2.2311927486598138E184, 2.5435597334721877E186, 2.925093693493016E188,
+  3.393108684451898E190, 3.969937160808721E192, 4.684525849754291E194, 5.574585761207606E196,
+  6.689502913449127E198, 8.094298525273444E200, 9.875044200833601E202, 1.214630436702533E205,
+  1.506141741511141E207, 1.882677176888926E209, 2.372173242880047E211, 3.0126600184576594E213,
+  3.856204823625804E215, 4.974504222477287E217, 6.466855489220474E219, 8.47158069087882E221,
+  1.1182486511960043E224, 1.4872707060906857E226, 1.9929427461615188E228, 2.6904727073180504E230,
+  3.659042881952549E232, 5.012888748274992E234, 6.917786472619489E236, 9.615723196941089E238,
+  1.3462012475717526E241, 1.898143759076171E243, 2.695364137888163E245, 3.854370717180073E247,
+  5.5502938327393044E249, 8.047926057471992E251, 1.1749972043909107E254, 1.727245890454639E256,
+  2.5563239178728654E258, 3.80892263763057E260, 5.713383956445855E262, 8.62720977423324E264,
+  1.3113358856834524E267, 2.0063439050956823E269, 3.0897696138473508E271, 4.789142901463394E273,
+  7.471062926282894E275, 1.1729568794264145E278, 1.853271869493735E280, 2.9467022724950384E282,
+  4.7147236359920616E284, 7.590705053947219E286, 1.2296942187394494E289, 2.0044015765453026E291,
+  3.287218585534296E293, 5.423910666131589E295, 9.003691705778438E297, 1.503616514864999E300,
+  2.5260757449731984E302, 4.269068009004705E304, 7.257415615307999E306
+  };
+// LANCZOS APPROXIMATION (g = 671/128, n = 15 - NUMERICAL RECIPES 3RD ED) - SEE call_Factorial
+static const double LanczosCoef[LANCZOS_TERMS] =
+  {
+  0.999999999999997092,    57.1562356658629235,     -59.5979603554754912,
+  14.1360979747417471,     -0.491913816097620199,   0.339946499848118887E-4,
+  0.465236289270485756E-4, -0.983744753048795646E-4, 0.158088703224912494E-3,
+  -0.210264441724104883E-3, 0.217439618115212643E-3, -0.164318106536763890E-3,
+  0.844182239838527433E-4, -0.261908384015814087E-4, 0.368991826595316234E-5
+  };
+// UNITS OF call_UnitConvert - IN THE ORDER OF enum UNIT - BASE = (VALUE + Offset) x Scale
+static const Type_Unit UnitTable[UNIT_TOTAL] =
+  {
+  {UNIT_LENGTH,      1.0,                         0.0},       // m
+  {UNIT_LENGTH,      0.001,                       0.0},       // mm
+  {UNIT_LENGTH,      0.01,                        0.0},       // cm
+  {UNIT_LENGTH,      1000.0,                      0.0},       // km
+  {UNIT_LENGTH,      UNIT_MIL_M,                  0.0},       // mils
+  {UNIT_LENGTH,      UNIT_INCH_M,                 0.0},       // in
+  {UNIT_LENGTH,      UNIT_FOOT_M,                 0.0},       // ft
+  {UNIT_LENGTH,      UNIT_MILE_M,                 0.0},       // mi
+  {UNIT_MASS,        1.0,                         0.0},       // kg
+  {UNIT_MASS,        UNIT_POUND_KG,               0.0},       // lb
+  {UNIT_VOLUME,      1.0,                         0.0},       // l
+  {UNIT_VOLUME,      UNIT_GALLON_L,               0.0},       // gal (US)
+  {UNIT_SPEED,       1.0,                         0.0},       // m/s
+  {UNIT_SPEED,       1000.0 / UNIT_HOUR_S,        0.0},       // km/h
+  {UNIT_SPEED,       UNIT_FOOT_M,                 0.0},       // ft/s
+  {UNIT_SPEED,       UNIT_MILE_M / UNIT_HOUR_S,   0.0},       // mi/h
+  {UNIT_TEMPERATURE, 1.0,                         0.0},       // C
+  {UNIT_TEMPERATURE, 1.0 / 1.8,                   -32.0}      // F
+  };
+// call_MathBenchmark: ENTRY POINT AND NAME OF EACH CHECKED FUNCTION - IN THE ORDER OF enum MATH_CHECK_FUNCTION
+static void (* const MathCheckEntry[MATH_CHECK_TOTAL])(void) =
+  {
+  call_sinX, call_cosX, call_tanX, call_asinX, call_acosX, call_atanX,
+  call_eToX, call_lnX, call_10ToX, call_logX, call_Xsqr, call_sqrtX,
+  call_OneOverX, call_YtoX, call_YtoOneOverX, call_Xfactorial, call_RtoP, call_PtoR
+  };
+static const uint8_t MathCheckName[MATH_CHECK_TOTAL][6] =
+  {
+  "SIN", "COS", "TAN", "ASIN", "ACOS", "ATAN",
+  "EXP", "LN", "10^X", "LOG", "X^2", "SQRT",
+  "1/X", "Y^X", "Y^1/X", "X!", "R>P", "P>R"
+  };
+// THE REFERENCE IS THE EXACT RESULT FOR THE DOUBLE OF Y AND X (60 DIGITS) ROUNDED TO THE NEAREST
+// DOUBLE - TRIG IN RADIANS
+static const Type_MathCheck MathCheck[] =
+  {
+  {MATH_CHECK_SIN,        0.0,  0.5,    0.479425538604203},
+  {MATH_CHECK_SIN,        0.0,  2.5,    0.5984721441039565},
+  {MATH_CHECK_SIN,        0.0,  100.0,  -0.5063656411097588},
+  {MATH_CHECK_COS,        0.0,  0.5,    0.8775825618903728},
+  {MATH_CHECK_COS,        0.0,  2.5,    -0.8011436155469337},
+  {MATH_CHECK_COS,        0.0,  100.0,  0.8623188722876839},
+  {MATH_CHECK_TAN,        0.0,  0.5,    0.5463024898437905},
+  {MATH_CHECK_TAN,        0.0,  1.5,    14.101419947171719},
+  {MATH_CHECK_TAN,        0.0,  -0.7,   -0.8422883804630794},
+  {MATH_CHECK_ASIN,       0.0,  0.3,    0.3046926540153975},
+  {MATH_CHECK_ASIN,       0.0,  -0.9,   -1.1197695149986342},
+  {MATH_CHECK_ACOS,       0.0,  0.3,    1.2661036727794992},
+  {MATH_CHECK_ACOS,       0.0,  0.9,    0.45102681179626236},
+  {MATH_CHECK_ATAN,       0.0,  0.5,    0.4636476090008061},
+  {MATH_CHECK_ATAN,       0.0,  20.0,   1.5208379310729538},
+  {MATH_CHECK_EXP,        0.0,  1.5,    4.4816890703380645},
+  {MATH_CHECK_EXP,        0.0,  -20.0,  2.061153622438558E-9},
+  {MATH_CHECK_EXP,        0.0,  100.0,  2.6881171418161356E43},
+  {MATH_CHECK_LN,         0.0,  0.001,  -6.907755278982137},
+  {MATH_CHECK_LN,         0.0,  2.0,    0.6931471805599453},
+  {MATH_CHECK_LN,         0.0,  1.0E10, 23.025850929940457},
+  {MATH_CHECK_EXP10,      0.0,  0.3,    1.9952623149688795},
+  {MATH_CHECK_EXP10,      0.0,  -5.5,   3.162277660168379E-6},
+  {MATH_CHECK_LOG,        0.0,  2.0,    0.3010299956639812},
+  {MATH_CHECK_LOG,        0.0,  12345.0, 4.091491094267951},
+  {MATH_CHECK_SQUARE,     0.0,  1.1,    1.2100000000000002},
+  {MATH_CHECK_SQUARE,     0.0,  -3.7E5, 1.369E11},
+  {MATH_CHECK_SQRT,       0.0,  2.0,    1.4142135623730951},
+  {MATH_CHECK_SQRT,       0.0,  1.0E-7, 3.1622776601683794E-4},
+  {MATH_CHECK_RECIPROCAL, 0.0,  3.0,    0.3333333333333333},
+  {MATH_CHECK_RECIPROCAL, 0.0,  -7.0,   -0.14285714285714285},
+  {MATH_CHECK_POWER,      2.0,  0.5,    1.4142135623730951},
+  {MATH_CHECK_POWER,      1.5,  40.0,   11057332.320940012},
+  {MATH_CHECK_POWER,      10.0, -3.3,   5.011872336272725E-4},
+  {MATH_CHECK_ROOT,       27.0, 3.0,    3.0},
+  {MATH_CHECK_ROOT,       2.0,  7.0,    1.1040895136738123},
+  {MATH_CHECK_FACTORIAL,  0.0,  10.0,   3628800.0},
+  {MATH_CHECK_FACTORIAL,  0.0,  0.5,    0.886226925452758},
+  {MATH_CHECK_FACTORIAL,  0.0,  5.5,    287.88527781504433},
+  {MATH_CHECK_FACTORIAL,  0.0,  100.0,  9.332621544394415E157},
+  {MATH_CHECK_RTOP,       2.0,  1.0,    2.23606797749979},            // |1 + j2|
+  {MATH_CHECK_PTOR,       0.5,  2.0,    1.7551651237807455}           // 2 cos(0.5)
+  };
 
 // EXTERN VARS
 extern uint8_t str_InputLine[MAX_DISPLAY_LENGTH];
 extern Type_Register RegisterValue[TOTAL_REGISTERS];
 extern Type_Numeric NumericValue;
 extern Type_CalSettings CalSettings;
-extern BOOLEAN bln_LineLoaded;
+extern BOOLEAN bln_LineLoaded,
+               bln_DisplayHold;
+extern Type_Program Program;
+extern FRESULT FF_Result;
+extern CTL_MUTEX_t FatFsMutex;
+extern FIL FatFsFile;
+extern uint32_t SystemCoreClock;
 
 
 
@@ -64,15 +215,15 @@ extern BOOLEAN bln_LineLoaded;
  
  // STEP 2
  DIP204_clearDisplay();
- sprintf(LineText,"MATH ERROR:");
- DIP204_txt_engine(LineText, 1, 0, strlen(LineText));
- DIP204_txt_engine(MathError.ErrorDescription, 2, 3, strlen(MathError.ErrorDescription));
- DIP204_txt_engine(MathError.ErrorSolution, 3, 3, strlen(MathError.ErrorSolution));
+ sprintf((char *)LineText,"MATH ERROR:");
+ DIP204_txt_engine(LineText, 1, 0, strlen((const char *)LineText));
+ DIP204_txt_engine(MathError.ErrorDescription, 2, 3, strlen((const char *)MathError.ErrorDescription));
+ DIP204_txt_engine(MathError.ErrorSolution, 3, 3, strlen((const char *)MathError.ErrorSolution));
  DIP204_ICON_set(ICON_ALERT, ICON_BLINK);
  DIP204_set_cursor(CURSOR_OFF);
  
  // STEP 3
- strcpy(AudioQueueStruct.FileName, NumericValue.AudioErrorFileName);
+ strcpy((char *)AudioQueueStruct.FileName, (const char *)NumericValue.AudioErrorFileName);
  AudioQueueStruct.PlayLevel = NumericValue.AudioPlayLevel;
  ctl_PostMessageByMemAllocate(&AudioQueueStruct);
  
@@ -99,16 +250,20 @@ extern BOOLEAN bln_LineLoaded;
  // STEP 1 
  if (isinf(Ans) || isnan(Ans))
    {
-    strcpy(MathError.ErrorDescription,"Invalid result");
-    strcpy(MathError.ErrorSolution,"Unsupported math");
-    strcpy(NumericValue.AudioErrorFileName, I_AND_I_ERROR_WAV);
+    strcpy((char *)MathError.ErrorDescription,"Invalid result");
+    strcpy((char *)MathError.ErrorSolution,"Unsupported math");
+    strcpy((char *)NumericValue.AudioErrorFileName, I_AND_I_ERROR_WAV);
     NumericValue.AudioPlayLevel = BASIC_HELP;
     call_ShowMathError();
     return;
    }
  
  // STEP 2
+ // DECIMAL MATH: EVERY RESULT IS TAKEN TO 13 DIGITS
+ if (CalSettings.DecimalMath && (CalSettings.CalBase == BASE_10))
+   Ans = call_DecimalRound(Ans);
  RegisterValue[0].NumericValue = Ans;
+ RegisterValue[0].Imaginary = 0.0;
  call_ProcessStackDown(); 
    
  } // END OF call_ChkAndDisplayDrop
@@ -134,15 +289,18 @@ extern BOOLEAN bln_LineLoaded;
  // STEP 1 
  if (isinf(Ans) || isnan(Ans))
    {
-    strcpy(MathError.ErrorDescription,"Invalid result");
-    strcpy(MathError.ErrorSolution,"Unsupported math");
-    strcpy(NumericValue.AudioErrorFileName, I_AND_I_ERROR_WAV);
+    strcpy((char *)MathError.ErrorDescription,"Invalid result");
+    strcpy((char *)MathError.ErrorSolution,"Unsupported math");
+    strcpy((char *)NumericValue.AudioErrorFileName, I_AND_I_ERROR_WAV);
     NumericValue.AudioPlayLevel = BASIC_HELP;
     call_ShowMathError();
     return;
    }
  
  // STEP 2
+ // DECIMAL MATH: EVERY RESULT IS TAKEN TO 13 DIGITS
+ if (CalSettings.DecimalMath && (CalSettings.CalBase == BASE_10))
+   Ans = call_DecimalRound(Ans);
  call_ProcessStackUp(Ans); 
    
  } // END OF call_ChkAndDisplayRaise
@@ -150,82 +308,6 @@ extern BOOLEAN bln_LineLoaded;
 
 
 
-/*************************************************************************
- * Function Name: call_singleLineConvertMultiply
- * Parameters: double
- * Return: void
- *
- * Description: Many conversions operate on a single variable.  That is a defined
- * converted value operates on the X or line input.  The function is passed the conversion
- * and multiply to convert the value
- * STEP 1: If unloaded check if valid number and check for pre-existing error conditions
- * STEP 2: Check and Display the answer
- *************************************************************************/
- void call_singleLineConvertMultiply(double MultiplyConversion)
- {
- 
- double TempAns;
- 
- // STEP 1
- if (!bln_LineLoaded)
-   {
-   if (call_IsNumericValue(str_InputLine, CalSettings.CalBase) == FALSE)
-     {
-     call_ShowEntryError();
-     return;
-     }
-   // MATH
-   TempAns = NumericValue.Value * MultiplyConversion;
-   }
- else
-   TempAns = RegisterValue[0].NumericValue * MultiplyConversion;
- 
- // STEP 2
- call_ChkAndDisplayRaise(TempAns);
- 
- } // END OF call_singleLineConvertMultiply
-
-
-
-
-/*************************************************************************
- * Function Name: call_singleLineConvertDivide
- * Parameters: double
- * Return: void
- *
- * Description: Many conversions operate on a single variable.  That is a defined
- * converted value operates on the X or line input.  The function is passed the conversion
- * and divided to convert the value
- * STEP 1: If unloaded check if valid number and check for pre-existing error conditions
- * STEP 2: Check and Display the answer
- *************************************************************************/
- void call_singleLineConvertDivide(double DivideConversion)
- {
- 
- double TempAns;
- 
- // STEP 1
- if (!bln_LineLoaded)
-   {
-   if (call_IsNumericValue(str_InputLine, CalSettings.CalBase) == FALSE)
-     {
-     call_ShowEntryError();
-     return;
-     }
-   // MATH
-   TempAns = NumericValue.Value / DivideConversion;
-   }
- else
-   TempAns = RegisterValue[0].NumericValue / DivideConversion;
- 
- // STEP 2
- call_ChkAndDisplayRaise(TempAns);
- 
- } // END OF call_singleLineConvertDivide
- 
-
-
-
 /*************************************************************************
  * Function Name: call_LShiftClick
  * Parameters: void
@@ -309,10 +391,16 @@ void call_Enter(void)
  if (bln_LineLoaded)
    {
    RegisterValue[3].NumericValue = RegisterValue[2].NumericValue;
+   RegisterValue[3].IntegerValue = RegisterValue[2].IntegerValue;
+   RegisterValue[3].Imaginary = RegisterValue[2].Imaginary;
    RegisterValue[3].Displayed = RegisterValue[2].Displayed;
    RegisterValue[2].NumericValue = RegisterValue[1].NumericValue;
+   RegisterValue[2].IntegerValue = RegisterValue[1].IntegerValue;
+   RegisterValue[2].Imaginary = RegisterValue[1].Imaginary;
    RegisterValue[2].Displayed = RegisterValue[1].Displayed;
    RegisterValue[1].NumericValue = RegisterValue[0].NumericValue;
+   RegisterValue[1].IntegerValue = RegisterValue[0].IntegerValue;
+   RegisterValue[1].Imaginary = RegisterValue[0].Imaginary;
    RegisterValue[1].Displayed = RegisterValue[0].Displayed;
    LastX = RegisterValue[0].NumericValue;
    call_FormatNumber();
@@ -329,12 +417,20 @@ void call_Enter(void)
    else
      {
      RegisterValue[3].NumericValue = RegisterValue[2].NumericValue;
+     RegisterValue[3].IntegerValue = RegisterValue[2].IntegerValue;
+     RegisterValue[3].Imaginary = RegisterValue[2].Imaginary;
      RegisterValue[3].Displayed = RegisterValue[2].Displayed;
      RegisterValue[2].NumericValue = RegisterValue[1].NumericValue;
+     RegisterValue[2].IntegerValue = RegisterValue[1].IntegerValue;
+     RegisterValue[2].Imaginary = RegisterValue[1].Imaginary;
      RegisterValue[2].Displayed = RegisterValue[1].Displayed;
      RegisterValue[1].NumericValue = RegisterValue[0].NumericValue;
+     RegisterValue[1].IntegerValue = RegisterValue[0].IntegerValue;
+     RegisterValue[1].Imaginary = RegisterValue[0].Imaginary;
      RegisterValue[1].Displayed = RegisterValue[0].Displayed;
      RegisterValue[0].NumericValue = NumericValue.Value;
+     RegisterValue[0].IntegerValue = NumericValue.IntegerValue;
+     RegisterValue[0].Imaginary = 0.0;
      RegisterValue[0].Displayed = TRUE;
      LastX = RegisterValue[0].NumericValue;
      bln_LineLoaded = TRUE;
@@ -361,12 +457,20 @@ void call_Drop(void)
  if(bln_LineLoaded)
    {
    RegisterValue[0].NumericValue = RegisterValue[1].NumericValue;
+   RegisterValue[0].IntegerValue = RegisterValue[1].IntegerValue;
+   RegisterValue[0].Imaginary = RegisterValue[1].Imaginary;
    RegisterValue[0].Displayed = RegisterValue[1].Displayed;
    RegisterValue[1].NumericValue = RegisterValue[2].NumericValue;
+   RegisterValue[1].IntegerValue = RegisterValue[2].IntegerValue;
+   RegisterValue[1].Imaginary = RegisterValue[2].Imaginary;
    RegisterValue[1].Displayed = RegisterValue[2].Displayed;
    RegisterValue[2].NumericValue = RegisterValue[3].NumericValue;
+   RegisterValue[2].IntegerValue = RegisterValue[3].IntegerValue;
+   RegisterValue[2].Imaginary = RegisterValue[3].Imaginary;
    RegisterValue[2].Displayed = RegisterValue[3].Displayed;
    RegisterValue[3].NumericValue = 0.0;
+   RegisterValue[3].IntegerValue = 0;
+   RegisterValue[3].Imaginary = 0.0;
    RegisterValue[3].Displayed = FALSE;
    }
  bln_LineLoaded = TRUE;
@@ -391,9 +495,11 @@ void call_Drop(void)
  // STEP 1
  for (uint8_t RegCount = 0; RegCount < TOTAL_REGISTERS; RegCount++)
    {
-   strcpy(RegisterValue[RegCount].DisplayAs,"");
+   strcpy((char *)RegisterValue[RegCount].DisplayAs,"");
    RegisterValue[RegCount].Displayed = FALSE;
    RegisterValue[RegCount].NumericValue = 0.0;
+   RegisterValue[RegCount].IntegerValue = 0;
+   RegisterValue[RegCount].Imaginary = 0.0;
    }
  
  // STEP 2
@@ -418,6 +524,8 @@ void call_Drop(void)
  if(bln_LineLoaded)
    {
    RegisterValue[0].NumericValue = 0;
+   RegisterValue[0].IntegerValue = 0;
+   RegisterValue[0].Imaginary = 0.0;
    RegisterValue[0].Displayed = TRUE;
    call_FormatNumber();
    }
@@ -449,6 +557,13 @@ void call_Divide(void)
  
  double TempAns;
 
+ // HEX MODE IS INTEGER MATH
+ if (CalSettings.CalBase == BASE_16)
+   {
+   call_IntBinaryOp(INT_DIVIDE);
+   return;
+   }
+
  // STEP 1
  if (!bln_LineLoaded)
    {
@@ -460,29 +575,35 @@ void call_Divide(void)
    // CHECK FOR DIVIDE BY ZERO.
    if (NumericValue.Value == 0)
      {
-     strcpy(MathError.ErrorDescription,"Divide By 0");
-     strcpy(MathError.ErrorSolution,"Causes infinity");
-     strcpy(NumericValue.AudioErrorFileName, I_AND_I_ERROR_WAV);
+     strcpy((char *)MathError.ErrorDescription,"Divide By 0");
+     strcpy((char *)MathError.ErrorSolution,"Causes infinity");
+     strcpy((char *)NumericValue.AudioErrorFileName, I_AND_I_ERROR_WAV);
      NumericValue.AudioPlayLevel = BASIC_HELP;
      call_ShowMathError();
      return;
      }
    // MATH
-   TempAns = RegisterValue[0].NumericValue / NumericValue.Value;
+   if (CalSettings.DecimalMath)
+     TempAns = call_DecimalOperation(DECIMAL_DIVIDE, RegisterValue[0].NumericValue, NumericValue.Value);
+   else
+     TempAns = RegisterValue[0].NumericValue / NumericValue.Value;
    }
  else
    {
    // CHECK FOR DIVIDE BY ZERO
    if (RegisterValue[0].NumericValue == 0)
      {
-     strcpy(MathError.ErrorDescription,"Divide By 0");
-     strcpy(MathError.ErrorSolution,"Causes infinity");
-     strcpy(NumericValue.AudioErrorFileName, I_AND_I_ERROR_WAV);
+     strcpy((char *)MathError.ErrorDescription,"Divide By 0");
+     strcpy((char *)MathError.ErrorSolution,"Causes infinity");
+     strcpy((char *)NumericValue.AudioErrorFileName, I_AND_I_ERROR_WAV);
      NumericValue.AudioPlayLevel = BASIC_HELP;
      call_ShowMathError();
      return;
      }
-   TempAns = RegisterValue[1].NumericValue / RegisterValue[0].NumericValue;
+   if (CalSettings.DecimalMath)
+     TempAns = call_DecimalOperation(DECIMAL_DIVIDE, RegisterValue[1].NumericValue, RegisterValue[0].NumericValue);
+   else
+     TempAns = RegisterValue[1].NumericValue / RegisterValue[0].NumericValue;
    }
  
  // STEP 2
@@ -510,6 +631,13 @@ void call_Divide(void)
  
  double TempAns;
  
+ // HEX MODE IS INTEGER MATH
+ if (CalSettings.CalBase == BASE_16)
+   {
+   call_IntBinaryOp(INT_MULTIPLY);
+   return;
+   }
+
  // STEP 1
  if (!bln_LineLoaded)
    {
@@ -519,10 +647,18 @@ void call_Divide(void)
      return;
      }
    // MATH
-   TempAns = RegisterValue[0].NumericValue * NumericValue.Value;
+   if (CalSettings.DecimalMath)
+     TempAns = call_DecimalOperation(DECIMAL_MULTIPLY, RegisterValue[0].NumericValue, NumericValue.Value);
+   else
+     TempAns = RegisterValue[0].NumericValue * NumericValue.Value;
    }
  else
-   TempAns = RegisterValue[1].NumericValue * RegisterValue[0].NumericValue;
+   {
+   if (CalSettings.DecimalMath)
+     TempAns = call_DecimalOperation(DECIMAL_MULTIPLY, RegisterValue[1].NumericValue, RegisterValue[0].NumericValue);
+   else
+     TempAns = RegisterValue[1].NumericValue * RegisterValue[0].NumericValue;
+   }
  
  // STEP 2
  call_ChkAndDisplayDrop(TempAns);
@@ -549,6 +685,13 @@ void call_Divide(void)
  
  double TempAns;
  
+ // HEX MODE IS INTEGER MATH
+ if (CalSettings.CalBase == BASE_16)
+   {
+   call_IntBinaryOp(INT_SUBTRACT);
+   return;
+   }
+
  // STEP 1
  if (!bln_LineLoaded)
    {
@@ -558,10 +701,18 @@ void call_Divide(void)
      return;
      }
    // MATH
-   TempAns = RegisterValue[0].NumericValue - NumericValue.Value;
+   if (CalSettings.DecimalMath)
+     TempAns = call_DecimalOperation(DECIMAL_SUBTRACT, RegisterValue[0].NumericValue, NumericValue.Value);
+   else
+     TempAns = RegisterValue[0].NumericValue - NumericValue.Value;
    }
  else
-   TempAns = RegisterValue[1].NumericValue - RegisterValue[0].NumericValue;
+   {
+   if (CalSettings.DecimalMath)
+     TempAns = call_DecimalOperation(DECIMAL_SUBTRACT, RegisterValue[1].NumericValue, RegisterValue[0].NumericValue);
+   else
+     TempAns = RegisterValue[1].NumericValue - RegisterValue[0].NumericValue;
+   }
  
  // STEP 2
  call_ChkAndDisplayDrop(TempAns);
@@ -588,6 +739,13 @@ void call_Divide(void)
  
  double TempAns;
  
+ // HEX MODE IS INTEGER MATH
+ if (CalSettings.CalBase == BASE_16)
+   {
+   call_IntBinaryOp(INT_ADD);
+   return;
+   }
+
  // STEP 1
  if (!bln_LineLoaded)
    {
@@ -597,10 +755,18 @@ void call_Divide(void)
      return;
      }
    // MATH
-   TempAns = RegisterValue[0].NumericValue + NumericValue.Value;
+   if (CalSettings.DecimalMath)
+     TempAns = call_DecimalOperation(DECIMAL_ADD, RegisterValue[0].NumericValue, NumericValue.Value);
+   else
+     TempAns = RegisterValue[0].NumericValue + NumericValue.Value;
    }
  else
-   TempAns = RegisterValue[1].NumericValue + RegisterValue[0].NumericValue;
+   {
+   if (CalSettings.DecimalMath)
+     TempAns = call_DecimalOperation(DECIMAL_ADD, RegisterValue[1].NumericValue, RegisterValue[0].NumericValue);
+   else
+     TempAns = RegisterValue[1].NumericValue + RegisterValue[0].NumericValue;
+   }
  
  // STEP 2
  call_ChkAndDisplayDrop(TempAns);
@@ -611,380 +777,37 @@ void call_Divide(void)
 
 
 /*************************************************************************
- * Function Name: call_mm_to_MILS
- * Parameters: void
- * Return: void
- *
- * Description: Perform the stated math function on loaded and unloaded numbers. In the case
- * of unloaded numbers the input string is first checked to see if valid.  If so, the operation
- * is performed on the input string and the X (REG0).  If loaded the function is performed on the
- * X and Y register (REG0 and REG1).
- * STEP 1: If unloaded check if valid number and check for pre-existing error conditions
- * STEP 2: Check and Display the answer
- *************************************************************************/
- void call_mm_to_MILS(void)
- {
- 
- call_singleLineConvertMultiply(MM_TO_MILS_CONVERT);
- 
- } // END OF call_mm_to_MILS
-
-
-
-
-/*************************************************************************
- * Function Name: call_mm_to_MILS
- * Parameters: void
- * Return: void
- *
- * Description: Perform the stated math function on loaded and unloaded numbers. In the case
- * of unloaded numbers the input string is first checked to see if valid.  If so, the operation
- * is performed on the input string and the X (REG0).  If loaded the function is performed on the
- * X and Y register (REG0 and REG1).
- *************************************************************************/
- void call_MILS_to_mm(void)
- {
- 
- call_singleLineConvertDivide(MM_TO_MILS_CONVERT);
- 
- } // END OF call_MILS_to_mm
-
-
-
-
-/*************************************************************************
- * Function Name: call_km_to_mi
- * Parameters: void
- * Return: void
- *
- * Description: Perform the stated math function on loaded and unloaded numbers. In the case
- * of unloaded numbers the input string is first checked to see if valid.  If so, the operation
- * is performed on the input string and the X (REG0).  If loaded the function is performed on the
- * X and Y register (REG0 and REG1).
- *************************************************************************/
- void call_km_to_mi(void)
- {
- 
- call_singleLineConvertDivide(MILES_TO_KM_CONVERT);
- 
- } // END OF call_km_to_mi
-
-
-
-
-/*************************************************************************
- * Function Name: call_mi_to_km
- * Parameters: void
- * Return: void
- *
- * Description: Perform the stated math function on loaded and unloaded numbers. In the case
- * of unloaded numbers the input string is first checked to see if valid.  If so, the operation
- * is performed on the input string and the X (REG0).  If loaded the function is performed on the
- * X and Y register (REG0 and REG1).
- *************************************************************************/
- void call_mi_to_km(void)
- {
- 
- call_singleLineConvertMultiply(MILES_TO_KM_CONVERT);
- 
- } // END OF call_mi_to_km
-
-
-
-
-/*************************************************************************
- * Function Name: call_kg_to_lb
- * Parameters: void
- * Return: void
- *
- * Description: Perform the stated math function on loaded and unloaded numbers. In the case
- * of unloaded numbers the input string is first checked to see if valid.  If so, the operation
- * is performed on the input string and the X (REG0).  If loaded the function is performed on the
- * X and Y register (REG0 and REG1).
- *************************************************************************/
- void call_kg_to_lb(void)
- {
- 
- call_singleLineConvertMultiply(KG_TO_LB_CONVERT);
- 
- } // END OF call_kg_to_lb
-
-
-
-
-/*************************************************************************
- * Function Name: call_lb_to_kg
- * Parameters: void
- * Return: void
- *
- * Description: Perform the stated math function on loaded and unloaded numbers. In the case
- * of unloaded numbers the input string is first checked to see if valid.  If so, the operation
- * is performed on the input string and the X (REG0).  If loaded the function is performed on the
- * X and Y register (REG0 and REG1).
- *************************************************************************/
- void call_lb_to_kg(void)
- {
- 
- call_singleLineConvertDivide(KG_TO_LB_CONVERT);
- 
- } // END OF call_lb_to_kg
-
-
-
-
-/*************************************************************************
- * Function Name: call_gal_to_l
- * Parameters: void
- * Return: void
- *
- * Description: Perform the stated math function on loaded and unloaded numbers. In the case
- * of unloaded numbers the input string is first checked to see if valid.  If so, the operation
- * is performed on the input string and the X (REG0).  If loaded the function is performed on the
- * X and Y register (REG0 and REG1).
- *************************************************************************/
- void call_gal_to_l(void)
- {
- 
- call_singleLineConvertMultiply(GAL_TO_L_CONVERT);
- 
- } // END OF call_gal_to_l
-
-
-
-
-/*************************************************************************
- * Function Name: call_l_to_gal
- * Parameters: void
- * Return: void
- *
- * Description: Perform the stated math function on loaded and unloaded numbers. In the case
- * of unloaded numbers the input string is first checked to see if valid.  If so, the operation
- * is performed on the input string and the X (REG0).  If loaded the function is performed on the
- * X and Y register (REG0 and REG1).
- *************************************************************************/
- void call_l_to_gal(void)
- {
- 
- call_singleLineConvertDivide(GAL_TO_L_CONVERT);
- 
- } // END OF call_l_to_gal
-
-
-
-
-/*************************************************************************
- * Function Name: call_in_to_cm
- * Parameters: void
+ * Function Name: call_UnitConvert
+ * Parameters: uint8_t, uint8_t
  * Return: void
  *
- * Description: Perform the stated math function on loaded and unloaded numbers. In the case
- * of unloaded numbers the input string is first checked to see if valid.  If so, the operation
- * is performed on the input string and the X (REG0).  If loaded the function is performed on the
- * X and Y register (REG0 and REG1).
+ * Description: Converts X (or the unloaded input line) from one unit to another of the same
+ * dimension.  Each unit of UnitTable is its value in the base unit of its dimension:
+ * BASE = (VALUE + Offset) x Scale.  Any pair is converted by going through the base unit, so
+ * a new unit is one line of the table and not a new function.  As the other single variable
+ * functions the result is raised onto the stack
+ * STEP 1: Check the units are of the same dimension
+ * STEP 2: If unloaded check if valid number
+ * STEP 3: To the base unit and from the base unit
+ * STEP 4: Check and Display the answer
  *************************************************************************/
- void call_in_to_cm(void)
- {
- 
- call_singleLineConvertMultiply(IN_TO_CM_CONVERT);
- 
- } // END OF call_in_to_cm
-
-
-
-
-/*************************************************************************
- * Function Name: call_cm_to_in
- * Parameters: void
- * Return: void
- *
- * Description: Perform the stated math function on loaded and unloaded numbers. In the case
- * of unloaded numbers the input string is first checked to see if valid.  If so, the operation
- * is performed on the input string and the X (REG0).  If loaded the function is performed on the
- * X and Y register (REG0 and REG1).
- *************************************************************************/
- void call_cm_to_in(void)
- {
- 
- call_singleLineConvertDivide(IN_TO_CM_CONVERT);
- 
- } // END OF call_cm_to_in
-
-
-
-
-/*************************************************************************
- * Function Name: call_mph_to_kph
- * Parameters: void
- * Return: void
- *
- * Description: Perform the stated math function on loaded and unloaded numbers. In the case
- * of unloaded numbers the input string is first checked to see if valid.  If so, the operation
- * is performed on the input string and the X (REG0).  If loaded the function is performed on the
- * X and Y register (REG0 and REG1).
- *************************************************************************/
- void call_mph_to_kph(void)
- {
- 
- call_singleLineConvertMultiply(MILES_TO_KM_CONVERT);
- 
- } // END OF call_mph_to_kph
-
-
-
-
-/*************************************************************************
- * Function Name: call_kph_to_mph
- * Parameters: void
- * Return: void
- *
- * Description: Perform the stated math function on loaded and unloaded numbers. In the case
- * of unloaded numbers the input string is first checked to see if valid.  If so, the operation
- * is performed on the input string and the X (REG0).  If loaded the function is performed on the
- * X and Y register (REG0 and REG1).
- *************************************************************************/
- void call_kph_to_mph(void)
- {
- 
- call_singleLineConvertDivide(MILES_TO_KM_CONVERT);
- 
- } // END OF call_kph_to_mph
-
-
-
-
-/*************************************************************************
- * Function Name: call_mps_to_fps
- * Parameters: void
- * Return: void
- *
- * Description: Perform the stated math function on loaded and unloaded numbers. In the case
- * of unloaded numbers the input string is first checked to see if valid.  If so, the operation
- * is performed on the input string and the X (REG0).  If loaded the function is performed on the
- * X and Y register (REG0 and REG1).
- *************************************************************************/
- void call_mps_to_fps(void)
- {
- 
- call_singleLineConvertMultiply(M_TO_FT_CONVERT);
- 
- } // END OF call_mps_to_fps
-
-
-
-
-/*************************************************************************
- * Function Name: call_fps_to_mps
- * Parameters: void
- * Return: void
- *
- * Description: Perform the stated math function on loaded and unloaded numbers. In the case
- * of unloaded numbers the input string is first checked to see if valid.  If so, the operation
- * is performed on the input string and the X (REG0).  If loaded the function is performed on the
- * X and Y register (REG0 and REG1).
- *************************************************************************/
- void call_fps_to_mps(void)
- {
- 
- call_singleLineConvertDivide(M_TO_FT_CONVERT);
- 
- } // END OF call_fps_to_mps
-
-
-
-
-/*************************************************************************
- * Function Name: call_m_to_ft
- * Parameters: void
- * Return: void
- *
- * Description: Perform the stated math function on loaded and unloaded numbers. In the case
- * of unloaded numbers the input string is first checked to see if valid.  If so, the operation
- * is performed on the input string and the X (REG0).  If loaded the function is performed on the
- * X and Y register (REG0 and REG1).
- *************************************************************************/
- void call_m_to_ft(void)
- {
- 
- call_singleLineConvertMultiply(M_TO_FT_CONVERT);
- 
- } // END OF call_m_to_ft
-
-
-
-
-/*************************************************************************
- * Function Name: call_ft_to_m
- * Parameters: void
- * Return: void
- *
- * Description: Perform the stated math function on loaded and unloaded numbers. In the case
- * of unloaded numbers the input string is first checked to see if valid.  If so, the operation
- * is performed on the input string and the X (REG0).  If loaded the function is performed on the
- * X and Y register (REG0 and REG1).
- *************************************************************************/
- void call_ft_to_m(void)
- {
- 
- call_singleLineConvertDivide(M_TO_FT_CONVERT);
- 
- } // END OF call_ft_to_m
-
-
-
-
-/*************************************************************************
- * Function Name: call_F_to_C
- * Parameters: void
- * Return: void
- *
- * Description: Perform the stated math function on loaded and unloaded numbers. In the case
- * of unloaded numbers the input string is first checked to see if valid.  If so, the operation
- * is performed on the input string and the X (REG0).  If loaded the function is performed on the
- * X and Y register (REG0 and REG1).
- *************************************************************************/
- void call_F_to_C(void)
+ void call_UnitConvert(uint8_t From, uint8_t To)
  {
  
  double TempAns;
  
  // STEP 1
- if (!bln_LineLoaded)
+ if ((From >= UNIT_TOTAL) || (To >= UNIT_TOTAL) || (UnitTable[From].Dimension != UnitTable[To].Dimension))
    {
-   if (call_IsNumericValue(str_InputLine, CalSettings.CalBase) == FALSE)
-     {
-     call_ShowEntryError();
-     return;
-     }
-   // MATH
-   TempAns = (NumericValue.Value - 32.0) / 1.8;
+   strcpy((char *)MathError.ErrorDescription,"Unit mismatch");
+   strcpy((char *)MathError.ErrorSolution,"Same type of units");
+   strcpy((char *)NumericValue.AudioErrorFileName, I_AND_I_ERROR_WAV);
+   NumericValue.AudioPlayLevel = BASIC_HELP;
+   call_ShowMathError();
+   return;
    }
- else
-   TempAns = (RegisterValue[0].NumericValue - 32.0) / 1.8;
  
  // STEP 2
- call_ChkAndDisplayRaise(TempAns);
- 
- } // END OF call_F_to_C
-
-
-
-
-/*************************************************************************
- * Function Name: call_C_to_F
- * Parameters: void
- * Return: void
- *
- * Description: Perform the stated math function on loaded and unloaded numbers. In the case
- * of unloaded numbers the input string is first checked to see if valid.  If so, the operation
- * is performed on the input string and the X (REG0).  If loaded the function is performed on the
- * X and Y register (REG0 and REG1).
- *************************************************************************/
- void call_C_to_F(void)
- {
- 
- double TempAns;
- 
- // STEP 1
  if (!bln_LineLoaded)
    {
    if (call_IsNumericValue(str_InputLine, CalSettings.CalBase) == FALSE)
@@ -992,16 +815,19 @@ void call_Divide(void)
      call_ShowEntryError();
      return;
      }
-   // MATH
-   TempAns = (NumericValue.Value * 1.8) + 32.0;
+   TempAns = NumericValue.Value;
    }
  else
-   TempAns = (RegisterValue[0].NumericValue * 1.8) + 32.0;
+   TempAns = RegisterValue[0].NumericValue;
  
- // STEP 2
+ // STEP 3
+ TempAns = (TempAns + UnitTable[From].Offset) * UnitTable[From].Scale;
+ TempAns = (TempAns / UnitTable[To].Scale) - UnitTable[To].Offset;
+ 
+ // STEP 4
  call_ChkAndDisplayRaise(TempAns);
  
- } // END OF call_C_to_F
+ } // END OF call_UnitConvert
 
 
 
@@ -1026,12 +852,19 @@ void call_Divide(void)
  else
    {
    RegisterValue[3].NumericValue = RegisterValue[2].NumericValue;
+   RegisterValue[3].IntegerValue = RegisterValue[2].IntegerValue;
+   RegisterValue[3].Imaginary = RegisterValue[2].Imaginary;
    RegisterValue[3].Displayed = RegisterValue[2].Displayed;
    RegisterValue[2].NumericValue = RegisterValue[1].NumericValue;
+   RegisterValue[2].IntegerValue = RegisterValue[1].IntegerValue;
+   RegisterValue[2].Imaginary = RegisterValue[1].Imaginary;
    RegisterValue[2].Displayed = RegisterValue[1].Displayed;
    RegisterValue[1].NumericValue = RegisterValue[0].NumericValue;
+   RegisterValue[1].IntegerValue = RegisterValue[0].IntegerValue;
+   RegisterValue[1].Imaginary = RegisterValue[0].Imaginary;
    RegisterValue[1].Displayed = RegisterValue[0].Displayed;
    RegisterValue[0].NumericValue = PI;
+   RegisterValue[0].Imaginary = 0.0;
    RegisterValue[0].Displayed = TRUE;
    }
  
@@ -1063,12 +896,19 @@ void call_Divide(void)
  else
    {
    RegisterValue[3].NumericValue = RegisterValue[2].NumericValue;
+   RegisterValue[3].IntegerValue = RegisterValue[2].IntegerValue;
+   RegisterValue[3].Imaginary = RegisterValue[2].Imaginary;
    RegisterValue[3].Displayed = RegisterValue[2].Displayed;
    RegisterValue[2].NumericValue = RegisterValue[1].NumericValue;
+   RegisterValue[2].IntegerValue = RegisterValue[1].IntegerValue;
+   RegisterValue[2].Imaginary = RegisterValue[1].Imaginary;
    RegisterValue[2].Displayed = RegisterValue[1].Displayed;
    RegisterValue[1].NumericValue = RegisterValue[0].NumericValue;
+   RegisterValue[1].IntegerValue = RegisterValue[0].IntegerValue;
+   RegisterValue[1].Imaginary = RegisterValue[0].Imaginary;
    RegisterValue[1].Displayed = RegisterValue[0].Displayed;
    RegisterValue[0].NumericValue = (2.0 * PI);
+   RegisterValue[0].Imaginary = 0.0;
    RegisterValue[0].Displayed = TRUE;
    }
  
@@ -1232,7 +1072,7 @@ void call_Divide(void)
  CalSettings.CalBase = BASE_10;
  // STEP 2
  call_FormatNumber();
- strcpy(AudioQueueStruct.FileName, DEC_INPUT_WAV);
+ strcpy((char *)AudioQueueStruct.FileName, DEC_INPUT_WAV);
  AudioQueueStruct.FullInteractiveMask = DEC_INPUT_MASK;
  AudioQueueStruct.PlayLevel = FULL_INTERACTIVE;
  ctl_PostMessageByMemAllocate(&AudioQueueStruct);
@@ -1248,7 +1088,8 @@ void call_Divide(void)
  * Return: void
  *
  * Description: Places the calculator in Base16 mode.  Has not effect on loaded
- * numbers.  Unloaded numbers will be dropped from the stack.
+ * numbers.  Unloaded numbers will be dropped from the stack.  Base16 is the integer mode:
+ * on entry the integer stack is loaded from the double stack (see call_IntFromDouble)
  * STEP 1: Sets base 16 mode
  * STEP 2: Display
  *************************************************************************/
@@ -1258,10 +1099,12 @@ void call_Divide(void)
  Type_AudioQueueStruct AudioQueueStruct;
  
  // STEP 1
+ if (CalSettings.CalBase != BASE_16)
+   call_IntLoadStack();
  CalSettings.CalBase = BASE_16;
  // STEP 2
  call_FormatNumber();
- strcpy(AudioQueueStruct.FileName, HEX_INPUT_WAV);
+ strcpy((char *)AudioQueueStruct.FileName, HEX_INPUT_WAV);
  AudioQueueStruct.FullInteractiveMask = HEX_INPUT_MASK;
  AudioQueueStruct.PlayLevel = FULL_INTERACTIVE;
  ctl_PostMessageByMemAllocate(&AudioQueueStruct);
@@ -1285,6 +1128,11 @@ void call_Divide(void)
  {
  
  // STEP 1
+ if (CalSettings.CalBase == BASE_16)
+   {
+   call_IntUnaryOp(INT_ABS);
+   return;
+   }
  if (RegisterValue[0].NumericValue < 0)
    {
    RegisterValue[0].NumericValue *= -1.0;
@@ -1312,7 +1160,9 @@ void call_Divide(void)
  void call_XtoY(void)
  {
  
- double TempAns;
+ double TempAns,
+        TempImaginary;
+ uint64_t TempInt;
  
  // STEP 1
  if (!bln_LineLoaded)
@@ -1323,6 +1173,13 @@ void call_Divide(void)
      return;
      }
    // MATH
+   if (CalSettings.CalBase == BASE_16)
+     {
+     TempInt = RegisterValue[0].IntegerValue;
+     RegisterValue[0].IntegerValue = NumericValue.IntegerValue;
+     call_IntChkAndDisplayRaise(TempInt);
+     return;
+     }
    TempAns = RegisterValue[0].NumericValue;
    RegisterValue[0].NumericValue = NumericValue.Value;
    call_ProcessStackUp(TempAns);
@@ -1330,8 +1187,14 @@ void call_Divide(void)
  else
    {
    TempAns = RegisterValue[1].NumericValue;
+   TempInt = RegisterValue[1].IntegerValue;
+   TempImaginary = RegisterValue[1].Imaginary;
    RegisterValue[1].NumericValue = RegisterValue[0].NumericValue;
+   RegisterValue[1].IntegerValue = RegisterValue[0].IntegerValue;
+   RegisterValue[1].Imaginary = RegisterValue[0].Imaginary;
    RegisterValue[0].NumericValue = TempAns;
+   RegisterValue[0].IntegerValue = TempInt;
+   RegisterValue[0].Imaginary = TempImaginary;
    call_FormatNumber();
    }
  
@@ -1352,14 +1215,22 @@ void call_Divide(void)
  void call_3to2(void)
  {
  
- double TempAns;
+ double TempAns,
+        TempImaginary;
+ uint64_t TempInt;
  
  // STEP 1
  if (bln_LineLoaded)
    {
    TempAns = RegisterValue[3].NumericValue;
+   TempInt = RegisterValue[3].IntegerValue;
+   TempImaginary = RegisterValue[3].Imaginary;
    RegisterValue[3].NumericValue = RegisterValue[2].NumericValue;
+   RegisterValue[3].IntegerValue = RegisterValue[2].IntegerValue;
+   RegisterValue[3].Imaginary = RegisterValue[2].Imaginary;
    RegisterValue[2].NumericValue = TempAns;
+   RegisterValue[2].IntegerValue = TempInt;
+   RegisterValue[2].Imaginary = TempImaginary;
    call_FormatNumber();
    }
 
@@ -1469,10 +1340,10 @@ void call_Divide(void)
      return;
      }
    // MATH
-   TempAns = exp(NumericValue.Value);
+   TempAns = call_KernelExp(NumericValue.Value, CalSettings.KernelMode);
    }
  else
-   TempAns = exp(RegisterValue[0].NumericValue);
+   TempAns = call_KernelExp(RegisterValue[0].NumericValue, CalSettings.KernelMode);
  
  // STEP 2
  call_ChkAndDisplayRaise(TempAns);
@@ -1507,10 +1378,10 @@ void call_Divide(void)
      return;
      }
    // MATH
-   TempAns = log(NumericValue.Value);
+   TempAns = call_KernelLn(NumericValue.Value, CalSettings.KernelMode);
    }
  else
-   TempAns = log(RegisterValue[0].NumericValue);
+   TempAns = call_KernelLn(RegisterValue[0].NumericValue, CalSettings.KernelMode);
  
  // STEP 2
  call_ChkAndDisplayRaise(TempAns);
@@ -1582,10 +1453,18 @@ void call_Divide(void)
      return;
      }
    // MATH
-   TempAns = sqrt(NumericValue.Value);
+   if (CalSettings.DecimalMath)
+     TempAns = call_DecimalOperation(DECIMAL_SQRT, NumericValue.Value, 0);
+   else
+     TempAns = sqrt(NumericValue.Value);
    }
  else
-   TempAns = sqrt(RegisterValue[0].NumericValue);
+   {
+   if (CalSettings.DecimalMath)
+     TempAns = call_DecimalOperation(DECIMAL_SQRT, RegisterValue[0].NumericValue, 0);
+   else
+     TempAns = sqrt(RegisterValue[0].NumericValue);
+   }
  
  // STEP 2
  call_ChkAndDisplayRaise(TempAns);
@@ -1657,10 +1536,10 @@ void call_Divide(void)
      return;
      }
    // MATH
-   TempAns = pow(RegisterValue[0].NumericValue, (1.0/NumericValue.Value));
+   TempAns = call_Root(RegisterValue[0].NumericValue, NumericValue.Value);
    }
  else
-   TempAns = pow(RegisterValue[1].NumericValue, (1.0/RegisterValue[0].NumericValue));
+   TempAns = call_Root(RegisterValue[1].NumericValue, RegisterValue[0].NumericValue);
  
  // STEP 2
  call_ChkAndDisplayDrop(TempAns);
@@ -1670,6 +1549,39 @@ void call_Divide(void)
 
 
 
+/*************************************************************************
+ * Function Name: call_Root
+ * Parameters: double, double
+ * Return: double
+ *
+ * Description: Y^(1/X).  1/X is not exact - its rounding is an error of ln(Y)/X in the
+ * result, many ULP for a large Y and small X.  The part of 1/X lost to the rounding is
+ * found by fma and put back as Y^Low = 1 + Low*ln(Y) (Low is under an ULP of 1/X)
+ * STEP 1: 1/X in two parts
+ * STEP 2: Y to the high part, corrected by the low part
+ *************************************************************************/
+ static double call_Root(double Y, double X)
+ {
+ 
+ double Inverse,
+        InverseLow,
+        Result;
+ 
+ // STEP 1
+ Inverse = 1.0 / X;
+ InverseLow = fma(-Inverse, X, 1.0) / X;
+ 
+ // STEP 2
+ Result = pow(Y, Inverse);
+ if ((InverseLow != 0.0) && (isfinite(Result)) && (Result != 0.0))
+   Result += Result * InverseLow * log(fabs(Y));
+ return(Result);
+ 
+ } // END OF call_Root
+
+
+
+
 /*************************************************************************
  * Function Name: call_OneOverX
  * Parameters: void
@@ -1712,82 +1624,119 @@ void call_Divide(void)
  * Parameters: void
  * Return: void
  *
- * Description: Perform the stated math function on loaded and unloaded numbers. Operates
- * only on a single variable X register (loaded) or line input (unloaded).  The result is
- * stored in Reg X
- * STEP 1: If unloaded check if valid number and check for pre-existing error conditions
- * STEP 2: Check and Display the answer
+ * Description: Perform the stated math function on loaded and unloaded numbers. Operates
+ * only on a single variable X register (loaded) or line input (unloaded).  The result is
+ * stored in Reg X
+ * NOTE: As on the HP-15C x! of a non integer is Gamma(x+1).  Integers 0 to MAX_FACTORIAL are
+ * read from a table - the result is the same double every time.  All other values are by
+ * call_Factorial.  There is no loop on X so every input returns in the same bounded time.
+ * STEP 1: If unloaded check if valid number and check for pre-existing error conditions
+ * STEP 2: Check for errors: negative integer (undefined) and too large (overflow)
+ * STEP 3: Table for integers - Gamma for all others
+ * STEP 4: Check and Display the answer
+ *************************************************************************/
+ void call_Xfactorial(void)
+ {
+ 
+ double Value,
+        TempAns;
+ 
+ // STEP 1
+ if (!bln_LineLoaded)
+   {
+   if (call_IsNumericValue(str_InputLine, CalSettings.CalBase) == FALSE)
+     {
+     call_ShowEntryError();
+     return;
+     }
+   Value = NumericValue.Value;
+   }
+ else
+   Value = RegisterValue[0].NumericValue;
+ 
+ // STEP 2
+ // MATH CHECK FOR ERRORS: NEGATIVE INTEGER - GAMMA HAS A POLE
+ if ((Value < 0) && (floor(Value) == Value))
+   {
+   strcpy((char *)MathError.ErrorDescription, "Negative X!");
+   strcpy((char *)MathError.ErrorSolution, "Undefined X!");
+   strcpy((char *)NumericValue.AudioErrorFileName, I_AND_I_ERROR_WAV);
+   NumericValue.AudioPlayLevel = BASIC_HELP;
+   call_ShowMathError();
+   return;
+   }
+ // MATH CHECK FOR ERRORS: RESULT LARGER THAN A DOUBLE
+ if (Value > MAX_FACTORIAL_ARGUMENT)
+   {
+   //                                   01234567890123456789
+   strcpy((char *)MathError.ErrorDescription, "X! overflow");
+   strcpy((char *)MathError.ErrorSolution,    "X must be < 170.62");
+   strcpy((char *)NumericValue.AudioErrorFileName, VALUE_TOO_LARGE_WAV);
+   NumericValue.AudioPlayLevel = BASIC_HELP;
+   call_ShowMathError();
+   return;
+   }
+ 
+ // STEP 3
+ if ((floor(Value) == Value) && (Value <= MAX_FACTORIAL))
+   TempAns = FactorialTable[(uint8_t)Value];
+ else
+   TempAns = call_Factorial(Value);
+ 
+ // STEP 4
+ call_ChkAndDisplayRaise(TempAns);
+ 
+ } // END OF call_Xfactorial
+
+
+
+
+/*************************************************************************
+ * Function Name: call_Factorial
+ * Parameters: double
+ * Return: double
+ *
+ * Description: x! = Gamma(x + 1) by the Lanczos approximation (g = 671/128, 15 terms) - good
+ * to about 16 digits.  The series is in x itself: x + 1 - 1 would round x above 1 and the error
+ * grows with ln x.  Below -0.5 the reflection formula is used:
+ * x! = PI*x / (sin(PI*x) * (-x)!) with the sin of x less its nearest integer (exact) - near
+ * a pole PI*x itself would lose the digits of the sin.  The power term
+ * is t^(x/2) twice (x/2 is exact, x + 0.5 is not) and sqrt(t) so it does not overflow before
+ * the exp term brings it back into range.  Fixed work for any x.
+ * NOTE: The caller must check for the poles (-1, -2...) and overflow
+ * STEP 1: Reflect if below -0.5
+ * STEP 2: Lanczos series
+ * STEP 3: x! from the series
  *************************************************************************/
- void call_Xfactorial(void)
+ static double call_Factorial(double X)
  {
  
- double TempAns = 1.0;
+ double Series,
+        T,
+        HalfPower,
+        Nearest;
  
  // STEP 1
- if (!bln_LineLoaded)
-   {
-   if (call_IsNumericValue(str_InputLine, CalSettings.CalBase) == FALSE)
-     {
-     call_ShowEntryError();
-     return;
-     }
-   // MATH CHECK FOR ERRORS: NEGATIVE
-   if (NumericValue.Value < 0)
-     {
-     strcpy(MathError.ErrorDescription, "Negative X!");
-     strcpy(MathError.ErrorSolution, "Undefined X!");
-     call_ShowMathError();
-     return;
-     }
-   // MATH CHECK FOR ERRORS: NON INTEGER
-   if ((NumericValue.Value - (int32_t)NumericValue.Value) != 0.0)
-     {
-     strcpy(MathError.ErrorDescription, "Improper number");
-     strcpy(MathError.ErrorSolution, "Only INT32 valid");
-     call_ShowMathError();
-     return;
-     }
-   // MATH
-   if (NumericValue.Value == 0.0)
-     TempAns = 1.0;
-   while (NumericValue.Value > 1)
-     {
-       TempAns *= NumericValue.Value;
-       NumericValue.Value--;
-     }
-   }
- else // Loaded number
+ if (X < -0.5)
    {
-   // MATH CHECK FOR ERRORS: NEGATIVE
-   if (RegisterValue[0].NumericValue < 0)
-     {
-     strcpy(MathError.ErrorDescription, "Negative X!");
-     strcpy(MathError.ErrorSolution, "Undefined X!");
-     call_ShowMathError();
-     return;
-     }
-   // MATH CHECK FOR ERRORS: NON INTEGER
-   if ((RegisterValue[0].NumericValue - (int32_t)RegisterValue[0].NumericValue) != 0.0)
-     {
-     strcpy(MathError.ErrorDescription, "Improper number");
-     strcpy(MathError.ErrorSolution, "Only INT32 valid");
-     call_ShowMathError();
-     return;
-     }
-   // FACTORIAL MATH
-   if (RegisterValue[0].NumericValue == 0.0)
-     TempAns = 1.0;
-   while (RegisterValue[0].NumericValue > 1)
-     {
-       TempAns *= RegisterValue[0].NumericValue;
-       RegisterValue[0].NumericValue--;
-     }
+   Nearest = rint(X);
+   Series = sin(GAMMA_PI * (X - Nearest));
+   if (fmod(Nearest, 2.0) != 0.0)
+     Series = -Series;
+   return((GAMMA_PI * X) / (Series * call_Factorial(-X)));
    }
  
  // STEP 2
- call_ChkAndDisplayRaise(TempAns);
+ Series = LanczosCoef[0];
+ for (uint8_t Term = 1; Term < LANCZOS_TERMS; Term++)
+   Series += LanczosCoef[Term] / (X + Term);
  
- } // END OF call_Xfactorial
+ // STEP 3
+ T = X + LANCZOS_G + 0.5;
+ HalfPower = pow(T, (X / 2.0));
+ return(SQRT_2PI * HalfPower * exp(-T) * HalfPower * sqrt(T) * Series);
+ 
+ } // END OF call_Factorial
 
 
 
@@ -1811,7 +1760,7 @@ void call_Divide(void)
    
    // STEP 2
    DIP204_ICON_set(ICON_TEMP, ICON_ON);
-   strcpy(AudioQueueStruct.FileName, ANGULAR_RAD_WAV);
+   strcpy((char *)AudioQueueStruct.FileName, ANGULAR_RAD_WAV);
    AudioQueueStruct.FullInteractiveMask = ANGULAR_RAD_MASK;
    AudioQueueStruct.PlayLevel = FULL_INTERACTIVE;
    ctl_PostMessageByMemAllocate(&AudioQueueStruct);
@@ -1841,7 +1790,7 @@ void call_Divide(void)
    
    // STEP 2
    DIP204_ICON_set(ICON_TEMP, ICON_OFF);
-   strcpy(AudioQueueStruct.FileName, ANGULAR_DEGREE_WAV);
+   strcpy((char *)AudioQueueStruct.FileName, ANGULAR_DEGREE_WAV);
    AudioQueueStruct.FullInteractiveMask = ANGULAR_DEGREE_MASK;
    AudioQueueStruct.PlayLevel = FULL_INTERACTIVE;
    ctl_PostMessageByMemAllocate(&AudioQueueStruct);
@@ -1859,17 +1808,15 @@ void call_Divide(void)
  * Description: Perform the stated math function on loaded and unloaded numbers. Operates
  * only on a single variable X register (loaded) or line input (unloaded).  The result is
  * stored in Reg X
- * STEP 1: Check for special case
- * STEP 2: If unloaded check if valid number and check for pre-existing error conditions
- * STEP 3: Check and Display the answer
+ * STEP 1: If unloaded check if valid number and check for pre-existing error conditions
+ * STEP 2: Check and Display the answer
  *************************************************************************/
  void call_sinX(void)
  {
  
- double TempAns,
-        AnsShouldBe;
+ double TempAns;
  
- // STEP 2
+ // STEP 1
  if (!bln_LineLoaded)
    {
    if (call_IsNumericValue(str_InputLine, CalSettings.CalBase) == FALSE)
@@ -1877,34 +1824,13 @@ void call_Divide(void)
      call_ShowEntryError();
      return;
      }
-   // CHECK SPECIAL CASE
-   if (call_CheckSinSpecialCase(&NumericValue.Value, &AnsShouldBe))
-     TempAns = AnsShouldBe;
    // MATH
-   else
-     {
-     if (CalSettings.CalAngle == DEGREES)
-       TempAns = sin(NumericValue.Value*PI/180.0);
-     else
-       TempAns = sin(NumericValue.Value);
-     }
+   TempAns = call_KernelSin(NumericValue.Value, CalSettings.CalAngle, CalSettings.KernelMode);
    }
  else
-   {
-   // CHECK SPECIAL CASE
-   if (call_CheckSinSpecialCase(&RegisterValue[0].NumericValue, &AnsShouldBe))
-     TempAns = AnsShouldBe;
-   // MATH
-   else
-     {
-     if (CalSettings.CalAngle == DEGREES)
-       TempAns = sin(RegisterValue[0].NumericValue*PI/180.0);
-     else
-       TempAns = sin(RegisterValue[0].NumericValue);
-     }
-   }
+   TempAns = call_KernelSin(RegisterValue[0].NumericValue, CalSettings.CalAngle, CalSettings.KernelMode);
  
- // STEP 3
+ // STEP 2
  call_ChkAndDisplayRaise(TempAns);
  
  } // END OF call_sinX
@@ -1912,50 +1838,6 @@ void call_Divide(void)
 
 
 
-/*************************************************************************
- * Function Name: call_CheckSinSpecialCase
- * Parameters: const double *, double *
- * Return: BOOLEAN
- *
- * Description: Checks for trig sin special cases of 0, and 180 degrees (and factors).  These
- * special cases are not covered due to computer estimations.  The funciton is passed
- * the value to check and a pointer in which the correct answer (if a special case) is to
- * be loaded
- * STEP 1: Work in degree mode
- * STEP 2: Check for the error condition
- *************************************************************************/
- static BOOLEAN call_CheckSinSpecialCase(const double *Value, double *Answer)
- {
- 
- double ChkValue = *Value;
- 
- // STEP 1
- // CONVERT TO DEGREES
- if (CalSettings.CalAngle != DEGREES)
-   {
-   ChkValue = ChkValue * 180.0/PI;
-   }
- 
- // STEP 2
- // CHECK IF A MULTIPLE OF 0 OR 180 - WORK IN ABSOLUTES
- if (ChkValue < 0)
-   ChkValue *= -1.0;
- if ((ChkValue - (uint32_t)ChkValue) == 0)
-   {
-   if ((((uint32_t)ChkValue % 180) == 0) || ChkValue == 0)
-     {
-     *Answer = 0;
-     return(TRUE);
-     }
-   }
- 
- return(FALSE);
- } // END OF call_CheckSinSpecialCase
- 
-
-
-
-
 /*************************************************************************
  * Function Name: call_cosX
  * Parameters: void
@@ -1970,8 +1852,7 @@ void call_Divide(void)
  void call_cosX(void)
  {
  
- double TempAns,
-        AnsShouldBe;
+ double TempAns;
  
  // STEP 1
  if (!bln_LineLoaded)
@@ -1981,32 +1862,11 @@ void call_Divide(void)
      call_ShowEntryError();
      return;
      }
-   // CHECK SPECIAL CASE
-   if (call_CheckCosSpecialCase(&NumericValue.Value, &AnsShouldBe))
-     TempAns = AnsShouldBe;
    // MATH
-   else
-     {
-     if (CalSettings.CalAngle == DEGREES)
-       TempAns = cos(NumericValue.Value*PI/180.0);
-     else
-       TempAns = cos(NumericValue.Value);
-     }
+   TempAns = call_KernelCos(NumericValue.Value, CalSettings.CalAngle, CalSettings.KernelMode);
    }
  else
-   {
-   // CHECK SPECIAL CASE
-   if (call_CheckCosSpecialCase(&RegisterValue[0].NumericValue, &AnsShouldBe))
-     TempAns = AnsShouldBe;
-   else
-     {
-     // MATH
-     if (CalSettings.CalAngle == DEGREES)
-       TempAns = cos(RegisterValue[0].NumericValue*PI/180.0);
-     else
-       TempAns = cos(RegisterValue[0].NumericValue);
-     }
-   }
+   TempAns = call_KernelCos(RegisterValue[0].NumericValue, CalSettings.CalAngle, CalSettings.KernelMode);
  
  // STEP 2
  call_ChkAndDisplayRaise(TempAns);
@@ -2016,61 +1876,6 @@ void call_Divide(void)
 
 
 
-/*************************************************************************
- * Function Name: call_CheckCosSpecialCase
- * Parameters: const double *, double *
- * Return: BOOLEAN
- *
- * Description: Checks for trig cos special cases of 90 degrees (and factors).  These
- * special cases are not covered due to computer estimations.  The funciton is passed
- * the value to check and a pointer in which the correct answer (if a special case) is to
- * be loaded
- * STEP 1: Work in degree mode
- * STEP 2: Check for the error condition
- *************************************************************************/
- static BOOLEAN call_CheckCosSpecialCase(const double *Value, double *Answer)
- {
- 
- double ChkValue = *Value;
- 
- // STEP 1
- // CONVERT TO DEGREES
- if (CalSettings.CalAngle != DEGREES)
-   {
-   ChkValue = ChkValue * 180.0/PI;
-   }
- 
- // STEP 2
- // CHECK IF 90 DEGREE OR REPEATED BY 180
- // WORK IN ABSOLUTES
- if (ChkValue < 0)
-   ChkValue *= -1.0;
- // LESS THAN 90
- if (ChkValue < 90)
-   return(FALSE);
- // EQAUL TO 90
- if (ChkValue == 90)
-   {
-   *Answer = 0;
-   return(TRUE);
-   }
- // GREATER THAN 90
- if (ChkValue > 90)
-   {
-   ChkValue -= 90;
-   if (((uint32_t)ChkValue % 180) == 0)
-     {
-     *Answer = 0;
-     return(TRUE);
-     }
-   }
- 
- return(FALSE);
- } // END OF call_CheckCosSpecialCase
-
-
-
-
 /*************************************************************************
  * Function Name: call_tanX
  * Parameters: void
@@ -2085,8 +1890,7 @@ void call_Divide(void)
  void call_tanX(void)
  {
  
- double TempAns,
-        AnsShouldBe;
+ double TempAns;
  
  // STEP 1
  if (!bln_LineLoaded)
@@ -2096,31 +1900,11 @@ void call_Divide(void)
      call_ShowEntryError();
      return;
      }
-   // CHECK SPECIAL CASE
-   if (call_CheckTanSpecialCase(&NumericValue.Value, &AnsShouldBe))
-     TempAns = AnsShouldBe;
-   else
-     {
-     // MATH
-     if (CalSettings.CalAngle == DEGREES)
-       TempAns = tan(NumericValue.Value*PI/180.0);
-     else
-       TempAns = tan(NumericValue.Value);
-     }
+   // MATH
+   TempAns = call_KernelTan(NumericValue.Value, CalSettings.CalAngle, CalSettings.KernelMode);
    }
  else
-   {
-   if (call_CheckTanSpecialCase(&RegisterValue[0].NumericValue, &AnsShouldBe))
-     TempAns = AnsShouldBe;
-   else
-     {
-     // MATH
-     if (CalSettings.CalAngle == DEGREES)
-       TempAns = tan(RegisterValue[0].NumericValue*PI/180.0);
-     else
-       TempAns = tan(RegisterValue[0].NumericValue);
-     }
-   }
+   TempAns = call_KernelTan(RegisterValue[0].NumericValue, CalSettings.CalAngle, CalSettings.KernelMode);
  
  // STEP 2
  call_ChkAndDisplayRaise(TempAns);
@@ -2130,46 +1914,6 @@ void call_Divide(void)
 
 
 
-/*************************************************************************
- * Function Name: call_CheckTanSpecialCase
- * Parameters: const double *, double *
- * Return: BOOLEAN
- *
- * Description: Checks for trig tan special cases of 0, 90, 180 degrees (and factors).  These
- * special cases are not covered due to computer estimations.  The function is passed
- * the value to check and a pointer in which the correct answer (if a special case) is to
- * be loaded.  tanX = sinX/CosX
- * STEP 1: Check for cosX special case (0) if so return infinity
- * STEP 2: Check for sinX special case (0) if so return 0
- *************************************************************************/
- static BOOLEAN call_CheckTanSpecialCase(const double *Value, double *Answer)
- {
- 
- double Result;
- 
- /* TAN = sinX/cosX 
-  * CHECK FOR sinX = 0
-  * CHECK FOR cosX = 0 */
-  // STEP 1
- if (call_CheckCosSpecialCase(Value, &Result))
-   {
-   *Answer = sqrt(-1); // FORCE AN INFINTE - UNREAL ERROR
-    return(TRUE);
-   }
-  // STEP 2
- if (call_CheckSinSpecialCase(Value, &Result))
-   {
-    *Answer = Result; // RESULT IS 0
-    return(TRUE);
-   }
-  
- return(FALSE);
-
- } // END OF call_CheckTanSpecialCase
-
-
-
-
 /*************************************************************************
  * Function Name: call_asinX
  * Parameters: void
@@ -2196,14 +1940,14 @@ void call_Divide(void)
      }
    // MATH
    if (CalSettings.CalAngle == DEGREES)
-     TempAns = (180.0/PI) * asin(NumericValue.Value);
+     TempAns = KERNEL_RAD_TO_DEG * asin(NumericValue.Value);
    else
      TempAns = asin(NumericValue.Value);
    }
  else
    {
    if (CalSettings.CalAngle == DEGREES)
-     TempAns = (180.0/PI) * asin(RegisterValue[0].NumericValue);
+     TempAns = KERNEL_RAD_TO_DEG * asin(RegisterValue[0].NumericValue);
    else
      TempAns = asin(RegisterValue[0].NumericValue);
    }
@@ -2242,14 +1986,14 @@ void call_Divide(void)
      }
    // MATH
    if (CalSettings.CalAngle == DEGREES)
-     TempAns = (180.0/PI) * acos(NumericValue.Value);
+     TempAns = KERNEL_RAD_TO_DEG * acos(NumericValue.Value);
    else
      TempAns = acos(NumericValue.Value);
    }
  else
    {
    if (CalSettings.CalAngle == DEGREES)
-     TempAns = (180.0/PI) * acos(RegisterValue[0].NumericValue);
+     TempAns = KERNEL_RAD_TO_DEG * acos(RegisterValue[0].NumericValue);
    else
      TempAns = acos(RegisterValue[0].NumericValue);
    }
@@ -2288,14 +2032,14 @@ void call_Divide(void)
      }
    // MATH
    if (CalSettings.CalAngle == DEGREES)
-     TempAns = (180.0/PI) * atan(NumericValue.Value);
+     TempAns = KERNEL_RAD_TO_DEG * atan(NumericValue.Value);
    else
      TempAns = atan(NumericValue.Value);
    }
  else
    {
    if (CalSettings.CalAngle == DEGREES)
-     TempAns = (180.0/PI) * atan(RegisterValue[0].NumericValue);
+     TempAns = KERNEL_RAD_TO_DEG * atan(RegisterValue[0].NumericValue);
    else
      TempAns = atan(RegisterValue[0].NumericValue);
    }
@@ -2393,9 +2137,9 @@ void call_Divide(void)
  * Description: Calculates the Rectangular coordinates from the given Polar form. 
  * Works on loaded and unloaded numbers.  For unloaded numbers the Angle is in X,
  * while the Resultant is the line input.  For loaded the Angle is Y and the Resultant
- * is X 
- * STEP 1: Create Angle multiplier for dealing with Cal Angle Mode
- * STEP 2: Perform the math
+ * is X.  x = R cos, y = R sin by the kernel - any quadrant, and in DEGREES the reduction
+ * is exact so 90, 180... give an exact 0
+ * STEP 1: Perform the math
  *************************************************************************/
  void call_PtoR(void)
  {
@@ -2404,12 +2148,6 @@ void call_Divide(void)
  Type_AudioQueueStruct AudioQueueStruct;
  
  // STEP 1
- if (CalSettings.CalAngle == DEGREES)
-   Angle = PI / 180.0;
- else
-   Angle = 1.0;
- 
- // STEP 2
  if (!bln_LineLoaded)
    {
    if (call_IsNumericValue(str_InputLine, CalSettings.CalBase) == FALSE)
@@ -2419,20 +2157,20 @@ void call_Divide(void)
      }
    // MATH
    R = NumericValue.Value;
-   Angle *= RegisterValue[0].NumericValue;
-   RegisterValue[0].NumericValue = sqrt(pow(R,2)/(1.0 + (1.0/pow(tan(Angle),2))));
-   R = sqrt(pow(R,2) - pow(RegisterValue[0].NumericValue,2));
+   Angle = RegisterValue[0].NumericValue;
+   RegisterValue[0].NumericValue = R * call_KernelSin(Angle, CalSettings.CalAngle, CalSettings.KernelMode);
+   R *= call_KernelCos(Angle, CalSettings.CalAngle, CalSettings.KernelMode);
    call_ChkAndDisplayRaise(R);
    }
  else
    {
    R = RegisterValue[0].NumericValue;
-   Angle *= RegisterValue[1].NumericValue;
-   RegisterValue[1].NumericValue = sqrt(pow(R,2)/(1.0 + (1.0/pow(tan(Angle),2))));
-   RegisterValue[0].NumericValue = sqrt(pow(R,2) - pow(RegisterValue[1].NumericValue,2));
+   Angle = RegisterValue[1].NumericValue;
+   RegisterValue[1].NumericValue = R * call_KernelSin(Angle, CalSettings.CalAngle, CalSettings.KernelMode);
+   RegisterValue[0].NumericValue = R * call_KernelCos(Angle, CalSettings.CalAngle, CalSettings.KernelMode);
    call_FormatNumber();
    }
-   strcpy(AudioQueueStruct.FileName, VERIFY_ANG_MEASURE_WAV);
+   strcpy((char *)AudioQueueStruct.FileName, VERIFY_ANG_MEASURE_WAV);
    AudioQueueStruct.FullInteractiveMask = VERIFY_ANG_MEASURE_MASK;
    AudioQueueStruct.PlayLevel = FULL_INTERACTIVE;
    ctl_PostMessageByMemAllocate(&AudioQueueStruct);
@@ -2450,7 +2188,8 @@ void call_Divide(void)
  * Description: Calculates the Polar coordinates from the given Rectangular form. 
  * Works on loaded and unloaded numbers.  For unloaded numbers the imaginary is in X,
  * while the real is the line input.  For loaded the imaginary is Y and the real
- * is X 
+ * is X.  The resultant is hypot (no overflow of the squares) and the angle atan2 - the
+ * quadrant is kept, -180 to 180
  * STEP 1: Create Angle multiplier for dealing with Cal Angle Mode
  * STEP 2: Perform the math
  *************************************************************************/
@@ -2462,7 +2201,7 @@ void call_Divide(void)
  
  // STEP 1
  if (CalSettings.CalAngle == DEGREES)
-   Angle = 180.0/PI;
+   Angle = KERNEL_RAD_TO_DEG;
  else
    Angle = 1.0;
  
@@ -2476,18 +2215,18 @@ void call_Divide(void)
      }
    // MATH
    Imaginary = RegisterValue[0].NumericValue;
-   RegisterValue[0].NumericValue = Angle * atan(Imaginary/NumericValue.Value);
-   NumericValue.Value = sqrt(pow(NumericValue.Value,2) + pow(Imaginary,2));
+   RegisterValue[0].NumericValue = Angle * atan2(Imaginary, NumericValue.Value);
+   NumericValue.Value = hypot(NumericValue.Value, Imaginary);
    call_ChkAndDisplayRaise(NumericValue.Value);
    }
  else
    {
    Imaginary = RegisterValue[1].NumericValue;
-   RegisterValue[1].NumericValue = Angle * atan(Imaginary/RegisterValue[0].NumericValue);
-   RegisterValue[0].NumericValue = sqrt(pow(RegisterValue[0].NumericValue,2) + pow(Imaginary,2));
+   RegisterValue[1].NumericValue = Angle * atan2(Imaginary, RegisterValue[0].NumericValue);
+   RegisterValue[0].NumericValue = hypot(RegisterValue[0].NumericValue, Imaginary);
    call_FormatNumber();
    }
-   strcpy(AudioQueueStruct.FileName, VERIFY_ANG_MEASURE_WAV);
+   strcpy((char *)AudioQueueStruct.FileName, VERIFY_ANG_MEASURE_WAV);
    AudioQueueStruct.FullInteractiveMask = VERIFY_ANG_MEASURE_MASK;
    AudioQueueStruct.PlayLevel = FULL_INTERACTIVE;
    ctl_PostMessageByMemAllocate(&AudioQueueStruct);
@@ -2510,11 +2249,20 @@ void call_Divide(void)
  void call_StatClear(void)
  {
  
+ // STEP 1
  Stat.Count = 0;
- Stat.Sum = 0.0;
- Stat.Mean = 0.0;
- Stat.DiffSquareSum = 0.0;
- Stat.StanDev = 0.0;
+ Stat.SumX = 0.0;
+ Stat.SumY = 0.0;
+ Stat.SumXY = 0.0;
+ Stat.SumX2 = 0.0;
+ Stat.SumY2 = 0.0;
+ Stat.MeanX = 0.0;
+ Stat.MeanY = 0.0;
+ Stat.M2X = 0.0;
+ Stat.M2Y = 0.0;
+ Stat.CoMomentXY = 0.0;
+ 
+ // STEP 2
  DIP204_ICON_set(ICON_MAIL, ICON_OFF);
  
  } // END OF call_StatClear
@@ -2527,9 +2275,11 @@ void call_Divide(void)
  * Parameters: void
  * Return: void
  *
- * Description: Works on loaded and unloaded values.  Takes the value and adds
- * to the Stat computation for mean and standard deviation.  The Count, Sum, DiffSquareSum
- * and mean are all updated.  The count is loaded to the X register and that is displayed.
+ * Description: Works on loaded and unloaded values.  As on the HP-15C the sample is
+ * the pair x (X register or line input) and y (Y register, or X register if unloaded).
+ * For single variable stats y can be left as is.  The pair is added to the Stat computation
+ * for mean, standard deviation and linear regression.  The count is loaded to the X register
+ * and that is displayed.
  * STEP 1: Process the stat by calling associated function
  * STEP 2: Display and set stat store icon
  *************************************************************************/
@@ -2547,10 +2297,10 @@ void call_Divide(void)
      return;
      }
    // MATH
-   TempAns = call_statCalUpdate(NumericValue.Value);
+   TempAns = call_statCalUpdate(NumericValue.Value, RegisterValue[0].NumericValue);
    }
  else
-   TempAns = call_statCalUpdate(RegisterValue[0].NumericValue);
+   TempAns = call_statCalUpdate(RegisterValue[0].NumericValue, RegisterValue[1].NumericValue);
  
  // STEP 2
  DIP204_ICON_set(ICON_MAIL, ICON_ON);
@@ -2563,20 +2313,38 @@ void call_Divide(void)
  
 /*************************************************************************
  * Function Name: call_statCalUpdate
- * Parameters: double
- * Return: uint8_t
+ * Parameters: double, double
+ * Return: uint32_t
  *
- * Description: Updates the Count, Sum, and Mean.  Returns the 
- * present count.
- * STEP 1: 
+ * Description: Adds the pair x, y to the stat sums.  Returns the present count.
+ * The mean, squared differences and co-moment are by Welford's method - each is updated
+ * from the one sample so there is no sample storage, no limit on the count and the
+ * time per sample is fixed.  The plain sums are kept as well (as in the HP-15C registers).
+ * STEP 1: Update count and plain sums
+ * STEP 2: Welford update - the diff from the old mean times the diff from the new mean
  *************************************************************************/
- uint8_t call_statCalUpdate(double Xi)
+ uint32_t call_statCalUpdate(double Xi, double Yi)
  {
-   
- Stat.X[Stat.Count] = Xi;
+ 
+ double DiffX,
+        DiffY;
+ 
+ // STEP 1
  Stat.Count++;
- Stat.Sum += Xi;
- Stat.Mean = Stat.Sum/Stat.Count;
+ Stat.SumX += Xi;
+ Stat.SumY += Yi;
+ Stat.SumXY += Xi * Yi;
+ Stat.SumX2 += Xi * Xi;
+ Stat.SumY2 += Yi * Yi;
+ 
+ // STEP 2
+ DiffX = Xi - Stat.MeanX;
+ DiffY = Yi - Stat.MeanY;
+ Stat.MeanX += DiffX / Stat.Count;
+ Stat.MeanY += DiffY / Stat.Count;
+ Stat.M2X += DiffX * (Xi - Stat.MeanX);
+ Stat.M2Y += DiffY * (Yi - Stat.MeanY);
+ Stat.CoMomentXY += DiffX * (Yi - Stat.MeanY);
  return(Stat.Count);
  
  } // END OF call_statCalUpdate
@@ -2584,18 +2352,51 @@ void call_Divide(void)
 
 
 
+/*************************************************************************
+ * Function Name: call_StatCheckData
+ * Parameters: uint32_t
+ * Return: BOOLEAN
+ *
+ * Description: Checks there are at least the number of samples needed for the stat
+ * function.  If not shows math error and returns FALSE.
+ * STEP 1: Check count
+ *************************************************************************/
+ static BOOLEAN call_StatCheckData(uint32_t SamplesNeeded)
+ {
+ 
+ // STEP 1
+ if (Stat.Count < SamplesNeeded)
+   {
+   //                                   01234567890123456789
+   strcpy((char *)MathError.ErrorDescription, "Not enough data");
+   sprintf((char *)MathError.ErrorSolution,    "Need %lu samples", SamplesNeeded);
+   strcpy((char *)NumericValue.AudioErrorFileName, I_AND_I_ERROR_WAV);
+   NumericValue.AudioPlayLevel = BASIC_HELP;
+   call_ShowMathError();
+   return(FALSE);
+   }
+ return(TRUE);
+ 
+ } // END OF call_StatCheckData
+
+
+
+
 /*************************************************************************
  * Function Name: call_Mean
  * Parameters: void
  * Return: void
  *
- * Description: Returns the stat mean from structure to the loaded X register
+ * Description: Returns the stat mean of x from structure to the loaded X register
  * STEP 1: 
  *************************************************************************/
  void call_Mean(void)
  {
  
- RegisterValue[0].NumericValue = Stat.Mean;
+ // STEP 1
+ if (call_StatCheckData(1) == FALSE)
+   return;
+ RegisterValue[0].NumericValue = Stat.MeanX;
  call_FormatNumber();
  
  } // END OF call_Mean
@@ -2609,7 +2410,7 @@ void call_Divide(void)
  * Return: void
  *
  * Description: Returns the stat standard deviation on x from stat structure to 
- * the loaded X register.
+ * the loaded X register.  Read from the Welford sum - no pass over the samples.
  * STEP 1: Calculate SDx
  * STEP 2: Display
  *************************************************************************/
@@ -2617,12 +2418,9 @@ void call_Divide(void)
  {
  
  // STEP 1
- Stat.DiffSquareSum = 0.0;
- for (uint8_t Count = 0; Count < Stat.Count; Count++)
-   {
-   Stat.DiffSquareSum += pow((Stat.X[Count] - Stat.Mean),2);
-   }
- RegisterValue[0].NumericValue = sqrt((1.0 / Stat.Count) * Stat.DiffSquareSum);
+ if (call_StatCheckData(1) == FALSE)
+   return;
+ RegisterValue[0].NumericValue = sqrt(Stat.M2X / Stat.Count);
  
  // STEP 2
  call_FormatNumber();
@@ -2632,6 +2430,119 @@ void call_Divide(void)
 
 
 
+/*************************************************************************
+ * Function Name: call_LinearRegression
+ * Parameters: void
+ * Return: void
+ *
+ * Description: As L.R. on the HP-15C.  Fits y = Ax + B to the stat data by least squares.
+ * The stack is pushed up twice: the y intercept B is placed in X and the slope A in Y.
+ * An unloaded value is discarded.
+ * STEP 1: Check for enough data and for x values that are not all the same
+ * STEP 2: Slope and intercept from the Welford sums
+ * STEP 3: Push the stack and display
+ *************************************************************************/
+ void call_LinearRegression(void)
+ {
+ 
+ double Slope,
+        Intercept;
+ 
+ // STEP 1
+ if (call_StatCheckData(2) == FALSE)
+   return;
+ if (Stat.M2X == 0.0)
+   {
+   //                                   01234567890123456789
+   strcpy((char *)MathError.ErrorDescription, "All x the same");
+   strcpy((char *)MathError.ErrorSolution,    "Slope is infinite");
+   strcpy((char *)NumericValue.AudioErrorFileName, I_AND_I_ERROR_WAV);
+   NumericValue.AudioPlayLevel = BASIC_HELP;
+   call_ShowMathError();
+   return;
+   }
+ 
+ // STEP 2
+ Slope = Stat.CoMomentXY / Stat.M2X;
+ Intercept = Stat.MeanY - (Slope * Stat.MeanX);
+ 
+ // STEP 3
+ // EACH PUSH IS AS IF UNLOADED SO THE STACK RAISES - ANY LINE INPUT IS DROPPED
+ bln_LineLoaded = FALSE;
+ call_ProcessStackUp(Slope);
+ bln_LineLoaded = FALSE;
+ call_ProcessStackUp(Intercept);
+ 
+ } // END OF call_LinearRegression
+
+
+
+
+/*************************************************************************
+ * Function Name: call_EstimateYandR
+ * Parameters: void
+ * Return: void
+ *
+ * Description: As y,r on the HP-15C.  For the x in the X register (loaded) or the
+ * line input (unloaded) the estimate of y from the regression line is placed in X and the
+ * correlation coefficient r is placed in Y.  The x value is replaced, the stack is pushed once.
+ * STEP 1: Get x - if unloaded check if valid number
+ * STEP 2: Check for enough data and for x or y values that are not all the same
+ * STEP 3: Estimate and correlation from the Welford sums
+ * STEP 4: Push the stack and display
+ *************************************************************************/
+ void call_EstimateYandR(void)
+ {
+ 
+ double ValueX,
+        Estimate,
+        Correlation;
+ 
+ // STEP 1
+ if (!bln_LineLoaded)
+   {
+   if (call_IsNumericValue(str_InputLine, CalSettings.CalBase) == FALSE)
+     {
+     call_ShowEntryError();
+     return;
+     }
+   ValueX = NumericValue.Value;
+   }
+ else
+   ValueX = RegisterValue[0].NumericValue;
+ 
+ // STEP 2
+ if (call_StatCheckData(2) == FALSE)
+   return;
+ if ((Stat.M2X == 0.0) || (Stat.M2Y == 0.0))
+   {
+   //                                   01234567890123456789
+   strcpy((char *)MathError.ErrorDescription, "All x or y same");
+   strcpy((char *)MathError.ErrorSolution,    "r is undefined");
+   strcpy((char *)NumericValue.AudioErrorFileName, I_AND_I_ERROR_WAV);
+   NumericValue.AudioPlayLevel = BASIC_HELP;
+   call_ShowMathError();
+   return;
+   }
+ 
+ // STEP 3
+ Estimate = Stat.MeanY + ((Stat.CoMomentXY / Stat.M2X) * (ValueX - Stat.MeanX));
+ Correlation = Stat.CoMomentXY / sqrt(Stat.M2X * Stat.M2Y);
+ 
+ // STEP 4
+ // r REPLACES x (A LINE INPUT IS RAISED FIRST) - THE ESTIMATE IS PUSHED ON TOP
+ if (bln_LineLoaded)
+   RegisterValue[0].NumericValue = Correlation;
+ else
+   call_ProcessStackUp(Correlation);
+ bln_LineLoaded = FALSE;
+ call_ProcessStackUp(Estimate);
+ 
+ } // END OF call_EstimateYandR
+
+
+
+
 /*************************************************************************
  * Function Name: call_DeltaPercent
  * Parameters: void
@@ -2659,8 +2570,8 @@ void call_Divide(void)
    // CHECK FOR DIVIDE BY ZERO.
    if (RegisterValue[0].NumericValue == 0)
      {
-     strcpy(MathError.ErrorDescription,"Divide By 0");
-     strcpy(MathError.ErrorSolution,"Causes infinity");
+     strcpy((char *)MathError.ErrorDescription,"Divide By 0");
+     strcpy((char *)MathError.ErrorSolution,"Causes infinity");
      call_ShowMathError();
      return;
      }
@@ -2674,8 +2585,8 @@ void call_Divide(void)
    // CHECK FOR DIVIDE BY ZERO
    if (RegisterValue[1].NumericValue == 0)
      {
-     strcpy(MathError.ErrorDescription,"Divide By 0");
-     strcpy(MathError.ErrorSolution,"Causes infinity");
+     strcpy((char *)MathError.ErrorDescription,"Divide By 0");
+     strcpy((char *)MathError.ErrorSolution,"Causes infinity");
      call_ShowMathError();
      return;
      }
@@ -2687,3 +2598,142 @@ void call_Divide(void)
  } // END OF call_DeltaPercent
 
 
+
+
+/*************************************************************************
+ * Function Name: call_MathBenchmark
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Self test of the math path.  Each check of MathCheck puts its Y and X on the
+ * stack and runs the real entry point (call_sinX, call_YtoX ...) with the display held, in RAD
+ * and binary double math.  The X left by the function is compared to the reference in ULP and
+ * the call is timed on the DWT cycle counter (MATH_BENCH_REPEAT calls).  The max ULP and calls
+ * per second of every function are written to MATH_BENCH_FILE_NAME on the SD card, the worst
+ * and the slowest are shown until the next key:
+ * MATH <n> CHECKS
+ * ULP <name> <max ulp>
+ * SLOW <name> <calls/s>
+ * SAVED HC15C_MATH.TXT
+ * A check that ends in a math error stops the test with the error shown.
+ * NOTE: The stack and settings are not changed
+ * STEP 1: Check the calculator can run the test, save what it changes
+ * STEP 2: Run and time each check
+ * STEP 3: Restore
+ * STEP 4: Write the report
+ * STEP 5: Display
+ *************************************************************************/
+ void call_MathBenchmark(void)
+ {
+
+ static Type_Register SavedRegister[TOTAL_REGISTERS];
+ double SavedLastX;
+ BOOLEAN SavedLoaded,
+         SavedDecimal;
+ uint8_t SavedAngle,
+         Function,
+         Worst = 0,
+         Slowest = 0,
+         Repeat;
+ uint32_t StartCount,
+          ULP,
+          MaxULP[MATH_CHECK_TOTAL],
+          Cycles[MATH_CHECK_TOTAL],
+          Calls[MATH_CHECK_TOTAL],
+          PerSecond[MATH_CHECK_TOTAL];
+ uint16_t Check;
+ uint8_t LineText[2 * MAX_DISPLAY_LENGTH];
+ UINT BytesWritten;
+
+ // STEP 1
+ if ((Program.Running) || (CalSettings.CalMode != CAL_MODE) || (CalSettings.CalError != NO_ERROR) || (CalSettings.CalBase != BASE_10) || (CalSettings.ComplexMode))
+   return;
+ memcpy(SavedRegister, RegisterValue, sizeof(SavedRegister));
+ SavedLastX = LastX;
+ SavedLoaded = bln_LineLoaded;
+ SavedAngle = CalSettings.CalAngle;
+ SavedDecimal = CalSettings.DecimalMath;
+ CalSettings.CalAngle = RADS;
+ CalSettings.DecimalMath = FALSE;
+ memset(MaxULP, 0, sizeof(MaxULP));
+ memset(Cycles, 0, sizeof(Cycles));
+ memset(Calls, 0, sizeof(Calls));
+
+ // STEP 2
+ bln_DisplayHold = TRUE;
+ init_CycleCounter();
+ for (Check = 0; Check < (sizeof(MathCheck) / sizeof(MathCheck[0])); Check++)
+   {
+   Function = MathCheck[Check].Function;
+   // R>P AND P>R QUEUE A VOICE PROMPT ON EVERY CALL - ONE CALL SO THE AUDIO POOL IS NOT EMPTIED
+   Repeat = ((Function == MATH_CHECK_RTOP) || (Function == MATH_CHECK_PTOR)) ? 1 : MATH_BENCH_REPEAT;
+   for (uint8_t Count = 0; Count < Repeat; Count++)
+     {
+     RegisterValue[1].NumericValue = MathCheck[Check].Y;
+     RegisterValue[0].NumericValue = MathCheck[Check].X;
+     bln_LineLoaded = TRUE;
+     StartCount = CYCLE_COUNT;
+     MathCheckEntry[Function]();
+     Cycles[Function] += CYCLE_COUNT - StartCount;
+     }
+   Calls[Function] += Repeat;
+   if (CalSettings.CalError != NO_ERROR)
+     break;
+   ULP = call_KernelULP(RegisterValue[0].NumericValue, MathCheck[Check].Reference, KERNEL_ACCURATE);
+   if (ULP > MaxULP[Function])
+     MaxULP[Function] = ULP;
+   }
+ bln_DisplayHold = FALSE;
+
+ // STEP 3
+ memcpy(RegisterValue, SavedRegister, sizeof(SavedRegister));
+ LastX = SavedLastX;
+ bln_LineLoaded = SavedLoaded;
+ CalSettings.CalAngle = SavedAngle;
+ CalSettings.DecimalMath = SavedDecimal;
+ if (CalSettings.CalError != NO_ERROR)
+   return;
+
+ // STEP 4
+ for (Function = 0; Function < MATH_CHECK_TOTAL; Function++)
+   {
+   PerSecond[Function] = (Cycles[Function]) ? (uint32_t)(((uint64_t)SystemCoreClock * Calls[Function]) / Cycles[Function]) : 0;
+   if (MaxULP[Function] > MaxULP[Worst])
+     Worst = Function;
+   if (PerSecond[Function] < PerSecond[Slowest])
+     Slowest = Function;
+   }
+ ctl_mutex_lock(&FatFsMutex, CTL_TIMEOUT_NONE, 0);
+ FF_Result = f_open(&FatFsFile, MATH_BENCH_FILE_NAME, FA_CREATE_ALWAYS | FA_WRITE);
+ if (FF_Result == FR_OK)
+   {
+   sprintf((char *)LineText, "FUNCTION,MAX ULP,CALLS/S\r\n");
+   FF_Result = f_write(&FatFsFile, LineText, strlen((const char *)LineText), &BytesWritten);
+   for (Function = 0; (FF_Result == FR_OK) && (Function < MATH_CHECK_TOTAL); Function++)
+     {
+     snprintf((char *)LineText, sizeof(LineText), "%.*s,%lu,%lu\r\n", (int)sizeof(MathCheckName[0]), MathCheckName[Function], MaxULP[Function], PerSecond[Function]);
+     FF_Result = f_write(&FatFsFile, LineText, strlen((const char *)LineText), &BytesWritten);
+     if (BytesWritten != strlen((const char *)LineText))
+       FF_Result = FR_DISK_ERR;
+     }
+   f_close(&FatFsFile);
+   }
+ ctl_mutex_unlock(&FatFsMutex);
+
+ // STEP 5
+ DIP204_set_cursor(CURSOR_OFF);
+ DIP204_clearDisplay();
+ //                  01234567890123456789
+ snprintf((char *)LineText, sizeof(LineText), "MATH %u CHECKS", Check);
+ DIP204_txt_engine(LineText, 1, 0, strlen((const char *)LineText));
+ snprintf((char *)LineText, sizeof(LineText), "ULP  %s %lu", MathCheckName[Worst], MaxULP[Worst]);
+ DIP204_txt_engine(LineText, 2, 0, strlen((const char *)LineText));
+ snprintf((char *)LineText, sizeof(LineText), "SLOW %s %lu/S", MathCheckName[Slowest], PerSecond[Slowest]);
+ DIP204_txt_engine(LineText, 3, 0, strlen((const char *)LineText));
+ if (FF_Result == FR_OK)
+   strcpy((char *)LineText, "SAVED HC15C_MATH.TXT");
+ else
+   strcpy((char *)LineText, "SD NOT WRITTEN");
+ DIP204_txt_engine(LineText, 4, 0, strlen((const char *)LineText));
+
+ } // END OF call_MathBenchmark
@@ -0,0 +1,1128 @@
+/*****************************************************************
+ *
+ * File name:       MATRIX_FUNCTIONS.C
+ * Description:     Matrices A - E of the HC15C - dimension, element entry, multiply, transpose, det, inverse and solve
+ * Author:          Hab S. Collector
+ * Date:            10/19/2026
+ * LAST EDIT:       10/19/2026
+ * Hardware:        NXP LPC1769
+ * Firmware Tool:   CrossStudio for ARM
+ * Notes:           This file should be written as to not be dependent on other includes.
+ *                  everything these functions need should be passed to them.
+ *                  It will be necessary to consult the reference documents and associated schematics to understand
+ *                  the operations of this firmware.
+ *                  As the HP-15C the matrices share one pool of memory: MatrixArena.  Each matrix is packed row
+ *                  major with no gap to the next, so the arena is used to the last element and there is no
+ *                  fragmentation - a DIM moves the matrices after it.  The arena is the scratch pool shared with
+ *                  BIG and BATCH (see call_ScratchClaim) - held while any matrix is dimensioned.  A matrix is named by the hex letter keys.
+ *                  det, inverse and solve work in place on a partial pivoting LU decomposition: the L and U
+ *                  factors take the place of the matrix and the row swaps are a byte vector, so no second n x n
+ *                  buffer is ever needed.  As the HP-15C, det and solve leave the matrix as its LU - a second
+ *                  solve with the same matrix reuses it.
+ *****************************************************************/
+
+#include "MATRIX_FUNCTIONS.H"
+#include "PROGRAM_TASKS.H"
+#include "CORE_FUNCTIONS.H"
+#include "MATH_FUNCTIONS.H"
+#include "TOUCH_TASKS.H"
+#include "TIMERS_HC15C.H"
+#include "DIP204.H"
+#include "AUDIO_TASKS.H"
+#include "lpc_types.h"
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+
+// GLOBAL VARS
+// TYPES
+Type_Matrix Matrix;
+static double *MatrixArena;                      // THE SCRATCH POOL - SEE call_MatrixClaim
+static double MatrixWork[MATRIX_MAX_DIM];        // ONE COLUMN OF THE INVERSE - NOT ON THE CLICK TASK STACK
+// MATRIX n: DIGIT KEYS 0 - 9 AND THE MATRICES EACH OPERATION NAMES
+static const uint32_t MatrixDigitKey[MATRIX_OPERATION_TOTAL] =
+  {
+  MASK_KEY_0, MASK_KEY_1, MASK_KEY_2, MASK_KEY_3, MASK_KEY_4,
+  MASK_KEY_5, MASK_KEY_6, MASK_KEY_7, MASK_KEY_8, MASK_KEY_9
+  };
+static const uint8_t MatrixOperands[MATRIX_OPERATION_TOTAL] = {1, 0, 1, 1, 3, 1, 1, 1, 3, 0};
+static const uint8_t MatrixOpName[MATRIX_OPERATION_TOTAL][6] =
+  {
+  "DIM", "INDEX", "STO", "RCL", "x", "TRN", "DET", "INV", "SOLVE", "MEM"
+  };
+// HEX LETTER KEYS OF TOUCH A NAME THE MATRICES A - E
+static const uint32_t MatrixLetterKey[MATRIX_COUNT] =
+  {
+  MASK_KEY_HEX_A, MASK_KEY_HEX_B, MASK_KEY_HEX_C, MASK_KEY_HEX_D, MASK_KEY_HEX_E
+  };
+
+// EXTERN VARS
+extern Type_Program Program;
+extern Type_CalSettings CalSettings;
+extern Type_Register RegisterValue[TOTAL_REGISTERS];
+extern Type_Numeric NumericValue;
+extern Type_MathErrorDisplay MathError;
+extern BOOLEAN bln_LineLoaded;
+
+// PROTOTYPES LOCAL
+static void call_MatrixDigit(uint8_t);
+static void call_MatrixRun(void);
+static void call_MatrixShowPrompt(void);
+static BOOLEAN call_MatrixClaim(void);
+static BOOLEAN call_MatrixDim(uint8_t, uint8_t, uint8_t);
+static BOOLEAN call_MatrixSize(double, uint8_t *);
+static BOOLEAN call_MatrixCheck(uint8_t, BOOLEAN);
+static BOOLEAN call_MatrixFactor(uint8_t);
+static void call_MatrixNextIndex(uint8_t);
+static void call_MatrixReport(uint8_t);
+static void call_MatrixMemory(void);
+static void call_MatrixError(const uint8_t *, const uint8_t *);
+static BOOLEAN call_MatrixLU(double *, uint8_t, uint8_t *, BOOLEAN *);
+static void call_MatrixLUSolve(const double *, uint8_t, const uint8_t *, double *, uint8_t);
+static void call_MatrixLUInvert(double *, uint8_t, const uint8_t *);
+static void call_MatrixProduct(const double *, const double *, double *, uint8_t, uint8_t, uint8_t);
+static void call_MatrixTransposeInPlace(double *, uint8_t, uint8_t);
+
+
+
+
+/*************************************************************************
+ * Function Name: call_MatrixKey
+ * Parameters: uint32_t
+ * Return: BOOLEAN
+ *
+ * Description: Called by the click task for every key that passed the filter.  Returns TRUE
+ * if the key was taken here and is not to go to the keypad switch.  While the matrix prefix
+ * waits only ATN (cancel) and the digit keys are enabled, while an operation waits on its
+ * matrices only ATN and the hex letter keys A - E.
+ * STEP 1: Not waiting - not taken
+ * STEP 2: ATN cancels
+ * STEP 3: The operation digit
+ * STEP 4: A matrix name - run the operation when all are keyed
+ *************************************************************************/
+ BOOLEAN call_MatrixKey(uint32_t Key)
+ {
+
+ // STEP 1
+ if ((!Matrix.Prefix) && (!Matrix.OperandsNeeded))
+   return(FALSE);
+
+ // STEP 2
+ if (Key == MASK_ATN_KEY)
+   {
+   Matrix.Prefix = FALSE;
+   Matrix.OperandsNeeded = 0;
+   select_All_Normal_Keys();
+   call_FormatNumber();
+   return(TRUE);
+   }
+
+ // STEP 3
+ if (Matrix.Prefix)
+   {
+   for (uint8_t Digit = 0; Digit < MATRIX_OPERATION_TOTAL; Digit++)
+     {
+     if ((Key & MASK_B_TOUCH_DATA) && ((Key & ~MASK_B_TOUCH_DATA) == MatrixDigitKey[Digit]))
+       call_MatrixDigit(Digit);
+     }
+   return(TRUE);
+   }
+
+ // STEP 4
+ for (uint8_t Name = 0; Name < MATRIX_COUNT; Name++)
+   {
+   if (Key != MatrixLetterKey[Name])
+     continue;
+   Matrix.Operand[Matrix.OperandsKeyed++] = Name;
+   if (Matrix.OperandsKeyed < Matrix.OperandsNeeded)
+     call_MatrixShowPrompt();
+   else
+     call_MatrixRun();
+   }
+ return(TRUE);
+
+ } // END OF call_MatrixKey
+
+
+
+
+/*************************************************************************
+ * Function Name: call_MatrixPrefix
+ * Parameters: void
+ * Return: void
+ *
+ * Description: MATRIX - R shift ENTER.  The operations are shown on lines 1 - 3 and the next
+ * digit picks one (see enum MATRIX_OPERATION).  CAL mode base 10 only, as the other real math.
+ * A number being keyed is first entered.
+ * STEP 1: Check the calculator can start a matrix operation
+ * STEP 2: Mask the keys to ATN and the digits, show the operations
+ *************************************************************************/
+ void call_MatrixPrefix(void)
+ {
+
+ uint8_t LineText[MAX_DISPLAY_LENGTH];
+
+ // STEP 1
+ if ((Program.Running) || (CalSettings.CalMode != CAL_MODE) || (CalSettings.CalError != NO_ERROR) || (CalSettings.CalBase != BASE_10))
+   return;
+ if (!bln_LineLoaded)
+   call_Enter();
+ if (CalSettings.CalError != NO_ERROR)
+   return;
+
+ // STEP 2
+ Matrix.Prefix = TRUE;
+ Matrix.OperandsNeeded = 0;
+ CalSettings.Mask_KeyTouchA = CalSettings.Mask_KeyTouchB = NO_KEYS_SELECTED;
+ CalSettings.Mask_KeyTouchA = MASK_ATN_KEY;
+ CalSettings.Mask_KeyTouchB = MASK_0TO9_ONLY;
+ DIP204_set_cursor(CURSOR_OFF);
+ DIP204_clearDisplay();
+ //                  01234567890123456789
+ sprintf(LineText, "0DIM 1IDX 2STO 3RCL");
+ DIP204_txt_engine(LineText, 1, 0, strlen(LineText));
+ sprintf(LineText, "4x 5TRN 6DET 7INV");
+ DIP204_txt_engine(LineText, 2, 0, strlen(LineText));
+ sprintf(LineText, "8SOLVE 9MEM");
+ DIP204_txt_engine(LineText, 3, 0, strlen(LineText));
+ sprintf(LineText, "MATRIX _");
+ DIP204_txt_engine(LineText, 4, 0, strlen(LineText));
+
+ } // END OF call_MatrixPrefix
+
+
+
+
+/*************************************************************************
+ * Function Name: call_MatrixBenchmark
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Times the matrix kernels on the free part of the arena - the matrices A - E are
+ * not touched.  The largest size is the largest n with two n x n matrices in the free arena, then
+ * a half and a quarter of it.  For each size a diagonally dominant matrix of pseudo random elements
+ * is made and the CPU cycles (DWT cycle counter) are measured of:
+ * LU  - the in place LU decomposition and the solve of one right hand side
+ * x   - the n x n product
+ * Shown until the next key:
+ * N<n> LU<cycles> x<cycles>
+ * STEP 1: Claim the arena, the sizes the free arena holds
+ * STEP 2: Time each size - the arena is given back if no matrix is dimensioned
+ * STEP 3: Display
+ *************************************************************************/
+ void call_MatrixBenchmark(void)
+ {
+
+ double *Square,
+        *Result;
+ uint32_t Seed = MATRIX_BENCH_SEED,
+          StartCount,
+          CyclesLU[MATRIX_BENCH_SIZES],
+          CyclesProduct[MATRIX_BENCH_SIZES];
+ uint8_t Size[MATRIX_BENCH_SIZES],
+         Pivot[MATRIX_MAX_DIM],
+         Largest = 0,
+         LineText[2 * MAX_DISPLAY_LENGTH];
+ BOOLEAN OddSwaps;
+
+ // STEP 1
+ if ((Program.Running) || (CalSettings.CalMode != CAL_MODE) || (CalSettings.CalError != NO_ERROR))
+   return;
+ if (!call_MatrixClaim())
+   return;
+ while ((Largest < MATRIX_MAX_DIM) && ((2 * (Largest + 1) * (Largest + 1)) <= (MATRIX_ARENA_SIZE - Matrix.Used)))
+   Largest++;
+ Size[2] = Largest;
+ Size[1] = Largest / 2;
+ Size[0] = Largest / 4;
+ Square = &MatrixArena[Matrix.Used];
+ Result = Square + (Largest * Largest);
+
+ // STEP 2
+ init_CycleCounter();
+ for (uint8_t Index = 0; Index < MATRIX_BENCH_SIZES; Index++)
+   {
+   CyclesLU[Index] = CyclesProduct[Index] = 0;
+   if (!Size[Index])
+     continue;
+   for (uint16_t Element = 0; Element < (Size[Index] * Size[Index]); Element++)
+     {
+     // LINEAR CONGRUENTIAL - ELEMENTS -1 TO 1, THE DIAGONAL PLUS n SO THE MATRIX IS NOT SINGULAR
+     Seed = (Seed * 1103515245UL) + 12345UL;
+     Square[Element] = ((double)(Seed >> 16) / 32768.0) - 1.0;
+     if ((Element % Size[Index]) == (Element / Size[Index]))
+       Square[Element] += Size[Index];
+     }
+   StartCount = CYCLE_COUNT;
+   call_MatrixProduct(Square, Square, Result, Size[Index], Size[Index], Size[Index]);
+   CyclesProduct[Index] = CYCLE_COUNT - StartCount;
+   StartCount = CYCLE_COUNT;
+   call_MatrixLU(Square, Size[Index], Pivot, &OddSwaps);
+   call_MatrixLUSolve(Square, Size[Index], Pivot, Result, 1);
+   CyclesLU[Index] = CYCLE_COUNT - StartCount;
+   }
+ if (!Matrix.Used)
+   call_ScratchRelease(SCRATCH_MATRIX);
+
+ // STEP 3
+ DIP204_set_cursor(CURSOR_OFF);
+ DIP204_clearDisplay();
+ //                  01234567890123456789
+ sprintf(LineText, "MATRIX BENCH CYCLES");
+ DIP204_txt_engine(LineText, 1, 0, strlen(LineText));
+ for (uint8_t Index = 0; Index < MATRIX_BENCH_SIZES; Index++)
+   {
+   sprintf(LineText, "N%-2u LU%6lu x%6lu", Size[Index], CyclesLU[Index], CyclesProduct[Index]);
+   LineText[MAX_DISPLAY_LENGTH] = NULL_VALUE;
+   DIP204_txt_engine(LineText, Index + 2, 0, strlen(LineText));
+   }
+
+ } // END OF call_MatrixBenchmark
+
+
+
+
+/*************************************************************************
+ * Function Name: call_MatrixDigit
+ * Parameters: uint8_t
+ * Return: void
+ *
+ * Description: The operation digit after MATRIX.  An operation that names matrices waits on
+ * them with only ATN and the letter keys A - E enabled - the stack is shown while it waits.
+ * STEP 1: Set the operation
+ * STEP 2: Run it or wait on its matrices
+ *************************************************************************/
+ static void call_MatrixDigit(uint8_t Digit)
+ {
+
+ // STEP 1
+ Matrix.Prefix = FALSE;
+ Matrix.Operation = Digit;
+ Matrix.OperandsNeeded = MatrixOperands[Digit];
+ Matrix.OperandsKeyed = 0;
+
+ // STEP 2
+ if (!Matrix.OperandsNeeded)
+   {
+   call_MatrixRun();
+   return;
+   }
+ CalSettings.Mask_KeyTouchA = CalSettings.Mask_KeyTouchB = NO_KEYS_SELECTED;
+ CalSettings.Mask_KeyTouchA = MASK_ATN_KEY;
+ for (uint8_t Name = 0; Name < MATRIX_COUNT; Name++)
+   CalSettings.Mask_KeyTouchA |= MatrixLetterKey[Name];
+ call_FormatNumber();
+ call_MatrixShowPrompt();
+
+ } // END OF call_MatrixDigit
+
+
+
+
+/*************************************************************************
+ * Function Name: call_MatrixRun
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Runs the operation with all its matrices keyed.  A result matrix (x, SOLVE) is
+ * dimensioned to the result and must not be an operand it is made from.  Errors are math errors.
+ * STEP 1: Clear the operation and restore the keys
+ * STEP 2: Run the operation
+ *************************************************************************/
+ static void call_MatrixRun(void)
+ {
+
+ Type_MatrixDescriptor *First,
+                       *Second;
+ uint8_t Rows,
+         Cols,
+         Name = Matrix.Operand[0];
+ double Value;
+
+ // STEP 1
+ Matrix.OperandsNeeded = 0;
+ select_All_Normal_Keys();
+ First = &Matrix.Descriptor[Matrix.Operand[0]];
+ Second = &Matrix.Descriptor[Matrix.Operand[1]];
+
+ // STEP 2
+ switch(Matrix.Operation)
+   {
+   case MATRIX_DIM:
+     if ((!call_MatrixSize(RegisterValue[1].NumericValue, &Rows)) || (!call_MatrixSize(RegisterValue[0].NumericValue, &Cols)))
+       return;
+     if (!call_MatrixDim(Name, Rows, Cols))
+       return;
+     Matrix.Row = Matrix.Col = 1;
+     call_FormatNumber();
+     call_MatrixReport(Name);
+   break;
+
+   case MATRIX_INDEX:
+     if ((!call_MatrixSize(RegisterValue[1].NumericValue, &Rows)) || (!call_MatrixSize(RegisterValue[0].NumericValue, &Cols)))
+       return;
+     Matrix.Row = Rows;
+     Matrix.Col = Cols;
+     call_FormatNumber();
+     call_MatrixNextIndex(MATRIX_NONE);
+   break;
+
+   case MATRIX_STO:
+   case MATRIX_RCL:
+     if (!call_MatrixCheck(Name, FALSE))
+       return;
+     if ((!Matrix.Row) || (!Matrix.Col) || (Matrix.Row > First->Rows) || (Matrix.Col > First->Cols))
+       {
+       //                 01234567890123456789
+       call_MatrixError("Index out of range", "Set row and column");
+       return;
+       }
+     Value = MatrixArena[First->Offset + ((Matrix.Row - 1) * First->Cols) + (Matrix.Col - 1)];
+     if (Matrix.Operation == MATRIX_STO)
+       {
+       MatrixArena[First->Offset + ((Matrix.Row - 1) * First->Cols) + (Matrix.Col - 1)] = RegisterValue[0].NumericValue;
+       First->LU = FALSE;
+       call_FormatNumber();
+       }
+     else
+       call_ProcessStackUp(Value);
+     // NEXT ELEMENT ROW MAJOR - BACK TO 1,1 AFTER THE LAST
+     if (++Matrix.Col > First->Cols)
+       {
+       Matrix.Col = 1;
+       if (++Matrix.Row > First->Rows)
+         Matrix.Row = 1;
+       }
+     call_MatrixNextIndex(Name);
+   break;
+
+   case MATRIX_MULTIPLY:
+     if ((!call_MatrixCheck(Matrix.Operand[0], FALSE)) || (!call_MatrixCheck(Matrix.Operand[1], FALSE)))
+       return;
+     if (First->Cols != Second->Rows)
+       {
+       call_MatrixError("Dimension mismatch", "Check dimensions");
+       return;
+       }
+     if ((Matrix.Operand[2] == Matrix.Operand[0]) || (Matrix.Operand[2] == Matrix.Operand[1]))
+       {
+       call_MatrixError("Result is operand", "Name another result");
+       return;
+       }
+     if (!call_MatrixDim(Matrix.Operand[2], First->Rows, Second->Cols))
+       return;
+     // THE DIM MAY HAVE MOVED THE OPERANDS - OFFSETS ARE READ AFTER IT
+     call_MatrixProduct(&MatrixArena[First->Offset], &MatrixArena[Second->Offset], &MatrixArena[Matrix.Descriptor[Matrix.Operand[2]].Offset],
+                        First->Rows, First->Cols, Second->Cols);
+     call_FormatNumber();
+     call_MatrixReport(Matrix.Operand[2]);
+   break;
+
+   case MATRIX_TRANSPOSE:
+     if (!call_MatrixCheck(Name, FALSE))
+       return;
+     call_MatrixTransposeInPlace(&MatrixArena[First->Offset], First->Rows, First->Cols);
+     Rows = First->Rows;
+     First->Rows = First->Cols;
+     First->Cols = Rows;
+     First->LU = FALSE;
+     call_FormatNumber();
+     call_MatrixReport(Name);
+   break;
+
+   case MATRIX_DETERMINANT:
+     if (!call_MatrixCheck(Name, TRUE))
+       return;
+     // A SINGULAR MATRIX HAS A 0 PIVOT - det IS 0, NOT AN ERROR
+     call_MatrixFactor(Name);
+     Value = (First->OddSwaps) ? -1.0 : 1.0;
+     for (uint8_t Diagonal = 0; Diagonal < First->Rows; Diagonal++)
+       Value *= MatrixArena[First->Offset + (Diagonal * (First->Cols + 1))];
+     if (isinf(Value) || isnan(Value))
+       {
+       call_MatrixError("Invalid result", "Unsupported math");
+       return;
+       }
+     call_ProcessStackUp(Value);
+   break;
+
+   case MATRIX_INVERSE:
+     if (!call_MatrixCheck(Name, TRUE))
+       return;
+     if (!call_MatrixFactor(Name))
+       {
+       //                 01234567890123456789
+       call_MatrixError("Singular matrix", "Check the matrix");
+       return;
+       }
+     call_MatrixLUInvert(&MatrixArena[First->Offset], First->Rows, First->Pivot);
+     First->LU = FALSE;
+     call_FormatNumber();
+     call_MatrixReport(Name);
+   break;
+
+   case MATRIX_SOLVE:
+     if ((!call_MatrixCheck(Matrix.Operand[0], TRUE)) || (!call_MatrixCheck(Matrix.Operand[1], FALSE)))
+       return;
+     if (First->Rows != Second->Rows)
+       {
+       call_MatrixError("Dimension mismatch", "Check dimensions");
+       return;
+       }
+     if (Matrix.Operand[2] == Matrix.Operand[0])
+       {
+       call_MatrixError("Result is operand", "Name another result");
+       return;
+       }
+     // THE RIGHT HAND SIDE IS COPIED TO THE RESULT FIRST - IT MAY BE THE MATRIX THAT IS FACTORED
+     if (Matrix.Operand[2] != Matrix.Operand[1])
+       {
+       Rows = Second->Rows;
+       Cols = Second->Cols;
+       if (!call_MatrixDim(Matrix.Operand[2], Rows, Cols))
+         return;
+       memcpy(&MatrixArena[Matrix.Descriptor[Matrix.Operand[2]].Offset], &MatrixArena[Second->Offset], Rows * Cols * sizeof(double));
+       }
+     if (!call_MatrixFactor(Name))
+       {
+       call_MatrixError("Singular matrix", "Check the matrix");
+       return;
+       }
+     call_MatrixLUSolve(&MatrixArena[First->Offset], First->Rows, First->Pivot,
+                        &MatrixArena[Matrix.Descriptor[Matrix.Operand[2]].Offset], Second->Cols);
+     Matrix.Descriptor[Matrix.Operand[2]].LU = FALSE;
+     call_FormatNumber();
+     call_MatrixReport(Matrix.Operand[2]);
+   break;
+
+   case MATRIX_MEMORY:
+     call_MatrixMemory();
+   break;
+   }
+
+ } // END OF call_MatrixRun
+
+
+
+
+/*************************************************************************
+ * Function Name: call_MatrixShowPrompt
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Shows the operation and the matrices keyed so far on line 4: "MATRIX x A B _"
+ * STEP 1: Build and show the prompt
+ *************************************************************************/
+ static void call_MatrixShowPrompt(void)
+ {
+
+ uint8_t LineText[MAX_DISPLAY_LENGTH];
+
+ // STEP 1
+ sprintf(LineText, "MATRIX %s ", MatrixOpName[Matrix.Operation]);
+ for (uint8_t Keyed = 0; Keyed < Matrix.OperandsKeyed; Keyed++)
+   sprintf(&LineText[strlen(LineText)], "%c ", 'A' + Matrix.Operand[Keyed]);
+ strcat(LineText, "_");
+ DIP204_clearLine(4);
+ DIP204_txt_engine(LineText, 4, 0, strlen(LineText));
+
+ } // END OF call_MatrixShowPrompt
+
+
+
+
+/*************************************************************************
+ * Function Name: call_MatrixClaim
+ * Parameters: void
+ * Return: BOOLEAN
+ *
+ * Description: The scratch pool as the arena - the matrices keep it while any is dimensioned.
+ * Shows the error and returns FALSE if BATCH holds it.  A BIG result kept for the view is lost.
+ * STEP 1: Claim the pool
+ *************************************************************************/
+ static BOOLEAN call_MatrixClaim(void)
+ {
+
+ // STEP 1
+ MatrixArena = (double *)call_ScratchClaim(SCRATCH_MATRIX, MATRIX_ARENA_SIZE * sizeof(double));
+ if (MatrixArena != NULL)
+   return(TRUE);
+ //                 01234567890123456789
+ call_MatrixError("Memory in use", "Wait for the BATCH");
+ return(FALSE);
+
+ } // END OF call_MatrixClaim
+
+
+
+
+/*************************************************************************
+ * Function Name: call_MatrixDim
+ * Parameters: uint8_t, uint8_t, uint8_t
+ * Return: BOOLEAN
+ *
+ * Description: Dimensions a matrix to rows x columns (either 0 frees it).  The elements it had
+ * are kept in row major order, new elements are 0.  The matrices after it in the arena are moved
+ * so the arena stays packed.  The first matrix dimensioned claims the arena and the last one
+ * freed gives it back.  Returns FALSE if the arena can not hold it or BATCH has the scratch pool
+ * - the error is shown.
+ * STEP 1: Check the arena holds the new size
+ * STEP 2: Move the matrices after it and clear the new elements
+ * STEP 3: Update the descriptors, give back the arena if it is empty
+ *************************************************************************/
+ static BOOLEAN call_MatrixDim(uint8_t Name, uint8_t Rows, uint8_t Cols)
+ {
+
+ Type_MatrixDescriptor *Descriptor = &Matrix.Descriptor[Name];
+ uint16_t OldSize = Descriptor->Rows * Descriptor->Cols,
+          NewSize = Rows * Cols,
+          Tail;
+
+ // STEP 1
+ if (!NewSize)
+   Rows = Cols = 0;
+ if ((Matrix.Used - OldSize + NewSize) > MATRIX_ARENA_SIZE)
+   {
+   //                 01234567890123456789
+   call_MatrixError("Matrix too large", "DIM a matrix to 0");
+   return(FALSE);
+   }
+ if (((Matrix.Used) || (NewSize)) && (!call_MatrixClaim()))
+   return(FALSE);
+
+ // STEP 2
+ Tail = Matrix.Used - (Descriptor->Offset + OldSize);
+ memmove(&MatrixArena[Descriptor->Offset + NewSize], &MatrixArena[Descriptor->Offset + OldSize], Tail * sizeof(double));
+ if (NewSize > OldSize)
+   memset(&MatrixArena[Descriptor->Offset + OldSize], 0, (NewSize - OldSize) * sizeof(double));
+
+ // STEP 3
+ for (uint8_t After = Name + 1; After < MATRIX_COUNT; After++)
+   Matrix.Descriptor[After].Offset = Matrix.Descriptor[After].Offset + NewSize - OldSize;
+ Matrix.Used = Matrix.Used + NewSize - OldSize;
+ Descriptor->Rows = Rows;
+ Descriptor->Cols = Cols;
+ Descriptor->LU = FALSE;
+ if (!Matrix.Used)
+   call_ScratchRelease(SCRATCH_MATRIX);
+ return(TRUE);
+
+ } // END OF call_MatrixDim
+
+
+
+
+/*************************************************************************
+ * Function Name: call_MatrixSize
+ * Parameters: double, uint8_t *
+ * Return: BOOLEAN
+ *
+ * Description: A row or column count from the stack - a whole number 0 to 255.  Returns FALSE
+ * if it is not - the error is shown.
+ * STEP 1: Check and convert
+ *************************************************************************/
+ static BOOLEAN call_MatrixSize(double Value, uint8_t *Size)
+ {
+
+ // STEP 1
+ if ((Value < 0.0) || (Value > 255.0) || (Value != floor(Value)))
+   {
+   //                 01234567890123456789
+   call_MatrixError("Invalid dimension", "Use 0 to 255");
+   return(FALSE);
+   }
+ *Size = (uint8_t)Value;
+ return(TRUE);
+
+ } // END OF call_MatrixSize
+
+
+
+
+/*************************************************************************
+ * Function Name: call_MatrixCheck
+ * Parameters: uint8_t, BOOLEAN
+ * Return: BOOLEAN
+ *
+ * Description: Checks a matrix operand is dimensioned and, if passed TRUE, square.  Returns
+ * FALSE if not - the error is shown.
+ * STEP 1: Check
+ *************************************************************************/
+ static BOOLEAN call_MatrixCheck(uint8_t Name, BOOLEAN Square)
+ {
+
+ // STEP 1
+ if (!Matrix.Descriptor[Name].Rows)
+   {
+   //                 01234567890123456789
+   call_MatrixError("No matrix", "DIM the matrix");
+   return(FALSE);
+   }
+ if ((Square) && (Matrix.Descriptor[Name].Rows != Matrix.Descriptor[Name].Cols))
+   {
+   call_MatrixError("Matrix not square", "Check dimensions");
+   return(FALSE);
+   }
+ return(TRUE);
+
+ } // END OF call_MatrixCheck
+
+
+
+
+/*************************************************************************
+ * Function Name: call_MatrixFactor
+ * Parameters: uint8_t
+ * Return: BOOLEAN
+ *
+ * Description: The square matrix is replaced by its LU decomposition - unless it already is
+ * one.  Returns FALSE if it is singular (a 0 pivot) - det of it is still valid, 0.
+ * STEP 1: Decompose in place if not already
+ * STEP 2: Check for a 0 pivot
+ *************************************************************************/
+ static BOOLEAN call_MatrixFactor(uint8_t Name)
+ {
+
+ Type_MatrixDescriptor *Descriptor = &Matrix.Descriptor[Name];
+
+ // STEP 1
+ if (!Descriptor->LU)
+   {
+   call_MatrixLU(&MatrixArena[Descriptor->Offset], Descriptor->Rows, Descriptor->Pivot, &Descriptor->OddSwaps);
+   Descriptor->LU = TRUE;
+   }
+
+ // STEP 2
+ for (uint8_t Diagonal = 0; Diagonal < Descriptor->Rows; Diagonal++)
+   {
+   if (MatrixArena[Descriptor->Offset + (Diagonal * (Descriptor->Cols + 1))] == 0.0)
+     return(FALSE);
+   }
+ return(TRUE);
+
+ } // END OF call_MatrixFactor
+
+
+
+
+/*************************************************************************
+ * Function Name: call_MatrixNextIndex
+ * Parameters: uint8_t
+ * Return: void
+ *
+ * Description: Shows the row and column of the next STO / RCL on line 1: "A 2,1" (no name
+ * if MATRIX_NONE is passed)
+ * STEP 1: Build and show
+ *************************************************************************/
+ static void call_MatrixNextIndex(uint8_t Name)
+ {
+
+ uint8_t LineText[MAX_DISPLAY_LENGTH];
+
+ // STEP 1
+ if (Name == MATRIX_NONE)
+   sprintf(LineText, "INDEX %u,%u", Matrix.Row, Matrix.Col);
+ else
+   sprintf(LineText, "NEXT %c %u,%u", 'A' + Name, Matrix.Row, Matrix.Col);
+ DIP204_clearLine(1);
+ DIP204_txt_engine(LineText, 1, 0, strlen(LineText));
+
+ } // END OF call_MatrixNextIndex
+
+
+
+
+/*************************************************************************
+ * Function Name: call_MatrixReport
+ * Parameters: uint8_t
+ * Return: void
+ *
+ * Description: Shows the matrix and its dimensions on line 1: "A 3x3" - "A 3x3 LU" if it holds
+ * its LU decomposition
+ * STEP 1: Build and show
+ *************************************************************************/
+ static void call_MatrixReport(uint8_t Name)
+ {
+
+ uint8_t LineText[MAX_DISPLAY_LENGTH];
+
+ // STEP 1
+ sprintf(LineText, "%c %ux%u%s", 'A' + Name, Matrix.Descriptor[Name].Rows, Matrix.Descriptor[Name].Cols,
+         (Matrix.Descriptor[Name].LU) ? " LU" : "");
+ DIP204_clearLine(1);
+ DIP204_txt_engine(LineText, 1, 0, strlen(LineText));
+
+ } // END OF call_MatrixReport
+
+
+
+
+/*************************************************************************
+ * Function Name: call_MatrixMemory
+ * Parameters: void
+ * Return: void
+ *
+ * Description: MATRIX 9 - the footprint of the matrices, shown until the next key:
+ * MATRIX <bytes of the arena> BYTES
+ * USED <n> FREE <n>        (elements)
+ * DESC <bytes of the descriptors> BYTES
+ * A3x3 C3x1 ...            (the dimensioned matrices)
+ * STEP 1: Footprint
+ * STEP 2: The dimensioned matrices
+ *************************************************************************/
+ static void call_MatrixMemory(void)
+ {
+
+ uint8_t LineText[2 * MAX_DISPLAY_LENGTH];
+
+ // STEP 1
+ DIP204_set_cursor(CURSOR_OFF);
+ DIP204_clearDisplay();
+ //                  01234567890123456789
+ sprintf(LineText, "MATRIX %u BYTES", MATRIX_ARENA_SIZE * sizeof(double));
+ DIP204_txt_engine(LineText, 1, 0, strlen(LineText));
+ sprintf(LineText, "USED %u FREE %u", Matrix.Used, MATRIX_ARENA_SIZE - Matrix.Used);
+ DIP204_txt_engine(LineText, 2, 0, strlen(LineText));
+ sprintf(LineText, "DESC %u BYTES", sizeof(Matrix) + sizeof(MatrixWork));
+ DIP204_txt_engine(LineText, 3, 0, strlen(LineText));
+
+ // STEP 2
+ LineText[0] = NULL_VALUE;
+ for (uint8_t Name = 0; Name < MATRIX_COUNT; Name++)
+   {
+   if (Matrix.Descriptor[Name].Rows)
+     sprintf(&LineText[strlen(LineText)], "%c%ux%u ", 'A' + Name, Matrix.Descriptor[Name].Rows, Matrix.Descriptor[Name].Cols);
+   }
+ if (!LineText[0])
+   sprintf(LineText, "NO MATRICES");
+ LineText[MAX_DISPLAY_LENGTH] = NULL_VALUE;
+ DIP204_txt_engine(LineText, 4, 0, strlen(LineText));
+
+ } // END OF call_MatrixMemory
+
+
+
+
+/*************************************************************************
+ * Function Name: call_MatrixError
+ * Parameters: const uint8_t *, const uint8_t *
+ * Return: void
+ *
+ * Description: Shows a matrix error as a math error - ATN clears it
+ * STEP 1: Set the error text and show
+ *************************************************************************/
+ static void call_MatrixError(const uint8_t *Description, const uint8_t *Solution)
+ {
+
+ // STEP 1
+ strcpy(MathError.ErrorDescription, Description);
+ strcpy(MathError.ErrorSolution, Solution);
+ strcpy(NumericValue.AudioErrorFileName, I_AND_I_ERROR_WAV);
+ NumericValue.AudioPlayLevel = BASIC_HELP;
+ call_ShowMathError();
+
+ } // END OF call_MatrixError
+
+
+
+
+/*************************************************************************
+ * Function Name: call_MatrixLU
+ * Parameters: double *, uint8_t, uint8_t *, BOOLEAN *
+ * Return: BOOLEAN
+ *
+ * Description: LU decomposition in place with partial pivoting (Doolittle - L has a unit
+ * diagonal that is not stored).  The n x n row major matrix is replaced by L below the diagonal
+ * and U on and above it.  The row swapped with row k at step k is Pivot[k] and OddSwaps is set
+ * for an odd number of swaps.  Each pivot is inverted once - the soft float divide is the most
+ * costly op.  Returns FALSE if a pivot is 0 (singular) - the decomposition is still complete so
+ * the product of the diagonal is det.
+ * STEP 1: Pick the largest pivot of the column and swap its row up
+ * STEP 2: Eliminate below the pivot
+ *************************************************************************/
+ static BOOLEAN call_MatrixLU(double *A, uint8_t n, uint8_t *Pivot, BOOLEAN *OddSwaps)
+ {
+
+ double Largest,
+        Swap,
+        Reciprocal,
+        Factor,
+        *PivotRow,
+        *Row;
+ BOOLEAN NonSingular = TRUE;
+
+ *OddSwaps = FALSE;
+ for (uint8_t k = 0; k < n; k++)
+   {
+   // STEP 1
+   Pivot[k] = k;
+   Largest = fabs(A[(k * n) + k]);
+   for (uint8_t i = k + 1; i < n; i++)
+     {
+     if (fabs(A[(i * n) + k]) > Largest)
+       {
+       Largest = fabs(A[(i * n) + k]);
+       Pivot[k] = i;
+       }
+     }
+   PivotRow = &A[k * n];
+   if (Pivot[k] != k)
+     {
+     Row = &A[Pivot[k] * n];
+     for (uint8_t j = 0; j < n; j++)
+       {
+       Swap = PivotRow[j];
+       PivotRow[j] = Row[j];
+       Row[j] = Swap;
+       }
+     *OddSwaps = !(*OddSwaps);
+     }
+   if (PivotRow[k] == 0.0)
+     {
+     NonSingular = FALSE;
+     continue;
+     }
+
+   // STEP 2
+   Reciprocal = 1.0 / PivotRow[k];
+   for (uint8_t i = k + 1; i < n; i++)
+     {
+     Row = &A[i * n];
+     Factor = Row[k] * Reciprocal;
+     Row[k] = Factor;
+     if (Factor == 0.0)
+       continue;
+     for (uint8_t j = k + 1; j < n; j++)
+       Row[j] -= Factor * PivotRow[j];
+     }
+   }
+ return(NonSingular);
+
+ } // END OF call_MatrixLU
+
+
+
+
+/*************************************************************************
+ * Function Name: call_MatrixLUSolve
+ * Parameters: const double *, uint8_t, const uint8_t *, double *, uint8_t
+ * Return: void
+ *
+ * Description: Solves A X = B in place with the LU decomposition of A (see call_MatrixLU).
+ * B is n x Cols row major and is replaced by X.
+ * STEP 1: Swap the rows of B as the rows of A were swapped
+ * STEP 2: Forward substitution - L Y = B (unit diagonal)
+ * STEP 3: Back substitution - U X = Y
+ *************************************************************************/
+ static void call_MatrixLUSolve(const double *LU, uint8_t n, const uint8_t *Pivot, double *B, uint8_t Cols)
+ {
+
+ double Swap,
+        Factor,
+        Reciprocal;
+
+ // STEP 1
+ for (uint8_t k = 0; k < n; k++)
+   {
+   if (Pivot[k] == k)
+     continue;
+   for (uint8_t j = 0; j < Cols; j++)
+     {
+     Swap = B[(k * Cols) + j];
+     B[(k * Cols) + j] = B[(Pivot[k] * Cols) + j];
+     B[(Pivot[k] * Cols) + j] = Swap;
+     }
+   }
+
+ // STEP 2
+ for (uint8_t i = 1; i < n; i++)
+   {
+   for (uint8_t k = 0; k < i; k++)
+     {
+     Factor = LU[(i * n) + k];
+     if (Factor == 0.0)
+       continue;
+     for (uint8_t j = 0; j < Cols; j++)
+       B[(i * Cols) + j] -= Factor * B[(k * Cols) + j];
+     }
+   }
+
+ // STEP 3
+ for (uint8_t i = n; i-- > 0; )
+   {
+   for (uint8_t k = i + 1; k < n; k++)
+     {
+     Factor = LU[(i * n) + k];
+     for (uint8_t j = 0; j < Cols; j++)
+       B[(i * Cols) + j] -= Factor * B[(k * Cols) + j];
+     }
+   Reciprocal = 1.0 / LU[(i * n) + i];
+   for (uint8_t j = 0; j < Cols; j++)
+     B[(i * Cols) + j] *= Reciprocal;
+   }
+
+ } // END OF call_MatrixLUSolve
+
+
+
+
+/*************************************************************************
+ * Function Name: call_MatrixLUInvert
+ * Parameters: double *, uint8_t, const uint8_t *
+ * Return: void
+ *
+ * Description: Replaces the LU decomposition of A (see call_MatrixLU) with the inverse of A in
+ * place (as LAPACK getri).  The only work space is one column (MatrixWork).
+ * STEP 1: Invert U in place - column by column, each from the inverse of the columns before it
+ * STEP 2: Solve inv(A) L = inv(U) for inv(A) - the columns from the last to the first
+ * STEP 3: Undo the row swaps as column swaps in the reverse order
+ *************************************************************************/
+ static void call_MatrixLUInvert(double *A, uint8_t n, const uint8_t *Pivot)
+ {
+
+ double Diagonal,
+        Sum,
+        Swap;
+
+ // STEP 1
+ for (uint8_t j = 0; j < n; j++)
+   {
+   A[(j * n) + j] = 1.0 / A[(j * n) + j];
+   Diagonal = -A[(j * n) + j];
+   // ROWS IN ORDER - ROW i USES THE ELEMENTS OF COLUMN j BELOW IT THAT ARE NOT YET REPLACED
+   for (uint8_t i = 0; i < j; i++)
+     {
+     Sum = 0.0;
+     for (uint8_t k = i; k < j; k++)
+       Sum += A[(i * n) + k] * A[(k * n) + j];
+     A[(i * n) + j] = Sum * Diagonal;
+     }
+   }
+
+ // STEP 2
+ for (uint8_t j = n - 1; j-- > 0; )
+   {
+   for (uint8_t i = j + 1; i < n; i++)
+     {
+     MatrixWork[i] = A[(i * n) + j];
+     A[(i * n) + j] = 0.0;
+     }
+   for (uint8_t Row = 0; Row < n; Row++)
+     {
+     Sum = 0.0;
+     for (uint8_t i = j + 1; i < n; i++)
+       Sum += A[(Row * n) + i] * MatrixWork[i];
+     A[(Row * n) + j] -= Sum;
+     }
+   }
+
+ // STEP 3
+ for (uint8_t j = n - 1; j-- > 0; )
+   {
+   if (Pivot[j] == j)
+     continue;
+   for (uint8_t Row = 0; Row < n; Row++)
+     {
+     Swap = A[(Row * n) + j];
+     A[(Row * n) + j] = A[(Row * n) + Pivot[j]];
+     A[(Row * n) + Pivot[j]] = Swap;
+     }
+   }
+
+ } // END OF call_MatrixLUInvert
+
+
+
+
+/*************************************************************************
+ * Function Name: call_MatrixProduct
+ * Parameters: const double *, const double *, double *, uint8_t, uint8_t, uint8_t
+ * Return: void
+ *
+ * Description: C = A x B - A is Rows x Inner, B is Inner x Cols and C is Rows x Cols, all
+ * row major.  C must not be A or B.
+ * STEP 1: Each element is the dot product of a row of A and a column of B
+ *************************************************************************/
+ static void call_MatrixProduct(const double *A, const double *B, double *C, uint8_t Rows, uint8_t Inner, uint8_t Cols)
+ {
+
+ const double *RowA,
+              *ColB;
+ double Sum;
+
+ // STEP 1
+ for (uint8_t i = 0; i < Rows; i++)
+   {
+   for (uint8_t j = 0; j < Cols; j++)
+     {
+     RowA = &A[i * Inner];
+     ColB = &B[j];
+     Sum = 0.0;
+     for (uint8_t k = 0; k < Inner; k++, ColB += Cols)
+       Sum += RowA[k] * (*ColB);
+     *C++ = Sum;
+     }
+   }
+
+ } // END OF call_MatrixProduct
+
+
+
+
+/*************************************************************************
+ * Function Name: call_MatrixTransposeInPlace
+ * Parameters: double *, uint8_t, uint8_t
+ * Return: void
+ *
+ * Description: Transposes a Rows x Cols row major matrix in place to Cols x Rows.  Square:
+ * the elements are swapped across the diagonal.  Not square: the element at i moves to
+ * (i % Cols) * Rows + i / Cols - the moves form cycles and each cycle is followed once, from
+ * its lowest element, carrying one element.  No work space is used.
+ * STEP 1: Square
+ * STEP 2: Not square - follow each cycle from its lowest element
+ *************************************************************************/
+ static void call_MatrixTransposeInPlace(double *A, uint8_t Rows, uint8_t Cols)
+ {
+
+ uint16_t Last = (Rows * Cols) - 1,
+          Next;
+ double Carry,
+        Swap;
+
+ // STEP 1
+ if (Rows == Cols)
+   {
+   for (uint8_t i = 0; i < Rows; i++)
+     {
+     for (uint8_t j = i + 1; j < Cols; j++)
+       {
+       Swap = A[(i * Cols) + j];
+       A[(i * Cols) + j] = A[(j * Cols) + i];
+       A[(j * Cols) + i] = Swap;
+       }
+     }
+   return;
+   }
+
+ // STEP 2
+ // THE FIRST AND LAST ELEMENTS DO NOT MOVE
+ for (uint16_t Start = 1; Start < Last; Start++)
+   {
+   Next = ((Start % Cols) * Rows) + (Start / Cols);
+   while (Next > Start)
+     Next = ((Next % Cols) * Rows) + (Next / Cols);
+   if (Next < Start)
+     continue;
+   Carry = A[Start];
+   Next = Start;
+   do
+     {
+     Next = ((Next % Cols) * Rows) + (Next / Cols);
+     Swap = A[Next];
+     A[Next] = Carry;
+     Carry = Swap;
+     } while (Next != Start);
+   }
+
+ } // END OF call_MatrixTransposeInPlace
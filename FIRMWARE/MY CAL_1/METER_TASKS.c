@@ -5,7 +5,7 @@
                     related functions of the HC15C
  * Author:          Hab S. Collector
  * Date:            11/27/11
- * LAST EDIT:       7/16/2012 
+ * LAST EDIT:       10/19/2026
  * Hardware:        NXP LPC1769
  * Firmware Tool:   CrossStudio for ARM
  * Notes:           This file should be written as to not be dependent on other includes.
@@ -23,6 +23,9 @@
 #include "TOUCH_TASKS.H"
 #include "HC15C_PROTOCOL.H"
 #include "USB_LINK.H"
+#include "LOG_TASKS.H"
+#include "usbserial.h"
+#include "lpc17xx_adc.h"
 #include "lpc17xx_gpio.h"
 #include <ctl_api.h>
 #include <stdio.h>
@@ -32,7 +35,11 @@
 // GLOBALS
 Type_Meter Meter;
 Type_OHMS OHMS;
+Type_Scope Scope;
 BOOLEAN ContinunityTone = FALSE;
+// THE SCAN BETWEEN CAPTURES FOR THE BATTERY AND USB FILTERS - SEE call_CaptureMonitor
+static BOOLEAN CaptureMonitoring = FALSE;
+static uint32_t CaptureMonitorTime;
 
 
 // EXTERNS
@@ -40,6 +47,23 @@ extern CTL_EVENT_SET_t CalEvents;
 extern CTL_TASK_t meter_task;
 extern Type_CalSettings CalSettings;
 extern BOOLEAN VCOM_Link;
+extern Type_Stream MeterStream;
+extern Type_Log MeterLog;
+
+// PROTOTYPES LOCAL
+static double call_OhmsFromVoltage(double);
+static double call_VoltMeterRange(double);
+static void call_VoltMeterSwitch(double);
+static void call_VoltMeterPins(double);
+static void call_VoltMeterProbe(void);
+static void call_VoltMeterAC(void);
+static void call_VoltMeterShow(double);
+static double call_OhmsEstimate(double);
+static void call_ScopeUpdate(void);
+static void call_ScopeShow(const ADC_Capture_Type *);
+static void call_ScopeTrigRow(void);
+static double call_ScopeVolts(uint16_t);
+static BOOLEAN call_CaptureMonitor(double);
 
 
 /*************************************************************************
@@ -57,101 +81,87 @@ extern BOOLEAN VCOM_Link;
  * Due to the way resistance is measured a very small change in the ADC measure (about 1%)
  * results in a very large change in resistance measured.  Because of this the measured
  * resistance is compared against the last resistance to be within a given tolerance to be
- * acceptable.  
- * STEP 1: Volt Meter Event {Steps 2...4}
- * STEP 2: Make ADC measure and display
- * STEP 3: Update the Max V measure
- * STEP 4: Update the auto range based on the input voltage and take action if necessary
- * to setup ADC ratio and hardware divider
- * STEP 5: OHMS Meter Event {Steps 6..8}
- * STEP 6: Calculate the Measured resistance from the ADC read
- * STEP 7: Only accept that reading to continue if the reading is less than X% of the last reading.
- * if not get another measure.
- * STEP 8: Determine if the measured resistance is greater than the set limit resistance.  If so,
- * beep, blink and display continuity.  If not, show as open.
+ * acceptable.  Scope mode shares the meter event: each one shows a capture when it is done and
+ * arms the next.  So do AC readings of the volt meter: the RMS of a capture.
+ * STEP 1: Volt Meter Event {Steps 2...4}.  In scope mode the scope update, for AC the RMS capture instead
+ * STEP 2: After a range switch probe the new range until it is right.  Read the filtered ADC value
+ * and display.  Skip the update until the filter is full after a range switch
+ * STEP 3: Display the reading, to the USB port and update the Max V measure
+ * STEP 4: The first reading after a range switch: show the time it took.  Otherwise update the auto
+ * range from the probe value - quicker than the filter to see a step at the input
+ * STEP 5: OHMS Meter Event (timer 0 IRQ each OHMS_SAMPLE_TIME) {Steps 6..8}
+ * STEP 6: Calculate the Measured resistance from the ADC probe value and add it to the estimate
+ * STEP 7: Continuity from the median of the last samples: beep and display at once when it changes.
+ * STEP 8: Each OHMS_DISPLAY_SAMPLES display the reading - once the estimate has converged.  Open is
+ * shown without waiting
  * STEP 9: Check for UI increment down of ohms set.  Decrement the set point
  * accordingly and update the display with the new set point value
  * STEP 10: Check for UI increment up of ohms set.  Increment the set point
  * accordingly and update the display with the new set point value
+ * STEP 11: Meter log event (timer 0 IRQ each sample time): the reading in volts or ohms to the log
+ * STEP 12: Meter stream event (timer 0 IRQ each sample time): the reading in volts or ohms to the
+ * stream - once the filter is full (for AC the last RMS reading).  After the stream stops: send the samples not yet sent
+ * NOTE: While the stream is on it replaces the packet of each displayed reading
  *************************************************************************/
  void meter_taskFn(void *p)
  {
  
  uint8_t LineText[DISPLAY_COLUMN_TOTAL];
- static double LastResistance = 0.0;
  double MeasuredVoltage, 
-        MeasuredResistance,
-        I1, I2, Vb;
+        MeasuredResistance;
  
  while (1)
    {
-   ctl_events_wait(CTL_EVENT_WAIT_ANY_EVENTS, &CalEvents, (EVENT_METER|EVENT_OHMS|EVENT_OHMS_UI), CTL_TIMEOUT_NONE, 0);
+   ctl_events_wait(CTL_EVENT_WAIT_ANY_EVENTS, &CalEvents, (EVENT_METER|EVENT_OHMS|EVENT_OHMS_UI|EVENT_LOG|EVENT_STREAM), CTL_TIMEOUT_NONE, 0);
   
    // STEP 1
    // VOLTMETER MODE
    if (CalEvents & EVENT_METER)
      {
-     // STEP 2
-     MeasuredVoltage = ADC_getConvertedValue(Meter.ADC_HC15C);
-     DIP204_txt_engine(CLEAR_READING, METER_ROW, METER_POSITION, strlen(CLEAR_READING));
-     // WRITE TO DISPLAY
-     sprintf(LineText,"%2.3fV", MeasuredVoltage);
-     DIP204_txt_engine(LineText, METER_ROW, METER_POSITION, strlen(LineText));
-     // IF VCOM LINK WRITE OHM READING TO USB PORT
-     if (VCOM_Link & CalSettings.USB_Link)
+     // SCOPE MODE: SHOW A DONE CAPTURE AND ARM THE NEXT
+     if (CalSettings.CalMode == SCOPE_MODE)
        {
-       call_WriteToUSB_Meter(MeasuredVoltage, TYPE_VOLT);
-       }  
-     // STEP 3
-     if (MeasuredVoltage > Meter.MaxV)
+       call_ScopeUpdate();
+       ctl_events_set_clear(&CalEvents, 0, EVENT_METER);
+       continue;
+       }
+     // AC: THE RMS OF A CAPTURE - ALSO THE SWITCH BACK TO THE SCAN
+     if (Meter.AC || Meter.ACRunning)
        {
-       Meter.MaxV = MeasuredVoltage;
-       DIP204_txt_engine(CLEAR_READING, MAX_ROW, MAX_POSITION, strlen(CLEAR_READING));
-       sprintf(LineText,"%2.3fV", Meter.MaxV);
-       DIP204_txt_engine(LineText, MAX_ROW, MAX_POSITION, strlen(LineText));
+       call_VoltMeterAC();
+       ctl_events_set_clear(&CalEvents, 0, EVENT_METER);
+       continue;
        }
-     // STEP3
-     // CHECK FOR 10V RANGE
-     if (MeasuredVoltage <= RANGE_10V_TH)
+     // STEP 2
+     // AFTER A RANGE SWITCH PROBE UNTIL THE RANGE IS RIGHT, THEN WAIT FOR THE FILTER TO FILL ON IT
+     if (Meter.Step == METER_PROBING)
        {
-       if (Meter.LastRange != RANGE_10V_TH)
-         {
-         GPIO_SetValue(PORT1, (RANGE_10V|SEL_V_C));
-         GPIO_ClearValue(PORT1, (RANGE_20V|RANGE_30V));
-         Meter.ADC_HC15C.ADC_FrontEndDivider = ADC_10V_DIVIDER;
-         Meter.LastRange = RANGE_10V_TH;
-         DIP204_ICON_set(ICON_ALERT, ICON_OFF);
-         DIP204_txt_engine(CLEAR_READING, RANGE_ROW, RANGE_POSITION, strlen(CLEAR_READING));
-         DIP204_txt_engine(TXT_RNG_00_10, RANGE_ROW, RANGE_POSITION, strlen(TXT_RNG_00_10));
-         }
+       call_VoltMeterProbe();
+       ctl_events_set_clear(&CalEvents, 0, EVENT_METER);
+       continue;
        }
-     // CHECK FOR 20V RANGE
-     if ((MeasuredVoltage > RANGE_10V_TH) && (MeasuredVoltage < RANGE_20V_TH))
+     if (!ADC_ScanSettled(ADC_MET_VOLTAGE))
        {
-       if (Meter.LastRange != RANGE_20V_TH)
-         {
-         GPIO_SetValue(PORT1, (RANGE_20V|SEL_V_C));
-         GPIO_ClearValue(PORT1, (RANGE_10V|RANGE_30V));
-         Meter.ADC_HC15C.ADC_FrontEndDivider = ADC_20V_DIVIDER;
-         Meter.LastRange = RANGE_20V_TH;
-         DIP204_ICON_set(ICON_ALERT, ICON_OFF);
-         DIP204_txt_engine(CLEAR_READING, RANGE_ROW, RANGE_POSITION, strlen(CLEAR_READING));
-         DIP204_txt_engine(TXT_RNG_10_20, RANGE_ROW, RANGE_POSITION, strlen(TXT_RNG_10_20));
-         }
+       ctl_events_set_clear(&CalEvents, 0, EVENT_METER);
+       continue;
        }
-     // CHECK FOR 30V RANGE
-     if (MeasuredVoltage >= RANGE_20V_TH)
+     MeasuredVoltage = ADC_getConvertedValue(Meter.ADC_HC15C);
+     // STEP 3
+     // WRITE TO DISPLAY, USB AND UPDATE THE MAX
+     call_VoltMeterShow(MeasuredVoltage);
+     // STEP 4
+     if (Meter.Step == METER_FILLING)
        {
-       if (Meter.LastRange != RANGE_30V_TH)
-         {
-         GPIO_SetValue(PORT1, (RANGE_30V|SEL_V_C));
-         GPIO_ClearValue(PORT1, (RANGE_10V|RANGE_20V));
-         Meter.ADC_HC15C.ADC_FrontEndDivider = ADC_30V_DIVIDER;
-         Meter.LastRange = RANGE_30V_TH;
-         DIP204_ICON_set(ICON_ALERT, ICON_BLINK);
-         DIP204_txt_engine(CLEAR_READING, RANGE_ROW, RANGE_POSITION, strlen(CLEAR_READING));
-         DIP204_txt_engine(TXT_RNG_20_30, RANGE_ROW, RANGE_POSITION, strlen(TXT_RNG_20_30));
-         }
+       Meter.SettleTime = ctl_get_current_time() - Meter.StepStart;
+       Meter.Step = METER_STEADY;
+       sprintf(LineText, "%luMS", Meter.SettleTime);
+       LineText[DISPLAY_COLUMN_TOTAL - SETTLE_POSITION] = NULL_VALUE;
+       DIP204_txt_engine(LineText, RANGE_ROW, SETTLE_POSITION, strlen(LineText));
+       }
+     else if ((ADC_ScanProbeReady(ADC_MET_VOLTAGE)) && (call_VoltMeterRange(ADC_getProbeValue(Meter.ADC_HC15C)) != Meter.LastRange))
+       {
+       Meter.StepStart = ctl_get_current_time();
+       call_VoltMeterSwitch(call_VoltMeterRange(ADC_getProbeValue(Meter.ADC_HC15C)));
        }
      // CLEAR THE VOLT METER EVENT    
      ctl_events_set_clear(&CalEvents, 0, EVENT_METER);
@@ -162,54 +172,49 @@ extern BOOLEAN VCOM_Link;
    if (CalEvents & EVENT_OHMS)
      {
      // STEP 6
-     MeasuredResistance = ADC_getConvertedValue(OHMS.ADC_HC15C);
-     /* CALCULATE THE RESISTANCE BEING MEASURE WHICH WILL BE STORED IN Measured Value
-      * FROM NOTE ON 11/30/11 */
-     I2 = MeasuredResistance / RD;
-     Vb = I2 * (RC + RD);
-     I1 = (Vb + (RA * I2)) / RA;
-     // THIS IS MEASURED RESISTANCE 
-     MeasuredResistance = (ADC_REFERENCE - Vb) / I1;
+     if (!ADC_ScanProbeReady(ADC_MET_VOLTAGE))
+       {
+       ctl_events_set_clear(&CalEvents, 0, EVENT_OHMS);
+       continue;
+       }
+     MeasuredResistance = call_OhmsEstimate(call_OhmsFromVoltage(ADC_getProbeValue(OHMS.ADC_HC15C)));
      // STEP 7
-     if ( (100.0*fabs(MeasuredResistance-LastResistance)/MeasuredResistance) > READ_TOL_ERROR)
+     if ((MeasuredResistance < OHMS.Limit) != ContinunityTone)
        {
-       LastResistance = MeasuredResistance;
+       ContinunityTone = (MeasuredResistance < OHMS.Limit);
+       DIP204_txt_engine(CLEAR_READING, STATUS_ROW, STATUS_POSITION, strlen(CLEAR_READING));
+       if (ContinunityTone)
+         DIP204_txt_engine(TXT_SHORT, STATUS_ROW, STATUS_POSITION, strlen(TXT_SHORT));
+       else
+         DIP204_txt_engine(TXT_OPEN, STATUS_ROW, STATUS_POSITION, strlen(TXT_OPEN));
        }
-     else
+     // STEP 8
+     if (++OHMS.DisplayCount >= OHMS_DISPLAY_SAMPLES)
        {
-       // STEP 8
-       DIP204_txt_engine(CLEAR_READING, RX_ROW, RX_POSITION, strlen(CLEAR_READING));
+       OHMS.DisplayCount = 0;
        if (MeasuredResistance > MAX_OHM_READ)
          {
+         DIP204_txt_engine(CLEAR_READING, RX_ROW, RX_POSITION, strlen(CLEAR_READING));
          DIP204_txt_engine(TXT_OPEN_MEASURE, RX_ROW, RX_POSITION, strlen(TXT_OPEN_MEASURE));
-         DIP204_txt_engine(TXT_OPEN, STATUS_ROW, STATUS_POSITION, strlen(TXT_OPEN));
          // IF VCOM LINK WRITE OHM READING TO USB PORT
-         if (VCOM_Link & CalSettings.USB_Link)
+         if ((VCOM_Link & CalSettings.USB_Link) && !MeterStream.On)
            {
            call_WriteToUSB_Meter(OPEN_CIRCUIT_READING, TYPE_OHMS);
            }
          }
-       else
+       else if (OHMS.Converged)
          {
          // DISPLAY THE OHMS READING
-         sprintf(LineText,"%d", (uint16_t)MeasuredResistance);
+         DIP204_txt_engine(CLEAR_READING, RX_ROW, RX_POSITION, strlen(CLEAR_READING));
+         sprintf(LineText,"%d", (uint16_t)OHMS.Mean);
          DIP204_txt_engine(LineText, RX_ROW, RX_POSITION, strlen(LineText));
          // IF VCOM LINK WRITE OHM READING TO USB PORT
-         if (VCOM_Link & CalSettings.USB_Link)
+         if ((VCOM_Link & CalSettings.USB_Link) && !MeterStream.On)
            {
-           call_WriteToUSB_Meter(MeasuredResistance, TYPE_OHMS);
+           call_WriteToUSB_Meter(OHMS.Mean, TYPE_OHMS);
            }
-          if (MeasuredResistance < OHMS.Limit)
-            {
-            DIP204_txt_engine(TXT_SHORT, STATUS_ROW, STATUS_POSITION, strlen(TXT_SHORT));
-            ContinunityTone = TRUE;
-            }
-          else
-            {
-            DIP204_txt_engine(TXT_OPEN, STATUS_ROW, STATUS_POSITION, strlen(TXT_OPEN));
-            ContinunityTone = FALSE;
-            }
          }
+       call_LogShow();
        }
      ctl_events_set_clear(&CalEvents, 0, EVENT_OHMS);
      } // END OF EVENT_OHMS
@@ -242,6 +247,42 @@ extern BOOLEAN VCOM_Link;
        
      ctl_events_set_clear(&CalEvents, 0, EVENT_OHMS_UI);
      } // END OF EVENT_OHMS_UI
+   
+   // METER LOG EVENT
+   // STEP 11
+   if (CalEvents & EVENT_LOG)
+     {
+     if (CalSettings.CalMode == OHMS_MODE)
+       call_LogSample(call_OhmsFromVoltage(ADC_getConvertedValue(OHMS.ADC_HC15C)), 0, ADC_ScanSettled(ADC_MET_VOLTAGE));
+     else
+       call_LogSample((Meter.ACRunning ? Meter.Rms : ADC_getConvertedValue(Meter.ADC_HC15C)),
+                      (Meter.LastRange == RANGE_10V_TH) ? 10 : ((Meter.LastRange == RANGE_20V_TH) ? 20 : 30),
+                      (Meter.ACRunning ? Meter.RmsReady : ADC_ScanSettled(ADC_MET_VOLTAGE)));
+     ctl_events_set_clear(&CalEvents, 0, EVENT_LOG);
+     } // END OF EVENT_LOG
+   
+   // METER STREAM EVENT
+   // STEP 12
+   if (CalEvents & EVENT_STREAM)
+     {
+     if (!MeterStream.On)
+       {
+       call_StreamFlush();
+       }
+     else if (Meter.ACRunning ? Meter.RmsReady : ADC_ScanSettled(ADC_MET_VOLTAGE))
+       {
+       if (CalSettings.CalMode == OHMS_MODE)
+         {
+         MeasuredResistance = call_OhmsFromVoltage(ADC_getConvertedValue(OHMS.ADC_HC15C));
+         call_StreamSample(((MeasuredResistance > MAX_OHM_READ) ? OPEN_CIRCUIT_READING : MeasuredResistance), TYPE_OHMS);
+         }
+       else
+         {
+         call_StreamSample((Meter.ACRunning ? Meter.Rms : ADC_getConvertedValue(Meter.ADC_HC15C)), TYPE_VOLT);
+         }
+       }
+     ctl_events_set_clear(&CalEvents, 0, EVENT_STREAM);
+     } // END OF EVENT_STREAM
    }// END OF WHILE     
    
  } // END OF meter_taskFn
@@ -256,7 +297,8 @@ extern BOOLEAN VCOM_Link;
  *
  * Description: Places the calculator in Volt Meter mode.  Volt Meter Mode continuously displays the analog
  * voltage of the METER input.  Meter mode is self ranging and works with a timer1 IRQ and the meter task
- * to produce the desired effect.  The timer is used as the acquire interval.
+ * to produce the desired effect.  The timer is used as the acquire interval: an update each
+ * Meter.UpdateTicks of the timer.  The ADC scan filters the meter channel in the background.
  * Meter Mode is one of the fundamental modes of operation.  Meter mode is run from a task
  * which is (restored) by this function call.  Note the meter is not updated in this function.
  * It is updated in the meter task (event set by timer1 irq).
@@ -273,6 +315,9 @@ extern BOOLEAN VCOM_Link;
  CalSettings.Mask_KeyTouchA = CalSettings.Mask_KeyTouchB = NO_KEYS_SELECTED;
  CalSettings.Mask_KeyTouchA = (MASK_ATN_KEY | MASK_KEY_LSHIFT);
  CalSettings.Mask_KeyTouchB = (MASK_VMAX_RST | MASK_KEY_CAL | 
+                                               MASK_KEY_START |
+                                               MASK_KEY_STOP  |
+                                               MASK_KEY_UP    |
                                                MASK_KEY_METER |
                                                MASK_KEY_ALINK |
                                                MASK_KEY_FLASH |
@@ -298,13 +343,22 @@ extern BOOLEAN VCOM_Link;
       ctl_HabTaskRun(&meter_task);
     #endif    
    // SETUP THE ADC STRUCT VALUES TO DEFAULT 
-   Meter.ADC_HC15C.ADC_AvgWeight = METER_SAMPLE_AVG;
-   Meter.ADC_HC15C.ADC_msTimeBetweenSamples = METER_SAMPLE_AVG_TIME;
    Meter.ADC_HC15C.ADC_Type = ADC_MET_VOLTAGE;
    Meter.ADC_HC15C.ADC_FrontEndDivider = ADC_30V_DIVIDER;
    // SET THE METER TO THE HIGHEST RANGE (SAFEEST MODE) - MAKE BEFORE BREAK
    GPIO_SetValue(PORT1, (RANGE_30V|SEL_V_C));
    GPIO_ClearValue(PORT1, (RANGE_10V|RANGE_20V));
+   ADC_ScanConfig(ADC_MET_VOLTAGE, METER_DECIMATION, METER_FILTER_LENGTH);
+   Meter.UpdateTicks = METER_UPDATE_TICKS;
+   Meter.Ticks = 0;
+   // PICK THE FIRST RANGE FROM A PROBE ON THE 30V RANGE
+   Meter.ProbeTicks = 0;
+   Meter.StepStart = ctl_get_current_time();
+   Meter.Step = METER_PROBING;
+   // DC READINGS FROM THE SCAN
+   Meter.AC = FALSE;
+   Meter.ACRunning = FALSE;
+   Meter.RmsReady = FALSE;
    // SETUP THE METER STRUCT, AND DISPLAY
    Meter.MaxV = 0.0;
    Meter.LastRange = 0.0;
@@ -343,6 +397,31 @@ extern BOOLEAN VCOM_Link;
 
 
 
+/*************************************************************************
+ * Function Name: call_VoltMeterACToggle
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Asks for AC (RMS) or DC readings.  This function can only be called in Meter mode.
+ * The meter task makes the switch on its next meter event - it owns the ADC.
+ * STEP 1: Check to make sure in Meter mode.  If not do nothing.
+ * STEP 2: Toggle the readings asked for
+ **************************************************************************/
+ void call_VoltMeterACToggle(void)
+ {
+ 
+ // STEP 1
+ if (CalSettings.CalMode != METER_MODE)
+   return;
+ 
+ // STEP 2
+ Meter.AC = !Meter.AC;
+ 
+ } // END OF call_VoltMeterACToggle
+
+
+
+
 /*************************************************************************
  * Function Name: call_VoltMeterModeEnd
  * Parameters: void
@@ -351,7 +430,7 @@ extern BOOLEAN VCOM_Link;
  * Description: Performs the actions necessary to end Meter Mode.  Such that the next
  * mode can start itself.  This function sets CalMode to calculator mode as a default.  
  * It is up to the next mode function to set its mode of operation.
- * STEP 1: End the meter task
+ * STEP 1: End the meter task.  After AC readings start the background ADC scan again
  * STEP 2: Select all Keys for the next function
  * STEP 3: Prep the display for use by the next Mode
  **************************************************************************/
@@ -359,10 +438,12 @@ extern BOOLEAN VCOM_Link;
  {
  
  // STEP 1
- // STOP ANY FUTURE VOLT METER EVENTS
+ // STOP ANY FUTURE VOLT METER EVENTS, THE LOG AND THE STREAM
+ call_LogStop();
+ call_StreamStop();
  Meter.Status = STOP_MEASURE;
  // WAIT FOR METER EVENT TO CLEAR - AS THIS WILL BE A STABLE TIME TO SWITCH
- while (CalEvents & EVENT_METER)
+ while (CalEvents & (EVENT_METER|EVENT_LOG|EVENT_STREAM))
    {
    ctl_timeout_wait(ctl_get_current_time()+1);
    } 
@@ -371,6 +452,13 @@ extern BOOLEAN VCOM_Link;
  #elif defined(SUSPEND_RUN)
     ctl_HabTaskSuspend(&meter_task);
  #endif
+ if (Meter.ACRunning)
+   {
+   ADC_ScanStop();
+   init_ADC_Scan();
+   }
+ Meter.AC = FALSE;
+ Meter.ACRunning = FALSE;
  
  // STEP 2
  select_All_Normal_Keys();
@@ -392,11 +480,11 @@ extern BOOLEAN VCOM_Link;
  * Return: void
  *
  * Description: Places the calculator in OHMS mode.  OHMS Mode continuously displays the resistance
- * as measured at the METER input terminal.  OMHS mode works with timer1 IRQ and the meter task
+ * as measured at the METER input terminal.  OMHS mode works with timer0 IRQ and the meter task
  * to produce the desired effect.
  * OHMs Mode is one of the fundamental modes of operation.  OHMS mode is run from a task
  * which is restored by this function call.  Note the meter is not updated in this function.
- * It is updated in the meter task (event set by timer1 irq).
+ * It is updated in the meter task (event set by timer0 irq each OHMS_SAMPLE_TIME).
  * STEP 1: End the present mode, set up keys to use
  * STEP 2: Ready the display for use
  * STEP 3: Set the ohms mode vars and parameters
@@ -411,6 +499,8 @@ extern BOOLEAN VCOM_Link;
  CalSettings.Mask_KeyTouchA = CalSettings.Mask_KeyTouchB = NO_KEYS_SELECTED;
  CalSettings.Mask_KeyTouchA = (MASK_ATN_KEY | MASK_KEY_LSHIFT);
  CalSettings.Mask_KeyTouchB = (MASK_KEY_UP | MASK_KEY_DOWN |  MASK_KEY_CAL   | 
+                                                              MASK_KEY_START |
+                                                              MASK_KEY_STOP  |
                                                               MASK_KEY_METER |
                                                               MASK_KEY_ALINK |
                                                               MASK_KEY_FLASH |
@@ -437,13 +527,17 @@ extern BOOLEAN VCOM_Link;
       ctl_HabTaskRun(&meter_task);
     #endif 
    // SETUP THE ADC STRUCT VALUES
-   OHMS.ADC_HC15C.ADC_AvgWeight = OHMS_SAMPLE_AVG;
-   OHMS.ADC_HC15C.ADC_msTimeBetweenSamples = OHMS_SAMPLE_AVG_TIME;
    OHMS.ADC_HC15C.ADC_Type = ADC_MET_VOLTAGE;
    OHMS.ADC_HC15C.ADC_FrontEndDivider = ADC_OHMS_DIVIDER;
    // SET THE METER TO MEASURE OHMS - MAKE BEFORE BREAK
    GPIO_ClearValue(PORT1, (RANGE_10V|RANGE_20V|SEL_V_C));
    GPIO_SetValue(PORT1, RANGE_30V);
+   ADC_ScanConfig(ADC_MET_VOLTAGE, OHMS_DECIMATION, OHMS_FILTER_LENGTH);
+   OHMS.Ticks = 0;
+   OHMS.MedianHead = OHMS.MedianFilled = 0;
+   OHMS.Samples = 0;
+   OHMS.Converged = FALSE;
+   OHMS.DisplayCount = 0;
    // SETUP THE OHMS STRUCT AND DISPLAY
    OHMS.Status = START_MEASURE;
    OHMS.Limit = LIMIT_INCREMENT;
@@ -514,11 +608,13 @@ void call_OhmsLimitDown(void)
  {
  
  // STEP 1
- // STOP ANY FUTURE OHMS METER EVENT
+ // STOP ANY FUTURE OHMS METER EVENT, THE LOG AND THE STREAM
+ call_LogStop();
+ call_StreamStop();
  OHMS.Status = STOP_MEASURE;
  ContinunityTone = FALSE;
  // WAIT FOR METER EVENT TO CLEAR - AS THIS WILL BE A STABLE TIME TO SWITCH
- while (CalEvents & (EVENT_OHMS|EVENT_OHMS_UI))
+ while (CalEvents & (EVENT_OHMS|EVENT_OHMS_UI|EVENT_LOG|EVENT_STREAM))
    {
    ctl_timeout_wait(ctl_get_current_time()+1);
    } 
@@ -541,4 +637,807 @@ void call_OhmsLimitDown(void)
  // SET TO DEFAULT MODE
  CalSettings.CalMode = CAL_MODE;
   
- } // END OF call_OhmsMeterModeEnd
\ No newline at end of file
+ } // END OF call_OhmsMeterModeEnd
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ScopeMode
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Places the calculator in Scope mode: captures of the METER input on the 30V range at
+ * the full ADC rate (see ADC_CaptureStart) shown as a min / max trace in the user characters, with
+ * the rate achieved and the highest and lowest volts of the capture.  Each capture triggers on a
+ * rising edge through the trigger level (UP / DOWN keys) or, with no edge in SCOPE_AUTO_TIME, at once.
+ * While linked the USB LINK key sends each capture to the PC.  The meter task does the work on each
+ * timer1 meter event.  The background ADC scan is stopped while a capture is made - it runs between
+ * captures for the battery task (see call_CaptureMonitor).
+ * STEP 1: End the present mode, set up keys to use
+ * STEP 2: Ready the display - the trace characters blank
+ * STEP 3: Set scope mode vars and parameters
+ *************************************************************************/
+ void call_ScopeMode(void)
+ {
+ 
+ uint8_t LineText[DISPLAY_COLUMN_TOTAL],
+         Blank[CGRAM_ROWS];
+ 
+ // STEP 1
+ call_EndPresentMode();
+ CalSettings.Mask_KeyTouchA = CalSettings.Mask_KeyTouchB = NO_KEYS_SELECTED;
+ CalSettings.Mask_KeyTouchA = (MASK_ATN_KEY | MASK_KEY_LSHIFT);
+ CalSettings.Mask_KeyTouchB = (MASK_KEY_UP | MASK_KEY_DOWN |  MASK_KEY_CAL   | 
+                                                              MASK_KEY_METER |
+                                                              MASK_KEY_ALINK |
+                                                              MASK_KEY_FLASH |
+                                                              MASK_KEY_MUSIC );
+ 
+ // STEP 2
+ DIP204_set_cursor(CURSOR_OFF);
+ DIP204_clearDisplay();
+ strcpy(LineText, "SCOPE 30V");
+ DIP204_txt_engine(LineText,SCOPE_RATE_ROW,0,strlen(LineText));
+ memset(Blank, 0, sizeof(Blank));
+ for (uint8_t Character = 0; Character < CGRAM_CHARACTERS; Character++)
+   {
+   DIP204_loadCGRAM(Character, Blank);
+   LineText[Character] = Character;
+   }
+ DIP204_txt_engine(LineText, SCOPE_MAX_ROW, 0, SCOPE_TRACE_CHARS);
+ DIP204_txt_engine(&LineText[SCOPE_TRACE_CHARS], SCOPE_MIN_ROW, 0, SCOPE_TRACE_CHARS);
+ 
+ // STEP 3
+ if (CalSettings.CalMode != SCOPE_MODE)
+   {
+    #if defined(REMOVE_RESTORE)
+      ctl_task_restore(&meter_task);
+    #elif defined(SUSPEND_RUN)
+      ctl_HabTaskRun(&meter_task);
+    #endif    
+   // THE 30V RANGE - MAKE BEFORE BREAK
+   Scope.ADC_HC15C.ADC_Type = ADC_MET_VOLTAGE;
+   Scope.ADC_HC15C.ADC_FrontEndDivider = ADC_30V_DIVIDER;
+   GPIO_SetValue(PORT1, (RANGE_30V|SEL_V_C));
+   GPIO_ClearValue(PORT1, (RANGE_10V|RANGE_20V));
+   Scope.LevelSteps = SCOPE_DEFAULT_STEPS;
+   Scope.Send = FALSE;
+   Scope.Auto = FALSE;
+   Scope.Shown = FALSE;
+   Scope.Refresh = TRUE;
+   // THE FIRST CAPTURE IS ARMED ON THE NEXT METER EVENT
+   Scope.Status = START_MEASURE;
+   DIP204_ICON_set(ICON_INFO, ICON_ON);
+   CalSettings.CalMode = SCOPE_MODE;
+   }
+ 
+ } // END OF call_ScopeMode
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ScopeLevelUp
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Raises the scope trigger level a SCOPE_LEVEL_STEP.  The next capture armed uses it,
+ * the meter task shows it.
+ * STEP 1: Step up to the highest level
+ **************************************************************************/
+ void call_ScopeLevelUp(void)
+ {
+ 
+ // STEP 1
+ if (Scope.LevelSteps < SCOPE_LEVEL_STEPS)
+   Scope.LevelSteps++;
+ Scope.Refresh = TRUE;
+ 
+ } // END OF call_ScopeLevelUp
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ScopeLevelDown
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Lowers the scope trigger level a SCOPE_LEVEL_STEP.  The next capture armed uses it,
+ * the meter task shows it.
+ * STEP 1: Step down to 0V
+ **************************************************************************/
+ void call_ScopeLevelDown(void)
+ {
+ 
+ // STEP 1
+ if (Scope.LevelSteps > 0)
+   Scope.LevelSteps--;
+ Scope.Refresh = TRUE;
+ 
+ } // END OF call_ScopeLevelDown
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ScopeSendToggle
+ * Parameters: void
+ * Return: void
+ *
+ * Description: USB LINK key in Scope mode while linked.  Starts or stops sending each capture to the
+ * PC.  Stopping drops what is left of a capture being sent.
+ * STEP 1: Toggle the send, the meter task shows it
+ **************************************************************************/
+ void call_ScopeSendToggle(void)
+ {
+ 
+ // STEP 1
+ Scope.Send = !Scope.Send;
+ if (!Scope.Send)
+   VCOM_cancelBlock();
+ Scope.Refresh = TRUE;
+ 
+ } // END OF call_ScopeSendToggle
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ScopeModeEnd
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Performs the actions necessary to end Scope Mode such that the next mode can start
+ * itself.  This function sets CalMode to calculator mode as a default.  It is up to the next mode
+ * function to set its mode of operation.
+ * STEP 1: End the meter task
+ * STEP 2: Drop a capture being sent and start the background ADC scan again
+ * STEP 3: Select all Keys for the next function and prep the display for use by the next Mode
+ **************************************************************************/
+ void call_ScopeModeEnd(void)
+ {
+ 
+ // STEP 1
+ // STOP ANY FUTURE SCOPE EVENTS
+ Scope.Status = STOP_MEASURE;
+ // WAIT FOR METER EVENT TO CLEAR - AS THIS WILL BE A STABLE TIME TO SWITCH
+ while (CalEvents & EVENT_METER)
+   {
+   ctl_timeout_wait(ctl_get_current_time()+1);
+   } 
+ #if defined(REMOVE_RESTORE)
+    ctl_task_remove(&meter_task);
+ #elif defined(SUSPEND_RUN)
+    ctl_HabTaskSuspend(&meter_task);
+ #endif
+ 
+ // STEP 2
+ VCOM_cancelBlock();
+ ADC_ScanStop();
+ init_ADC_Scan();
+ 
+ // STEP 3
+ select_All_Normal_Keys();
+ DIP204_ICON_set(ICON_INFO, ICON_OFF);
+ DIP204_set_cursor(CURSOR_OFF);
+ DIP204_clearDisplay();
+ CalSettings.CalMode = CAL_MODE; // AS A DEFAULT
+ 
+ } // END OF call_ScopeModeEnd
+
+
+
+
+/*************************************************************************
+ * Function Name: call_OhmsFromVoltage
+ * Parameters: double
+ * Return: double
+ *
+ * Description: The resistance at the METER input from the voltage the ADC reads in OHMS mode.
+ * FROM NOTE ON 11/30/11
+ * STEP 1: Calculate the resistance being measured
+ **************************************************************************/
+ static double call_OhmsFromVoltage(double MeasuredVoltage)
+ {
+ 
+ double I1, I2, Vb;
+ 
+ // STEP 1
+ I2 = MeasuredVoltage / RD;
+ Vb = I2 * (RC + RD);
+ I1 = (Vb + (RA * I2)) / RA;
+ // THIS IS MEASURED RESISTANCE 
+ return((ADC_REFERENCE - Vb) / I1);
+ 
+ } // END OF call_OhmsFromVoltage
+
+
+
+
+/*************************************************************************
+ * Function Name: call_VoltMeterRange
+ * Parameters: double
+ * Return: double - the range: RANGE_10V_TH, RANGE_20V_TH or RANGE_30V_TH
+ *
+ * Description: The range for a reading taken on the present range.  A reading at the top of the
+ * 10V or 20V range is the divider at full scale, not the input - it could be anything up to 30V so
+ * go straight to the 30V range and let its probe pick the range down.  A switch down needs the
+ * reading RANGE_HYSTERESIS under the threshold so a reading at a threshold does not flip ranges.
+ * STEP 1: Full scale on the 10V or 20V range - the 30V range
+ * STEP 2: The lowest range that holds the reading
+ **************************************************************************/
+ static double call_VoltMeterRange(double MeasuredVoltage)
+ {
+ 
+ // STEP 1
+ if ((Meter.LastRange == RANGE_10V_TH) && (MeasuredVoltage > RANGE_10V_TH))
+   return(RANGE_30V_TH);
+ if ((Meter.LastRange == RANGE_20V_TH) && (MeasuredVoltage >= RANGE_20V_TH))
+   return(RANGE_30V_TH);
+ 
+ // STEP 2
+ if (MeasuredVoltage <= (RANGE_10V_TH - ((Meter.LastRange > RANGE_10V_TH) ? RANGE_HYSTERESIS : 0.0)))
+   return(RANGE_10V_TH);
+ if (MeasuredVoltage < (RANGE_20V_TH - ((Meter.LastRange > RANGE_20V_TH) ? RANGE_HYSTERESIS : 0.0)))
+   return(RANGE_20V_TH);
+ return(RANGE_30V_TH);
+ 
+ } // END OF call_VoltMeterRange
+
+
+
+
+/*************************************************************************
+ * Function Name: call_VoltMeterSwitch
+ * Parameters: double
+ * Return: void
+ *
+ * Description: Switches the volt meter to the passed range: the hardware divider and the ADC ratio.
+ * The meter channel filter starts over and drops METER_SETTLE_SAMPLES while the input settles,
+ * then the meter task probes the new range (timer 0 meter events until the first reading).
+ * STEP 1: Set the range pins and divider
+ * STEP 2: Flush the meter channel and probe
+ * STEP 3: Show the range
+ **************************************************************************/
+ static void call_VoltMeterSwitch(double Range)
+ {
+ 
+ // STEP 1
+ call_VoltMeterPins(Range);
+ if (Range == RANGE_10V_TH)
+   Meter.ADC_HC15C.ADC_FrontEndDivider = ADC_10V_DIVIDER;
+ else if (Range == RANGE_20V_TH)
+   Meter.ADC_HC15C.ADC_FrontEndDivider = ADC_20V_DIVIDER;
+ else
+   Meter.ADC_HC15C.ADC_FrontEndDivider = ADC_30V_DIVIDER;
+ 
+ // STEP 2
+ ADC_ScanFlush(ADC_MET_VOLTAGE, METER_SETTLE_SAMPLES);
+ Meter.LastRange = Range;
+ Meter.ProbeTicks = 0;
+ Meter.Step = METER_PROBING;
+ 
+ // STEP 3
+ DIP204_ICON_set(ICON_ALERT, ((Range == RANGE_30V_TH) ? ICON_BLINK : ICON_OFF));
+ DIP204_clearLine(RANGE_ROW);
+ if (Range == RANGE_10V_TH)
+   DIP204_txt_engine(TXT_RNG_00_10, RANGE_ROW, RANGE_POSITION, strlen(TXT_RNG_00_10));
+ else if (Range == RANGE_20V_TH)
+   DIP204_txt_engine(TXT_RNG_10_20, RANGE_ROW, RANGE_POSITION, strlen(TXT_RNG_10_20));
+ else
+   DIP204_txt_engine(TXT_RNG_20_30, RANGE_ROW, RANGE_POSITION, strlen(TXT_RNG_20_30));
+ 
+ } // END OF call_VoltMeterSwitch
+
+
+
+
+/*************************************************************************
+ * Function Name: call_VoltMeterPins
+ * Parameters: double
+ * Return: void
+ *
+ * Description: Sets the range pins of the passed range - make before break.  init_ADC_Scan sets the
+ * 30V pins, so a scan started between AC captures sets the range back with this.
+ * STEP 1: Set the new range pin, then clear the others
+ **************************************************************************/
+ static void call_VoltMeterPins(double Range)
+ {
+ 
+ // STEP 1
+ if (Range == RANGE_10V_TH)
+   {
+   GPIO_SetValue(PORT1, (RANGE_10V|SEL_V_C));
+   GPIO_ClearValue(PORT1, (RANGE_20V|RANGE_30V));
+   }
+ else if (Range == RANGE_20V_TH)
+   {
+   GPIO_SetValue(PORT1, (RANGE_20V|SEL_V_C));
+   GPIO_ClearValue(PORT1, (RANGE_10V|RANGE_30V));
+   }
+ else
+   {
+   GPIO_SetValue(PORT1, (RANGE_30V|SEL_V_C));
+   GPIO_ClearValue(PORT1, (RANGE_10V|RANGE_20V));
+   }
+ 
+ } // END OF call_VoltMeterPins
+
+
+
+
+/*************************************************************************
+ * Function Name: call_VoltMeterProbe
+ * Parameters: void
+ * Return: void
+ *
+ * Description: A meter event after a range switch.  Once the input has settled the probe value
+ * (a few ms of samples) says if the range is right.  If not switch again, if so the meter task
+ * takes the first reading when the filter is full.
+ * STEP 1: Wait for a probe on the new range
+ * STEP 2: Switch again or wait for the filter
+ **************************************************************************/
+ static void call_VoltMeterProbe(void)
+ {
+ 
+ double Range;
+ 
+ // STEP 1
+ if (!ADC_ScanProbeReady(ADC_MET_VOLTAGE))
+   return;
+ 
+ // STEP 2
+ Range = call_VoltMeterRange(ADC_getProbeValue(Meter.ADC_HC15C));
+ if (Range != Meter.LastRange)
+   call_VoltMeterSwitch(Range);
+ else
+   Meter.Step = METER_FILLING;
+ 
+ } // END OF call_VoltMeterProbe
+
+
+
+
+/*************************************************************************
+ * Function Name: call_VoltMeterAC
+ * Parameters: void
+ * Return: void
+ *
+ * Description: A meter event while AC readings are asked for (or were).  The filter of the scan is an
+ * average - nothing of an AC input - so each reading is the RMS of a capture of the meter input at
+ * ADC_RMS_RATE with the DC removed, over whole cycles (see ADC_CaptureRMS).  The capture is forced: no
+ * trigger, the DMA fills the ring while the CPU is free - a reading about each 300ms.  The range is the
+ * one that holds the highest count of a capture.  A capture that switches the range is not shown, the
+ * next is started on the next event - after the input has settled on the new range.  Back to DC the scan
+ * starts again and probes from the 30V range.  The capture stops the scan, so between captures the scan
+ * runs again for the battery task (see call_CaptureMonitor).
+ * STEP 1: Back to DC readings - or the first AC event
+ * STEP 2: Wait on a capture being made
+ * STEP 3: The RMS of a done capture.  Switch the range or show the reading and its frequency
+ * STEP 4: Start the next capture once the battery and USB filters are full
+ **************************************************************************/
+ static void call_VoltMeterAC(void)
+ {
+ 
+ uint8_t LineText[DISPLAY_COLUMN_TOTAL + 1],
+         Status;
+ double Range;
+ ADC_RMS_Type RMS;
+ 
+ // STEP 1
+ if (!Meter.AC)
+   {
+   ADC_ScanStop();
+   init_ADC_Scan();
+   Meter.ACRunning = FALSE;
+   Meter.RmsReady = FALSE;
+   Meter.MaxV = 0.0;
+   DIP204_clearLine(METER_ROW);
+   Meter.StepStart = ctl_get_current_time();
+   call_VoltMeterSwitch(RANGE_30V_TH);
+   return;
+   }
+ if (!Meter.ACRunning)
+   {
+   Meter.ACRunning = TRUE;
+   Meter.RmsReady = FALSE;
+   Meter.MaxV = 0.0;
+   Meter.Step = METER_STEADY;
+   DIP204_clearLine(METER_ROW);
+   }
+ 
+ // STEP 2
+ Status = ADC_CaptureStatus();
+ if ((Status == CAPTURE_ARMED) || (Status == CAPTURE_TRIGGERED))
+   return;
+ 
+ // STEP 3
+ if (Status == CAPTURE_DONE)
+   {
+   ADC_CaptureRMS(ADC_CaptureResult(), &RMS);
+   Range = call_VoltMeterRange((RMS.High / ADC_FULL_COUNT) * (1.0 / Meter.ADC_HC15C.ADC_FrontEndDivider) * ADC_REFERENCE);
+   if (Range != Meter.LastRange)
+     {
+     // NO CAPTURE UNTIL THE NEXT EVENT - THE INPUT SETTLES ON THE NEW RANGE
+     call_VoltMeterSwitch(Range);
+     Meter.Step = METER_STEADY;
+     Meter.RmsReady = FALSE;
+     ADC_ScanStop();
+     return;
+     }
+   else
+     {
+     Meter.Rms = (RMS.Rms / ADC_FULL_COUNT) * (1.0 / Meter.ADC_HC15C.ADC_FrontEndDivider) * ADC_REFERENCE;
+     Meter.RmsReady = TRUE;
+     call_VoltMeterShow(Meter.Rms);
+     sprintf(LineText, ((RMS.Frequency < 1000.0) ? "%5.1fHZ" : "%5.0fHZ"), RMS.Frequency);
+     LineText[DISPLAY_COLUMN_TOTAL - FREQUENCY_POSITION] = NULL_VALUE;
+     DIP204_txt_engine(LineText, RANGE_ROW, FREQUENCY_POSITION, strlen(LineText));
+     }
+   }
+   
+ // STEP 4
+ if (!call_CaptureMonitor(Meter.LastRange))
+   return;
+ ADC_CaptureStart(ADC_RMS_RATE, 0, TRUE, 1);
+ ADC_CaptureForce();
+ 
+ } // END OF call_VoltMeterAC
+
+
+
+
+/*************************************************************************
+ * Function Name: call_VoltMeterShow
+ * Parameters: double
+ * Return: void
+ *
+ * Description: Shows a volt meter reading, DC or AC, sends it while linked (not while streaming) and
+ * updates the max.
+ * STEP 1: Display the reading
+ * STEP 2: To the USB port and the log row
+ * STEP 3: Update the Max V measure
+ **************************************************************************/
+ static void call_VoltMeterShow(double MeasuredVoltage)
+ {
+ 
+ uint8_t LineText[DISPLAY_COLUMN_TOTAL + 1];
+ 
+ // STEP 1
+ DIP204_txt_engine(CLEAR_READING, METER_ROW, METER_POSITION, strlen(CLEAR_READING));
+ sprintf(LineText, (Meter.ACRunning ? "%6.3fV AC" : "%2.3fV"), MeasuredVoltage);
+ DIP204_txt_engine(LineText, METER_ROW, METER_POSITION, strlen(LineText));
+ 
+ // STEP 2
+ // IF VCOM LINK WRITE VOLT READING TO USB PORT
+ if ((VCOM_Link & CalSettings.USB_Link) && !MeterStream.On)
+   {
+   call_WriteToUSB_Meter(MeasuredVoltage, TYPE_VOLT);
+   }  
+ call_LogShow();
+ 
+ // STEP 3
+ if (MeasuredVoltage > Meter.MaxV)
+   {
+   Meter.MaxV = MeasuredVoltage;
+   DIP204_txt_engine(CLEAR_READING, MAX_ROW, MAX_POSITION, strlen(CLEAR_READING));
+   sprintf(LineText,"%2.3fV", Meter.MaxV);
+   DIP204_txt_engine(LineText, MAX_ROW, MAX_POSITION, strlen(LineText));
+   }
+ 
+ } // END OF call_VoltMeterShow
+
+
+
+
+/*************************************************************************
+ * Function Name: call_OhmsEstimate
+ * Parameters: double
+ * Return: double - the median of the last OHMS_MEDIAN samples
+ *
+ * Description: Adds a resistance sample to the ohms estimate.  The median of the last samples
+ * rejects a spike (probe bounce, noise) and is what continuity is decided on.  The median feeds
+ * an exponential running mean and variance: the reading is converged when the deviation is under
+ * READ_TOL_ERROR percent of the mean.  A median far off the mean (OHMS_STEP_SIGMA deviations and
+ * out of tolerance) is a new contact - the estimate starts over from it instead of slowly
+ * following it.
+ * STEP 1: Clamp and add the sample to the ring.  The median of the ring
+ * STEP 2: Start over on the first sample or a step, otherwise update the mean and variance
+ * STEP 3: Converged from the variance
+ **************************************************************************/
+ static double call_OhmsEstimate(double Resistance)
+ {
+ 
+ double Sorted[OHMS_MEDIAN],
+        Median,
+        Deviation,
+        Tolerance;
+ uint8_t Index, Count;
+ 
+ // STEP 1
+ if (Resistance < 0.0)
+   Resistance = 0.0;
+ if (!(Resistance < OHMS_CLAMP))
+   Resistance = OHMS_CLAMP;
+ OHMS.Median[OHMS.MedianHead] = Resistance;
+ if (++OHMS.MedianHead >= OHMS_MEDIAN)
+   OHMS.MedianHead = 0;
+ if (OHMS.MedianFilled < OHMS_MEDIAN)
+   OHMS.MedianFilled++;
+ // INSERTION SORT - A FEW SAMPLES
+ for (Count = 0; Count < OHMS.MedianFilled; Count++)
+   {
+   for (Index = Count; (Index > 0) && (Sorted[Index - 1] > OHMS.Median[Count]); Index--)
+     Sorted[Index] = Sorted[Index - 1];
+   Sorted[Index] = OHMS.Median[Count];
+   }
+ Median = Sorted[OHMS.MedianFilled / 2];
+ 
+ // STEP 2
+ Deviation = Median - OHMS.Mean;
+ Tolerance = OHMS.Mean * (READ_TOL_ERROR / 100.0);
+ if (Tolerance < OHMS_MIN_TOLERANCE)
+   Tolerance = OHMS_MIN_TOLERANCE;
+ if ((OHMS.Samples == 0) || ((OHMS.Samples >= OHMS_MIN_SAMPLES) && (fabs(Deviation) > Tolerance) &&
+     ((Deviation * Deviation) > (OHMS_STEP_SIGMA * OHMS_STEP_SIGMA * OHMS.Variance))))
+   {
+   OHMS.Mean = Median;
+   OHMS.Variance = 0.0;
+   OHMS.Samples = 1;
+   OHMS.Converged = FALSE;
+   return(Median);
+   }
+ OHMS.Mean += OHMS_ALPHA * Deviation;
+ OHMS.Variance = (1.0 - OHMS_ALPHA) * (OHMS.Variance + (OHMS_ALPHA * Deviation * Deviation));
+ if (OHMS.Samples < OHMS_MIN_SAMPLES)
+   OHMS.Samples++;
+ 
+ // STEP 3
+ Tolerance = OHMS.Mean * (READ_TOL_ERROR / 100.0);
+ if (Tolerance < OHMS_MIN_TOLERANCE)
+   Tolerance = OHMS_MIN_TOLERANCE;
+ OHMS.Converged = ((OHMS.Samples >= OHMS_MIN_SAMPLES) && (OHMS.Variance <= (Tolerance * Tolerance)));
+ return(Median);
+ 
+ } // END OF call_OhmsEstimate
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ScopeUpdate
+ * Parameters: void
+ * Return: void
+ *
+ * Description: A meter event in scope mode.  A done capture is shown (and sent) once, then the next
+ * is armed - not while the last one is still being sent: the USB reads it where the DMA wrote it.
+ * A capture armed SCOPE_AUTO_TIME without an edge is forced.  The capture stops the background
+ * scan, so between captures the scan runs again for the battery task (see call_CaptureMonitor).
+ * STEP 1: Show a key change of the trigger row
+ * STEP 2: Show and send a done capture
+ * STEP 3: Arm the next capture once the battery and USB filters are full, or force one armed too long
+ **************************************************************************/
+ static void call_ScopeUpdate(void)
+ {
+ 
+ uint8_t Status;
+ uint32_t Level;
+ const ADC_Capture_Type *Capture;
+ 
+ // STEP 1
+ if (Scope.Refresh)
+   {
+   Scope.Refresh = FALSE;
+   call_ScopeTrigRow();
+   }
+ 
+ // STEP 2
+ Status = ADC_CaptureStatus();
+ if ((Status == CAPTURE_DONE) && (!Scope.Shown))
+   {
+   Capture = ADC_CaptureResult();
+   call_ScopeShow(Capture);
+   if (Scope.Send && VCOM_Link)
+     call_WriteToUSB_Scope(Capture, Scope.ADC_HC15C.ADC_FrontEndDivider);
+   Scope.Shown = TRUE;
+   }
+ 
+ // STEP 3
+ if (((Status == CAPTURE_IDLE) || (Status == CAPTURE_DONE)) && (!VCOM_blockBusy()))
+   {
+   if (!call_CaptureMonitor(RANGE_30V_TH))
+     return;
+   Level = (uint32_t)(((Scope.LevelSteps * SCOPE_LEVEL_STEP) * Scope.ADC_HC15C.ADC_FrontEndDivider / ADC_REFERENCE) * ADC_FULL_COUNT);
+   if (Level > (uint32_t)ADC_FULL_COUNT)
+     Level = (uint32_t)ADC_FULL_COUNT;
+   ADC_CaptureStart(ADC_CAPTURE_RATE, (uint16_t)Level, TRUE, SCOPE_PRE_CHUNKS);
+   Scope.ArmTime = ctl_get_current_time();
+   Scope.Auto = FALSE;
+   Scope.Shown = FALSE;
+   }
+ else if ((Status == CAPTURE_ARMED) && (!Scope.Auto) && ((ctl_get_current_time() - Scope.ArmTime) >= SCOPE_AUTO_TIME))
+   {
+   ADC_CaptureForce();
+   Scope.Auto = TRUE;
+   }
+ 
+ } // END OF call_ScopeUpdate
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ScopeShow
+ * Parameters: const ADC_Capture_Type *
+ * Return: void
+ *
+ * Description: Shows a capture: the samples in time order decimated to SCOPE_TRACE_WIDTH columns, the
+ * lowest and highest count of each column drawn as a bar in the user characters.  The trace spans the
+ * lowest to the highest count of the capture - at least SCOPE_MIN_SPAN.  The samples are read in the
+ * capture ring, not copied.
+ * STEP 1: The low and high of each column and of the capture
+ * STEP 2: The vertical scale
+ * STEP 3: Draw each column into the patterns and load them
+ * STEP 4: Show the rate, the highest and lowest volts and the trigger
+ **************************************************************************/
+ static void call_ScopeShow(const ADC_Capture_Type *Capture)
+ {
+ 
+ uint8_t LineText[DISPLAY_COLUMN_TOTAL + 1],
+         Pattern[CGRAM_CHARACTERS][CGRAM_ROWS],
+         Column, Top, Base, Character;
+ uint16_t Low[SCOPE_TRACE_WIDTH],
+          High[SCOPE_TRACE_WIDTH],
+          Result,
+          Min = (uint16_t)ADC_FULL_COUNT,
+          Max = 0;
+ uint32_t Bottom, Span;
+ 
+ // STEP 1
+ for (Column = 0; Column < SCOPE_TRACE_WIDTH; Column++)
+   {
+   Low[Column] = (uint16_t)ADC_FULL_COUNT;
+   High[Column] = 0;
+   }
+ for (uint16_t Count = 0; Count < ADC_CAPTURE_SAMPLES; Count++)
+   {
+   Result = ADC_GDR_RESULT(Capture->Buffer[(Capture->First + Count) % ADC_CAPTURE_SAMPLES]);
+   Column = ((uint32_t)Count * SCOPE_TRACE_WIDTH) / ADC_CAPTURE_SAMPLES;
+   if (Result < Low[Column])
+     Low[Column] = Result;
+   if (Result > High[Column])
+     High[Column] = Result;
+   }
+ for (Column = 0; Column < SCOPE_TRACE_WIDTH; Column++)
+   {
+   if (Low[Column] < Min)
+     Min = Low[Column];
+   if (High[Column] > Max)
+     Max = High[Column];
+   }
+ 
+ // STEP 2
+ Bottom = Min;
+ Span = Max - Min;
+ if (Span < SCOPE_MIN_SPAN)
+   {
+   Bottom = (((uint32_t)Min + Max) / 2 > (SCOPE_MIN_SPAN / 2)) ? ((((uint32_t)Min + Max) / 2) - (SCOPE_MIN_SPAN / 2)) : 0;
+   Span = SCOPE_MIN_SPAN;
+   }
+ 
+ // STEP 3
+ // PIXEL ROW 0 IS THE TOP OF THE TRACE
+ memset(Pattern, 0, sizeof(Pattern));
+ for (Column = 0; Column < SCOPE_TRACE_WIDTH; Column++)
+   {
+   Top = (SCOPE_TRACE_HEIGHT - 1) - (((High[Column] - Bottom) * (SCOPE_TRACE_HEIGHT - 1) + (Span / 2)) / Span);
+   Base = (SCOPE_TRACE_HEIGHT - 1) - (((Low[Column] - Bottom) * (SCOPE_TRACE_HEIGHT - 1) + (Span / 2)) / Span);
+   for (uint8_t Row = Top; Row <= Base; Row++)
+     {
+     Character = ((Row / CGRAM_ROWS) * SCOPE_TRACE_CHARS) + (Column / CGRAM_WIDTH);
+     Pattern[Character][Row % CGRAM_ROWS] |= (1 << (CGRAM_WIDTH - 1 - (Column % CGRAM_WIDTH)));
+     }
+   }
+ for (Character = 0; Character < CGRAM_CHARACTERS; Character++)
+   {
+   DIP204_loadCGRAM(Character, Pattern[Character]);
+   }
+ 
+ // STEP 4
+ sprintf(LineText, "%5.1fKS/S", (Capture->Rate / 1000.0));
+ DIP204_txt_engine(LineText, SCOPE_RATE_ROW, SCOPE_RATE_POSITION, strlen(LineText));
+ sprintf(LineText, "MAX %6.3fV", call_ScopeVolts(Max));
+ DIP204_txt_engine(LineText, SCOPE_MAX_ROW, SCOPE_VALUE_POSITION, strlen(LineText));
+ sprintf(LineText, "MIN %6.3fV", call_ScopeVolts(Min));
+ DIP204_txt_engine(LineText, SCOPE_MIN_ROW, SCOPE_VALUE_POSITION, strlen(LineText));
+ call_ScopeTrigRow();
+ 
+ } // END OF call_ScopeShow
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ScopeTrigRow
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Shows the trigger row: the level, AUTO if the capture was forced (EDGE if not) and USB
+ * while captures are sent.
+ * STEP 1: Write the whole row
+ **************************************************************************/
+ static void call_ScopeTrigRow(void)
+ {
+ 
+ uint8_t LineText[DISPLAY_COLUMN_TOTAL + 1];
+ 
+ // STEP 1
+ sprintf(LineText, "TRIG %4.1fV %s  %s", (Scope.LevelSteps * SCOPE_LEVEL_STEP), (Scope.Auto ? "AUTO" : "EDGE"),
+         ((Scope.Send && VCOM_Link) ? "USB" : "   "));
+ DIP204_txt_engine(LineText, SCOPE_TRIG_ROW, 0, strlen(LineText));
+ 
+ } // END OF call_ScopeTrigRow
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ScopeVolts
+ * Parameters: uint16_t
+ * Return: double
+ *
+ * Description: The volts at the METER input of an ADC count of a capture - the scope range divider.
+ * STEP 1: Scale the count
+ **************************************************************************/
+ static double call_ScopeVolts(uint16_t Result)
+ {
+ 
+ // STEP 1
+ return((Result / ADC_FULL_COUNT) * (1.0 / Scope.ADC_HC15C.ADC_FrontEndDivider) * ADC_REFERENCE);
+ 
+ } // END OF call_ScopeVolts
+
+
+
+
+/*************************************************************************
+ * Function Name: call_CaptureMonitor
+ * Parameters: double
+ * Return: BOOLEAN
+ *
+ * Description: Before a capture is started: TRUE if it can be.  A capture stops the background scan
+ * and the battery task waits on full battery and USB filters, so the scan runs between captures until
+ * both are full - after a wake or mode change and again each CAPTURE_MONITOR_TIME so the battery
+ * and USB readings stay current.  FALSE while the scan runs: the meter event after it fills starts
+ * the capture.  Range is the meter range of the captures - init_ADC_Scan sets the 30V pins.
+ * STEP 1: Scan running - wait for the battery and USB filters
+ * STEP 2: Start the scan if a filter is not full or the last scan is too old
+ **************************************************************************/
+ static BOOLEAN call_CaptureMonitor(double Range)
+ {
+ 
+ // STEP 1
+ if (CaptureMonitoring)
+   {
+   if ((!ADC_ScanSettled(ADC_BAT_VOLTAGE)) || (!ADC_ScanSettled(ADC_USB_VOLTAGE)))
+     return(FALSE);
+   CaptureMonitoring = FALSE;
+   CaptureMonitorTime = ctl_get_current_time();
+   return(TRUE);
+   }
+ 
+ // STEP 2
+ if ((!ADC_ScanSettled(ADC_BAT_VOLTAGE)) || (!ADC_ScanSettled(ADC_USB_VOLTAGE)) ||
+     ((ctl_get_current_time() - CaptureMonitorTime) >= CAPTURE_MONITOR_TIME))
+   {
+   ADC_ScanStop();
+   init_ADC_Scan();
+   call_VoltMeterPins(Range);
+   CaptureMonitoring = TRUE;
+   return(FALSE);
+   }
+ return(TRUE);
+ 
+ } // END OF call_CaptureMonitor
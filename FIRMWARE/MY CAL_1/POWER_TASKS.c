@@ -39,7 +39,8 @@ extern Type_CalSettings CalSettings;
  * The other function of this task is to update the backlight display.  The counter BackLightTimer
  * is incremented every second in the same IRQ.  The back light is dimmed according to the count.
  * The event back light sets the back light to full brightness and resets the back light counter to 0
- * STEP 1: Read Battery Voltage and USB (J3) voltage.  If connected to USB always display a full charge and
+ * STEP 1: Read Battery Voltage and USB (J3) voltage - the latest values of the background ADC scan, the
+ * meter is not held up.  If connected to USB always display a full charge and
  * display ICON of computer connect - this is the USB Link
  * STEP 2: Update the Battery Charge Display ICON if necessary
  * STEP 3: Update the display back light
@@ -68,9 +69,9 @@ void batQ_taskFn(void *p)
     if (CalEvents & EVENT_BAT_Q)
       {
       // STEP 1
-      // READ AND CHECK IF CONNECTED TO USB FOR PWR
-      ADC_HC15C_Struct.ADC_AvgWeight = ADC_AVG_WEIGHT;
-      ADC_HC15C_Struct.ADC_msTimeBetweenSamples = ADC_SAMPLE_RATE;
+      // READ AND CHECK IF CONNECTED TO USB FOR PWR - AFTER AN INIT (POR OR WAKE) WAIT FOR FULL FILTERS
+      while ((!ADC_ScanSettled(ADC_USB_VOLTAGE)) || (!ADC_ScanSettled(ADC_BAT_VOLTAGE)))
+        ctl_timeout_wait(ctl_get_current_time()+ADC_SCAN_SETTLE);
       ADC_HC15C_Struct.ADC_Type = ADC_USB_VOLTAGE;
       ADC_HC15C_Struct.ADC_FrontEndDivider = ADC_VUSB_DIVIDER;
       MeasuredUSB_Voltage = ADC_getConvertedValue(ADC_HC15C_Struct);
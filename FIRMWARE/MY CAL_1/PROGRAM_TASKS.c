@@ -0,0 +1,1814 @@
+/*****************************************************************
+ *
+ * File name:       PROGRAM_TASKS.C
+ * Description:     Keystroke programming of the HC15C - program entry, the compiler and the program task
+ * Author:          Hab S. Collector
+ * Date:            10/19/2026
+ * LAST EDIT:       10/19/2026
+ * Hardware:        NXP LPC1769
+ * Firmware Tool:   CrossStudio for ARM
+ * Notes:           This file should be written as to not be dependent on other includes.
+ *                  everything these functions need should be passed to them.
+ *                  It will be necessary to consult the reference documents and associated schematics to understand
+ *                  the operations of this firmware.
+ *                  A program is recorded one byte per keystroke (see PROGRAM_KEY_CODE) with LBL, GTO, GSB,
+ *                  RTN, TEST, DSE, ISG, R/S, STO and RCL as byte codes of their own.  The byte code is what is
+ *                  kept in RAM and on the SD card.  At R/S the byte code is compiled once to an array of cells:
+ *                  runs of number keys become one literal with its entry parse already built, math keys become
+ *                  a direct call of the key's function and GTO / GSB hold the address of their label.  The
+ *                  program task then runs cell to cell with the display held - the display is written once
+ *                  when the program stops.
+ *****************************************************************/
+
+#include <ctl_api.h>
+#include "PROGRAM_TASKS.H"
+#include "SOLVE_FUNCTIONS.H"
+#include "BATCH_FUNCTIONS.H"
+#include "CORE_FUNCTIONS.H"
+#include "MATH_FUNCTIONS.H"
+#include "KERNEL_FUNCTIONS.H"
+#include "TOUCH_TASKS.H"
+#include "TIMERS_HC15C.H"
+#include "DIP204.H"
+#include "AUDIO_TASKS.H"
+#include "FAT_FS_INC/ff.h"
+#include "lpc_types.h"
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+
+// GLOBAL VARS
+// TYPES
+Type_Program Program;
+// THE COMPILED PROGRAM - AHB SRAM, SET BY EACH COMPILE
+static Type_ProgramCell ProgramCell[PROGRAM_MAX_CELLS] AHB_BANK1;
+static Type_ProgramLiteral ProgramLiteral[PROGRAM_MAX_LITERALS] AHB_BANK1;
+static uint16_t ProgramLabel[PROGRAM_LABELS];
+// NUMBER ENTRY CHAR OF EACH KEY - A: HEX DIGITS, B: DIGITS, DP, EEX ('E') AND CHS ('-').  0 IF NOT NUMBER ENTRY
+static const uint8_t ProgramLiteralChar[2][24] =
+  {
+  {0,   0,   0,   0,   0,   'A', 'B', 'C', 0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   'D', 'E', 'F', 0,   0,   0},
+  {'3', 0,   0,   '0', '1', 0,   'E', '4', 0,   0,   0,   '8', '9', 0,   0,   '2', 0,   '.', '-', '7', 0,   0,   '5', '6'}
+  };
+// KEYS OF PROGRAM ENTRY THAT ARE PROGRAM OPERATIONS
+static const uint8_t ProgramKeyOperation[][2] =
+  {
+  {PROGRAM_KEY_CODE(FALSE, 1, PROGRAM_R_SHIFT),  PROGRAM_LBL},    // R SHIFT tan
+  {PROGRAM_KEY_CODE(FALSE, 3, PROGRAM_R_SHIFT),  PROGRAM_GTO},    // R SHIFT e^x
+  {PROGRAM_KEY_CODE(FALSE, 17, PROGRAM_R_SHIFT), PROGRAM_GSB},    // R SHIFT 10^x
+  {PROGRAM_KEY_CODE(FALSE, 21, PROGRAM_R_SHIFT), PROGRAM_RTN},    // R SHIFT y^x
+  {PROGRAM_KEY_CODE(FALSE, 8, PROGRAM_R_SHIFT),  PROGRAM_TEST},   // R SHIFT 1/x
+  {PROGRAM_KEY_CODE(TRUE, 9, PROGRAM_R_SHIFT),   PROGRAM_DSE},    // R SHIFT VOLT
+  {PROGRAM_KEY_CODE(TRUE, 10, PROGRAM_R_SHIFT),  PROGRAM_ISG},    // R SHIFT MUSIC
+  {PROGRAM_KEY_CODE(TRUE, 21, PROGRAM_R_SHIFT),  PROGRAM_RS},     // R SHIFT CLOCK
+  {PROGRAM_KEY_CODE(FALSE, 22, PROGRAM_L_SHIFT), PROGRAM_STO},    // L SHIFT RCL
+  {PROGRAM_KEY_CODE(FALSE, 22, PROGRAM_NO_SHIFT), PROGRAM_RCL}    // RCL
+  };
+// KEYS WITH ONE FUNCTION IN CAL MODE BASE 10 - THESE RUN WITHOUT THE KEYPAD SWITCH
+static const Type_ProgramFunction ProgramFunction[] =
+  {
+  {PROGRAM_KEY_CODE(FALSE, 1, PROGRAM_NO_SHIFT),  call_tanX},
+  {PROGRAM_KEY_CODE(FALSE, 1, PROGRAM_L_SHIFT),   call_atanX},
+  {PROGRAM_KEY_CODE(FALSE, 2, PROGRAM_NO_SHIFT),  call_cosX},
+  {PROGRAM_KEY_CODE(FALSE, 2, PROGRAM_L_SHIFT),   call_acosX},
+  {PROGRAM_KEY_CODE(FALSE, 3, PROGRAM_NO_SHIFT),  call_eToX},
+  {PROGRAM_KEY_CODE(FALSE, 3, PROGRAM_L_SHIFT),   call_lnX},
+  {PROGRAM_KEY_CODE(FALSE, 4, PROGRAM_NO_SHIFT),  call_Xsqr},
+  {PROGRAM_KEY_CODE(FALSE, 4, PROGRAM_L_SHIFT),   call_sqrtX},
+  {PROGRAM_KEY_CODE(FALSE, 8, PROGRAM_NO_SHIFT),  call_OneOverX},
+  {PROGRAM_KEY_CODE(FALSE, 8, PROGRAM_L_SHIFT),   call_Xfactorial},
+  {PROGRAM_KEY_CODE(FALSE, 9, PROGRAM_NO_SHIFT),  call_XtoY},
+  {PROGRAM_KEY_CODE(FALSE, 9, PROGRAM_L_SHIFT),   call_3to2},
+  {PROGRAM_KEY_CODE(FALSE, 11, PROGRAM_NO_SHIFT), call_PtoR},
+  {PROGRAM_KEY_CODE(FALSE, 11, PROGRAM_L_SHIFT),  call_RtoP},
+  {PROGRAM_KEY_CODE(FALSE, 13, PROGRAM_NO_SHIFT), call_Drop},
+  {PROGRAM_KEY_CODE(FALSE, 16, PROGRAM_NO_SHIFT), call_sinX},
+  {PROGRAM_KEY_CODE(FALSE, 16, PROGRAM_L_SHIFT),  call_asinX},
+  {PROGRAM_KEY_CODE(FALSE, 17, PROGRAM_NO_SHIFT), call_10ToX},
+  {PROGRAM_KEY_CODE(FALSE, 17, PROGRAM_L_SHIFT),  call_logX},
+  {PROGRAM_KEY_CODE(FALSE, 21, PROGRAM_NO_SHIFT), call_YtoX},
+  {PROGRAM_KEY_CODE(FALSE, 21, PROGRAM_L_SHIFT),  call_YtoOneOverX},
+  {PROGRAM_KEY_CODE(FALSE, 23, PROGRAM_NO_SHIFT), call_StatAdd},
+  {PROGRAM_KEY_CODE(FALSE, 23, PROGRAM_L_SHIFT),  call_StatClear},
+  {PROGRAM_KEY_CODE(TRUE, 1, PROGRAM_NO_SHIFT),   call_Subtract},
+  {PROGRAM_KEY_CODE(TRUE, 2, PROGRAM_NO_SHIFT),   call_Add},
+  {PROGRAM_KEY_CODE(TRUE, 5, PROGRAM_NO_SHIFT),   call_Enter},
+  {PROGRAM_KEY_CODE(TRUE, 13, PROGRAM_NO_SHIFT),  call_Divide},
+  {PROGRAM_KEY_CODE(TRUE, 14, PROGRAM_NO_SHIFT),  call_Multiply},
+  {PROGRAM_KEY_CODE(TRUE, 16, PROGRAM_NO_SHIFT),  call_PiClick},
+  {PROGRAM_KEY_CODE(TRUE, 17, PROGRAM_L_SHIFT),   call_Mean},
+  {PROGRAM_KEY_CODE(TRUE, 17, PROGRAM_R_SHIFT),   call_StanDev},
+  {PROGRAM_KEY_CODE(TRUE, 18, PROGRAM_R_SHIFT),   call_abs}
+  };
+static const uint8_t ProgramOpName[PROGRAM_OP_LAST - PROGRAM_OP_FIRST][6] =
+  {
+  "LBL", "GTO", "GSB", "RTN", "TEST", "DSE", "ISG", "R/S", "STO", "RCL", "SOLVE", "INTEG", "BATCH"
+  };
+static const uint8_t ShiftName[3][3] = {"", " L", " R"};
+
+// EXTERN VARS
+extern CTL_EVENT_SET_t CalEvents;
+extern FRESULT FF_Result;
+extern CTL_MUTEX_t FatFsMutex;
+extern FIL FatFsFile;
+extern Type_CalSettings CalSettings;
+extern Type_Register RegisterValue[TOTAL_REGISTERS];
+extern Type_Numeric NumericValue;
+extern Type_NumEntry NumEntry;
+extern Type_STO_RCL STO_RCL;
+extern Type_MathErrorDisplay MathError;
+extern uint8_t str_InputLine[MAX_DISPLAY_LENGTH];
+extern BOOLEAN bln_LineLoaded,
+               bln_InputHasExp,
+               bln_DisplayHold;
+extern double LastX;
+extern uint32_t SystemCoreClock;
+
+// PROTOTYPES LOCAL
+static const Type_ProgramCell *call_ProgramExecute(const Type_ProgramCell *);
+static const Type_ProgramCell *call_ProgramDoLiteral(const Type_ProgramCell *);
+static const Type_ProgramCell *call_ProgramDoFunction(const Type_ProgramCell *);
+static const Type_ProgramCell *call_ProgramDoKey(const Type_ProgramCell *);
+static const Type_ProgramCell *call_ProgramDoGoTo(const Type_ProgramCell *);
+static const Type_ProgramCell *call_ProgramDoGoSub(const Type_ProgramCell *);
+static const Type_ProgramCell *call_ProgramDoReturn(const Type_ProgramCell *);
+static const Type_ProgramCell *call_ProgramDoTest(const Type_ProgramCell *);
+static const Type_ProgramCell *call_ProgramDoDSE(const Type_ProgramCell *);
+static const Type_ProgramCell *call_ProgramDoISG(const Type_ProgramCell *);
+static const Type_ProgramCell *call_ProgramDoStop(const Type_ProgramCell *);
+static const Type_ProgramCell *call_ProgramDoSTO(const Type_ProgramCell *);
+static const Type_ProgramCell *call_ProgramDoRCL(const Type_ProgramCell *);
+static BOOLEAN call_ProgramCompile(const uint8_t *, uint16_t, Type_ProgramCell *, uint16_t *);
+static void call_ProgramLiteralAdd(Type_ProgramLiteral *, uint8_t);
+static BOOLEAN call_ProgramLoopCount(uint8_t, BOOLEAN);
+static BOOLEAN call_ProgramEndEntry(void);
+static BOOLEAN call_ProgramReady(void);
+static void call_ProgramStart(const Type_ProgramCell *);
+static void call_ProgramPrefixDigit(uint8_t);
+static uint8_t call_ProgramStepLength(uint8_t);
+static void call_ProgramInsert(const uint8_t *, uint8_t);
+static void call_ProgramDelete(void);
+static void call_ProgramMnemonic(uint16_t, uint8_t *);
+static void call_ProgramShowEntry(void);
+static void call_ProgramShowPrompt(uint8_t);
+static void call_ProgramError(const uint8_t *);
+static void call_ProgramLoad(void);
+static BOOLEAN call_ProgramSave(void);
+// HANDLER OF EACH PROGRAM OPERATION - LBL COMPILES TO NO CELL, SOLVE / INTEGRATE / BATCH CANNOT BE IN A PROGRAM
+static const Type_ProgramHandler ProgramOpHandler[PROGRAM_OP_LAST - PROGRAM_OP_FIRST] =
+  {
+  NULL,                  call_ProgramDoGoTo,   call_ProgramDoGoSub,  call_ProgramDoReturn,
+  call_ProgramDoTest,    call_ProgramDoDSE,    call_ProgramDoISG,    call_ProgramDoStop,
+  call_ProgramDoSTO,     call_ProgramDoRCL,    NULL,                 NULL,
+  NULL
+  };
+
+
+
+
+/*************************************************************************
+ * Function Name: program_taskFn
+ * Parameters:    void *
+ * Return:        void
+ *
+ * Description: RTOS CTL task to run a keystroke program.  The task is the lowest priority
+ * of the calculator so the keypad, audio and clock run while a program does.  The event is
+ * set by call_ProgramStart after the program is compiled and the display held.  Any key
+ * sets Program.StopRequest (see call_ProgramKey).  The job is to run the program or to SOLVE /
+ * INTEGRATE / BATCH with the program function at a label.  A job can leave a report for line 1.
+ * A BATCH, and a program with SIGMA+ (a statistics run), use the FAST kernels for sin, cos, tan,
+ * e^x and ln - about 7 digits and a fraction of the time.  SOLVE, INTEGRATE, any other program and
+ * the keys are ACCURATE.
+ * STEP 1: Wait for the event, select the kernels and do the job
+ * STEP 2: Run: set where R/S continues from - the top if the program ended
+ * STEP 3: Back to the ACCURATE kernels.  Release the display and show the stack and report -
+ * unless an error is shown or a key of the program left CAL mode
+ * STEP 4: Clear the event
+ *************************************************************************/
+void program_taskFn(void *p)
+{
+
+ const Type_ProgramCell *Cell;
+
+ while (1)
+   {
+   ctl_events_wait(CTL_EVENT_WAIT_ANY_EVENTS, &CalEvents, (EVENT_PROGRAM), CTL_TIMEOUT_NONE, 0);
+
+   // STEP 1
+   Program.Report[0] = NULL_VALUE;
+   if ((Program.Job == PROGRAM_JOB_BATCH) || ((Program.Job == PROGRAM_JOB_RUN) && (Program.Statistics)))
+     CalSettings.KernelMode = KERNEL_FAST;
+   if (Program.Job != PROGRAM_JOB_RUN)
+     {
+     if (Program.Job == PROGRAM_JOB_SOLVE)
+       call_SolveRoot(Program.JobLabel);
+     else if (Program.Job == PROGRAM_JOB_INTEGRATE)
+       call_IntegrateRun(Program.JobLabel);
+     else
+       call_BatchRun(Program.JobLabel);
+     Program.ReturnDepth = 0;
+     }
+   else
+     {
+     Cell = call_ProgramExecute(Program.Next);
+
+     // STEP 2
+     if (Cell == NULL)
+       {
+       Cell = ProgramCell;
+       Program.ReturnDepth = 0;
+       }
+     Program.Next = Cell;
+     }
+
+   // STEP 3
+   CalSettings.KernelMode = KERNEL_ACCURATE;
+   bln_DisplayHold = FALSE;
+   CalSettings.L_Shift = CalSettings.R_Shift = FALSE;
+   DIP204_ICON_set(ICON_LEFT_ARROW, ICON_OFF);
+   DIP204_ICON_set(ICON_RIGHT_ARROW, ICON_OFF);
+   if ((CalSettings.CalError == NO_ERROR) && (CalSettings.CalMode == CAL_MODE) && (call_ProgramEndEntry()))
+     {
+     call_FormatNumber();
+     if (Program.Report[0] != NULL_VALUE)
+       {
+       DIP204_clearLine(1);
+       DIP204_txt_engine(Program.Report, 1, 0, strlen(Program.Report));
+       }
+     }
+   Program.Job = PROGRAM_JOB_RUN;
+   Program.StopRequest = FALSE;
+   Program.Running = FALSE;
+
+   // STEP 4
+   ctl_events_set_clear(&CalEvents, 0, (EVENT_PROGRAM));
+   }
+
+} // END OF program_taskFn
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramKey
+ * Parameters: uint32_t
+ * Return: BOOLEAN
+ *
+ * Description: Called by the click task for every key that passed the filter.  Returns TRUE
+ * if the key was taken here and is not to go to the keypad switch.
+ * Running: any key stops the program.
+ * Prefix (GTO, STO...) waiting: the key is one of its digits.
+ * Program entry: the key is recorded as a step.  The shift keys still go to the keypad - the
+ * shift is part of the code of the next key.  P/R and ATN leave program entry, backspace deletes
+ * the step before the entry point and the program operation keys start their prefix.
+ * STEP 1: Running or not taken
+ * STEP 2: The key and shift to a keystroke code
+ * STEP 3: Digit of a prefix
+ * STEP 4: Program entry keys that are not recorded
+ * STEP 5: Record the key
+ *************************************************************************/
+ BOOLEAN call_ProgramKey(uint32_t Key)
+ {
+
+ uint8_t Bit = 0,
+         Shift = PROGRAM_NO_SHIFT,
+         Code;
+ BOOLEAN ChannelB;
+
+ // STEP 1
+ if (Program.Running)
+   {
+   Program.StopRequest = TRUE;
+   return(TRUE);
+   }
+ if ((!Program.Entry) && (!Program.Prefix))
+   return(FALSE);
+
+ // STEP 2
+ ChannelB = ((Key & MASK_B_TOUCH_DATA) != 0);
+ while ((Bit < 23) && (!(Key & ((uint32_t)1 << Bit))))
+   Bit++;
+
+ // STEP 3
+ if (Program.Prefix)
+   {
+   if ((ChannelB) && (ProgramLiteralChar[1][Bit] >= '0') && (ProgramLiteralChar[1][Bit] <= '9'))
+     call_ProgramPrefixDigit(ProgramLiteralChar[1][Bit] - '0');
+   return(TRUE);
+   }
+ if ((!ChannelB) && ((Key == MASK_KEY_LSHIFT) || (Key == MASK_KEY_RSHIFT)))
+   return(FALSE);
+ if (CalSettings.L_Shift)
+   {
+   Shift = PROGRAM_L_SHIFT;
+   call_LShiftClick();
+   }
+ if (CalSettings.R_Shift)
+   {
+   Shift = PROGRAM_R_SHIFT;
+   call_RShiftClick();
+   }
+ Code = PROGRAM_KEY_CODE(ChannelB, Bit, Shift);
+
+ // STEP 4
+ if ((Code == PROGRAM_KEY_PR) || ((Code & ~PROGRAM_SHIFT_MASK) == PROGRAM_KEY_ATN))
+   {
+   call_ProgramEntryMode();
+   return(TRUE);
+   }
+ if (Code == PROGRAM_KEY_BACKSPACE)
+   {
+   call_ProgramDelete();
+   call_ProgramShowEntry();
+   return(TRUE);
+   }
+ for (uint8_t Index = 0; Index < (sizeof(ProgramKeyOperation) / sizeof(ProgramKeyOperation[0])); Index++)
+   {
+   if (Code != ProgramKeyOperation[Index][0])
+     continue;
+   Code = ProgramKeyOperation[Index][1];
+   if (call_ProgramStepLength(Code) == 1)
+     {
+     call_ProgramInsert(&Code, 1);
+     call_ProgramShowEntry();
+     }
+   else
+     call_ProgramPrefix(Code);
+   return(TRUE);
+   }
+
+ // STEP 5
+ call_ProgramInsert(&Code, 1);
+ call_ProgramShowEntry();
+ return(TRUE);
+
+ } // END OF call_ProgramKey
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramEntryMode
+ * Parameters: void
+ * Return: void
+ *
+ * Description: P/R - toggles program entry.  Entering: a number being keyed is first entered,
+ * the program is read from the SD card the first time and the entry point is the end of the
+ * program.  Leaving: the program is written to the SD card if it was changed.
+ * STEP 1: Leave program entry - save and show the stack
+ * STEP 2: Enter program entry - only from CAL mode without an error
+ *************************************************************************/
+ void call_ProgramEntryMode(void)
+ {
+
+ uint8_t LineText[MAX_DISPLAY_LENGTH];
+
+ // STEP 1
+ if (Program.Entry)
+   {
+   Program.Entry = FALSE;
+   Program.Prefix = 0;
+   select_All_Normal_Keys();
+   call_FormatNumber();
+   if ((Program.Changed) && (!call_ProgramSave()))
+     {
+     //                  01234567890123456789
+     sprintf(LineText, "PROGRAM NOT SAVED");
+     DIP204_clearLine(1);
+     DIP204_txt_engine(LineText, 1, 0, strlen(LineText));
+     }
+   return;
+   }
+
+ // STEP 2
+ if ((Program.Running) || (CalSettings.CalMode != CAL_MODE) || (CalSettings.CalError != NO_ERROR))
+   return;
+ if (!call_ProgramEndEntry())
+   return;
+ if (!Program.Loaded)
+   call_ProgramLoad();
+ Program.Entry = TRUE;
+ Program.EntryPoint = Program.Length;
+ call_ProgramShowEntry();
+
+ } // END OF call_ProgramEntryMode
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramPrefix
+ * Parameters: uint8_t
+ * Return: void
+ *
+ * Description: Starts a program operation that needs digits: LBL, GTO, GSB, TEST, DSE, ISG,
+ * SOLVE, INTEGRATE and BATCH take one, STO and RCL take two.  As STO and RCL of the keypad, only the
+ * digit keys are enabled until the digits are in (see call_ProgramPrefixDigit).  Outside of
+ * program entry only GTO, GSB, SOLVE, INTEGRATE and BATCH are used - a number being keyed is first entered.
+ * STEP 1: Set the prefix
+ * STEP 2: Mask the keys and prompt for the digits
+ *************************************************************************/
+ void call_ProgramPrefix(uint8_t Operation)
+ {
+
+ // STEP 1
+ if (!Program.Entry)
+   {
+   if ((Program.Running) || (CalSettings.CalMode != CAL_MODE) || (CalSettings.CalError != NO_ERROR))
+     return;
+   if (!call_ProgramEndEntry())
+     return;
+   }
+ Program.Prefix = Operation;
+ Program.Operand = 0;
+ Program.PrefixDigits = call_ProgramStepLength(Operation) - 1;
+ if ((Operation == PROGRAM_STO) || (Operation == PROGRAM_RCL))
+   Program.PrefixDigits = 2;
+
+ // STEP 2
+ CalSettings.Mask_KeyTouchA = CalSettings.Mask_KeyTouchB = NO_KEYS_SELECTED;
+ CalSettings.Mask_KeyTouchB = MASK_0TO9_ONLY;
+ if (Program.Entry)
+   call_ProgramShowEntry();
+ else
+   call_ProgramShowPrompt(4);
+
+ } // END OF call_ProgramPrefix
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramRunStop
+ * Parameters: void
+ * Return: void
+ *
+ * Description: R/S - runs the program from where it last stopped (the top after it ends,
+ * after it was edited or after RTN).  A number being keyed is left on the input line - it is
+ * the X the program starts with, as it would be for a key.  Stop is any key while running.
+ * STEP 1: Check the calculator can run a program
+ * STEP 2: Compile if needed and start the program task
+ *************************************************************************/
+ void call_ProgramRunStop(void)
+ {
+
+ // STEP 1
+ if ((Program.Running) || (CalSettings.CalMode != CAL_MODE) || (CalSettings.CalError != NO_ERROR))
+   return;
+
+ // STEP 2
+ if (!call_ProgramReady())
+   return;
+ call_ProgramStart(Program.Next);
+
+ } // END OF call_ProgramRunStop
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramReturn
+ * Parameters: void
+ * Return: void
+ *
+ * Description: RTN from the keypad - the next R/S runs from the top of the program and any
+ * pending subroutine returns are dropped.
+ * STEP 1: Program counter to the top
+ *************************************************************************/
+ void call_ProgramReturn(void)
+ {
+
+ // STEP 1
+ Program.Next = ProgramCell;
+ Program.ReturnDepth = 0;
+
+ } // END OF call_ProgramReturn
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramBenchmark
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Times the interpreter.  A fixed loop is compiled to its own cells and run
+ * PROGRAM_BENCH_LOOPS times with the display held:
+ * LBL 0, SQRT(x), x<>y, DSE 0, GTO 0, RTN
+ * The steps per second, CPU cycles per step (DWT cycle counter) and the speed as a multiple of
+ * keying the same steps by hand (PROGRAM_KEYS_PER_SECOND) are shown until the next key.
+ * NOTE: The stack, STO RCL location 0, the return stack of a stopped program and the keystroke
+ * program are not changed - they are restored if the loop does not compile as well
+ * STEP 1: Save what the loop uses and set up X, Y and the loop counter
+ * STEP 2: Compile and run the loop
+ * STEP 3: Restore
+ * STEP 4: Display
+ *************************************************************************/
+ void call_ProgramBenchmark(void)
+ {
+
+ static const uint8_t BenchCode[] =
+   {
+   PROGRAM_LBL, 0,
+   PROGRAM_KEY_CODE(FALSE, 4, PROGRAM_L_SHIFT),
+   PROGRAM_KEY_CODE(FALSE, 9, PROGRAM_NO_SHIFT),
+   PROGRAM_DSE, 0,
+   PROGRAM_GTO, 0,
+   PROGRAM_RTN
+   };
+ // STATIC - THE CLICK TASK STACK IS SMALL
+ static Type_ProgramCell BenchCell[sizeof(BenchCode) + 2];
+ static Type_Register SavedRegister[TOTAL_REGISTERS];
+ static const Type_ProgramCell *SavedReturn[PROGRAM_RETURN_DEPTH];
+ uint16_t BenchLabel[PROGRAM_LABELS];
+ double SavedLocation,
+        SavedLastX;
+ BOOLEAN SavedLoaded,
+         Compiled;
+ uint8_t SavedDepth;
+ uint32_t StartCount,
+          Cycles,
+          CyclesPerStep;
+ uint8_t LineText[MAX_DISPLAY_LENGTH + 1];
+
+ // STEP 1
+ if (Program.Running)
+   return;
+ memcpy(SavedRegister, RegisterValue, sizeof(SavedRegister));
+ SavedLocation = STO_RCL.StoredValue[0];
+ SavedLastX = LastX;
+ SavedLoaded = bln_LineLoaded;
+ memcpy(SavedReturn, Program.ReturnStack, sizeof(SavedReturn));
+ SavedDepth = Program.ReturnDepth;
+ RegisterValue[0].NumericValue = RegisterValue[1].NumericValue = 2.0;
+ STO_RCL.StoredValue[0] = PROGRAM_BENCH_LOOPS;
+ bln_LineLoaded = TRUE;
+ Program.ReturnDepth = 0;
+
+ // STEP 2
+ Compiled = call_ProgramCompile(BenchCode, sizeof(BenchCode), BenchCell, BenchLabel);
+ if (Compiled)
+   {
+   bln_DisplayHold = TRUE;
+   Program.StopRequest = FALSE;
+   Program.StepsRun = 0;
+   init_CycleCounter();
+   StartCount = CYCLE_COUNT;
+   call_ProgramExecute(BenchCell);
+   Cycles = CYCLE_COUNT - StartCount;
+   bln_DisplayHold = FALSE;
+   }
+
+ // STEP 3
+ memcpy(RegisterValue, SavedRegister, sizeof(SavedRegister));
+ STO_RCL.StoredValue[0] = SavedLocation;
+ LastX = SavedLastX;
+ bln_LineLoaded = SavedLoaded;
+ memcpy(Program.ReturnStack, SavedReturn, sizeof(SavedReturn));
+ Program.ReturnDepth = SavedDepth;
+ if (!Compiled)
+   return;
+
+ // STEP 4
+ CyclesPerStep = Cycles / (Program.StepsRun ? Program.StepsRun : 1);
+ if (!CyclesPerStep)
+   CyclesPerStep = 1;
+ DIP204_set_cursor(CURSOR_OFF);
+ DIP204_clearDisplay();
+ //                  01234567890123456789
+ sprintf(LineText, "PROGRAM %lu STEPS", Program.StepsRun);
+ DIP204_txt_engine(LineText, 1, 0, strlen(LineText));
+ sprintf(LineText, "STEP/S:   %lu", SystemCoreClock / CyclesPerStep);
+ DIP204_txt_engine(LineText, 2, 0, strlen(LineText));
+ sprintf(LineText, "CYC/STEP: %lu", CyclesPerStep);
+ DIP204_txt_engine(LineText, 3, 0, strlen(LineText));
+ sprintf(LineText, "X KEYPAD: %lu", (SystemCoreClock / CyclesPerStep) / PROGRAM_KEYS_PER_SECOND);
+ DIP204_txt_engine(LineText, 4, 0, strlen(LineText));
+
+ } // END OF call_ProgramBenchmark
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramEvaluate
+ * Parameters: uint8_t, double, double *
+ * Return: BOOLEAN
+ *
+ * Description: Evaluates the program function at LBL n for the x passed, as the HP-15C: the
+ * stack is filled with x and the subroutine runs to its RTN, f(x) is then X.  Called by SOLVE
+ * from the program task - the program is compiled and the display held.  Returns FALSE if the
+ * function stopped (key, R/S step) or had an error.
+ * STEP 1: Fill the stack with x
+ * STEP 2: Run the subroutine
+ * STEP 3: Return f(x)
+ *************************************************************************/
+ BOOLEAN call_ProgramEvaluate(uint8_t Label, double X, double *Fx)
+ {
+
+ // STEP 1
+ for (uint8_t RegCount = 0; RegCount < TOTAL_REGISTERS; RegCount++)
+   RegisterValue[RegCount].NumericValue = X;
+
+ // STEP 2
+ if (!call_ProgramEvaluateStack(Label))
+   return(FALSE);
+
+ // STEP 3
+ *Fx = RegisterValue[0].NumericValue;
+ return(TRUE);
+
+ } // END OF call_ProgramEvaluate
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramEvaluateStack
+ * Parameters: uint8_t
+ * Return: BOOLEAN
+ *
+ * Description: Runs the subroutine at LBL n to its RTN on the stack as it is - the result is
+ * the stack it leaves.  Called from the program task (SOLVE, INTEGRATE, BATCH) - the program
+ * is compiled and the display held.  Returns FALSE if the function stopped (key, R/S step) or
+ * had an error - a label that is not in the program is the error No LBL n.
+ * STEP 1: The label must be in the program, then run the subroutine
+ * STEP 2: End a number the function was keying
+ *************************************************************************/
+ BOOLEAN call_ProgramEvaluateStack(uint8_t Label)
+ {
+
+ // STEP 1
+ if ((Label >= PROGRAM_LABELS) || (ProgramLabel[Label] == PROGRAM_NO_LABEL))
+   {
+   sprintf(MathError.ErrorDescription, "No LBL %u", Label);
+   call_ProgramError(MathError.ErrorDescription);
+   return(FALSE);
+   }
+ bln_LineLoaded = TRUE;
+ Program.ReturnDepth = 0;
+ Program.Evaluations++;
+ if (call_ProgramExecute(&ProgramCell[ProgramLabel[Label]]) != NULL)
+   return(FALSE);
+
+ // STEP 2
+ return(call_ProgramEndEntry());
+
+ } // END OF call_ProgramEvaluateStack
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramExecute
+ * Parameters: const Type_ProgramCell *
+ * Return: const Type_ProgramCell *
+ *
+ * Description: The inner interpreter.  Each handler returns the next cell so there is no
+ * decode - the loop is a load and an indirect call per step.  Runs until the end of the
+ * program (NULL), a stop request (R/S step or a key) or an error.
+ * Returns the cell to continue from: on an error the step that failed, so R/S runs it again
+ * once the error is cleared.
+ * STEP 1: Run cell to cell
+ *************************************************************************/
+ static const Type_ProgramCell *call_ProgramExecute(const Type_ProgramCell *Cell)
+ {
+
+ const Type_ProgramCell *Previous;
+
+ // STEP 1
+ while ((Cell != NULL) && (!Program.StopRequest))
+   {
+   Previous = Cell;
+   Cell = Cell->Handler(Cell);
+   Program.StepsRun++;
+   // AN ERROR, OR A KEY THAT LEFT CAL MODE, STOPS ON THE STEP
+   if ((CalSettings.CalError != NO_ERROR) || (CalSettings.CalMode != CAL_MODE))
+     return(Previous);
+   }
+ return(Cell);
+
+ } // END OF call_ProgramExecute
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramDoLiteral
+ * Parameters: const Type_ProgramCell *
+ * Return: const Type_ProgramCell *
+ *
+ * Description: A number of the program.  It is placed on the input line unloaded, exactly as
+ * if keyed, with the entry parse that was built when compiled.  A number still on the input
+ * line is entered first.
+ * STEP 1: Enter a number being keyed
+ * STEP 2: Load the input line and its parse
+ *************************************************************************/
+ static const Type_ProgramCell *call_ProgramDoLiteral(const Type_ProgramCell *Cell)
+ {
+
+ const Type_ProgramLiteral *Literal = &ProgramLiteral[Cell->Operand.Literal];
+
+ // STEP 1
+ if (!call_ProgramEndEntry())
+   return(Cell);
+
+ // STEP 2
+ strcpy(str_InputLine, Literal->Text);
+ NumEntry = Literal->Entry;
+ bln_InputHasExp = Literal->HasExp;
+ bln_LineLoaded = FALSE;
+ return(Cell + 1);
+
+ } // END OF call_ProgramDoLiteral
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramDoFunction
+ * Parameters: const Type_ProgramCell *
+ * Return: const Type_ProgramCell *
+ *
+ * Description: A key compiled to a direct call.  The function is the one the keypad calls in
+ * base 10 - in base 16 the key goes through the keypad switch as any other key.
+ * STEP 1: Call the function
+ *************************************************************************/
+ static const Type_ProgramCell *call_ProgramDoFunction(const Type_ProgramCell *Cell)
+ {
+
+ // STEP 1
+ if (CalSettings.CalBase != BASE_10)
+   return(call_ProgramDoKey(Cell));
+ Cell->Operand.Function();
+ return(Cell + 1);
+
+ } // END OF call_ProgramDoFunction
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramDoKey
+ * Parameters: const Type_ProgramCell *
+ * Return: const Type_ProgramCell *
+ *
+ * Description: Any other key - the shift of the step is set and the key goes to the keypad
+ * switch of its channel.  The shift is always cleared after.
+ * STEP 1: Set the shift and call the key
+ *************************************************************************/
+ static const Type_ProgramCell *call_ProgramDoKey(const Type_ProgramCell *Cell)
+ {
+
+ uint32_t Key = (uint32_t)1 << ((Cell->Code >> PROGRAM_KEY_POSITION) & PROGRAM_KEY_MASK);
+
+ // STEP 1
+ CalSettings.L_Shift = ((Cell->Code & PROGRAM_SHIFT_MASK) == PROGRAM_L_SHIFT);
+ CalSettings.R_Shift = ((Cell->Code & PROGRAM_SHIFT_MASK) == PROGRAM_R_SHIFT);
+ if (Cell->Code & PROGRAM_CHANNEL_B)
+   select_key_functionB(Key);
+ else
+   select_key_functionA(Key);
+ CalSettings.L_Shift = CalSettings.R_Shift = FALSE;
+ return(Cell + 1);
+
+ } // END OF call_ProgramDoKey
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramDoGoTo
+ * Parameters: const Type_ProgramCell *
+ * Return: const Type_ProgramCell *
+ *
+ * Description: GTO n - the label was resolved to its cell when compiled
+ * STEP 1: Jump
+ *************************************************************************/
+ static const Type_ProgramCell *call_ProgramDoGoTo(const Type_ProgramCell *Cell)
+ {
+
+ // STEP 1
+ return(Cell->Operand.Target);
+
+ } // END OF call_ProgramDoGoTo
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramDoGoSub
+ * Parameters: const Type_ProgramCell *
+ * Return: const Type_ProgramCell *
+ *
+ * Description: GSB n - the cell after is pushed on the return stack (PROGRAM_RETURN_DEPTH
+ * levels) and the label was resolved to its cell when compiled
+ * STEP 1: Check the depth - error if full
+ * STEP 2: Push the return and jump
+ *************************************************************************/
+ static const Type_ProgramCell *call_ProgramDoGoSub(const Type_ProgramCell *Cell)
+ {
+
+ // STEP 1
+ if (Program.ReturnDepth == PROGRAM_RETURN_DEPTH)
+   {
+   //                 01234567890123456789
+   call_ProgramError("GSB too deep");
+   return(Cell);
+   }
+
+ // STEP 2
+ Program.ReturnStack[Program.ReturnDepth++] = Cell + 1;
+ return(Cell->Operand.Target);
+
+ } // END OF call_ProgramDoGoSub
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramDoReturn
+ * Parameters: const Type_ProgramCell *
+ * Return: const Type_ProgramCell *
+ *
+ * Description: RTN - and the end of program memory.  Returns to the step after the GSB, or
+ * ends the program if there is no GSB to return to.
+ * STEP 1: Pop the return stack
+ *************************************************************************/
+ static const Type_ProgramCell *call_ProgramDoReturn(const Type_ProgramCell *Cell)
+ {
+
+ // STEP 1
+ if (Program.ReturnDepth)
+   return(Program.ReturnStack[--Program.ReturnDepth]);
+ return(NULL);
+
+ } // END OF call_ProgramDoReturn
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramDoTest
+ * Parameters: const Type_ProgramCell *
+ * Return: const Type_ProgramCell *
+ *
+ * Description: TEST n (see enum PROGRAM_TEST_CONDITION) - do the next step if true, skip it
+ * if false.  A number being keyed is entered first.
+ * STEP 1: Enter a number being keyed
+ * STEP 2: Test X (and Y)
+ *************************************************************************/
+ static const Type_ProgramCell *call_ProgramDoTest(const Type_ProgramCell *Cell)
+ {
+
+ double X,
+        Y;
+ BOOLEAN TestTrue;
+
+ // STEP 1
+ if (!call_ProgramEndEntry())
+   return(Cell);
+ X = RegisterValue[0].NumericValue;
+ Y = RegisterValue[1].NumericValue;
+
+ // STEP 2
+ switch(Cell->Code)
+   {
+   case TEST_X_NE_0:
+     TestTrue = (X != 0.0);
+   break;
+
+   case TEST_X_GT_0:
+     TestTrue = (X > 0.0);
+   break;
+
+   case TEST_X_LT_0:
+     TestTrue = (X < 0.0);
+   break;
+
+   case TEST_X_GE_0:
+     TestTrue = (X >= 0.0);
+   break;
+
+   case TEST_X_LE_0:
+     TestTrue = (X <= 0.0);
+   break;
+
+   case TEST_X_EQ_Y:
+     TestTrue = (X == Y);
+   break;
+
+   case TEST_X_NE_Y:
+     TestTrue = (X != Y);
+   break;
+
+   case TEST_X_GT_Y:
+     TestTrue = (X > Y);
+   break;
+
+   case TEST_X_LT_Y:
+     TestTrue = (X < Y);
+   break;
+
+   default:
+   case TEST_X_GE_Y:
+     TestTrue = (X >= Y);
+   break;
+   }
+ return(TestTrue ? (Cell + 1) : (Cell + 2));
+
+ } // END OF call_ProgramDoTest
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramDoDSE
+ * Parameters: const Type_ProgramCell *
+ * Return: const Type_ProgramCell *
+ *
+ * Description: DSE n - decrement the loop counter of location n, skip the next step if it is
+ * then at or below its limit (see call_ProgramLoopCount)
+ * STEP 1: Count and skip
+ *************************************************************************/
+ static const Type_ProgramCell *call_ProgramDoDSE(const Type_ProgramCell *Cell)
+ {
+
+ // STEP 1
+ return(call_ProgramLoopCount(Cell->Code, TRUE) ? (Cell + 2) : (Cell + 1));
+
+ } // END OF call_ProgramDoDSE
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramDoISG
+ * Parameters: const Type_ProgramCell *
+ * Return: const Type_ProgramCell *
+ *
+ * Description: ISG n - increment the loop counter of location n, skip the next step if it is
+ * then above its limit (see call_ProgramLoopCount)
+ * STEP 1: Count and skip
+ *************************************************************************/
+ static const Type_ProgramCell *call_ProgramDoISG(const Type_ProgramCell *Cell)
+ {
+
+ // STEP 1
+ return(call_ProgramLoopCount(Cell->Code, FALSE) ? (Cell + 2) : (Cell + 1));
+
+ } // END OF call_ProgramDoISG
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramDoStop
+ * Parameters: const Type_ProgramCell *
+ * Return: const Type_ProgramCell *
+ *
+ * Description: R/S as a step - stops the program.  The next R/S continues after it.
+ * STEP 1: Request the stop
+ *************************************************************************/
+ static const Type_ProgramCell *call_ProgramDoStop(const Type_ProgramCell *Cell)
+ {
+
+ // STEP 1
+ Program.StopRequest = TRUE;
+ return(Cell + 1);
+
+ } // END OF call_ProgramDoStop
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramDoSTO
+ * Parameters: const Type_ProgramCell *
+ * Return: const Type_ProgramCell *
+ *
+ * Description: STO nn - as call_PerformSTO.  A number being keyed is entered first.
+ * STEP 1: Enter a number being keyed and store X
+ *************************************************************************/
+ static const Type_ProgramCell *call_ProgramDoSTO(const Type_ProgramCell *Cell)
+ {
+
+ // STEP 1
+ if (!call_ProgramEndEntry())
+   return(Cell);
+ STO_RCL.StoredValue[Cell->Code] = RegisterValue[0].NumericValue;
+ return(Cell + 1);
+
+ } // END OF call_ProgramDoSTO
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramDoRCL
+ * Parameters: const Type_ProgramCell *
+ * Return: const Type_ProgramCell *
+ *
+ * Description: RCL nn - as call_PerformRCL the value is pushed on the stack.  A number being
+ * keyed is entered first.
+ * STEP 1: Enter a number being keyed and push the location
+ *************************************************************************/
+ static const Type_ProgramCell *call_ProgramDoRCL(const Type_ProgramCell *Cell)
+ {
+
+ // STEP 1
+ if (!call_ProgramEndEntry())
+   return(Cell);
+ bln_LineLoaded = FALSE;
+ call_ProcessStackUp(STO_RCL.StoredValue[Cell->Code]);
+ return(Cell + 1);
+
+ } // END OF call_ProgramDoRCL
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramCompile
+ * Parameters: const uint8_t *, uint16_t, Type_ProgramCell *, uint16_t *
+ * Return: BOOLEAN
+ *
+ * Description: Compiles keystroke byte code to cells - one cell per step, but a run of number
+ * keys (digits, A-F, ., EEX and CHS within the number) is one literal cell with its text and
+ * entry parse built here.  LBL is no cell: the label is the cell that follows it.  The end of
+ * the code is two RTN cells so a skip of the last step also lands on a RTN.  The cells must hold
+ * Length + 2.  Labels holds PROGRAM_LABELS.  Shows the error and returns FALSE if a GTO / GSB
+ * has no label, an operand is out of range or there are too many numbers.
+ * NOTE: The entry parse of the input line (NumEntry) is used to build literals and is restored
+ * STEP 1: Clear the labels
+ * STEP 2: Compile step by step
+ * STEP 3: End the last literal and add the end cells
+ * STEP 4: Resolve GTO and GSB to their cells
+ *************************************************************************/
+ static BOOLEAN call_ProgramCompile(const uint8_t *Code, uint16_t Length, Type_ProgramCell *Cell, uint16_t *Label)
+ {
+
+ Type_NumEntry SavedEntry = NumEntry;
+ Type_ProgramLiteral *Literal = NULL;
+ uint16_t Offset = 0,
+          CellCount = 0,
+          LiteralCount = 0;
+ uint8_t Byte,
+         Key,
+         Operand = 0,
+         Limit;
+ BOOLEAN ChannelB;
+
+ // STEP 1
+ for (uint8_t Index = 0; Index < PROGRAM_LABELS; Index++)
+   Label[Index] = PROGRAM_NO_LABEL;
+
+ // STEP 2
+ while (Offset < Length)
+   {
+   Byte = Code[Offset];
+   ChannelB = ((Byte & PROGRAM_CHANNEL_B) != 0);
+   Key = (Byte >> PROGRAM_KEY_POSITION) & PROGRAM_KEY_MASK;
+   // NUMBER ENTRY KEYS ARE GATHERED TO ONE LITERAL - CHS ONLY WITHIN A NUMBER
+   if ((!(Byte & PROGRAM_SHIFT_MASK)) && (Key < 24) && (ProgramLiteralChar[ChannelB][Key]) &&
+       ((Literal != NULL) || (!ChannelB) || (Key != PROGRAM_KEY_B_CHS)))
+     {
+     if (Literal == NULL)
+       {
+       if (LiteralCount == PROGRAM_MAX_LITERALS)
+         {
+         NumEntry = SavedEntry;
+         //                 01234567890123456789
+         call_ProgramError("Too many numbers");
+         return(FALSE);
+         }
+       Literal = &ProgramLiteral[LiteralCount];
+       Literal->Text[0] = NULL_VALUE;
+       Literal->HasExp = FALSE;
+       Cell[CellCount].Handler = call_ProgramDoLiteral;
+       Cell[CellCount].Operand.Literal = LiteralCount++;
+       Cell[CellCount].Step = Offset;
+       CellCount++;
+       }
+     call_ProgramLiteralAdd(Literal, Byte);
+     Offset++;
+     continue;
+     }
+   // ANY OTHER STEP ENDS THE NUMBER
+   if (Literal != NULL)
+     {
+     call_NumEntryReload(Literal->Text, BASE_10);
+     Literal->Entry = NumEntry;
+     Literal = NULL;
+     }
+   // PROGRAM OPERATIONS
+   if ((Byte >= PROGRAM_OP_FIRST) && (Byte < PROGRAM_OP_LAST))
+     {
+     if (call_ProgramStepLength(Byte) == 2)
+       {
+       if ((Offset + 1) >= Length)
+         break;
+       Operand = Code[Offset + 1];
+       Limit = ((Byte == PROGRAM_STO) || (Byte == PROGRAM_RCL)) ? STO_RCL_LOCATIONS : PROGRAM_LABELS;
+       if (Operand >= Limit)
+         {
+         NumEntry = SavedEntry;
+         //                 01234567890123456789
+         call_ProgramError("Invalid step");
+         return(FALSE);
+         }
+       }
+     if (Byte == PROGRAM_LBL)
+       {
+       if (Label[Operand] == PROGRAM_NO_LABEL)
+         Label[Operand] = CellCount;
+       Offset += 2;
+       continue;
+       }
+     if (ProgramOpHandler[Byte - PROGRAM_OP_FIRST] == NULL)
+       {
+       NumEntry = SavedEntry;
+       //                 01234567890123456789
+       call_ProgramError("Invalid step");
+       return(FALSE);
+       }
+     Cell[CellCount].Handler = ProgramOpHandler[Byte - PROGRAM_OP_FIRST];
+     Cell[CellCount].Code = Operand;
+     }
+   // KEYS
+   else
+     {
+     Cell[CellCount].Handler = call_ProgramDoKey;
+     Cell[CellCount].Code = Byte;
+     for (uint8_t Index = 0; Index < (sizeof(ProgramFunction) / sizeof(ProgramFunction[0])); Index++)
+       {
+       if (ProgramFunction[Index].Code == Byte)
+         {
+         Cell[CellCount].Handler = call_ProgramDoFunction;
+         Cell[CellCount].Operand.Function = ProgramFunction[Index].Function;
+         break;
+         }
+       }
+     }
+   Cell[CellCount].Step = Offset;
+   CellCount++;
+   Offset += call_ProgramStepLength(Byte);
+   }
+
+ // STEP 3
+ if (Literal != NULL)
+   {
+   call_NumEntryReload(Literal->Text, BASE_10);
+   Literal->Entry = NumEntry;
+   }
+ NumEntry = SavedEntry;
+ for (uint8_t Index = 0; Index < 2; Index++)
+   {
+   Cell[CellCount + Index].Handler = call_ProgramDoReturn;
+   Cell[CellCount + Index].Step = Length;
+   }
+
+ // STEP 4
+ for (uint16_t Index = 0; Index < CellCount; Index++)
+   {
+   if ((Cell[Index].Handler != call_ProgramDoGoTo) && (Cell[Index].Handler != call_ProgramDoGoSub))
+     continue;
+   if (Label[Cell[Index].Code] == PROGRAM_NO_LABEL)
+     {
+     sprintf(MathError.ErrorDescription, "No LBL %u", Cell[Index].Code);
+     call_ProgramError(MathError.ErrorDescription);
+     return(FALSE);
+     }
+   Cell[Index].Operand.Target = &Cell[Label[Cell[Index].Code]];
+   }
+ return(TRUE);
+
+ } // END OF call_ProgramCompile
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramLiteralAdd
+ * Parameters: Type_ProgramLiteral *, uint8_t
+ * Return: void
+ *
+ * Description: Adds one number entry key to the text of a literal - the same text call_NumClick
+ * builds for the key: EEX adds "E+" ("1E+" if first), CHS changes the sign of the mantissa or,
+ * after EEX, of the exponent.
+ * STEP 1: EEX
+ * STEP 2: CHS
+ * STEP 3: Digit or decimal point
+ *************************************************************************/
+ static void call_ProgramLiteralAdd(Type_ProgramLiteral *Literal, uint8_t Byte)
+ {
+
+ BOOLEAN ChannelB = ((Byte & PROGRAM_CHANNEL_B) != 0);
+ uint8_t Key = (Byte >> PROGRAM_KEY_POSITION) & PROGRAM_KEY_MASK,
+         Length = strlen(Literal->Text);
+ uint8_t *Exponent;
+
+ // STEP 1
+ if ((ChannelB) && (Key == PROGRAM_KEY_B_EEX))
+   {
+   if ((Literal->HasExp) || (Length > (MAX_DISPLAY_LENGTH - 4)))
+     return;
+   strcat(Literal->Text, (Length ? "E+" : "1E+"));
+   Literal->HasExp = TRUE;
+   return;
+   }
+
+ // STEP 2
+ if ((ChannelB) && (Key == PROGRAM_KEY_B_CHS))
+   {
+   if (Literal->HasExp)
+     {
+     Exponent = strchr(Literal->Text, 'E') + 1;
+     *Exponent = (*Exponent == '+') ? '-' : '+';
+     }
+   else if (Literal->Text[0] == '-')
+     memmove(Literal->Text, Literal->Text + 1, Length);
+   else if (Length < (MAX_DISPLAY_LENGTH - 1))
+     {
+     memmove(Literal->Text + 1, Literal->Text, Length + 1);
+     Literal->Text[0] = '-';
+     }
+   return;
+   }
+
+ // STEP 3
+ if (Length < (MAX_DISPLAY_LENGTH - 1))
+   {
+   Literal->Text[Length] = ProgramLiteralChar[ChannelB][Key];
+   Literal->Text[Length + 1] = NULL_VALUE;
+   }
+
+ } // END OF call_ProgramLiteralAdd
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramLoopCount
+ * Parameters: uint8_t, BOOLEAN
+ * Return: BOOLEAN
+ *
+ * Description: DSE / ISG on STO RCL location 0-9.  The location holds the control number
+ * nnnnn.xxxyy as the HP-15C: nnnnn the count, xxx the limit, yy the step (0 is 1).  The count is
+ * stepped down (Decrement) or up and the location updated.  Returns TRUE if the next step is to
+ * be skipped: DSE count <= limit, ISG count > limit.
+ * STEP 1: Split the control number
+ * STEP 2: Step the count and rebuild the control number
+ *************************************************************************/
+ static BOOLEAN call_ProgramLoopCount(uint8_t Location, BOOLEAN Decrement)
+ {
+
+ double Value = STO_RCL.StoredValue[Location];
+ int32_t Count = (int32_t)Value;
+ uint32_t Control = (uint32_t)((fabs(Value - Count) * PROGRAM_LOOP_SCALE) + 0.5),
+          Limit = Control / PROGRAM_LOOP_STEP_DIV,
+          Step = Control % PROGRAM_LOOP_STEP_DIV;
+
+ // STEP 1
+ if (!Step)
+   Step = 1;
+
+ // STEP 2
+ Count = Decrement ? (Count - (int32_t)Step) : (Count + (int32_t)Step);
+ Value = fabs((double)Count) + (Control / PROGRAM_LOOP_SCALE);
+ STO_RCL.StoredValue[Location] = (Count < 0) ? -Value : Value;
+ if (Decrement)
+   return(Count <= (int32_t)Limit);
+ return(Count > (int32_t)Limit);
+
+ } // END OF call_ProgramLoopCount
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramEndEntry
+ * Parameters: void
+ * Return: BOOLEAN
+ *
+ * Description: A number being keyed (unloaded) is entered on the stack as the ENTER key.
+ * Returns FALSE if the number is not valid - the entry error is shown.
+ * STEP 1: Enter if unloaded
+ *************************************************************************/
+ static BOOLEAN call_ProgramEndEntry(void)
+ {
+
+ // STEP 1
+ if (!bln_LineLoaded)
+   call_Enter();
+ return(CalSettings.CalError == NO_ERROR);
+
+ } // END OF call_ProgramEndEntry
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramReady
+ * Parameters: void
+ * Return: BOOLEAN
+ *
+ * Description: Reads the program from the SD card the first time and compiles it if it was
+ * changed.  After a compile the program runs from the top.  Returns FALSE on a compile error.
+ * STEP 1: Load
+ * STEP 2: Compile
+ * STEP 3: A program with SIGMA+ is a statistics run - see program_taskFn
+ *************************************************************************/
+ static BOOLEAN call_ProgramReady(void)
+ {
+
+ // STEP 1
+ if (!Program.Loaded)
+   call_ProgramLoad();
+
+ // STEP 2
+ if (Program.Compiled)
+   return(TRUE);
+ if (!call_ProgramCompile(Program.Memory, Program.Length, ProgramCell, ProgramLabel))
+   return(FALSE);
+ Program.Compiled = TRUE;
+ Program.Next = ProgramCell;
+ Program.ReturnDepth = 0;
+
+ // STEP 3
+ Program.Statistics = FALSE;
+ for (uint16_t Index = 0; ProgramCell[Index].Step < Program.Length; Index++)
+   {
+   if ((ProgramCell[Index].Handler == call_ProgramDoFunction) && (ProgramCell[Index].Operand.Function == call_StatAdd))
+     Program.Statistics = TRUE;
+   }
+ return(TRUE);
+
+ } // END OF call_ProgramReady
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramStart
+ * Parameters: const Type_ProgramCell *
+ * Return: void
+ *
+ * Description: Starts the program task at the cell passed.  The display is held from here
+ * until the task stops: line 4 shows the program is running.
+ * STEP 1: Set the program running and hold the display
+ * STEP 2: Set the event
+ *************************************************************************/
+ static void call_ProgramStart(const Type_ProgramCell *Cell)
+ {
+
+ uint8_t LineText[MAX_DISPLAY_LENGTH];
+
+ // STEP 1
+ Program.Next = Cell;
+ Program.StepsRun = 0;
+ Program.StopRequest = FALSE;
+ Program.Running = TRUE;
+ bln_DisplayHold = TRUE;
+ DIP204_set_cursor(CURSOR_OFF);
+ DIP204_clearLine(4);
+ //                  01234567890123456789
+ sprintf(LineText, "      RUNNING");
+ DIP204_txt_engine(LineText, 4, 0, strlen(LineText));
+
+ // STEP 2
+ ctl_events_set_clear(&CalEvents, EVENT_PROGRAM, 0);
+
+ } // END OF call_ProgramStart
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramPrefixDigit
+ * Parameters: uint8_t
+ * Return: void
+ *
+ * Description: A digit of the prefix.  When all the digits are in: in program entry the step is
+ * recorded; otherwise GTO sets where R/S runs from, GSB runs the program from the label and
+ * SOLVE / INTEGRATE / BATCH start the root finder / integrator / CSV batch on the function at the
+ * label (see call_SolveRoot, call_IntegrateRun and call_BatchRun).
+ * STEP 1: Add the digit - prompt for the next if more are needed
+ * STEP 2: Clear the prefix and restore the keys
+ * STEP 3: Record the step or do GTO / GSB / SOLVE / INTEGRATE / BATCH
+ *************************************************************************/
+ static void call_ProgramPrefixDigit(uint8_t Digit)
+ {
+
+ uint8_t Step[2];
+
+ // STEP 1
+ Program.Operand = (Program.Operand * 10) + Digit;
+ if (--Program.PrefixDigits)
+   {
+   if (Program.Entry)
+     call_ProgramShowEntry();
+   else
+     call_ProgramShowPrompt(4);
+   return;
+   }
+
+ // STEP 2
+ Step[0] = Program.Prefix;
+ Step[1] = Program.Operand;
+ Program.Prefix = 0;
+ select_All_Normal_Keys();
+
+ // STEP 3
+ if (Program.Entry)
+   {
+   call_ProgramInsert(Step, 2);
+   call_ProgramShowEntry();
+   return;
+   }
+ call_FormatNumber();
+ if (!call_ProgramReady())
+   return;
+ if (ProgramLabel[Step[1]] == PROGRAM_NO_LABEL)
+   {
+   sprintf(MathError.ErrorDescription, "No LBL %u", Step[1]);
+   call_ProgramError(MathError.ErrorDescription);
+   return;
+   }
+ Program.ReturnDepth = 0;
+ if ((Step[0] == PROGRAM_SOLVE) || (Step[0] == PROGRAM_INTEGRATE) || (Step[0] == PROGRAM_BATCH))
+   {
+   if (Step[0] == PROGRAM_SOLVE)
+     Program.Job = PROGRAM_JOB_SOLVE;
+   else
+     Program.Job = (Step[0] == PROGRAM_INTEGRATE) ? PROGRAM_JOB_INTEGRATE : PROGRAM_JOB_BATCH;
+   Program.JobLabel = Step[1];
+   call_ProgramStart(Program.Next);
+   return;
+   }
+ Program.Next = &ProgramCell[ProgramLabel[Step[1]]];
+ if (Step[0] == PROGRAM_GSB)
+   call_ProgramStart(Program.Next);
+
+ } // END OF call_ProgramPrefixDigit
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramStepLength
+ * Parameters: uint8_t
+ * Return: uint8_t
+ *
+ * Description: Bytes of the step that starts with the byte passed - the program operations but
+ * RTN and R/S have an operand byte.
+ * STEP 1: Return the length
+ *************************************************************************/
+ static uint8_t call_ProgramStepLength(uint8_t Byte)
+ {
+
+ // STEP 1
+ if ((Byte >= PROGRAM_OP_FIRST) && (Byte < PROGRAM_OP_LAST) && (Byte != PROGRAM_RTN) && (Byte != PROGRAM_RS))
+   return(2);
+ return(1);
+
+ } // END OF call_ProgramStepLength
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramInsert
+ * Parameters: const uint8_t *, uint8_t
+ * Return: void
+ *
+ * Description: Inserts a step at the entry point and moves the entry point after it.  The
+ * program must be compiled again.  Nothing is done if program memory is full.
+ * STEP 1: Check for room
+ * STEP 2: Open a gap and insert
+ *************************************************************************/
+ static void call_ProgramInsert(const uint8_t *Step, uint8_t Count)
+ {
+
+ // STEP 1
+ if ((Program.Length + Count) > PROGRAM_MAX_STEPS)
+   return;
+
+ // STEP 2
+ memmove(&Program.Memory[Program.EntryPoint + Count], &Program.Memory[Program.EntryPoint], Program.Length - Program.EntryPoint);
+ memcpy(&Program.Memory[Program.EntryPoint], Step, Count);
+ Program.EntryPoint += Count;
+ Program.Length += Count;
+ Program.Changed = TRUE;
+ Program.Compiled = FALSE;
+
+ } // END OF call_ProgramInsert
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramDelete
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Deletes the step before the entry point.  The program must be compiled again.
+ * STEP 1: Find the start of the step before the entry point
+ * STEP 2: Close the gap
+ *************************************************************************/
+ static void call_ProgramDelete(void)
+ {
+
+ uint16_t Offset = 0,
+          Previous = 0;
+
+ // STEP 1
+ if (!Program.EntryPoint)
+   return;
+ while (Offset < Program.EntryPoint)
+   {
+   Previous = Offset;
+   Offset += call_ProgramStepLength(Program.Memory[Offset]);
+   }
+
+ // STEP 2
+ memmove(&Program.Memory[Previous], &Program.Memory[Program.EntryPoint], Program.Length - Program.EntryPoint);
+ Program.Length -= Program.EntryPoint - Previous;
+ Program.EntryPoint = Previous;
+ Program.Changed = TRUE;
+ Program.Compiled = FALSE;
+
+ } // END OF call_ProgramDelete
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramMnemonic
+ * Parameters: uint16_t, uint8_t *
+ * Return: void
+ *
+ * Description: Text of the step at the offset passed: the operation and its operand, or the
+ * text of the key (see call_ProgramKeyName).
+ * STEP 1: Program operation
+ * STEP 2: Key
+ *************************************************************************/
+ static void call_ProgramMnemonic(uint16_t Offset, uint8_t *Text)
+ {
+
+ uint8_t Byte = Program.Memory[Offset];
+
+ // STEP 1
+ if ((Byte >= PROGRAM_OP_FIRST) && (Byte < PROGRAM_OP_LAST))
+   {
+   if (call_ProgramStepLength(Byte) == 1)
+     sprintf(Text, "%s", ProgramOpName[Byte - PROGRAM_OP_FIRST]);
+   else if ((Byte == PROGRAM_STO) || (Byte == PROGRAM_RCL))
+     sprintf(Text, "%s %02u", ProgramOpName[Byte - PROGRAM_OP_FIRST], Program.Memory[Offset + 1]);
+   else
+     sprintf(Text, "%s %u", ProgramOpName[Byte - PROGRAM_OP_FIRST], Program.Memory[Offset + 1]);
+   return;
+   }
+
+ // STEP 2
+ call_ProgramKeyName(Byte, Text);
+
+ } // END OF call_ProgramMnemonic
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramKeyName
+ * Parameters: uint8_t, uint8_t *
+ * Return: void
+ *
+ * Description: Text of the keystroke code passed: the digit or char of a number entry key, or
+ * KEY with the channel, key number and shift.  Used by the program listing and the tape.
+ * STEP 1: Number entry key
+ * STEP 2: Any other key
+ *************************************************************************/
+ void call_ProgramKeyName(uint8_t Code, uint8_t *Text)
+ {
+
+ uint8_t Key = (Code >> PROGRAM_KEY_POSITION) & PROGRAM_KEY_MASK,
+         Shift = Code & PROGRAM_SHIFT_MASK;
+ BOOLEAN ChannelB = ((Code & PROGRAM_CHANNEL_B) != 0);
+
+ // STEP 1
+ if ((Shift == PROGRAM_NO_SHIFT) && (Key < 24) && (ProgramLiteralChar[ChannelB][Key]))
+   {
+   if ((ChannelB) && (Key == PROGRAM_KEY_B_EEX))
+     sprintf(Text, "EEX");
+   else if ((ChannelB) && (Key == PROGRAM_KEY_B_CHS))
+     sprintf(Text, "CHS");
+   else
+     sprintf(Text, "%c", ProgramLiteralChar[ChannelB][Key]);
+   return;
+   }
+
+ // STEP 2
+ sprintf(Text, "KEY %c%02u%s", (ChannelB ? 'B' : 'A'), Key, ShiftName[Shift]);
+
+ } // END OF call_ProgramKeyName
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramShowEntry
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Program entry display.  Line 1: free program memory.  Line 3: the step before
+ * the entry point, step 000 is the top of memory.  Line 4: the prefix waiting for its digits.
+ * PROGRAM  FREE 123
+ *
+ * 012- KEY A16 L
+ * GTO _
+ * STEP 1: Free memory
+ * STEP 2: Count the steps to the entry point and show the last
+ * STEP 3: Prefix
+ *************************************************************************/
+ static void call_ProgramShowEntry(void)
+ {
+
+ uint8_t LineText[MAX_DISPLAY_LENGTH + 1],
+         Mnemonic[MAX_DISPLAY_LENGTH];
+ uint16_t Offset = 0,
+          Previous = 0,
+          Step = 0;
+
+ // STEP 1
+ DIP204_set_cursor(CURSOR_OFF);
+ DIP204_clearDisplay();
+ //                  01234567890123456789
+ sprintf(LineText, "PROGRAM  FREE %u", (PROGRAM_MAX_STEPS - Program.Length));
+ DIP204_txt_engine(LineText, 1, 0, strlen(LineText));
+
+ // STEP 2
+ while (Offset < Program.EntryPoint)
+   {
+   Previous = Offset;
+   Offset += call_ProgramStepLength(Program.Memory[Offset]);
+   Step++;
+   }
+ Mnemonic[0] = NULL_VALUE;
+ if (Step)
+   call_ProgramMnemonic(Previous, Mnemonic);
+ sprintf(LineText, "%03u- %s", Step, Mnemonic);
+ DIP204_txt_engine(LineText, 3, 0, strlen(LineText));
+
+ // STEP 3
+ if (Program.Prefix)
+   call_ProgramShowPrompt(4);
+
+ } // END OF call_ProgramShowEntry
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramShowPrompt
+ * Parameters: uint8_t
+ * Return: void
+ *
+ * Description: Shows the prefix and the digits keyed so far on the line passed: "STO 1_"
+ * STEP 1: Build and show the prompt
+ *************************************************************************/
+ static void call_ProgramShowPrompt(uint8_t Line)
+ {
+
+ uint8_t LineText[MAX_DISPLAY_LENGTH];
+
+ // STEP 1
+ if (((Program.Prefix == PROGRAM_STO) || (Program.Prefix == PROGRAM_RCL)) && (Program.PrefixDigits == 1))
+   sprintf(LineText, "%s %u_", ProgramOpName[Program.Prefix - PROGRAM_OP_FIRST], Program.Operand);
+ else
+   sprintf(LineText, "%s _", ProgramOpName[Program.Prefix - PROGRAM_OP_FIRST]);
+ DIP204_clearLine(Line);
+ DIP204_txt_engine(LineText, Line, 0, strlen(LineText));
+
+ } // END OF call_ProgramShowPrompt
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramError
+ * Parameters: const uint8_t *
+ * Return: void
+ *
+ * Description: Shows a program error as a math error - ATN clears it
+ * STEP 1: Set the error text and show
+ *************************************************************************/
+ static void call_ProgramError(const uint8_t *Description)
+ {
+
+ // STEP 1
+ if (Description != MathError.ErrorDescription)
+   strcpy(MathError.ErrorDescription, Description);
+ //                                   01234567890123456789
+ strcpy(MathError.ErrorSolution,     "Check program");
+ strcpy(NumericValue.AudioErrorFileName, I_AND_I_ERROR_WAV);
+ NumericValue.AudioPlayLevel = BASIC_HELP;
+ call_ShowMathError();
+
+ } // END OF call_ProgramError
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramLoad
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Reads the keystroke program from the SD card.  The file is a marker byte, the
+ * length (2 bytes, LSB first) and the byte code.  No file, or a file that is not valid, is an
+ * empty program.  FatFsMutex is held from the open to the close.
+ * STEP 1: Open the file
+ * STEP 2: Read and check the header, read the byte code
+ *************************************************************************/
+ static void call_ProgramLoad(void)
+ {
+
+ uint8_t Header[3];
+ UINT BytesRead;
+
+ // STEP 1
+ Program.Loaded = TRUE;
+ Program.Length = 0;
+ Program.Compiled = FALSE;
+ ctl_mutex_lock(&FatFsMutex, CTL_TIMEOUT_NONE, 0);
+ FF_Result = f_open(&FatFsFile, PROGRAM_FILE_NAME, FA_OPEN_EXISTING | FA_READ);
+ if (FF_Result != FR_OK)
+   {
+   ctl_mutex_unlock(&FatFsMutex);
+   return;
+   }
+
+ // STEP 2
+ FF_Result = f_read(&FatFsFile, Header, sizeof(Header), &BytesRead);
+ if ((FF_Result == FR_OK) && (BytesRead == sizeof(Header)) && (Header[0] == PROGRAM_FILE_MARKER))
+   {
+   Program.Length = Header[1] | (Header[2] << 8);
+   if (Program.Length > PROGRAM_MAX_STEPS)
+     Program.Length = 0;
+   FF_Result = f_read(&FatFsFile, Program.Memory, Program.Length, &BytesRead);
+   if ((FF_Result != FR_OK) || (BytesRead != Program.Length))
+     Program.Length = 0;
+   }
+ f_close(&FatFsFile);
+ ctl_mutex_unlock(&FatFsMutex);
+
+ } // END OF call_ProgramLoad
+
+
+
+
+/*************************************************************************
+ * Function Name: call_ProgramSave
+ * Parameters: void
+ * Return: BOOLEAN
+ *
+ * Description: Writes the keystroke program to the SD card (see call_ProgramLoad for the
+ * file).  Returns FALSE if the file could not be written.  FatFsMutex is held from the open to
+ * the close.
+ * STEP 1: Create the file
+ * STEP 2: Write the header and the byte code
+ *************************************************************************/
+ static BOOLEAN call_ProgramSave(void)
+ {
+
+ uint8_t Header[3];
+ UINT BytesWritten,
+      HeaderWritten;
+ BOOLEAN Written;
+
+ // STEP 1
+ ctl_mutex_lock(&FatFsMutex, CTL_TIMEOUT_NONE, 0);
+ FF_Result = f_open(&FatFsFile, PROGRAM_FILE_NAME, FA_CREATE_ALWAYS | FA_WRITE);
+ if (FF_Result != FR_OK)
+   {
+   ctl_mutex_unlock(&FatFsMutex);
+   return(FALSE);
+   }
+
+ // STEP 2
+ Header[0] = PROGRAM_FILE_MARKER;
+ Header[1] = (uint8_t)(Program.Length & 0xFF);
+ Header[2] = (uint8_t)(Program.Length >> 8);
+ FF_Result = f_write(&FatFsFile, Header, sizeof(Header), &HeaderWritten);
+ if (FF_Result == FR_OK)
+   FF_Result = f_write(&FatFsFile, Program.Memory, Program.Length, &BytesWritten);
+ f_close(&FatFsFile);
+ Written = ((FF_Result == FR_OK) && (HeaderWritten == sizeof(Header)) && (BytesWritten == Program.Length));
+ ctl_mutex_unlock(&FatFsMutex);
+ if (!Written)
+   return(FALSE);
+ Program.Changed = FALSE;
+ return(TRUE);
+
+ } // END OF call_ProgramSave
@@ -5,7 +5,7 @@
                     related functions of the HC15C
  * Author:          Hab S. Collector`
  * Date:            3/5/12
- * LAST EDIT:       7/03/2012 
+ * LAST EDIT:       10/19/2026
  * Hardware:        NXP LPC1769
  * Firmware Tool:   CrossStudio for ARM
  * Notes:           This file should be written as to not be dependent on other includes.
@@ -30,6 +30,8 @@ extern CTL_EVENT_SET_t CalEvents;
 extern CTL_TASK_t clock_task;
 extern Type_CalSettings CalSettings;
 extern volatile uint8_t BackLightTimer;
+extern volatile uint8_t IdlePercent;
+extern volatile uint8_t WaitPercent;
 
 
 
@@ -46,7 +48,7 @@ extern volatile uint8_t BackLightTimer;
  * and sleep timeout.
  * NOTE: Back light and sleep time out are in 10's of seconds
  * STEP 1: Clear the previous results
- * STEP 2: Display the updated settings
+ * STEP 2: Display the updated settings and the CPU idle time
  * STEP 3: Clear the event
  *************************************************************************/
  void setup_taskFn(void *p)
@@ -73,6 +75,8 @@ extern volatile uint8_t BackLightTimer;
    DIP204_txt_engine(LineText, SETUP_CAL_TALK_ROW, SETUP_POSITION, strlen(LineText));
    sprintf(LineText, "%d", (CalSettings.Setup.TimeToSleep * 10));
    DIP204_txt_engine(LineText, SETUP_TIMEOUT_ROW, SETUP_POSITION, strlen(LineText));
+   sprintf(LineText, "IDLE%3u%% W%3u%%", IdlePercent, WaitPercent);
+   DIP204_txt_engine(LineText, 1, SETUP_IDLE_POSITION, strlen(LineText));
 
    // STEP 3
    ctl_events_set_clear(&CalEvents, 0, (EVENT_SETUP));    
@@ -92,7 +96,8 @@ extern volatile uint8_t BackLightTimer;
  * Description: Places the calculator in User Setup Mode.  Setup Mode displays 
  * three user options to change: BackLight Time Out time - the time it takes the 
  * the back light to time out.  Cal Verbose - the level of voice help the calcualtor
- * responds with.
+ * responds with.  The title row shows the CPU idle time of the last second (see idleSleep) and W,
+ * the time tasks slept in delayXms - the CPU the old busy wait took (see delayXms).
  * STEP 1: End the present mode, set up keys to use
  * STEP 2: Ready the display
  * STEP 3: Set for Setup Mode
@@ -116,8 +121,11 @@ extern volatile uint8_t BackLightTimer;
  // STEP 2
  DIP204_set_cursor(CURSOR_OFF);
  DIP204_clearDisplay();
- strcpy(LineText, "USER SETUP:");
+ //                01234567890123456789
+ strcpy(LineText, "SETUP");
  DIP204_txt_engine(LineText, 1, 0, strlen(LineText));
+ sprintf(LineText, "IDLE%3u%% W%3u%%", IdlePercent, WaitPercent);
+ DIP204_txt_engine(LineText, 1, SETUP_IDLE_POSITION, strlen(LineText));
  strcpy(LineText, "1.BL TIME OUT:");
  DIP204_txt_engine(LineText, SETUP_BL_ROW, 2, strlen(LineText));
  strcpy(LineText, "2.CAL VERBOSE:");
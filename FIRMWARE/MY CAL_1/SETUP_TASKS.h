@@ -21,6 +21,7 @@
 #define SETUP_CAL_TALK_ROW 3
 #define SETUP_TIMEOUT_ROW  4
 #define SETUP_POSITION     17
+#define SETUP_IDLE_POSITION 6       // CPU IDLE AND DELAY WAIT OF THE LAST SECOND - TITLE ROW
 
 // SETUP LIMITS (VALUE IN 10'S OF SECONDS)
 #define MAX_TIME_TO_SLEEP         20
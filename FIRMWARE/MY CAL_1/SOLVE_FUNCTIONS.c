@@ -0,0 +1,604 @@
+/*****************************************************************
+ *
+ * File name:       SOLVE_FUNCTIONS.C
+ * Description:     SOLVE and INTEGRATE - root finder and integrator of a keystroke program function of the HC15C
+ * Author:          Hab S. Collector
+ * Date:            10/19/2026
+ * LAST EDIT:       10/19/2026
+ * Hardware:        NXP LPC1769
+ * Firmware Tool:   CrossStudio for ARM
+ * Notes:           This file should be written as to not be dependent on other includes.
+ *                  everything these functions need should be passed to them.
+ *                  It will be necessary to consult the reference documents and associated schematics to understand
+ *                  the operations of this firmware.
+ *                  As the HP-15C: the function is a subroutine of the keystroke program at LBL n that takes x
+ *                  in X and leaves f(x) in X.  The two guesses are X and Y.  The root finder runs in the program
+ *                  task (lowest priority) so the keypad, audio and clock run while it does.  If the guesses do
+ *                  not bracket a root, secant steps search for a sign change - then Brent's method (inverse
+ *                  quadratic / secant with bisection as the fall back) closes on the root.
+ *                  INTEGRATE takes the limits from Y (lower) and X (upper) and is Romberg on a substitution
+ *                  that clusters the samples at the limits and never evaluates the limits themselves.  Each
+ *                  level halves the step so every evaluation of the levels before is reused.  The accuracy is
+ *                  set by the display format, as the HP-15C.
+ *****************************************************************/
+
+#include <ctl_api.h>
+#include "SOLVE_FUNCTIONS.H"
+#include "PROGRAM_TASKS.H"
+#include "CORE_FUNCTIONS.H"
+#include "MATH_FUNCTIONS.H"
+#include "DIP204.H"
+#include "AUDIO_TASKS.H"
+#include "lpc_types.h"
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+
+// GLOBAL VARS
+// TYPES
+typedef struct
+  {
+  double A, FA;                              // PREVIOUS ESTIMATE AND f(A)
+  double B, FB;                              // BEST ESTIMATE AND f(B)
+  uint16_t Iteration;
+  uint32_t StartTime;                        // ms - ctl_get_current_time
+  uint8_t Label;
+  uint8_t Result;                            // SEE enum SOLVE_RESULT
+  } Type_Solve;
+static Type_Solve Solve;
+
+// EXTERN VARS
+extern Type_Program Program;
+extern Type_CalSettings CalSettings;
+extern Type_Register RegisterValue[TOTAL_REGISTERS];
+extern Type_Numeric NumericValue;
+extern Type_MathErrorDisplay MathError;
+
+// PROTOTYPES LOCAL
+static BOOLEAN call_SolveBracket(void);
+static void call_SolveBrent(void);
+static BOOLEAN call_SolveEvaluate(double, double *);
+static BOOLEAN call_SolveBudget(void);
+static double call_SolveTolerance(double);
+static BOOLEAN call_SolveSameSign(double, double);
+static void call_SolveError(const uint8_t *);
+static BOOLEAN call_IntegrateLevel(uint16_t, double, double, double, double *);
+
+
+
+
+/*************************************************************************
+ * Function Name: call_SolveRoot
+ * Parameters: uint8_t
+ * Return: void
+ *
+ * Description: SOLVE n - finds a root of the function at LBL n from the guesses in X and Y.
+ * Called by the program task with the program compiled and the display held.  Line 4 shows the
+ * iteration while it runs.  Ends as the HP-15C: X the root, Y the estimate before it, Z f(root).
+ * The iterations and function evaluations are reported on line 1.  No root, or out of the
+ * iteration / time budget, is a math error with the best estimates on the stack.  ATN (any key)
+ * stops the solve with the estimates on the stack.
+ * STEP 1: Start with the guesses
+ * STEP 2: Search for a sign change - then Brent's method
+ * STEP 3: Estimates to the stack
+ * STEP 4: Report or error
+ *************************************************************************/
+ void call_SolveRoot(uint8_t Label)
+ {
+
+ double SavedT = RegisterValue[3].NumericValue;
+
+ // STEP 1
+ Solve.Label = Label;
+ Solve.Iteration = 0;
+ Solve.StartTime = ctl_get_current_time();
+ Solve.Result = SOLVE_DONE;
+ Program.Evaluations = 0;
+ Solve.B = RegisterValue[0].NumericValue;
+ Solve.A = RegisterValue[1].NumericValue;
+ if (Solve.A == Solve.B)
+   Solve.A = Solve.B + ((Solve.B != 0.0) ? (Solve.B * SOLVE_FIRST_STEP) : SOLVE_FIRST_STEP);
+ Solve.FA = Solve.FB = 0.0;
+
+ // STEP 2
+ if ((call_SolveEvaluate(Solve.A, &Solve.FA)) && (call_SolveEvaluate(Solve.B, &Solve.FB)) && (call_SolveBracket()))
+   call_SolveBrent();
+
+ // STEP 3
+ RegisterValue[0].NumericValue = Solve.B;
+ RegisterValue[1].NumericValue = Solve.A;
+ RegisterValue[2].NumericValue = Solve.FB;
+ RegisterValue[3].NumericValue = SavedT;
+ RegisterValue[0].Displayed = RegisterValue[1].Displayed = RegisterValue[2].Displayed = TRUE;
+
+ // STEP 4
+ switch(Solve.Result)
+   {
+   case SOLVE_DONE:
+     //                            01234567890123456789
+     sprintf(Program.Report, "SOLVE I:%u EVAL:%lu", Solve.Iteration, Program.Evaluations);
+   break;
+
+   case SOLVE_STOPPED:
+     sprintf(Program.Report, "SOLVE STOPPED I:%u", Solve.Iteration);
+   break;
+
+   case SOLVE_NO_ROOT:
+     call_SolveError("No root found");
+   break;
+
+   case SOLVE_OUT_OF_BUDGET:
+     call_SolveError("SOLVE out of budget");
+   break;
+
+   default:
+   case SOLVE_FUNCTION_ERROR:
+   break;
+   }
+
+ } // END OF call_SolveRoot
+
+
+
+
+/*************************************************************************
+ * Function Name: call_SolveBracket
+ * Parameters: void
+ * Return: BOOLEAN
+ *
+ * Description: Searches for a sign change from the guesses.  Each step is the secant of the
+ * last two estimates, limited to SOLVE_STEP_LIMIT times the last step (a flat secant steps out
+ * by the limit).  Returns TRUE when A and B bracket a root (f(A) and f(B) differ in sign).
+ * Returns FALSE with Solve.Result set: a root hit exactly, no root (the steps close on a minimum
+ * of |f| or SOLVE_STALL_LIMIT steps do not find a smaller |f| - B is then the best estimate),
+ * stopped or out of budget.
+ * STEP 1: Best estimate is B - check for no root
+ * STEP 2: Secant step
+ * STEP 3: Evaluate - next estimate
+ *************************************************************************/
+ static BOOLEAN call_SolveBracket(void)
+ {
+
+ double X,
+        Fx,
+        Step,
+        BestX = Solve.B,
+        BestF = Solve.FB;
+ uint8_t Stall = 0;
+
+ while (call_SolveSameSign(Solve.FA, Solve.FB))
+   {
+   // STEP 1
+   if (fabs(Solve.FA) < fabs(Solve.FB))
+     {
+     X = Solve.A;   Solve.A = Solve.B;   Solve.B = X;
+     Fx = Solve.FA; Solve.FA = Solve.FB; Solve.FB = Fx;
+     }
+   if (fabs(Solve.FB) < fabs(BestF))
+     {
+     BestX = Solve.B;
+     BestF = Solve.FB;
+     Stall = 0;
+     }
+   else
+     Stall++;
+   if ((Stall > SOLVE_STALL_LIMIT) || (fabs(Solve.B - Solve.A) <= call_SolveTolerance(Solve.B)))
+     {
+     Solve.B = BestX;
+     Solve.FB = BestF;
+     Solve.Result = SOLVE_NO_ROOT;
+     return(FALSE);
+     }
+   if (!call_SolveBudget())
+     return(FALSE);
+
+   // STEP 2
+   Step = SOLVE_STEP_LIMIT * (Solve.B - Solve.A);
+   if (Solve.FB != Solve.FA)
+     {
+     X = -Solve.FB * (Solve.B - Solve.A) / (Solve.FB - Solve.FA);
+     if (fabs(X) < fabs(Step))
+       Step = X;
+     }
+
+   // STEP 3
+   X = Solve.B + Step;
+   if (!call_SolveEvaluate(X, &Fx))
+     return(FALSE);
+   Solve.A = Solve.B;
+   Solve.FA = Solve.FB;
+   Solve.B = X;
+   Solve.FB = Fx;
+   }
+ if (Solve.FB == 0.0)
+   return(FALSE);
+ if (Solve.FA == 0.0)
+   {
+   X = Solve.A;   Solve.A = Solve.B;   Solve.B = X;
+   Fx = Solve.FA; Solve.FA = Solve.FB; Solve.FB = Fx;
+   return(FALSE);
+   }
+ return(TRUE);
+
+ } // END OF call_SolveBracket
+
+
+
+
+/*************************************************************************
+ * Function Name: call_SolveBrent
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Brent's method on the bracket A, B.  C is the end of the bracket on the other
+ * side of the root from B.  Each iteration takes the inverse quadratic (or secant) step if it
+ * stays inside the bracket and is shrinking fast enough, otherwise bisects - so the root is
+ * always kept bracketed and is found in at most about 2x the bisection iterations.  Ends with B
+ * within tolerance of the root (or f(B) = 0) and A the estimate before it.
+ * STEP 1: Keep C on the other side of the root, B the best estimate
+ * STEP 2: Converged
+ * STEP 3: Interpolate or bisect
+ * STEP 4: Evaluate the new estimate
+ *************************************************************************/
+ static void call_SolveBrent(void)
+ {
+
+ double C = Solve.A,
+        FC = Solve.FA,
+        D = Solve.B - Solve.A,
+        E = D,
+        Tol,
+        M,
+        P,
+        Q,
+        R,
+        S;
+
+ while (1)
+   {
+   // STEP 1
+   if (call_SolveSameSign(Solve.FB, FC))
+     {
+     C = Solve.A;
+     FC = Solve.FA;
+     D = E = Solve.B - Solve.A;
+     }
+   if (fabs(FC) < fabs(Solve.FB))
+     {
+     Solve.A = Solve.B;   Solve.B = C;   C = Solve.A;
+     Solve.FA = Solve.FB; Solve.FB = FC; FC = Solve.FA;
+     }
+
+   // STEP 2
+   Tol = call_SolveTolerance(Solve.B);
+   M = 0.5 * (C - Solve.B);
+   if ((fabs(M) <= Tol) || (Solve.FB == 0.0))
+     return;
+   if (!call_SolveBudget())
+     return;
+
+   // STEP 3
+   if ((fabs(E) >= Tol) && (fabs(Solve.FA) > fabs(Solve.FB)))
+     {
+     S = Solve.FB / Solve.FA;
+     if (Solve.A == C)
+       {
+       // SECANT
+       P = 2.0 * M * S;
+       Q = 1.0 - S;
+       }
+     else
+       {
+       // INVERSE QUADRATIC
+       Q = Solve.FA / FC;
+       R = Solve.FB / FC;
+       P = S * ((2.0 * M * Q * (Q - R)) - ((Solve.B - Solve.A) * (R - 1.0)));
+       Q = (Q - 1.0) * (R - 1.0) * (S - 1.0);
+       }
+     if (P > 0.0)
+       Q = -Q;
+     else
+       P = -P;
+     if (((2.0 * P) < ((3.0 * M * Q) - fabs(Tol * Q))) && (P < fabs(0.5 * E * Q)))
+       {
+       E = D;
+       D = P / Q;
+       }
+     else
+       D = E = M;
+     }
+   else
+     D = E = M;
+
+   // STEP 4
+   Solve.A = Solve.B;
+   Solve.FA = Solve.FB;
+   Solve.B += (fabs(D) > Tol) ? D : ((M > 0.0) ? Tol : -Tol);
+   if (!call_SolveEvaluate(Solve.B, &Solve.FB))
+     {
+     Solve.B = Solve.A;
+     Solve.FB = Solve.FA;
+     return;
+     }
+   }
+
+ } // END OF call_SolveBrent
+
+
+
+
+/*************************************************************************
+ * Function Name: call_SolveEvaluate
+ * Parameters: double, double *
+ * Return: BOOLEAN
+ *
+ * Description: f(x) by the program function (see call_ProgramEvaluate).  Returns FALSE with
+ * Solve.Result set if the function had an error or the solve was stopped.
+ * STEP 1: Evaluate
+ * STEP 2: Check for a stop
+ *************************************************************************/
+ static BOOLEAN call_SolveEvaluate(double X, double *Fx)
+ {
+
+ // STEP 1
+ if (!call_ProgramEvaluate(Solve.Label, X, Fx))
+   {
+   Solve.Result = (CalSettings.CalError != NO_ERROR) ? SOLVE_FUNCTION_ERROR : SOLVE_STOPPED;
+   return(FALSE);
+   }
+
+ // STEP 2
+ if (Program.StopRequest)
+   {
+   Solve.Result = SOLVE_STOPPED;
+   return(FALSE);
+   }
+ return(TRUE);
+
+ } // END OF call_SolveEvaluate
+
+
+
+
+/*************************************************************************
+ * Function Name: call_SolveBudget
+ * Parameters: void
+ * Return: BOOLEAN
+ *
+ * Description: Counts an iteration and shows it on line 4.  Returns FALSE with Solve.Result
+ * set if the iteration or time budget is used up.
+ * STEP 1: Check the budget
+ * STEP 2: Count and show progress
+ *************************************************************************/
+ static BOOLEAN call_SolveBudget(void)
+ {
+
+ uint8_t LineText[MAX_DISPLAY_LENGTH];
+
+ // STEP 1
+ if ((Solve.Iteration >= SOLVE_MAX_ITERATIONS) || ((ctl_get_current_time() - Solve.StartTime) > SOLVE_TIME_BUDGET))
+   {
+   Solve.Result = SOLVE_OUT_OF_BUDGET;
+   return(FALSE);
+   }
+
+ // STEP 2
+ Solve.Iteration++;
+ //                  01234567890123456789
+ sprintf(LineText, "      SOLVING %u", Solve.Iteration);
+ DIP204_clearLine(4);
+ DIP204_txt_engine(LineText, 4, 0, strlen(LineText));
+ return(TRUE);
+
+ } // END OF call_SolveBudget
+
+
+
+
+/*************************************************************************
+ * Function Name: call_SolveTolerance
+ * Parameters: double
+ * Return: double
+ *
+ * Description: How close the bracket must close on the root at x: 12 digits of x, or the
+ * absolute tolerance for a root at 0
+ * STEP 1: Return the tolerance
+ *************************************************************************/
+ static double call_SolveTolerance(double X)
+ {
+
+ // STEP 1
+ return((SOLVE_RELATIVE_TOL * fabs(X)) + SOLVE_ABSOLUTE_TOL);
+
+ } // END OF call_SolveTolerance
+
+
+
+
+/*************************************************************************
+ * Function Name: call_SolveSameSign
+ * Parameters: double, double
+ * Return: BOOLEAN
+ *
+ * Description: TRUE if both values are non zero and of the same sign.  Compares the signs and
+ * not the product - the product of two small values underflows to 0 and reads as a root.
+ * STEP 1: Return the compare
+ *************************************************************************/
+ static BOOLEAN call_SolveSameSign(double F1, double F2)
+ {
+
+ // STEP 1
+ return((F1 != 0.0) && (F2 != 0.0) && ((F1 > 0.0) == (F2 > 0.0)));
+
+ } // END OF call_SolveSameSign
+
+
+
+
+/*************************************************************************
+ * Function Name: call_SolveError
+ * Parameters: const uint8_t *
+ * Return: void
+ *
+ * Description: Shows a SOLVE error as a math error - ATN clears it
+ * STEP 1: Set the error text and show
+ *************************************************************************/
+ static void call_SolveError(const uint8_t *Description)
+ {
+
+ // STEP 1
+ strcpy(MathError.ErrorDescription, Description);
+ //                                   01234567890123456789
+ strcpy(MathError.ErrorSolution,     "Try new guesses");
+ strcpy(NumericValue.AudioErrorFileName, I_AND_I_ERROR_WAV);
+ NumericValue.AudioPlayLevel = BASIC_HELP;
+ call_ShowMathError();
+
+ } // END OF call_SolveError
+
+
+
+
+/*************************************************************************
+ * Function Name: call_IntegrateRun
+ * Parameters: uint8_t
+ * Return: void
+ *
+ * Description: INTEGRATE n - integral of the function at LBL n from Y to X.  Called by the
+ * program task with the program compiled and the display held.  Line 4 shows the level while
+ * it runs.  Romberg: each level is the trapezoid of the step of the level before halved (only
+ * the new mid points are evaluated) extrapolated to step 0.  Ends as the HP-15C: X the integral,
+ * Y its uncertainty (the change of the last extrapolation), Z the upper limit, T the lower.
+ * The accuracy is that of the display: FIX n to 0.5 x 10^-n of f times the width, ENG n to n
+ * digits of the integral.  The levels and function evaluations are reported on line 1.  Out of
+ * levels or time, or ATN (any key), ends with the estimate so far.
+ * STEP 1: Limits and the tolerance of the display format
+ * STEP 2: Next level - the new points and the trapezoid
+ * STEP 3: Romberg extrapolation of the level
+ * STEP 4: Converged
+ * STEP 5: Result to the stack and report
+ *************************************************************************/
+ void call_IntegrateRun(uint8_t Label)
+ {
+
+ double Row[INTEGRATE_MAX_LEVEL],                 // ROMBERG ROW OF THE LAST LEVEL
+        Lower = RegisterValue[1].NumericValue,
+        Upper = RegisterValue[0].NumericValue,
+        Width = Upper - Lower,
+        Trapezoid = 0.0,
+        Step = 1.0,
+        Sum,
+        Old,
+        Temp,
+        Factor,
+        Tol,
+        Error = 0.0;
+ uint16_t Points = 1;
+ uint8_t Level,
+         LineText[MAX_DISPLAY_LENGTH];
+
+ // STEP 1
+ Solve.Label = Label;
+ Solve.StartTime = ctl_get_current_time();
+ Solve.Result = SOLVE_OUT_OF_BUDGET;
+ Program.Evaluations = 0;
+ if (CalSettings.DisplayMode == FIX)
+   Tol = INTEGRATE_DISPLAY_TOL * pow(10.0, -(double)CalSettings.FixPrecision) * fabs(Width);
+ else
+   Tol = INTEGRATE_DISPLAY_TOL * pow(10.0, -(double)CalSettings.EngPrecision);
+ Row[0] = 0.0;
+
+ for (Level = 0; Level < INTEGRATE_MAX_LEVEL; Level++)
+   {
+   // STEP 2
+   //                  01234567890123456789
+   sprintf(LineText, "    INTEGRATING %u", (Level + 1));
+   DIP204_clearLine(4);
+   DIP204_txt_engine(LineText, 4, 0, strlen(LineText));
+   if (!call_IntegrateLevel(Points, Step, Lower, Width, &Sum))
+     break;
+   Trapezoid = (0.5 * Trapezoid) + (0.5 * Step * Sum);
+   Step *= 0.5;
+   Points *= 2;
+
+   // STEP 3
+   Old = Row[0];
+   Row[0] = Trapezoid;
+   Factor = 4.0;
+   for (uint8_t Column = 1; Column <= Level; Column++)
+     {
+     Temp = Row[Column];
+     Row[Column] = Row[Column - 1] + ((Row[Column - 1] - Old) / (Factor - 1.0));
+     Old = Temp;
+     Factor *= 4.0;
+     }
+
+   // STEP 4
+   if (!Level)
+     continue;
+   Error = fabs(Row[Level] - Row[Level - 1]);
+   if (((Level + 1) >= INTEGRATE_MIN_LEVEL) &&
+       (Error <= ((CalSettings.DisplayMode == FIX) ? Tol : (Tol * fabs(Row[Level])))))
+     {
+     Solve.Result = SOLVE_DONE;
+     Level++;
+     break;
+     }
+   }
+
+ // STEP 5
+ if (Solve.Result == SOLVE_FUNCTION_ERROR)
+   return;
+ RegisterValue[0].NumericValue = Level ? Row[Level - 1] : 0.0;
+ RegisterValue[1].NumericValue = Error;
+ RegisterValue[2].NumericValue = Upper;
+ RegisterValue[3].NumericValue = Lower;
+ for (uint8_t RegCount = 0; RegCount < TOTAL_REGISTERS; RegCount++)
+   RegisterValue[RegCount].Displayed = TRUE;
+ //                                 01234567890123456789
+ if (Solve.Result == SOLVE_DONE)
+   sprintf(Program.Report, "INTEG L:%u EVAL:%lu", Level, Program.Evaluations);
+ else if (Solve.Result == SOLVE_STOPPED)
+   sprintf(Program.Report, "INTEG STOPPED L:%u", Level);
+ else
+   sprintf(Program.Report, "INTEG ROUGH EVAL:%lu", Program.Evaluations);
+
+ } // END OF call_IntegrateRun
+
+
+
+
+/*************************************************************************
+ * Function Name: call_IntegrateLevel
+ * Parameters: uint16_t, double, double, double, double *
+ * Return: BOOLEAN
+ *
+ * Description: Sum of the new points of a Romberg level: the mid points of the step of the
+ * level before, f(x(t)) dx/dt at t = (i + 1/2) * Step.  Returns FALSE with Solve.Result set if
+ * the function had an error, the integrate was stopped or the time budget is used up.
+ * STEP 1: Evaluate the mid points
+ *************************************************************************/
+ static BOOLEAN call_IntegrateLevel(uint16_t Points, double Step, double Lower, double Width, double *Sum)
+ {
+
+ double T,
+        Fx;
+
+ // STEP 1
+ *Sum = 0.0;
+ for (uint16_t Point = 0; Point < Points; Point++)
+   {
+   if ((ctl_get_current_time() - Solve.StartTime) > INTEGRATE_TIME_BUDGET)
+     {
+     Solve.Result = SOLVE_OUT_OF_BUDGET;
+     return(FALSE);
+     }
+   T = (Point + 0.5) * Step;
+   if (!call_SolveEvaluate(INTEGRATE_X(Lower, Width, T), &Fx))
+     return(FALSE);
+   *Sum += Fx * INTEGRATE_DX(Width, T);
+   }
+ return(TRUE);
+
+ } // END OF call_IntegrateLevel
@@ -4,7 +4,7 @@
  * Description:     CTL RTOS Functions used to support start and sleep related functions of the HC15C
  * Author:          Hab S. Collector
  * Date:            1/23/12
- * LAST EDIT:       8/20/2012
+ * LAST EDIT:       10/19/2026
  * Hardware:        NXP LPC1768
  * Firmware Tool:   CrossStudio for ARM
  * Notes:           This file should be written as to not be dependent on other includes.
@@ -33,6 +33,8 @@
 #include "PWM_HC15C.H"
 #include "CORE_FUNCTIONS.H"
 #include "DIP204.H"
+#include "TAPE_TASKS.H"
+#include "LOG_TASKS.H"
 
 #include "FAT_FS_INC/ff.h"
 
@@ -45,6 +47,7 @@ extern CTL_TASK_t init_task;
 extern CTL_MESSAGE_QUEUE_t AudioQueue;
 extern Type_CalSettings CalSettings;
 extern FATFS fs[1];
+extern CTL_MUTEX_t FatFsMutex;
 extern volatile uint8_t BackLightTimer;
  
 /*************************************************************************
@@ -86,8 +89,9 @@ void init_taskFn(void *p)
       // TIMERS NEEED FOR EVENTS THAT FOLLOW
       init_HC15C_OnTimerCounter0(100);
       init_HC15C_OnTimerCounter1(100000);
+      init_CycleCounter();
       init_LED();
-      init_ADC_polling();
+      init_ADC_Scan();
       init_I2C0(I2C_STMPE24M31_FREQUENCY);
       init_Clock();
       init_DIP204();
@@ -135,7 +139,9 @@ void init_taskFn(void *p)
       // PLAY WELCOME
       if (PowerOnReset)
         {
+        ctl_mutex_lock(&FatFsMutex, CTL_TIMEOUT_NONE, 0);
         f_mount(0, &fs[0]);
+        ctl_mutex_unlock(&FatFsMutex);
         Type_AudioQueueStruct AudioQueueStruct;
         strcpy(AudioQueueStruct.FileName, WELCOME_WAV);
         AudioQueueStruct.PlayLevel = CORE_SOUND;
@@ -306,7 +312,7 @@ void init_taskFn(void *p)
  * NOTE: Deep Sleep and Power Down have an associated errata condition.  The recommended fix
  * is implemented here
  * STEP 1: Check if sleep disable - if so return.  
- * STEP 2: Store the Calculator Settings.  Save power by placing cal support devices in lowest power settings.  
+ * STEP 2: Store the Calculator Settings, commit the calculation tape and close a meter log.  Save power by placing cal support devices in lowest power settings.  
  * Turn off Audio Amp. 
  * STEP 3: Disable all possible sources of external wake up except what is intended - the
  * wake from sleep external irq, touch irq and RTC alarm to wake from sleep mode.  Enable external wake
@@ -325,6 +331,11 @@ void init_taskFn(void *p)
   // STEP 2
   // SAVE PRESENT SETTINGS
   call_StoreCalSettings();
+  call_TapeCommit();
+  call_LogStop();
+  call_LogCommit();
+  // STOP THE BACKGROUND ADC SCAN - RESTARTED BY THE INIT TASK ON WAKE
+  ADC_ScanStop();
   // SET CONDITIONS FOR CIRCUIT LOW POWER MODE
   // POWER DOWN AUDIO
   GPIO_ClearValue(PORT0, PWR_AUDIO);
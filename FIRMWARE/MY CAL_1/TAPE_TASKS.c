@@ -0,0 +1,428 @@
+/*****************************************************************
+ *
+ * File name:       TAPE_TASKS.C
+ * Description:     The calculation tape - every operation and the X it left, journaled to the SD card
+ * Author:          Hab S. Collector
+ * Date:            10/19/2026
+ * LAST EDIT:       10/19/2026
+ * Hardware:        NXP LPC1769
+ * Firmware Tool:   CrossStudio for ARM
+ * Notes:           This file should be written as to not be dependent on other includes.
+ *                  everything these functions need should be passed to them.
+ *                  It will be necessary to consult the reference documents and associated schematics to understand
+ *                  the operations of this firmware.
+ *                  The click task only puts a record in RAM - it never waits on the SD card.  Records go to
+ *                  one of two sector sized buffers.  A full buffer is committed by the tape task as one sector
+ *                  write at a sector aligned offset of the file.  The buffer being filled is committed every
+ *                  TAPE_COMMIT_TIME and by goToSleep: its sector is written again from the start with the
+ *                  records added since.  Power lost loses at most the records of the last TAPE_COMMIT_TIME.
+ *                  The tape is a CSV file (RECORD,TIME,KEY,X) - any text viewer or spreadsheet reads it.
+ *****************************************************************/
+
+#include <ctl_api.h>
+#include "TAPE_TASKS.H"
+#include "PROGRAM_TASKS.H"
+#include "TOUCH_TASKS.H"
+#include "CORE_FUNCTIONS.H"
+#include "MATH_FUNCTIONS.H"
+#include "DIP204.H"
+#include "AUDIO_TASKS.H"
+#include "FAT_FS_INC/ff.h"
+#include "lpc17xx_rtc.h"
+#include "lpc_types.h"
+#include <string.h>
+#include <stdio.h>
+
+
+// GLOBAL VARS
+// TYPES
+static Type_Tape Tape;
+// NOT ON THE STACK - THE CLICK TASK STACK IS SMALL
+static uint8_t TapeBuffer[TAPE_BUFFERS][TAPE_SECTOR] AHB_BANK1;
+static uint8_t TapeRecord[TAPE_RECORD_LENGTH];
+
+// EXTERN VARS
+extern CTL_EVENT_SET_t CalEvents;
+extern Type_Program Program;
+extern Type_CalSettings CalSettings;
+extern Type_Register RegisterValue[TOTAL_REGISTERS];
+extern Type_Numeric NumericValue;
+extern Type_MathErrorDisplay MathError;
+extern BOOLEAN bln_LineLoaded;
+extern FRESULT FF_Result;
+extern CTL_MUTEX_t FatFsMutex;
+extern FIL FatFsFile;
+
+// PROTOTYPES LOCAL
+static void call_TapeAppend(const uint8_t *, uint16_t);
+static BOOLEAN call_TapeWrite(const uint8_t *, uint16_t);
+static void call_TapeShow(uint8_t *);
+
+
+
+
+/*************************************************************************
+ * Function Name: tape_taskFn
+ * Parameters:    void *
+ * Return:        void
+ *
+ * Description: RTOS CTL task to commit the tape to the SD card.  The task is the lowest priority
+ * so a commit never holds off a key.  The event is set by the click task when a buffer is full or
+ * the tape is turned off, else the task commits every TAPE_COMMIT_TIME.
+ * STEP 1: Wait for the event or the commit time
+ * STEP 2: Commit
+ *************************************************************************/
+void tape_taskFn(void *p)
+{
+
+ while (1)
+   {
+   // STEP 1
+   ctl_events_wait(CTL_EVENT_WAIT_ANY_EVENTS, &CalEvents, (EVENT_TAPE), CTL_TIMEOUT_DELAY, TAPE_COMMIT_TIME);
+   ctl_events_set_clear(&CalEvents, 0, (EVENT_TAPE));
+
+   // STEP 2
+   call_TapeCommit();
+   }
+
+} // END OF tape_taskFn
+
+
+
+
+/*************************************************************************
+ * Function Name: call_TapeKeyCode
+ * Parameters: uint32_t
+ * Return: uint8_t
+ *
+ * Description: The keystroke code (see PROGRAM_KEY_CODE) of the key passed with the shift as it
+ * is before the key runs.  The click task takes the code before the key and records it after.
+ * STEP 1: Channel and key, then the shift
+ *************************************************************************/
+ uint8_t call_TapeKeyCode(uint32_t Key)
+ {
+
+ uint8_t Bit = 0,
+         Shift = PROGRAM_NO_SHIFT;
+
+ // STEP 1
+ while ((Bit < 23) && (!(Key & ((uint32_t)1 << Bit))))
+   Bit++;
+ if (CalSettings.L_Shift)
+   Shift = PROGRAM_L_SHIFT;
+ if (CalSettings.R_Shift)
+   Shift = PROGRAM_R_SHIFT;
+ return(PROGRAM_KEY_CODE(((Key & MASK_B_TOUCH_DATA) != 0), Bit, Shift));
+
+ } // END OF call_TapeKeyCode
+
+
+
+
+/*************************************************************************
+ * Function Name: call_TapeRecord
+ * Parameters: uint8_t
+ * Return: void
+ *
+ * Description: Called by the click task after each key.  If the tape is on and the key was an
+ * operation of CAL mode the record of the key and the X it left is put in RAM:
+ * 12,14:03:22,KEY B20 R,1.4142135623731
+ * Number entry keys are not recorded (the number is the X of the key that ends it), nor a shift,
+ * nor keys of program entry or a running program.  An error records X as ERROR, base 2 and 16
+ * record X as its 64 bit integer in hex.
+ * STEP 1: Is it an operation that is done
+ * STEP 2: X as text
+ * STEP 3: The record to the buffer
+ *************************************************************************/
+ void call_TapeRecord(uint8_t Code)
+ {
+
+ uint8_t KeyName[MAX_DISPLAY_LENGTH],
+         Value[2 * MAX_DISPLAY_LENGTH + 8];
+ int Length;
+
+ // STEP 1
+ if ((!Tape.On) || (CalSettings.CalMode != CAL_MODE) || (CalSettings.L_Shift) || (CalSettings.R_Shift) || (!bln_LineLoaded))
+   return;
+ if ((Program.Entry) || (Program.Prefix) || (Program.Running))
+   return;
+
+ // STEP 2
+ call_ProgramKeyName(Code, KeyName);
+ if (CalSettings.CalError != NO_ERROR)
+   strcpy(Value, "ERROR");
+ else if (CalSettings.CalBase != BASE_10)
+   sprintf(Value, "0x%08lX%08lX", (uint32_t)(RegisterValue[0].IntegerValue >> 32), (uint32_t)RegisterValue[0].IntegerValue);
+ else if (CalSettings.ComplexMode)
+   sprintf(Value, "%.15G%+.15Gi", RegisterValue[0].NumericValue, RegisterValue[0].Imaginary);
+ else
+   sprintf(Value, "%.15G", RegisterValue[0].NumericValue);
+
+ // STEP 3
+ Length = sprintf(TapeRecord, "%lu,%02lu:%02lu:%02lu,%s,%s\r\n", Tape.Records + 1,
+                  RTC_GetTime(LPC_RTC, RTC_TIMETYPE_HOUR), RTC_GetTime(LPC_RTC, RTC_TIMETYPE_MINUTE),
+                  RTC_GetTime(LPC_RTC, RTC_TIMETYPE_SECOND), KeyName, Value);
+ call_TapeAppend(TapeRecord, (uint16_t)Length);
+
+ } // END OF call_TapeRecord
+
+
+
+
+/*************************************************************************
+ * Function Name: call_TapeAppend
+ * Parameters: const uint8_t *, uint16_t
+ * Return: void
+ *
+ * Description: Appends a record to the buffer being filled.  A record that fills the buffer is
+ * split - the buffer is marked full for the tape task and the rest goes to the other buffer, so
+ * every full buffer is exactly one sector.  If the other buffer is still waiting on its commit the
+ * record is dropped and counted.  Only the click task calls this: the tape task is lower priority
+ * and cannot run in the middle of it.
+ * STEP 1: Room for the record
+ * STEP 2: Copy what fits
+ * STEP 3: Buffer full - swap, the rest to the other buffer and wake the tape task
+ *************************************************************************/
+ static void call_TapeAppend(const uint8_t *Record, uint16_t Length)
+ {
+
+ uint8_t Fill = Tape.Fill;
+ uint16_t Space = TAPE_SECTOR - Tape.Used[Fill],
+          Part;
+
+ // STEP 1
+ if ((Length >= Space) && (Tape.Full[Fill ^ 1]))
+   {
+   Tape.Lost++;
+   return;
+   }
+ Tape.Records++;
+
+ // STEP 2
+ Part = (Length < Space) ? Length : Space;
+ memcpy(&TapeBuffer[Fill][Tape.Used[Fill]], Record, Part);
+ Tape.Used[Fill] += Part;
+ if (Tape.Used[Fill] < TAPE_SECTOR)
+   return;
+
+ // STEP 3
+ Tape.Full[Fill] = TRUE;
+ Fill ^= 1;
+ memcpy(TapeBuffer[Fill], &Record[Part], Length - Part);
+ Tape.Written[Fill] = 0;
+ Tape.Used[Fill] = Length - Part;
+ Tape.Fill = Fill;
+ ctl_events_set_clear(&CalEvents, EVENT_TAPE, 0);
+
+ } // END OF call_TapeAppend
+
+
+
+
+/*************************************************************************
+ * Function Name: call_TapeCommit
+ * Parameters: void
+ * Return: void
+ *
+ * Description: Writes what the tape has in RAM to the SD card.  A full buffer is one sector at
+ * Base, then Base moves to the next sector.  The buffer being filled is written from the start of
+ * its sector with what it holds now.  The file is closed after so the directory entry is current
+ * if the power is lost.  Called by the tape task and by goToSleep from the init task - the two are
+ * the same priority and time sliced, so FatFsMutex is held from the open to the close: it keeps the
+ * other caller, and the audio, log and list tasks, off the card until the commit is done.  A buffer
+ * not written stays in RAM for the next commit.
+ * STEP 1: What is there to write - taken with the IRQs off as the click task can swap the buffers
+ * STEP 2: Lock and open
+ * STEP 3: The full buffer
+ * STEP 4: The buffer being filled - only once the full buffer before it is on the card
+ * STEP 5: Close and unlock
+ *************************************************************************/
+ void call_TapeCommit(void)
+ {
+
+ uint8_t Fill;
+ uint16_t Used;
+ BOOLEAN Full;
+
+ // STEP 1
+ if (!Tape.Opened)
+   return;
+ ctl_global_interrupts_disable();
+ Fill = Tape.Fill;
+ Used = Tape.Used[Fill];
+ Full = Tape.Full[Fill ^ 1];
+ ctl_global_interrupts_enable();
+ if ((!Full) && (Used == Tape.Written[Fill]))
+   return;
+
+ // STEP 2
+ ctl_mutex_lock(&FatFsMutex, CTL_TIMEOUT_NONE, 0);
+ FF_Result = f_open(&FatFsFile, TAPE_FILE_NAME, FA_OPEN_ALWAYS | FA_WRITE);
+ if (FF_Result != FR_OK)
+   {
+   ctl_mutex_unlock(&FatFsMutex);
+   Tape.Error = TRUE;
+   return;
+   }
+
+ // STEP 3
+ if ((Full) && (call_TapeWrite(TapeBuffer[Fill ^ 1], TAPE_SECTOR)))
+   {
+   Tape.Base += TAPE_SECTOR;
+   Tape.Full[Fill ^ 1] = FALSE;
+   }
+
+ // STEP 4
+ if ((!Tape.Full[Fill ^ 1]) && (Used != Tape.Written[Fill]) && (call_TapeWrite(TapeBuffer[Fill], Used)))
+   Tape.Written[Fill] = Used;
+
+ // STEP 5
+ if (f_close(&FatFsFile) != FR_OK)
+   Tape.Error = TRUE;
+ ctl_mutex_unlock(&FatFsMutex);
+
+ } // END OF call_TapeCommit
+
+
+
+
+/*************************************************************************
+ * Function Name: call_TapeWrite
+ * Parameters: const uint8_t *, uint16_t
+ * Return: BOOLEAN
+ *
+ * Description: Writes the bytes passed to the open tape file at Base - FatFsMutex is held by the
+ * caller.  Returns FALSE and sets the tape error if not all written.
+ * STEP 1: Seek and write
+ *************************************************************************/
+ static BOOLEAN call_TapeWrite(const uint8_t *Block, uint16_t Length)
+ {
+
+ UINT BytesWritten = 0;
+
+ // STEP 1
+ FF_Result = f_lseek(&FatFsFile, Tape.Base);
+ if (FF_Result == FR_OK)
+   FF_Result = f_write(&FatFsFile, Block, Length, &BytesWritten);
+ if ((FF_Result != FR_OK) || (BytesWritten != Length))
+   {
+   Tape.Error = TRUE;
+   return(FALSE);
+   }
+ return(TRUE);
+
+ } // END OF call_TapeWrite
+
+
+
+
+/*************************************************************************
+ * Function Name: call_TapeToggle
+ * Parameters: void
+ * Return: void
+ *
+ * Description: R SHIFT 8 - turns the tape on or off.  Off: the tape task is woken to commit what
+ * is left and line 1 shows the records (or the records lost, or a failed commit).  On: the first
+ * time since power up the end of TAPE_FILE_NAME is read - Base is the start of its last sector and
+ * the bytes of that sector go to the buffer, so the tape appends to the file and still writes
+ * whole sectors.  A new file gets the CSV header.  Line 1 shows:
+ * TAPE ON
+ * TAPE OFF 123 REC
+ * STEP 1: Check the calculator can take the key
+ * STEP 2: Off
+ * STEP 3: On - the end of the file the first time
+ * STEP 4: On
+ *************************************************************************/
+ void call_TapeToggle(void)
+ {
+
+ UINT BytesRead;
+ uint16_t Tail;
+ uint8_t LineText[2 * MAX_DISPLAY_LENGTH];
+ BOOLEAN Failed;
+
+ // STEP 1
+ if ((Program.Running) || (CalSettings.CalMode != CAL_MODE))
+   return;
+
+ // STEP 2
+ if (Tape.On)
+   {
+   Tape.On = FALSE;
+   ctl_events_set_clear(&CalEvents, EVENT_TAPE, 0);
+   //                  01234567890123456789
+   if (Tape.Error)
+     sprintf(LineText, "TAPE OFF SD FAILED");
+   else if (Tape.Lost)
+     sprintf(LineText, "TAPE OFF %lu LOST", Tape.Lost);
+   else
+     sprintf(LineText, "TAPE OFF %lu REC", Tape.Records);
+   LineText[MAX_DISPLAY_LENGTH] = NULL_VALUE;
+   call_TapeShow(LineText);
+   return;
+   }
+
+ // STEP 3
+ if (!Tape.Opened)
+   {
+   BytesRead = Tail = 0;
+   ctl_mutex_lock(&FatFsMutex, CTL_TIMEOUT_NONE, 0);
+   FF_Result = f_open(&FatFsFile, TAPE_FILE_NAME, FA_OPEN_ALWAYS | FA_READ);
+   if (FF_Result == FR_OK)
+     {
+     Tail = f_size(&FatFsFile) % TAPE_SECTOR;
+     Tape.Base = f_size(&FatFsFile) - Tail;
+     FF_Result = f_lseek(&FatFsFile, Tape.Base);
+     if (FF_Result == FR_OK)
+       FF_Result = f_read(&FatFsFile, TapeBuffer[0], Tail, &BytesRead);
+     f_close(&FatFsFile);
+     }
+   Failed = ((FF_Result != FR_OK) || (BytesRead != Tail));
+   ctl_mutex_unlock(&FatFsMutex);
+   if (Failed)
+     {
+     //                                              01234567890123456789
+     strcpy(MathError.ErrorDescription, "SD access failed");
+     strcpy(MathError.ErrorSolution, "Check the SD card");
+     strcpy(NumericValue.AudioErrorFileName, I_AND_I_ERROR_WAV);
+     NumericValue.AudioPlayLevel = BASIC_HELP;
+     call_ShowMathError();
+     return;
+     }
+   Tape.Fill = 0;
+   Tape.Used[0] = Tape.Written[0] = Tail;
+   Tape.Full[0] = Tape.Full[1] = FALSE;
+   Tape.Opened = TRUE;
+   if ((Tape.Base == 0) && (Tail == 0))
+     call_TapeAppend(TAPE_HEADER, strlen(TAPE_HEADER));
+   }
+
+ // STEP 4
+ Tape.Records = Tape.Lost = 0;
+ Tape.Error = FALSE;
+ Tape.On = TRUE;
+ //                  01234567890123456789
+ sprintf(LineText, "TAPE ON");
+ call_TapeShow(LineText);
+
+ } // END OF call_TapeToggle
+
+
+
+
+/*************************************************************************
+ * Function Name: call_TapeShow
+ * Parameters: uint8_t *
+ * Return: void
+ *
+ * Description: The tape state on line 1 until the next key
+ * STEP 1: Clear line 1 and show
+ *************************************************************************/
+ static void call_TapeShow(uint8_t *LineText)
+ {
+
+ // STEP 1
+ DIP204_clearLine(1);
+ DIP204_txt_engine(LineText, 1, 0, strlen(LineText));
+
+ } // END OF call_TapeShow
@@ -4,7 +4,7 @@
  * Description:     CTL RTOS Functions used to support touch related functions of the HC15C
  * Author:          Hab S. Collector
  * Date:            1/21/2012
- * LAST EDIT:       8/01/2012 
+ * LAST EDIT:       10/19/2026 
  * Hardware:        NXP LPC1769
  * Firmware Tool:   CrossStudio for ARM
  * Notes:           This file should be written as to not be dependent on other includes.
@@ -27,8 +27,18 @@
 #include "DIP204.H"
 #include "CORE_FUNCTIONS.H"
 #include "MATH_FUNCTIONS.H"
+#include "INTEGER_FUNCTIONS.H"
+#include "KERNEL_FUNCTIONS.H"
+#include "DECIMAL_FUNCTIONS.H"
+#include "PROGRAM_TASKS.H"
+#include "MATRIX_FUNCTIONS.H"
+#include "COMPLEX_FUNCTIONS.H"
+#include "BIGNUM_FUNCTIONS.H"
+#include "TAPE_TASKS.H"
+#include "LOG_TASKS.H"
 #include "AUDIO_TASKS.H"
 #include "USB_LINK.H"
+#include "HC15C_PROTOCOL.H"
 
 
 // GLOBAL VARIABLES
@@ -39,6 +49,7 @@ extern CTL_EVENT_SET_t CalEvents;
 extern CTL_MESSAGE_QUEUE_t MsgQueue, AudioQueue;
 extern volatile uint8_t BackLightTimer;
 extern Type_CalSettings CalSettings;
+extern BOOLEAN VCOM_Link;
 extern BOOLEAN bln_LineLoaded;
 extern CTL_MEMORY_AREA_t MemArea;
 extern CTL_TASK_t audio_task;
@@ -55,15 +66,20 @@ extern CTL_TASK_t audio_task;
  * based on the key pressed.  As almost everything the cal does is based on a keypress event
  * this task should be the highest running priority.
  * STEP 1: Get a message string (KeyPress event) from the message queue and filter the event
- * ie check to see if the key is enabled.  There are two key sets to consider A and B
- * STEP 2: Call the specific key event and clear the event.  The bit MASK_B_TOUCH_DATA
- * is used to establish if the event is a A or B channel press.
+ * ie check to see if the key is enabled.  There are two key sets to consider A and B.  Keys of program
+ * entry, of a running program and of GTO / GSB digits are taken by call_ProgramKey.  The keystroke
+ * code for the tape is taken before the key changes the shift
+ * STEP 2: The keys of a matrix operation are taken by call_MatrixKey, the keys of the BIG prefix and
+ * view by call_BigNumKey and the math keys of complex mode by call_ComplexKey.  Else call the specific
+ * key event.  The bit MASK_B_TOUCH_DATA is used to establish if the event is a A or B channel press.
+ * STEP 3: The key and the X it left to the calculation tape (RAM only - see TAPE_TASKS.c)
  *************************************************************************/
 void click_taskFn(void *p)
 {
  
  void *Msg;
  uint32_t MsgValue;
+ uint8_t TapeCode;
  
  while (1)
    {
@@ -75,13 +91,21 @@ void click_taskFn(void *p)
      {
      continue;
      } 
+   if (call_ProgramKey(MsgValue))
+     continue;
+   TapeCode = call_TapeKeyCode(MsgValue);
    
    // STEP 2
-   if (MsgValue & MASK_B_TOUCH_DATA)
-      select_key_functionB(MsgValue & 0x7FFFFFFF);
-   else
-     select_key_functionA(MsgValue);
+   if ((!call_MatrixKey(MsgValue)) && (!call_BigNumKey(MsgValue)) && (!call_ComplexKey(MsgValue)))
+     {
+     if (MsgValue & MASK_B_TOUCH_DATA)
+        select_key_functionB(MsgValue & 0x7FFFFFFF);
+     else
+       select_key_functionA(MsgValue);
+     }
    
+   // STEP 3
+   call_TapeRecord(TapeCode);
    }
  
 } // END OF click_taskFn
@@ -195,7 +219,8 @@ void select_key_functionA(uint32_t ACAP_TouchKey)
   call_CalATN();
   break;
   
-  // CS27 Key_tanx, SHIFT L: ATAN
+  // CS27 Key_tanx, SHIFT L: ATAN, SHIFT R: LBL (PROGRAM ENTRY ONLY)
+  // HEX MODE: XOR
   case ((uint32_t)(1<<1)):
   if (CalSettings.R_Shift)  // R_Shift NOT DEFINED FOR THIS KEY
     break;
@@ -205,45 +230,84 @@ void select_key_functionA(uint32_t ACAP_TouchKey)
     call_LShiftClick();
     break;
     }
+  // HEX MODE: XOR
+  if (CalSettings.CalBase == BASE_16)
+    {
+    call_IntBinaryOp(INT_XOR);
+    break;
+    }
   call_tanX();
   break;
   
-  // CS26 Key_cosX, SHIFT L: ACOS
+  // CS26 Key_cosX, SHIFT L: ACOS, SHIFT R: DECIMAL BENCHMARK
+  // HEX MODE: OR
   case ((uint32_t)(1<<2)):
-  if (CalSettings.R_Shift)  // R_Shift NOT DEFINED FOR THIS KEY
+  if (CalSettings.R_Shift)
+    {
+    call_DecimalBenchmark();
+    call_RShiftClick();
     break;
+    }
   if (CalSettings.L_Shift)
     {
     call_acosX();
     call_LShiftClick();
     break;
     }
+  // HEX MODE: OR
+  if (CalSettings.CalBase == BASE_16)
+    {
+    call_IntBinaryOp(INT_OR);
+    break;
+    }
   call_cosX();
   break;
   
-  // CS14 Key_eToX, SHIFT L: LN(x)
+  // CS14 Key_eToX, SHIFT L: LN(x), SHIFT R: GTO (PROGRAM)
+  // HEX MODE: SHIFT RIGHT
   case ((uint32_t)(1<<3)):
-  if (CalSettings.R_Shift)  // R_Shift NOT DEFINED FOR THIS KEY
+  if (CalSettings.R_Shift)
+    {
+    call_ProgramPrefix(PROGRAM_GTO);
+    call_RShiftClick();
     break;
+    }
   if (CalSettings.L_Shift)
     {
     call_lnX();
     call_LShiftClick();
     break;
     }
+  // HEX MODE: SHIFT RIGHT
+  if (CalSettings.CalBase == BASE_16)
+    {
+    call_IntUnaryOp(INT_SHIFT_RIGHT);
+    break;
+    }
   call_eToX();
   break;
   
-  // CS15 Key_Xsqr, SHIFT L: SQRT(x)
+  // CS15 Key_Xsqr, SHIFT L: SQRT(x), SHIFT R: DECIMAL / BINARY MATH
+  // HEX MODE: SHIFT LEFT
   case ((uint32_t)(1<<4)):
-  if (CalSettings.R_Shift)  // R_Shift NOT DEFINED FOR THIS KEY
+  if (CalSettings.R_Shift)
+    {
+    call_DecimalMode();
+    call_RShiftClick();
     break;
+    }
   if (CalSettings.L_Shift)
     {
     call_sqrtX();
     call_LShiftClick();
     break;
     }
+  // HEX MODE: SHIFT LEFT
+  if (CalSettings.CalBase == BASE_16)
+    {
+    call_IntUnaryOp(INT_SHIFT_LEFT);
+    break;
+    }
   call_Xsqr();
   break;
   
@@ -286,7 +350,8 @@ void select_key_functionA(uint32_t ACAP_TouchKey)
   call_NumClick(HEX_C);
   break;
   
-  // CS17 Key_1overX, SHIFT L: !X
+  // CS17 Key_1overX, SHIFT L: !X, SHIFT R: TEST (PROGRAM ENTRY ONLY)
+  // HEX MODE: NOT
   case ((uint32_t)(1<<8)):
   if (CalSettings.R_Shift)  // R_Shift NOT DEFINED FOR THIS KEY
     break;
@@ -296,13 +361,23 @@ void select_key_functionA(uint32_t ACAP_TouchKey)
     call_LShiftClick();
     break;
     }
+  // HEX MODE: NOT
+  if (CalSettings.CalBase == BASE_16)
+    {
+    call_IntUnaryOp(INT_NOT);
+    break;
+    }
   call_OneOverX();
   break;
   
-  // CS18 KEY_XTOY, SHIFT L: 3<>2
+  // CS18 KEY_XTOY, SHIFT L: 3<>2, SHIFT R: SOLVE (PROGRAM)
   case ((uint32_t)(1<<9)):
-  if (CalSettings.R_Shift)  // R_Shift NOT DEFINED FOR THIS KEY
+  if (CalSettings.R_Shift)
+    {
+    call_ProgramPrefix(PROGRAM_SOLVE);
+    call_RShiftClick();
     break;
+    }
   if (CalSettings.L_Shift)
     {
     call_3to2();
@@ -312,10 +387,14 @@ void select_key_functionA(uint32_t ACAP_TouchKey)
   call_XtoY();
   break;
   
-  // CS30 Backspace, SHIFT_L CLRx
+  // CS30 Backspace, SHIFT_L CLRx, SHIFT R: INTEGRATE (PROGRAM)
   case ((uint32_t)(1<<10)):
-  if (CalSettings.R_Shift)  // R_Shift NOT DEFINED FOR THIS KEY
+  if (CalSettings.R_Shift)
+    {
+    call_ProgramPrefix(PROGRAM_INTEGRATE);
+    call_RShiftClick();
     break;
+    }
   if (CalSettings.L_Shift)  // R_Shift NOT DEFINED FOR THIS KEY
     {
     call_ClearX();
@@ -325,35 +404,63 @@ void select_key_functionA(uint32_t ACAP_TouchKey)
   call_NumClick(BACKSPACE);
   break;
 
-  // CS29 Key_PtoR, SHIFT L: RtoP
+  // CS29 Key_PtoR, SHIFT L: RtoP, SHIFT R: INTEGER BENCHMARK
+  // HEX MODE: BIT COUNT
   case ((uint32_t)(1<<11)):
-  if (CalSettings.R_Shift)  // R_Shift NOT DEFINED FOR THIS KEY
+  if (CalSettings.R_Shift)
+    {
+    call_IntBenchmark();
+    call_RShiftClick();
     break;
+    }
   if (CalSettings.L_Shift)
     {
     call_RtoP();
     call_LShiftClick();
     break;
     }
+  // HEX MODE: BIT COUNT
+  if (CalSettings.CalBase == BASE_16)
+    {
+    call_IntUnaryOp(INT_BIT_COUNT);
+    break;
+    }
     call_PtoR();
   break;
   
-  // CS28 Key_jXC, SHIFT L: jXL
+  // CS28 Key_jXC, SHIFT L: jXL, SHIFT R: INTEGER SIGNED / UNSIGNED
+  // HEX MODE: WORD SIZE
   case ((uint32_t)(1<<12)):
-  if (CalSettings.R_Shift)  // R_Shift NOT DEFINED FOR THIS KEY
+  if (CalSettings.R_Shift)
+    {
+    call_IntSignMode();
+    call_RShiftClick();
     break;
+    }
   if (CalSettings.L_Shift)
     {
     call_jXL();
     call_LShiftClick();
+    if (CalSettings.CalBase == BASE_16)  // NOT ON TO THE WORD SIZE
+      break;
+    }
+  // HEX MODE: WORD SIZE
+  if (CalSettings.CalBase == BASE_16)
+    {
+    call_IntWordSize();
+    break;
     }
     call_jXC();
   break;
   
-  // CS42 Key_Drop SHIFT L: FLUSH
+  // CS42 Key_Drop SHIFT L: FLUSH, SHIFT R: PROGRAM BENCHMARK
   case ((uint32_t)(1<<13)):
-  if (CalSettings.R_Shift)  // R_Shift NOT DEFINED FOR THIS KEY
+  if (CalSettings.R_Shift)
+    {
+    call_ProgramBenchmark();
+    call_RShiftClick();
     break;
+    }
   if (CalSettings.L_Shift)
     {
     call_Flush();
@@ -372,29 +479,51 @@ void select_key_functionA(uint32_t ACAP_TouchKey)
   call_LShiftClick();
   break;
   
-  // CS25 Key_sinX, SHIFT L: ASIN
+  // CS25 Key_sinX, SHIFT L: ASIN, SHIFT R: MATH KERNEL BENCHMARK
+  // HEX MODE: AND
   case ((uint32_t)(1<<16)):
-  if (CalSettings.R_Shift)  // R_Shift NOT DEFINED FOR THIS KEY
+  if (CalSettings.R_Shift)
+    {
+    call_KernelBenchmark();
+    call_RShiftClick();
     break;
+    }
   if (CalSettings.L_Shift)
     {
     call_asinX();
     call_LShiftClick();
     break;
     }
+  // HEX MODE: AND
+  if (CalSettings.CalBase == BASE_16)
+    {
+    call_IntBinaryOp(INT_AND);
+    break;
+    }
   call_sinX();
   break;
   
-  // CS13 Key_10toX, SHIFT L: LOG(x)
+  // CS13 Key_10toX, SHIFT L: LOG(x), SHIFT R: GSB (PROGRAM)
+  // HEX MODE: ROTATE LEFT
   case ((uint32_t)(1<<17)):
-  if (CalSettings.R_Shift)  // R_Shift NOT DEFINED FOR THIS KEY
+  if (CalSettings.R_Shift)
+    {
+    call_ProgramPrefix(PROGRAM_GSB);
+    call_RShiftClick();
     break;
+    }
   if (CalSettings.L_Shift)
     {
     call_logX();
     call_LShiftClick();
     break;
     }
+  // HEX MODE: ROTATE LEFT
+  if (CalSettings.CalBase == BASE_16)
+    {
+    call_IntUnaryOp(INT_ROTATE_LEFT);
+    break;
+    }
   call_10ToX();
   break;
   
@@ -437,24 +566,39 @@ void select_key_functionA(uint32_t ACAP_TouchKey)
   call_NumClick(HEX_F);
   break;
   
-  // CS16 Key_yToX, SHIFT L: y^(1/x)
+  // CS16 Key_yToX, SHIFT L: y^(1/x), SHIFT R: RTN (PROGRAM)
+  // HEX MODE: ROTATE RIGHT
   case ((uint32_t)(1<<21)):
-  if (CalSettings.R_Shift)  // R_Shift NOT DEFINED FOR THIS KEY
-    break;  
+  if (CalSettings.R_Shift)
+    {
+    call_ProgramReturn();
+    call_RShiftClick();
+    break;
+    }
     if (CalSettings.L_Shift)
     {
     call_YtoOneOverX();
     call_LShiftClick();
     break;
     }
+  // HEX MODE: ROTATE RIGHT
+  if (CalSettings.CalBase == BASE_16)
+    {
+    call_IntUnaryOp(INT_ROTATE_RIGHT);
+    break;
+    }
   call_YtoX();
   break;
   break;
   
-  // CS41 Key_RCL, SHIFT L: STO
+  // CS41 Key_RCL, SHIFT L: STO, SHIFT R: ESTIMATE y AND r (PROGRAM ENTRY: RCL / STO nn)
   case ((uint32_t)(1<<22)):
-  if (CalSettings.R_Shift)  // R_Shift NOT DEFINED FOR THIS KEY
+  if (CalSettings.R_Shift)
+    {
+    call_EstimateYandR();
+    call_RShiftClick();
     break;
+    }
   if (CalSettings.L_Shift)
     {
     if (bln_LineLoaded)
@@ -466,10 +610,14 @@ void select_key_functionA(uint32_t ACAP_TouchKey)
     call_NumClick(RCL);
   break;
   
-  // CS40 Key_Sigma+, SHIFT L: Clear Stat sums
+  // CS40 Key_Sigma+, SHIFT L: Clear Stat sums, SHIFT R: LINEAR REGRESSION
   case ((uint32_t)(1<<23)):
-  if (CalSettings.R_Shift)  // R_Shift NOT DEFINED FOR THIS KEY
+  if (CalSettings.R_Shift)
+    {
+    call_LinearRegression();
+    call_RShiftClick();
     break;
+    }
   if (CalSettings.L_Shift)
     {
     call_StatClear();
@@ -515,13 +663,13 @@ switch(BCAP_TouchKey)
     }
   if (CalSettings.L_Shift)
     {
-    call_lb_to_kg();
+    call_UnitConvert(UNIT_LB, UNIT_KG);
     call_LShiftClick();
     break;
     }
   if (CalSettings.R_Shift)
     {
-    call_kg_to_lb();
+    call_UnitConvert(UNIT_KG, UNIT_LB);
     call_RShiftClick();
     break;
     }
@@ -532,13 +680,13 @@ switch(BCAP_TouchKey)
   case ((uint32_t)(1<<1)):
   if (CalSettings.L_Shift)
     {
-    call_gal_to_l();
+    call_UnitConvert(UNIT_GAL, UNIT_L);
     call_LShiftClick();
     break;
     }
   if (CalSettings.R_Shift)
     {
-    call_l_to_gal();
+    call_UnitConvert(UNIT_L, UNIT_GAL);
     call_RShiftClick();
     break;
     }
@@ -549,13 +697,13 @@ switch(BCAP_TouchKey)
   case ((uint32_t)(1<<2)):
   if (CalSettings.L_Shift)
     {
-    call_in_to_cm();
+    call_UnitConvert(UNIT_IN, UNIT_CM);
     call_LShiftClick();
     break;
     }
   if (CalSettings.R_Shift)
     {
-    call_cm_to_in();
+    call_UnitConvert(UNIT_CM, UNIT_IN);
     call_RShiftClick();
     break;
     }
@@ -566,13 +714,13 @@ switch(BCAP_TouchKey)
   case ((uint32_t)(1<<3)):
   if (CalSettings.L_Shift)
     {
-    call_MILS_to_mm();
+    call_UnitConvert(UNIT_MILS, UNIT_MM);
     call_LShiftClick();
     break;
     }
   if (CalSettings.R_Shift)
     {
-    call_mm_to_MILS();
+    call_UnitConvert(UNIT_MM, UNIT_MILS);
     call_RShiftClick();
     break;
     }
@@ -589,20 +737,20 @@ switch(BCAP_TouchKey)
     }
   if (CalSettings.L_Shift)
     {
-    call_ft_to_m();
+    call_UnitConvert(UNIT_FT, UNIT_M);
     call_LShiftClick();
     break;
     }
   if (CalSettings.R_Shift)
     {
-    call_m_to_ft();
+    call_UnitConvert(UNIT_M, UNIT_FT);
     call_RShiftClick();
     break;
     }
   call_NumClick(1);
   break;
   
-  // CS43 Key_Enter
+  // CS43 Key_Enter, SHIFT L: COMPLEX / REAL MODE, SHIFT R: MATRIX
   // ALARM MODE: TURN ON ALARM
   case ((uint32_t)(1<<5)):
   if (CalSettings.CalMode == ALARM_MODE)
@@ -615,10 +763,22 @@ switch(BCAP_TouchKey)
     call_PlayPauseMusic();
     break;
     }
+  if (CalSettings.R_Shift)
+    {
+    call_MatrixPrefix();
+    call_RShiftClick();
+    break;
+    }
+  if (CalSettings.L_Shift)
+    {
+    call_ComplexMode();
+    call_LShiftClick();
+    break;
+    }
   call_Enter();
   break;
   
-  // CS19 Key_Exponent, SHIFT L: Percent Difference
+  // CS19 Key_Exponent, SHIFT L: Percent Difference, SHIFT R: MATRIX BENCHMARK
   case ((uint32_t)(1<<6)):
   if (CalSettings.L_Shift)
     {
@@ -626,15 +786,27 @@ switch(BCAP_TouchKey)
     call_LShiftClick();
     break;
     }
+  if (CalSettings.R_Shift)
+    {
+    call_MatrixBenchmark();
+    call_RShiftClick();
+    break;
+    }
   call_NumClick(EXPONENT);
   break;
   
-  // CS20 Key_4
+  // CS20 Key_4, SHIFT R: BIG (EXACT INTEGER)
   // ALARM MODE: MOVE TIME CURSOR SET POSITION LEFT
   // CLOCK MODE: STOP THE STOPWATCH
   // VOLTE METER MODE: RESET THE MAX HIGH VALUE
   case ((uint32_t)(1<<7)):
-  if ((CalSettings.R_Shift)||(CalSettings.L_Shift))  // R_Shift OR L_Shift NOT DEFINED FOR THIS KEY
+  if (CalSettings.R_Shift)
+    {
+    call_BigNumPrefix();
+    call_RShiftClick();
+    break;
+    }
+  if (CalSettings.L_Shift)  // L_Shift NOT DEFINED FOR THIS KEY
     break;
   if (CalSettings.CalMode == ALARM_MODE)
     {
@@ -654,7 +826,7 @@ switch(BCAP_TouchKey)
   call_NumClick(4);
   break;
   
-  // CS31 USB LINK, SHIFT L: USB EJECT
+  // CS31 USB LINK (METER STREAM WHEN LINKED IN METER MODE, SEND CAPTURES IN SCOPE MODE), SHIFT L: USB EJECT, SHIFT R: Re<>Im (COMPLEX MODE)
   case ((uint32_t)(1<<8)):
   if (CalSettings.R_Shift)  // R_Shift NOT DEFINED FOR THIS KEY
     break;
@@ -664,13 +836,29 @@ switch(BCAP_TouchKey)
     call_LShiftClick();
     break;
     }
+  // LINKED IN METER OR OHMS MODE: START OR STOP THE METER STREAM
+  if ((VCOM_Link) && ((CalSettings.CalMode == METER_MODE) || (CalSettings.CalMode == OHMS_MODE)))
+    {
+    call_StreamToggle();
+    break;
+    }
+  // LINKED IN SCOPE MODE: START OR STOP SENDING THE CAPTURES
+  if ((VCOM_Link) && (CalSettings.CalMode == SCOPE_MODE))
+    {
+    call_ScopeSendToggle();
+    break;
+    }
   call_USB_VCOM_Link();
   break;
   
-  // CS36 VOLT METER MODE, SHIFT L: OHM METER MODE
+  // CS36 VOLT METER MODE, SHIFT L: OHM METER MODE, SHIFT R: SCOPE MODE (DSE IN PROGRAM ENTRY)
   case ((uint32_t)(1<<9)):
-  if (CalSettings.R_Shift)  // R_Shift NOT DEFINED FOR THIS KEY
+  if (CalSettings.R_Shift)
+    {
+    call_ScopeMode();
+    call_RShiftClick();
     break;
+    }
   if (CalSettings.L_Shift)
     {
     call_OhmsMeterMode();
@@ -680,7 +868,7 @@ switch(BCAP_TouchKey)
   call_VoltMeterMode();
   break;
   
-  // CS48 MUSIC MODE, SHIFT L: DIR LIST MODE
+  // CS48 MUSIC MODE, SHIFT L: DIR LIST MODE, SHIFT R: ISG (PROGRAM ENTRY ONLY)
   case ((uint32_t)(1<<10)):
   if (CalSettings.R_Shift)  // R_Shift NOT DEFINED FOR THIS KEY
     break;
@@ -693,13 +881,21 @@ switch(BCAP_TouchKey)
    call_MusicListMode();
   break;
   
-  // CS9 Key_8
+  // CS9 Key_8, SHIFT R: CALCULATION TAPE ON / OFF
   // ALARM MODE: INCREMENT TIME PARAMETER UP
   // OHM METER MODE: INCREMENT CONTINUNITY MATCH VALUE UP
+  // VOLT METER MODE: AC RMS / DC READINGS
+  // SCOPE MODE: TRIGGER LEVEL UP
   // DIR LIST MODE: SCROLL DISPLAY UP
   // MUSIC LIST MODE: SCROLL DISPLAY UP
   case ((uint32_t)(1<<11)):
-  if ((CalSettings.R_Shift)||(CalSettings.L_Shift))  // R_Shift OR L_Shift NOT DEFINED FOR THIS KEY
+  if (CalSettings.R_Shift)
+    {
+    call_TapeToggle();
+    call_RShiftClick();
+    break;
+    }
+  if (CalSettings.L_Shift)  // L_Shift NOT DEFINED FOR THIS KEY
     break;
   if (CalSettings.CalMode == ALARM_MODE)
     {
@@ -711,6 +907,16 @@ switch(BCAP_TouchKey)
     call_OhmsLimitUp();
     break;
     }
+  if (CalSettings.CalMode == METER_MODE)
+    {
+    call_VoltMeterACToggle();
+    break;
+    }
+  if (CalSettings.CalMode == SCOPE_MODE)
+    {
+    call_ScopeLevelUp();
+    break;
+    }
   if (CalSettings.CalMode == SD_LIST_MODE)
     {
     call_DirScrollUp();
@@ -728,13 +934,13 @@ switch(BCAP_TouchKey)
   case ((uint32_t)(1<<12)):
   if (CalSettings.L_Shift)
     {
-    call_F_to_C();
+    call_UnitConvert(UNIT_F, UNIT_C);
     call_LShiftClick();
     break;
     }
   if (CalSettings.R_Shift)
     {
-    call_C_to_F();
+    call_UnitConvert(UNIT_C, UNIT_F);
     call_RShiftClick();
     break;
     }
@@ -745,13 +951,13 @@ switch(BCAP_TouchKey)
   case ((uint32_t)(1<<13)):
   if (CalSettings.L_Shift)
     {
-    call_mph_to_kph();
+    call_UnitConvert(UNIT_MPH, UNIT_KPH);
     call_LShiftClick();
     break;
     }
   if (CalSettings.R_Shift)
     {
-    call_kph_to_mph();
+    call_UnitConvert(UNIT_KPH, UNIT_MPH);
     call_RShiftClick();
     break;
     }
@@ -762,13 +968,13 @@ switch(BCAP_TouchKey)
   case ((uint32_t)(1<<14)):
   if (CalSettings.L_Shift)
     {
-    call_fps_to_mps();
+    call_UnitConvert(UNIT_FPS, UNIT_MPS);
     call_LShiftClick();
     break;
     }
   if (CalSettings.R_Shift)
     {
-    call_mps_to_fps();
+    call_UnitConvert(UNIT_MPS, UNIT_FPS);
     call_RShiftClick();
     break;
     }
@@ -779,6 +985,7 @@ switch(BCAP_TouchKey)
   // ALARM MODE: DECREMENT ALARM TIME PARAMETER
   // CLOCK MODE: ENABLE WIN APP CLOCK SET BUTTON
   // OHM METER MODE: DECREMENT CONTINUNITY SET RESISTANCE
+  // SCOPE MODE: TRIGGER LEVEL DOWN
   // SD LIST MODE: SCROLL DOWN SD LIST
   // SETUP MODE: CHANGE CAL VERBSOE SETTING
   // MUSIC LIST MODE: SCROLL DOWN MUSIC LIST
@@ -800,6 +1007,11 @@ switch(BCAP_TouchKey)
     call_OhmsLimitDown();
     break;
     }
+  if (CalSettings.CalMode == SCOPE_MODE)
+    {
+    call_ScopeLevelDown();
+    break;
+    }
   if (CalSettings.CalMode == SD_LIST_MODE)
     {
     call_DirScrollDown();
@@ -867,23 +1079,27 @@ switch(BCAP_TouchKey)
   case ((uint32_t)(1<<19)):
   if (CalSettings.L_Shift)
     {
-    call_mi_to_km();
+    call_UnitConvert(UNIT_MI, UNIT_KM);
     call_LShiftClick();
     break;
     }
   if (CalSettings.R_Shift)
     {
-    call_km_to_mi();
+    call_UnitConvert(UNIT_KM, UNIT_MI);
     call_RShiftClick();
     break;
     }
   call_NumClick(7);
   break;
   
-  // CS12 CALCULATOR MODE, SHIFT L: SETUP MODE
+  // CS12 CALCULATOR MODE, SHIFT L: SETUP MODE, SHIFT R: PROGRAM ENTRY (P/R)
   case ((uint32_t)(1<<20)):
-  if (CalSettings.R_Shift)  // R_Shift NOT DEFINED FOR THIS KEY
+  if (CalSettings.R_Shift)
+    {
+    call_ProgramEntryMode();
+    call_RShiftClick();
     break;
+    }
   if (CalSettings.L_Shift)
     {
     call_SetupMode();
@@ -893,10 +1109,14 @@ switch(BCAP_TouchKey)
   call_CalMode();
   break;
   
-  //CS24 CLOCK MODE, SHIFT L: ALARM MODE
+  //CS24 CLOCK MODE, SHIFT L: ALARM MODE, SHIFT R: RUN / STOP PROGRAM (R/S)
   case ((uint32_t)(1<<21)):
-  if (CalSettings.R_Shift)  // R_Shift NOT DEFINED FOR THIS KEY
+  if (CalSettings.R_Shift)
+    {
+    call_ProgramRunStop();
+    call_RShiftClick();
     break;
+    }
   if (CalSettings.L_Shift)
     {
     call_AlarmMode();
@@ -906,12 +1126,19 @@ switch(BCAP_TouchKey)
   call_ClockMode();
   break;
   
-  // CS21 Key_5
+  // CS21 Key_5, SHIFT R: MATH SELF TEST
   // CLOCK MODE: STOP STOP WATCH
   // ALARM MODE: TURN OFF ALARM
   // MUSIC LIST MODE: ENABLE STOP OF PLAY AUDIO
+  // VOLT AND OHM METER MODE: STOP THE METER LOG
   case ((uint32_t)(1<<22)): 
-  if ((CalSettings.R_Shift)||(CalSettings.L_Shift))  // R_Shift OR L_Shift NOT DEFINED FOR THIS KEY
+  if (CalSettings.R_Shift)
+    {
+    call_MathBenchmark();
+    call_RShiftClick();
+    break;
+    }
+  if (CalSettings.L_Shift)  // L_Shift NOT DEFINED FOR THIS KEY
     break;
   if ((CalSettings.CalMode == CLOCK_MODE) && (!CalSettings.TimeAlarm.AlarmEvent))
     {
@@ -928,15 +1155,27 @@ switch(BCAP_TouchKey)
     call_MusicStop();
     break;
     }
+  if ((CalSettings.CalMode == METER_MODE) || (CalSettings.CalMode == OHMS_MODE))
+    {
+    call_LogStop();
+    break;
+    }
   call_NumClick(5);
   break;
   
-  // CS22 Key_6
+  // CS22 Key_6, SHIFT R: BATCH (PROGRAM)
   // ALARM MODE: MOVE TIME CURSOR SET POSITION RIGHT
   // CLOCK MODE: START / CONTINUE STOP WATCH
   // MUSIC LIST MODE: PLAY SELECTED AUDIO
+  // VOLT AND OHM METER MODE: START THE METER LOG
   case ((uint32_t)(1<<23)):
-  if ((CalSettings.R_Shift)||(CalSettings.L_Shift))  // R_Shift OR L_Shift NOT DEFINED FOR THIS KEY
+  if (CalSettings.R_Shift)
+    {
+    call_ProgramPrefix(PROGRAM_BATCH);
+    call_RShiftClick();
+    break;
+    }
+  if (CalSettings.L_Shift)  // L_Shift NOT DEFINED FOR THIS KEY
     break;
   if (CalSettings.CalMode == ALARM_MODE)
     {
@@ -953,6 +1192,16 @@ switch(BCAP_TouchKey)
     call_PlayPauseMusic();
     break;
     }
+  if (CalSettings.CalMode == METER_MODE)
+    {
+    call_LogStart(TYPE_VOLT);
+    break;
+    }
+  if (CalSettings.CalMode == OHMS_MODE)
+    {
+    call_LogStart(TYPE_OHMS);
+    break;
+    }
   call_NumClick(6);
   break;
   
@@ -46,7 +46,14 @@
 #define MASK_KEY_ALINK      ((uint32_t)(1<<8))  // FUNCTION KEY FOR VCOMM LINK & UNLINK
 #define MASK_KEY_FLASH      ((uint32_t)(1<<9))  // FUNCTION KEY FOR FLASH DRIVE CONTENTS
 #define MASK_KEY_MUSIC      ((uint32_t)(1<<10)) // FUNCTION KWY FOR AUDIO PLAY & HC15C SETUP
+#define MASK_KEY_RSHIFT     ((uint32_t)(1<<14))
 #define MASK_KEY_LSHIFT     ((uint32_t)(1<<15))
+#define MASK_KEY_HEX_A      ((uint32_t)(1<<5))  // TOUCH A HEX LETTER KEYS - ALSO NAME THE MATRICES A - E
+#define MASK_KEY_HEX_B      ((uint32_t)(1<<6))
+#define MASK_KEY_HEX_C      ((uint32_t)(1<<7))
+#define MASK_KEY_HEX_D      ((uint32_t)(1<<18))
+#define MASK_KEY_HEX_E      ((uint32_t)(1<<19))
+#define MASK_KEY_HEX_F      ((uint32_t)(1<<20))
 #define MASK_0TO9_ONLY      (MASK_KEY_0|MASK_KEY_1|MASK_KEY_2|MASK_KEY_3|MASK_KEY_4|MASK_KEY_5|MASK_KEY_6|MASK_KEY_7|MASK_KEY_8|MASK_KEY_9)
 
 // ALIAS TOUCH KEY NAMES
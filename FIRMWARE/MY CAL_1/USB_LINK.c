@@ -5,7 +5,7 @@
  *                  USB VCOM files of the VCOM USB dir GV WORKS REV VCOM_LIB REV 1.3.    
  * Author:          Hab S. Collector
  * Date:            12/31/11
- * LAST EDIT:       7/04/2012  
+ * LAST EDIT:       10/19/2026
  * Hardware:        NXP LPC1769
  * Firmware Tool:   CrossStudio for ARM
  * Notes:           This file should be written as to not be dependent on other includes.
@@ -21,12 +21,17 @@
  #include "CORE_FUNCTIONS.H"
  #include "DIP204.H"
  #include "LED_HC15C.H"
+ #include <ctl_api.h>
+ #include <stdio.h>
+ #include <string.h>
  
  // GLOBALS
  BOOLEAN VCOM_Link = FALSE;
+ Type_Stream MeterStream;
  
  // EXTERNS
  extern Type_CalSettings CalSettings;
+ extern CTL_EVENT_SET_t CalEvents;
  
  
  
@@ -67,8 +72,8 @@
  * NOTE: The function call_USB_Link changes the function of the USB LED pin from GPIO to
  * USB connect.  Change back to GPIO when you disconnect 
  * STEP 1: Do nothing if USB Link not connected
- * STEP 2: Disconnect USB VCOMM, remove ICONS, turn off USB LED by making it GPIO and
- * re-enable sleep mode
+ * STEP 2: Stop the meter stream and any scope capture being sent.  Disconnect USB VCOMM, remove ICONS,
+ * turn off USB LED by making it GPIO and re-enable sleep mode
  *************************************************************************/
  void call_USB_VCOM_UnLink(void)
  {
@@ -82,6 +87,8 @@
    }
  
   // STEP 2
+ call_StreamStop();
+ VCOM_cancelBlock();
  USBHwConnect(FALSE); 
  DIP204_ICON_set(ICON_UP_ARROW, ICON_OFF);
  DIP204_ICON_set(ICON_DOWN_ARROW, ICON_OFF);
@@ -140,6 +147,242 @@
 
  } // END OF  call_WriteToUSB_Meter
 
+
+
+
+/*************************************************************************
+ * Function Name: call_StreamToggle
+ * Parameters:    void
+ * Return:        void
+ *
+ * Description: USB LINK key in Meter or Ohms mode while linked.  Starts or stops the meter
+ * stream: TYPE_STREAM packets of many readings in place of a TYPE_VOLT or TYPE_OHMS packet for
+ * each displayed reading.  The timer 0 IRQ sets EVENT_STREAM each sample time.
+ * STEP 1: On - stop and show the packets sent
+ * STEP 2: Off - wait for the flush of the last stream.  Start with an empty payload
+ *************************************************************************/
+ void call_StreamToggle(void)
+ {
+ 
+ uint8_t LineText[2 * DISPLAY_COLUMN_TOTAL];
+ 
+ // STEP 1
+ if (MeterStream.On)
+   {
+   call_StreamStop();
+   //                  01234567890123456789
+   sprintf(LineText, "STREAM OFF DROP %lu", MeterStream.Dropped);
+   LineText[DISPLAY_COLUMN_TOTAL] = NULL_VALUE;
+   DIP204_clearLine(STREAM_ROW);
+   DIP204_txt_engine(LineText, STREAM_ROW, 0, strlen(LineText));
+   return;
+   }
+ 
+ // STEP 2
+ if (!(VCOM_Link & CalSettings.USB_Link) || (CalEvents & EVENT_STREAM))
+   return;
+ MeterStream.Count = 0;
+ MeterStream.Length = 0;
+ MeterStream.Samples = 0;
+ MeterStream.Dropped = 0;
+ MeterStream.SampleTime = STREAM_SAMPLE_TIME;
+ MeterStream.Ticks = 0;
+ MeterStream.On = TRUE;
+ //                  01234567890123456789
+ sprintf(LineText, "STREAM ON %u/S", 1000 / MeterStream.SampleTime);
+ DIP204_clearLine(STREAM_ROW);
+ DIP204_txt_engine(LineText, STREAM_ROW, 0, strlen(LineText));
+ 
+ } // END OF call_StreamToggle
+
+
+
+
+/*************************************************************************
+ * Function Name: call_StreamStop
+ * Parameters:    void
+ * Return:        void
+ *
+ * Description: Stops the meter stream.  Samples not yet sent are flushed by the meter task (never
+ * in the middle of a call_StreamSample) on the EVENT_STREAM this sets.
+ * STEP 1: Do nothing if not on
+ * STEP 2: Stop the samples and signal the flush
+ *************************************************************************/
+ void call_StreamStop(void)
+ {
+ 
+ // STEP 1
+ if (!MeterStream.On)
+   return;
+ 
+ // STEP 2
+ MeterStream.On = FALSE;
+ ctl_events_set_clear(&CalEvents, EVENT_STREAM, 0);
+ 
+ } // END OF call_StreamStop
+
+
+
+
+/*************************************************************************
+ * Function Name: call_StreamSample
+ * Parameters:    double, uint8_t
+ * Return:        void
+ *
+ * Description: Adds a reading (volts or ohms - the meter type) to the stream payload as a fixed
+ * point value.  The first sample of a payload is sent whole, each one after it as the change in
+ * time and value from the sample before it - a steady reading is 2 bytes a sample.  The packet is
+ * sent when it is full or the first sample is STREAM_FLUSH_TIME old.
+ * NOTE: Called by the meter task only.
+ * STEP 1: Fixed point value.  A change of meter type starts a new payload
+ * STEP 2: First sample - the payload header and the value
+ * STEP 3: Other samples - the time and value change
+ * STEP 4: Send if full or old
+ *************************************************************************/
+ void call_StreamSample(double Value, uint8_t MeterType)
+ {
+ 
+ double Factor = 1.0;
+ uint8_t Scale;
+ int32_t FixedValue;
+ uint32_t Now;
+ 
+ // STEP 1
+ if (!MeterStream.On)
+   return;
+ Scale = (MeterType == TYPE_OHMS) ? STREAM_OHMS_SCALE : STREAM_VOLT_SCALE;
+ for (uint8_t Digit = 0; Digit < Scale; Digit++)
+   Factor *= 10.0;
+ FixedValue = (int32_t)((Value * Factor) + ((Value < 0.0) ? -0.5 : 0.5));
+ Now = ctl_get_current_time();
+ if ((MeterStream.Count) && (MeterStream.Type != MeterType))
+   call_StreamFlush();
+ 
+ // STEP 2
+ if (!MeterStream.Count)
+   {
+   MeterStream.Type = MeterType;
+   MeterStream.TimeBase = Now;
+   MeterStream.Payload[STREAM_SEQ_INDEX] = (uint8_t)MeterStream.Sequence;
+   MeterStream.Payload[STREAM_SEQ_INDEX + 1] = (uint8_t)(MeterStream.Sequence >> 8);
+   MeterStream.Payload[STREAM_METER_INDEX] = MeterType;
+   MeterStream.Payload[STREAM_SCALE_INDEX] = Scale;
+   for (uint8_t ByteCount = 0; ByteCount < sizeof(uint32_t); ByteCount++)
+     {
+     MeterStream.Payload[STREAM_TIME_INDEX + ByteCount] = (uint8_t)(Now >> (8 * ByteCount));
+     }
+   MeterStream.Length = STREAM_HEADER_SIZE;
+   MeterStream.Length += encodeVarint(encodeZigZag(FixedValue), &MeterStream.Payload[MeterStream.Length]);
+   }
+ // STEP 3
+ else
+   {
+   MeterStream.Length += encodeVarint(Now - MeterStream.LastTime, &MeterStream.Payload[MeterStream.Length]);
+   MeterStream.Length += encodeVarint(encodeZigZag(FixedValue - MeterStream.LastValue), &MeterStream.Payload[MeterStream.Length]);
+   }
+ MeterStream.LastTime = Now;
+ MeterStream.LastValue = FixedValue;
+ MeterStream.Count++;
+ 
+ // STEP 4
+ if ((MeterStream.Count >= STREAM_SAMPLES) || ((MeterStream.Length + (2 * MAX_VARINT_SIZE)) > STREAM_PAYLOAD) ||
+     ((Now - MeterStream.TimeBase) >= STREAM_FLUSH_TIME))
+   {
+   call_StreamFlush();
+   }
+ 
+ } // END OF call_StreamSample
+
+
+
+
+/*************************************************************************
+ * Function Name: call_StreamFlush
+ * Parameters:    void
+ * Return:        void
+ *
+ * Description: Sends the stream payload as one TYPE_STREAM packet.  The packet goes into the USB
+ * TX FIFO in one block copy or not at all - the meter task never waits on the PC.  A packet not
+ * sent (no room, or a scope ring is being sent - see VCOM_writeBlock) is counted and its sequence
+ * number skipped, so the PC sees the gap.
+ * STEP 1: Do nothing if the payload is empty
+ * STEP 2: Create the packet and copy it to the USB TX FIFO
+ * STEP 3: Start the next payload
+ *************************************************************************/
+ void call_StreamFlush(void)
+ {
+ 
+ static uint8_t TX_Packet[STREAM_PAYLOAD + 4];
+ 
+ // STEP 1
+ if (!MeterStream.Count)
+   return;
+ 
+ // STEP 2
+ MeterStream.Payload[STREAM_COUNT_INDEX] = MeterStream.Count;
+ createTX_Buffer(MeterStream.Payload, MeterStream.Length, TX_Packet, TYPE_STREAM);
+ if (VCOM_write(TX_Packet, MeterStream.Length + 4) == EOF)
+   MeterStream.Dropped++;
+ else
+   MeterStream.Samples += MeterStream.Count;
+ 
+ // STEP 3
+ MeterStream.Sequence++;
+ MeterStream.Count = 0;
+ MeterStream.Length = 0;
+ 
+ } // END OF call_StreamFlush
+
+
+
+
+/*************************************************************************
+ * Function Name: call_WriteToUSB_Scope
+ * Parameters:    const ADC_Capture_Type *, double
+ * Return:        BOOLEAN - TRUE if the capture is being sent
+ *
+ * Description: Sends a scope capture: a TYPE_SCOPE packet of the rate, the ring indexes, the trigger
+ * level and the front end divider, then the ring itself.  The ring is not copied - the USB IRQ
+ * sends it from where the DMA wrote it, so the capture must stay until VCOM_blockBusy is FALSE.
+ * Nothing is sent if the TX FIFO has no room for the packet or the last capture is still going.
+ * STEP 1: Do nothing while the last ring is being sent
+ * STEP 2: Load the payload little endian
+ * STEP 3: The packet through the TX FIFO, then the ring after it
+ *************************************************************************/
+ BOOLEAN call_WriteToUSB_Scope(const ADC_Capture_Type *Capture, double FrontEndDivider)
+ {
+ 
+ uint8_t TX_PayLoad[SCOPE_HEADER_SIZE],
+         TX_Packet[SCOPE_HEADER_SIZE + 4];
+ float Divider = (float)FrontEndDivider;
+ 
+ // STEP 1
+ if (VCOM_blockBusy())
+   return(FALSE);
+ 
+ // STEP 2
+ for (uint8_t ByteCount = 0; ByteCount < sizeof(uint32_t); ByteCount++)
+   {
+   TX_PayLoad[SCOPE_RATE_INDEX + ByteCount] = (uint8_t)(Capture->Rate >> (8 * ByteCount));
+   }
+ for (uint8_t ByteCount = 0; ByteCount < sizeof(uint16_t); ByteCount++)
+   {
+   TX_PayLoad[SCOPE_SAMPLES_INDEX + ByteCount] = (uint8_t)(ADC_CAPTURE_SAMPLES >> (8 * ByteCount));
+   TX_PayLoad[SCOPE_FIRST_INDEX + ByteCount] = (uint8_t)(Capture->First >> (8 * ByteCount));
+   TX_PayLoad[SCOPE_TRIGGER_INDEX + ByteCount] = (uint8_t)(Capture->Trigger >> (8 * ByteCount));
+   TX_PayLoad[SCOPE_LEVEL_INDEX + ByteCount] = (uint8_t)(Capture->Level >> (8 * ByteCount));
+   }
+ memcpy(&TX_PayLoad[SCOPE_DIVIDER_INDEX], &Divider, sizeof(float));
+ 
+ // STEP 3
+ createTX_Buffer(TX_PayLoad, SCOPE_HEADER_SIZE, TX_Packet, TYPE_SCOPE);
+ if (VCOM_write(TX_Packet, SCOPE_HEADER_SIZE + 4) == EOF)
+   return(FALSE);
+ VCOM_writeBlock((const U8 *)Capture->Buffer, ADC_CAPTURE_SAMPLES * sizeof(uint32_t));
+ return(TRUE);
+ 
+ } // END OF call_WriteToUSB_Scope
+
  
 
   
@@ -15,12 +15,48 @@
 
 // INCLUDES
 #include "HC15C_DEFINES.h"
+#include "ADC_HC15C.H"
 
 
+// DEFINES
+#define STREAM_SAMPLE_TIME      5                 // ms BETWEEN SAMPLES: 200 SAMPLES PER SECOND
+#define STREAM_SAMPLES          64                // MOST SAMPLES IN A PACKET
+#define STREAM_PAYLOAD          240               // MOST BYTES OF A PACKET PAYLOAD - UNDER MAX_PACKET_SIZE_HC15C
+#define STREAM_FLUSH_TIME       250               // ms - MOST A SAMPLE WAITS FOR ITS PACKET TO BE SENT
+#define STREAM_VOLT_SCALE       4                 // DECIMAL PLACES SENT: 0.1mV
+#define STREAM_OHMS_SCALE       1                 // DECIMAL PLACES SENT: 0.1 OHM
+#define STREAM_ROW              3                 // FREE IN METER AND OHMS MODE - SHARED WITH THE LOG
+
+
+// ENUMERATED TYPES AND STRUCTURES
+// THE METER TASK BUILDS THE PAYLOAD OF A TYPE_STREAM PACKET ONE SAMPLE AT A TIME AND SENDS IT WHOLE
+// WHEN IT IS FULL OR STREAM_FLUSH_TIME OLD.  SEE HC15C_PROTOCOL.H FOR THE PAYLOAD
+typedef struct
+  {
+  BOOLEAN On;                                // SAMPLING
+  uint8_t Type;                              // TYPE_VOLT OR TYPE_OHMS OF THE PAYLOAD
+  uint8_t Count;                             // SAMPLES IN THE PAYLOAD
+  uint8_t Length;                            // BYTES OF THE PAYLOAD
+  uint16_t Sequence;                         // OF THE NEXT PACKET
+  uint16_t SampleTime;                       // ms BETWEEN SAMPLES
+  volatile uint16_t Ticks;                   // ms COUNTED IN THE TIMER 0 IRQ
+  uint32_t TimeBase;                         // ctl_get_current_time OF THE FIRST SAMPLE IN THE PAYLOAD
+  uint32_t LastTime;                         // ctl_get_current_time OF THE LAST SAMPLE
+  int32_t LastValue;                         // FIXED POINT VALUE OF THE LAST SAMPLE
+  uint32_t Samples;                          // SENT
+  uint32_t Dropped;                          // PACKETS NOT SENT - THE USB TX FIFO WAS FULL
+  uint8_t Payload[STREAM_PAYLOAD];
+  } Type_Stream;
+
 
 // PROTOTYPES
 void call_USB_VCOM_Link(void);
 void call_WriteToUSB_Meter(double, uint8_t);
 void call_USB_VCOM_UnLink(void);
+void call_StreamToggle(void);
+void call_StreamStop(void);
+void call_StreamSample(double, uint8_t);
+void call_StreamFlush(void);
+BOOLEAN call_WriteToUSB_Scope(const ADC_Capture_Type *, double);
 
 #endif
\ No newline at end of file
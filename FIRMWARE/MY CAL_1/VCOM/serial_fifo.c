@@ -29,6 +29,7 @@
 //#include "type.h"
 #include "lpcusb_type.h"
 #include "serial_fifo.h"
+#include <string.h>
 
 void fifo_init(fifo_t *fifo, U8 *buf)
 {
@@ -56,6 +57,32 @@ BOOL fifo_put(fifo_t *fifo, U8 c)
 }
 
 
+/*
+	Puts a block into the FIFO, all or nothing: one or two block copies
+	(the second when the block wraps) and a single update of head, so the
+	USB interrupt never sees a partial block.
+ */
+BOOL fifo_put_block(fifo_t *fifo, const U8 *buf, int len)
+{
+	int first;
+	
+	// check if FIFO has room for the whole block
+	if ((len <= 0) || (fifo_free(fifo) < len)) {
+		return FALSE;
+	}
+	
+	first = VCOM_FIFO_SIZE - fifo->head;
+	if (first > len) {
+		first = len;
+	}
+	memcpy(&fifo->buf[fifo->head], buf, first);
+	memcpy(&fifo->buf[0], &buf[first], len - first);
+	fifo->head = (fifo->head + len) % VCOM_FIFO_SIZE;
+	
+	return TRUE;
+}
+
+
 BOOL fifo_get(fifo_t *fifo, U8 *pc)
 {
 	int next;
@@ -37,6 +37,7 @@ typedef struct {
 
 void fifo_init(fifo_t *fifo, U8 *buf);
 BOOL fifo_put(fifo_t *fifo, U8 c);
+BOOL fifo_put_block(fifo_t *fifo, const U8 *buf, int len);
 BOOL fifo_get(fifo_t *fifo, U8 *pc);
 int  fifo_avail(fifo_t *fifo);
 int	 fifo_free(fifo_t *fifo);
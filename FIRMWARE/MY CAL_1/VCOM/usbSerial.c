@@ -83,6 +83,11 @@ static U8 rxdata[VCOM_FIFO_SIZE];
 static fifo_t txfifo;
 static fifo_t rxfifo;
 
+// block sent in place once the transmit FIFO is empty, see VCOM_writeBlock.
+// The FIFO takes no bytes while it is set, so the FIFO only holds what went before it
+static const U8 * volatile pbBlock;
+static volatile int iBlockLen = 0;
+
 // forward declaration of interrupt handler
 void USBIntHandler(void);
 
@@ -238,6 +243,14 @@ static void BulkIn(U8 bEP, U8 bEPStatus)
 	int i, iLen;
 	bEPStatus = bEPStatus;
 	if (fifo_avail(&txfifo) == 0) {
+		if (iBlockLen > 0) {
+			// send the next packet of the block straight from its buffer
+			iLen = (iBlockLen < MAX_PACKET_SIZE) ? iBlockLen : MAX_PACKET_SIZE;
+			USBHwEPWrite(bEP, (U8 *)pbBlock, iLen);
+			pbBlock += iLen;
+			iBlockLen -= iLen;
+			return;
+		}
 		// no more data, disable further NAK interrupts until next USB frame
 		USBHwNakIntEnable(0);
 		return;
@@ -316,13 +329,77 @@ void VCOM_init(void)
 	
 	@param [in] c character to write
 	@returns character written, or EOF if character could not be written
+	or a block from VCOM_writeBlock is being sent
  */
 int VCOM_putchar(int c)
 {
+	if (iBlockLen > 0) {
+		return EOF;
+	}
 	return fifo_put(&txfifo, c) ? c : EOF;
 }
 
 
+/**
+	Writes a block to VCOM port in one copy - all of it or none of it
+	
+	@param [in] buf block to write
+	@param [in] len bytes in the block
+	@returns len, or EOF if the block could not be written or a block
+	from VCOM_writeBlock is being sent
+ */
+int VCOM_write(const U8 *buf, int len)
+{
+	if (iBlockLen > 0) {
+		return EOF;
+	}
+	return fifo_put_block(&txfifo, buf, len) ? len : EOF;
+}
+
+
+/**
+	Sends a block over VCOM port without a copy - the USB interrupt reads
+	each packet from the block once the FIFO is empty.  The block must stay
+	as it is until VCOM_blockBusy returns FALSE.  Until then VCOM_putchar and
+	VCOM_write are refused, so what is in the FIFO now goes before the block
+	and nothing goes into the middle of it
+	
+	@param [in] buf block to send
+	@param [in] len bytes in the block
+	@returns len, or EOF if a block is still being sent
+ */
+int VCOM_writeBlock(const U8 *buf, int len)
+{
+	if (iBlockLen > 0) {
+		return EOF;
+	}
+	pbBlock = buf;
+	iBlockLen = len;
+	return len;
+}
+
+
+/**
+	Tells if a block from VCOM_writeBlock is still being sent
+	
+	@returns TRUE until the last packet of the block is written
+ */
+BOOL VCOM_blockBusy(void)
+{
+	return iBlockLen > 0;
+}
+
+
+/**
+	Drops what is left of a block from VCOM_writeBlock - the block
+	can change after this returns
+ */
+void VCOM_cancelBlock(void)
+{
+	iBlockLen = 0;
+}
+
+
 /**
 	Reads one character from VCOM port
 	
@@ -351,7 +428,7 @@ void USB_IRQHandler(void)
 static void USBFrameHandler(U16 wFrame)
 {
 	wFrame = wFrame;
-	if (fifo_avail(&txfifo) > 0) {
+	if ((fifo_avail(&txfifo) > 0) || (iBlockLen > 0)) {
 		// data available, enable NAK interrupt on bulk in
 		USBHwNakIntEnable(INACK_BI);
 	}
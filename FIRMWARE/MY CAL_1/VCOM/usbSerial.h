@@ -103,9 +103,46 @@ int usbSerialInit(); // run once in main b4 main loop starts.
 	
 	@param [in] c character to write
 	@returns character written, or EOF if character could not be written
+	or a block from VCOM_writeBlock is being sent
  */
 int VCOM_putchar(int c);  
 
+/**
+	Writes a block to VCOM port in one copy - all of it or none of it
+	
+	@param [in] buf block to write
+	@param [in] len bytes in the block
+	@returns len, or EOF if the block could not be written or a block
+	from VCOM_writeBlock is being sent
+ */
+int VCOM_write(const U8 *buf, int len);
+
+/**
+	Sends a block over VCOM port without a copy - the USB interrupt reads
+	each packet from the block once the FIFO is empty.  The block must stay
+	as it is until VCOM_blockBusy returns FALSE.  Until then VCOM_putchar and
+	VCOM_write are refused, so what is in the FIFO now goes before the block
+	and nothing goes into the middle of it
+	
+	@param [in] buf block to send
+	@param [in] len bytes in the block
+	@returns len, or EOF if a block is still being sent
+ */
+int VCOM_writeBlock(const U8 *buf, int len);
+
+/**
+	Tells if a block from VCOM_writeBlock is still being sent
+	
+	@returns TRUE until the last packet of the block is written
+ */
+BOOL VCOM_blockBusy(void);
+
+/**
+	Drops what is left of a block from VCOM_writeBlock - the block
+	can change after this returns
+ */
+void VCOM_cancelBlock(void);
+
 /**
 	Reads one character from VCOM port
 	
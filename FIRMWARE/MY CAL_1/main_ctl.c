@@ -77,6 +77,9 @@
 #include "AUDIO_TASKS.H"
 #include "START_N_SLEEP_TASKS.H"
 #include "SETUP_TASKS.H"
+#include "PROGRAM_TASKS.H"
+#include "TAPE_TASKS.H"
+#include "LOG_TASKS.H"
 #include "USB_LINK.H"
 #include "FAT_FS_INC/ff.h"
 #define MEMORY_BLOCK_SIZE (sizeof(Type_AudioQueueStruct)/4+1)
@@ -87,6 +90,7 @@
 FATFS fs[1];
 FRESULT FF_Result;
 FILINFO FF_Status;
+FIL FatFsFile;      // A FILE OPENED AND CLOSED IN ONE HOLD OF FatFsMutex - THE TAPE, PROGRAM, BIG AND BENCHMARK FILES
 DIR Directory;
 
 // DIRECT TASKING ASSOCIATE DECLARATIONS
@@ -99,7 +103,10 @@ CTL_TASK_t main_task,
            meter_task,
            SDlist_task,
            audio_task,
-           setup_task;
+           setup_task,
+           program_task,
+           tape_task,
+           log_task;
 
 // TASKING EVENTS
 CTL_EVENT_SET_t CalEvents;
@@ -115,9 +122,8 @@ CTL_MEMORY_AREA_t MemArea;
 unsigned memory[MEMORY_BLOCK_SIZE * MEMORY_BLOCK_COUNT]; 
 
 // TASKING MUTEX
-CTL_MUTEX_t ADC_Mutex,
-            DelayMutex,
-            DIP204Mutex;
+CTL_MUTEX_t DIP204Mutex,
+            FatFsMutex;     // FAT FS IS NOT REENTRANT (_FS_REENTRANT 0) - HELD AROUND EVERY f_ CALL
 
 // STACK DEFINITION
 #define CALLSTACKSIZE 0 // FOR ARM BUILDS
@@ -129,7 +135,11 @@ unsigned init_task_stack[1+ STACKSIZE +1],
          meter_task_stack[1+ STACKSIZE +1],
          SDlist_task_stack[1+ (2*STACKSIZE) +1],
          audio_task_stack[1+ (4*STACKSIZE) +1],
-         setup_task_stack[1+ STACKSIZE +1]; 
+         setup_task_stack[1+ STACKSIZE +1],
+         program_task_stack[1+ (2*STACKSIZE) +1];
+// THE TAPE AND LOG TASKS ONLY WRITE THE SD CARD - THEIR STACKS ARE IN AHB SRAM
+unsigned tape_task_stack[1+ (2*STACKSIZE) +1] AHB_BANK1,
+         log_task_stack[1+ (2*STACKSIZE) +1] AHB_BANK1; 
 
 
 /*************************************************************************
@@ -174,9 +184,8 @@ int main(void)
   ctl_message_queue_init(&MsgQueue, M_Queue, 20);
   ctl_message_queue_init(&AudioQueue, A_Queue, MAX_AUDIO_MSG);
   ctl_memory_area_init(&MemArea, memory, MEMORY_BLOCK_SIZE, MEMORY_BLOCK_COUNT);
-  ctl_mutex_init(&ADC_Mutex);
-  ctl_mutex_init(&DelayMutex);
   ctl_mutex_init(&DIP204Mutex);
+  ctl_mutex_init(&FatFsMutex);
   
   // START MAIN AND SYSTICK
   ctl_task_init(&main_task, 255, "main"); // CREATE ADDITIONAL TASKS WHILE MAIN IS AT HIGHEST PRIORITY
@@ -202,6 +211,20 @@ int main(void)
   memset(setup_task_stack, 0xcd, sizeof(setup_task_stack));  
   setup_task_stack[0] = setup_task_stack[(sizeof(setup_task_stack)/sizeof(unsigned)) - 1] = 0xFaceFeed; 
   ctl_task_run(&setup_task, 4, setup_taskFn, 0, "setup_task", (sizeof(setup_task_stack)/sizeof(unsigned))-2, setup_task_stack+1, CALLSTACKSIZE);
+
+  // READY AND RUN keystroke program task - LOWEST SO A RUNNING PROGRAM NEVER HOLDS OFF THE OTHER TASKS
+  memset(program_task_stack, 0xcd, sizeof(program_task_stack));  
+  program_task_stack[0] = program_task_stack[(sizeof(program_task_stack)/sizeof(unsigned)) - 1] = 0xFaceFeed; 
+  ctl_task_run(&program_task, 1, program_taskFn, 0, "program_task", (sizeof(program_task_stack)/sizeof(unsigned))-2, program_task_stack+1, CALLSTACKSIZE);
+
+  // READY AND RUN calculation tape task - LOWEST SO AN SD COMMIT NEVER HOLDS OFF A KEY
+  memset(tape_task_stack, 0xcd, sizeof(tape_task_stack));  
+  tape_task_stack[0] = tape_task_stack[(sizeof(tape_task_stack)/sizeof(unsigned)) - 1] = 0xFaceFeed; 
+  ctl_task_run(&tape_task, 1, tape_taskFn, 0, "tape_task", (sizeof(tape_task_stack)/sizeof(unsigned))-2, tape_task_stack+1, CALLSTACKSIZE);
+  // READY AND RUN meter log task - LOWEST SO AN SD WRITE NEVER HOLDS OFF A SAMPLE
+  memset(log_task_stack, 0xcd, sizeof(log_task_stack));  
+  log_task_stack[0] = log_task_stack[(sizeof(log_task_stack)/sizeof(unsigned)) - 1] = 0xFaceFeed; 
+  ctl_task_run(&log_task, 1, log_taskFn, 0, "log_task", (sizeof(log_task_stack)/sizeof(unsigned))-2, log_task_stack+1, CALLSTACKSIZE);
     
   // READY AND RUN clock task
   memset(clock_task_stack, 0xcd, sizeof(clock_task_stack));  
@@ -244,8 +267,8 @@ int main(void)
   while (1)
     {
     // SLEEP TO CONSERVER POWER WHEN DOING NOTHING: CORE CLK IF OFF BY ALL OTHER CLOCKS ON
-    // ANY OF THE TOUCH IRQ'S, TIMER IRQs, OR RTC WILL WAKE UP
-    CLKPWR_Sleep();
+    // ANY OF THE TOUCH IRQ'S, TIMER IRQs, OR RTC WILL WAKE UP.  THE TIME ASLEEP IS THE IDLE TIME
+    idleSleep();
     }
   
   // CODE SHOULD NEVER REACH HERE